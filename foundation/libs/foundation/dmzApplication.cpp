@@ -344,7 +344,11 @@ dmz::Application::load_session () {
 /*!
 
 \brief Process the command line.
-\details Loads all XML configuration files specified by the command line.
+\details Loads all XML configuration files specified by the command line. The
+configuration files are parsed in parallel. If the environment variable
+<PREFIX>_CONFIG_CACHE is set, parsed configuration files are cached in the directory
+it names. The number of parsing threads may be set with <PREFIX>_CONFIG_THREADS.
+<PREFIX> is the upper case name of the application.
 \param[in] CL CommandLine object to process.
 \return Returns dmz::True if command line was successfully processed. Returns
 dmz::False if there was an error parsing the XML configuration files.
@@ -355,6 +359,12 @@ dmz::Application::process_command_line (const CommandLine &CL) {
 
    CommandLineConfig clconfig;
 
+   clconfig.set_cache_directory (get_env (_state.NamePrefix + "_CONFIG_CACHE"));
+
+   const String ThreadCount (get_env (_state.NamePrefix + "_CONFIG_THREADS"));
+
+   if (ThreadCount) { clconfig.set_thread_count (string_to_int32 (ThreadCount)); }
+
    if (!clconfig.process_command_line (CL, _state.global, &(_state.log))) {
 
       _state.errorMsg.flush () << "Unable to process command line: "
@@ -371,7 +381,9 @@ dmz::Application::process_command_line (const CommandLine &CL) {
 /*!
 
 \brief Initializes the runtime.
-\details Initializes the runtime specified by the configuration files.
+\details Initializes the runtime specified by the configuration files. The dmz.runtime
+config is read in quiet mode too. Quiet mode only suppresses the warning logged when it
+is missing.
 \return Returns dmz::True if runtime get intialized.
 
 */
@@ -384,8 +396,10 @@ dmz::Application::init_runtime () {
       
       Config runtimeData;
 
-      if (!_state.error && !_state.quiet &&
-            !_state.global.lookup_all_config_merged ("dmz.runtime", runtimeData)) {
+      const Boolean Found (
+         _state.global.lookup_all_config_merged ("dmz.runtime", runtimeData));
+
+      if (!Found && !_state.error && !_state.quiet) {
 
          _state.log.warn << "dmz.runtime not found" << endl;
       }
@@ -5,13 +5,15 @@
 #include <dmzRuntimeLog.h>
 #include <dmzSystemFile.h>
 #include <dmzTypesString.h>
+#include <dmzTypesStringContainer.h>
 
 /*!
 
 \class dmz::CommandLineConfig
 \brief Process the command line.
 \details Takes the parsed command line and parse the specified config files and
-converts them into a config context tree.
+converts them into a config context tree. The config files are parsed in parallel and
+may be cached in a binary form so unchanged files are not parsed again.
 \sa dmz::Config \n dmz::ConfigContext
 
 */
@@ -20,6 +22,10 @@ struct dmz::CommandLineConfig::State {
 
    String error;
    StringContainer paths;
+   String cacheDir;
+   Int32 threadCount;
+
+   State () : threadCount (4) {;}
 };
 
 
@@ -61,6 +67,37 @@ dmz::CommandLineConfig::set_search_path (const StringContainer &Container) {
 }
 
 
+/*!
+
+\brief Set config cache directory.
+\details Parsed config files are cached in the directory so that unchanged config
+files do not need to be parsed the next time they are read. Caching is disabled
+by default.
+\param[in] Path String containing the cache directory. An empty String disables caching.
+\sa dmz::read_config_files_parallel
+
+*/
+void
+dmz::CommandLineConfig::set_cache_directory (const String &Path) {
+
+   _state.cacheDir = Path;
+}
+
+
+/*!
+
+\brief Set the number of threads used to parse config files.
+\details Defaults to four threads.
+\param[in] Count Maximum number of threads used to parse config files.
+
+*/
+void
+dmz::CommandLineConfig::set_thread_count (const Int32 Count) {
+
+   _state.threadCount = Count > 0 ? Count : 1;
+}
+
+
 /*!
 
 \brief Process command line.
@@ -85,6 +122,8 @@ dmz::CommandLineConfig::process_command_line (
    Boolean error (False);
    Boolean done (!Opts.get_first_option (args));
 
+   StringContainer files;
+
    while (!done) {
 
       if (args.get_name ().get_lower () == "f") {
@@ -95,14 +134,7 @@ dmz::CommandLineConfig::process_command_line (
 
          while (nextArg) {
 
-            if (find_file (_state.paths, file, foundFile)) {
-
-               if (!read_config_file (foundFile, globalData, FileTypeAutoDetect, log)) {
-
-                  error = True;
-                  _state.error.flush () << "Unable to read config file: "<< foundFile;
-               }
-            }
+            if (find_file (_state.paths, file, foundFile)) { files.add (foundFile); }
             else {
 
                error = True;
@@ -118,8 +150,18 @@ dmz::CommandLineConfig::process_command_line (
       else { done  = !Opts.get_next_option (args); }
    }
 
-   if (!error) {
-
+   // Files found before a missing file are still read so the config context tree
+   // matches what was read when the files were parsed one at a time.
+   if (files.get_count () && !read_config_files_parallel (
+         files,
+         globalData,
+         _state.cacheDir,
+         _state.threadCount,
+         FileTypeAutoDetect,
+         log) && !error) {
+
+      error = True;
+      _state.error.flush () << "Unable to read config files";
    }
 
    return !error;
@@ -19,6 +19,8 @@ namespace dmz {
          ~CommandLineConfig ();
 
          void set_search_path (const StringContainer &Container);
+         void set_cache_directory (const String &Path);
+         void set_thread_count (const Int32 Count);
 
          Boolean process_command_line (
             const CommandLine &Opts,
@@ -8,12 +8,20 @@
 #include <dmzFoundationXMLUtil.h>
 #include <dmzFoundationReaderWriterFile.h>
 #include <dmzFoundationReaderWriterZip.h>
+#include <dmzFoundationSHA.h>
 #include <dmzRuntimeConfig.h>
 #include <dmzRuntimeConfigToTypesBase.h>
 #include <dmzRuntimeLog.h>
 #include <dmzSystem.h>
 #include <dmzSystemFile.h>
+#include <dmzSystemMarshal.h>
+#include <dmzSystemMutex.h>
 #include <dmzSystemStreamFile.h>
+#include <dmzSystemThread.h>
+#include <dmzSystemThreadPool.h>
+#include <dmzSystemUnmarshal.h>
+
+#include <stdio.h> // for fwrite and rename
 
 /*!
 
@@ -83,7 +91,11 @@ local_file_type (const UInt32 Type, const String &FileName, Log *log) {
 
 
 static Boolean
-local_read_file (const String &ArchiveName, Reader &reader, Parser &parser, Log *log) {
+local_read_file (
+      const String &ArchiveName,
+      Reader &reader,
+      Parser &parser,
+      String &error) {
 
    Boolean result (True);
 
@@ -100,19 +112,432 @@ local_read_file (const String &ArchiveName, Reader &reader, Parser &parser, Log
          done = True;
          result = False;
 
-         if (log) {
+         error.flush () << "In file: " << reader.get_file_name ();
+         if (ArchiveName) { error << " in zip archive: " << ArchiveName; }
+         error << " : " << parser.get_error ();
+      }
+      else if (Size < BufferSize) { done = True; }
+   }
+
+   return result;
+}
+
+
+static Boolean
+local_parse_file (
+      const String &ArchiveName,
+      Reader &reader,
+      const String &FileName,
+      const UInt32 Type,
+      Config &data,
+      String &error) {
+
+   Boolean result (True);
+
+   if (reader.open_file (FileName)) {
+
+      if (Type == FileTypeXML) {
+
+         ParserXML parser;
+         InterpreterXMLConfig interpreter (data);
+         parser.set_interpreter (&interpreter);
+
+         result = local_read_file (ArchiveName, reader, parser, error);
+      }
+      else if (Type == FileTypeJSON) {
+
+         ParserJSON parser;
+         InterpreterJSONConfig interpreter (data);
+         parser.set_interpreter (&interpreter);
+
+         result = local_read_file (ArchiveName, reader, parser, error);
+      }
+   }
+   else {
+
+      error.flush () << "Failed opening file: " << FileName;
+      if (ArchiveName) { error << " in zip archive: " << ArchiveName; }
+
+      result = False;
+   }
+
+   return result;
+}
+
+
+// The cache stores each parsed file as a Config tree marshaled in little endian byte
+// order. The file type is part of the header so a file whose extension changes is
+// parsed again. Increase CacheVersion if the layout changes.
+static const UInt32 CacheMagic = 0x434d5a44; // "DMZC"
+static const UInt32 CacheVersion = 1;
+static const UInt32 CacheEndMarker = 0x444e455f; // "_END"
+static const char CacheExtension[] = ".dmzcache";
+static const UInt8 CacheFormattedFlag = 0x01;
+static const UInt8 CacheInArrayFlag = 0x02;
+static const Int32 CacheMaxDepth = 256;
+
+
+// Values are stored by Config in unnamed child contexts so a node with an empty name
+// only holds a value.
+static void
+local_marshal_config (const Config &Data, Marshal &out) {
+
+   const String Name (Data.get_name ());
+
+   out.set_next_string (Name);
+   out.set_next_uint8 (
+      (Data.is_formatted () ? CacheFormattedFlag : 0) |
+      (Data.is_in_array () ? CacheInArrayFlag : 0));
+
+   if (!Name) {
+
+      String value;
+      Data.get_value (value);
+      out.set_next_string (value);
+   }
+   else {
+
+      ConfigIterator it;
+      String name, value;
+
+      Int32 count (0);
+
+      Boolean found (Data.get_first_attribute (it, name, value));
+      while (found) { count++; found = Data.get_next_attribute (it, name, value); }
+
+      out.set_next_int32 (count);
+
+      found = Data.get_first_attribute (it, name, value);
+
+      while (found) {
+
+         out.set_next_string (name);
+         out.set_next_string (value);
+         found = Data.get_next_attribute (it, name, value);
+      }
+
+      out.set_next_int32 (Data.get_config_count ());
+
+      Config child;
+      ConfigIterator childIt;
+
+      found = Data.get_first_config (childIt, child);
+
+      while (found) {
+
+         local_marshal_config (child, out);
+         found = Data.get_next_config (childIt, child);
+      }
+   }
+}
+
+
+static Boolean
+local_unmarshal_config (Unmarshal &in, Config &parent, const Int32 Depth) {
+
+   Boolean result (Depth < CacheMaxDepth);
+
+   String name, value;
+
+   in.get_next_string (name);
+
+   const UInt8 Flags (in.get_next_uint8 ());
+
+   if (result && !name) {
+
+      in.get_next_string (value);
+      result = parent.append_value (value, (Flags & CacheFormattedFlag) != 0);
+   }
+   else if (result) {
+
+      Config data (name);
 
-            log->error << "In file: " << reader.get_file_name ();
-            if (ArchiveName) { log->error << " in zip archive: " << ArchiveName; }
-            log->error << " : " << parser.get_error () << endl;
+      if (Flags & CacheInArrayFlag) { data.set_in_array (True); }
+
+      const Int32 AttrCount (in.get_next_int32 ());
+
+      result = (AttrCount >= 0) && (AttrCount <= (in.get_length () - in.get_place ()));
+
+      for (Int32 ix = 0; result && (ix < AttrCount); ix++) {
+
+         name.flush (); value.flush ();
+         in.get_next_string (name);
+         in.get_next_string (value);
+         result = data.store_attribute (name, value);
+      }
+
+      const Int32 ChildCount (result ? in.get_next_int32 () : -1);
+
+      result = (ChildCount >= 0) && (ChildCount <= (in.get_length () - in.get_place ()));
+
+      for (Int32 ix = 0; result && (ix < ChildCount); ix++) {
+
+         result = local_unmarshal_config (in, data, Depth + 1);
+      }
+
+      if (result) { result = parent.add_config (data); }
+   }
+
+   return result;
+}
+
+
+static String
+local_cache_file (const String &CacheDir, const String &FileName) {
+
+   String result;
+
+   if (CacheDir) {
+
+      const String Key (sha_from_file (FileName));
+
+      if (Key) { result.flush () << CacheDir << "/" << Key << CacheExtension; }
+   }
+
+   return result;
+}
+
+
+static Boolean
+local_read_cache (const String &CacheFile, const UInt32 Type, Config &data) {
+
+   Boolean result (False);
+
+   const Int32 Size (Int32 (get_file_size (CacheFile)));
+
+   FILE *file (Size > 0 ? open_file (CacheFile, "rb") : 0);
+
+   if (file) {
+
+      // Pad the buffer so a truncated string can not be read past the end.
+      char *buffer (new char[Size + 1]);
+
+      if (buffer && (read_file (file, Size, buffer) == Size)) {
+
+         buffer[Size] = '\0';
+
+         Unmarshal in (ByteOrderLittleEndian);
+         in.set_buffer (Size, buffer);
+
+         if ((in.get_next_uint32 () == CacheMagic) &&
+               (in.get_next_uint32 () == CacheVersion) &&
+               (in.get_next_uint32 () == Type)) {
+
+            const Int32 Count (in.get_next_int32 ());
+
+            result = (Count >= 0) && (Count <= Size);
+
+            for (Int32 ix = 0; result && (ix < Count); ix++) {
+
+               result = local_unmarshal_config (in, data, 0);
+            }
+
+            if (result) {
+
+               result = (in.get_next_uint32 () == CacheEndMarker) &&
+                  (in.get_place () == Size);
+            }
          }
+
+         in.clear ();
+      }
+
+      if (buffer) { delete []buffer; buffer = 0; }
+
+      close_file (file); file = 0;
+
+      if (!result) {
+
+         // Discard anything stored from a corrupt cache file before parsing the file.
+         Config tmp (data.get_name ());
+         data = tmp;
       }
-      else if (Size < BufferSize) { done = True; }
    }
 
    return result;
 }
 
+
+static void
+local_write_cache (
+      const String &CacheFile,
+      const UInt32 Type,
+      const Config &Data,
+      const Int32 Id) {
+
+   Marshal out (ByteOrderLittleEndian);
+
+   out.set_next_uint32 (CacheMagic);
+   out.set_next_uint32 (CacheVersion);
+   out.set_next_uint32 (Type);
+   out.set_next_int32 (Data.get_config_count ());
+
+   Config child;
+   ConfigIterator it;
+
+   Boolean found (Data.get_first_config (it, child));
+
+   while (found) {
+
+      local_marshal_config (child, out);
+      found = Data.get_next_config (it, child);
+   }
+
+   out.set_next_uint32 (CacheEndMarker);
+
+   // Write to a temporary file and rename it so a cache file is never seen partially
+   // written by another thread or process.
+   String tmpFile;
+   tmpFile.flush () << CacheFile << "." << Id << "." << get_time () << ".tmp";
+
+   FILE *file (open_file (tmpFile, "wb"));
+
+   if (file) {
+
+      Int32 length (0);
+      char *buffer (out.get_buffer (length));
+
+      const Boolean Written (
+         fwrite (buffer, 1, size_t (length), file) == size_t (length));
+
+      close_file (file); file = 0;
+
+      if (!Written || rename (tmpFile.get_buffer (), CacheFile.get_buffer ())) {
+
+         remove_file (tmpFile);
+      }
+   }
+}
+
+
+struct ConfigFileJob {
+
+   const String FileName;
+   const UInt32 Type;
+   const Boolean IsZip;
+   Config data;
+   String error;
+   Boolean result;
+   Boolean cached;
+   Float64 time;
+
+   ConfigFileJob (const String &TheFileName, const UInt32 TheType, const Boolean Zip) :
+         FileName (TheFileName),
+         Type (TheType),
+         IsZip (Zip),
+         data ("global"),
+         result (False),
+         cached (False),
+         time (0.0) {;}
+};
+
+
+struct ConfigFileQueue {
+
+   const String CacheDir;
+   const Int32 Count;
+   ConfigFileJob **jobs;
+   Mutex lock;
+   Int32 next;
+
+   ConfigFileQueue (const String &TheCacheDir, const Int32 TheCount) :
+         CacheDir (TheCacheDir),
+         Count (TheCount),
+         jobs (0),
+         next (0) {
+
+      if (Count > 0) {
+
+         jobs = new ConfigFileJob *[Count];
+         for (Int32 ix = 0; ix < Count; ix++) { jobs[ix] = 0; }
+      }
+   }
+
+   ~ConfigFileQueue () {
+
+      if (jobs) {
+
+         for (Int32 ix = 0; ix < Count; ix++) {
+
+            if (jobs[ix]) { delete jobs[ix]; jobs[ix] = 0; }
+         }
+
+         delete []jobs; jobs = 0;
+      }
+   }
+
+   ConfigFileJob *get_next_job () {
+
+      ConfigFileJob *result (0);
+
+      lock.lock ();
+         while (!result && (next < Count)) {
+
+            // Zip archives are read by the calling thread so they may log.
+            if (jobs[next] && !jobs[next]->IsZip) { result = jobs[next]; }
+            next++;
+         }
+      lock.unlock ();
+
+      return result;
+   }
+
+   void run_jobs (const Int32 Id) {
+
+      ReaderFile reader;
+      ConfigFileJob *job (get_next_job ());
+
+      while (job) {
+
+         const Float64 StartTime = get_time ();
+
+         const String CacheFile (local_cache_file (CacheDir, job->FileName));
+
+         if (CacheFile && local_read_cache (CacheFile, job->Type, job->data)) {
+
+            job->cached = True;
+            job->result = True;
+         }
+         else {
+
+            job->result = local_parse_file (
+               "",
+               reader,
+               job->FileName,
+               job->Type,
+               job->data,
+               job->error);
+
+            if (job->result && CacheFile) {
+
+               local_write_cache (CacheFile, job->Type, job->data, Id);
+            }
+         }
+
+         job->time = get_time () - StartTime;
+
+         job = get_next_job ();
+      }
+   }
+};
+
+
+class ConfigFileWorker : public ThreadFunction {
+
+   public:
+      ConfigFileWorker (ConfigFileQueue &queue, const Int32 Id) :
+            _queue (queue),
+            _Id (Id) {;}
+
+      virtual ~ConfigFileWorker () {;}
+
+      virtual void run_thread_function () { _queue.run_jobs (_Id); }
+
+   protected:
+      ConfigFileQueue &_queue;
+      const Int32 _Id;
+};
+
 };
 
 
@@ -283,48 +708,165 @@ dmz::read_config_files (
 
          const Float64 StartTime = get_time ();
 
-         if (reader->open_file (file)) {
+         String error;
 
-            if (RType == FileTypeXML) {
+         result = local_parse_file (ArchiveName, *reader, file, RType, data, error);
 
-               ParserXML parser;
-               InterpreterXMLConfig interpreter (data);
-               parser.set_interpreter (&interpreter);
+         if (result && log) {
 
-               result = local_read_file (ArchiveName, *reader, parser, log);
-            }
-            else if (RType == FileTypeJSON) {
+            log->info << "Parsed file: " << file;
+            if (ArchiveName) { log->info << " from archive: " << ArchiveName; }
+            log->info << " (" << get_time () - StartTime << "sec)" << endl;
+         }
+         else if (!result && log) { log->error << error << endl; }
+      }
+   }
 
-               ParserJSON parser;
-               InterpreterJSONConfig interpreter (data);
-               parser.set_interpreter (&interpreter);
+   if (reader) { delete reader; reader = 0; }
 
-               result = local_read_file (ArchiveName, *reader, parser, log);
-            }
+   return result;
+}
+
+
+/*!
 
-            if (result && log) {
+\brief Reads a list of Config files in parallel.
+\ingroup Foundation
+\details Config files are parsed on worker threads and the results are added to \a data
+in the same order as they appear in \a Files. Zip archives are read by the calling
+thread. If \a CacheDir is specified, each parsed Config file is also stored in the
+directory in a binary form keyed by the SHA-1 of the file's contents. An unchanged file is
+then loaded from the cache instead of being parsed. Stale entries are never read since a
+changed file produces a new key. A file that fails to parse is logged and skipped. The
+files after it are still added to \a data.
+\param[in] Files StringContainer containing the list of Config files to read.
+\param[out] data Config object used to store parsed Config data.
+\param[in] CacheDir String containing the directory used to cache parsed Config files.
+Caching is disabled if the String is empty. The directory is created if it does not
+exist.
+\param[in] ThreadCount Maximum number of threads, including the calling thread, used to
+parse the Config files.
+\param[in] Type File type.
+\param[in] log Pointer to the Log to use for reporting.
+\return Returns dmz::True if every file was read without errors.
+\sa dmz::read_config_files
+
+*/
+dmz::Boolean
+dmz::read_config_files_parallel (
+      const StringContainer &Files,
+      Config &data,
+      const String &CacheDir,
+      const Int32 ThreadCount,
+      const UInt32 Type,
+      Log *log) {
+
+   Boolean result (True);
+
+   if (!data) {
+
+      Config tmp ("global");
+      data = tmp;
+   }
+
+   String cacheDir (CacheDir);
+
+   if (cacheDir && !is_directory (cacheDir) && !create_directory (cacheDir)) {
+
+      if (log) {
+
+         log->warn << "Unable to create config cache directory: " << cacheDir << endl;
+      }
+
+      cacheDir.flush ();
+   }
+
+   ConfigFileQueue queue (cacheDir, Files.get_count ());
+
+   StringContainerIterator it;
+   String file;
+   Int32 count (0);
+   Int32 parseCount (0);
+
+   while (Files.get_next (it, file) && (count < queue.Count)) {
+
+      const Boolean IsZip (is_zip_file (file));
+
+      queue.jobs[count] =
+         new ConfigFileJob (file, IsZip ? Type : local_file_type (Type, file, log), IsZip);
+
+      if (!IsZip) { parseCount++; }
+      count++;
+   }
+
+   const Int32 WorkerCount ((ThreadCount < parseCount ? ThreadCount : parseCount) - 1);
+
+   ThreadPool pool;
+   ConfigFileWorker **workers (WorkerCount > 0 ? new ConfigFileWorker *[WorkerCount] : 0);
+
+   if (workers) {
+
+      pool.set_thread_count (WorkerCount);
+
+      for (Int32 ix = 0; ix < WorkerCount; ix++) {
+
+         workers[ix] = new ConfigFileWorker (queue, ix + 1);
+         pool.add_task (*(workers[ix]));
+      }
+   }
+
+   for (Int32 ix = 0; ix < queue.Count; ix++) {
+
+      ConfigFileJob *job (queue.jobs[ix]);
+
+      if (job && job->IsZip) {
+
+         const Float64 StartTime = get_time ();
+         job->result = read_config_file (job->FileName, job->data, job->Type, log);
+         job->time = get_time () - StartTime;
+      }
+   }
+
+   queue.run_jobs (0);
+
+   if (workers) {
 
-               log->info << "Parsed file: " << file;
-               if (ArchiveName) { log->info << " from archive: " << ArchiveName; }
-               log->info << " (" << get_time () - StartTime << "sec)" << endl;
+      pool.wait ();
+
+      for (Int32 ix = 0; ix < WorkerCount; ix++) { delete workers[ix]; workers[ix] = 0; }
+
+      delete []workers; workers = 0;
+   }
+
+   for (Int32 ix = 0; ix < queue.Count; ix++) {
+
+      ConfigFileJob *job (queue.jobs[ix]);
+
+      if (job) {
+
+         if (job->result) {
+
+            data.add_children (job->data);
+
+            if (log && !job->IsZip) {
+
+               log->info << (job->cached ? "Loaded cached file: " : "Parsed file: ")
+                  << job->FileName << " (" << job->time << "sec)" << endl;
             }
          }
          else {
 
-            if (log) {
+            result = False;
 
-               log->error << "Failed opening file: " << file;
-               if (ArchiveName) { log->error << " in zip archive: " << ArchiveName; }
-               log->error  << endl;
-            }
+            if (log && job->error) { log->error << job->error << endl; }
+            else if (log) {
 
-            result = False;
+               log->error << "Unable to read config file: " << job->FileName << endl;
+            }
          }
       }
    }
 
-   if (reader) { delete reader; reader = 0; }
-
    return result;
 }
 
@@ -38,6 +38,15 @@ read_config_files (
    const UInt32 Type = FileTypeAutoDetect,
    Log *log = 0);
 
+DMZ_FOUNDATION_LINK_SYMBOL Boolean
+read_config_files_parallel (
+   const StringContainer &Files,
+   Config &data,
+   const String &CacheDir,
+   const Int32 ThreadCount,
+   const UInt32 Type = FileTypeAutoDetect,
+   Log *log = 0);
+
 DMZ_FOUNDATION_LINK_SYMBOL Boolean
 write_config_file (
    const String &ArchiveName,
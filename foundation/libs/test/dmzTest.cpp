@@ -90,6 +90,35 @@ dmz::Test::failed () {
 }
 
 
+/*!
+
+\brief Logs the time taken by a benchmark.
+\details Writes the elapsed time since \a StartTime and the average time per unit to the
+log.
+\param[in] Name String containing the name of the benchmark.
+\param[in] StartTime Time returned by dmz::get_time when the benchmark started.
+\param[in] Count Number of units processed by the benchmark.
+\param[in] Unit String containing the name of a single unit.
+\return Returns the elapsed time in seconds.
+
+*/
+dmz::Float64
+dmz::Test::report_time (
+      const String &Name,
+      const Float64 StartTime,
+      const Int32 Count,
+      const String &Unit) {
+
+   const Float64 Elapsed (get_time () - StartTime);
+
+   log.out << Name << ": " << Count << " " << Unit << "s in " << Elapsed << " seconds ("
+      << (Count > 0 ? (Elapsed * 1.0e9) / Float64 (Count) : 0.0) << " ns/" << Unit << ")"
+      << endl;
+
+   return Elapsed;
+}
+
+
 /*!
 
 \brief Get test result.
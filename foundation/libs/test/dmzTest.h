@@ -22,6 +22,12 @@ namespace dmz {
          void failed ();
          Int32 result ();
 
+         Float64 report_time (
+            const String &Name,
+            const Float64 StartTime,
+            const Int32 Count,
+            const String &Unit = "iteration");
+
          Runtime rt; //!< Runtime object.
          LogObserverBasic obs; //!< Basic log observer.
          Config config; //!< Root of config context tree.
@@ -9,7 +9,17 @@
 \ingroup Foundation
 \brief Performs and undo or redo when a message is received.
 \details The default Message name to perform an undo is "Plugin_Undo_Message" and
-the default Message to perform a redo is "Plugin_Redo_Message".
+the default Message to perform a redo is "Plugin_Redo_Message". The memory used by the
+runtime undo may be bounded with the memory-budget.value attribute given in megabytes.
+\code
+<dmz>
+<dmzPluginUndo>
+   <undo name="Plugin_Undo_Message"/>
+   <redo name="Plugin_Redo_Message"/>
+   <memory-budget value="64"/>
+</dmzPluginUndo>
+</dmz>
+\endcode
 
 */
 
@@ -64,6 +74,13 @@ dmz::PluginUndo::_init (Config &local) {
 
    subscribe_to_message (_undoMessage);
    subscribe_to_message (_redoMessage);
+
+   const Float64 BudgetMB (config_to_float64 ("memory-budget.value", local, 0.0));
+
+   if (BudgetMB > 0.0) {
+
+      _undo.set_memory_budget (UInt64 (BudgetMB * 1024.0 * 1024.0));
+   }
 }
 
 //! \endcond
@@ -6,13 +6,16 @@
 \ingroup Audio
 \brief Audio instance initialization parameters.
 \details Provides a container for getting and setting a sound instance's initialization
-parameters such as looped and relative. All parameters default to dmz::False.
+parameters such as looped and relative. All parameters default to dmz::False. The
+priority is used to decide which sounds are heard when there are more sounds playing
+than the audio module has voices. It defaults to 1.0.
 
 */
 
 struct dmz::SoundInit::State {
 
    Boolean values[SoundMaxEnumValue];
+   Float64 priority;
 
    State &operator= (const State &TheState) {
 
@@ -21,10 +24,12 @@ struct dmz::SoundInit::State {
          values[ix] = TheState.values[ix];
       }
 
+      priority = TheState.priority;
+
       return *this;
    }
 
-   State () {
+   State () : priority (1.0) {
 
       for (Int32 ix = 0; ix < SoundMaxEnumValue; ix++) {
 
@@ -90,3 +95,22 @@ dmz::SoundInit::get (const SoundInitEnum Type) const {
 
    return result;
 }
+
+
+/*!
+
+\brief Sets the priority of the sound instance.
+\param[in] Value The priority. Sounds with a higher priority are more likely to be
+heard when there are not enough voices for every sound.
+
+*/
+void
+dmz::SoundInit::set_priority (const Float64 Value) {
+
+   _state.priority = Value > 0.0 ? Value : 0.0;
+}
+
+
+//! Gets the priority of the sound instance.
+dmz::Float64
+dmz::SoundInit::get_priority () const { return _state.priority; }
@@ -28,6 +28,9 @@ namespace dmz {
          void set (const SoundInitEnum Type, const Boolean Value);
          Boolean get (const SoundInitEnum Type) const;
 
+         void set_priority (const Float64 Value);
+         Float64 get_priority () const;
+
       protected:
          struct State;
          State &_state; //!< Internal state.
@@ -0,0 +1,456 @@
+#include <dmzAudioSoundAttributes.h>
+#include <dmzAudioSoundInit.h>
+#include <dmzAudioVoiceManager.h>
+#include <dmzTypesHandleContainer.h>
+#include <dmzTypesHashTableHandleTemplate.h>
+#include <dmzTypesVector.h>
+
+#include <math.h>
+#include <stdlib.h> // qsort
+
+/*!
+
+\class dmz::VoiceManager
+\ingroup Audio
+\brief Decides which sound instances are given a voice.
+\details Audio back ends only have a limited number of voices. The voice manager ranks
+every playing sound instance by how audible it is and only the most audible instances
+are real voices. The rest are virtual voices. A virtual voice uses no back end resources
+but its play offset keeps advancing so that when it becomes a real voice again it
+resumes where it would have been had it played the whole time.
+
+The audibility of a sound instance is its priority multiplied by its gain and by the
+attenuation due to its distance from the listener. The attenuation uses the inverse
+distance clamped model:
+\code
+   distance = max (distance, reference)
+   attenuation = reference / (reference + (rolloff * (distance - reference)))
+\endcode
+A real voice is favored over a virtual voice of similar audibility so that voices do
+not swap every update.
+
+*/
+
+namespace {
+
+// Audibility multiplier applied to real voices when ranking.
+static const dmz::Float64 LocalRealBias = 1.2;
+
+struct VoiceStruct {
+
+   const dmz::Handle VoiceHandle;
+   const dmz::Boolean Looped;
+   const dmz::Boolean Relative;
+   const dmz::Float64 Priority;
+   const dmz::Float64 Length;
+   dmz::Vector pos;
+   dmz::Float64 gain;
+   dmz::Float64 pitch;
+   dmz::Float64 offset;
+   dmz::Float64 score;
+   dmz::Boolean real;
+
+   VoiceStruct (
+         const dmz::Handle TheVoiceHandle,
+         const dmz::SoundInit &Init,
+         const dmz::Float64 TheLength) :
+         VoiceHandle (TheVoiceHandle),
+         Looped (Init.get (dmz::SoundLooped)),
+         Relative (Init.get (dmz::SoundRelative)),
+         Priority (Init.get_priority ()),
+         Length (TheLength > 0.0 ? TheLength : 0.0),
+         gain (1.0),
+         pitch (1.0),
+         offset (0.0),
+         score (0.0),
+         real (dmz::False) {;}
+
+   void set_attributes (const dmz::SoundAttributes &Attributes) {
+
+      Attributes.get_position (pos);
+      gain = Attributes.get_gain_scale ();
+      pitch = Attributes.get_pitch_scale ();
+   }
+};
+
+
+static int
+local_compare (const void *Value1, const void *Value2) {
+
+   const VoiceStruct *Voice1 (*((const VoiceStruct **)Value1));
+   const VoiceStruct *Voice2 (*((const VoiceStruct **)Value2));
+
+   // Sorted from most to least audible. Older voices win ties.
+   return Voice1->score > Voice2->score ? -1 :
+      (Voice1->score < Voice2->score ? 1 :
+      (Voice1->VoiceHandle < Voice2->VoiceHandle ? -1 :
+      (Voice1->VoiceHandle > Voice2->VoiceHandle ? 1 : 0)));
+}
+
+};
+
+
+struct dmz::VoiceManager::State {
+
+   Int32 maxVoices;
+   Int32 realCount;
+   Float64 reference;
+   Float64 rolloff;
+   Vector listener;
+   HashTableHandleTemplate<VoiceStruct> voiceTable;
+   VoiceStruct **rank;
+   Int32 rankSize;
+
+   Float64 audibility (const VoiceStruct &Voice) const;
+   void set_real (VoiceStruct &voice, const Boolean Real);
+
+   State () :
+         maxVoices (0),
+         realCount (0),
+         reference (1.0),
+         rolloff (1.0),
+         rank (0),
+         rankSize (0) {;}
+
+   ~State () {
+
+      voiceTable.empty ();
+      if (rank) { delete []rank; rank = 0; }
+   }
+};
+
+
+dmz::Float64
+dmz::VoiceManager::State::audibility (const VoiceStruct &Voice) const {
+
+   Float64 distance (Voice.Relative ?
+      Voice.pos.magnitude () : (Voice.pos - listener).magnitude ());
+
+   if (distance < reference) { distance = reference; }
+
+   const Float64 Divisor (reference + (rolloff * (distance - reference)));
+
+   const Float64 Attenuation (Divisor > 0.0 ? reference / Divisor : 1.0);
+
+   return Voice.Priority * (Voice.gain > 0.0 ? Voice.gain : 0.0) * Attenuation;
+}
+
+
+void
+dmz::VoiceManager::State::set_real (VoiceStruct &voice, const Boolean Real) {
+
+   if (voice.real != Real) {
+
+      voice.real = Real;
+      if (Real) { realCount++; } else { realCount--; }
+   }
+}
+
+
+//! Constructor.
+dmz::VoiceManager::VoiceManager () : _state (*(new State)) {;}
+
+
+//! Destructor.
+dmz::VoiceManager::~VoiceManager () { delete &_state; }
+
+
+/*!
+
+\brief Sets the maximum number of real voices.
+\details The change takes effect the next time dmz::VoiceManager::update is called.
+\param[in] Count Maximum number of real voices. Zero allows any number of real voices.
+Defaults to zero.
+
+*/
+void
+dmz::VoiceManager::set_max_voices (const Int32 Count) {
+
+   _state.maxVoices = Count > 0 ? Count : 0;
+}
+
+
+//! Returns the maximum number of real voices.
+dmz::Int32
+dmz::VoiceManager::get_max_voices () const { return _state.maxVoices; }
+
+
+//! Sets the distance at which sounds start to attenuate. Defaults to 1.0.
+void
+dmz::VoiceManager::set_reference_distance (const Float64 Distance) {
+
+   _state.reference = Distance > 0.0 ? Distance : 0.0;
+}
+
+
+//! Returns the distance at which sounds start to attenuate.
+dmz::Float64
+dmz::VoiceManager::get_reference_distance () const { return _state.reference; }
+
+
+//! Sets how quickly sounds attenuate with distance. Defaults to 1.0.
+void
+dmz::VoiceManager::set_rolloff_factor (const Float64 Factor) {
+
+   _state.rolloff = Factor > 0.0 ? Factor : 0.0;
+}
+
+
+//! Returns how quickly sounds attenuate with distance.
+dmz::Float64
+dmz::VoiceManager::get_rolloff_factor () const { return _state.rolloff; }
+
+
+//! Sets the position of the listener.
+void
+dmz::VoiceManager::set_listener_position (const Vector &Position) {
+
+   _state.listener = Position;
+}
+
+
+//! Returns the position of the listener.
+dmz::Vector
+dmz::VoiceManager::get_listener_position () const { return _state.listener; }
+
+
+/*!
+
+\brief Adds a sound instance.
+\details The new voice is real if there is a free voice. Otherwise it is virtual until
+it is ranked by the next call to dmz::VoiceManager::update.
+\param[in] VoiceHandle Handle of the sound instance.
+\param[in] Init Initialization parameters of the sound instance.
+\param[in] Attributes Attributes of the sound instance.
+\param[in] Length Length of the sound in seconds. Virtual voices that are not looped
+expire once they have played their whole length. A length of zero never expires.
+\return Returns dmz::True if the voice was added.
+
+*/
+dmz::Boolean
+dmz::VoiceManager::add_voice (
+      const Handle VoiceHandle,
+      const SoundInit &Init,
+      const SoundAttributes &Attributes,
+      const Float64 Length) {
+
+   Boolean result (False);
+
+   VoiceStruct *voice (VoiceHandle ? new VoiceStruct (VoiceHandle, Init, Length) : 0);
+
+   if (voice) {
+
+      if (_state.voiceTable.store (VoiceHandle, voice)) {
+
+         voice->set_attributes (Attributes);
+
+         if (!_state.maxVoices || (_state.realCount < _state.maxVoices)) {
+
+            _state.set_real (*voice, True);
+         }
+
+         result = True;
+      }
+      else { delete voice; voice = 0; }
+   }
+
+   return result;
+}
+
+
+/*!
+
+\brief Updates the attributes of a sound instance.
+\param[in] VoiceHandle Handle of the sound instance.
+\param[in] Attributes New attributes of the sound instance.
+\return Returns dmz::True if the voice was found.
+
+*/
+dmz::Boolean
+dmz::VoiceManager::update_voice (
+      const Handle VoiceHandle,
+      const SoundAttributes &Attributes) {
+
+   VoiceStruct *voice (_state.voiceTable.lookup (VoiceHandle));
+
+   if (voice) { voice->set_attributes (Attributes); }
+
+   return voice != 0;
+}
+
+
+//! Removes a sound instance. Returns dmz::True if the voice was found.
+dmz::Boolean
+dmz::VoiceManager::remove_voice (const Handle VoiceHandle) {
+
+   Boolean result (False);
+
+   VoiceStruct *voice (_state.voiceTable.remove (VoiceHandle));
+
+   if (voice) {
+
+      _state.set_real (*voice, False);
+      delete voice; voice = 0;
+      result = True;
+   }
+
+   return result;
+}
+
+
+//! Removes all sound instances.
+void
+dmz::VoiceManager::clear () {
+
+   _state.voiceTable.empty ();
+   _state.realCount = 0;
+}
+
+
+//! Returns the number of sound instances.
+dmz::Int32
+dmz::VoiceManager::get_voice_count () const { return _state.voiceTable.get_count (); }
+
+
+//! Returns the number of real voices.
+dmz::Int32
+dmz::VoiceManager::get_real_voice_count () const { return _state.realCount; }
+
+
+//! Returns dmz::True if the sound instance is a real voice.
+dmz::Boolean
+dmz::VoiceManager::is_real_voice (const Handle VoiceHandle) const {
+
+   VoiceStruct *voice (_state.voiceTable.lookup (VoiceHandle));
+
+   return voice ? voice->real : False;
+}
+
+
+/*!
+
+\brief Gets the play offset of a sound instance.
+\details A back end should start a promoted voice at this offset so that it resumes
+seamlessly.
+\param[in] VoiceHandle Handle of the sound instance.
+\return Returns the offset in seconds from the start of the sound.
+
+*/
+dmz::Float64
+dmz::VoiceManager::get_offset (const Handle VoiceHandle) const {
+
+   VoiceStruct *voice (_state.voiceTable.lookup (VoiceHandle));
+
+   return voice ? voice->offset : 0.0;
+}
+
+
+//! Returns the audibility of the sound instance used to rank the voices.
+dmz::Float64
+dmz::VoiceManager::get_audibility (const Handle VoiceHandle) const {
+
+   VoiceStruct *voice (_state.voiceTable.lookup (VoiceHandle));
+
+   return voice ? _state.audibility (*voice) : 0.0;
+}
+
+
+/*!
+
+\brief Advances the voices and ranks them.
+\details Should be called once a frame. The play offset of every voice is advanced by
+the time delta scaled by its pitch. Virtual voices that are not looped and have played
+their whole length are removed. The voices are then ranked and the most audible are
+made real.
+\param[in] TimeDelta Time in seconds since the last update.
+\param[out] promoted Voices that became real. The back end should start them at the
+offset returned by dmz::VoiceManager::get_offset.
+\param[out] demoted Voices that became virtual. The back end should release their
+resources.
+\param[out] expired Virtual voices that finished playing. They have already been
+removed from the voice manager.
+
+*/
+void
+dmz::VoiceManager::update (
+      const Float64 TimeDelta,
+      HandleContainer &promoted,
+      HandleContainer &demoted,
+      HandleContainer &expired) {
+
+   promoted.clear ();
+   demoted.clear ();
+   expired.clear ();
+
+   const Int32 Count (_state.voiceTable.get_count ());
+
+   if (Count > _state.rankSize) {
+
+      if (_state.rank) { delete []_state.rank; _state.rank = 0; }
+      _state.rankSize = Count * 2;
+      _state.rank = new VoiceStruct *[_state.rankSize];
+   }
+
+   Int32 rankCount (0);
+
+   HashTableHandleIterator it;
+   VoiceStruct *voice (0);
+
+   while (_state.voiceTable.get_next (it, voice)) {
+
+      voice->offset += TimeDelta * (voice->pitch > 0.0 ? voice->pitch : 0.0);
+
+      if (voice->Length > 0.0 && voice->offset >= voice->Length) {
+
+         if (voice->Looped) { voice->offset = fmod (voice->offset, voice->Length); }
+         else if (!voice->real) { expired.add (voice->VoiceHandle); voice = 0; }
+      }
+
+      if (voice) { _state.rank[rankCount++] = voice; }
+   }
+
+   Handle expiredHandle (0);
+   HandleContainerIterator expiredIt;
+
+   while (expired.get_next (expiredIt, expiredHandle)) { remove_voice (expiredHandle); }
+
+   if (!_state.maxVoices || (rankCount <= _state.maxVoices)) {
+
+      for (Int32 ix = 0; ix < rankCount; ix++) {
+
+         voice = _state.rank[ix];
+
+         if (!voice->real) {
+
+            _state.set_real (*voice, True);
+            promoted.add (voice->VoiceHandle);
+         }
+      }
+   }
+   else {
+
+      for (Int32 ix = 0; ix < rankCount; ix++) {
+
+         voice = _state.rank[ix];
+         voice->score = _state.audibility (*voice);
+         if (voice->real) { voice->score *= LocalRealBias; }
+      }
+
+      qsort (_state.rank, rankCount, sizeof (VoiceStruct *), local_compare);
+
+      for (Int32 ix = 0; ix < rankCount; ix++) {
+
+         voice = _state.rank[ix];
+
+         const Boolean Real (ix < _state.maxVoices);
+
+         if (Real != voice->real) {
+
+            _state.set_real (*voice, Real);
+
+            if (Real) { promoted.add (voice->VoiceHandle); }
+            else { demoted.add (voice->VoiceHandle); }
+         }
+      }
+   }
+}
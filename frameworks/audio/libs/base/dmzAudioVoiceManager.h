@@ -0,0 +1,68 @@
+#ifndef DMZ_AUDIO_VOICE_MANAGER_DOT_H
+#define DMZ_AUDIO_VOICE_MANAGER_DOT_H
+
+#include <dmzAudioBaseExport.h>
+#include <dmzTypesBase.h>
+
+namespace dmz {
+
+   class HandleContainer;
+   class SoundAttributes;
+   class SoundInit;
+   class Vector;
+
+   class DMZ_AUDIO_BASE_LINK_SYMBOL VoiceManager {
+
+      public:
+         VoiceManager ();
+         ~VoiceManager ();
+
+         void set_max_voices (const Int32 Count);
+         Int32 get_max_voices () const;
+
+         void set_reference_distance (const Float64 Distance);
+         Float64 get_reference_distance () const;
+
+         void set_rolloff_factor (const Float64 Factor);
+         Float64 get_rolloff_factor () const;
+
+         void set_listener_position (const Vector &Position);
+         Vector get_listener_position () const;
+
+         Boolean add_voice (
+            const Handle VoiceHandle,
+            const SoundInit &Init,
+            const SoundAttributes &Attributes,
+            const Float64 Length);
+
+         Boolean update_voice (
+            const Handle VoiceHandle,
+            const SoundAttributes &Attributes);
+
+         Boolean remove_voice (const Handle VoiceHandle);
+         void clear ();
+
+         Int32 get_voice_count () const;
+         Int32 get_real_voice_count () const;
+
+         Boolean is_real_voice (const Handle VoiceHandle) const;
+         Float64 get_offset (const Handle VoiceHandle) const;
+         Float64 get_audibility (const Handle VoiceHandle) const;
+
+         void update (
+            const Float64 TimeDelta,
+            HandleContainer &promoted,
+            HandleContainer &demoted,
+            HandleContainer &expired);
+
+      protected:
+         struct State;
+         State &_state; //!< Internal state.
+
+      private:
+         VoiceManager (const VoiceManager &);
+         VoiceManager &operator= (const VoiceManager &);
+   };
+};
+
+#endif // DMZ_AUDIO_VOICE_MANAGER_DOT_H
@@ -7,9 +7,20 @@
 \class dmz::WaveFile
 \ingroup Audio
 \brief Loads and parses standard WAV files.
+\details A WAV file may either be loaded into memory with dmz::WaveFile::load_file or
+opened as a stream with dmz::WaveFile::open_stream so that long files may be read in
+pieces with dmz::WaveFile::read_stream.
 
 */
 
+namespace {
+
+static const dmz::Int32 LocalHeaderSize = 12;
+static const dmz::Int32 LocalFormatSize = 24;
+
+};
+
+
 struct dmz::WaveFile::State {
 
    String fileName;
@@ -20,9 +31,21 @@ struct dmz::WaveFile::State {
    UInt32 bps;
    UInt32 size;
    char *buffer;
+   FILE *file;
+   long dataOffset;
+   UInt32 dataSize;
+   UInt32 position;
+
+   void close () {
+
+      if (file) { close_file (file); file = 0; }
+      dataOffset = 0;
+      position = 0;
+   }
 
    void clear () {
 
+      close ();
       fileName.empty ();
       error.empty ();
       format = 0;
@@ -30,21 +53,179 @@ struct dmz::WaveFile::State {
       frequency = 0;
       bps = 0;
       size = 0;
+      dataSize = 0;
       if (buffer) { delete []buffer; buffer = 0; }
    }
 
+   Boolean skip (const Int32 Size) {
+
+      return (Size >= 0) && (fseek (file, Size, SEEK_CUR) == 0);
+   }
+
+   Boolean open (const String &FileName);
+
    State () :
          format (0),
          channels (0),
          frequency (0),
          bps (0),
          size (0),
-         buffer (0) {;}
+         buffer (0),
+         file (0),
+         dataOffset (0),
+         dataSize (0),
+         position (0) {;}
 
    ~State () { clear (); }
 };
 
 
+// Parses the headers and leaves the file positioned at the start of the audio data.
+dmz::Boolean
+dmz::WaveFile::State::open (const String &FileName) {
+
+   Boolean failed (False);
+
+   file = open_file (FileName, "rb");
+
+   if (file) {
+
+      fileName = FileName;
+
+      char header[LocalHeaderSize];
+      const Int32 HeaderSize = read_file (file, LocalHeaderSize, header);
+
+      if (HeaderSize == LocalHeaderSize) {
+
+         Unmarshal out (ByteOrderLittleEndian);
+         out.set_buffer (HeaderSize, header);
+
+         String chunkID;
+         out.get_next_fixed_string (4, chunkID);
+         const UInt32 ChunkSize (out.get_next_uint32 ());
+         String format;
+         out.get_next_fixed_string (4, format);
+
+         if (chunkID != "RIFF") {
+
+            error.flush () << "Unsupported file type: " << chunkID;
+            failed = True;
+         }
+         else if (format != "WAVE") {
+
+            error.flush () << "Unsupported format: '" << format << "'";
+            failed = True;
+         }
+      }
+      else {
+
+         error.flush () << "Unable to read wave file header";
+         failed = True;
+      }
+
+      if (!failed) {
+
+         char formatHeader[LocalFormatSize];
+
+         const Int32 FormatSize = read_file (file, LocalFormatSize, formatHeader);
+
+         if (FormatSize == LocalFormatSize) {
+
+            Unmarshal out (ByteOrderLittleEndian);
+            out.set_buffer (FormatSize, formatHeader);
+
+            String fmtID;
+            out.get_next_fixed_string (4, fmtID);
+            const Int32 ChunkSize (out.get_next_int32 ());
+            format = out.get_next_uint16 ();
+            channels = out.get_next_uint16 ();
+            frequency = out.get_next_uint32 ();
+            const UInt32 ByteRate (out.get_next_uint32 ());
+            const UInt16 BlockAlign (out.get_next_uint16 ());
+            bps = out.get_next_uint16 ();
+
+            if (fmtID != "fmt ") {
+
+               error.flush () << "Unknown sub chunk id: " << fmtID;
+               failed = True;
+            }
+
+            // Subtract of the standard part of the fmt header.
+            const Int32 Remainder (ChunkSize - 16);
+
+            if (!failed && (Remainder > 0) && !skip (Remainder)) {
+
+               error.flush () << "Inconsistent extra data in fmt data header.";
+               failed = True;
+            }
+         }
+         else {
+
+            error.flush () << "Unable to read wave file format header";
+            failed = True;
+         }
+      }
+
+      // Find the data!
+      Boolean done (False);
+
+      while (!done && !failed) {
+
+         char subchunk [8];
+         const Int32 SubChunkSize = read_file (file, 8, subchunk);
+
+         if (SubChunkSize == 8) {
+
+            Unmarshal out (ByteOrderLittleEndian);
+            out.set_buffer (SubChunkSize, subchunk);
+
+            String dataID;
+            out.get_next_fixed_string (4, dataID);
+            const Int32 DataSize (out.get_next_int32 ());
+
+            if (dataID == "data") {
+
+               done = True;
+
+               if (DataSize > 0) {
+
+                  dataSize = UInt32 (DataSize);
+                  dataOffset = ftell (file);
+                  position = 0;
+               }
+               else {
+
+                  error.flush () << "Data size is less than zero.";
+                  failed = True;
+               }
+            }
+            // Skip over unknown sub chunk. Chunks are padded to an even size.
+            else if (!skip (DataSize + (DataSize & 0x01))) {
+
+               error.flush () << "Inconsistent sub chunk size of type: " << dataID;
+               failed = True;
+            }
+         }
+         else {
+
+            error.flush () << "Failed Reading subchunk header while looking "
+               << " for data subchunk.";
+            failed = True;
+         }
+      }
+
+      if (failed) { close (); }
+   }
+   else {
+
+      error.flush () << "Unable to open wav file: " << FileName;
+      failed = True;
+   }
+
+   return !failed;
+}
+
+
 //! Default Constructor.
 dmz::WaveFile::WaveFile () : _state (*(new State)) {;}
 
@@ -72,33 +253,30 @@ dmz::WaveFile::~WaveFile () { delete &_state; }
 and empty string if no file was loaded.
 
 */
-dmz::String 
+dmz::String
 dmz::WaveFile::get_file_name () const { return _state.fileName; }
 
 
 /*!
 
 \brief Determines if the WAV file is valid.
-\return Returns dmz::True if the WAV file was successfully loaded.
+\return Returns dmz::True if the WAV file was successfully loaded or opened as a stream.
 
 */
 dmz::Boolean
-dmz::WaveFile::is_valid () const { return _state.buffer != 0; }
+dmz::WaveFile::is_valid () const { return (_state.buffer != 0) || (_state.file != 0); }
 
 
 /*!
 
 \brief Clears the class.
-\details All memory used to store the loaded WAV file is freed and the class instance
-is reset.
+\details All memory used to store the loaded WAV file is freed, any open stream is
+closed, and the class instance is reset.
 
 */
 void
-dmz::WaveFile::clear () { _state.clear (); } 
-
+dmz::WaveFile::clear () { _state.clear (); }
 
-static const dmz::Int32 LocalHeaderSize = 12;
-static const dmz::Int32 LocalFormatSize = 24;
 
 /*!
 
@@ -112,191 +290,121 @@ dmz::WaveFile::load_file (const String &FileName) {
 
    _state.clear ();
 
-   Boolean error (False);
-
-   FILE *f = open_file (FileName, "rb");
+   Boolean result (_state.open (FileName));
 
-   if (f) {
+   if (result) {
 
-      _state.fileName = FileName;
-
-      Boolean error (False);
-
-      char header[LocalHeaderSize];
-      const Int32 HeaderSize = read_file (f, LocalHeaderSize, header);
-
-      if (HeaderSize == LocalHeaderSize) {
+      const UInt32 DataSize (_state.dataSize);
 
-         Unmarshal out (ByteOrderLittleEndian);
-         out.set_buffer (HeaderSize, header);
+      _state.buffer = new char[DataSize];
 
-         String chunkID;
-         out.get_next_fixed_string (4, chunkID);
-         const UInt32 ChunkSize (out.get_next_uint32 ());
-         String format;
-         out.get_next_fixed_string (4, format);
+      if (_state.buffer) {
 
-         if (chunkID != "RIFF") {
+         _state.size = read_file (_state.file, Int32 (DataSize), _state.buffer);
 
-            _state.error.flush () << "Unsupported file type: " << chunkID;
-            error = true;
-         }
-         else if (format != "WAVE") {
+         if (_state.size != DataSize) {
 
-            _state.error.flush () << "Unsupported format: '" << format << "'";
-            error = true;
+            UInt32 tmp (_state.size);
+            _state.clear ();
+            _state.error.flush () << "Read data size does not match "
+               << "data size specified in the sub chunk header. " << tmp
+               << " " << DataSize;
+            result = False;
          }
       }
       else {
 
-         _state.error.flush () << "Unable to read wave file header";
-         error = True;
+         _state.error.flush () << "Unable to allocate buffer of size: " << DataSize;
+         result = False;
       }
 
-      if (!error) {
-
-         char format[LocalFormatSize];
-
-         const Int32 FormatSize = read_file (f, LocalFormatSize, format);
-
-         if (FormatSize == LocalFormatSize) {
-
-            Unmarshal out (ByteOrderLittleEndian);
-            out.set_buffer (FormatSize, format);
-
-            String fmtID;
-            out.get_next_fixed_string (4, fmtID);
-            const Int32 ChunkSize (out.get_next_int32 ());
-            _state.format = out.get_next_uint16 ();
-            _state.channels = out.get_next_uint16 ();
-            _state.frequency = out.get_next_uint32 ();
-            const UInt32 ByteRate (out.get_next_uint32 ());
-            const UInt16 BlockAlign (out.get_next_uint16 ());
-            _state.bps = out.get_next_uint16 ();
-
-            if (fmtID != "fmt ") {
-
-               _state.error.flush () << "Unknown sub chunk id: " << fmtID;
-               error = True;
-            }
+      _state.close ();
+   }
 
-            // Subtract of the standard part of the fmt header.
-            const Int32 Remainder (ChunkSize - 16);
+   return result;
+}
 
-            if (!error && (Remainder > 0)) {
 
-               char buf = '\0';
-               Int32 count (0);
-               for (Int32 ix = 0; ix < Remainder; ix++) {
- 
-                  count += read_file (f, 1, &buf);
-               }
+/*!
 
-               if (count != Remainder) {
+\brief Opens a WAV file as a stream.
+\details Only the headers are read. The audio data is read with
+dmz::WaveFile::read_stream and the file is kept open until the class is cleared.
+\param[in] FileName String containing the name of the WAV file to open.
+\return Returns dmz::True if the WAV file was successfully opened.
 
-                  _state.error.flush () << "Inconsistent extra data in fmt data header.";
-                  error = True;
-               }
-            }
-         }
-         else {
-
-            _state.error.flush () << "Unable to read wave file format header";
-            error = True;
-         }
-      }
+*/
+dmz::Boolean
+dmz::WaveFile::open_stream (const String &FileName) {
 
-      // Find the data!
-      if (!error) {
+   _state.clear ();
 
-         Boolean done (False);
+   return _state.open (FileName);
+}
 
-         while (!done && !error) {
 
-            char subchunk [8];
-            const Int32 SubChunkSize = read_file (f, 8, subchunk);
+/*!
 
-            if (SubChunkSize == 8) {
+\brief Reads the next piece of an open stream.
+\param[in] Size Maximum number of bytes to read.
+\param[out] buffer Buffer to store the audio data in.
+\return Returns the number of bytes read. Returns zero at the end of the audio data.
 
-               Unmarshal out (ByteOrderLittleEndian);
-               out.set_buffer (SubChunkSize, subchunk);
+*/
+dmz::UInt32
+dmz::WaveFile::read_stream (const UInt32 Size, char *buffer) {
 
-               String dataID;
-               out.get_next_fixed_string (4, dataID);
-               const Int32 DataSize (out.get_next_int32 ());
+   UInt32 result (0);
 
-               if (dataID == "data") {
+   if (_state.file && buffer && (_state.position < _state.dataSize)) {
 
-                  done = True;
+      const UInt32 Remaining (_state.dataSize - _state.position);
 
-                  if (DataSize > 0) {
+      result = read_file (
+         _state.file,
+         Int32 (Size < Remaining ? Size : Remaining),
+         buffer);
 
-                     _state.buffer = new char[DataSize];
+      _state.position += result;
+   }
 
-                     if (_state.buffer) {
+   return result;
+}
 
-                        _state.size = read_file (f, DataSize, _state.buffer);
 
-                        if (_state.size != DataSize) {
+/*!
 
-                           UInt32 tmp (_state.size);
-                           _state.clear ();
-                           _state.error.flush () << "Read data size does not match "
-                              << "data size specified in the sub chunk header. " << tmp
-                              << " " << DataSize;
-                           error = True;
-                        }
-                     }
-                     else {
+\brief Moves an open stream back to the start of the audio data.
+\return Returns dmz::True if the stream was rewound.
 
-                        _state.error.flush () << "Unable to allocate buffer of size: "
-                           << DataSize;
-                        error = True;
-                     }
-                  }
-                  else {
+*/
+dmz::Boolean
+dmz::WaveFile::rewind_stream () { return seek_stream (0); }
 
-                     _state.error.flush () << "Data size is less than zero.";
-                     error = True;
-                  }
-               }
-               else {
 
-                  // Skip over unknown sub chunk
+/*!
 
-                  char buf = '\0';
-                  Int32 count (0);
-                  for (Int32 ix = 0; ix < DataSize; ix++) {
- 
-                     count += read_file (f, 1, &buf);
-                  }
+\brief Moves an open stream to a position in the audio data.
+\param[in] Position Offset in bytes from the start of the audio data. Positions past
+the end of the audio data move the stream to the end.
+\return Returns dmz::True if the stream was moved.
 
-                  if (DataSize != count) {
+*/
+dmz::Boolean
+dmz::WaveFile::seek_stream (const UInt32 Position) {
 
-                     _state.error.flush () << "Inconsistent sub chunk size of type: "
-                        << dataID;
-                     error = True;
-                  }
-               }
-            }
-            else {
+   Boolean result (False);
 
-               _state.error.flush () << "Failed Reading subchunk header while looking "
-                  << " for data subchunk.";
-               error = True;
-            }
-         }
-      }
+   const UInt32 Target (Position < _state.dataSize ? Position : _state.dataSize);
 
-      close_file (f);
-   }
-   else {
+   if (_state.file &&
+         (fseek (_state.file, _state.dataOffset + long (Target), SEEK_SET) == 0)) {
 
-      _state.error.flush () << "Unable to open wav file: " << FileName;
-      error = True;
+      _state.position = Target;
+      result = True;
    }
 
-   return error != True;
+   return result;
 }
 
 
@@ -320,6 +428,11 @@ dmz::UInt32
 dmz::WaveFile::get_bits_per_sample () const { return _state.bps; }
 
 
+//! Returns the size in bytes of the audio data specified in the WAV file.
+dmz::UInt32
+dmz::WaveFile::get_data_size () const { return _state.dataSize; }
+
+
 /*!
 
 \brief Gets the buffer containing the loaded WAV file.
@@ -340,4 +453,3 @@ dmz::WaveFile::get_audio_buffer (UInt32 &size) {
 dmz::String
 dmz::WaveFile::get_error () const { return _state.error; }
 
-
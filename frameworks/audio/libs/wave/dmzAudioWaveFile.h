@@ -26,10 +26,16 @@ namespace dmz {
 
          Boolean load_file (const String &FileName);
 
+         Boolean open_stream (const String &FileName);
+         UInt32 read_stream (const UInt32 Size, char *buffer);
+         Boolean rewind_stream ();
+         Boolean seek_stream (const UInt32 Position);
+
          UInt32 get_audio_format () const;
          UInt32 get_channel_count () const;
          UInt32 get_frequency () const;
          UInt32 get_bits_per_sample () const;
+         UInt32 get_data_size () const;
 
          char *get_audio_buffer (UInt32 &size);
 
@@ -38,6 +44,10 @@ namespace dmz {
       protected:
          struct State;
          State &_state; //!< Internal state.
+
+      private:
+         WaveFile (const WaveFile &);
+         WaveFile &operator= (const WaveFile &);
    };
 
 };
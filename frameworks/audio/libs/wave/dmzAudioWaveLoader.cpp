@@ -0,0 +1,321 @@
+#include <dmzAudioWaveFile.h>
+#include <dmzAudioWaveLoader.h>
+#include <dmzSystemMutex.h>
+#include <dmzSystemThread.h>
+#include <dmzSystemThreadPool.h>
+#include <dmzTypesString.h>
+#include <dmzTypesStringContainer.h>
+
+/*!
+
+\class dmz::WaveLoader
+\ingroup Audio
+\brief Loads WAV files on worker threads.
+\details Requested files are loaded by a pool of worker threads so that large files do
+not block the thread making the request. Loaded files are collected with
+dmz::WaveLoader::take_loaded_file, usually once a frame. A file that is already
+waiting to be loaded is only loaded once no matter how many times it is requested.
+The worker threads are started by dmz::WaveLoader::set_thread_count and wait for
+requests between loads. Setting the thread count to zero loads requested files
+immediately.
+
+*/
+
+namespace {
+
+struct LoadStruct {
+
+   const dmz::String FileName;
+   dmz::WaveFile *file;
+   LoadStruct *next;
+
+   LoadStruct (const dmz::String &TheFileName) :
+         FileName (TheFileName),
+         file (0),
+         next (0) {;}
+
+   ~LoadStruct () {
+
+      if (file) { delete file; file = 0; }
+      if (next) { delete next; next = 0; }
+   }
+};
+
+
+// The queue is shared between the thread making requests and the load workers. One pool
+// task is added for each job so an idle worker takes the next job when its task is run.
+struct LoadQueue {
+
+   dmz::Mutex lock;
+   dmz::Boolean stop;
+   LoadStruct *jobHead;
+   LoadStruct *jobTail;
+   LoadStruct *doneHead;
+   LoadStruct *doneTail;
+
+   LoadQueue () :
+         stop (dmz::False),
+         jobHead (0),
+         jobTail (0),
+         doneHead (0),
+         doneTail (0) {;}
+
+   ~LoadQueue () {
+
+      if (jobHead) { delete jobHead; jobHead = jobTail = 0; }
+      if (doneHead) { delete doneHead; doneHead = doneTail = 0; }
+   }
+
+   void add_job (LoadStruct *job) {
+
+      lock.lock ();
+         if (jobTail) { jobTail->next = job; }
+         else { jobHead = job; }
+         jobTail = job;
+      lock.unlock ();
+   }
+
+   LoadStruct *get_next_job () {
+
+      LoadStruct *result (0);
+
+      lock.lock ();
+         if (!stop && jobHead) {
+
+            result = jobHead;
+            jobHead = result->next;
+            if (!jobHead) { jobTail = 0; }
+            result->next = 0;
+         }
+      lock.unlock ();
+
+      return result;
+   }
+
+   void add_done (LoadStruct *job) {
+
+      lock.lock ();
+         if (doneTail) { doneTail->next = job; }
+         else { doneHead = job; }
+         doneTail = job;
+      lock.unlock ();
+   }
+
+   LoadStruct *take_done () {
+
+      lock.lock ();
+         LoadStruct *result (doneHead);
+
+         if (result) {
+
+            doneHead = result->next;
+            if (!doneHead) { doneTail = 0; }
+            result->next = 0;
+         }
+      lock.unlock ();
+
+      return result;
+   }
+};
+
+
+static void
+local_load (LoadStruct &job) {
+
+   job.file = new dmz::WaveFile;
+   if (job.file) { job.file->load_file (job.FileName); }
+}
+
+
+class LoadWorker : public dmz::ThreadFunction {
+
+   public:
+      LoadWorker (LoadQueue &queue) : _queue (queue) {;}
+      virtual ~LoadWorker () {;}
+
+      virtual void run_thread_function () {
+
+         LoadStruct *job (_queue.get_next_job ());
+
+         if (job) {
+
+            local_load (*job);
+            _queue.add_done (job);
+         }
+      }
+
+   protected:
+      LoadQueue &_queue;
+};
+
+};
+
+
+struct dmz::WaveLoader::State {
+
+   LoadQueue queue;
+   LoadWorker worker;
+   StringContainer pendingList;
+   ThreadPool pool;
+
+   void stop_workers ();
+
+   State () : worker (queue) { pool.set_thread_count (1); }
+
+   ~State () { stop_workers (); pool.set_thread_count (0); }
+};
+
+
+// Jobs that have not been started are left in the queue.
+void
+dmz::WaveLoader::State::stop_workers () {
+
+   queue.lock.lock ();
+      queue.stop = True;
+   queue.lock.unlock ();
+
+   pool.wait ();
+
+   queue.lock.lock ();
+      queue.stop = False;
+   queue.lock.unlock ();
+}
+
+
+//! Constructor.
+dmz::WaveLoader::WaveLoader () : _state (*(new State)) {;}
+
+
+//! Destructor. Waits for any running workers to finish.
+dmz::WaveLoader::~WaveLoader () { delete &_state; }
+
+
+/*!
+
+\brief Sets the number of worker threads.
+\details Waits for the current workers to load the files already requested before the
+new worker threads are started.
+\param[in] Count Number of worker threads. Zero loads requested files on the calling
+thread. Defaults to one.
+
+*/
+void
+dmz::WaveLoader::set_thread_count (const Int32 Count) {
+
+   _state.pool.set_thread_count (Count > 0 ? Count : 0);
+}
+
+
+//! Returns the number of worker threads.
+dmz::Int32
+dmz::WaveLoader::get_thread_count () const { return _state.pool.get_thread_count (); }
+
+
+/*!
+
+\brief Requests a WAV file be loaded.
+\param[in] FileName String containing the name of the WAV file to load.
+\return Returns dmz::True if the file was queued. Returns dmz::False if the file is
+already waiting to be loaded.
+
+*/
+dmz::Boolean
+dmz::WaveLoader::request_file (const String &FileName) {
+
+   Boolean result (False);
+
+   if (FileName && !_state.pendingList.contains (FileName) &&
+         _state.pendingList.add (FileName)) {
+
+      LoadStruct *job (new LoadStruct (FileName));
+
+      if (_state.pool.get_thread_count () > 0) {
+
+         _state.queue.add_job (job);
+         _state.pool.add_task (_state.worker);
+      }
+      else { local_load (*job); _state.queue.add_done (job); }
+
+      result = True;
+   }
+
+   return result;
+}
+
+
+/*!
+
+\brief Tests if a WAV file is waiting to be loaded or collected.
+\param[in] FileName String containing the name of the WAV file.
+\return Returns dmz::True if the file has been requested and not yet collected.
+
+*/
+dmz::Boolean
+dmz::WaveLoader::is_pending (const String &FileName) const {
+
+   return _state.pendingList.contains (FileName);
+}
+
+
+//! Returns the number of requested files that have not yet been collected.
+dmz::Int32
+dmz::WaveLoader::get_pending_count () const { return _state.pendingList.get_count (); }
+
+
+/*!
+
+\brief Collects the next loaded WAV file.
+\details Files are returned in the order they finish loading. A file that failed to
+load is still returned so the error may be reported.
+\return Returns a pointer to the loaded file. The caller is responsible for deleting
+the returned file. Returns NULL if no file has finished loading.
+
+*/
+dmz::WaveFile *
+dmz::WaveLoader::take_loaded_file () {
+
+   WaveFile *result (0);
+
+   LoadStruct *job (_state.queue.take_done ());
+
+   if (job) {
+
+      _state.pendingList.remove (job->FileName);
+
+      result = job->file;
+      job->file = 0;
+      delete job; job = 0;
+   }
+
+   return result;
+}
+
+
+/*!
+
+\brief Stops loading files.
+\details Waits for the workers to finish the file they are loading. Files waiting to
+be loaded and files that have not been collected are discarded.
+
+*/
+void
+dmz::WaveLoader::stop () {
+
+   _state.stop_workers ();
+
+   _state.queue.lock.lock ();
+      if (_state.queue.jobHead) {
+
+         delete _state.queue.jobHead;
+         _state.queue.jobHead = _state.queue.jobTail = 0;
+      }
+
+      if (_state.queue.doneHead) {
+
+         delete _state.queue.doneHead;
+         _state.queue.doneHead = _state.queue.doneTail = 0;
+      }
+   _state.queue.lock.unlock ();
+
+   _state.pendingList.clear ();
+}
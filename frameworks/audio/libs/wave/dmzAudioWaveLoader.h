@@ -0,0 +1,39 @@
+#ifndef DMZ_AUDIO_WAVE_LOADER_DOT_H
+#define DMZ_AUDIO_WAVE_LOADER_DOT_H
+
+#include <dmzAudioWaveExport.h>
+#include <dmzTypesBase.h>
+
+namespace dmz {
+
+   class String;
+   class WaveFile;
+
+   class DMZ_AUDIO_WAVE_LINK_SYMBOL WaveLoader {
+
+      public:
+         WaveLoader ();
+         ~WaveLoader ();
+
+         void set_thread_count (const Int32 Count);
+         Int32 get_thread_count () const;
+
+         Boolean request_file (const String &FileName);
+         Boolean is_pending (const String &FileName) const;
+         Int32 get_pending_count () const;
+
+         WaveFile *take_loaded_file ();
+
+         void stop ();
+
+      protected:
+         struct State;
+         State &_state; //!< Internal state.
+
+      private:
+         WaveLoader (const WaveLoader &);
+         WaveLoader &operator= (const WaveLoader &);
+   };
+};
+
+#endif // DMZ_AUDIO_WAVE_LOADER_DOT_H
@@ -1,17 +1,71 @@
 #include "dmzAudioModuleOpenAL.h"
+#include <dmzRuntimeConfig.h>
+#include <dmzRuntimeConfigToTypesBase.h>
 #include <dmzRuntimePluginFactoryLinkSymbol.h>
 #include <dmzRuntimePluginInfo.h>
 #include <dmzSystemFile.h>
+#include <dmzTypesHandleContainer.h>
 #include <dmzTypesMatrix.h>
 #include <dmzTypesVector.h>
+
 /*!
 
 \class dmz::AudioModuleOpenAL
 \ingroup Audio
 \brief OpenAL implementation of the audio module.
+\details Sounds are cached by absolute file name so each file is only loaded once.
+When load threads are specified, the audio data is loaded on worker threads and sounds
+played before their file is loaded start once it is. Files at least as large as the
+stream size are not loaded. Instead each played instance streams the file through a
+small queue of buffers.
+
+When a maximum number of voices is specified, only the most audible sounds are given
+an OpenAL source. The remaining sounds are virtual and resume at the correct offset
+once they become audible enough. See dmz::VoiceManager.
+\code
+<dmz>
+<dmzAudioModuleOpenAL>
+   <load threads="Int32"/>
+   <stream size="UInt32"/>
+   <voices max="Int32"/>
+</dmzAudioModuleOpenAL>
+</dmz>
+\endcode
+- \b load.threads Number of threads used to load audio files. Defaults to zero which
+loads files when the sound is created.
+- \b stream.size Size in bytes of the audio data at which files are streamed. Defaults
+to zero which never streams files.
+- \b voices.max Maximum number of sounds given an OpenAL source. Defaults to zero
+which gives every sound a source.
 
 */
- 
+
+namespace {
+
+static const dmz::UInt32 LocalStreamChunkSize = 65536;
+static const ALfloat LocalRolloffFactor = 0.1f;
+
+static ALenum
+local_format (const dmz::UInt32 Channels, const dmz::UInt32 BPS) {
+
+   ALenum result (0);
+
+   if (Channels == 1) {
+
+      if (BPS == 8) { result = AL_FORMAT_MONO8; }
+      else if (BPS == 16) { result = AL_FORMAT_MONO16; }
+   }
+   else if (Channels == 2) {
+
+      if (BPS == 8) { result = AL_FORMAT_STEREO8; }
+      else if (BPS == 16) { result = AL_FORMAT_STEREO16; }
+   }
+
+   return result;
+}
+
+};
+
 
 //! \cond
 dmz::AudioModuleOpenAL::AudioModuleOpenAL (const PluginInfo &Info, Config &local) :
@@ -20,7 +74,9 @@ dmz::AudioModuleOpenAL::AudioModuleOpenAL (const PluginInfo &Info, Config &local
       AudioModule (Info),
       _log (Info),
       _device (0),
-      _context (0) {
+      _context (0),
+      _streamSize (0),
+      _streamData (0) {
 
    _init (local);
 }
@@ -28,7 +84,11 @@ dmz::AudioModuleOpenAL::AudioModuleOpenAL (const PluginInfo &Info, Config &local
 
 dmz::AudioModuleOpenAL::~AudioModuleOpenAL () {
 
+   _loader.stop ();
+   _voices.clear ();
+
    _soundTimedTable.clear ();
+   _soundStreamTable.clear ();
    _soundTable.empty ();
    _bufferHandleTable.clear ();
 
@@ -54,6 +114,8 @@ dmz::AudioModuleOpenAL::~AudioModuleOpenAL () {
       alcCloseDevice (_device);
       _device = 0;
    }
+
+   if (_streamData) { delete []_streamData; _streamData = 0; }
 }
 
 
@@ -96,20 +158,36 @@ dmz::AudioModuleOpenAL::discover_plugin (
 void
 dmz::AudioModuleOpenAL::update_time_slice (const Float64 TimeDelta) {
 
+   _update_loaded_buffers ();
+   _update_voices (TimeDelta);
+
    HashTableHandleIterator it;
 
-   SoundStruct *ss (_soundTimedTable.get_first (it));
+   SoundStruct *ss (_soundStreamTable.get_first (it));
+
+   while (ss) {
+
+      _update_stream (*ss);
+      ss = _soundStreamTable.get_next (it);
+   }
+
+   it.reset ();
+
+   ss = _soundTimedTable.get_first (it);
 
    while (ss) {
 
       ALint value (0);
 
-      alGetSourcei (ss->source, AL_SOURCE_STATE, &value);
+      // Virtual voices have no source and are expired by the voice manager.
+      if (ss->source) { alGetSourcei (ss->source, AL_SOURCE_STATE, &value); }
 
       if (value == AL_STOPPED) {
 
          _soundTimedTable.remove (ss->Handle.get_runtime_handle ());
+         _soundStreamTable.remove (ss->Handle.get_runtime_handle ());
          _soundTable.remove (ss->Handle.get_runtime_handle ());
+         _voices.remove_voice (ss->Handle.get_runtime_handle ());
 
          delete ss; ss = 0;
       }
@@ -132,96 +210,85 @@ dmz::AudioModuleOpenAL::create_sound (const String &FileName) {
 
       if (!bs) {
 
-         bs = new BufferStruct (
-            absPath,
-            get_plugin_runtime_context (),
-            _bufferNameTable,
-            _bufferHandleTable);
+         // Only the headers are read here. The audio data is either loaded below,
+         // loaded by the worker threads, or streamed when the sound is played.
+         WaveFile header;
+         String error;
+         ALenum format (0);
 
-         if (bs &&
-               bs->file.is_valid () &&
-               (bs->file.get_audio_format () == WaveFormatPCM)) {
+         if (!header.open_stream (absPath)) { error = header.get_error (); }
+         else if (header.get_audio_format () != WaveFormatPCM) {
 
-            if (!_bufferNameTable.store (absPath, bs)) { bs->unref (); bs = 0; }
-            else { _bufferHandleTable.store (bs->Handle.get_runtime_handle (), bs); }
+            error = "Wave audio data is not PCM.";
          }
-         else if (bs) {
+         else {
 
-            if (bs->file.is_valid ()) {
+            format = local_format (
+               header.get_channel_count (),
+               header.get_bits_per_sample ());
 
-               _log.error << "Unable to load audio file: " << FileName << " because: "
-                  << " Wave audio data is not PCM." << endl;
-            }
-            else {
+            if (!format) {
 
-               _log.error << "Unable to load audio file: " << FileName << " because: "
-                  << bs->file.get_error () << endl;
+               error.flush () << "Unsupported format, channels: "
+                  << header.get_channel_count ()
+                  << " BPS: " << header.get_bits_per_sample ();
             }
-
-            bs->unref (); bs = 0;
          }
 
-         if (bs) {
-
-            alGenBuffers (1, &(bs->buffer));
-            ALenum format (0);
-            const UInt32 Channels (bs->file.get_channel_count ());
-            const UInt32 BPS (bs->file.get_bits_per_sample ());
+         if (error) {
 
-            if (Channels == 1) {
+            _log.error << "Unable to load audio file: " << FileName << " because: "
+               << error << endl;
+         }
+         else {
 
-               if (BPS == 8) { format = AL_FORMAT_MONO8; }
-               else if (BPS == 16) { format = AL_FORMAT_MONO16; }
-            }
-            else if (Channels == 2) {
+            bs = new BufferStruct (
+               absPath,
+               get_plugin_runtime_context (),
+               _bufferNameTable,
+               _bufferHandleTable);
 
-               if (BPS == 8) { format = AL_FORMAT_STEREO8; }
-               else if (BPS == 16) { format = AL_FORMAT_STEREO16; }
-            }
+            if (bs) {
 
-            UInt32 size (0);
-            ALvoid *data = (ALvoid *)(bs->file.get_audio_buffer (size));
+               bs->format = format;
+               bs->frequency = (ALsizei)header.get_frequency ();
+               bs->blockAlign =
+                  (header.get_channel_count () * header.get_bits_per_sample ()) / 8;
 
-            if (size && data && format) {
+               if (bs->frequency > 0) {
 
-               alBufferData (
-                  bs->buffer,
-                  format,
-                  data,
-                  (ALsizei)size,
-                  (ALsizei)bs->file.get_frequency ());
+                  bs->length = Float64 (header.get_data_size ()) /
+                     (Float64 (bs->frequency) * Float64 (bs->blockAlign));
+               }
 
-               ALenum error = alGetError ();
+               if (!_bufferNameTable.store (absPath, bs)) { bs->unref (); bs = 0; }
+               else { _bufferHandleTable.store (bs->Handle.get_runtime_handle (), bs); }
+            }
+         }
 
-               if (error != AL_NO_ERROR) {
+         if (bs) {
 
-                  _log.error << "Unable to bind file: " << FileName
-                     << " to OpenAL buffer." << endl;
+            if (_streamSize && (header.get_data_size () >= _streamSize)) {
 
-                  destroy_sound (bs->Handle.get_runtime_handle ());
-                  bs = 0;
-               }
-               else {
+               bs->stream = True;
+               _log.info << "Streaming audio file: " << bs->FileName << endl;
+            }
+            else if (_loader.get_thread_count () > 0) {
 
-                  _log.info << "Loaded audio file: " << bs->FileName << endl;
-                  bs->file.clear ();
-               }
+               bs->pending = True;
+               _loader.request_file (absPath);
             }
             else {
 
-               if (!size || !data) {
+               header.clear ();
 
-                  _log.error << "Unable to load wave data" << endl;
-               }
+               WaveFile file (absPath);
 
-               if (!format) {
+               if (!_load_buffer (*bs, file)) {
 
-                  _log.error << "Unsupported format, channels: " << Channels
-                     << " BPS: " << BPS << endl;
+                  destroy_sound (bs->Handle.get_runtime_handle ());
+                  bs = 0;
                }
-
-               destroy_sound (bs->Handle.get_runtime_handle ());
-               bs = 0;
             }
          }
       }
@@ -270,18 +337,6 @@ dmz::AudioModuleOpenAL::play_sound (
 
       if (_soundTable.store (result, ss)) {
 
-         alGenSources (1, &(ss->source));
-         alSourcei (ss->source, AL_BUFFER, bs->buffer);
-
-         alSourcei (
-            ss->source,
-            AL_SOURCE_RELATIVE,
-            Init.get (SoundRelative) ? AL_TRUE : AL_FALSE);
-
-         alSourcei (ss->source, AL_LOOPING, Init.get (SoundLooped) ? AL_TRUE : AL_FALSE);
-         alSourcef (ss->source, AL_GAIN, 1.0f);
-         alSourcef (ss->source, AL_ROLLOFF_FACTOR, 0.1f);
-
          if (!Init.get (SoundLooped)) {
 
             _soundTimedTable.store (result, ss);
@@ -290,14 +345,10 @@ dmz::AudioModuleOpenAL::play_sound (
          ss->attr = Attributes;
          ss->init = Init;
 
-         _update_sound (*ss);
-
-         alGetError ();
-         alSourcePlay (ss->source);
-         ALenum error;
-         if ((error = alGetError ()) != AL_NO_ERROR) {
+         if (!_voices.add_voice (result, Init, Attributes, bs->length) ||
+               _voices.is_real_voice (result)) {
 
-            _log.error << "Unable to play sound: " << alGetString (error) << endl;
+            _start_source (*ss, 0.0);
          }
       }
       else { delete ss; ss = 0; result = 0; }
@@ -318,7 +369,13 @@ dmz::AudioModuleOpenAL::update_sound (
 
    SoundStruct *ss (_soundTable.lookup (InstanceHandle));
 
-   if (ss) { ss->attr = Attributes; _update_sound (*ss); result = True; }
+   if (ss) {
+
+      ss->attr = Attributes;
+      _voices.update_voice (InstanceHandle, Attributes);
+      _update_sound (*ss);
+      result = True;
+   }
 
    return result;
 }
@@ -350,6 +407,8 @@ dmz::AudioModuleOpenAL::stop_sound (const Handle InstanceHandle) {
    if (ss) {
 
       _soundTimedTable.remove (InstanceHandle);
+      _soundStreamTable.remove (InstanceHandle);
+      _voices.remove_voice (InstanceHandle);
 
       delete ss; ss = 0;
       result = True;
@@ -425,6 +484,8 @@ dmz::AudioModuleOpenAL::set_listener (
       _listenerOri = Orientation;
       _listenerVel = Velocity;
 
+      _voices.set_listener_position (Position);
+
       Vector f (0.0, 0.0, -1.0);
       Vector up (0.0, 1.0, 0.0);
       Orientation.transform_vector (f);
@@ -495,35 +556,301 @@ dmz::AudioModuleOpenAL::destroy_listener (const Handle ListenerHandle) {
 void
 dmz::AudioModuleOpenAL::_update_sound (SoundStruct &ss) {
 
-   Vector vec;
+   // Virtual voices have no source to update.
+   if (ss.source) {
+
+      Vector vec;
+
+      ss.attr.get_position (vec);
+      alSource3f (
+         ss.source,
+         AL_POSITION,
+         (ALfloat)vec.get_x (),
+         (ALfloat)vec.get_y (),
+         (ALfloat)vec.get_z ());
+
+      ss.attr.get_velocity (vec);
+      alSource3f (
+         ss.source,
+         AL_VELOCITY,
+         (ALfloat)vec.get_x (),
+         (ALfloat)vec.get_y (),
+         (ALfloat)vec.get_z ());
+
+      alSourcef (ss.source, AL_GAIN, (ALfloat)ss.attr.get_gain_scale ());
+
+      Float64 Pitch (ss.attr.get_pitch_scale ());
+      ALfloat AdjustedPitch (Pitch < 0.1 ? (ALfloat)0.1f : (ALfloat)Pitch);
+      alSourcef (ss.source, AL_PITCH, AdjustedPitch);
+   }
+}
+
+
+dmz::Boolean
+dmz::AudioModuleOpenAL::_load_buffer (BufferStruct &bs, WaveFile &file) {
+
+   Boolean result (False);
+
+   UInt32 size (0);
+   ALvoid *data = (ALvoid *)(file.get_audio_buffer (size));
+
+   if (!file.is_valid ()) {
+
+      _log.error << "Unable to load audio file: " << bs.FileName << " because: "
+         << file.get_error () << endl;
+   }
+   else if (size && data) {
+
+      alGenBuffers (1, &(bs.buffer));
+      alBufferData (bs.buffer, bs.format, data, (ALsizei)size, bs.frequency);
+
+      ALenum error = alGetError ();
+
+      if (error != AL_NO_ERROR) {
+
+         _log.error << "Unable to bind file: " << bs.FileName
+            << " to OpenAL buffer." << endl;
+      }
+      else {
+
+         _log.info << "Loaded audio file: " << bs.FileName << endl;
+         result = True;
+      }
+   }
+   else { _log.error << "Unable to load wave data" << endl; }
+
+   return result;
+}
+
+
+// Binds the files loaded by the worker threads and starts the sounds that were
+// played while their file was loading.
+void
+dmz::AudioModuleOpenAL::_update_loaded_buffers () {
+
+   WaveFile *file (_loader.take_loaded_file ());
+
+   while (file) {
+
+      BufferStruct *bs (_bufferNameTable.lookup (file->get_file_name ()));
+
+      if (bs && bs->pending) {
+
+         bs->pending = False;
+
+         const Boolean Loaded (_load_buffer (*bs, *file));
+
+         HashTableHandleIterator it;
+
+         SoundStruct *ss (_soundTable.get_first (it));
 
-   ss.attr.get_position (vec);
-   alSource3f (
+         while (ss) {
+
+            if (ss->pending && (&(ss->buffer) == bs)) {
+
+               ss->pending = False;
+
+               if (Loaded) {
+
+                  alSourcei (ss->source, AL_BUFFER, bs->buffer);
+                  _play_source (*ss);
+               }
+               else { stop_sound (ss->Handle.get_runtime_handle ()); ss = 0; }
+            }
+
+            ss = _soundTable.get_next (it);
+         }
+      }
+
+      delete file; file = _loader.take_loaded_file ();
+   }
+}
+
+
+// Gives a sound an OpenAL source and starts it playing at the given offset.
+void
+dmz::AudioModuleOpenAL::_start_source (SoundStruct &ss, const Float64 Offset) {
+
+   alGenSources (1, &(ss.source));
+
+   alSourcei (
       ss.source,
-      AL_POSITION,
-      (ALfloat)vec.get_x (),
-      (ALfloat)vec.get_y (),
-      (ALfloat)vec.get_z ());
+      AL_SOURCE_RELATIVE,
+      ss.init.get (SoundRelative) ? AL_TRUE : AL_FALSE);
 
-   ss.attr.get_velocity (vec);
-   alSource3f (
+   // Streamed sounds are looped by rewinding the stream.
+   alSourcei (
       ss.source,
-      AL_VELOCITY,
-      (ALfloat)vec.get_x (),
-      (ALfloat)vec.get_y (),
-      (ALfloat)vec.get_z ());
+      AL_LOOPING,
+      (ss.init.get (SoundLooped) && !ss.buffer.stream) ? AL_TRUE : AL_FALSE);
+
+   alSourcef (ss.source, AL_GAIN, 1.0f);
+   alSourcef (ss.source, AL_ROLLOFF_FACTOR, LocalRolloffFactor);
+
+   _update_sound (ss);
+
+   if (ss.buffer.stream) { _start_stream (ss, Offset); }
+   else if (ss.buffer.pending) { ss.pending = True; }
+   else {
+
+      alSourcei (ss.source, AL_BUFFER, ss.buffer.buffer);
+
+      if (Offset > 0.0) { alSourcef (ss.source, AL_SEC_OFFSET, (ALfloat)Offset); }
+
+      _play_source (ss);
+   }
+}
+
+
+void
+dmz::AudioModuleOpenAL::_play_source (SoundStruct &ss) {
+
+   alGetError ();
+   alSourcePlay (ss.source);
+   ALenum error;
+   if ((error = alGetError ()) != AL_NO_ERROR) {
+
+      _log.error << "Unable to play sound: " << alGetString (error) << endl;
+   }
+}
+
+
+// Releases the sources of the sounds that became virtual voices and restarts the
+// sounds that became real voices.
+void
+dmz::AudioModuleOpenAL::_update_voices (const Float64 TimeDelta) {
+
+   HandleContainer promoted, demoted, expired;
+
+   _voices.update (TimeDelta, promoted, demoted, expired);
+
+   HandleContainerIterator it;
+   Handle instance (0);
+
+   while (demoted.get_next (it, instance)) {
+
+      SoundStruct *ss (_soundTable.lookup (instance));
+
+      if (ss) { _soundStreamTable.remove (instance); ss->release_source (); }
+   }
+
+   it.reset ();
+
+   while (promoted.get_next (it, instance)) {
+
+      SoundStruct *ss (_soundTable.lookup (instance));
+
+      if (ss && !ss->source) { _start_source (*ss, _voices.get_offset (instance)); }
+   }
 
-   alSourcef (ss.source, AL_GAIN, (ALfloat)ss.attr.get_gain_scale ());
+   it.reset ();
 
-   Float64 Pitch (ss.attr.get_pitch_scale ());
-   ALfloat AdjustedPitch (Pitch < 0.1 ? (ALfloat)0.1f : (ALfloat)Pitch);
-   alSourcef (ss.source, AL_PITCH, AdjustedPitch);
+   while (expired.get_next (it, instance)) { stop_sound (instance); }
+}
+
+
+void
+dmz::AudioModuleOpenAL::_start_stream (SoundStruct &ss, const Float64 Offset) {
+
+   ss.stream = new WaveFile;
+
+   if (ss.stream && _streamData && ss.stream->open_stream (ss.buffer.FileName)) {
+
+      if (Offset > 0.0) {
+
+         ss.stream->seek_stream (
+            UInt32 (Offset * Float64 (ss.buffer.frequency)) * ss.buffer.blockAlign);
+      }
+
+      alGenBuffers (SoundStruct::StreamBufferCount, ss.streamBuffers);
+
+      Int32 count (0);
+
+      while ((count < SoundStruct::StreamBufferCount) &&
+            _fill_stream_buffer (ss, ss.streamBuffers[count])) { count++; }
+
+      if (count > 0) {
+
+         alSourceQueueBuffers (ss.source, count, ss.streamBuffers);
+         _soundStreamTable.store (ss.Handle.get_runtime_handle (), &ss);
+         _play_source (ss);
+      }
+   }
+   else {
+
+      _log.error << "Unable to stream audio file: " << ss.buffer.FileName << endl;
+   }
+}
+
+
+dmz::Boolean
+dmz::AudioModuleOpenAL::_fill_stream_buffer (SoundStruct &ss, const ALuint Buffer) {
+
+   UInt32 size (ss.stream->read_stream (LocalStreamChunkSize, _streamData));
+
+   if ((size < LocalStreamChunkSize) &&
+         ss.init.get (SoundLooped) &&
+         ss.stream->rewind_stream ()) {
+
+      size += ss.stream->read_stream (LocalStreamChunkSize - size, _streamData + size);
+   }
+
+   const Boolean Result (size > 0);
+
+   if (Result) {
+
+      alBufferData (
+         Buffer,
+         ss.buffer.format,
+         (ALvoid *)_streamData,
+         (ALsizei)size,
+         ss.buffer.frequency);
+   }
+   else { ss.streamDone = True; }
+
+   return Result;
+}
+
+
+void
+dmz::AudioModuleOpenAL::_update_stream (SoundStruct &ss) {
+
+   ALint processed (0);
+   alGetSourcei (ss.source, AL_BUFFERS_PROCESSED, &processed);
+
+   while (processed > 0) {
+
+      ALuint buffer (0);
+      alSourceUnqueueBuffers (ss.source, 1, &buffer);
+
+      if (!ss.streamDone && _fill_stream_buffer (ss, buffer)) {
+
+         alSourceQueueBuffers (ss.source, 1, &buffer);
+      }
+
+      processed--;
+   }
+
+   ALint queued (0);
+   ALint state (0);
+   alGetSourcei (ss.source, AL_BUFFERS_QUEUED, &queued);
+   alGetSourcei (ss.source, AL_SOURCE_STATE, &state);
+
+   // The source stops if it plays every queued buffer before they are refilled.
+   if ((state == AL_STOPPED) && (queued > 0)) { alSourcePlay (ss.source); }
 }
 
 
 void
 dmz::AudioModuleOpenAL::_init (Config &local) {
 
+   _loader.set_thread_count (config_to_int32 ("load.threads", local, 0));
+   _streamSize = config_to_uint32 ("stream.size", local, _streamSize);
+   _voices.set_max_voices (config_to_int32 ("voices.max", local, 0));
+   _voices.set_rolloff_factor (LocalRolloffFactor);
+
+   if (_streamSize) { _streamData = new char[LocalStreamChunkSize]; }
+
    _device = alcOpenDevice (0);
 
    if (_device) {
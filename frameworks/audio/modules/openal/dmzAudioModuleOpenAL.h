@@ -4,7 +4,9 @@
 #include <dmzAudioModule.h>
 #include <dmzAudioSoundAttributes.h>
 #include <dmzAudioSoundInit.h>
+#include <dmzAudioVoiceManager.h>
 #include <dmzAudioWaveFile.h>
+#include <dmzAudioWaveLoader.h>
 #include <dmzRuntimeHandle.h>
 #include <dmzRuntimeLog.h>
 #include <dmzRuntimePlugin.h>
@@ -91,8 +93,13 @@ namespace dmz {
 
             const RuntimeHandle Handle;
             const String FileName;
-            WaveFile file;
             ALuint buffer;
+            ALenum format;
+            ALsizei frequency;
+            UInt32 blockAlign;
+            Float64 length;
+            Boolean pending;
+            Boolean stream;
             HashTableStringTemplate<BufferStruct> &nameTable;
             HashTableHandleTemplate<BufferStruct> &handleTable;
 
@@ -103,15 +110,20 @@ namespace dmz {
                   HashTableHandleTemplate<BufferStruct> &theHandleTable) :
                   Handle (TheFileName + ".AudioBuffer", context),
                   FileName (TheFileName),
-                  file (TheFileName),
                   buffer (0),
+                  format (0),
+                  frequency (0),
+                  blockAlign (0),
+                  length (0.0),
+                  pending (False),
+                  stream (False),
                   nameTable (theNameTable),
                   handleTable (theHandleTable) {;}
 
             protected:
                ~BufferStruct () {
 
-                  if (alIsBuffer (buffer)) { alDeleteBuffers (1, &buffer); }
+                  if (buffer && alIsBuffer (buffer)) { alDeleteBuffers (1, &buffer); }
                }
 
                virtual void _ref_count_is_zero () {
@@ -125,18 +137,34 @@ namespace dmz {
 
          struct SoundStruct {
 
+            static const Int32 StreamBufferCount = 4;
+
             const RuntimeHandle Handle;
             BufferStruct &buffer;
             ALuint source;
             SoundAttributes attr;
             SoundInit init;
+            Boolean pending;
+            WaveFile *stream;
+            Boolean streamDone;
+            ALuint streamBuffers[StreamBufferCount];
 
             SoundStruct (BufferStruct &theBuffer, RuntimeContext *context) :
                   Handle ("Sound Instance", context),
                   buffer (theBuffer),
-                  source (0) { buffer.ref (); }
+                  source (0),
+                  pending (False),
+                  stream (0),
+                  streamDone (False) {
+
+               for (Int32 ix = 0; ix < StreamBufferCount; ix++) { streamBuffers[ix] = 0; }
+               buffer.ref ();
+            }
 
-            ~SoundStruct () {
+            ~SoundStruct () { release_source (); buffer.unref (); }
+
+            // Frees the OpenAL source when the sound becomes a virtual voice.
+            void release_source () {
 
                if (source) {
 
@@ -146,13 +174,35 @@ namespace dmz {
                   if (value == AL_PLAYING) { alSourceStop (source); }
 
                   alDeleteSources (1, &source);
+                  source = 0;
                }
 
-               buffer.unref ();
+               if (stream) {
+
+                  alDeleteBuffers (StreamBufferCount, streamBuffers);
+
+                  for (Int32 ix = 0; ix < StreamBufferCount; ix++) {
+
+                     streamBuffers[ix] = 0;
+                  }
+
+                  delete stream; stream = 0;
+               }
+
+               pending = False;
+               streamDone = False;
             }
          };
 
          void _update_sound (SoundStruct &ss);
+         Boolean _load_buffer (BufferStruct &bs, WaveFile &file);
+         void _update_loaded_buffers ();
+         void _start_source (SoundStruct &ss, const Float64 Offset);
+         void _play_source (SoundStruct &ss);
+         void _update_voices (const Float64 TimeDelta);
+         void _start_stream (SoundStruct &ss, const Float64 Offset);
+         Boolean _fill_stream_buffer (SoundStruct &ss, const ALuint Buffer);
+         void _update_stream (SoundStruct &ss);
 
          void _init (Config &local);
 
@@ -170,6 +220,12 @@ namespace dmz {
          HashTableHandleTemplate<BufferStruct> _bufferHandleTable;
          HashTableHandleTemplate<SoundStruct> _soundTable;
          HashTableHandleTemplate<SoundStruct> _soundTimedTable;
+         HashTableHandleTemplate<SoundStruct> _soundStreamTable;
+
+         WaveLoader _loader;
+         VoiceManager _voices;
+         UInt32 _streamSize;
+         char *_streamData;
          //! \endcond
 
       private:
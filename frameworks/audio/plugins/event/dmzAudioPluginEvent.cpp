@@ -19,6 +19,8 @@
 \class dmz::AudioPluginEvent
 \ingroup Audio
 \brief Work in Progress.
+\details The event type "audio.priority" and the object type "audio.event.priority"
+attributes set the priority of the played sound. The priority defaults to 1.0.
 
 */
 
@@ -78,7 +80,9 @@ dmz::AudioPluginEvent::close_event (
 
    if (_audioMod && _eventMod) {
 
-      const Handle Sound = _get_sound (EventHandle, Type);
+      Float64 priority (1.0);
+
+      const Handle Sound = _get_sound (EventHandle, Type, priority);
 
       if (Sound) {
 
@@ -87,6 +91,7 @@ dmz::AudioPluginEvent::close_event (
          _eventMod->lookup_position (EventHandle, _defaultEventHandle, pos);
 
          SoundInit si;
+         si.set_priority (priority);
          SoundAttributes sa;
          sa.set_position (pos);
 
@@ -99,7 +104,8 @@ dmz::AudioPluginEvent::close_event (
 dmz::Handle
 dmz::AudioPluginEvent::_get_sound (
       const Handle EventHandle,
-      const EventType &Type) {
+      const EventType &Type,
+      Float64 &priority) {
 
    Handle result (0);
 
@@ -146,6 +152,7 @@ dmz::AudioPluginEvent::_get_sound (
          if (ts) {
 
             result = ts->Sound;
+            priority = ts->Priority;
 
             if (current != Start) {
 
@@ -153,7 +160,7 @@ dmz::AudioPluginEvent::_get_sound (
             }
          }
 
-         if (!result) { result = table->Sound; }
+         if (!result) { result = table->Sound; priority = table->Priority; }
       }
 
       if (!result) { event.become_parent (); }
@@ -172,6 +179,7 @@ dmz::AudioPluginEvent::_get_type_table (const EventType &Type) {
 
       result = new TypeTable (
          _create_sound (config_to_string ("audio.resource", Type.get_config ())),
+         config_to_float64 ("audio.priority", Type.get_config (), 1.0),
          config_to_named_handle (
             "audio.type-attribute",
             Type.get_config (),
@@ -215,7 +223,7 @@ dmz::AudioPluginEvent::_create_type (
 
       const Handle Sound = _create_sound (config_to_string ("resource", info));
 
-      result = new TypeStruct (Sound);
+      result = new TypeStruct (Sound, config_to_float64 ("priority", info, 1.0));
 
       if (result) {
 
@@ -45,26 +45,37 @@ namespace dmz {
          struct TypeStruct {
 
             const Handle Sound;
+            const Float64 Priority;
 
-            TypeStruct (const Handle TheSound) : Sound (TheSound) {;}
+            TypeStruct (const Handle TheSound, const Float64 ThePriority) :
+                  Sound (TheSound),
+                  Priority (ThePriority) {;}
          };
 
          struct TypeTable {
 
             const Handle Sound;
+            const Float64 Priority;
             const Handle TypeAttr;
 
             HashTableHandleTemplate<TypeStruct> map;
             HashTableHandleTemplate<TypeStruct> table;
 
-            TypeTable (const Handle TheSound, const Handle TheTypeAttr) :
+            TypeTable (
+                  const Handle TheSound,
+                  const Float64 ThePriority,
+                  const Handle TheTypeAttr) :
                   Sound (TheSound),
+                  Priority (ThePriority),
                   TypeAttr (TheTypeAttr) {;}
 
             ~TypeTable () { map.clear (); table.empty (); }
          };
 
-         Handle _get_sound (const Handle EventHandle, const EventType &Type);
+         Handle _get_sound (
+            const Handle EventHandle,
+            const EventType &Type,
+            Float64 &priority);
 
          TypeTable *_get_type_table (const EventType &Type);
 
@@ -31,6 +31,7 @@
                scalar="scalar attribute name"
                offset="minimum scalar value"
                scale="scalars scale"
+               priority="sound priority"
             />
          </audio>
       </object>
@@ -47,6 +48,8 @@
 file's pitch. (Optional)
 - \b offset: Minimum value the scalar will have. Defaults to 0.0. (Optional)
 - \b scale: Defines the scalar's scale. Defaults to 1.0. (Optional)
+- \b priority: Priority of the sounds used to decide which sounds are heard when the
+audio module runs out of voices. Defaults to 1.0. (Optional)
 
 At least one sound type needs to be defined (i.e.
 \b activatefile, \b loopedfile, \b deactivatefile).
@@ -313,6 +316,8 @@ dmz::AudioPluginObject::update_object_state (
          }
          else { init.set (SoundRelative, True); }
 
+         init.set_priority (current->Data.priority);
+
          const Boolean IsSet (Value.contains (current->Data.State));
 
          const Boolean WasSet (
@@ -544,6 +549,7 @@ dmz::AudioPluginObject::_init_sound_struct (Config &data, SoundDefStruct &ss) {
 
    ss.offset = config_to_float64 ("offset", data, ss.offset);
    ss.scale = config_to_float64 ("scale", data, ss.scale);
+   ss.priority = config_to_float64 ("priority", data, ss.priority);
    ss.relative = config_to_boolean ("relative", data, ss.relative);
 }
 
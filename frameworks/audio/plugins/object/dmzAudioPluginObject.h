@@ -96,6 +96,7 @@ namespace dmz {
 
             Float64 offset;
             Float64 scale;
+            Float64 priority;
             Boolean relative;
 
             SoundDefStruct *next;
@@ -108,6 +109,7 @@ namespace dmz {
                scalarAttributeHandle (0),
                offset (0.0),
                scale (1.0),
+               priority (1.0),
                relative (False),
                next (0) {;}
 
@@ -4,6 +4,7 @@
 #include <dmzInputEventMasks.h>
 #include <dmzObjectAttributeMasks.h>
 #include <dmzObjectConsts.h>
+#include <dmzRenderModuleTerrain.h>
 #include <dmzRuntimeConfig.h>
 #include <dmzRuntimeConfigToTypesBase.h>
 #include <dmzRuntimeDefinitions.h>
@@ -19,7 +20,8 @@
 \class dmz::EntityPluginGroundSimple
 \ingroup Entity
 \brief Provides simple ground vehicle movement.
-\details
+\details If a dmz::RenderModuleTerrain is available it is used to find the ground
+under the vehicle. Intersection tests are used when it does not find a terrain point.
 \code
 <movement
    speed="Max Speed"
@@ -68,6 +70,7 @@ dmz::EntityPluginGroundSimple::EntityPluginGroundSimple (
       _hilHandle (0),
       _throttleHandle (0),
       _isect (0),
+      _terrain (0),
       _eventMod (0),
       _wasAirborn (False),
       _isDead (False),
@@ -93,12 +96,18 @@ dmz::EntityPluginGroundSimple::discover_plugin (
    if (Mode == PluginDiscoverAdd) {
 
       if (!_isect) { _isect = RenderModuleIsect::cast (PluginPtr); }
+      if (!_terrain) { _terrain = RenderModuleTerrain::cast (PluginPtr); }
       if (!_eventMod) { _eventMod = EventModuleCommon::cast (PluginPtr); }
    }
    else if (Mode == PluginDiscoverRemove) {
 
       if (_isect && (_isect == RenderModuleIsect::cast (PluginPtr))) { _isect = 0; }
 
+      if (_terrain && (_terrain == RenderModuleTerrain::cast (PluginPtr))) {
+
+         _terrain = 0;
+      }
+
       if (_eventMod && (_eventMod == EventModuleCommon::cast (PluginPtr))) {
 
          _eventMod = 0;
@@ -395,7 +404,16 @@ dmz::EntityPluginGroundSimple::_find_point (
 
    Boolean result (False);
 
-   if (_isect) {
+   if (_terrain) {
+
+      if (_isect) { _isect->disable_isect (_hil); }
+
+      result = _terrain->get_terrain_point (Pos, point, normal);
+
+      if (_isect) { _isect->enable_isect (_hil); }
+   }
+
+   if (!result && _isect) {
 
       _isect->disable_isect (_hil);
 
@@ -16,6 +16,7 @@
 namespace dmz {
 
    class EventModuleCommon;
+   class RenderModuleTerrain;
    class Vector;
 
    class EntityPluginGroundSimple :
@@ -172,6 +173,7 @@ namespace dmz {
          void _init (Config &local);
 
          RenderModuleIsect *_isect;
+         RenderModuleTerrain *_terrain;
          EventModuleCommon *_eventMod;
          Boolean _wasAirborn;
          Handle _hil;
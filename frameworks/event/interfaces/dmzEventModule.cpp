@@ -117,6 +117,31 @@ callbacks have been made.
 \param[in] EventHandle Handle of the event to close
 \return Returns dmz::True if the event was closed or scheduled to be closed.
 
+\fn dmz::Int32 dmz::EventModule::create_events (
+EventDescriptorStruct *list,
+const Int32 Count)
+\brief Creates a batch of open events.
+\details Each descriptor creates one event. The source, target, and munitions objects
+are stored in the attributes named by dmz::EventAttributeSourceName,
+dmz::EventAttributeTargetName, and dmz::EventAttributeMunitionsName. The position and
+velocity are stored in the attribute named by dmz::EventAttributeDefaultName. Further
+attributes may be stored before the events are closed with
+dmz::EventModule::close_events.
+\param[in,out] list Array of descriptors. The handle of each created event is stored
+in the descriptor.
+\param[in] Count Number of descriptors in \a list.
+\return Returns the number of events created.
+
+\fn dmz::Int32 dmz::EventModule::close_events (const Handle *List, const Int32 Count)
+\brief Closes a batch of open events.
+\details The events are closed in the order given. Each observer receives all the
+events it has subscribed to in a single dmz::EventObserver::create_events and a single
+dmz::EventObserver::close_events callback instead of a callback per event. Events closed
+from within a callback are handled the same as dmz::EventModule::close_event.
+\param[in] List Array of event handles.
+\param[in] Count Number of handles in \a List.
+\return Returns the number of events closed or scheduled to be closed.
+
 \fn dmz::Boolean dmz::EventModule::lookup_event_type (
 const Handle EventHandle,
 EventType &value)
@@ -4,9 +4,11 @@
 #include <dmzEventConsts.h>
 #include <dmzRuntimePlugin.h>
 #include <dmzRuntimePluginInfo.h>
+#include <dmzRuntimeEventType.h>
 #include <dmzRuntimeRTTI.h>
 #include <dmzTypesBase.h>
 #include <dmzTypesString.h>
+#include <dmzTypesVector.h>
 
 namespace dmz {
 
@@ -18,11 +20,35 @@ namespace dmz {
    class EventDump;
    class Mask;
    class EventObserver;
-   class EventType;
    class Matrix;
    class ObjectType;
    class RuntimeContext;
-   class Vector;
+
+   //! \brief Describes an event created by dmz::EventModule::create_events().
+   //! \ingroup Event
+   struct EventDescriptorStruct {
+
+      Handle handle;              //!< Handle of the created event, zero on failure.
+      EventType type;             //!< Type of the event.
+      EventLocalityEnum locality; //!< Locality of the event.
+      Handle source;              //!< Source object, stored when not zero.
+      Handle target;              //!< Target object, stored when not zero.
+      Handle munitions;           //!< Munitions object, stored when not zero.
+      Boolean hasPosition;        //!< Stores \a position when dmz::True.
+      Vector position;            //!< Position stored in the default attribute.
+      Boolean hasVelocity;        //!< Stores \a velocity when dmz::True.
+      Vector velocity;            //!< Velocity stored in the default attribute.
+
+      //! Constructor.
+      EventDescriptorStruct () :
+            handle (0),
+            locality (EventLocal),
+            source (0),
+            target (0),
+            munitions (0),
+            hasPosition (False),
+            hasVelocity (False) {;}
+   };
 
    class EventModule {
 
@@ -51,6 +77,10 @@ namespace dmz {
 
          virtual Boolean close_event (const Handle EventHandle) = 0;
 
+         virtual Int32 create_events (EventDescriptorStruct *list, const Int32 Count) = 0;
+
+         virtual Int32 close_events (const Handle *List, const Int32 Count) = 0;
+
          virtual Boolean lookup_event_type (
             const Handle EventHandle,
             EventType &value) = 0;
@@ -68,4 +68,23 @@ const EventLocalityEnum Locality)
 \param[in] Type Event's EventType.
 \param[in] Locality Event's locality.
 
+\fn void dmz::EventObserver::create_events (
+const EventRecordStruct *List,
+const Int32 Count)
+\brief Batch event creation callback.
+\details Called when events are closed with dmz::EventModule::close_events. The default
+implementation calls dmz::EventObserver::create_event for each event. Observers that
+handle many events may override it to process the whole batch at once.
+\param[in] List Array of events.
+\param[in] Count Number of events in \a List.
+
+\fn void dmz::EventObserver::close_events (
+const EventRecordStruct *List,
+const Int32 Count)
+\brief Batch event close callback.
+\details The default implementation calls dmz::EventObserver::close_event for
+each event.
+\param[in] List Array of events.
+\param[in] Count Number of events in \a List.
+
 */
@@ -3,6 +3,7 @@
 
 #include <dmzEventConsts.h>
 #include <dmzRuntimePlugin.h>
+#include <dmzRuntimeEventType.h>
 #include <dmzRuntimePluginInfo.h>
 #include <dmzRuntimeRTTI.h>
 #include <dmzTypesBase.h>
@@ -16,9 +17,20 @@ namespace dmz {
    //! \endcond
 
    class EventModule;
-   class EventType;
    class RuntimeContext;
 
+   //! \brief Event passed to the EventObserver batch callbacks.
+   //! \ingroup Event
+   struct EventRecordStruct {
+
+      Handle handle;              //!< Event's unique runtime handle.
+      EventType type;             //!< Event's EventType.
+      EventLocalityEnum locality; //!< Event's locality.
+
+      //! Constructor.
+      EventRecordStruct () : handle (0), locality (EventLocalityUnknown) {;}
+   };
+
    class EventObserver {
 
       public:
@@ -44,6 +56,9 @@ namespace dmz {
             const EventType &Type,
             const EventLocalityEnum Locality) = 0;
 
+         virtual void create_events (const EventRecordStruct *List, const Int32 Count);
+         virtual void close_events (const EventRecordStruct *List, const Int32 Count);
+
       protected:
          EventObserver (const PluginInfo &Info);
          ~EventObserver ();
@@ -93,6 +108,26 @@ dmz::EventObserver::~EventObserver () {
 }
 
 
+inline void
+dmz::EventObserver::create_events (const EventRecordStruct *List, const Int32 Count) {
+
+   for (Int32 ix = 0; ix < Count; ix++) {
+
+      create_event (List[ix].handle, List[ix].type, List[ix].locality);
+   }
+}
+
+
+inline void
+dmz::EventObserver::close_events (const EventRecordStruct *List, const Int32 Count) {
+
+   for (Int32 ix = 0; ix < Count; ix++) {
+
+      close_event (List[ix].handle, List[ix].type, List[ix].locality);
+   }
+}
+
+
 inline dmz::String
 dmz::EventObserver::get_event_observer_name () { return __Info.get_name (); }
 
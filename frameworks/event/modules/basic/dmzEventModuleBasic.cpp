@@ -17,8 +17,16 @@
 \class dmz::EventModuleBasic
 \ingroup Event
 \brief Basic EventModule implementation.
-\details This provides a basic implementation of the EventModule. At this time the
-EventModuleBasic has no configuration parameters.
+\details This provides a basic implementation of the EventModule. Closed events are
+kept in the order they were closed and expire once they are older than the time to
+live or once there are more events than the maximum. Event records are allocated in
+slabs and reused.
+\code
+<dmzEventModuleBasic>
+   <ttl value="1.0"/> <!-- Seconds a closed event is kept -->
+   <max value="0"/> <!-- Maximum number of events, 0 uses the time to live instead -->
+</dmzEventModuleBasic>
+\endcode
 \sa EventModule
 
 */
@@ -28,6 +36,40 @@ namespace {
 
 static const dmz::Mask CreateMask (0, dmz::EventCallbackCreateEvent);
 static const dmz::Mask CloseMask (0, dmz::EventCallbackCloseEvent);
+static const dmz::Int32 SlabSize = 256;
+
+template <class T> static inline void
+local_store_vector (T *slot, const dmz::Vector &Value) {
+
+   slot[0].real = Value.get_x ();
+   slot[1].real = Value.get_y ();
+   slot[2].real = Value.get_z ();
+}
+
+
+template <class T> static inline void
+local_lookup_vector (const T *Slot, dmz::Vector &value) {
+
+   value.set_xyz (Slot[0].real, Slot[1].real, Slot[2].real);
+}
+
+
+template <class T> static inline void
+local_store_matrix (T *slot, const dmz::Matrix &Value) {
+
+   dmz::Float64 array[9];
+   Value.to_array (array);
+   for (int ix = 0; ix < 9; ix++) { slot[ix].real = array[ix]; }
+}
+
+
+template <class T> static inline void
+local_lookup_matrix (const T *Slot, dmz::Matrix &value) {
+
+   dmz::Float64 array[9];
+   for (int ix = 0; ix < 9; ix++) { array[ix] = Slot[ix].real; }
+   value = dmz::Matrix (array);
+}
 
 };
 
@@ -41,10 +83,17 @@ dmz::EventModuleBasic::EventModuleBasic (const PluginInfo &Info, Config &local)
       _inCloseEvent (False),
       _maxEvents (0),
       _eventTTL (1.0),
+      _defaultHandle (0),
+      _sourceHandle (0),
+      _targetHandle (0),
+      _munitionsHandle (0),
       _eventCache (0),
       _delayedListHead (0),
       _delayedListTail (0),
-      _recycleList (0) {
+      _closedListHead (0),
+      _closedListTail (0),
+      _freeList (0),
+      _slabList (0) {
 
    _init (local);
 }
@@ -53,10 +102,18 @@ dmz::EventModuleBasic::EventModuleBasic (const PluginInfo &Info, Config &local)
 dmz::EventModuleBasic::~EventModuleBasic () {
 
    _eventCache = 0;
+   _closedListHead = _closedListTail = 0;
+   _freeList = 0;
+
+   // Event records are owned by the slabs.
+   _eventTable.clear ();
 
-   if (_recycleList) { delete _recycleList; _recycleList = 0; }
+   while (_slabList) {
 
-   _eventTable.empty ();
+      EventSlabStruct *slab (_slabList);
+      _slabList = _slabList->next;
+      delete slab; slab = 0;
+   }
 
    HashTableHandleIterator it;
 
@@ -104,61 +161,22 @@ dmz::EventModuleBasic::discover_plugin (
 void
 dmz::EventModuleBasic::update_time_slice (const Float64 TimeDelta) {
 
+   // Closed events are queued in the order they were closed so only the events that
+   // are due are touched.
    if (_maxEvents > 0) {
 
-      HashTableHandleIterator it;
-
-      Int32 count (0);
-
-      const Int32 Diff (_eventTable.get_count () - _maxEvents);
-
-      EventStruct *event (_eventTable.get_first (it));
-
-      while (event) {
+      while (_closedListHead && (_eventTable.get_count () > _maxEvents)) {
 
-         if (event->closed) {
-
-            event = _eventTable.remove (event->handle);
-
-            if (event) {
-
-               if (event == _eventCache) { _eventCache = 0; }
-
-               count++;
-               event->next = _recycleList; _recycleList = event;
-
-               if (Diff < count) { event = 0; }
-               else { event = _eventTable.get_next (it); }
-            }
-         }
-         else { event = _eventTable.get_next (it); }
+         _expire_closed_event ();
       }
    }
    else {
 
       const Float64 FrameTime (_time.get_frame_time () - _eventTTL);
 
-      HashTableHandleIterator it;
-
-      EventStruct *event (_eventTable.get_first (it));
-
-      while (event) {
-
-         if (event->closed) {
+      while (_closedListHead && (_closedListHead->closeTime < FrameTime)) {
 
-            if (event->closeTime < FrameTime) {
-
-               event = _eventTable.remove (event->handle);
-
-               if (event == _eventCache) { _eventCache = 0; }
-
-               if (event) { event->next = _recycleList; _recycleList = event; }
-
-               event = _eventTable.get_next (it);
-            }
-            else { event = 0; }
-         }
-         else { event = _eventTable.get_next (it); }
+         _expire_closed_event ();
       }
    }
 }
@@ -300,237 +318,240 @@ dmz::EventModuleBasic::dump_event (const Handle EventHandle, EventDump &dump) {
 
       dump.start_dump_event (event->handle, event->type, event->locality);
 
-      HashTableHandleIterator it;
-
-      {
-         Handle *ptr = event->handleTable.get_first (it);
-
-         while (ptr) {
-
-            dump.store_event_handle (event->handle, it.get_hash_key (), *ptr);
-            ptr = event->handleTable.get_next (it);
+      for (Int32 ix = 0; ix < event->attrList.count; ix++) {
+
+         const AttrStruct &Attr (event->attrList.list[ix]);
+         const ValueUnion *Ptr (event->valueList.list + Attr.index);
+         Vector vec;
+         Matrix mat;
+
+         switch (Attr.kind) {
+
+            case EventAttrHandle:
+               dump.store_event_handle (EventHandle, Attr.attr, Ptr->handle);
+               break;
+            case EventAttrObject:
+               dump.store_event_object_handle (EventHandle, Attr.attr, Ptr->handle);
+               break;
+            case EventAttrType:
+               dump.store_event_object_type (
+                  EventHandle,
+                  Attr.attr,
+                  event->typeList.list[Attr.index]);
+               break;
+            case EventAttrState:
+               dump.store_event_state (
+                  EventHandle,
+                  Attr.attr,
+                  event->stateList.list[Attr.index]);
+               break;
+            case EventAttrTimeStamp:
+               dump.store_event_time_stamp (EventHandle, Attr.attr, Ptr->real);
+               break;
+            case EventAttrPosition:
+               local_lookup_vector (Ptr, vec);
+               dump.store_event_position (EventHandle, Attr.attr, vec);
+               break;
+            case EventAttrOrientation:
+               local_lookup_matrix (Ptr, mat);
+               dump.store_event_orientation (EventHandle, Attr.attr, mat);
+               break;
+            case EventAttrVelocity:
+               local_lookup_vector (Ptr, vec);
+               dump.store_event_velocity (EventHandle, Attr.attr, vec);
+               break;
+            case EventAttrAcceleration:
+               local_lookup_vector (Ptr, vec);
+               dump.store_event_acceleration (EventHandle, Attr.attr, vec);
+               break;
+            case EventAttrScale:
+               local_lookup_vector (Ptr, vec);
+               dump.store_event_scale (EventHandle, Attr.attr, vec);
+               break;
+            case EventAttrVector:
+               local_lookup_vector (Ptr, vec);
+               dump.store_event_vector (EventHandle, Attr.attr, vec);
+               break;
+            case EventAttrScalar:
+               dump.store_event_scalar (EventHandle, Attr.attr, Ptr->real);
+               break;
+            case EventAttrCounter:
+               dump.store_event_counter (EventHandle, Attr.attr, Ptr->counter);
+               break;
+            case EventAttrText:
+               dump.store_event_text (
+                  EventHandle,
+                  Attr.attr,
+                  event->textList.list[Attr.index]);
+               break;
+            case EventAttrData:
+               dump.store_event_data (
+                  EventHandle,
+                  Attr.attr,
+                  event->dataList.list[Attr.index]);
+               break;
          }
       }
 
-      {
-         Handle *ptr = event->objectTable.get_first (it);
-
-         while (ptr) {
+      dump.end_dump_event (event->handle);
+   }
+}
 
-            dump.store_event_object_handle (event->handle, it.get_hash_key (), *ptr);
-            ptr = event->objectTable.get_next (it);
-         }
-      }
 
-      {
-         ObjectType *ptr = event->typeTable.get_first (it);
+dmz::Handle
+dmz::EventModuleBasic::create_event (
+      const EventType &Type,
+      const EventLocalityEnum Locality) {
 
-         while (ptr) {
+   EventStruct *event (_create_event (Type, Locality));
 
-            dump.store_event_object_type (event->handle, it.get_hash_key (), *ptr);
-            ptr = event->typeTable.get_next (it);
-         }
-      }
+   return event ? event->handle : 0;
+}
 
-      {
-         Mask *ptr = event->stateTable.get_first (it);
 
-         while (ptr) {
+dmz::Boolean
+dmz::EventModuleBasic::close_event (const Handle EventHandle) {
 
-            dump.store_event_state (event->handle, it.get_hash_key (), *ptr);
-            ptr = event->stateTable.get_next (it);
-         }
-      }
+   Boolean result (False);
 
-      {
-         Float64 *ptr = event->timeStampTable.get_first (it);
+   EventStruct *event (_lookup_event (EventHandle));
 
-         while (ptr) {
+   if (event && !event->closed) {
 
-            dump.store_event_time_stamp (event->handle, it.get_hash_key (), *ptr);
-            ptr = event->timeStampTable.get_next (it);
-         }
-      }
+      result = True;
 
-      {
-         Vector *ptr = event->positionTable.get_first (it);
+      // Events that are already being closed are not closed a second time.
+      if (!event->closing && !_inCloseEvent) {
 
-         while (ptr) {
+         _inCloseEvent = True;
+         _close_event (*event);
+         _inCloseEvent = False;
 
-            dump.store_event_position (event->handle, it.get_hash_key (), *ptr);
-            ptr = event->positionTable.get_next (it);
-         }
+         _close_delayed_events ();
       }
+      else if (!event->closing) {
 
-      {
-         Matrix *ptr = event->orientationTable.get_first (it);
+         event->closing = True;
 
-         while (ptr) {
+         if (_delayedListTail) {
 
-            dump.store_event_orientation (event->handle, it.get_hash_key (), *ptr);
-            ptr = event->orientationTable.get_next (it);
+            _delayedListTail->next = event;
+            _delayedListTail = event;
          }
+         else { _delayedListHead = _delayedListTail = event; }
       }
+   }
 
-      {
-         Vector *ptr = event->velocityTable.get_first (it);
-
-         while (ptr) {
+   return result;
+}
 
-            dump.store_event_velocity (event->handle, it.get_hash_key (), *ptr);
-            ptr = event->velocityTable.get_next (it);
-         }
-      }
 
-      {
-         Vector *ptr = event->accelerationTable.get_first (it);
+dmz::Int32
+dmz::EventModuleBasic::create_events (EventDescriptorStruct *list, const Int32 Count) {
 
-         while (ptr) {
+   Int32 result (0);
 
-            dump.store_event_acceleration (event->handle, it.get_hash_key (), *ptr);
-            ptr = event->accelerationTable.get_next (it);
-         }
-      }
+   for (Int32 ix = 0; list && (ix < Count); ix++) {
 
-      {
-         Vector *ptr = event->scaleTable.get_first (it);
+      EventDescriptorStruct &desc (list[ix]);
 
-         while (ptr) {
+      EventStruct *event (_create_event (desc.type, desc.locality));
 
-            dump.store_event_scale (event->handle, it.get_hash_key (), *ptr);
-            ptr = event->scaleTable.get_next (it);
-         }
-      }
+      desc.handle = event ? event->handle : 0;
 
-      {
-         Vector *ptr = event->vectorTable.get_first (it);
+      if (event) {
 
-         while (ptr) {
+         if (desc.source) {
 
-            dump.store_event_vector (event->handle, it.get_hash_key (), *ptr);
-            ptr = event->vectorTable.get_next (it);
+            event->store_values (_sourceHandle, EventAttrObject, 1)->handle = desc.source;
          }
-      }
-
-      {
-         Float64 *ptr = event->scalarTable.get_first (it);
 
-         while (ptr) {
+         if (desc.target) {
 
-            dump.store_event_scalar (event->handle, it.get_hash_key (), *ptr);
-            ptr = event->scalarTable.get_next (it);
+            event->store_values (_targetHandle, EventAttrObject, 1)->handle = desc.target;
          }
-      }
 
-      {
-         Int64 *ptr = event->counterTable.get_first (it);
+         if (desc.munitions) {
 
-         while (ptr) {
-
-            dump.store_event_counter (event->handle, it.get_hash_key (), *ptr);
-            ptr = event->counterTable.get_next (it);
+            event->store_values (_munitionsHandle, EventAttrObject, 1)->handle =
+               desc.munitions;
          }
-      }
-
-      {
-         String *ptr = event->textTable.get_first (it);
 
-         while (ptr) {
+         if (desc.hasPosition) {
 
-            dump.store_event_text (event->handle, it.get_hash_key (), *ptr);
-            ptr = event->textTable.get_next (it);
+            local_store_vector (
+               event->store_values (_defaultHandle, EventAttrPosition, 3),
+               desc.position);
          }
-      }
-
-      {
-         Data *ptr = event->dataTable.get_first (it);
 
-         while (ptr) {
+         if (desc.hasVelocity) {
 
-            dump.store_event_data (event->handle, it.get_hash_key (), *ptr);
-            ptr = event->dataTable.get_next (it);
+            local_store_vector (
+               event->store_values (_defaultHandle, EventAttrVelocity, 3),
+               desc.velocity);
          }
-      }
 
-      dump.end_dump_event (event->handle);
+         result++;
+      }
    }
+
+   return result;
 }
 
 
-dmz::Handle
-dmz::EventModuleBasic::create_event (
-      const EventType &Type,
-      const EventLocalityEnum Locality) {
+dmz::Int32
+dmz::EventModuleBasic::close_events (const Handle *List, const Int32 Count) {
 
-   Handle result (0);
+   Int32 result (0);
 
-   if (Type && (Locality != EventLocalityUnknown)) {
+   if (List && _inCloseEvent) {
 
-      EventStruct *event (_recycleList);
+      for (Int32 ix = 0; ix < Count; ix++) { if (close_event (List[ix])) { result++; } }
+   }
+   else if (List) {
 
-      if (event) { _recycleList = _recycleList->next; event->next = 0; event->reset (); }
-      else { event = new EventStruct; }
+      _inCloseEvent = True;
+      _batchEventList.clear ();
 
-      if (event) {
+      for (Int32 ix = 0; ix < Count; ix++) {
 
-         result = event->get_handle (Type.get_name (), _PluginInfoData.get_context ());
+         EventStruct *event (_lookup_event (List[ix]));
 
-         if (result) {
+         if (event && !event->closed && !event->closing) {
 
-            if (_eventTable.store (result, event)) {
-
-               event->type = Type;
-               event->locality = Locality;
-            }
-            else {
-
-               result = 0;
-               event->next = _recycleList; _recycleList = event;
-            }
+            event->closing = True;
+            const Int32 Index (_batchEventList.add (1));
+            _batchEventList.list[Index] = event;
          }
       }
-   }
 
-   return result;
-}
+      result = _batchEventList.count;
 
+      _send_batch (True);
 
-dmz::Boolean
-dmz::EventModuleBasic::close_event (const Handle EventHandle) {
+      const Float64 CloseTime (_time.get_frame_time ());
 
-   Boolean result (False);
-
-   EventStruct *event (_lookup_event (EventHandle));
+      for (Int32 ix = 0; ix < result; ix++) {
 
-   if (event && !event->closed) {
-
-      result = True;
-
-      if (!_inCloseEvent) {
+         EventStruct &event (*(_batchEventList.list[ix]));
+         event.closed = True;
+         event.closeTime = CloseTime;
+      }
 
-         _inCloseEvent = True;
-         _close_event (*event);
-         _inCloseEvent = False;
+      _send_batch (False);
 
-         while (_delayedListHead) {
+      for (Int32 ix = 0; ix < result; ix++) {
 
-            EventStruct *current (_delayedListHead);
-            _delayedListHead = _delayedListHead->next;
-            current->next = 0;
-            _close_event (*current);
-         }
+         EventStruct *event (_batchEventList.list[ix]);
 
-         _delayedListTail = 0;
+         if (_closedListTail) { _closedListTail->next = event; _closedListTail = event; }
+         else { _closedListHead = _closedListTail = event; }
       }
-      else {
 
-         if (_delayedListTail) {
+      _batchEventList.clear ();
+      _inCloseEvent = False;
 
-            _delayedListTail->next = event;
-            _delayedListTail = event;
-         }
-         else { _delayedListHead = _delayedListTail = event; }
-      }
+      _close_delayed_events ();
    }
 
    return result;
@@ -575,16 +596,8 @@ dmz::EventModuleBasic::store_handle (
 
    if (event && !event->closed) {
 
-      Handle *valuePtr (event->handleTable.lookup (AttributeHandle));
-
-      if (valuePtr) { *valuePtr = Value; result = True; }
-      else {
-
-         valuePtr = new Handle (Value);
-
-         if (event->handleTable.store (AttributeHandle, valuePtr)) { result = True; }
-         else { delete valuePtr; valuePtr = 0; }
-      }
+      event->store_values (AttributeHandle, EventAttrHandle, 1)->handle = Value;
+      result = True;
    }
 
    return result;
@@ -603,9 +616,9 @@ dmz::EventModuleBasic::lookup_handle (
 
    if (event) {
 
-      Handle *ptr (event->handleTable.lookup (AttributeHandle));
+      const ValueUnion *Ptr (event->lookup_values (AttributeHandle, EventAttrHandle));
 
-      if (ptr) { value = *ptr; result = True; }
+      if (Ptr) { value = Ptr->handle; result = True; }
    }
 
    return result;
@@ -624,16 +637,8 @@ dmz::EventModuleBasic::store_object_handle (
 
    if (event && !event->closed) {
 
-      Handle *valuePtr (event->objectTable.lookup (AttributeHandle));
-
-      if (valuePtr) { *valuePtr = Value; result = True; }
-      else {
-
-         valuePtr = new Handle (Value);
-
-         if (event->objectTable.store (AttributeHandle, valuePtr)) { result = True; }
-         else { delete valuePtr; valuePtr = 0; }
-      }
+      event->store_values (AttributeHandle, EventAttrObject, 1)->handle = Value;
+      result = True;
    }
 
    return result;
@@ -652,9 +657,9 @@ dmz::EventModuleBasic::lookup_object_handle (
 
    if (event) {
 
-      Handle *ptr (event->objectTable.lookup (AttributeHandle));
+      const ValueUnion *Ptr (event->lookup_values (AttributeHandle, EventAttrObject));
 
-      if (ptr) { value = *ptr; result = True; }
+      if (Ptr) { value = Ptr->handle; result = True; }
    }
 
    return result;
@@ -673,16 +678,11 @@ dmz::EventModuleBasic::store_object_type (
 
    if (event && !event->closed) {
 
-      ObjectType *valuePtr (event->typeTable.lookup (AttributeHandle));
-
-      if (valuePtr) { *valuePtr = Value; result = True; }
-      else {
+      const Int32 Index (
+         event->store_index (AttributeHandle, EventAttrType, 1, event->typeList));
 
-         valuePtr = new ObjectType (Value);
-
-         if (event->typeTable.store (AttributeHandle, valuePtr)) { result = True; }
-         else { delete valuePtr; valuePtr = 0; }
-      }
+      event->typeList.list[Index] = Value;
+      result = True;
    }
 
    return result;
@@ -701,9 +701,9 @@ dmz::EventModuleBasic::lookup_object_type (
 
    if (event) {
 
-      ObjectType *ptr (event->typeTable.lookup (AttributeHandle));
+      const Int32 Index (event->lookup_index (AttributeHandle, EventAttrType));
 
-      if (ptr) { value = *ptr; result = True; }
+      if (Index >= 0) { value = event->typeList.list[Index]; result = True; }
    }
 
    return result;
@@ -722,16 +722,11 @@ dmz::EventModuleBasic::store_state (
 
    if (event && !event->closed) {
 
-      Mask *valuePtr (event->stateTable.lookup (AttributeHandle));
-
-      if (valuePtr) { *valuePtr = Value; result = True; }
-      else {
-
-         valuePtr = new Mask (Value);
+      const Int32 Index (
+         event->store_index (AttributeHandle, EventAttrState, 1, event->stateList));
 
-         if (event->stateTable.store (AttributeHandle, valuePtr)) { result = True; }
-         else { delete valuePtr; valuePtr = 0; }
-      }
+      event->stateList.list[Index] = Value;
+      result = True;
    }
 
    return result;
@@ -750,9 +745,9 @@ dmz::EventModuleBasic::lookup_state (
 
    if (event) {
 
-      Mask *ptr (event->stateTable.lookup (AttributeHandle));
+      const Int32 Index (event->lookup_index (AttributeHandle, EventAttrState));
 
-      if (ptr) { value = *ptr; result = True; }
+      if (Index >= 0) { value = event->stateList.list[Index]; result = True; }
    }
 
    return result;
@@ -771,16 +766,8 @@ dmz::EventModuleBasic::store_time_stamp (
 
    if (event && !event->closed) {
 
-      Float64 *valuePtr (event->timeStampTable.lookup (AttributeHandle));
-
-      if (valuePtr) { *valuePtr = Value; result = True; }
-      else {
-
-         valuePtr = new Float64 (Value);
-
-         if (event->timeStampTable.store (AttributeHandle, valuePtr)) { result = True; }
-         else { delete valuePtr; valuePtr = 0; }
-      }
+      event->store_values (AttributeHandle, EventAttrTimeStamp, 1)->real = Value;
+      result = True;
    }
 
    return result;
@@ -799,9 +786,9 @@ dmz::EventModuleBasic::lookup_time_stamp (
 
    if (event) {
 
-      Float64 *ptr (event->timeStampTable.lookup (AttributeHandle));
+      const ValueUnion *Ptr (event->lookup_values (AttributeHandle, EventAttrTimeStamp));
 
-      if (ptr) { value = *ptr; result = True; }
+      if (Ptr) { value = Ptr->real; result = True; }
    }
 
    return result;
@@ -820,16 +807,9 @@ dmz::EventModuleBasic::store_position (
 
    if (event && !event->closed) {
 
-      Vector *valuePtr (event->positionTable.lookup (AttributeHandle));
-
-      if (valuePtr) { *valuePtr = Value; result = True; }
-      else {
-
-         valuePtr = new Vector (Value);
-
-         if (event->positionTable.store (AttributeHandle, valuePtr)) { result = True; }
-         else { delete valuePtr; valuePtr = 0; }
-      }
+      ValueUnion *ptr (event->store_values (AttributeHandle, EventAttrPosition, 3));
+      local_store_vector (ptr, Value);
+      result = True;
    }
 
    return result;
@@ -848,9 +828,9 @@ dmz::EventModuleBasic::lookup_position (
 
    if (event) {
 
-      Vector *ptr (event->positionTable.lookup (AttributeHandle));
+      const ValueUnion *Ptr (event->lookup_values (AttributeHandle, EventAttrPosition));
 
-      if (ptr) { value = *ptr; result = True; }
+      if (Ptr) { local_lookup_vector (Ptr, value); result = True; }
    }
 
    return result;
@@ -869,16 +849,9 @@ dmz::EventModuleBasic::store_orientation (
 
    if (event && !event->closed) {
 
-      Matrix *valuePtr (event->orientationTable.lookup (AttributeHandle));
-
-      if (valuePtr) { *valuePtr = Value; result = True; }
-      else {
-
-         valuePtr = new Matrix (Value);
-
-         if (event->orientationTable.store (AttributeHandle, valuePtr)) { result = True; }
-         else { delete valuePtr; valuePtr = 0; }
-      }
+      ValueUnion *ptr (event->store_values (AttributeHandle, EventAttrOrientation, 9));
+      local_store_matrix (ptr, Value);
+      result = True;
    }
 
    return result;
@@ -897,9 +870,10 @@ dmz::EventModuleBasic::lookup_orientation (
 
    if (event) {
 
-      Matrix *ptr (event->orientationTable.lookup (AttributeHandle));
+      const ValueUnion *Ptr (
+         event->lookup_values (AttributeHandle, EventAttrOrientation));
 
-      if (ptr) { value = *ptr; result = True; }
+      if (Ptr) { local_lookup_matrix (Ptr, value); result = True; }
    }
 
    return result;
@@ -918,16 +892,9 @@ dmz::EventModuleBasic::store_velocity (
 
    if (event && !event->closed) {
 
-      Vector *valuePtr (event->velocityTable.lookup (AttributeHandle));
-
-      if (valuePtr) { *valuePtr = Value; result = True; }
-      else {
-
-         valuePtr = new Vector (Value);
-
-         if (event->velocityTable.store (AttributeHandle, valuePtr)) { result = True; }
-         else { delete valuePtr; valuePtr = 0; }
-      }
+      ValueUnion *ptr (event->store_values (AttributeHandle, EventAttrVelocity, 3));
+      local_store_vector (ptr, Value);
+      result = True;
    }
 
    return result;
@@ -946,9 +913,9 @@ dmz::EventModuleBasic::lookup_velocity (
 
    if (event) {
 
-      Vector *ptr (event->velocityTable.lookup (AttributeHandle));
+      const ValueUnion *Ptr (event->lookup_values (AttributeHandle, EventAttrVelocity));
 
-      if (ptr) { value = *ptr; result = True; }
+      if (Ptr) { local_lookup_vector (Ptr, value); result = True; }
    }
 
    return result;
@@ -967,19 +934,9 @@ dmz::EventModuleBasic::store_acceleration (
 
    if (event && !event->closed) {
 
-      Vector *valuePtr (event->velocityTable.lookup (AttributeHandle));
-
-      if (valuePtr) { *valuePtr = Value; result = True; }
-      else {
-
-         valuePtr = new Vector (Value);
-
-         if (event->accelerationTable.store (AttributeHandle, valuePtr)) {
-
-            result = True;
-         }
-         else { delete valuePtr; valuePtr = 0; }
-      }
+      ValueUnion *ptr (event->store_values (AttributeHandle, EventAttrAcceleration, 3));
+      local_store_vector (ptr, Value);
+      result = True;
    }
 
    return result;
@@ -998,9 +955,10 @@ dmz::EventModuleBasic::lookup_acceleration (
 
    if (event) {
 
-      Vector *ptr (event->accelerationTable.lookup (AttributeHandle));
+      const ValueUnion *Ptr (
+         event->lookup_values (AttributeHandle, EventAttrAcceleration));
 
-      if (ptr) { value = *ptr; result = True; }
+      if (Ptr) { local_lookup_vector (Ptr, value); result = True; }
    }
 
    return result;
@@ -1019,16 +977,9 @@ dmz::EventModuleBasic::store_scale (
 
    if (event && !event->closed) {
 
-      Vector *valuePtr (event->scaleTable.lookup (AttributeHandle));
-
-      if (valuePtr) { *valuePtr = Value; result = True; }
-      else {
-
-         valuePtr = new Vector (Value);
-
-         if (event->scaleTable.store (AttributeHandle, valuePtr)) { result = True; }
-         else { delete valuePtr; valuePtr = 0; }
-      }
+      ValueUnion *ptr (event->store_values (AttributeHandle, EventAttrScale, 3));
+      local_store_vector (ptr, Value);
+      result = True;
    }
 
    return result;
@@ -1047,9 +998,9 @@ dmz::EventModuleBasic::lookup_scale (
 
    if (event) {
 
-      Vector *ptr (event->scaleTable.lookup (AttributeHandle));
+      const ValueUnion *Ptr (event->lookup_values (AttributeHandle, EventAttrScale));
 
-      if (ptr) { value = *ptr; result = True; }
+      if (Ptr) { local_lookup_vector (Ptr, value); result = True; }
    }
 
    return result;
@@ -1068,16 +1019,9 @@ dmz::EventModuleBasic::store_vector (
 
    if (event && !event->closed) {
 
-      Vector *valuePtr (event->vectorTable.lookup (AttributeHandle));
-
-      if (valuePtr) { *valuePtr = Value; result = True; }
-      else {
-
-         valuePtr = new Vector (Value);
-
-         if (event->vectorTable.store (AttributeHandle, valuePtr)) { result = True; }
-         else { delete valuePtr; valuePtr = 0; }
-      }
+      ValueUnion *ptr (event->store_values (AttributeHandle, EventAttrVector, 3));
+      local_store_vector (ptr, Value);
+      result = True;
    }
 
    return result;
@@ -1096,9 +1040,9 @@ dmz::EventModuleBasic::lookup_vector (
 
    if (event) {
 
-      Vector *ptr (event->vectorTable.lookup (AttributeHandle));
+      const ValueUnion *Ptr (event->lookup_values (AttributeHandle, EventAttrVector));
 
-      if (ptr) { value = *ptr; result = True; }
+      if (Ptr) { local_lookup_vector (Ptr, value); result = True; }
    }
 
    return result;
@@ -1117,16 +1061,8 @@ dmz::EventModuleBasic::store_scalar (
 
    if (event && !event->closed) {
 
-      Float64 *valuePtr (event->scalarTable.lookup (AttributeHandle));
-
-      if (valuePtr) { *valuePtr = Value; result = True; }
-      else {
-
-         valuePtr = new Float64 (Value);
-
-         if (event->scalarTable.store (AttributeHandle, valuePtr)) { result = True; }
-         else { delete valuePtr; valuePtr = 0; }
-      }
+      event->store_values (AttributeHandle, EventAttrScalar, 1)->real = Value;
+      result = True;
    }
 
    return result;
@@ -1145,9 +1081,9 @@ dmz::EventModuleBasic::lookup_scalar (
 
    if (event) {
 
-      Float64 *ptr (event->scalarTable.lookup (AttributeHandle));
+      const ValueUnion *Ptr (event->lookup_values (AttributeHandle, EventAttrScalar));
 
-      if (ptr) { value = *ptr; result = True; }
+      if (Ptr) { value = Ptr->real; result = True; }
    }
 
    return result;
@@ -1166,16 +1102,8 @@ dmz::EventModuleBasic::store_counter (
 
    if (event && !event->closed) {
 
-      Int64 *valuePtr (event->counterTable.lookup (AttributeHandle));
-
-      if (valuePtr) { *valuePtr = Value; result = True; }
-      else {
-
-         valuePtr = new Int64 (Value);
-
-         if (event->counterTable.store (AttributeHandle, valuePtr)) { result = True; }
-         else { delete valuePtr; valuePtr = 0; }
-      }
+      event->store_values (AttributeHandle, EventAttrCounter, 1)->counter = Value;
+      result = True;
    }
 
    return result;
@@ -1194,9 +1122,9 @@ dmz::EventModuleBasic::lookup_counter (
 
    if (event) {
 
-      Int64 *ptr (event->counterTable.lookup (AttributeHandle));
+      const ValueUnion *Ptr (event->lookup_values (AttributeHandle, EventAttrCounter));
 
-      if (ptr) { value = *ptr; result = True; }
+      if (Ptr) { value = Ptr->counter; result = True; }
    }
 
    return result;
@@ -1215,16 +1143,11 @@ dmz::EventModuleBasic::store_text (
 
    if (event && !event->closed) {
 
-      String *valuePtr (event->textTable.lookup (AttributeHandle));
+      const Int32 Index (
+         event->store_index (AttributeHandle, EventAttrText, 1, event->textList));
 
-      if (valuePtr) { *valuePtr = Value; result = True; }
-      else {
-
-         valuePtr = new String (Value);
-
-         if (event->textTable.store (AttributeHandle, valuePtr)) { result = True; }
-         else { delete valuePtr; valuePtr = 0; }
-      }
+      event->textList.list[Index] = Value;
+      result = True;
    }
 
    return result;
@@ -1243,9 +1166,9 @@ dmz::EventModuleBasic::lookup_text (
 
    if (event) {
 
-      String *ptr (event->textTable.lookup (AttributeHandle));
+      const Int32 Index (event->lookup_index (AttributeHandle, EventAttrText));
 
-      if (ptr) { value = *ptr; result = True; }
+      if (Index >= 0) { value = event->textList.list[Index]; result = True; }
    }
 
    return result;
@@ -1264,16 +1187,11 @@ dmz::EventModuleBasic::store_data (
 
    if (event && !event->closed) {
 
-      Data *valuePtr (event->dataTable.lookup (AttributeHandle));
-
-      if (valuePtr) { *valuePtr = Value; result = True; }
-      else {
+      const Int32 Index (
+         event->store_index (AttributeHandle, EventAttrData, 1, event->dataList));
 
-         valuePtr = new Data (Value);
-
-         if (event->dataTable.store (AttributeHandle, valuePtr)) { result = True; }
-         else { delete valuePtr; valuePtr = 0; }
-      }
+      event->dataList.list[Index] = Value;
+      result = True;
    }
 
    return result;
@@ -1292,9 +1210,9 @@ dmz::EventModuleBasic::lookup_data (
 
    if (event) {
 
-      Data *ptr (event->dataTable.lookup (AttributeHandle));
+      const Int32 Index (event->lookup_index (AttributeHandle, EventAttrData));
 
-      if (ptr) { value = *ptr; result = True; }
+      if (Index >= 0) { value = event->dataList.list[Index]; result = True; }
    }
 
    return result;
@@ -1319,9 +1237,96 @@ dmz::EventModuleBasic::_create_event_observers (
 }
 
 
+dmz::EventModuleBasic::EventStruct *
+dmz::EventModuleBasic::_create_event (
+      const EventType &Type,
+      const EventLocalityEnum Locality) {
+
+   EventStruct *result (0);
+
+   if (Type && (Locality != EventLocalityUnknown)) {
+
+      EventStruct *event (_create_event_struct ());
+
+      if (event) {
+
+         const Handle EventHandle (
+            event->get_handle (Type.get_name (), _PluginInfoData.get_context ()));
+
+         if (EventHandle && _eventTable.store (EventHandle, event)) {
+
+            event->type = Type;
+            event->locality = Locality;
+            result = event;
+         }
+         else { _release_event_struct (*event); }
+      }
+   }
+
+   return result;
+}
+
+
+dmz::EventModuleBasic::EventStruct *
+dmz::EventModuleBasic::_create_event_struct () {
+
+   if (!_freeList) {
+
+      EventSlabStruct *slab (new EventSlabStruct (SlabSize));
+
+      if (slab) {
+
+         slab->next = _slabList;
+         _slabList = slab;
+
+         for (Int32 ix = SlabSize - 1; ix >= 0; ix--) {
+
+            slab->list[ix].next = _freeList;
+            _freeList = &(slab->list[ix]);
+         }
+      }
+   }
+
+   EventStruct *result (_freeList);
+
+   if (result) { _freeList = result->next; result->next = 0; }
+
+   return result;
+}
+
+
+void
+dmz::EventModuleBasic::_release_event_struct (EventStruct &event) {
+
+   if (&event == _eventCache) { _eventCache = 0; }
+
+   event.reset ();
+   event.next = _freeList;
+   _freeList = &event;
+}
+
+
+void
+dmz::EventModuleBasic::_expire_closed_event () {
+
+   EventStruct *event (_closedListHead);
+
+   if (event) {
+
+      _closedListHead = event->next;
+      if (!_closedListHead) { _closedListTail = 0; }
+      event->next = 0;
+
+      if (_eventTable.remove (event->handle) == event) { _release_event_struct (*event); }
+   }
+}
+
+
 void
 dmz::EventModuleBasic::_close_event (EventStruct &event) {
 
+   event.closing = True;
+
    EventType current (event.type);
 
    while (current) {
@@ -1369,15 +1374,156 @@ dmz::EventModuleBasic::_close_event (EventStruct &event) {
       current.become_parent ();
    }
 
-   // Move to end of the table.
-   if (_eventTable.remove (event.handle)) {
+   if (_closedListTail) { _closedListTail->next = &event; _closedListTail = &event; }
+   else { _closedListHead = _closedListTail = &event; }
+}
+
+
+void
+dmz::EventModuleBasic::_close_delayed_events () {
+
+   while (_delayedListHead) {
+
+      EventStruct *current (_delayedListHead);
+      _delayedListHead = _delayedListHead->next;
+      current->next = 0;
+      _close_event (*current);
+   }
+
+   _delayedListTail = 0;
+}
+
+
+// Each observer gets one callback with all of its events. The events are counted per
+// observer first so the records can be laid out contiguously in one array that is
+// owned by the module and is not affected by observers released during a callback.
+// Batches are usually made of events of the same type so the subscriptions for a type
+// are only looked up when the type changes.
+void
+dmz::EventModuleBasic::_send_batch (const Boolean Create) {
+
+   HashTableHandleTemplate<EventObserverStruct> &table (
+      Create ? _createTable : _closeTable);
+
+   _batchHandleList.clear ();
 
-      if (!_eventTable.store (event.handle, &event)) {
+   for (Int32 pass = 0; pass < 2; pass++) {
 
-         _log.error << "Internal error: Failed to save event: " << event.handle
-            << " of type: " << event.type.get_name () << endl;
-         _eventCache = 0; delete &event;
+      EventType lastType;
+
+      for (Int32 ix = 0; ix < _batchEventList.count; ix++) {
+
+         const EventStruct &Event (*(_batchEventList.list[ix]));
+
+         if ((ix == 0) || (Event.type != lastType)) {
+
+            lastType = Event.type;
+            _lookup_batch_subscriptions (lastType, table);
+         }
+
+         for (Int32 jy = 0; jy < _batchSubList.count; jy++) {
+
+            SubscriptionStruct &sub (*(_batchSubList.list[jy]));
+
+            if (pass == 0) {
+
+               if (!sub.batchCount) {
+
+                  const Int32 Index (_batchHandleList.add (1));
+                  _batchHandleList.list[Index] = sub.SubHandle;
+               }
+            }
+            else {
+
+               EventRecordStruct &record (
+                  _batchRecordList.list[sub.batchOffset + sub.batchCount]);
+
+               record.handle = Event.handle;
+               if (record.type != Event.type) { record.type = Event.type; }
+               record.locality = Event.locality;
+            }
+
+            sub.batchCount++;
+         }
       }
+
+      if (pass == 0) {
+
+         Int32 total (0);
+
+         for (Int32 ix = 0; ix < _batchHandleList.count; ix++) {
+
+            SubscriptionStruct *sub (
+               _subscriptionTable.lookup (_batchHandleList.list[ix]));
+
+            if (sub) {
+
+               sub->batchOffset = total;
+               total += sub->batchCount;
+               sub->batchCount = 0;
+            }
+         }
+
+         _batchRecordList.clear ();
+         _batchRecordList.add (total);
+      }
+   }
+
+   _batchSubList.clear ();
+
+   for (Int32 ix = 0; ix < _batchHandleList.count; ix++) {
+
+      SubscriptionStruct *sub (_subscriptionTable.lookup (_batchHandleList.list[ix]));
+
+      if (sub && sub->batchCount) {
+
+         const EventRecordStruct *List (_batchRecordList.list + sub->batchOffset);
+         const Int32 Count (sub->batchCount);
+         sub->batchCount = 0;
+
+         if (Create) { sub->obs.create_events (List, Count); }
+         else { sub->obs.close_events (List, Count); }
+      }
+   }
+
+   _batchHandleList.clear ();
+}
+
+
+void
+dmz::EventModuleBasic::_lookup_batch_subscriptions (
+      const EventType &Type,
+      HashTableHandleTemplate<EventObserverStruct> &table) {
+
+   _batchSubList.clear ();
+
+   EventType current (Type);
+
+   while (current) {
+
+      EventObserverStruct *eos (table.lookup (current.get_handle ()));
+
+      if (eos) {
+
+         HashTableHandleIterator it;
+
+         EventObserver *obs (eos->get_first (it));
+
+         while (obs) {
+
+            SubscriptionStruct *sub (_subscriptionTable.lookup (it.get_hash_key ()));
+
+            if (sub) {
+
+               const Int32 Index (_batchSubList.add (1));
+               _batchSubList.list[Index] = sub;
+            }
+
+            obs = eos->get_next (it);
+         }
+      }
+
+      current.become_parent ();
    }
 }
 
@@ -1385,6 +1531,13 @@ dmz::EventModuleBasic::_close_event (EventStruct &event) {
 void
 dmz::EventModuleBasic::_init (Config &local) {
 
+   Definitions defs (get_plugin_runtime_context (), &_log);
+
+   _defaultHandle = defs.create_named_handle (EventAttributeDefaultName);
+   _sourceHandle = defs.create_named_handle (EventAttributeSourceName);
+   _targetHandle = defs.create_named_handle (EventAttributeTargetName);
+   _munitionsHandle = defs.create_named_handle (EventAttributeMunitionsName);
+
    _eventTTL = config_to_float64 ("ttl.value", local, 1.0);
    _maxEvents = config_to_int32 ("max.value", local, 0);
 }
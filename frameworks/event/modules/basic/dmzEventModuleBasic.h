@@ -3,6 +3,7 @@
 
 #include <dmzEventModule.h>
 #include <dmzEventObserver.h>
+#include <dmzRuntimeData.h>
 #include <dmzRuntimeEventType.h>
 #include <dmzRuntimeHandle.h>
 #include <dmzRuntimeLog.h>
@@ -12,7 +13,9 @@
 #include <dmzRuntimeTime.h>
 #include <dmzTypesHashTableStringTemplate.h>
 #include <dmzTypesHashTableHandleTemplate.h>
+#include <dmzTypesMask.h>
 #include <dmzTypesMatrix.h>
+#include <dmzTypesString.h>
 #include <dmzTypesVector.h>
 
 namespace dmz {
@@ -64,6 +67,10 @@ namespace dmz {
 
          virtual Boolean close_event (const Handle EventHandle);
 
+         virtual Int32 create_events (EventDescriptorStruct *list, const Int32 Count);
+
+         virtual Int32 close_events (const Handle *List, const Int32 Count);
+
          virtual Boolean lookup_event_type (const Handle EventHandle, EventType &value);
 
          virtual EventLocalityEnum lookup_locality (const Handle EventHandle);
@@ -219,31 +226,97 @@ namespace dmz {
             Data &value);
 
       protected:
+         enum EventAttrEnum {
+            EventAttrHandle,
+            EventAttrObject,
+            EventAttrType,
+            EventAttrState,
+            EventAttrTimeStamp,
+            EventAttrPosition,
+            EventAttrOrientation,
+            EventAttrVelocity,
+            EventAttrAcceleration,
+            EventAttrScale,
+            EventAttrVector,
+            EventAttrScalar,
+            EventAttrCounter,
+            EventAttrText,
+            EventAttrData
+         };
+
+         struct AttrStruct {
+
+            Handle attr;
+            Int32 kind;
+            Int32 index;
+         };
+
+         union ValueUnion {
+
+            Handle handle;
+            Float64 real;
+            Int64 counter;
+         };
+
+         template <class T, int LocalSize> struct AttrArrayTemplate {
+
+            T *list;
+            Int32 count;
+            Int32 size;
+            T local[LocalSize];
+
+            Int32 add (const Int32 Count) {
+
+               if ((count + Count) > size) {
+
+                  Int32 newSize (size * 2);
+                  while (newSize < (count + Count)) { newSize *= 2; }
+
+                  T *newList (new T[newSize]);
+                  for (Int32 ix = 0; ix < count; ix++) { newList[ix] = list[ix]; }
+                  if (list != local) { delete []list; }
+
+                  list = newList;
+                  size = newSize;
+               }
+
+               const Int32 Result (count);
+               count += Count;
+               return Result;
+            }
+
+            void clear () { count = 0; }
+
+            void reset () {
+
+               const T Empty;
+               for (Int32 ix = 0; ix < count; ix++) { list[ix] = Empty; }
+               count = 0;
+            }
+
+            AttrArrayTemplate () : list (local), count (0), size (LocalSize) {;}
+            ~AttrArrayTemplate () { if (list != local) { delete []list; } list = 0; }
+         };
+
          struct EventStruct {
 
             EventStruct *next;
             Handle handle;
             RuntimeHandle *handlePtr;
+            Boolean closing;
             Boolean closed;
             Float64 closeTime;
             EventType type;
             EventLocalityEnum locality;
 
-            HashTableHandleTemplate<Handle> handleTable;
-            HashTableHandleTemplate<Handle> objectTable;
-            HashTableHandleTemplate<ObjectType> typeTable;
-            HashTableHandleTemplate<Mask> stateTable;
-            HashTableHandleTemplate<Float64> timeStampTable;
-            HashTableHandleTemplate<Vector> positionTable;
-            HashTableHandleTemplate<Matrix> orientationTable;
-            HashTableHandleTemplate<Vector> velocityTable;
-            HashTableHandleTemplate<Vector> accelerationTable;
-            HashTableHandleTemplate<Vector> scaleTable;
-            HashTableHandleTemplate<Vector> vectorTable;
-            HashTableHandleTemplate<Float64> scalarTable;
-            HashTableHandleTemplate<Int64> counterTable;
-            HashTableHandleTemplate<String> textTable;
-            HashTableHandleTemplate<Data> dataTable;
+            // Events carry a handful of attributes so they are kept in a compact block
+            // and searched linearly. Numeric values share one array of slots.
+            AttrArrayTemplate<AttrStruct, 8> attrList;
+            AttrArrayTemplate<ValueUnion, 24> valueList;
+            AttrArrayTemplate<ObjectType, 1> typeList;
+            AttrArrayTemplate<Mask, 1> stateList;
+            AttrArrayTemplate<String, 1> textList;
+            AttrArrayTemplate<Data, 1> dataList;
 
             Handle get_handle (const String &TypeName, RuntimeContext *context) {
 
@@ -260,41 +333,100 @@ namespace dmz {
                return handle;
             }
 
+            Int32 lookup_index (const Handle Attr, const Int32 Kind) const {
+
+               Int32 result (-1);
+
+               for (Int32 ix = 0; (result < 0) && (ix < attrList.count); ix++) {
+
+                  const AttrStruct &Current (attrList.list[ix]);
+
+                  if ((Current.attr == Attr) && (Current.kind == Kind)) {
+
+                     result = Current.index;
+                  }
+               }
+
+               return result;
+            }
+
+            template <class T, int LocalSize> Int32 store_index (
+                  const Handle Attr,
+                  const Int32 Kind,
+                  const Int32 Count,
+                  AttrArrayTemplate<T, LocalSize> &array) {
+
+               Int32 result (lookup_index (Attr, Kind));
+
+               if (result < 0) {
+
+                  result = array.add (Count);
+
+                  const Int32 Index (attrList.add (1));
+                  AttrStruct &current (attrList.list[Index]);
+                  current.attr = Attr;
+                  current.kind = Kind;
+                  current.index = result;
+               }
+
+               return result;
+            }
+
+            ValueUnion *store_values (
+                  const Handle Attr,
+                  const Int32 Kind,
+                  const Int32 Count) {
+
+               const Int32 Index (store_index (Attr, Kind, Count, valueList));
+               return valueList.list + Index;
+            }
+
+            const ValueUnion *lookup_values (const Handle Attr, const Int32 Kind) const {
+
+               const Int32 Index (lookup_index (Attr, Kind));
+               return Index >= 0 ? valueList.list + Index : 0;
+            }
+
             void reset () {
 
                if (handlePtr) { delete handlePtr; handlePtr = 0; }
 
                next = 0;
                handle = 0;
+               closing = False;
                closed = False;
                closeTime = 0.0;
                locality = EventLocalityUnknown;
-               handleTable.empty ();
-               objectTable.empty ();
-               typeTable.empty ();
-               stateTable.empty ();
-               timeStampTable.empty ();
-               positionTable.empty ();
-               orientationTable.empty ();
-               velocityTable.empty ();
-               accelerationTable.empty ();
-               scaleTable.empty ();
-               vectorTable.empty ();
-               scalarTable.empty ();
-               counterTable.empty ();
-               textTable.empty ();
-               dataTable.empty ();
+               attrList.clear ();
+               valueList.clear ();
+               typeList.reset ();
+               stateList.reset ();
+               textList.reset ();
+               dataList.reset ();
             }
 
             EventStruct () :
                   next (0),
                   handle (0),
                   handlePtr (0),
+                  closing (False),
                   closed (False),
                   closeTime (0.0),
                   locality (EventLocalityUnknown) {;}
 
-            ~EventStruct () { if (next) { delete next; next = 0; } reset (); }
+            ~EventStruct () { reset (); }
+         };
+
+         struct EventSlabStruct {
+
+            EventSlabStruct *next;
+            EventStruct *list;
+
+            EventSlabStruct (const Int32 Size) :
+                  next (0),
+                  list (new EventStruct[Size]) {;}
+
+            ~EventSlabStruct () { if (list) { delete []list; list = 0; } }
          };
 
          struct SubscriptionStruct {
@@ -303,21 +435,38 @@ namespace dmz {
             HashTableHandleTemplate<EventObserverStruct> createTable;
             HashTableHandleTemplate<EventObserverStruct> closeTable;
             EventObserver &obs;
+            Int32 batchCount;
+            Int32 batchOffset;
 
             SubscriptionStruct (EventObserver &theObs) :
                   SubHandle (theObs.get_event_observer_handle ()),
-                  obs (theObs) {;}
+                  obs (theObs),
+                  batchCount (0),
+                  batchOffset (0) {;}
 
             ~SubscriptionStruct () { createTable.clear (); closeTable.clear (); }
          };
 
          EventStruct *_lookup_event (const Handle EventHandle);
 
+         EventStruct *_create_event (
+            const EventType &Type,
+            const EventLocalityEnum Locality);
+
          EventObserverStruct *_create_event_observers (
             const Handle TypeHandle,
             HashTableHandleTemplate<EventObserverStruct> &table);
 
+         EventStruct *_create_event_struct ();
+         void _release_event_struct (EventStruct &event);
+         void _expire_closed_event ();
          void _close_event (EventStruct &es);
+         void _close_delayed_events ();
+         void _send_batch (const Boolean Create);
+
+         void _lookup_batch_subscriptions (
+            const EventType &Type,
+            HashTableHandleTemplate<EventObserverStruct> &table);
 
          void _init (Config &local);
 
@@ -328,12 +477,25 @@ namespace dmz {
          Int32 _maxEvents;
          Float64 _eventTTL;
 
+         Handle _defaultHandle;
+         Handle _sourceHandle;
+         Handle _targetHandle;
+         Handle _munitionsHandle;
+
          HashTableHandleTemplate<EventStruct> _eventTable;
 
          EventStruct *_eventCache;
          EventStruct *_delayedListHead;
          EventStruct *_delayedListTail;
-         EventStruct *_recycleList;
+         EventStruct *_closedListHead;
+         EventStruct *_closedListTail;
+         EventStruct *_freeList;
+         EventSlabStruct *_slabList;
+
+         AttrArrayTemplate<EventStruct *, 64> _batchEventList;
+         AttrArrayTemplate<SubscriptionStruct *, 16> _batchSubList;
+         AttrArrayTemplate<Handle, 16> _batchHandleList;
+         AttrArrayTemplate<EventRecordStruct, 1> _batchRecordList;
 
          HashTableHandleTemplate<SubscriptionStruct> _subscriptionTable;
          HashTableHandleTemplate<EventObserverStruct> _createTable;
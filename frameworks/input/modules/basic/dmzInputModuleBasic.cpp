@@ -1,4 +1,6 @@
 #include "dmzInputModuleBasic.h"
+#include <dmzRuntimeConfig.h>
+#include <dmzRuntimeConfigToTypesBase.h>
 #include <dmzRuntimeInit.h>
 #include <dmzRuntimePluginFactoryLinkSymbol.h>
 #include <dmzRuntimeRTTI.h>
@@ -15,8 +17,22 @@
 \class dmz::InputModuleBasic
 \ingroup Input
 \brief Basic InputModule implementation.
-\details This provides a basic implementation of the InputModule. At this time the
-InputModuleBasic has no configuration parameters.
+\details This provides a basic implementation of the InputModule. Events are sent
+through per event type dispatch lists of the active channels. The lists are rebuilt
+when a channel changes state or an observer subscription changes.
+Axis and mouse move events may be coalesced so that only the latest axis value and
+mouse position from each source is sent once per frame. Mouse events that change the
+buttons or scroll are never coalesced and are sent after any pending move from the
+same source.
+\code
+<dmz>
+<dmzInputModuleBasic>
+   <coalesce value="Boolean"/>
+</dmzInputModuleBasic>
+</dmz>
+\endcode
+- \b coalesce.value Coalesces axis and mouse move events once per frame. Defaults to
+false.
 \sa InputModule
 
 */
@@ -114,16 +130,22 @@ struct DataQueStruct : public estruct {
 
 
 //! \cond
-dmz::InputModuleBasic::InputModuleBasic (const PluginInfo &Info) :
+dmz::InputModuleBasic::InputModuleBasic (const PluginInfo &Info, Config &local) :
       Plugin (Info),
+      TimeSlice (Info),
       InputModule (Info),
       _inEvent (False),
       _inQue (False),
       _eventQueHead (0),
       _eventQueTail (0),
+      _dispatchDirty (True),
+      _coalesce (False),
       _eventCount (0),
       _log (Info),
-      _defs (Info, &_log) {;}
+      _defs (Info, &_log) {
+
+   _init (local);
+}
 
 
 dmz::InputModuleBasic::~InputModuleBasic () {
@@ -151,6 +173,8 @@ dmz::InputModuleBasic::~InputModuleBasic () {
    _channelTable.empty ();
 
    _keyCache.empty ();
+   _pendingAxisTable.clear ();
+   _pendingMouseTable.empty ();
    _controllerCache.empty ();
 }
 
@@ -176,6 +200,14 @@ dmz::InputModuleBasic::discover_plugin (
 }
 
 
+// TimeSlice Interface
+void
+dmz::InputModuleBasic::update_time_slice (const Float64 TimeDelta) {
+
+   _send_coalesced_events ();
+}
+
+
 // Input Module Interface
 void
 dmz::InputModuleBasic::register_input_observer (
@@ -277,6 +309,8 @@ dmz::InputModuleBasic::register_input_observer (
                }
             }
 
+            if (updateMask.is_set ()) { _dispatchDirty = True; }
+
             if (obsMask->is_set ()) {
 
                cs->activeTable.store (os->ObsHandle, os);
@@ -386,6 +420,8 @@ dmz::InputModuleBasic::release_input_observer (
                }
             }
 
+            if (updateMask.is_set ()) { _dispatchDirty = True; }
+
             if (cs->active && updateMask.is_set ()) {
 
                _decrement_active_count (cs->ChannelHandle, updateMask, *os);
@@ -434,6 +470,7 @@ dmz::InputModuleBasic::set_channel_state (
 
          cs->active = Value;
          cs->locked = True;
+         _dispatchDirty = True;
 
          HashTableHandleIterator it;
 
@@ -491,57 +528,43 @@ dmz::InputModuleBasic::send_axis_event (const InputEventAxis &Event) {
 
       _inEvent = True;
 
-      _eventCount++;
-
-      HashTableHandleIterator it;
-
-      ChannelStruct *cs (_channelTable.get_first (it));
+      Boolean send (True);
 
       ControllerStruct *controller (_get_controller (Event.get_source_handle ()));
 
       if (controller) {
 
-         InputEventAxis *tmp (controller->axisTable.lookup (Event.get_axis_id ()));
+         const Handle AxisId (Event.get_axis_id ());
+
+         InputEventAxis *tmp (controller->axisTable.lookup (AxisId));
 
          if (tmp) {
 
             if (*tmp != Event) { *tmp = Event; }
-            else { cs = 0; } // don't send duplicate events
+            else { send = False; } // don't send duplicate events
          }
          else {
 
             tmp = new InputEventAxis (Event);
 
-            if (tmp && !controller->axisTable.store (Event.get_axis_id (), tmp)) {
+            if (tmp && !controller->axisTable.store (AxisId, tmp)) {
 
                delete tmp; tmp = 0;
             }
          }
-      }
-
-      while (cs) {
-
-         if (cs->active) {
-
-            HashTableHandleIterator osIt;
-
-            ObsStruct *os (cs->axisTable.get_first (osIt));
-
-            while (os) {
-
-               if (os->eventCount != _eventCount) {
 
-                  os->obs.receive_axis_event (cs->ChannelHandle, Event);
-                  os->eventCount = _eventCount;
-               }
+         // The cached event is sent with the latest value at the end of the frame.
+         if (send && tmp && _coalesce &&
+               (controller->pendingAxisTable.lookup (AxisId) ||
+                  controller->pendingAxisTable.store (AxisId, tmp))) {
 
-               os = cs->axisTable.get_next (osIt);
-            }
+            _pendingAxisTable.store (controller->SourceHandle, controller);
+            send = False;
          }
-
-         cs = _channelTable.get_next (it);
       }
 
+      if (send) { _send_axis_event (Event); }
+
       _inEvent = False;
       _do_qued_events ();
    }
@@ -556,11 +579,7 @@ dmz::InputModuleBasic::send_button_event (const InputEventButton &Event) {
 
       _inEvent = True;
 
-      _eventCount++;
-
-      HashTableHandleIterator it;
-
-      ChannelStruct *cs (_channelTable.get_first (it));
+      Boolean send (True);
 
       ControllerStruct *controller (_get_controller (Event.get_source_handle ()));
 
@@ -571,7 +590,7 @@ dmz::InputModuleBasic::send_button_event (const InputEventButton &Event) {
          if (tmp) {
 
             if (*tmp != Event) { *tmp = Event; }
-            else { cs = 0; } // event already sent; don't send again
+            else { send = False; } // event already sent; don't send again
          }
          else {
 
@@ -584,27 +603,22 @@ dmz::InputModuleBasic::send_button_event (const InputEventButton &Event) {
          }
       }
 
-      while (cs) {
+      if (send) {
 
-         if (cs->active) {
+         _eventCount++;
 
-            HashTableHandleIterator osIt;
+         if (_dispatchDirty) { _update_dispatch (); }
 
-            ObsStruct *os (cs->buttonTable.get_first (osIt));
+         for (Int32 ix = 0; ix < _buttonDispatch.count; ix++) {
 
-            while (os) {
+            DispatchStruct &ds (_buttonDispatch.list[ix]);
 
-               if (os->eventCount != _eventCount) {
+            if (ds.cs->active && (ds.os->eventCount != _eventCount)) {
 
-                  os->obs.receive_button_event (cs->ChannelHandle, Event);
-                  os->eventCount = _eventCount;
-               }
-
-               os = cs->buttonTable.get_next (osIt);
+               ds.os->obs.receive_button_event (ds.cs->ChannelHandle, Event);
+               ds.os->eventCount = _eventCount;
             }
          }
-
-         cs = _channelTable.get_next (it);
       }
 
       _inEvent = False;
@@ -621,11 +635,7 @@ dmz::InputModuleBasic::send_switch_event (const InputEventSwitch &Event) {
 
       _inEvent = True;
 
-      _eventCount++;
-
-      HashTableHandleIterator it;
-
-      ChannelStruct *cs (_channelTable.get_first (it));
+      Boolean send (True);
 
       ControllerStruct *controller (_get_controller (Event.get_source_handle ()));
 
@@ -636,7 +646,7 @@ dmz::InputModuleBasic::send_switch_event (const InputEventSwitch &Event) {
          if (tmp) {
 
             if (*tmp != Event) { *tmp = Event; }
-            else { cs = 0; } // don't send duplicate events
+            else { send = False; } // don't send duplicate events
          }
          else {
 
@@ -649,27 +659,22 @@ dmz::InputModuleBasic::send_switch_event (const InputEventSwitch &Event) {
          }
       }
 
-      while (cs) {
-
-         if (cs->active) {
+      if (send) {
 
-            HashTableHandleIterator osIt;
+         _eventCount++;
 
-            ObsStruct *os (cs->switchTable.get_first (osIt));
+         if (_dispatchDirty) { _update_dispatch (); }
 
-            while (os) {
+         for (Int32 ix = 0; ix < _switchDispatch.count; ix++) {
 
-               if (os->eventCount != _eventCount) {
+            DispatchStruct &ds (_switchDispatch.list[ix]);
 
-                  os->obs.receive_switch_event (cs->ChannelHandle, Event);
-                  os->eventCount = _eventCount;
-               }
+            if (ds.cs->active && (ds.os->eventCount != _eventCount)) {
 
-               os = cs->switchTable.get_next (osIt);
+               ds.os->obs.receive_switch_event (ds.cs->ChannelHandle, Event);
+               ds.os->eventCount = _eventCount;
             }
          }
-
-         cs = _channelTable.get_next (it);
       }
 
       _inEvent = False;
@@ -686,11 +691,7 @@ dmz::InputModuleBasic::send_key_event (const InputEventKey &Event) {
 
       _inEvent = True;
 
-      _eventCount++;
-
-      HashTableHandleIterator it;
-
-      ChannelStruct *cs (_channelTable.get_first (it));
+      Boolean send (True);
 
       if (Event.get_key_state ()) {
 
@@ -699,7 +700,7 @@ dmz::InputModuleBasic::send_key_event (const InputEventKey &Event) {
          if (!_keyCache.store (Event.get_key (), tmp)) {
 
             if (tmp) { delete tmp; tmp = 0; }
-            cs = 0; // Key has already been pushed no need to send event again
+            send = False; // Key has already been pushed no need to send event again
          }
       }
       else {
@@ -730,31 +731,26 @@ dmz::InputModuleBasic::send_key_event (const InputEventKey &Event) {
          if (tmp) { delete tmp; tmp = 0; }
          else { // Key release has already been sent, no need to send again
 
-            cs = 0;
+            send = False;
          }
       }
 
-      while (cs) {
-
-         if (cs->active) {
+      if (send) {
 
-            HashTableHandleIterator osIt;
+         _eventCount++;
 
-            ObsStruct *os (cs->keyTable.get_first (osIt));
+         if (_dispatchDirty) { _update_dispatch (); }
 
-            while (os) {
+         for (Int32 ix = 0; ix < _keyDispatch.count; ix++) {
 
-               if (os->eventCount != _eventCount) {
+            DispatchStruct &ds (_keyDispatch.list[ix]);
 
-                  os->obs.receive_key_event (cs->ChannelHandle, Event);
-                  os->eventCount = _eventCount;
-               }
+            if (ds.cs->active && (ds.os->eventCount != _eventCount)) {
 
-               os = cs->keyTable.get_next (osIt);
+               ds.os->obs.receive_key_event (ds.cs->ChannelHandle, Event);
+               ds.os->eventCount = _eventCount;
             }
          }
-
-         cs = _channelTable.get_next (it);
       }
 
       _inEvent = False;
@@ -771,41 +767,43 @@ dmz::InputModuleBasic::send_mouse_event (const InputEventMouse &Event) {
 
       _inEvent = True;
 
-      _eventCount++;
-
-      HashTableHandleIterator it;
-
-      ChannelStruct *cs (_channelTable.get_first (it));
-
-      if ((_mouseCache != Event) ||
+      if (_coalesce) { _coalesce_mouse_event (Event); }
+      else if ((_mouseCache != Event) ||
             Event.get_scroll_delta_x () ||
             Event.get_scroll_delta_y ()) {
 
          _mouseCache = Event;
-       }
-      else { cs = 0; } // don't send duplicate events
+         _send_mouse_event (Event);
+      }
+      // else don't send duplicate events
 
-      while (cs) {
+      _inEvent = False;
+      _do_qued_events ();
+   }
+}
 
-         if (cs->active) {
 
-            HashTableHandleIterator osIt;
+void
+dmz::InputModuleBasic::send_data_event (const Handle Source, const Data &Event) {
 
-            ObsStruct *os (cs->mouseTable.get_first (osIt));
+   if (_inEvent) { _que_event (new DataQueStruct (Source, Event)); }
+   else {
 
-            while (os) {
+      _inEvent = True;
 
-               if (os->eventCount != _eventCount) {
+      _eventCount++;
 
-                  os->obs.receive_mouse_event (cs->ChannelHandle, Event);
-                  os->eventCount = _eventCount;
-               }
+      if (_dispatchDirty) { _update_dispatch (); }
 
-               os = cs->mouseTable.get_next (osIt);
-            }
-         }
+      for (Int32 ix = 0; ix < _dataDispatch.count; ix++) {
+
+         DispatchStruct &ds (_dataDispatch.list[ix]);
 
-         cs = _channelTable.get_next (it);
+         if (ds.cs->active && (ds.os->eventCount != _eventCount)) {
+
+            ds.os->obs.receive_data_event (ds.cs->ChannelHandle, Source, Event);
+            ds.os->eventCount = _eventCount;
+         }
       }
 
       _inEvent = False;
@@ -814,43 +812,201 @@ dmz::InputModuleBasic::send_mouse_event (const InputEventMouse &Event) {
 }
 
 
+// Rebuilds the dispatch lists from the active channels. The lists keep the order the
+// channel and observer tables are iterated in so observers subscribed on more than one
+// channel still receive each event through the same channel as before.
 void
-dmz::InputModuleBasic::send_data_event (const Handle Source, const Data &Event) {
+dmz::InputModuleBasic::_update_dispatch () {
 
-   if (_inEvent) { _que_event (new DataQueStruct (Source, Event)); }
-   else {
+   _axisDispatch.count = 0;
+   _buttonDispatch.count = 0;
+   _switchDispatch.count = 0;
+   _keyDispatch.count = 0;
+   _mouseDispatch.count = 0;
+   _dataDispatch.count = 0;
 
-      _inEvent = True;
+   HashTableHandleIterator it;
 
-      _eventCount++;
+   ChannelStruct *cs (_channelTable.get_first (it));
 
-      HashTableHandleIterator it;
+   while (cs) {
+
+      if (cs->active) {
 
-      ChannelStruct *cs (_channelTable.get_first (it));
+         _add_dispatch (*cs, cs->axisTable, _axisDispatch);
+         _add_dispatch (*cs, cs->buttonTable, _buttonDispatch);
+         _add_dispatch (*cs, cs->switchTable, _switchDispatch);
+         _add_dispatch (*cs, cs->keyTable, _keyDispatch);
+         _add_dispatch (*cs, cs->mouseTable, _mouseDispatch);
+         _add_dispatch (*cs, cs->dataTable, _dataDispatch);
+      }
+
+      cs = _channelTable.get_next (it);
+   }
 
-      while (cs) {
+   _dispatchDirty = False;
+}
 
-         if (cs->active) {
 
-            HashTableHandleIterator osIt;
+void
+dmz::InputModuleBasic::_add_dispatch (
+      ChannelStruct &cs,
+      HashTableHandleTemplate<ObsStruct> &table,
+      DispatchListStruct &list) {
 
-            ObsStruct *os (cs->dataTable.get_first (osIt));
+   HashTableHandleIterator it;
 
-            while (os) {
+   ObsStruct *os (table.get_first (it));
 
-               if (os->eventCount != _eventCount) {
+   while (os) { list.add (cs, *os); os = table.get_next (it); }
+}
 
-                  os->obs.receive_data_event (cs->ChannelHandle, Source, Event);
-                  os->eventCount = _eventCount;
-               }
 
-               os = cs->dataTable.get_next (osIt);
+void
+dmz::InputModuleBasic::_send_axis_event (const InputEventAxis &Event) {
+
+   _eventCount++;
+
+   if (_dispatchDirty) { _update_dispatch (); }
+
+   for (Int32 ix = 0; ix < _axisDispatch.count; ix++) {
+
+      DispatchStruct &ds (_axisDispatch.list[ix]);
+
+      // A channel may be deactivated by an observer while the event is being sent.
+      if (ds.cs->active && (ds.os->eventCount != _eventCount)) {
+
+         ds.os->obs.receive_axis_event (ds.cs->ChannelHandle, Event);
+         ds.os->eventCount = _eventCount;
+      }
+   }
+}
+
+
+void
+dmz::InputModuleBasic::_send_mouse_event (const InputEventMouse &Event) {
+
+   _eventCount++;
+
+   if (_dispatchDirty) { _update_dispatch (); }
+
+   for (Int32 ix = 0; ix < _mouseDispatch.count; ix++) {
+
+      DispatchStruct &ds (_mouseDispatch.list[ix]);
+
+      if (ds.cs->active && (ds.os->eventCount != _eventCount)) {
+
+         ds.os->obs.receive_mouse_event (ds.cs->ChannelHandle, Event);
+         ds.os->eventCount = _eventCount;
+      }
+   }
+}
+
+
+void
+dmz::InputModuleBasic::_coalesce_mouse_event (const InputEventMouse &Event) {
+
+   const Handle Source (Event.get_source_handle ());
+
+   const Boolean Scroll (Event.get_scroll_delta_x () || Event.get_scroll_delta_y ());
+
+   const Boolean Move (
+      !Scroll &&
+      !Event.have_buttons_changed () &&
+      (Event.get_button_mask () == _mouseCache.get_button_mask ()));
+
+   InputEventMouse *pending (_pendingMouseTable.lookup (Source));
+
+   if (Move) {
+
+      if (_mouseCache != Event) {
+
+         _mouseCache = Event;
+
+         if (pending) {
+
+            // Keep the previous position of the first move so the deltas span the frame.
+            Int32 x (0), y (0), screenX (0), screenY (0);
+            pending->get_previous_mouse_position (x, y);
+            pending->get_previous_mouse_screen_position (screenX, screenY);
+
+            *pending = Event;
+            pending->set_previous_mouse_position (x, y);
+            pending->set_previous_mouse_screen_position (screenX, screenY);
+         }
+         else {
+
+            pending = new InputEventMouse (Event);
+
+            if (!_pendingMouseTable.store (Source, pending)) {
+
+               delete pending; pending = 0;
+               _send_mouse_event (Event);
             }
          }
+      }
+   }
+   else {
+
+      // Button and scroll events are sent after the move that led up to them.
+      if (pending && _pendingMouseTable.remove (Source)) {
 
-         cs = _channelTable.get_next (it);
+         _send_mouse_event (*pending);
+         delete pending; pending = 0;
       }
 
+      if ((_mouseCache != Event) || Scroll) {
+
+         _mouseCache = Event;
+         _send_mouse_event (Event);
+      }
+   }
+}
+
+
+void
+dmz::InputModuleBasic::_send_coalesced_events () {
+
+   if (!_inEvent &&
+         (_pendingAxisTable.get_count () || _pendingMouseTable.get_count ())) {
+
+      _inEvent = True;
+
+      HashTableHandleIterator it;
+
+      ControllerStruct *controller (_pendingAxisTable.get_first (it));
+
+      while (controller) {
+
+         HashTableHandleIterator axisIt;
+
+         InputEventAxis *event (controller->pendingAxisTable.get_first (axisIt));
+
+         while (event) {
+
+            _send_axis_event (*event);
+            event = controller->pendingAxisTable.get_next (axisIt);
+         }
+
+         controller->pendingAxisTable.clear ();
+
+         controller = _pendingAxisTable.get_next (it);
+      }
+
+      _pendingAxisTable.clear ();
+
+      it.reset ();
+
+      InputEventMouse *event (_pendingMouseTable.get_first (it));
+
+      while (event) {
+
+         _send_mouse_event (*event);
+         event = _pendingMouseTable.get_next (it);
+      }
+
+      _pendingMouseTable.empty ();
+
       _inEvent = False;
       _do_qued_events ();
    }
@@ -1236,6 +1392,15 @@ dmz::InputModuleBasic::_get_controller (const Handle ControllerHandle) {
 
    return cs;
 }
+
+
+void
+dmz::InputModuleBasic::_init (Config &local) {
+
+   _coalesce = config_to_boolean ("coalesce.value", local, _coalesce);
+
+   if (!_coalesce) { stop_time_slice (); }
+}
 //! \endcond
 
 
@@ -1247,7 +1412,7 @@ create_dmzInputModuleBasic (
       dmz::Config &local,
       dmz::Config &global) {
 
-   return new dmz::InputModuleBasic (Info);
+   return new dmz::InputModuleBasic (Info, local);
 }
 
 };
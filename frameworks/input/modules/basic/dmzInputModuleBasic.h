@@ -10,6 +10,7 @@
 #include <dmzRuntimeDefinitions.h>
 #include <dmzRuntimeLog.h>
 #include <dmzRuntimePlugin.h>
+#include <dmzRuntimeTimeSlice.h>
 #include <dmzTypesBase.h>
 #include <dmzTypesString.h>
 #include <dmzTypesHashTableStringTemplate.h>
@@ -17,7 +18,12 @@
 
 namespace dmz {
 
-   class InputModuleBasic : public Plugin, public InputModule {
+   class Config;
+
+   class InputModuleBasic :
+         public Plugin,
+         public TimeSlice,
+         public InputModule {
 
       public:
          //! \cond
@@ -30,7 +36,7 @@ namespace dmz {
             virtual void send_event (InputModule &module) = 0;
          };
 
-         InputModuleBasic (const PluginInfo &Info);
+         InputModuleBasic (const PluginInfo &Info, Config &local);
          ~InputModuleBasic ();
 
          // Plugin Interface
@@ -42,6 +48,9 @@ namespace dmz {
             const PluginDiscoverEnum Mode,
             const Plugin *PluginPtr);
 
+         // TimeSlice Interface
+         virtual void update_time_slice (const Float64 TimeDelta);
+
          // Input Module Interface
          virtual void register_input_observer (
             const Handle Channel,
@@ -115,17 +124,54 @@ namespace dmz {
                   locked (False) {;}
          };
 
+         struct DispatchStruct {
+
+            ChannelStruct *cs;
+            ObsStruct *os;
+         };
+
+         struct DispatchListStruct {
+
+            DispatchStruct *list;
+            Int32 count;
+            Int32 size;
+
+            DispatchListStruct () : list (0), count (0), size (0) {;}
+            ~DispatchListStruct () { if (list) { delete []list; list = 0; } }
+
+            void add (ChannelStruct &cs, ObsStruct &os) {
+
+               if (count >= size) {
+
+                  const Int32 NewSize (size ? size * 2 : 8);
+                  DispatchStruct *tmp (new DispatchStruct[NewSize]);
+
+                  for (Int32 ix = 0; ix < count; ix++) { tmp[ix] = list[ix]; }
+
+                  if (list) { delete []list; }
+                  list = tmp;
+                  size = NewSize;
+               }
+
+               list[count].cs = &cs;
+               list[count].os = &os;
+               count++;
+            }
+         };
+
          struct ControllerStruct {
 
             const Handle SourceHandle;
             HashTableHandleTemplate<InputEventAxis> axisTable;
             HashTableHandleTemplate<InputEventButton> buttonTable;
             HashTableHandleTemplate<InputEventSwitch> switchTable;
+            HashTableHandleTemplate<InputEventAxis> pendingAxisTable;
 
             ControllerStruct (const Handle TheHandle) : SourceHandle (TheHandle) {;}
 
             ~ControllerStruct () {
 
+               pendingAxisTable.clear ();
                axisTable.empty ();
                buttonTable.empty ();
                switchTable.empty ();
@@ -142,6 +188,18 @@ namespace dmz {
             const Mask EventMask,
             ObsStruct &os);
 
+         void _update_dispatch ();
+
+         void _add_dispatch (
+            ChannelStruct &cs,
+            HashTableHandleTemplate<ObsStruct> &table,
+            DispatchListStruct &list);
+
+         void _send_axis_event (const InputEventAxis &Event);
+         void _send_mouse_event (const InputEventMouse &Event);
+         void _coalesce_mouse_event (const InputEventMouse &Event);
+         void _send_coalesced_events ();
+
          void _que_event (EventQueStruct *event);
          void _do_qued_events ();
 
@@ -149,6 +207,8 @@ namespace dmz {
 
          ControllerStruct *_get_controller (const Handle Handle);
 
+         void _init (Config &local);
+
          Boolean _inEvent;
          Boolean _inQue;
          EventQueStruct *_eventQueHead;
@@ -163,6 +223,18 @@ namespace dmz {
 
          InputEventMouse _mouseCache;
 
+         Boolean _dispatchDirty;
+         DispatchListStruct _axisDispatch;
+         DispatchListStruct _buttonDispatch;
+         DispatchListStruct _switchDispatch;
+         DispatchListStruct _keyDispatch;
+         DispatchListStruct _mouseDispatch;
+         DispatchListStruct _dataDispatch;
+
+         Boolean _coalesce;
+         HashTableHandleTemplate<ControllerStruct> _pendingAxisTable;
+         HashTableHandleTemplate<InputEventMouse> _pendingMouseTable;
+
          UInt32 _eventCount;
 
          Log _log;
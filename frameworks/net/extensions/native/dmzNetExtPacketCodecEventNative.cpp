@@ -26,6 +26,7 @@
 \details
 \code
 <local-scope>
+   <batch value="false"/>
    <adapter
       type="Adapter Type"
       attribute="Attribute Name"
@@ -35,6 +36,13 @@
 \endcode
 Possible types are: id, object-type, state, position, orientation, velocity, acceleration, scale, vector, scalar, timestamp, and text. Data object are not currently supported.
 
+When batch is true, the packet carries an event count after the system id, then the
+type of each event, then the attributes of each event. The events in a packet are
+created with dmz::EventModule::create_events and closed with
+dmz::EventModule::close_events so observers receive them in a single callback. Each
+encoded packet holds one event. When batch is false, packets hold a single event
+without a count. Both ends of a connection must use the same setting.
+
 */
 
 //! \cond
@@ -48,6 +56,10 @@ dmz::NetExtPacketCodecEventNative::NetExtPacketCodecEventNative (
       _time (Info),
       _defaultHandle (0),
       _lnvHandle (0),
+      _batch (False),
+      _descList (0),
+      _eventList (0),
+      _listSize (0),
       _eventMod (0),
       _attrMod (0),
       _adapterList (0) {
@@ -59,6 +71,8 @@ dmz::NetExtPacketCodecEventNative::NetExtPacketCodecEventNative (
 dmz::NetExtPacketCodecEventNative::~NetExtPacketCodecEventNative () {
 
    if (_adapterList) { delete _adapterList; _adapterList = 0; }
+   if (_descList) { delete []_descList; _descList = 0; }
+   if (_eventList) { delete []_eventList; _eventList = 0; }
 }
 
 
@@ -124,7 +138,8 @@ dmz::NetExtPacketCodecEventNative::decode (Unmarshal &data, Boolean &isLoopback)
 
    isLoopback = (uuid == _SysID);
 
-   if (!isLoopback && _eventMod) {
+   if (!isLoopback && _eventMod && _attrMod && _batch) { result = _decode_events (data); }
+   else if (!isLoopback && _eventMod) {
 
       const Int32 TypeSize (Int32 (data.get_next_int8 ()));
 
@@ -179,6 +194,8 @@ dmz::NetExtPacketCodecEventNative::encode_event (
 
       if (_attrMod->to_net_event_type (type, typeArray)) {
 
+         if (_batch) { data.set_next_uint16 (1); }
+
          const Int32 TypeSize (typeArray.get_size ());
          data.set_next_int8 (Int8 (TypeSize));
 
@@ -203,6 +220,72 @@ dmz::NetExtPacketCodecEventNative::encode_event (
 }
 
 
+// Reads a packet written in batch mode. Every event is created before the attributes
+// are read because the attributes of all the events follow the event types.
+dmz::Boolean
+dmz::NetExtPacketCodecEventNative::_decode_events (Unmarshal &data) {
+
+   const Int32 Count (Int32 (data.get_next_uint16 ()));
+
+   if (Count > _listSize) {
+
+      if (_descList) { delete []_descList; _descList = 0; }
+      if (_eventList) { delete []_eventList; _eventList = 0; }
+
+      _descList = new EventDescriptorStruct[Count];
+      _eventList = new Handle[Count];
+      _listSize = (_descList && _eventList) ? Count : 0;
+   }
+
+   Int32 eventCount (0);
+
+   if (Count <= _listSize) {
+
+      for (Int32 ix = 0; ix < Count; ix++) {
+
+         EventDescriptorStruct &desc (_descList[ix]);
+
+         desc = EventDescriptorStruct ();
+         desc.locality = EventRemote;
+
+         const Int32 TypeSize (Int32 (data.get_next_int8 ()));
+
+         ArrayUInt32 typeArray (TypeSize);
+
+         for (Int32 jy = 0; jy < TypeSize; jy++) {
+
+            typeArray.set (jy, UInt32 (data.get_next_uint8 ()));
+         }
+
+         _attrMod->to_internal_event_type (typeArray, desc.type);
+      }
+
+      _eventMod->create_events (_descList, Count);
+
+      for (Int32 ix = 0; ix < Count; ix++) {
+
+         const Handle EventHandle (_descList[ix].handle);
+
+         // The attributes of an event that was not created are still read so the
+         // attributes of the events that follow it are read from the correct place.
+         EventAttributeAdapter *current (_adapterList);
+
+         while (current) {
+
+            current->decode (EventHandle, data, *_eventMod);
+            current = current->next;
+         }
+
+         if (EventHandle) { _eventList[eventCount] = EventHandle; eventCount++; }
+      }
+
+      if (eventCount) { _eventMod->close_events (_eventList, eventCount); }
+   }
+
+   return eventCount > 0;
+}
+
+
 void
 dmz::NetExtPacketCodecEventNative::_init (Config &local) {
 
@@ -211,6 +294,8 @@ dmz::NetExtPacketCodecEventNative::_init (Config &local) {
 
    _defaultHandle = defs.create_named_handle (EventAttributeDefaultName);
 
+   _batch = config_to_boolean ("batch.value", local, _batch);
+
    Config adapters;
    EventAttributeAdapter *current (0);
 
@@ -71,6 +71,7 @@ namespace dmz {
             Marshal &data);
 
       protected:
+         Boolean _decode_events (Unmarshal &data);
          void _init (Config &local);
 
          const UUID _SysID;
@@ -80,6 +81,11 @@ namespace dmz {
          Handle _defaultHandle;
          Handle _lnvHandle;
 
+         Boolean _batch;
+         EventDescriptorStruct *_descList;
+         Handle *_eventList;
+         Int32 _listSize;
+
          EventModule *_eventMod;
          NetModuleAttributeMap *_attrMod;
          EventAttributeAdapter *_adapterList;
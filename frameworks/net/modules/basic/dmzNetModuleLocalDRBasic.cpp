@@ -613,7 +613,8 @@ dmz::NetModuleLocalDRBasic::NetModuleLocalDRBasic (
       _time (Info),
       _objMod (0),
       _debug (False),
-      _defaultHandle (0) {
+      _defaultHandle (0),
+      _RulePath ("net.rule") {
 
    _init (local);
 }
@@ -900,9 +901,7 @@ dmz::NetModuleLocalDRBasic::_create_test_from_type (const ObjectType &Type) {
 
          Config listData;
 
-         if (current.get_config ().lookup_all_config (
-               "net.rule",
-               listData)) {
+         if (_RulePath.lookup_all_config (current.get_config (), listData)) {
 
             _log.info << "Creating network transmission rules for: "
                << current.get_name () << endl;
@@ -2,6 +2,7 @@
 #define DMZ_NET_MODULE_LOCAL_DR_BASIC_DOT_H
 
 #include <dmzNetModuleLocalDR.h>
+#include <dmzRuntimeConfigPath.h>
 #include <dmzRuntimeLog.h>
 #include <dmzRuntimePlugin.h>
 #include <dmzRuntimeTime.h>
@@ -71,6 +72,7 @@ namespace dmz {
 
          Boolean _debug;
          UInt32 _defaultHandle;
+         const ConfigPath _RulePath;
          //! \endcond
 
       private:
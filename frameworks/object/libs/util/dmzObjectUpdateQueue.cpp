@@ -0,0 +1,292 @@
+#include <dmzObjectUpdateQueue.h>
+#include <dmzSystem.h>
+#include <dmzTypesHashTableHandleTemplate.h>
+
+/*!
+
+\class dmz::ObjectUpdateQueue
+\ingroup Object
+\brief Queues object updates and spreads them across frames.
+\details Objects are queued when they change and are updated once per frame by
+dmz::ObjectUpdateQueue::update. An object that changes again while it is queued is
+only updated once. Visible objects are always updated. The remaining objects are
+updated until the frame budget is used up and the rest stay queued for the following
+frames. The queue keeps counts of the applied, coalesced and deferred updates and of
+how long objects wait in the queue.
+
+*/
+
+/*!
+
+\class dmz::ObjectUpdateQueue::Updater
+\ingroup Object
+\brief Applies the updates of a dmz::ObjectUpdateQueue.
+
+*/
+
+namespace {
+
+// Number of deferrable updates applied between checks of the update budget.
+static const dmz::Int32 BudgetCheckInterval = 64;
+
+struct QueueStruct {
+
+   dmz::Float64 queueTime;
+   QueueStruct *next;
+
+   QueueStruct () : queueTime (0.0), next (0) {;}
+   ~QueueStruct () { if (next) { delete next; next = 0; } }
+};
+
+};
+
+
+struct dmz::ObjectUpdateQueue::State {
+
+   Float64 budget;
+   HashTableHandleTemplate<QueueStruct> table;
+   QueueStruct *freeList;
+   UInt64 updateCount;
+   UInt64 coalescedCount;
+   UInt64 deferredCount;
+   Float64 lagTotal;
+   Float64 lagMax;
+
+   State () :
+         budget (0.01),
+         freeList (0),
+         updateCount (0),
+         coalescedCount (0),
+         deferredCount (0),
+         lagTotal (0.0),
+         lagMax (0.0) {;}
+
+   ~State () {
+
+      table.empty ();
+      if (freeList) { delete freeList; freeList = 0; }
+   }
+
+   void release (QueueStruct *qs) { qs->next = freeList; freeList = qs; }
+
+   void apply (
+         const Handle ObjectHandle,
+         const Float64 Time,
+         Updater &updater) {
+
+      QueueStruct *qs (table.remove (ObjectHandle));
+
+      if (qs) {
+
+         const Float64 Lag (Time - qs->queueTime);
+
+         updateCount++;
+         lagTotal += Lag;
+         if (Lag > lagMax) { lagMax = Lag; }
+
+         release (qs);
+      }
+
+      updater.apply_update (ObjectHandle);
+   }
+};
+
+
+//! Constructor.
+dmz::ObjectUpdateQueue::ObjectUpdateQueue () : _state (*(new State)) {;}
+
+
+//! Destructor.
+dmz::ObjectUpdateQueue::~ObjectUpdateQueue () { delete &_state; }
+
+
+/*!
+
+\brief Sets the time spent on deferrable updates each frame.
+\param[in] Value Budget in seconds. Zero updates every queued object each frame.
+Defaults to 0.01.
+
+*/
+void
+dmz::ObjectUpdateQueue::set_budget (const Float64 Value) {
+
+   _state.budget = Value > 0.0 ? Value : 0.0;
+}
+
+
+//! Returns the time spent on deferrable updates each frame.
+dmz::Float64
+dmz::ObjectUpdateQueue::get_budget () const { return _state.budget; }
+
+
+/*!
+
+\brief Queues an object to be updated.
+\param[in] ObjectHandle Handle of the object.
+\param[in] Time Time the object changed.
+\return Returns dmz::True if the object was added to the queue. Returns dmz::False if
+the object was already queued. The change is then counted as coalesced.
+
+*/
+dmz::Boolean
+dmz::ObjectUpdateQueue::queue_object (const Handle ObjectHandle, const Float64 Time) {
+
+   Boolean result (False);
+
+   if (_state.table.lookup (ObjectHandle)) { _state.coalescedCount++; }
+   else if (ObjectHandle) {
+
+      QueueStruct *qs (_state.freeList);
+
+      if (qs) { _state.freeList = qs->next; qs->next = 0; }
+      else { qs = new QueueStruct; }
+
+      qs->queueTime = Time;
+
+      if (_state.table.store (ObjectHandle, qs)) { result = True; }
+      else { _state.release (qs); }
+   }
+
+   return result;
+}
+
+
+/*!
+
+\brief Removes an object from the queue without updating it.
+\param[in] ObjectHandle Handle of the object.
+\return Returns dmz::True if the object was queued.
+
+*/
+dmz::Boolean
+dmz::ObjectUpdateQueue::remove_object (const Handle ObjectHandle) {
+
+   QueueStruct *qs (_state.table.remove (ObjectHandle));
+
+   if (qs) { _state.release (qs); }
+
+   return qs != 0;
+}
+
+
+//! Returns dmz::True if the object is queued.
+dmz::Boolean
+dmz::ObjectUpdateQueue::is_queued (const Handle ObjectHandle) const {
+
+   return _state.table.lookup (ObjectHandle) != 0;
+}
+
+
+//! Returns the number of queued objects.
+dmz::Int32
+dmz::ObjectUpdateQueue::get_count () const { return _state.table.get_count (); }
+
+
+//! Removes every object from the queue without updating them.
+void
+dmz::ObjectUpdateQueue::clear () {
+
+   HashTableHandleIterator it;
+   QueueStruct *qs (0);
+
+   while (_state.table.get_next (it, qs)) { _state.release (qs); }
+
+   _state.table.clear ();
+}
+
+
+/*!
+
+\brief Updates the queued objects.
+\details Every queued object that dmz::ObjectUpdateQueue::Updater::is_update_visible
+accepts is updated first. The remaining objects are updated in the order they were
+queued until the budget is used up. Objects that are not updated stay queued and are
+counted as deferred.
+\param[in] Time Current time. The time each updated object waited in the queue is
+measured from the time it was queued.
+\param[in] updater Updater used to test and apply the updates.
+\return Returns the number of objects updated.
+
+*/
+dmz::Int32
+dmz::ObjectUpdateQueue::update (const Float64 Time, Updater &updater) {
+
+   Int32 result (0);
+
+   if (_state.table.get_count ()) {
+
+      const Float64 StartTime (get_time ());
+
+      HashTableHandleIterator it;
+      QueueStruct *qs (0);
+
+      while (_state.table.get_next (it, qs)) {
+
+         const Handle ObjectHandle (it.get_hash_key ());
+
+         if (updater.is_update_visible (ObjectHandle)) {
+
+            _state.apply (ObjectHandle, Time, updater);
+            result++;
+         }
+      }
+
+      Int32 count (0);
+      Boolean done (False);
+      it.reset ();
+
+      while (!done && _state.table.get_next (it, qs)) {
+
+         _state.apply (it.get_hash_key (), Time, updater);
+         count++;
+
+         if ((_state.budget > 0.0) && !(count % BudgetCheckInterval) &&
+               ((get_time () - StartTime) >= _state.budget)) { done = True; }
+      }
+
+      result += count;
+      _state.deferredCount += UInt64 (_state.table.get_count ());
+   }
+
+   return result;
+}
+
+
+//! Returns the number of updates applied.
+dmz::UInt64
+dmz::ObjectUpdateQueue::get_update_count () const { return _state.updateCount; }
+
+
+//! Returns the number of changes to objects that were already queued.
+dmz::UInt64
+dmz::ObjectUpdateQueue::get_coalesced_count () const { return _state.coalescedCount; }
+
+
+//! Returns the number of times an object was left in the queue at the end of a frame.
+dmz::UInt64
+dmz::ObjectUpdateQueue::get_deferred_count () const { return _state.deferredCount; }
+
+
+//! Returns the average time in seconds an updated object waited in the queue.
+dmz::Float64
+dmz::ObjectUpdateQueue::get_average_lag () const {
+
+   return _state.updateCount ? _state.lagTotal / Float64 (_state.updateCount) : 0.0;
+}
+
+
+//! Returns the longest time in seconds an updated object waited in the queue.
+dmz::Float64
+dmz::ObjectUpdateQueue::get_max_lag () const { return _state.lagMax; }
+
+
+//! Resets the update, coalesced and deferred counts and the lag statistics.
+void
+dmz::ObjectUpdateQueue::reset_counters () {
+
+   _state.updateCount = 0;
+   _state.coalescedCount = 0;
+   _state.deferredCount = 0;
+   _state.lagTotal = 0.0;
+   _state.lagMax = 0.0;
+}
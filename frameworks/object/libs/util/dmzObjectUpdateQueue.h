@@ -0,0 +1,57 @@
+#ifndef DMZ_OBJECT_UPDATE_QUEUE_DOT_H
+#define DMZ_OBJECT_UPDATE_QUEUE_DOT_H
+
+#include <dmzObjectUtilExport.h>
+#include <dmzTypesBase.h>
+
+namespace dmz {
+
+   class DMZ_OBJECT_UTIL_LINK_SYMBOL ObjectUpdateQueue {
+
+      public:
+         class Updater {
+
+            public:
+               //! Returns dmz::True if the object is visible and may not be deferred.
+               virtual Boolean is_update_visible (const Handle ObjectHandle) = 0;
+
+               //! Applies the queued changes of the object.
+               virtual void apply_update (const Handle ObjectHandle) = 0;
+
+            protected:
+               Updater () {;}
+               ~Updater () {;}
+         };
+
+         ObjectUpdateQueue ();
+         ~ObjectUpdateQueue ();
+
+         void set_budget (const Float64 Value);
+         Float64 get_budget () const;
+
+         Boolean queue_object (const Handle ObjectHandle, const Float64 Time);
+         Boolean remove_object (const Handle ObjectHandle);
+         Boolean is_queued (const Handle ObjectHandle) const;
+         Int32 get_count () const;
+         void clear ();
+
+         Int32 update (const Float64 Time, Updater &updater);
+
+         UInt64 get_update_count () const;
+         UInt64 get_coalesced_count () const;
+         UInt64 get_deferred_count () const;
+         Float64 get_average_lag () const;
+         Float64 get_max_lag () const;
+         void reset_counters ();
+
+      protected:
+         struct State;
+         State &_state; //!< Internal state.
+
+      private:
+         ObjectUpdateQueue (const ObjectUpdateQueue &);
+         ObjectUpdateQueue &operator= (const ObjectUpdateQueue &);
+   };
+};
+
+#endif // DMZ_OBJECT_UPDATE_QUEUE_DOT_H
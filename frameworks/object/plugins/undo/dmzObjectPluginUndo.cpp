@@ -28,6 +28,12 @@ local_uuid_to_handle (
    return module.lookup_handle_from_uuid (uuid);
 }
 
+static inline UInt64
+local_coalesce_key (const Handle ObjectHandle, const Handle AttrHandle) {
+
+   return (UInt64 (ObjectHandle) << 32) | UInt64 (AttrHandle);
+}
+
 static inline Handle
 local_attr_name_to_handle (
       const Data &InData,
@@ -47,6 +53,8 @@ local_attr_name_to_handle (
 \class dmz::ObjectPluginUndo
 \ingroup Object
 \brief Records changes to objects in the ObjectModule to the runtime undo.
+\details Consecutive updates to the same object attribute within a single undo record
+are coalesced so that only the value prior to the first update is stored.
 
 */
 
@@ -695,7 +703,7 @@ dmz::ObjectPluginUndo::update_object_counter (
          data.store_string (_handleHandle, 0, AttrName);
          data.store_int64 (_valueHandle, 0, CounterValue);
 
-         _undo.store_action (_storeCounter, get_plugin_handle (), &data);
+         _store_attribute_action (_storeCounter, ObjectHandle, AttributeHandle, data);
       }
    }
 }
@@ -725,7 +733,7 @@ dmz::ObjectPluginUndo::update_object_counter_minimum (
          data.store_string (_handleHandle, 0, AttrName);
          data.store_int64 (_valueHandle, 0, CounterValue);
 
-         _undo.store_action (_storeCounterMin, get_plugin_handle (), &data);
+         _store_attribute_action (_storeCounterMin, ObjectHandle, AttributeHandle, data);
       }
    }
 }
@@ -755,7 +763,7 @@ dmz::ObjectPluginUndo::update_object_counter_maximum (
          data.store_string (_handleHandle, 0, AttrName);
          data.store_int64 (_valueHandle, 0, CounterValue);
 
-         _undo.store_action (_storeCounterMax, get_plugin_handle (), &data);
+         _store_attribute_action (_storeCounterMax, ObjectHandle, AttributeHandle, data);
       }
    }
 
@@ -786,7 +794,7 @@ dmz::ObjectPluginUndo::update_object_alternate_type (
          data.store_string (_handleHandle, 0, AttrName);
          data.store_string (_valueHandle, 0, TypeName);
 
-         _undo.store_action (_storeType, get_plugin_handle (), &data);
+         _store_attribute_action (_storeType, ObjectHandle, AttributeHandle, data);
       }
    }
 }
@@ -816,7 +824,7 @@ dmz::ObjectPluginUndo::update_object_state (
          data.store_string (_handleHandle, 0, AttrName);
          data.store_mask (_valueHandle, MaskValue);
 
-         _undo.store_action (_storeState, get_plugin_handle (), &data);
+         _store_attribute_action (_storeState, ObjectHandle, AttributeHandle, data);
       }
    }
 }
@@ -846,7 +854,7 @@ dmz::ObjectPluginUndo::update_object_flag (
          data.store_string (_handleHandle, 0, AttrName);
          data.store_int32 (_valueHandle, 0, FlagValue);
 
-         _undo.store_action (_storeFlag, get_plugin_handle (), &data);
+         _store_attribute_action (_storeFlag, ObjectHandle, AttributeHandle, data);
       }
    }
 }
@@ -876,7 +884,7 @@ dmz::ObjectPluginUndo::update_object_time_stamp (
          data.store_string (_handleHandle, 0, AttrName);
          data.store_float64 (_valueHandle, 0, TSValue);
 
-         _undo.store_action (_storeTimeStamp, get_plugin_handle (), &data);
+         _store_attribute_action (_storeTimeStamp, ObjectHandle, AttributeHandle, data);
       }
    }
 }
@@ -906,7 +914,7 @@ dmz::ObjectPluginUndo::update_object_position (
          data.store_string (_handleHandle, 0, AttrName);
          data.store_vector (_valueHandle, 0, VecValue);
 
-         _undo.store_action (_storePosition, get_plugin_handle (), &data);
+         _store_attribute_action (_storePosition, ObjectHandle, AttributeHandle, data);
       }
    }
 }
@@ -936,7 +944,7 @@ dmz::ObjectPluginUndo::update_object_orientation (
          data.store_string (_handleHandle, 0, AttrName);
          data.store_matrix (_valueHandle, 0, MatValue);
 
-         _undo.store_action (_storeOrientation, get_plugin_handle (), &data);
+         _store_attribute_action (_storeOrientation, ObjectHandle, AttributeHandle, data);
       }
    }
 }
@@ -966,7 +974,7 @@ dmz::ObjectPluginUndo::update_object_velocity (
          data.store_string (_handleHandle, 0, AttrName);
          data.store_vector (_valueHandle, 0, VelValue);
 
-         _undo.store_action (_storeVelocity, get_plugin_handle (), &data);
+         _store_attribute_action (_storeVelocity, ObjectHandle, AttributeHandle, data);
       }
    }
 }
@@ -996,7 +1004,7 @@ dmz::ObjectPluginUndo::update_object_acceleration (
          data.store_string (_handleHandle, 0, AttrName);
          data.store_vector (_valueHandle, 0, AccelValue);
 
-         _undo.store_action (_storeAcceleration, get_plugin_handle (), &data);
+         _store_attribute_action (_storeAcceleration, ObjectHandle, AttributeHandle, data);
       }
    }
 }
@@ -1026,7 +1034,7 @@ dmz::ObjectPluginUndo::update_object_scale (
          data.store_string (_handleHandle, 0, AttrName);
          data.store_vector (_valueHandle, 0, ScaleValue);
 
-         _undo.store_action (_storeScale, get_plugin_handle (), &data);
+         _store_attribute_action (_storeScale, ObjectHandle, AttributeHandle, data);
       }
    }
 }
@@ -1056,7 +1064,7 @@ dmz::ObjectPluginUndo::update_object_vector (
          data.store_string (_handleHandle, 0, AttrName);
          data.store_vector (_valueHandle, 0, VecValue);
 
-         _undo.store_action (_storeVector, get_plugin_handle (), &data);
+         _store_attribute_action (_storeVector, ObjectHandle, AttributeHandle, data);
       }
    }
 }
@@ -1086,7 +1094,7 @@ dmz::ObjectPluginUndo::update_object_scalar (
          data.store_string (_handleHandle, 0, AttrName);
          data.store_float64 (_valueHandle, 0, ScalarValue);
 
-         _undo.store_action (_storeScalar, get_plugin_handle (), &data);
+         _store_attribute_action (_storeScalar, ObjectHandle, AttributeHandle, data);
       }
    }
 }
@@ -1116,7 +1124,7 @@ dmz::ObjectPluginUndo::update_object_text (
          data.store_string (_handleHandle, 0, AttrName);
          data.store_string (_valueHandle, 0, StrValue);
 
-         _undo.store_action (_storeText, get_plugin_handle (), &data);
+         _store_attribute_action (_storeText, ObjectHandle, AttributeHandle, data);
       }
    }
 }
@@ -1148,7 +1156,7 @@ dmz::ObjectPluginUndo::update_object_data (
          data.store_string (_handleHandle, 0, AttrName);
          data.store_string (_valueHandle, 0, StrValue);
 
-         _undo.store_action (_storeData, get_plugin_handle (), &data);
+         _store_attribute_action (_storeData, ObjectHandle, AttributeHandle, data);
       }
    }
 }
@@ -1174,6 +1182,20 @@ dmz::ObjectPluginUndo::update_current_undo_names (
 }
 
 
+void
+dmz::ObjectPluginUndo::_store_attribute_action (
+      const Message &Type,
+      const Handle ObjectHandle,
+      const Handle AttrHandle,
+      const Data &UndoData) {
+
+   // Attribute values dumped from a destroyed object are never coalesced.
+   const UInt64 Key (_inDump ? 0 : local_coalesce_key (ObjectHandle, AttrHandle));
+
+   _undo.store_coalesced_action (Type, get_plugin_handle (), Key, &UndoData);
+}
+
+
 void
 dmz::ObjectPluginUndo::_remove_attribute (
       const UUID &Identity,
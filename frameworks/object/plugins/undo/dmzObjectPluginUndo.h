@@ -215,6 +215,12 @@ namespace dmz {
             const String *NextRedoName);
 
       protected:
+         void _store_attribute_action (
+            const Message &Type,
+            const Handle ObjectHandle,
+            const Handle AttrHandle,
+            const Data &UndoData);
+
          void _remove_attribute (
             const UUID &Identity,
             const Handle AttrHandle,
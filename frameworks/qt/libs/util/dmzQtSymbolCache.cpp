@@ -0,0 +1,344 @@
+#include <dmzQtSymbolCache.h>
+#include <dmzTypesHashTableStringTemplate.h>
+#include <dmzTypesString.h>
+#include <QtGui/QPainter>
+#include <QtSvg/QSvgRenderer>
+
+#include <math.h>
+
+namespace {
+
+static const dmz::Int32 MinBucket = -16;
+static const dmz::Int32 MaxBucket = 16;
+static const int MaxImageSide = 4096;
+static const dmz::Int64 DefaultMaxImageBytes = 64 * 1024 * 1024;
+
+struct FileStruct {
+
+   QSvgRenderer *renderer;
+   QPixmap pixmap;
+   dmz::Boolean svgLoaded;
+   dmz::Boolean pixmapLoaded;
+
+   FileStruct () : renderer (0), svgLoaded (dmz::False), pixmapLoaded (dmz::False) {;}
+   ~FileStruct () { if (renderer) { delete renderer; renderer = 0; } }
+};
+
+struct ImageStruct {
+
+   const QImage Image;
+   const dmz::Int64 Bytes;
+
+   ImageStruct (const QImage &TheImage) :
+         Image (TheImage),
+         Bytes (dmz::Int64 (TheImage.bytesPerLine ()) * TheImage.height ()) {;}
+};
+
+};
+
+
+/*!
+
+\class dmz::QtSymbolCache
+\ingroup Qt
+\brief Shares symbol images between canvas items.
+\details Each file is loaded once. SVG files share a single QSvgRenderer and are
+rasterized into a QImage for each scale bucket so that items showing the same symbol
+at a similar scale draw the same image. Scale buckets are half powers of two and
+symbols are rasterized at the upper end of their bucket so they are never enlarged
+when drawn. Images are used instead of pixmaps so symbols may be rasterized without
+a display. When the rasterized images exceed the image byte limit they are all
+released and rasterized again as they are requested.
+
+*/
+
+struct dmz::QtSymbolCache::State {
+
+   HashTableStringTemplate<FileStruct> fileTable;
+   HashTableStringTemplate<ImageStruct> imageTable;
+   Int64 maxImageBytes;
+   Int64 imageBytes;
+   Int64 pixmapBytes;
+   UInt64 hits;
+   UInt64 misses;
+
+   State () :
+         maxImageBytes (DefaultMaxImageBytes),
+         imageBytes (0),
+         pixmapBytes (0),
+         hits (0),
+         misses (0) {;}
+
+   ~State () { clear (); }
+
+   void clear_images () {
+
+      imageTable.empty ();
+      imageBytes = 0;
+   }
+
+   void clear () {
+
+      clear_images ();
+      fileTable.empty ();
+      pixmapBytes = 0;
+   }
+
+   FileStruct *get_file (const String &FileName) {
+
+      FileStruct *fs (fileTable.lookup (FileName));
+
+      if (!fs && FileName) {
+
+         fs = new FileStruct;
+
+         if (!fileTable.store (FileName, fs)) { delete fs; fs = 0; }
+      }
+
+      return fs;
+   }
+
+   QSvgRenderer *get_renderer (const String &FileName) {
+
+      FileStruct *fs (get_file (FileName));
+
+      if (fs && !fs->svgLoaded) {
+
+         fs->svgLoaded = True;
+         fs->renderer = new QSvgRenderer;
+
+         if (!fs->renderer->load (QString (FileName.get_buffer ()))) {
+
+            delete fs->renderer; fs->renderer = 0;
+         }
+      }
+
+      return fs ? fs->renderer : 0;
+   }
+};
+
+
+//! Constructor.
+dmz::QtSymbolCache::QtSymbolCache () : _state (*(new State)) {;}
+
+
+//! Destructor.
+dmz::QtSymbolCache::~QtSymbolCache () { delete &_state; }
+
+
+//! Sets the number of bytes the rasterized symbol images may use.
+void
+dmz::QtSymbolCache::set_max_image_bytes (const Int64 Bytes) {
+
+   _state.maxImageBytes = Bytes;
+
+   if (_state.imageBytes > _state.maxImageBytes) { _state.clear_images (); }
+}
+
+
+//! Returns the number of bytes the rasterized symbol images may use.
+dmz::Int64
+dmz::QtSymbolCache::get_max_image_bytes () const { return _state.maxImageBytes; }
+
+
+/*!
+
+\brief Releases all renderers, pixmaps, and images.
+\note Renderers returned by dmz::QtSymbolCache::lookup_renderer are deleted so
+items using them must be deleted first.
+
+*/
+void
+dmz::QtSymbolCache::clear () { _state.clear (); }
+
+
+/*!
+
+\brief Returns the shared renderer of an SVG file.
+\param[in] FileName Name of the SVG file.
+\return Returns a pointer to the renderer. Returns NULL if the file could not be
+loaded. The renderer is owned by the cache.
+
+*/
+QSvgRenderer *
+dmz::QtSymbolCache::lookup_renderer (const String &FileName) {
+
+   FileStruct *fs (_state.fileTable.lookup (FileName));
+
+   if (fs && fs->svgLoaded) { _state.hits++; }
+   else { _state.misses++; }
+
+   return _state.get_renderer (FileName);
+}
+
+
+/*!
+
+\brief Returns the shared pixmap of an image file.
+\param[in] FileName Name of the image file.
+\return Returns the pixmap. The pixmap is null if the file could not be loaded.
+
+*/
+QPixmap
+dmz::QtSymbolCache::lookup_pixmap (const String &FileName) {
+
+   QPixmap result;
+
+   FileStruct *fs (_state.get_file (FileName));
+
+   if (fs) {
+
+      if (fs->pixmapLoaded) { _state.hits++; }
+      else {
+
+         _state.misses++;
+         fs->pixmapLoaded = True;
+
+         if (fs->pixmap.load (QString (FileName.get_buffer ()))) {
+
+            _state.pixmapBytes += (Int64 (fs->pixmap.width ()) *
+               Int64 (fs->pixmap.height ()) * Int64 (fs->pixmap.depth ())) / 8;
+         }
+      }
+
+      result = fs->pixmap;
+   }
+
+   return result;
+}
+
+
+//! Returns the default size of an SVG file. The size is empty if it can not be loaded.
+QSizeF
+dmz::QtSymbolCache::get_symbol_size (const String &FileName) {
+
+   QSizeF result;
+
+   QSvgRenderer *renderer (_state.get_renderer (FileName));
+
+   if (renderer) { result = renderer->defaultSize (); }
+
+   return result;
+}
+
+
+/*!
+
+\brief Returns an SVG file rasterized for a scale.
+\param[in] FileName Name of the SVG file.
+\param[in] Scale Scale the symbol is drawn at. A scale of one draws the symbol at
+its default size.
+\return Returns the rasterized image. The image is null if the file could not be
+loaded.
+
+*/
+QImage
+dmz::QtSymbolCache::lookup_symbol (const String &FileName, const Float64 Scale) {
+
+   QImage result;
+
+   const Int32 Bucket (get_scale_bucket (Scale));
+
+   String key (FileName);
+   key << "#" << Bucket;
+
+   ImageStruct *is (_state.imageTable.lookup (key));
+
+   if (is) { _state.hits++; result = is->Image; }
+   else {
+
+      QSvgRenderer *renderer (_state.get_renderer (FileName));
+
+      if (renderer) {
+
+         _state.misses++;
+
+         const Float64 BucketScale (get_bucket_scale (Bucket));
+         const QSize Default (renderer->defaultSize ());
+
+         const int Width (
+            qBound (1, int (ceil (Default.width () * BucketScale)), MaxImageSide));
+
+         const int Height (
+            qBound (1, int (ceil (Default.height () * BucketScale)), MaxImageSide));
+
+         QImage image (Width, Height, QImage::Format_ARGB32_Premultiplied);
+         image.fill (0);
+
+         QPainter painter (&image);
+         painter.setRenderHint (QPainter::Antialiasing, true);
+         painter.setRenderHint (QPainter::SmoothPixmapTransform, true);
+         renderer->render (&painter, QRectF (0.0, 0.0, Width, Height));
+         painter.end ();
+
+         is = new ImageStruct (image);
+
+         if ((_state.imageBytes + is->Bytes) > _state.maxImageBytes) {
+
+            _state.clear_images ();
+         }
+
+         if (_state.imageTable.store (key, is)) { _state.imageBytes += is->Bytes; }
+         else { delete is; is = 0; }
+
+         result = image;
+      }
+   }
+
+   return result;
+}
+
+
+//! Returns the number of lookups that were answered from the cache.
+dmz::UInt64
+dmz::QtSymbolCache::get_hit_count () const { return _state.hits; }
+
+
+//! Returns the number of lookups that had to load or rasterize a file.
+dmz::UInt64
+dmz::QtSymbolCache::get_miss_count () const { return _state.misses; }
+
+
+//! Returns the number of bytes used by the cached pixmaps and images.
+dmz::Int64
+dmz::QtSymbolCache::get_byte_count () const {
+
+   return _state.imageBytes + _state.pixmapBytes;
+}
+
+
+//! Returns the number of cached rasterized symbol images.
+dmz::Int32
+dmz::QtSymbolCache::get_image_count () const { return _state.imageTable.get_count (); }
+
+
+//! Resets the hit and miss counts.
+void
+dmz::QtSymbolCache::reset_counts () { _state.hits = _state.misses = 0; }
+
+
+//! Returns the scale bucket of a scale.
+dmz::Int32
+dmz::QtSymbolCache::get_scale_bucket (const Float64 Scale) {
+
+   Int32 result (0);
+
+   if (Scale > 0.0) {
+
+      const Float64 Value (ceil ((log (Scale) / log (2.0)) * 2.0));
+
+      if (Value < Float64 (MinBucket)) { result = MinBucket; }
+      else if (Value > Float64 (MaxBucket)) { result = MaxBucket; }
+      else { result = Int32 (Value); }
+   }
+
+   return result;
+}
+
+
+//! Returns the scale symbols in a scale bucket are rasterized at.
+dmz::Float64
+dmz::QtSymbolCache::get_bucket_scale (const Int32 Bucket) {
+
+   return pow (2.0, Float64 (Bucket) * 0.5);
+}
@@ -0,0 +1,52 @@
+#ifndef DMZ_QT_SYMBOL_CACHE_DOT_H
+#define DMZ_QT_SYMBOL_CACHE_DOT_H
+
+#include <dmzQtUtilExport.h>
+#include <dmzTypesBase.h>
+#include <QtCore/QSizeF>
+#include <QtGui/QImage>
+#include <QtGui/QPixmap>
+
+class QSvgRenderer;
+
+namespace dmz {
+
+   class String;
+
+   class DMZ_QT_UTIL_LINK_SYMBOL QtSymbolCache {
+
+      public:
+         QtSymbolCache ();
+         ~QtSymbolCache ();
+
+         void set_max_image_bytes (const Int64 Bytes);
+         Int64 get_max_image_bytes () const;
+
+         void clear ();
+
+         QSvgRenderer *lookup_renderer (const String &FileName);
+         QPixmap lookup_pixmap (const String &FileName);
+
+         QSizeF get_symbol_size (const String &FileName);
+         QImage lookup_symbol (const String &FileName, const Float64 Scale);
+
+         UInt64 get_hit_count () const;
+         UInt64 get_miss_count () const;
+         Int64 get_byte_count () const;
+         Int32 get_image_count () const;
+         void reset_counts ();
+
+         static Int32 get_scale_bucket (const Float64 Scale);
+         static Float64 get_bucket_scale (const Int32 Bucket);
+
+      protected:
+         struct State;
+         State &_state; //!< Internal state.
+
+      private:
+         QtSymbolCache (const QtSymbolCache &);
+         QtSymbolCache &operator= (const QtSymbolCache &);
+   };
+};
+
+#endif // DMZ_QT_SYMBOL_CACHE_DOT_H
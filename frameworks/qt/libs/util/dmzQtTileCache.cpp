@@ -0,0 +1,710 @@
+#include <dmzQtTileCache.h>
+#include <dmzTypesHashTableStringTemplate.h>
+#include <dmzTypesHashTableUInt64.h>
+#include <dmzTypesString.h>
+#include <QtCore/QByteArray>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+
+#include <stdlib.h>
+
+namespace {
+
+static const dmz::Int64 DefaultMaxDiskBytes = 256 * 1024 * 1024;
+static const dmz::Float64 DefaultPrefetchTime = 1.0;
+static const dmz::Int32 DefaultPrefetchMargin = 1;
+static const dmz::Int32 MaxTileZoom = 29;
+static const dmz::Int32 MaxRequested = 65536;
+
+// Tiles at the next and previous zoom levels are fetched after every tile at the
+// current level.
+static const dmz::Float64 ZoomPriority = 1.0e6;
+
+struct FileStruct {
+
+   const dmz::String Name;
+   dmz::Int64 bytes;
+   dmz::UInt32 scan;
+   FileStruct *next;
+   FileStruct *prev;
+
+   FileStruct (const dmz::String &TheName) :
+         Name (TheName),
+         bytes (0),
+         scan (0),
+         next (0),
+         prev (0) {;}
+};
+
+struct TileStruct {
+
+   dmz::Int32 zoom;
+   dmz::Int32 x;
+   dmz::Int32 y;
+   dmz::Float64 priority;
+};
+
+
+static inline dmz::UInt64
+local_tile_key (const dmz::Int32 Zoom, const dmz::Int32 X, const dmz::Int32 Y) {
+
+   return (dmz::UInt64 (Zoom) << 58) | (dmz::UInt64 (X) << 29) | dmz::UInt64 (Y);
+}
+
+
+static inline dmz::Int32
+local_clamp (const dmz::Int32 Value, const dmz::Int32 Min, const dmz::Int32 Max) {
+
+   return Value < Min ? Min : (Value > Max ? Max : Value);
+}
+
+
+static int
+local_compare (const void *Value1, const void *Value2) {
+
+   const TileStruct *Tile1 ((const TileStruct *)Value1);
+   const TileStruct *Tile2 ((const TileStruct *)Value2);
+
+   return Tile1->priority < Tile2->priority ? -1 :
+      (Tile1->priority > Tile2->priority ? 1 : 0);
+}
+
+};
+
+
+/*!
+
+\class dmz::QtTileCache
+\ingroup Qt
+\brief Size bounded disk store and prefetch planner for map tiles.
+\details Tiles are stored as files in a single directory. The directory is kept
+under a byte limit by removing the least recently used tiles. Tiles written to the
+directory by other code, such as a tile loader with its own persistent cache, are
+found by dmz::QtTileCache::rescan and ordered by their modification time.
+\n\n
+dmz::QtTileCache::plan_prefetch orders the tiles around a view so that the tiles the
+view is moving towards are fetched first, followed by the tiles at the previous and
+next zoom levels. Tiles are only returned by dmz::QtTileCache::get_next_prefetch once
+until dmz::QtTileCache::clear_prefetch is called.
+
+*/
+
+struct dmz::QtTileCache::State {
+
+   String directory;
+   Int64 maxBytes;
+   Int64 bytes;
+   HashTableStringTemplate<FileStruct> fileTable;
+   FileStruct *head;
+   FileStruct *tail;
+   UInt32 scan;
+   Float64 prefetchTime;
+   Int32 prefetchMargin;
+   HashTableUInt64 requestedTable;
+   TileStruct *queue;
+   Int32 queueSize;
+   Int32 queueCount;
+   Int32 queueNext;
+   UInt64 hits;
+   UInt64 misses;
+   UInt64 evicts;
+
+   State () :
+         maxBytes (DefaultMaxDiskBytes),
+         bytes (0),
+         head (0),
+         tail (0),
+         scan (0),
+         prefetchTime (DefaultPrefetchTime),
+         prefetchMargin (DefaultPrefetchMargin),
+         queue (0),
+         queueSize (0),
+         queueCount (0),
+         queueNext (0),
+         hits (0),
+         misses (0),
+         evicts (0) {;}
+
+   ~State () {
+
+      head = tail = 0;
+      fileTable.empty ();
+      if (queue) { delete []queue; queue = 0; }
+   }
+
+   String get_path (const String &Name) const { return directory + "/" + Name; }
+
+   void unlink (FileStruct &fs) {
+
+      if (fs.prev) { fs.prev->next = fs.next; }
+      else if (head == &fs) { head = fs.next; }
+
+      if (fs.next) { fs.next->prev = fs.prev; }
+      else if (tail == &fs) { tail = fs.prev; }
+
+      fs.next = fs.prev = 0;
+   }
+
+   void touch (FileStruct &fs) {
+
+      if (head != &fs) {
+
+         unlink (fs);
+
+         fs.next = head;
+         if (head) { head->prev = &fs; }
+         head = &fs;
+         if (!tail) { tail = &fs; }
+      }
+   }
+
+   FileStruct *get_file (const String &Name) {
+
+      FileStruct *fs (fileTable.lookup (Name));
+
+      if (!fs) {
+
+         fs = new FileStruct (Name);
+
+         if (fileTable.store (Name, fs)) { touch (*fs); }
+         else { delete fs; fs = 0; }
+      }
+
+      return fs;
+   }
+
+   void remove_file (FileStruct *fs) {
+
+      if (fs) {
+
+         unlink (*fs);
+         bytes -= fs->bytes;
+
+         if (fileTable.remove (fs->Name)) { delete fs; fs = 0; }
+      }
+   }
+
+   void add_tile (
+         const Int32 Zoom,
+         const Int32 X,
+         const Int32 Y,
+         const Float64 Priority) {
+
+      if (!requestedTable.lookup (local_tile_key (Zoom, X, Y))) {
+
+         if (queueCount >= queueSize) {
+
+            const Int32 Size (queueSize ? queueSize * 2 : 64);
+
+            TileStruct *list (new TileStruct[Size]);
+
+            for (Int32 ix = 0; ix < queueCount; ix++) { list[ix] = queue[ix]; }
+
+            if (queue) { delete []queue; }
+            queue = list;
+            queueSize = Size;
+         }
+
+         TileStruct &tile (queue[queueCount]);
+         tile.zoom = Zoom;
+         tile.x = X;
+         tile.y = Y;
+         tile.priority = Priority;
+         queueCount++;
+      }
+   }
+
+   void request_tile (const Int32 Zoom, const Int32 X, const Int32 Y) {
+
+      if (requestedTable.get_count () >= MaxRequested) { requestedTable.clear (); }
+
+      requestedTable.store (local_tile_key (Zoom, X, Y), (void *)this);
+   }
+};
+
+
+//! Constructor.
+dmz::QtTileCache::QtTileCache () : _state (*(new State)) {;}
+
+
+//! Destructor.
+dmz::QtTileCache::~QtTileCache () { delete &_state; }
+
+
+/*!
+
+\brief Sets the directory the tiles are stored in.
+\details The directory is created if it does not exist. Tiles already in the
+directory are added to the cache by dmz::QtTileCache::rescan.
+\param[in] Path Path of the directory.
+\return Returns dmz::True if the directory exists.
+
+*/
+dmz::Boolean
+dmz::QtTileCache::set_directory (const String &Path) {
+
+   _state.head = _state.tail = 0;
+   _state.fileTable.empty ();
+   _state.bytes = 0;
+   _state.directory = Path;
+
+   Boolean result (False);
+
+   if (Path) {
+
+      QDir dir;
+      result = dir.mkpath (Path.get_buffer ());
+   }
+
+   if (result) { rescan (); }
+
+   return result;
+}
+
+
+//! Returns the directory the tiles are stored in.
+dmz::String
+dmz::QtTileCache::get_directory () const { return _state.directory; }
+
+
+//! Sets the number of bytes the stored tiles may use. Zero disables the limit.
+void
+dmz::QtTileCache::set_max_disk_bytes (const Int64 Bytes) {
+
+   _state.maxBytes = Bytes;
+   trim ();
+}
+
+
+//! Returns the number of bytes the stored tiles may use.
+dmz::Int64
+dmz::QtTileCache::get_max_disk_bytes () const { return _state.maxBytes; }
+
+
+//! Returns the number of bytes used by the stored tiles.
+dmz::Int64
+dmz::QtTileCache::get_disk_bytes () const { return _state.bytes; }
+
+
+//! Returns the number of stored tiles.
+dmz::Int32
+dmz::QtTileCache::get_tile_count () const { return _state.fileTable.get_count (); }
+
+
+/*!
+
+\brief Stores a tile.
+\details The least recently used tiles are removed if the store exceeds its byte
+limit.
+\param[in] Name File name of the tile.
+\param[in] Data Contents of the tile.
+\return Returns dmz::True if the tile was written.
+
+*/
+dmz::Boolean
+dmz::QtTileCache::store_tile (const String &Name, const QByteArray &Data) {
+
+   Boolean result (False);
+
+   if (_state.directory && Name) {
+
+      QFile file (_state.get_path (Name).get_buffer ());
+
+      if (file.open (QIODevice::WriteOnly | QIODevice::Truncate)) {
+
+         result = file.write (Data) == Data.size ();
+         file.close ();
+      }
+
+      FileStruct *fs (_state.get_file (Name));
+
+      if (fs) {
+
+         if (result) {
+
+            _state.bytes += Int64 (Data.size ()) - fs->bytes;
+            fs->bytes = Data.size ();
+            _state.touch (*fs);
+            trim ();
+         }
+         else { _state.remove_file (fs); }
+      }
+   }
+
+   return result;
+}
+
+
+/*!
+
+\brief Loads a stored tile.
+\details The tile becomes the most recently used tile.
+\param[in] Name File name of the tile.
+\param[out] data QByteArray set to the contents of the tile.
+\return Returns dmz::True if the tile was found.
+
+*/
+dmz::Boolean
+dmz::QtTileCache::load_tile (const String &Name, QByteArray &data) {
+
+   Boolean result (False);
+
+   FileStruct *fs (_state.fileTable.lookup (Name));
+
+   if (fs) {
+
+      QFile file (_state.get_path (Name).get_buffer ());
+
+      if (file.open (QIODevice::ReadOnly)) {
+
+         data = file.readAll ();
+         file.close ();
+         result = True;
+      }
+
+      if (result) { _state.touch (*fs); }
+      else { _state.remove_file (fs); }
+   }
+
+   if (result) { _state.hits++; }
+   else { _state.misses++; }
+
+   return result;
+}
+
+
+//! Returns dmz::True if the tile is stored.
+dmz::Boolean
+dmz::QtTileCache::contains_tile (const String &Name) const {
+
+   return _state.fileTable.lookup (Name) != 0;
+}
+
+
+/*!
+
+\brief Finds tiles added to or removed from the directory by other code.
+\details New tiles are ordered by their modification time. The store is trimmed to
+its byte limit afterwards.
+\return Returns dmz::False if the directory could not be read.
+
+*/
+dmz::Boolean
+dmz::QtTileCache::rescan () {
+
+   Boolean result (False);
+
+   if (_state.directory) {
+
+      QDir dir (_state.directory.get_buffer ());
+
+      if (dir.exists ()) {
+
+         result = True;
+         _state.scan++;
+
+         // Oldest first so the newest tile ends up as the most recently used.
+         const QFileInfoList List (
+            dir.entryInfoList (QDir::Files, QDir::Time | QDir::Reversed));
+
+         for (int ix = 0; ix < List.count (); ix++) {
+
+            const QFileInfo &Info (List.at (ix));
+
+            const String Name (qPrintable (Info.fileName ()));
+
+            FileStruct *fs (_state.get_file (Name));
+
+            if (fs) {
+
+               _state.bytes += Int64 (Info.size ()) - fs->bytes;
+               fs->bytes = Info.size ();
+               fs->scan = _state.scan;
+            }
+         }
+
+         HashTableStringIterator it;
+         FileStruct *fs (_state.fileTable.get_next (it));
+
+         while (fs) {
+
+            if (fs->scan != _state.scan) { _state.remove_file (fs); }
+
+            fs = _state.fileTable.get_next (it);
+         }
+
+         trim ();
+      }
+   }
+
+   return result;
+}
+
+
+/*!
+
+\brief Removes the least recently used tiles until the store is under its byte limit.
+\return Returns the number of tiles removed.
+
+*/
+dmz::Int32
+dmz::QtTileCache::trim () {
+
+   Int32 result (0);
+
+   while ((_state.maxBytes > 0) && (_state.bytes > _state.maxBytes) && _state.tail) {
+
+      FileStruct *fs (_state.tail);
+
+      QFile::remove (_state.get_path (fs->Name).get_buffer ());
+      _state.remove_file (fs);
+      _state.evicts++;
+      result++;
+   }
+
+   return result;
+}
+
+
+//! Removes all stored tiles.
+void
+dmz::QtTileCache::clear () {
+
+   while (_state.tail) {
+
+      FileStruct *fs (_state.tail);
+
+      QFile::remove (_state.get_path (fs->Name).get_buffer ());
+      _state.remove_file (fs);
+   }
+
+   _state.fileTable.empty ();
+   _state.bytes = 0;
+}
+
+
+//! Sets how many seconds ahead of a moving view tiles are prefetched.
+void
+dmz::QtTileCache::set_prefetch_time (const Float64 Seconds) {
+
+   _state.prefetchTime = Seconds > 0.0 ? Seconds : 0.0;
+}
+
+
+//! Returns how many seconds ahead of a moving view tiles are prefetched.
+dmz::Float64
+dmz::QtTileCache::get_prefetch_time () const { return _state.prefetchTime; }
+
+
+//! Sets the number of tiles prefetched around the view.
+void
+dmz::QtTileCache::set_prefetch_margin (const Int32 Tiles) {
+
+   _state.prefetchMargin = Tiles > 0 ? Tiles : 0;
+}
+
+
+//! Returns the number of tiles prefetched around the view.
+dmz::Int32
+dmz::QtTileCache::get_prefetch_margin () const { return _state.prefetchMargin; }
+
+
+/*!
+
+\brief Plans the tiles to prefetch for a view.
+\details The tiles inside the view are assumed to be loaded by the display and are
+not prefetched. The remaining tiles around the view, extended in the direction the
+view is moving, are ordered by their distance from where the view is expected to be
+after the prefetch time. They are followed by the tiles covering the view at the
+previous zoom level and the tiles covering the center of the view at the next zoom
+level.
+\param[in] Zoom Zoom level of the view.
+\param[in] MinX First tile column in the view.
+\param[in] MinY First tile row in the view.
+\param[in] MaxX Last tile column in the view.
+\param[in] MaxY Last tile row in the view.
+\param[in] VelocityX Speed of the view in tile columns per second.
+\param[in] VelocityY Speed of the view in tile rows per second.
+\param[in] MinZoom Smallest zoom level of the tile source.
+\param[in] MaxZoom Largest zoom level of the tile source.
+\return Returns the number of tiles to prefetch.
+
+*/
+dmz::Int32
+dmz::QtTileCache::plan_prefetch (
+      const Int32 Zoom,
+      const Int32 MinX,
+      const Int32 MinY,
+      const Int32 MaxX,
+      const Int32 MaxY,
+      const Float64 VelocityX,
+      const Float64 VelocityY,
+      const Int32 MinZoom,
+      const Int32 MaxZoom) {
+
+   _state.queueCount = 0;
+   _state.queueNext = 0;
+
+   if ((Zoom >= 0) && (Zoom <= MaxTileZoom) && (MinX <= MaxX) && (MinY <= MaxY)) {
+
+      const Int32 Last ((1 << Zoom) - 1);
+
+      const Int32 ViewMinX (local_clamp (MinX, 0, Last));
+      const Int32 ViewMinY (local_clamp (MinY, 0, Last));
+      const Int32 ViewMaxX (local_clamp (MaxX, 0, Last));
+      const Int32 ViewMaxY (local_clamp (MaxY, 0, Last));
+
+      for (Int32 ix = ViewMinX; ix <= ViewMaxX; ix++) {
+
+         for (Int32 jy = ViewMinY; jy <= ViewMaxY; jy++) {
+
+            _state.request_tile (Zoom, ix, jy);
+         }
+      }
+
+      // The look ahead is limited to twice the size of the view.
+      const Int32 Width (ViewMaxX - ViewMinX + 1);
+      const Int32 Height (ViewMaxY - ViewMinY + 1);
+
+      const Int32 Dx (local_clamp (
+         Int32 (VelocityX * _state.prefetchTime), -Width * 2, Width * 2));
+
+      const Int32 Dy (local_clamp (
+         Int32 (VelocityY * _state.prefetchTime), -Height * 2, Height * 2));
+
+      const Float64 CenterX (Float64 (ViewMinX + ViewMaxX + 1) * 0.5 + Float64 (Dx));
+      const Float64 CenterY (Float64 (ViewMinY + ViewMaxY + 1) * 0.5 + Float64 (Dy));
+
+      const Int32 Margin (_state.prefetchMargin);
+
+      const Int32 AreaMinX (local_clamp (
+         (Dx < 0 ? ViewMinX + Dx : ViewMinX) - Margin, 0, Last));
+
+      const Int32 AreaMinY (local_clamp (
+         (Dy < 0 ? ViewMinY + Dy : ViewMinY) - Margin, 0, Last));
+
+      const Int32 AreaMaxX (local_clamp (
+         (Dx > 0 ? ViewMaxX + Dx : ViewMaxX) + Margin, 0, Last));
+
+      const Int32 AreaMaxY (local_clamp (
+         (Dy > 0 ? ViewMaxY + Dy : ViewMaxY) + Margin, 0, Last));
+
+      for (Int32 ix = AreaMinX; ix <= AreaMaxX; ix++) {
+
+         for (Int32 jy = AreaMinY; jy <= AreaMaxY; jy++) {
+
+            const Float64 OffsetX (Float64 (ix) + 0.5 - CenterX);
+            const Float64 OffsetY (Float64 (jy) + 0.5 - CenterY);
+
+            _state.add_tile (
+               Zoom, ix, jy, (OffsetX * OffsetX) + (OffsetY * OffsetY));
+         }
+      }
+
+      qsort (_state.queue, _state.queueCount, sizeof (TileStruct), local_compare);
+
+      if (Zoom > MinZoom) {
+
+         for (Int32 ix = ViewMinX >> 1; ix <= ViewMaxX >> 1; ix++) {
+
+            for (Int32 jy = ViewMinY >> 1; jy <= ViewMaxY >> 1; jy++) {
+
+               _state.add_tile (Zoom - 1, ix, jy, ZoomPriority);
+            }
+         }
+      }
+
+      if ((Zoom < MaxZoom) && (Zoom < MaxTileZoom)) {
+
+         const Int32 CenterMinX (ViewMinX + (Width / 4));
+         const Int32 CenterMinY (ViewMinY + (Height / 4));
+         const Int32 CenterMaxX (ViewMaxX - (Width / 4));
+         const Int32 CenterMaxY (ViewMaxY - (Height / 4));
+
+         for (Int32 ix = CenterMinX * 2; ix <= (CenterMaxX * 2) + 1; ix++) {
+
+            for (Int32 jy = CenterMinY * 2; jy <= (CenterMaxY * 2) + 1; jy++) {
+
+               _state.add_tile (Zoom + 1, ix, jy, ZoomPriority * 2.0);
+            }
+         }
+      }
+   }
+
+   return _state.queueCount;
+}
+
+
+/*!
+
+\brief Returns the next tile to prefetch.
+\details Each tile is only returned once until dmz::QtTileCache::clear_prefetch is
+called.
+\param[out] zoom Zoom level of the tile.
+\param[out] x Column of the tile.
+\param[out] y Row of the tile.
+\return Returns dmz::False if there are no more tiles to prefetch.
+
+*/
+dmz::Boolean
+dmz::QtTileCache::get_next_prefetch (Int32 &zoom, Int32 &x, Int32 &y) {
+
+   Boolean result (False);
+
+   while (!result && (_state.queueNext < _state.queueCount)) {
+
+      const TileStruct &Tile (_state.queue[_state.queueNext]);
+      _state.queueNext++;
+
+      if (!_state.requestedTable.lookup (local_tile_key (Tile.zoom, Tile.x, Tile.y))) {
+
+         _state.request_tile (Tile.zoom, Tile.x, Tile.y);
+
+         zoom = Tile.zoom;
+         x = Tile.x;
+         y = Tile.y;
+         result = True;
+      }
+   }
+
+   return result;
+}
+
+
+//! Returns the number of planned tiles that have not been returned yet.
+dmz::Int32
+dmz::QtTileCache::get_prefetch_count () const {
+
+   return _state.queueCount - _state.queueNext;
+}
+
+
+//! Clears the planned tiles and forgets which tiles were returned.
+void
+dmz::QtTileCache::clear_prefetch () {
+
+   _state.queueCount = 0;
+   _state.queueNext = 0;
+   _state.requestedTable.clear ();
+}
+
+
+//! Returns the number of tiles found by dmz::QtTileCache::load_tile.
+dmz::UInt64
+dmz::QtTileCache::get_hit_count () const { return _state.hits; }
+
+
+//! Returns the number of tiles not found by dmz::QtTileCache::load_tile.
+dmz::UInt64
+dmz::QtTileCache::get_miss_count () const { return _state.misses; }
+
+
+//! Returns the number of tiles removed to keep the store under its byte limit.
+dmz::UInt64
+dmz::QtTileCache::get_evict_count () const { return _state.evicts; }
+
+
+//! Resets the hit, miss, and evict counts.
+void
+dmz::QtTileCache::reset_counts () { _state.hits = _state.misses = _state.evicts = 0; }
@@ -0,0 +1,71 @@
+#ifndef DMZ_QT_TILE_CACHE_DOT_H
+#define DMZ_QT_TILE_CACHE_DOT_H
+
+#include <dmzQtUtilExport.h>
+#include <dmzTypesBase.h>
+
+class QByteArray;
+
+namespace dmz {
+
+   class String;
+
+   class DMZ_QT_UTIL_LINK_SYMBOL QtTileCache {
+
+      public:
+         QtTileCache ();
+         ~QtTileCache ();
+
+         Boolean set_directory (const String &Path);
+         String get_directory () const;
+
+         void set_max_disk_bytes (const Int64 Bytes);
+         Int64 get_max_disk_bytes () const;
+         Int64 get_disk_bytes () const;
+         Int32 get_tile_count () const;
+
+         Boolean store_tile (const String &Name, const QByteArray &Data);
+         Boolean load_tile (const String &Name, QByteArray &data);
+         Boolean contains_tile (const String &Name) const;
+
+         Boolean rescan ();
+         Int32 trim ();
+         void clear ();
+
+         void set_prefetch_time (const Float64 Seconds);
+         Float64 get_prefetch_time () const;
+
+         void set_prefetch_margin (const Int32 Tiles);
+         Int32 get_prefetch_margin () const;
+
+         Int32 plan_prefetch (
+            const Int32 Zoom,
+            const Int32 MinX,
+            const Int32 MinY,
+            const Int32 MaxX,
+            const Int32 MaxY,
+            const Float64 VelocityX,
+            const Float64 VelocityY,
+            const Int32 MinZoom,
+            const Int32 MaxZoom);
+
+         Boolean get_next_prefetch (Int32 &zoom, Int32 &x, Int32 &y);
+         Int32 get_prefetch_count () const;
+         void clear_prefetch ();
+
+         UInt64 get_hit_count () const;
+         UInt64 get_miss_count () const;
+         UInt64 get_evict_count () const;
+         void reset_counts ();
+
+      protected:
+         struct State;
+         State &_state; //!< Internal state.
+
+      private:
+         QtTileCache (const QtTileCache &);
+         QtTileCache &operator= (const QtTileCache &);
+   };
+};
+
+#endif // DMZ_QT_TILE_CACHE_DOT_H
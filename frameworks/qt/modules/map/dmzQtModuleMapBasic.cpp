@@ -11,10 +11,43 @@
 #include <dmzRuntimePluginFactoryLinkSymbol.h>
 #include <dmzRuntimePluginInfo.h>
 #include <dmzRuntimeSession.h>
+#include <dmzSystem.h>
 #include <dmzSystemFile.h>
+#include <dmzTypesHandleContainer.h>
 #include <qmapcontrol.h>
 #include <QtGui/QtGui>
 
+#include <math.h>
+
+namespace {
+
+static inline dmz::UInt64
+local_item_key (const qmapcontrol::Geometry *Item) {
+
+   return dmz::UInt64 (size_t (Item));
+}
+
+
+// Exposes the tile paths of the default adapter so its tiles can be prefetched.
+class TileAdapter : public qmapcontrol::TileMapAdapter {
+
+   public:
+      TileAdapter (
+            const QString &Host,
+            const QString &ServerPath,
+            const int TileSize,
+            const int MinZoom,
+            const int MaxZoom) :
+            qmapcontrol::TileMapAdapter (Host, ServerPath, TileSize, MinZoom, MaxZoom) {;}
+
+      QString get_tile_path (const int X, const int Y, const int Zoom) const {
+
+         return query (X, Y, Zoom);
+      }
+};
+
+};
+
 
 dmz::QtModuleMapBasic::QtModuleMapBasic (const PluginInfo &Info, Config &local) :
       QFrame (0),
@@ -31,15 +64,39 @@ dmz::QtModuleMapBasic::QtModuleMapBasic (const PluginInfo &Info, Config &local)
       _mouseEvent (),
       _ignoreEvents (False),
       _itemTable (),
+      _geometryTable (),
+      _index (),
+      _clusterList (),
+      _cull (True),
+      _cullMargin (32),
+      _cullDelay (100),
+      _updatePending (False),
+      _clusterZoom (8),
+      _clusterPixels (64),
+      _clusterRadius (6),
+      _clusterPen (),
       _map (0),
       _defaultAdapter (0),
       _mapAdapter (0),
       _baseLayer (0),
       _geomLayer (0),
+      _clusterLayer (0),
       _zoomMin (0),
       _zoomMax (17),
       _zoomDefault (_zoomMin),
-      _cacheDir () {
+      _cacheDir (),
+      _tileCache (),
+      _tileTimer (),
+      _tilePrefetch (True),
+      _tilePrefetchCount (8),
+      _tileScanInterval (60.0),
+      _tileScanTime (0.0),
+      _tileZoom (-1),
+      _tileTime (0.0),
+      _tilePosX (0.0),
+      _tilePosY (0.0),
+      _tileVelocityX (0.0),
+      _tileVelocityY (0.0) {
 
    _init (local);
 }
@@ -47,7 +104,9 @@ dmz::QtModuleMapBasic::QtModuleMapBasic (const PluginInfo &Info, Config &local)
 
 dmz::QtModuleMapBasic::~QtModuleMapBasic () {
 
-   _itemTable.clear ();
+   _clear_clusters ();
+   _geometryTable.clear ();
+   _itemTable.empty ();
 }
 
 
@@ -63,12 +122,15 @@ dmz::QtModuleMapBasic::update_plugin_state (
    }
    else if (State == PluginStateStart) {
 
+      _tileTimer.start ();
    }
    else if (State == PluginStateStop) {
 
+      _tileTimer.stop ();
    }
    else if (State == PluginStateShutdown) {
 
+      _tileCache.rescan ();
       _save_session ();
       use_default_map_adapter ();
    }
@@ -196,6 +258,9 @@ dmz::QtModuleMapBasic::empty_tile_cache () {
          found = fileList.get_next (file);
       }
    }
+
+   _tileCache.rescan ();
+   _tileCache.clear_prefetch ();
 }
 
 
@@ -213,10 +278,16 @@ dmz::QtModuleMapBasic::set_map_adapter (qmapcontrol::MapAdapter *adapter) {
 
          if (_baseLayer) { _baseLayer->setMapAdapter (_mapAdapter); }
          if (_geomLayer) { _geomLayer->setMapAdapter (_mapAdapter); }
+         if (_clusterLayer) { _clusterLayer->setMapAdapter (_mapAdapter); }
 
          qmapcontrol::ImageManager::instance ()->abortLoading ();
          _map->updateRequestNew ();
          _map->setZoom (zoom);
+
+         _tileCache.clear_prefetch ();
+         _tileZoom = -1;
+
+         _schedule_view_update (0);
       }
    }
 }
@@ -229,14 +300,30 @@ dmz::QtModuleMapBasic::add_item (
 
    Boolean retVal (False);
 
-   if (item && _geomLayer) {
+   if (item && _geomLayer && !_itemTable.lookup (ObjectHandle)) {
+
+      ItemStruct *is (new ItemStruct (ObjectHandle, item));
+
+      if (_itemTable.store (ObjectHandle, is)) {
 
-      retVal = _itemTable.store (ObjectHandle, item);
+         retVal = True;
 
-      if (retVal) {
+         if (_cull) {
 
-         _geomLayer->addGeometry (item);
+            // Items are only added to the layer once they are inside the view.
+            if (_geometryTable.store (local_item_key (item), is)) {
+
+               connect (
+                  item, SIGNAL (positionChanged (Geometry *)),
+                  this, SLOT (_item_position_changed ()));
+            }
+
+            _update_item_position (*is);
+            _schedule_view_update (0);
+         }
+         else { _geomLayer->addGeometry (item); }
       }
+      else { delete is; is = 0; }
    }
 
    return retVal;
@@ -246,19 +333,35 @@ dmz::QtModuleMapBasic::add_item (
 qmapcontrol::Geometry *
 dmz::QtModuleMapBasic::lookup_item (const Handle ObjectHandle) {
 
-   qmapcontrol::Geometry *item (_itemTable.lookup (ObjectHandle));
-   return item;
+   ItemStruct *is (_itemTable.lookup (ObjectHandle));
+   return is ? is->item : 0;
 }
 
 
 qmapcontrol::Geometry *
 dmz::QtModuleMapBasic::remove_item (const Handle ObjectHandle) {
 
-   qmapcontrol::Geometry *item (_itemTable.remove (ObjectHandle));
+   qmapcontrol::Geometry *item (0);
+
+   ItemStruct *is (_itemTable.remove (ObjectHandle));
+
+   if (is) {
+
+      item = is->item;
+
+      if (_geometryTable.remove (local_item_key (item))) {
+
+         disconnect (item, 0, this, 0);
+      }
+
+      if (_geomLayer && (!_cull || _index.is_shown (ObjectHandle))) {
 
-   if (item && _geomLayer) {
+         _geomLayer->removeGeometry (item);
+      }
+
+      if (_index.remove_object (ObjectHandle)) { _schedule_view_update (_cullDelay); }
 
-      _geomLayer->removeGeometry (item);
+      delete is; is = 0;
    }
 
    return item;
@@ -396,6 +499,7 @@ dmz::QtModuleMapBasic::resizeEvent (QResizeEvent *event) {
          if (_map && event) {
 
             _map->resize (event->size ());
+            _schedule_view_update (0);
          }
 
          _handle_mouse_event (0, 0);
@@ -597,6 +701,245 @@ dmz::QtModuleMapBasic::_mouse_event_coordinate (
 }
 
 
+void
+dmz::QtModuleMapBasic::_item_position_changed () {
+
+   qmapcontrol::Geometry *item (qobject_cast<qmapcontrol::Geometry *> (sender ()));
+
+   ItemStruct *is (item ? _geometryTable.lookup (local_item_key (item)) : 0);
+
+   if (is) {
+
+      _update_item_position (*is);
+      _schedule_view_update (_cullDelay);
+   }
+}
+
+
+void
+dmz::QtModuleMapBasic::_view_changed () { _schedule_view_update (0); }
+
+
+void
+dmz::QtModuleMapBasic::_update_view () {
+
+   _updatePending = False;
+
+   if (_cull && _map && _geomLayer) {
+
+      const QSize Size (_map->size ());
+
+      const QPointF Corner1 (
+         _map->screenToWorldCoordinate (QPoint (-_cullMargin, -_cullMargin)));
+
+      const QPointF Corner2 (_map->screenToWorldCoordinate (
+         QPoint (Size.width () + _cullMargin, Size.height () + _cullMargin)));
+
+      Float64 clusterSize (0.0);
+
+      if (_map->currentZoom () <= _clusterZoom) {
+
+         // Longitude is linear in screen space so the cluster cells are sized from a
+         // horizontal span of the view.
+         const QPointF Origin (_map->screenToWorldCoordinate (QPoint (0, 0)));
+         const QPointF Edge (_map->screenToWorldCoordinate (QPoint (_clusterPixels, 0)));
+
+         clusterSize = fabs (Edge.x () - Origin.x ());
+      }
+
+      HandleContainer shown;
+      HandleContainer hidden;
+
+      if (_index.update_view (
+            qMin (Corner1.x (), Corner2.x ()),
+            qMin (Corner1.y (), Corner2.y ()),
+            qMax (Corner1.x (), Corner2.x ()),
+            qMax (Corner1.y (), Corner2.y ()),
+            clusterSize,
+            shown,
+            hidden)) {
+
+         HandleContainerIterator it;
+         Handle object (0);
+
+         while (hidden.get_next (it, object)) {
+
+            ItemStruct *is (_itemTable.lookup (object));
+            if (is) { _geomLayer->removeGeometry (is->item); }
+         }
+
+         it.reset ();
+
+         while (shown.get_next (it, object)) {
+
+            ItemStruct *is (_itemTable.lookup (object));
+            if (is) { _geomLayer->addGeometry (is->item); }
+         }
+
+         _update_clusters ();
+         _map->updateRequestNew ();
+      }
+   }
+}
+
+
+void
+dmz::QtModuleMapBasic::_update_item_position (const ItemStruct &Item) {
+
+   QPointF pos;
+
+   qmapcontrol::Point *point (qobject_cast<qmapcontrol::Point *> (Item.item));
+
+   if (point) { pos = point->coordinate (); }
+   else if (Item.item) { pos = Item.item->boundingBox ().center (); }
+
+   _index.update_object (Item.ObjectHandle, pos.x (), pos.y ());
+}
+
+
+void
+dmz::QtModuleMapBasic::_schedule_view_update (const Int32 Delay) {
+
+   // Updates are coalesced so a burst of moves or view changes is culled once. A view
+   // change still gets an immediate update when a delayed one is pending.
+   if (_cull && (!_updatePending || (Delay == 0))) {
+
+      _updatePending = True;
+      QTimer::singleShot (Delay, this, SLOT (_update_view ()));
+   }
+}
+
+
+void
+dmz::QtModuleMapBasic::_update_clusters () {
+
+   _clear_clusters ();
+
+   if (_clusterLayer) {
+
+      for (Int32 ix = 0; ix < _index.get_cluster_count (); ix++) {
+
+         Float64 x (0.0), y (0.0);
+         Int32 count (0);
+
+         if (_index.get_cluster (ix, x, y, count)) {
+
+            const int Radius (
+               _clusterRadius + (2 * int (floor (log (Float64 (count)) / log (2.0)))));
+
+            qmapcontrol::CirclePoint *marker (new qmapcontrol::CirclePoint (
+               x,
+               y,
+               Radius,
+               QString::number (count),
+               qmapcontrol::Point::Middle,
+               &_clusterPen));
+
+            _clusterList.append (marker);
+            _clusterLayer->addGeometry (marker);
+         }
+      }
+   }
+}
+
+
+void
+dmz::QtModuleMapBasic::_clear_clusters () {
+
+   while (!_clusterList.isEmpty ()) {
+
+      qmapcontrol::CirclePoint *marker (_clusterList.takeLast ());
+
+      if (_clusterLayer) { _clusterLayer->removeGeometry (marker); }
+
+      delete marker; marker = 0;
+   }
+}
+
+
+void
+dmz::QtModuleMapBasic::_update_tiles () {
+
+   const Float64 Time (get_time ());
+
+   if (_tilePrefetch) { _prefetch_tiles (Time); }
+
+   // The tile loader writes to the cache directory on its own so the directory is
+   // scanned from time to time to keep it under its byte limit.
+   if ((_tileScanInterval > 0.0) && ((Time - _tileScanTime) >= _tileScanInterval)) {
+
+      _tileScanTime = Time;
+      _tileCache.rescan ();
+   }
+}
+
+
+void
+dmz::QtModuleMapBasic::_prefetch_tiles (const Float64 Time) {
+
+   // Only the default adapter's tile paths are known.
+   if (_map && _defaultAdapter && (_mapAdapter == _defaultAdapter)) {
+
+      TileAdapter *adapter (static_cast<TileAdapter *> (_defaultAdapter));
+
+      const int TileSize (adapter->tilesize ());
+      const int Zoom (adapter->currentZoom ());
+
+      if (TileSize > 0) {
+
+         const QPoint Center (adapter->coordinateToDisplay (_map->currentCoordinate ()));
+         const Float64 PosX (Float64 (Center.x ()) / Float64 (TileSize));
+         const Float64 PosY (Float64 (Center.y ()) / Float64 (TileSize));
+         const Float64 Delta (Time - _tileTime);
+
+         if ((Zoom == _tileZoom) && (Delta > 0.0)) {
+
+            // Smooths the pan velocity so a single jump does not steer the prefetch.
+            _tileVelocityX = (_tileVelocityX + ((PosX - _tilePosX) / Delta)) * 0.5;
+            _tileVelocityY = (_tileVelocityY + ((PosY - _tilePosY) / Delta)) * 0.5;
+         }
+         else { _tileVelocityX = _tileVelocityY = 0.0; }
+
+         _tileZoom = Zoom;
+         _tileTime = Time;
+         _tilePosX = PosX;
+         _tilePosY = PosY;
+
+         const QSize Size (_map->size ());
+         const Float64 HalfWidth (Float64 (Size.width ()) / Float64 (TileSize * 2));
+         const Float64 HalfHeight (Float64 (Size.height ()) / Float64 (TileSize * 2));
+
+         _tileCache.plan_prefetch (
+            Zoom,
+            Int32 (floor (PosX - HalfWidth)),
+            Int32 (floor (PosY - HalfHeight)),
+            Int32 (floor (PosX + HalfWidth)),
+            Int32 (floor (PosY + HalfHeight)),
+            _tileVelocityX,
+            _tileVelocityY,
+            adapter->minZoom (),
+            adapter->maxZoom ());
+
+         qmapcontrol::ImageManager *manager (qmapcontrol::ImageManager::instance ());
+
+         Int32 zoom (0), x (0), y (0);
+
+         Int32 count (0);
+
+         while ((count < _tilePrefetchCount) &&
+               _tileCache.get_next_prefetch (zoom, x, y)) {
+
+            manager->prefetchImage (
+               adapter->host (),
+               adapter->get_tile_path (x, y, zoom));
+
+            count++;
+         }
+      }
+   }
+}
+
+
 void
 dmz::QtModuleMapBasic::_save_session () {
 
@@ -649,8 +992,36 @@ dmz::QtModuleMapBasic::_init (Config &local) {
 
          _log.info << "Persistent cache: " << _cacheDir << endl;
          _map->enablePersistentCache (QString (_cacheDir.get_buffer ()));
+
+         _tileCache.set_max_disk_bytes (config_to_int64 (
+            "tileCache.maxBytes", local, _tileCache.get_max_disk_bytes ()));
+
+         _tileCache.set_directory (_cacheDir);
+         _tileScanTime = get_time ();
       }
 
+      _tileScanInterval =
+         config_to_float64 ("tileCache.scanInterval", local, _tileScanInterval);
+
+      const Int32 MemoryBytes (config_to_int32 ("tileCache.memoryBytes", local, 0));
+
+      // Decoded tiles are kept in the pixmap cache by the tile loader.
+      if (MemoryBytes > 0) { QPixmapCache::setCacheLimit (MemoryBytes / 1024); }
+
+      _tilePrefetch = config_to_boolean ("tileCache.prefetch", local, _tilePrefetch);
+
+      _tilePrefetchCount =
+         config_to_int32 ("tileCache.prefetchCount", local, _tilePrefetchCount);
+
+      _tileCache.set_prefetch_time (config_to_float64 (
+         "tileCache.prefetchTime", local, _tileCache.get_prefetch_time ()));
+
+      _tileCache.set_prefetch_margin (config_to_int32 (
+         "tileCache.prefetchMargin", local, _tileCache.get_prefetch_margin ()));
+
+      _tileTimer.setInterval (config_to_int32 ("tileCache.interval", local, 250));
+      connect (&_tileTimer, SIGNAL (timeout ()), this, SLOT (_update_tiles ()));
+
       _map->showScale (config_to_boolean ("map.scale", local, True));
       _map->showLoading (config_to_boolean ("map.loading", local, True));
 
@@ -664,7 +1035,7 @@ dmz::QtModuleMapBasic::_init (Config &local) {
       String mapPath (config_to_string ("tileMapAdapter.path", local, "/%1/%2/%3.png"));
       Int32 tileSize (config_to_int32 ("tileMapAdapter.tileSize", local, 256));
 
-       _defaultAdapter = new qmapcontrol::TileMapAdapter (
+       _defaultAdapter = new TileAdapter (
          mapUrl.get_buffer (),
          mapPath.get_buffer (),
          tileSize,
@@ -677,6 +1048,33 @@ dmz::QtModuleMapBasic::_init (Config &local) {
       _geomLayer = new qmapcontrol::GeometryLayer ("geom", _defaultAdapter);
       _map->addLayer (_geomLayer);
 
+      _cull = config_to_boolean ("cull.enable", local, _cull);
+      _cullMargin = config_to_int32 ("cull.margin", local, _cullMargin);
+      _cullDelay = config_to_int32 ("cull.delay", local, _cullDelay);
+      _index.set_cell_size (config_to_float64 ("cull.cellSize", local, 1.0));
+
+      _clusterZoom = config_to_int32 ("cluster.zoom", local, _clusterZoom);
+      _clusterPixels = config_to_int32 ("cluster.size", local, _clusterPixels);
+      _clusterRadius = config_to_int32 ("cluster.radius", local, _clusterRadius);
+      _index.set_min_cluster_count (config_to_int32 ("cluster.min", local, 4));
+
+      _clusterPen.setColor (config_to_qcolor ("cluster.color", local, Qt::red));
+      _clusterPen.setWidth (config_to_int32 ("cluster.width", local, 2));
+
+      if (_cull) {
+
+         _clusterLayer = new qmapcontrol::GeometryLayer ("cluster", _defaultAdapter);
+         _map->addLayer (_clusterLayer);
+
+         connect (
+            _map, SIGNAL (viewChanged (const QPointF &, int)),
+            this, SLOT (_view_changed ()));
+
+         connect (
+            _map, SIGNAL (zoomChanged (int)),
+            this, SLOT (_view_changed ()));
+      }
+
       _mapAdapter = _defaultAdapter;
 
       QVBoxLayout *layout (new QVBoxLayout ());
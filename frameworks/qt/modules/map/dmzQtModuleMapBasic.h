@@ -4,12 +4,17 @@
 #include <dmzInputEventKey.h>
 #include <dmzInputEventMouse.h>
 #include <dmzQtModuleMap.h>
+#include <dmzQtTileCache.h>
 #include <dmzQtWidget.h>
+#include <dmzRenderClusterIndex.h>
 #include <dmzRenderModulePickConvert.h>
 #include <dmzRuntimeLog.h>
 #include <dmzRuntimePlugin.h>
 #include <dmzTypesHashTableHandleTemplate.h>
+#include <dmzTypesHashTableUInt64Template.h>
+#include <QtCore/QTimer>
 #include <QtGui/QFrame>
+#include <QtGui/QPen>
 
 
 namespace qmapcontrol {
@@ -18,6 +23,7 @@ namespace qmapcontrol {
    class MapLayer;
    class GeometryLayer;
    class Geometry;
+   class CirclePoint;
 };
 
 
@@ -104,7 +110,22 @@ namespace dmz {
             const QMouseEvent *Event,
             const QPointF Coordinate);
 
+         void _item_position_changed ();
+         void _view_changed ();
+         void _update_view ();
+         void _update_tiles ();
+
       protected:
+         struct ItemStruct {
+
+            const Handle ObjectHandle;
+            qmapcontrol::Geometry *item;
+
+            ItemStruct (const Handle TheHandle, qmapcontrol::Geometry *theItem) :
+                  ObjectHandle (TheHandle),
+                  item (theItem) {;}
+         };
+
          virtual void resizeEvent (QResizeEvent* event);
          virtual void keyPressEvent (QKeyEvent *event);
          virtual void keyReleaseEvent (QKeyEvent* event);
@@ -119,6 +140,12 @@ namespace dmz {
 
          void _handle_mouse_event (QMouseEvent *me, QWheelEvent *we);
 
+         void _update_item_position (const ItemStruct &Item);
+         void _schedule_view_update (const Int32 Delay);
+         void _update_clusters ();
+         void _clear_clusters ();
+         void _prefetch_tiles (const Float64 Time);
+
          void _save_session ();
          void _load_session ();
 
@@ -132,16 +159,40 @@ namespace dmz {
          InputEventKey _keyEvent;
          InputEventMouse _mouseEvent;
          Boolean _ignoreEvents;
-         HashTableHandleTemplate<qmapcontrol::Geometry> _itemTable;
+         HashTableHandleTemplate<ItemStruct> _itemTable;
+         HashTableUInt64Template<ItemStruct> _geometryTable;
+         RenderClusterIndex _index;
+         QList<qmapcontrol::CirclePoint *> _clusterList;
+         Boolean _cull;
+         Int32 _cullMargin;
+         Int32 _cullDelay;
+         Boolean _updatePending;
+         Int32 _clusterZoom;
+         Int32 _clusterPixels;
+         Int32 _clusterRadius;
+         QPen _clusterPen;
          qmapcontrol::MapControl *_map;
          qmapcontrol::MapAdapter *_defaultAdapter;
          qmapcontrol::MapAdapter *_mapAdapter;
          qmapcontrol::MapLayer *_baseLayer;
          qmapcontrol::GeometryLayer *_geomLayer;
+         qmapcontrol::GeometryLayer *_clusterLayer;
          Int32 _zoomMin;
          Int32 _zoomMax;
          Int32 _zoomDefault;
          String _cacheDir;
+         QtTileCache _tileCache;
+         QTimer _tileTimer;
+         Boolean _tilePrefetch;
+         Int32 _tilePrefetchCount;
+         Float64 _tileScanInterval;
+         Float64 _tileScanTime;
+         Int32 _tileZoom;
+         Float64 _tileTime;
+         Float64 _tilePosX;
+         Float64 _tilePosY;
+         Float64 _tileVelocityX;
+         Float64 _tileVelocityY;
 
       private:
          QtModuleMapBasic ();
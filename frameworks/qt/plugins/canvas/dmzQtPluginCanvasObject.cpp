@@ -12,6 +12,7 @@
 #include <dmzRuntimePluginInfo.h>
 #include <dmzRuntimeLoadPlugins.h>
 #include <dmzRuntimeSession.h>
+#include <dmzSystem.h>
 #include <dmzTypesMask.h>
 #include <dmzTypesMath.h>
 #include <dmzTypesMatrix.h>
@@ -139,7 +140,8 @@ dmz::QtPluginCanvasObject::QtPluginCanvasObject (
       _canvasModule (0),
       _canvasModuleName (),
       _objectTable (),
-      _updateTable (),
+      _updateQueue (),
+      _visibleRect (),
       _zoomChanged (False),
       _zoom (1.0) {
 
@@ -149,7 +151,7 @@ dmz::QtPluginCanvasObject::QtPluginCanvasObject (
 
 dmz::QtPluginCanvasObject::~QtPluginCanvasObject () {
 
-   _updateTable.clear ();
+   _updateQueue.clear ();
    _extensions.remove_plugins ();
    _objectTable.empty ();
 }
@@ -168,6 +170,15 @@ dmz::QtPluginCanvasObject::update_plugin_state (
    else if (State == PluginStateStop) {
 
       _extensions.stop_plugins ();
+
+      if (_updateQueue.get_update_count ()) {
+
+         _log.info << "Canvas updates: " << _updateQueue.get_update_count ()
+            << " coalesced: " << _updateQueue.get_coalesced_count ()
+            << " deferred: " << _updateQueue.get_deferred_count ()
+            << " average lag: " << _updateQueue.get_average_lag () * 1.0e3 << "ms"
+            << " max lag: " << _updateQueue.get_max_lag () * 1.0e3 << "ms" << endl;
+      }
    }
    else if (State == PluginStateShutdown) {
 
@@ -208,19 +219,16 @@ dmz::QtPluginCanvasObject::discover_plugin (
 void
 dmz::QtPluginCanvasObject::update_time_slice (const Float64 TimeDelta) {
 
-   if (_updateTable.get_count ()) {
+   QGraphicsView *view (_canvasModule ? _canvasModule->get_view () : 0);
 
-      QGraphicsView *view (_canvasModule->get_view ());
-      view->setUpdatesEnabled (false);
-      HashTableHandleIterator it;
-      ObjectStruct *os (_updateTable.get_first (it));
-      while (os) {
+   if (view && _updateQueue.get_count ()) {
 
-         os->update ();
-         os = _updateTable.get_next (it);
-      }
+      // Objects in or leaving the visible part of the canvas are always updated. Off
+      // screen objects are updated until the budget is used up.
+      _visibleRect = view->mapToScene (view->viewport ()->rect ()).boundingRect ();
 
-      _updateTable.clear ();
+      view->setUpdatesEnabled (false);
+      _updateQueue.update (get_time (), *this);
       view->setUpdatesEnabled (true);
    }
 }
@@ -278,7 +286,7 @@ dmz::QtPluginCanvasObject::destroy_object (
 
    if (os) {
 
-      _updateTable.remove (ObjectHandle);
+      _updateQueue.remove_object (ObjectHandle);
       if (_canvasModule) { _canvasModule->remove_item (ObjectHandle); }
       delete os; os = 0;
    }
@@ -400,10 +408,7 @@ dmz::QtPluginCanvasObject::update_object_position (
          os->posX = Value.get_x ();
          os->posY = Value.get_z ();
 
-         if (!_updateTable.lookup (ObjectHandle)) {
-
-            _updateTable.store (ObjectHandle, os);
-         }
+         _updateQueue.queue_object (ObjectHandle, get_time ());
       }
    }
 }
@@ -425,15 +430,17 @@ dmz::QtPluginCanvasObject::update_object_orientation (
 
          os->heading = get_heading (Value);
 
-         if (!_updateTable.lookup (ObjectHandle)) {
-
-            _updateTable.store (ObjectHandle, os);
-         }
+         _updateQueue.queue_object (ObjectHandle, get_time ());
       }
    }
 }
 
 
+//! Returns the queue of pending object updates and its lag and deferred counts.
+const dmz::ObjectUpdateQueue &
+dmz::QtPluginCanvasObject::get_update_queue () const { return _updateQueue; }
+
+
 void
 dmz::QtPluginCanvasObject::_store_object_module (ObjectModule &module) {
 
@@ -476,6 +483,28 @@ dmz::QtPluginCanvasObject::_remove_object_module (ObjectModule &module) {
 }
 
 
+// ObjectUpdateQueue::Updater Interface
+dmz::Boolean
+dmz::QtPluginCanvasObject::is_update_visible (const Handle ObjectHandle) {
+
+   ObjectStruct *os (_objectTable.lookup (ObjectHandle));
+
+   return os && (_visibleRect.contains (QPointF (os->posX, os->posY)) ||
+      (os->item && _visibleRect.intersects (os->item->sceneBoundingRect ())));
+}
+
+
+// Objects that changed again before they were updated are drawn with their latest
+// position and heading.
+void
+dmz::QtPluginCanvasObject::apply_update (const Handle ObjectHandle) {
+
+   ObjectStruct *os (_objectTable.lookup (ObjectHandle));
+
+   if (os) { os->update (); }
+}
+
+
 dmz::Boolean
 dmz::QtPluginCanvasObject::_find_config_from_type (
       Config &local,
@@ -511,6 +540,9 @@ dmz::QtPluginCanvasObject::_init (Config &local, Config &global) {
 
    _canvasModuleName = config_to_string ("module.canvas.name", local);
 
+   _updateQueue.set_budget (
+      config_to_float64 ("update.budget", local, _updateQueue.get_budget ()));
+
    Config pluginList;
 
    if (local.lookup_all_config ("plugin-list.plugin", pluginList)) {
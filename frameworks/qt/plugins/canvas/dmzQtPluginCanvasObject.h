@@ -2,12 +2,14 @@
 #define DMZ_QT_PLUGIN_CANVAS_OBJECT_DOT_H
 
 #include <dmzObjectObserverUtil.h>
+#include <dmzObjectUpdateQueue.h>
 #include <dmzRuntimeDefinitions.h>
 #include <dmzRuntimeLog.h>
 #include <dmzRuntimePlugin.h>
 #include <dmzRuntimePluginContainer.h>
 #include <dmzRuntimeTimeSlice.h>
 #include <dmzTypesHashTableHandleTemplate.h>
+#include <QtCore/QRectF>
 #include <QtGui/QGraphicsItem>
 
 
@@ -32,7 +34,8 @@ namespace dmz {
    class QtPluginCanvasObject :
          public Plugin,
          public TimeSlice,
-         public ObjectObserverUtil {
+         public ObjectObserverUtil,
+         private ObjectUpdateQueue::Updater {
 
       public:
          QtPluginCanvasObject (const PluginInfo &Info, Config &local, Config &global);
@@ -102,6 +105,8 @@ namespace dmz {
             const Matrix &Value,
             const Matrix *PreviousValue);
 
+         const ObjectUpdateQueue &get_update_queue () const;
+
       protected:
          struct ObjectStruct {
 
@@ -130,6 +135,10 @@ namespace dmz {
          virtual void _store_object_module (ObjectModule &module);
          virtual void _remove_object_module (ObjectModule &module);
 
+         // ObjectUpdateQueue::Updater Interface
+         virtual Boolean is_update_visible (const Handle ObjectHandle);
+         virtual void apply_update (const Handle ObjectHandle);
+
          Boolean _find_config_from_type (Config &local, ObjectType &objType);
 
          void _init (Config &local, Config &global);
@@ -144,7 +153,8 @@ namespace dmz {
          Handle _linkAttrHandle;
          Handle _hideAttrHandle;
          HashTableHandleTemplate<ObjectStruct> _objectTable;
-         HashTableHandleTemplate<ObjectStruct> _updateTable;
+         ObjectUpdateQueue _updateQueue;
+         QRectF _visibleRect;
          Boolean _zoomChanged;
          Float64 _zoom;
 
@@ -235,6 +235,55 @@ dmz::QtCanvasObjectText::_roundness (const Float32 Size) const {
 }
 
 
+dmz::QtCanvasObjectSymbol::QtCanvasObjectSymbol (
+      QtSymbolCache &cache,
+      QGraphicsItem *parent) :
+      QGraphicsItem (parent),
+      _cache (cache),
+      _fileName (),
+      _bounds () {;}
+
+
+dmz::QtCanvasObjectSymbol::~QtCanvasObjectSymbol () {;}
+
+
+dmz::Boolean
+dmz::QtCanvasObjectSymbol::set_file (const String &FileName) {
+
+   prepareGeometryChange ();
+   _fileName = FileName;
+   _bounds = QRectF (QPointF (0.0, 0.0), _cache.get_symbol_size (FileName));
+   update ();
+
+   return !_bounds.isEmpty ();
+}
+
+
+QRectF
+dmz::QtCanvasObjectSymbol::boundingRect () const { return _bounds; }
+
+
+void
+dmz::QtCanvasObjectSymbol::paint (
+      QPainter *painter,
+      const QStyleOptionGraphicsItem *option,
+      QWidget *widget) {
+
+   // The symbol is drawn from the image rasterized for the item's scale on the
+   // device so every item showing the same symbol at a similar scale shares it.
+#if (QT_VERSION >= QT_VERSION_CHECK(4, 6, 0))
+   const Float64 Scale (
+      QStyleOptionGraphicsItem::levelOfDetailFromTransform (painter->worldTransform ()));
+#else
+   const Float64 Scale (option->levelOfDetail);
+#endif
+
+   const QImage Image (_cache.lookup_symbol (_fileName, Scale));
+
+   if (!Image.isNull ()) { painter->drawImage (_bounds, Image); }
+}
+
+
 dmz::QtPluginCanvasObjectBasic::QtPluginCanvasObjectBasic (
       const PluginInfo &Info,
       Config &local) :
@@ -247,9 +296,9 @@ dmz::QtPluginCanvasObjectBasic::QtPluginCanvasObjectBasic (
       _stateAttributeHandle (0),
       _itemIgnoresTransformations (False),
       _zValue (10),
+      _rasterizeSymbols (True),
       _canvasModule (0),
       _canvasModuleName (),
-      _svgRendererTable (),
       _modelTable (),
       _masterModelTable (),
       _objectTable (),
@@ -265,11 +314,26 @@ dmz::QtPluginCanvasObjectBasic::~QtPluginCanvasObjectBasic () {
    _modelTable.empty ();
    _objectTable.empty ();
    _templateConfigTable.empty ();
-   _svgRendererTable.empty ();
+   _symbolCache.clear ();
 }
 
 
 // Plugin Interface
+void
+dmz::QtPluginCanvasObjectBasic::update_plugin_state (
+      const PluginStateEnum State,
+      const UInt32 Level) {
+
+   if (State == PluginStateStop) {
+
+      _log.info << "Symbol cache hits: " << _symbolCache.get_hit_count ()
+         << " misses: " << _symbolCache.get_miss_count ()
+         << " images: " << _symbolCache.get_image_count ()
+         << " bytes: " << _symbolCache.get_byte_count () << endl;
+   }
+}
+
+
 void
 dmz::QtPluginCanvasObjectBasic::discover_plugin (
       const PluginDiscoverEnum Mode,
@@ -726,14 +790,17 @@ dmz::QtPluginCanvasObjectBasic::_create_pixmap_item (
 }
 
 
-QGraphicsSvgItem *
+QGraphicsItem *
 dmz::QtPluginCanvasObjectBasic::_create_svg_item (
       ObjectStruct &os,
       QGraphicsItem *parent,
       const Config &Data,
       HashTableStringTemplate<String> &table) {
 
-   QGraphicsSvgItem *item (new QGraphicsSvgItem (parent));
+   QGraphicsItem *item (0);
+
+   if (_rasterizeSymbols) { item = new QtCanvasObjectSymbol (_symbolCache, parent); }
+   else { item = new QGraphicsSvgItem (parent); }
 
    Boolean center (True);
 
@@ -1041,13 +1108,13 @@ dmz::QtPluginCanvasObjectBasic::_file_request (
 
          if (pixmapItem) {
 
-            QPixmap pixmap;
-
-            //_log.info << "Loading pixmap file: " << LocalFilePath << endl;
+            // Pixmaps are implicitly shared so every item using the file shares the
+            // pixmap held by the cache.
+            const QPixmap Pixmap (_symbolCache.lookup_pixmap (File));
 
-            if (pixmap.load (File.get_buffer ())) {
+            if (!Pixmap.isNull ()) {
 
-               pixmapItem->setPixmap (pixmap);
+               pixmapItem->setPixmap (Pixmap);
                result = True;
             }
             else {
@@ -1060,30 +1127,28 @@ dmz::QtPluginCanvasObjectBasic::_file_request (
 
          if (svgItem) {
 
-            QSvgRenderer *renderer (
-               _svgRendererTable.lookup (File));
+            QSvgRenderer *renderer (_symbolCache.lookup_renderer (File));
 
-            if (!renderer) {
-
-               renderer = new QSvgRenderer ();
+            if (renderer) {
 
-               //_log.info << "Loading SVG file: " << LocalFilePath << endl;
+               svgItem->setSharedRenderer (renderer);
+               result = True;
+            }
+            else {
 
-               if (renderer->load (QString (File.get_buffer ()))) {
+               _log.error << "SVG failed to load: " << File << endl;
+            }
+         }
 
-                  _svgRendererTable.store (File, renderer);
-               }
-               else {
+         QtCanvasObjectSymbol *symbolItem (
+            qgraphicsitem_cast<QtCanvasObjectSymbol *> (item));
 
-                  _log.error << "SVG failed to load: " << File << endl;
-                  delete renderer; renderer = 0;
-               }
-            }
+         if (symbolItem) {
 
-            if (renderer) {
+            if (symbolItem->set_file (File)) { result = True; }
+            else {
 
-               svgItem->setSharedRenderer (renderer);
-               result = True;
+               _log.error << "SVG failed to load: " << File << endl;
             }
          }
       }
@@ -1272,6 +1337,16 @@ dmz::QtPluginCanvasObjectBasic::_init (Config &local) {
       local,
       _itemIgnoresTransformations);
 
+   _rasterizeSymbols = config_to_boolean (
+      "symbol-cache.rasterize",
+      local,
+      _rasterizeSymbols);
+
+   _symbolCache.set_max_image_bytes (config_to_int64 (
+      "symbol-cache.max-bytes",
+      local,
+      _symbolCache.get_max_image_bytes ()));
+
    Config templ;
    if (local.lookup_all_config ("template", templ)) {
 
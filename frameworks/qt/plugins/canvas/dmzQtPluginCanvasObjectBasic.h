@@ -2,6 +2,7 @@
 #define DMZ_QT_PLUGIN_CANVAS_OBJECT_BASIC_DOT_H
 
 #include <dmzObjectObserverUtil.h>
+#include <dmzQtSymbolCache.h>
 #include <dmzRuntimeDefinitions.h>
 #include <dmzRuntimeLog.h>
 #include <dmzRuntimePlugin.h>
@@ -14,7 +15,6 @@
 
 class QGraphicsPixmapItem;
 class QGraphicsSvgItem;
-class QSvgRenderer;
 
 
 namespace dmz {
@@ -72,6 +72,32 @@ namespace dmz {
    };
 
 
+   class QtCanvasObjectSymbol : public QGraphicsItem {
+
+      public:
+         enum { Type = UserType + 1 };
+
+         QtCanvasObjectSymbol (QtSymbolCache &cache, QGraphicsItem *parent = 0);
+         ~QtCanvasObjectSymbol ();
+
+         Boolean set_file (const String &FileName);
+
+         // QGraphicsItem Interface
+         virtual int type () const { return Type; }
+         virtual QRectF boundingRect () const;
+
+         virtual void paint (
+            QPainter *painter,
+            const QStyleOptionGraphicsItem *option,
+            QWidget *widget);
+
+      protected:
+         QtSymbolCache &_cache;
+         String _fileName;
+         QRectF _bounds;
+   };
+
+
    class QtPluginCanvasObjectBasic :
       public Plugin,
       public ObjectObserverUtil {
@@ -83,7 +109,7 @@ namespace dmz {
          // Plugin Interface
          virtual void update_plugin_state (
             const PluginStateEnum State,
-            const UInt32 Level) {;}
+            const UInt32 Level);
 
          virtual void discover_plugin (
             const PluginDiscoverEnum Mode,
@@ -257,7 +283,7 @@ namespace dmz {
             const Config &Data,
             HashTableStringTemplate<String> &table);
 
-         QGraphicsSvgItem *_create_svg_item (
+         QGraphicsItem *_create_svg_item (
             ObjectStruct &os,
             QGraphicsItem *parent,
             const Config &Data,
@@ -311,7 +337,8 @@ namespace dmz {
          Handle _stateAttributeHandle;
          Boolean _itemIgnoresTransformations;
          Int32 _zValue;
-         HashTableStringTemplate<QSvgRenderer> _svgRendererTable;
+         Boolean _rasterizeSymbols;
+         QtSymbolCache _symbolCache;
          HashTableHandleTemplate<ModelStruct> _modelTable;
          HashTableHandleTemplate<ModelStruct> _masterModelTable;
          HashTableHandleTemplate<ObjectStruct> _objectTable;
@@ -1,3 +1,4 @@
+#include <dmzObjectAttributeMasks.h>
 #include <dmzObjectModule.h>
 #include <dmzQtModuleCanvas.h>
 #include "dmzQtPluginRenderPickCanvas.h"
@@ -6,6 +7,7 @@
 #include <dmzRuntimeConfigToVector.h>
 #include <dmzRuntimePluginFactoryLinkSymbol.h>
 #include <dmzRuntimePluginInfo.h>
+#include <dmzTypesHandleContainer.h>
 #include <dmzTypesVector.h>
 #include <QtGui/QtGui>
 
@@ -14,6 +16,7 @@ dmz::QtPluginRenderPickCanvas::QtPluginRenderPickCanvas (
       const PluginInfo &Info,
       Config &local) :
       Plugin (Info),
+      ObjectObserverUtil (Info, local),
       RenderPickUtil (Info, local),
       _log (Info),
       _canvasModule (0),
@@ -22,7 +25,10 @@ dmz::QtPluginRenderPickCanvas::QtPluginRenderPickCanvas (
       _objectModuleName (),
       _discoverPickConvert (False),
       _pickConvertModule (0),
-      _pickConvertModuleName () {
+      _pickConvertModuleName (),
+      _defaultAttrHandle (0),
+      _indexEnabled (False),
+      _indexRadius (8) {
 
    // Initialize array
    _vectorOrder[0] = VectorComponentX;
@@ -81,6 +87,34 @@ dmz::QtPluginRenderPickCanvas::discover_plugin (
 }
 
 
+// Object Observer Interface
+void
+dmz::QtPluginRenderPickCanvas::destroy_object (
+      const UUID &Identity,
+      const Handle ObjectHandle) {
+
+   _index.remove_object (ObjectHandle);
+}
+
+
+void
+dmz::QtPluginRenderPickCanvas::update_object_position (
+      const UUID &Identity,
+      const Handle ObjectHandle,
+      const Handle AttributeHandle,
+      const Vector &Value,
+      const Vector *PreviousValue) {
+
+   if (AttributeHandle == _defaultAttrHandle) {
+
+      _index.update_object (
+         ObjectHandle,
+         Value.get (_vectorOrder[0]),
+         Value.get (_vectorOrder[1]));
+   }
+}
+
+
 // RenderPick Interface
 dmz::Boolean
 dmz::QtPluginRenderPickCanvas::screen_to_world (
@@ -228,12 +262,48 @@ dmz::QtPluginRenderPickCanvas::world_to_source (
 }
 
 
+dmz::Boolean
+dmz::QtPluginRenderPickCanvas::_source_to_world (
+      const QPoint &SourcePos,
+      Vector &worldPosition) {
+
+   Boolean retVal (False);
+
+   QGraphicsView *view (_canvasModule ? _canvasModule->get_view () : 0);
+
+   if (view) {
+
+      if (_pickConvertModule) {
+
+         Vector normal;
+         Handle objectHandle (0);
+
+         _pickConvertModule->source_to_world (
+            SourcePos.x (), SourcePos.y (), worldPosition, normal, objectHandle);
+      }
+      else {
+
+         QPointF worldPoint (view->mapToScene (SourcePos));
+
+         worldPosition.set (_vectorOrder[0], worldPoint.x ());
+         worldPosition.set (_vectorOrder[1], worldPoint.y ());
+         worldPosition.set (_vectorOrder[2], 0.0);
+      }
+
+      retVal = True;
+   }
+
+   return retVal;
+}
+
+
 dmz::Handle
 dmz::QtPluginRenderPickCanvas::_get_object_handle (const QPoint &ScreenPos) {
 
    Handle objectHandle (0);
 
-   if (_canvasModule) {
+   if (_indexEnabled) { objectHandle = _find_indexed_object (ScreenPos); }
+   else if (_canvasModule) {
 
       QGraphicsView *view (_canvasModule->get_view ());
 
@@ -268,6 +338,80 @@ dmz::QtPluginRenderPickCanvas::_get_object_handle (const QPoint &ScreenPos) {
 }
 
 
+// Finds the visible object nearest to the source position using the pick index
+// instead of asking the view for every item under the cursor.
+dmz::Handle
+dmz::QtPluginRenderPickCanvas::_find_indexed_object (const QPoint &SourcePos) {
+
+   Handle result (0);
+
+   Float64 minX (0.0), minY (0.0), maxX (0.0), maxY (0.0);
+   Boolean valid (True);
+
+   // The corners of the pick area are converted separately so the search box is
+   // correct for views that are rotated or flipped.
+   for (Int32 ix = 0; (ix < 4) && valid; ix++) {
+
+      const QPoint Corner (
+         SourcePos.x () + ((ix & 0x01) ? _indexRadius : -_indexRadius),
+         SourcePos.y () + ((ix & 0x02) ? _indexRadius : -_indexRadius));
+
+      Vector pos;
+
+      if (_source_to_world (Corner, pos)) {
+
+         const Float64 X (pos.get (_vectorOrder[0]));
+         const Float64 Y (pos.get (_vectorOrder[1]));
+
+         if (!ix) { minX = maxX = X; minY = maxY = Y; }
+         else {
+
+            if (X < minX) { minX = X; } else if (X > maxX) { maxX = X; }
+            if (Y < minY) { minY = Y; } else if (Y > maxY) { maxY = Y; }
+         }
+      }
+      else { valid = False; }
+   }
+
+   HandleContainer list;
+
+   if (valid && _index.find_in_box (minX, minY, maxX, maxY, list)) {
+
+      Int32 best ((_indexRadius * _indexRadius) + 1);
+
+      HandleContainerIterator it;
+      Handle object (0);
+
+      while (list.get_next (it, object)) {
+
+         QGraphicsItem *item (_canvasModule->lookup_item (object));
+
+         Float64 x (0.0), y (0.0);
+
+         if (item && item->isVisible () && _index.lookup_object (object, x, y)) {
+
+            Vector pos;
+            pos.set (_vectorOrder[0], x);
+            pos.set (_vectorOrder[1], y);
+
+            Int32 sourceX (0), sourceY (0);
+
+            if (world_to_source (pos, sourceX, sourceY)) {
+
+               const Int32 Dx (sourceX - SourcePos.x ());
+               const Int32 Dy (sourceY - SourcePos.y ());
+               const Int32 Dist2 ((Dx * Dx) + (Dy * Dy));
+
+               if (Dist2 < best) { best = Dist2; result = object; }
+            }
+         }
+      }
+   }
+
+   return result;
+}
+
+
 void
 dmz::QtPluginRenderPickCanvas::_init (Config &local) {
 
@@ -279,6 +423,17 @@ dmz::QtPluginRenderPickCanvas::_init (Config &local) {
    _vectorOrder[0] = config_to_vector_component ("order.x", local, _vectorOrder [0]);
    _vectorOrder[1] = config_to_vector_component ("order.y", local, _vectorOrder [1]);
    _vectorOrder[2] = config_to_vector_component ("order.z", local, _vectorOrder [2]);
+
+   _indexEnabled = config_to_boolean ("index.enable", local, _indexEnabled);
+
+   if (_indexEnabled) {
+
+      _indexRadius = config_to_int32 ("index.radius", local, _indexRadius);
+      _index.set_cell_size (config_to_float64 ("index.cellSize", local, 10.0));
+
+      _defaultAttrHandle = activate_default_object_attribute (
+         ObjectDestroyMask | ObjectPositionMask);
+   }
 }
 
 
@@ -1,6 +1,8 @@
 #ifndef DMZ_QT_PLUGIN_RENDER_PICK_CANVAS_DOT_H
 #define DMZ_QT_PLUGIN_RENDER_PICK_CANVAS_DOT_H
 
+#include <dmzObjectObserverUtil.h>
+#include <dmzRenderPickIndex.h>
 #include <dmzRenderPickUtil.h>
 #include <dmzRuntimeLog.h>
 #include <dmzRuntimePlugin.h>
@@ -18,6 +20,7 @@ namespace dmz {
 
    class QtPluginRenderPickCanvas :
       public Plugin,
+      public ObjectObserverUtil,
       private RenderPickUtil {
 
       public:
@@ -33,6 +36,16 @@ namespace dmz {
             const PluginDiscoverEnum Mode,
             const Plugin *PluginPtr);
 
+         // Object Observer Interface
+         virtual void destroy_object (const UUID &Identity, const Handle ObjectHandle);
+
+         virtual void update_object_position (
+            const UUID &Identity,
+            const Handle ObjectHandle,
+            const Handle AttributeHandle,
+            const Vector &Value,
+            const Vector *PreviousValue);
+
          // RenderModulePick Interface
          virtual Boolean screen_to_world (
             const Int32 ScreenPosX,
@@ -59,7 +72,9 @@ namespace dmz {
             Int32 &sourcePosY);
 
       protected:
+         Boolean _source_to_world (const QPoint &SourcePos, Vector &worldPosition);
          Handle _get_object_handle (const QPoint &Pos);
+         Handle _find_indexed_object (const QPoint &SourcePos);
          void _init (Config &local);
 
          Log _log;
@@ -71,6 +86,10 @@ namespace dmz {
          Boolean _discoverPickConvert;
          String _pickConvertModuleName;
          VectorComponentEnum _vectorOrder[3];
+         Handle _defaultAttrHandle;
+         Boolean _indexEnabled;
+         Int32 _indexRadius;
+         RenderPickIndex _index;
 
       private:
          QtPluginRenderPickCanvas ();
@@ -1,3 +1,4 @@
+#include <dmzObjectAttributeMasks.h>
 #include <dmzObjectModule.h>
 #include <dmzQtModuleMap.h>
 #include "dmzQtPluginRenderPickMap.h"
@@ -5,6 +6,7 @@
 #include <dmzRuntimeConfigToVector.h>
 #include <dmzRuntimePluginFactoryLinkSymbol.h>
 #include <dmzRuntimePluginInfo.h>
+#include <dmzTypesHandleContainer.h>
 #include <dmzTypesVector.h>
 #include <qmapcontrol.h>
 #include <QtGui/QtGui>
@@ -14,12 +16,15 @@ dmz::QtPluginRenderPickMap::QtPluginRenderPickMap (
       const PluginInfo &Info,
       Config &local) :
       Plugin (Info),
+      ObjectObserverUtil (Info, local),
       RenderPickUtil (Info, local),
       _log (Info),
       _mapModule (0),
       _mapModuleName (),
       _objectModule (0),
-      _objectModuleName () {
+      _objectModuleName (),
+      _defaultAttrHandle (0),
+      _indexRadius (8) {
 
    // Initialize array
    _vectorOrder[0] = VectorComponentX;
@@ -68,6 +73,34 @@ dmz::QtPluginRenderPickMap::discover_plugin (
 }
 
 
+// Object Observer Interface
+void
+dmz::QtPluginRenderPickMap::destroy_object (
+      const UUID &Identity,
+      const Handle ObjectHandle) {
+
+   _index.remove_object (ObjectHandle);
+}
+
+
+void
+dmz::QtPluginRenderPickMap::update_object_position (
+      const UUID &Identity,
+      const Handle ObjectHandle,
+      const Handle AttributeHandle,
+      const Vector &Value,
+      const Vector *PreviousValue) {
+
+   if (AttributeHandle == _defaultAttrHandle) {
+
+      _index.update_object (
+         ObjectHandle,
+         Value.get (_vectorOrder[0]),
+         Value.get (_vectorOrder[1]));
+   }
+}
+
+
 // RenderPick Interface
 dmz::Boolean
 dmz::QtPluginRenderPickMap::screen_to_world (
@@ -189,6 +222,8 @@ dmz::QtPluginRenderPickMap::world_to_source (
 }
 
 
+// Finds the visible object nearest to the source position. The map control has no
+// item lookup by position so the objects are found with the pick index.
 dmz::Handle
 dmz::QtPluginRenderPickMap::_get_object_handle (const QPoint &ScreenPos) {
 
@@ -196,32 +231,45 @@ dmz::QtPluginRenderPickMap::_get_object_handle (const QPoint &ScreenPos) {
 
    if (_mapModule) {
 
-      qmapcontrol::MapControl *map (_mapModule->get_map_control ());
+      // The map projection keeps the axes aligned so the opposite corners of the
+      // pick area bound the search box.
+      const QPointF Min (_mapModule->screen_to_world (
+         QPoint (ScreenPos.x () - _indexRadius, ScreenPos.y () + _indexRadius)));
 
-      if (map) {
+      const QPointF Max (_mapModule->screen_to_world (
+         QPoint (ScreenPos.x () + _indexRadius, ScreenPos.y () - _indexRadius)));
+
+      HandleContainer list;
 
-         // QList<QGraphicsItem *>itemList (view->items (ScreenPos));
-         // 
-         // if (itemList.count ()) {
-         // 
-         //    foreach (QGraphicsItem *item, itemList) {
-         // 
-         //       if (item->isVisible ()) {
-         // 
-         //          bool ok (false);
-         // 
-         //          qlonglong data (
-         //             item->data (QtCanvasObjectHandleIndex).toULongLong (&ok));
-         // 
-         //          if (ok && !objectHandle && data) {
-         // 
-         //             objectHandle = data;
-         //          }
-         // 
-         //          if (objectHandle) { break; }
-         //       }
-         //    }
-         // }
+      if (_index.find_in_box (
+            qMin (Min.x (), Max.x ()),
+            qMin (Min.y (), Max.y ()),
+            qMax (Min.x (), Max.x ()),
+            qMax (Min.y (), Max.y ()),
+            list)) {
+
+         Int32 best ((_indexRadius * _indexRadius) + 1);
+
+         HandleContainerIterator it;
+         Handle object (0);
+
+         while (list.get_next (it, object)) {
+
+            qmapcontrol::Geometry *item (_mapModule->lookup_item (object));
+
+            Float64 x (0.0), y (0.0);
+
+            if (item && item->isVisible () && _index.lookup_object (object, x, y)) {
+
+               const QPoint SourcePos (_mapModule->world_to_screen (QPointF (x, y)));
+
+               const Int32 Dx (SourcePos.x () - ScreenPos.x ());
+               const Int32 Dy (SourcePos.y () - ScreenPos.y ());
+               const Int32 Dist2 ((Dx * Dx) + (Dy * Dy));
+
+               if (Dist2 < best) { best = Dist2; objectHandle = object; }
+            }
+         }
       }
    }
 
@@ -238,6 +286,12 @@ dmz::QtPluginRenderPickMap::_init (Config &local) {
    _vectorOrder[0] = config_to_vector_component ("order.x", local, _vectorOrder [0]);
    _vectorOrder[1] = config_to_vector_component ("order.y", local, _vectorOrder [1]);
    _vectorOrder[2] = config_to_vector_component ("order.z", local, _vectorOrder [2]);
+
+   _indexRadius = config_to_int32 ("index.radius", local, _indexRadius);
+   _index.set_cell_size (config_to_float64 ("index.cellSize", local, 0.01));
+
+   _defaultAttrHandle = activate_default_object_attribute (
+      ObjectDestroyMask | ObjectPositionMask);
 }
 
 
@@ -1,6 +1,8 @@
 #ifndef DMZ_QT_PLUGIN_RENDER_PICK_MAP_DOT_H
 #define DMZ_QT_PLUGIN_RENDER_PICK_MAP_DOT_H
 
+#include <dmzObjectObserverUtil.h>
+#include <dmzRenderPickIndex.h>
 #include <dmzRenderPickUtil.h>
 #include <dmzRuntimeLog.h>
 #include <dmzRuntimePlugin.h>
@@ -17,6 +19,7 @@ namespace dmz {
 
    class QtPluginRenderPickMap :
       public Plugin,
+      public ObjectObserverUtil,
       private RenderPickUtil {
 
       public:
@@ -32,6 +35,16 @@ namespace dmz {
             const PluginDiscoverEnum Mode,
             const Plugin *PluginPtr);
 
+         // Object Observer Interface
+         virtual void destroy_object (const UUID &Identity, const Handle ObjectHandle);
+
+         virtual void update_object_position (
+            const UUID &Identity,
+            const Handle ObjectHandle,
+            const Handle AttributeHandle,
+            const Vector &Value,
+            const Vector *PreviousValue);
+
          // RenderModulePick Interface
          virtual Boolean screen_to_world (
             const Int32 ScreenPosX,
@@ -67,6 +80,9 @@ namespace dmz {
          ObjectModule *_objectModule;
          String _objectModuleName;
          VectorComponentEnum _vectorOrder[3];
+         Handle _defaultAttrHandle;
+         Int32 _indexRadius;
+         RenderPickIndex _index;
 
       private:
          QtPluginRenderPickMap ();
@@ -21,6 +21,9 @@ const char RenderIsectGlyphName[] = "DMZ_Render_Isect_Glyph";
 //! Render overlay isect attribute name. Defined in dmzRenderConsts.h.
 const char RenderIsectOverlayName[] = "DMZ_Render_Isect_Overlay";
 
+//! Render level of detail attribute name. Defined in dmzRenderConsts.h.
+const char RenderLODLevelName[] = "DMZ_Render_LOD_Level";
+
 //! @}
 };
 
@@ -0,0 +1,53 @@
+/*!
+
+\class dmz::RenderModuleTerrain
+\ingroup Render
+\brief Terrain query interface.
+\details The terrain module finds the terrain point and normal directly below or above a
+position. It is intended for clamping entities to the ground without the cost of
+general intersection testing.
+
+\fn dmz::RenderModuleTerrain::RenderModuleTerrain (const PluginInfo &Info)
+\brief Constructor.
+
+\fn dmz::RenderModuleTerrain::~RenderModuleTerrain ()
+\brief Destructor.
+
+\fn dmz::RenderModuleTerrain *dmz::RenderModuleTerrain::cast (
+const Plugin *PluginPtr,
+const String &PluginName)
+\brief Casts Plugin pointer to an RenderModuleTerrain.
+\details If the Plugin object implements the RenderModuleTerrain interface, a pointer to
+the RenderModuleTerrain interface of the Plugin is returned.
+\param[in] PluginPtr Pointer to the Plugin to cast.
+\param[in] PluginName String containing the name of the desired RenderModuleTerrain
+\return Returns pointer to the RenderModuleTerrain. Returns NULL if the PluginPtr does not
+implement the RenderModuleTerrain interface or the \a PluginName is not empty
+and not equal to the Plugin's name.
+
+\fn dmz::Boolean dmz::RenderModuleTerrain::get_terrain_point (
+const Vector &Value,
+Vector &point,
+Vector &normal)
+\brief Finds the terrain point below or above a position.
+\param[in] Value Position to clamp to the terrain.
+\param[out] point Terrain point.
+\param[out] normal Terrain normal at \a point.
+\return Returns dmz::True if a terrain point was found.
+
+\fn dmz::Int32 dmz::RenderModuleTerrain::get_terrain_points (
+const Int32 Count,
+const Vector *Values,
+Vector *points,
+Vector *normals,
+Boolean *found)
+\brief Finds the terrain points for a batch of positions.
+\details Positions without a terrain point leave \a points and \a normals unchanged.
+\param[in] Count Number of positions in \a Values.
+\param[in] Values Array of positions to clamp to the terrain.
+\param[out] points Array the terrain points are written to.
+\param[out] normals Array the terrain normals are written to.
+\param[out] found Optional array set to dmz::True for each position with a terrain point.
+\return Returns the number of positions with a terrain point.
+
+*/
@@ -0,0 +1,69 @@
+#ifndef DMZ_RENDER_MODULE_TERRAIN_DOT_H
+#define DMZ_RENDER_MODULE_TERRAIN_DOT_H
+
+#include <dmzRuntimePlugin.h>
+#include <dmzRuntimeRTTI.h>
+#include <dmzTypesBase.h>
+
+namespace dmz {
+
+   //! \cond
+   const char RenderModuleTerrainInterfaceName[] = "RenderModuleTerrainInterface";
+   //! \endcond
+
+   class Vector;
+
+   class RenderModuleTerrain {
+
+      public:
+         static RenderModuleTerrain *cast (
+            const Plugin *PluginPtr,
+            const String &PluginName = "");
+
+         virtual Boolean get_terrain_point (
+            const Vector &Value,
+            Vector &point,
+            Vector &normal) = 0;
+
+         virtual Int32 get_terrain_points (
+            const Int32 Count,
+            const Vector *Values,
+            Vector *points,
+            Vector *normals,
+            Boolean *found) = 0;
+
+      protected:
+         RenderModuleTerrain (const PluginInfo &Info);
+         ~RenderModuleTerrain ();
+
+      private:
+         const PluginInfo &__Info;
+   };
+};
+
+
+inline dmz::RenderModuleTerrain *
+dmz::RenderModuleTerrain::cast (const Plugin *PluginPtr, const String &PluginName) {
+
+   return (RenderModuleTerrain *)lookup_rtti_interface (
+      RenderModuleTerrainInterfaceName,
+      PluginName,
+      PluginPtr);
+}
+
+
+inline
+dmz::RenderModuleTerrain::RenderModuleTerrain (const PluginInfo &Info) :
+      __Info (Info) {
+
+   store_rtti_interface (RenderModuleTerrainInterfaceName, __Info, (void *)this);
+}
+
+
+inline
+dmz::RenderModuleTerrain::~RenderModuleTerrain () {
+
+   remove_rtti_interface (RenderModuleTerrainInterfaceName, __Info);
+}
+
+#endif //  DMZ_RENDER_MODULE_TERRAIN_DOT_H
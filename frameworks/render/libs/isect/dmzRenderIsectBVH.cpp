@@ -0,0 +1,1501 @@
+#include <dmzRenderIsect.h>
+#include <dmzRenderIsectBVH.h>
+#include <dmzSystemMutex.h>
+#include <dmzSystemThread.h>
+#include <dmzSystemThreadPool.h>
+#include <dmzTypesHashTableHandleTemplate.h>
+#include <dmzTypesVector.h>
+
+#include <math.h>
+#include <string.h>
+
+using namespace dmz;
+
+namespace {
+
+static const Float64 Huge = 1.0e300;
+static const Float64 TraversalCost = 1.0;
+static const Int32 BinCount = 12;
+static const Int32 MaxLeafSize = 8;
+static const Int32 MaxDepth = 48;
+static const Int32 StackSize = MaxDepth + 2;
+static const Int32 PacketSize = 8;
+static const Int32 PacketsPerJob = 8;
+static const Int32 RaysPerJob = PacketSize * PacketsPerJob;
+static const Int32 MinTestsPerThread = 1024;
+static const Int32 RefitLimit = 32;
+
+enum HitModeEnum { AllHits, ClosestHit, AnyHit };
+
+struct BoxStruct {
+
+   Float64 min[3];
+   Float64 max[3];
+
+   void reset () {
+
+      for (Int32 ix = 0; ix < 3; ix++) { min[ix] = Huge; max[ix] = -Huge; }
+   }
+
+   void grow (const Float64 *Point) {
+
+      for (Int32 ix = 0; ix < 3; ix++) {
+
+         if (Point[ix] < min[ix]) { min[ix] = Point[ix]; }
+         if (Point[ix] > max[ix]) { max[ix] = Point[ix]; }
+      }
+   }
+
+   void grow (const BoxStruct &Box) {
+
+      for (Int32 ix = 0; ix < 3; ix++) {
+
+         if (Box.min[ix] < min[ix]) { min[ix] = Box.min[ix]; }
+         if (Box.max[ix] > max[ix]) { max[ix] = Box.max[ix]; }
+      }
+   }
+
+   Float64 get_area () const {
+
+      const Float64 X (max[0] - min[0]);
+      const Float64 Y (max[1] - min[1]);
+      const Float64 Z (max[2] - min[2]);
+
+      return (X < 0.0) ? 0.0 : (X * Y) + (Y * Z) + (Z * X);
+   }
+};
+
+
+struct NodeStruct {
+
+   BoxStruct box;
+   Int32 offset; // First primitive of a leaf or the second child of an interior node.
+   Int32 count; // Number of primitives in a leaf. Zero for interior nodes.
+   Int32 axis; // Split axis of an interior node.
+   UInt32 mask; // Union of the isect masks of every primitive below the node.
+};
+
+
+// Bounding volume hierarchy over a set of primitive boxes. Nodes are stored depth first
+// so the first child of a node always directly follows it and every child has a higher
+// index than its parent.
+struct TreeStruct {
+
+   NodeStruct *nodes;
+   Int32 nodeCount;
+   Int32 *order; // Primitive indices in leaf order.
+   Int32 count;
+
+   TreeStruct () : nodes (0), nodeCount (0), order (0), count (0) {;}
+   ~TreeStruct () { clear (); }
+
+   void clear () {
+
+      if (nodes) { delete []nodes; nodes = 0; }
+      if (order) { delete []order; order = 0; }
+      nodeCount = count = 0;
+   }
+
+   void build (const BoxStruct *Boxes, const UInt32 *Masks, const Int32 Count) {
+
+      clear ();
+
+      if (Count > 0) {
+
+         count = Count;
+         nodes = new NodeStruct[(Count * 2) - 1];
+         order = new Int32[Count];
+
+         Float64 *centers (new Float64[Count * 3]);
+
+         for (Int32 ix = 0; ix < Count; ix++) {
+
+            order[ix] = ix;
+
+            for (Int32 jy = 0; jy < 3; jy++) {
+
+               centers[(ix * 3) + jy] = (Boxes[ix].min[jy] + Boxes[ix].max[jy]) * 0.5;
+            }
+         }
+
+         _build_node (Boxes, Masks, centers, 0, Count, 0);
+
+         delete []centers; centers = 0;
+      }
+   }
+
+   void refit (const BoxStruct *Boxes, const UInt32 *Masks) {
+
+      for (Int32 ix = nodeCount - 1; ix >= 0; ix--) {
+
+         NodeStruct &node (nodes[ix]);
+
+         node.box.reset ();
+         node.mask = 0;
+
+         if (node.count) {
+
+            for (Int32 jy = node.offset; jy < (node.offset + node.count); jy++) {
+
+               node.box.grow (Boxes[order[jy]]);
+               node.mask |= Masks[order[jy]];
+            }
+         }
+         else {
+
+            node.box.grow (nodes[ix + 1].box);
+            node.box.grow (nodes[node.offset].box);
+            node.mask = nodes[ix + 1].mask | nodes[node.offset].mask;
+         }
+      }
+   }
+
+   Int32 _build_node (
+         const BoxStruct *Boxes,
+         const UInt32 *Masks,
+         const Float64 *Centers,
+         const Int32 First,
+         const Int32 Count,
+         const Int32 Depth) {
+
+      const Int32 Index (nodeCount++);
+      NodeStruct &node (nodes[Index]);
+
+      node.box.reset ();
+      node.offset = First;
+      node.count = Count;
+      node.axis = 0;
+      node.mask = 0;
+
+      BoxStruct centerBox;
+      centerBox.reset ();
+
+      for (Int32 ix = First; ix < (First + Count); ix++) {
+
+         node.box.grow (Boxes[order[ix]]);
+         node.mask |= Masks[order[ix]];
+         centerBox.grow (&(Centers[order[ix] * 3]));
+      }
+
+      Int32 axis (0);
+      Float64 extent (centerBox.max[0] - centerBox.min[0]);
+
+      for (Int32 ix = 1; ix < 3; ix++) {
+
+         const Float64 Value (centerBox.max[ix] - centerBox.min[ix]);
+         if (Value > extent) { extent = Value; axis = ix; }
+      }
+
+      Int32 split (0);
+
+      if ((Count > 1) && (Depth < MaxDepth)) {
+
+         if (extent > 0.0) {
+
+            // Binned surface area heuristic.
+            const Float64 Min (centerBox.min[axis]);
+            const Float64 Scale (Float64 (BinCount) / extent);
+
+            BoxStruct bins[BinCount];
+            Int32 binCounts[BinCount];
+            Float64 rightArea[BinCount];
+            Int32 rightCount[BinCount];
+
+            for (Int32 ix = 0; ix < BinCount; ix++) {
+
+               bins[ix].reset ();
+               binCounts[ix] = 0;
+            }
+
+            for (Int32 ix = First; ix < (First + Count); ix++) {
+
+               const Int32 Bin (_bin (Centers[(order[ix] * 3) + axis], Min, Scale));
+               bins[Bin].grow (Boxes[order[ix]]);
+               binCounts[Bin]++;
+            }
+
+            BoxStruct box;
+            box.reset ();
+            Int32 sum (0);
+
+            for (Int32 ix = BinCount - 1; ix > 0; ix--) {
+
+               box.grow (bins[ix]);
+               sum += binCounts[ix];
+               rightArea[ix] = box.get_area ();
+               rightCount[ix] = sum;
+            }
+
+            box.reset ();
+            sum = 0;
+            Int32 bestBin (0);
+            Float64 bestCost (Huge);
+
+            for (Int32 ix = 1; ix < BinCount; ix++) {
+
+               box.grow (bins[ix - 1]);
+               sum += binCounts[ix - 1];
+
+               const Float64 Cost (
+                  (Float64 (sum) * box.get_area ()) +
+                  (Float64 (rightCount[ix]) * rightArea[ix]));
+
+               if (sum && rightCount[ix] && (Cost < bestCost)) {
+
+                  bestCost = Cost;
+                  bestBin = ix;
+               }
+            }
+
+            const Float64 Area (node.box.get_area ());
+
+            if (bestBin && ((Count > MaxLeafSize) ||
+                  ((bestCost + (TraversalCost * Area)) < (Float64 (Count) * Area)))) {
+
+               Int32 left (First);
+               Int32 right (First + Count - 1);
+
+               while (left <= right) {
+
+                  if (_bin (Centers[(order[left] * 3) + axis], Min, Scale) < bestBin) {
+
+                     left++;
+                  }
+                  else {
+
+                     const Int32 Tmp (order[left]);
+                     order[left] = order[right];
+                     order[right] = Tmp;
+                     right--;
+                  }
+               }
+
+               split = left - First;
+            }
+         }
+
+         // Primitives that share a center can not be separated spatially.
+         if (!split && (Count > MaxLeafSize)) { split = Count / 2; }
+      }
+
+      if (split) {
+
+         node.count = 0;
+         node.axis = axis;
+         _build_node (Boxes, Masks, Centers, First, split, Depth + 1);
+         const Int32 Second (
+            _build_node (Boxes, Masks, Centers, First + split, Count - split, Depth + 1));
+         nodes[Index].offset = Second;
+      }
+
+      return Index;
+   }
+
+   static Int32 _bin (const Float64 Value, const Float64 Min, const Float64 Scale) {
+
+      Int32 result (Int32 ((Value - Min) * Scale));
+      if (result >= BinCount) { result = BinCount - 1; }
+      else if (result < 0) { result = 0; }
+      return result;
+   }
+};
+
+
+struct TriangleStruct {
+
+   Float64 point[3];
+   Float64 edge1[3];
+   Float64 edge2[3];
+   Float64 normal[3];
+   UInt32 mask;
+   UInt32 cullMode;
+};
+
+
+struct BoundsStruct {
+
+   const Handle ObjectHandle;
+   BoxStruct box;
+   UInt32 mask;
+   Boolean enabled;
+   Int32 index;
+
+   BoundsStruct (const Handle TheHandle) :
+         ObjectHandle (TheHandle),
+         mask (0),
+         enabled (True),
+         index (-1) { box.reset (); }
+};
+
+
+struct HitStruct {
+
+   UInt32 testID;
+   Float64 point[3];
+   Float64 normal[3];
+   Float64 distance;
+   Handle objectHandle;
+   UInt32 cullMode;
+};
+
+
+struct HitListStruct {
+
+   HitStruct *hits;
+   Int32 count;
+   Int32 capacity;
+
+   HitListStruct () : hits (0), count (0), capacity (0) {;}
+   ~HitListStruct () { if (hits) { delete []hits; hits = 0; } }
+
+   void add (const HitStruct &Hit) {
+
+      if (count >= capacity) {
+
+         const Int32 Capacity (capacity ? capacity * 2 : RaysPerJob);
+         HitStruct *tmp (new HitStruct[Capacity]);
+         if (count) { memcpy (tmp, hits, count * sizeof (HitStruct)); }
+         if (hits) { delete []hits; }
+         hits = tmp;
+         capacity = Capacity;
+      }
+
+      hits[count] = Hit;
+      count++;
+   }
+};
+
+
+struct RayStruct {
+
+   UInt32 testID;
+   Float64 origin[3];
+   Float64 dir[3];
+   Float64 inv[3];
+   Float64 length;
+   Float64 tmax;
+   Boolean found;
+   HitStruct best;
+};
+
+
+struct SortStruct {
+
+   UInt32 key;
+   Int32 index;
+};
+
+
+// Spreads the lower ten bits of Value so there are two zero bits between each bit.
+static inline UInt32
+local_spread_bits (UInt32 value) {
+
+   value = (value | (value << 16)) & 0x030000FF;
+   value = (value | (value << 8)) & 0x0300F00F;
+   value = (value | (value << 4)) & 0x030C30C3;
+   value = (value | (value << 2)) & 0x09249249;
+   return value;
+}
+
+
+static void
+local_radix_sort (SortStruct *values, SortStruct *tmp, const Int32 Count) {
+
+   for (Int32 shift = 0; shift < 32; shift += 8) {
+
+      Int32 offsets[256];
+      for (Int32 ix = 0; ix < 256; ix++) { offsets[ix] = 0; }
+      for (Int32 ix = 0; ix < Count; ix++) {
+
+         offsets[(values[ix].key >> shift) & 0xFF]++;
+      }
+
+      Int32 sum (0);
+
+      for (Int32 ix = 0; ix < 256; ix++) {
+
+         const Int32 Value (offsets[ix]);
+         offsets[ix] = sum;
+         sum += Value;
+      }
+
+      for (Int32 ix = 0; ix < Count; ix++) {
+
+         tmp[offsets[(values[ix].key >> shift) & 0xFF]++] = values[ix];
+      }
+
+      SortStruct *swap (values);
+      values = tmp;
+      tmp = swap;
+   }
+}
+
+
+static inline Float64
+local_min (const Float64 Value1, const Float64 Value2) {
+
+   return Value1 < Value2 ? Value1 : Value2;
+}
+
+
+static inline Float64
+local_max (const Float64 Value1, const Float64 Value2) {
+
+   return Value1 > Value2 ? Value1 : Value2;
+}
+
+
+// Written without branches since it is the inner most test of the traversal.
+static inline Boolean
+local_isect_box (const BoxStruct &Box, const RayStruct &Ray) {
+
+   const Float64 X1 ((Box.min[0] - Ray.origin[0]) * Ray.inv[0]);
+   const Float64 X2 ((Box.max[0] - Ray.origin[0]) * Ray.inv[0]);
+   const Float64 Y1 ((Box.min[1] - Ray.origin[1]) * Ray.inv[1]);
+   const Float64 Y2 ((Box.max[1] - Ray.origin[1]) * Ray.inv[1]);
+   const Float64 Z1 ((Box.min[2] - Ray.origin[2]) * Ray.inv[2]);
+   const Float64 Z2 ((Box.max[2] - Ray.origin[2]) * Ray.inv[2]);
+
+   const Float64 Near (local_max (
+      local_max (local_min (X1, X2), local_min (Y1, Y2)),
+      local_max (local_min (Z1, Z2), 0.0)));
+
+   const Float64 Far (local_min (
+      local_min (local_max (X1, X2), local_max (Y1, Y2)),
+      local_min (local_max (Z1, Z2), Ray.tmax)));
+
+   return Near <= Far;
+}
+
+
+// Finds where the ray enters the box or where it leaves if it starts inside the box.
+static inline Boolean
+local_isect_box (
+      const BoxStruct &Box,
+      const RayStruct &Ray,
+      Float64 &t,
+      Float64 *normal) {
+
+   Float64 tnear (-Huge);
+   Float64 tfar (Huge);
+   Int32 nearAxis (0);
+   Int32 farAxis (0);
+
+   for (Int32 ix = 0; ix < 3; ix++) {
+
+      Float64 t1 ((Box.min[ix] - Ray.origin[ix]) * Ray.inv[ix]);
+      Float64 t2 ((Box.max[ix] - Ray.origin[ix]) * Ray.inv[ix]);
+      if (t1 > t2) { const Float64 Tmp (t1); t1 = t2; t2 = Tmp; }
+      if (t1 > tnear) { tnear = t1; nearAxis = ix; }
+      if (t2 < tfar) { tfar = t2; farAxis = ix; }
+   }
+
+   Boolean result (False);
+
+   if ((tnear <= tfar) && (tfar >= 0.0)) {
+
+      const Boolean Inside (tnear < 0.0);
+      const Int32 Axis (Inside ? farAxis : nearAxis);
+
+      t = Inside ? tfar : tnear;
+
+      if (t <= Ray.tmax) {
+
+         normal[0] = normal[1] = normal[2] = 0.0;
+         normal[Axis] = ((Ray.dir[Axis] > 0.0) == Inside) ? 1.0 : -1.0;
+         result = True;
+      }
+   }
+
+   return result;
+}
+
+
+static inline Boolean
+local_isect_triangle (const TriangleStruct &Tri, const RayStruct &Ray, Float64 &t) {
+
+   Boolean result (False);
+
+   const Float64 *D (Ray.dir);
+   const Float64 *E1 (Tri.edge1);
+   const Float64 *E2 (Tri.edge2);
+
+   const Float64 P[3] = {
+      (D[1] * E2[2]) - (D[2] * E2[1]),
+      (D[2] * E2[0]) - (D[0] * E2[2]),
+      (D[0] * E2[1]) - (D[1] * E2[0])
+   };
+
+   const Float64 Det ((E1[0] * P[0]) + (E1[1] * P[1]) + (E1[2] * P[2]));
+
+   if (Det != 0.0) {
+
+      const Float64 Inv (1.0 / Det);
+
+      const Float64 S[3] = {
+         Ray.origin[0] - Tri.point[0],
+         Ray.origin[1] - Tri.point[1],
+         Ray.origin[2] - Tri.point[2]
+      };
+
+      const Float64 U (((S[0] * P[0]) + (S[1] * P[1]) + (S[2] * P[2])) * Inv);
+
+      if ((U >= 0.0) && (U <= 1.0)) {
+
+         const Float64 Q[3] = {
+            (S[1] * E1[2]) - (S[2] * E1[1]),
+            (S[2] * E1[0]) - (S[0] * E1[2]),
+            (S[0] * E1[1]) - (S[1] * E1[0])
+         };
+
+         const Float64 V (((D[0] * Q[0]) + (D[1] * Q[1]) + (D[2] * Q[2])) * Inv);
+
+         if ((V >= 0.0) && ((U + V) <= 1.0)) {
+
+            t = ((E2[0] * Q[0]) + (E2[1] * Q[1]) + (E2[2] * Q[2])) * Inv;
+            result = (t >= 0.0) && (t <= Ray.tmax);
+         }
+      }
+   }
+
+   return result;
+}
+
+
+// The state shared by the threads processing a single call to IsectBVH::do_isect.
+// Everything except the job counter and the per job hit lists is read only.
+struct IsectQueue {
+
+   const HitModeEnum Mode;
+   const UInt32 Mask;
+   const NodeStruct *TriangleNodes;
+   const TriangleStruct *Triangles;
+   const NodeStruct *BoundsNodes;
+   const Int32 *BoundsOrder;
+   BoundsStruct *const *BoundsList;
+   const RayStruct *Rays;
+   const SortStruct *Order;
+   const Int32 RayCount;
+   const Int32 JobCount;
+   HitListStruct *lists;
+   Mutex lock;
+   Int32 next;
+
+   IsectQueue (
+         const HitModeEnum TheMode,
+         const UInt32 TheMask,
+         const RayStruct *TheRays,
+         const SortStruct *TheOrder,
+         const Int32 TheRayCount,
+         HitListStruct *theLists) :
+         Mode (TheMode),
+         Mask (TheMask),
+         TriangleNodes (0),
+         Triangles (0),
+         BoundsNodes (0),
+         BoundsOrder (0),
+         BoundsList (0),
+         Rays (TheRays),
+         Order (TheOrder),
+         RayCount (TheRayCount),
+         JobCount ((TheRayCount + RaysPerJob - 1) / RaysPerJob),
+         lists (theLists),
+         next (0) {;}
+
+   Int32 get_next_job () {
+
+      Int32 result (-1);
+
+      lock.lock ();
+         if (next < JobCount) { result = next; next++; }
+      lock.unlock ();
+
+      return result;
+   }
+
+   void run_jobs () {
+
+      Int32 job (get_next_job ());
+
+      while (job >= 0) {
+
+         run_job (job);
+         job = get_next_job ();
+      }
+   }
+
+   void run_job (const Int32 Job) {
+
+      HitListStruct &hits (lists[Job]);
+      hits.count = 0;
+
+      const Int32 First (Job * RaysPerJob);
+      const Int32 Last (
+         (First + RaysPerJob) < RayCount ? First + RaysPerJob : RayCount);
+
+      RayStruct packet[PacketSize];
+
+      for (Int32 start = First; start < Last; start += PacketSize) {
+
+         const Int32 Count ((start + PacketSize) < Last ? PacketSize : Last - start);
+
+         for (Int32 ix = 0; ix < Count; ix++) {
+
+            packet[ix] = Rays[Order[start + ix].index];
+         }
+
+         UInt32 active ((1u << Count) - 1u);
+
+         if (TriangleNodes) {
+
+            active = _trace (TriangleNodes, True, packet, active, hits);
+         }
+         if (BoundsNodes && active) { _trace (BoundsNodes, False, packet, active, hits); }
+
+         if (Mode == ClosestHit) {
+
+            for (Int32 ix = 0; ix < Count; ix++) {
+
+               if (packet[ix].found) { hits.add (packet[ix].best); }
+            }
+         }
+      }
+   }
+
+   // Traces a packet of rays through the tree. A node is visited once for the whole
+   // packet and each primitive in a leaf is tested against the rays that hit the leaf.
+   // Each node on the stack carries the rays that hit its parent so rays that have
+   // left the packet's path are not tested against the nodes below it.
+   UInt32 _trace (
+         const NodeStruct *Nodes,
+         const Boolean IsTriangleTree,
+         RayStruct *rays,
+         UInt32 active,
+         HitListStruct &hits) {
+
+      Int32 stack[StackSize];
+      UInt32 stackRays[StackSize];
+      Int32 top (0);
+      stack[top] = 0;
+      stackRays[top] = active;
+      top++;
+
+      while (top && active) {
+
+         top--;
+         const NodeStruct &Node (Nodes[stack[top]]);
+         const UInt32 Rays (stackRays[top] & active);
+
+         if (Rays && (Node.mask & Mask)) {
+
+            UInt32 inside (0);
+            Int32 first (-1);
+
+            for (Int32 ix = 0; ix < PacketSize; ix++) {
+
+               if ((Rays & (1u << ix)) && local_isect_box (Node.box, rays[ix])) {
+
+                  inside |= (1u << ix);
+                  if (first < 0) { first = ix; }
+               }
+            }
+
+            if (inside && Node.count) {
+
+               if (IsTriangleTree) { _test_triangles (Node, rays, inside, active, hits); }
+               else { _test_bounds (Node, rays, inside, active, hits); }
+            }
+            else if (inside) {
+
+               const Int32 Left (Int32 (&Node - Nodes) + 1);
+               const Int32 Right (Node.offset);
+               const Boolean LeftFirst (rays[first].dir[Node.axis] >= 0.0);
+
+               stack[top] = LeftFirst ? Right : Left;
+               stackRays[top] = inside;
+               top++;
+               stack[top] = LeftFirst ? Left : Right;
+               stackRays[top] = inside;
+               top++;
+            }
+         }
+      }
+
+      return active;
+   }
+
+   void _test_triangles (
+         const NodeStruct &Node,
+         RayStruct *rays,
+         const UInt32 Inside,
+         UInt32 &active,
+         HitListStruct &hits) {
+
+      for (Int32 ix = Node.offset; ix < (Node.offset + Node.count); ix++) {
+
+         const TriangleStruct &Tri (Triangles[ix]);
+
+         if (Tri.mask & Mask) {
+
+            for (Int32 jy = 0; jy < PacketSize; jy++) {
+
+               Float64 t (0.0);
+
+               if ((Inside & active & (1u << jy)) &&
+                     local_isect_triangle (Tri, rays[jy], t)) {
+
+                  _add_hit (rays[jy], t, Tri.normal, 0, Tri.cullMode, hits);
+                  if (Mode == AnyHit) { active &= ~(1u << jy); }
+               }
+            }
+         }
+      }
+   }
+
+   void _test_bounds (
+         const NodeStruct &Node,
+         RayStruct *rays,
+         const UInt32 Inside,
+         UInt32 &active,
+         HitListStruct &hits) {
+
+      for (Int32 ix = Node.offset; ix < (Node.offset + Node.count); ix++) {
+
+         const BoundsStruct &Bounds (*(BoundsList[BoundsOrder[ix]]));
+
+         if (Bounds.enabled && (Bounds.mask & Mask)) {
+
+            for (Int32 jy = 0; jy < PacketSize; jy++) {
+
+               Float64 t (0.0);
+               Float64 normal[3];
+
+               if ((Inside & active & (1u << jy)) &&
+                     local_isect_box (Bounds.box, rays[jy], t, normal)) {
+
+                  _add_hit (
+                     rays[jy],
+                     t,
+                     normal,
+                     Bounds.ObjectHandle,
+                     IsectPolygonBackCulledMask,
+                     hits);
+
+                  if (Mode == AnyHit) { active &= ~(1u << jy); }
+               }
+            }
+         }
+      }
+   }
+
+   void _add_hit (
+         RayStruct &ray,
+         const Float64 T,
+         const Float64 *Normal,
+         const Handle ObjectHandle,
+         const UInt32 CullMode,
+         HitListStruct &hits) {
+
+      HitStruct &hit (ray.best);
+
+      hit.testID = ray.testID;
+      hit.distance = T * ray.length;
+      hit.objectHandle = ObjectHandle;
+      hit.cullMode = CullMode;
+
+      for (Int32 ix = 0; ix < 3; ix++) {
+
+         hit.point[ix] = ray.origin[ix] + (ray.dir[ix] * T);
+         hit.normal[ix] = Normal[ix];
+      }
+
+      if (Mode == ClosestHit) { ray.tmax = T; ray.found = True; }
+      else { hits.add (hit); }
+   }
+};
+
+
+class IsectWorker : public ThreadFunction {
+
+   public:
+      IsectWorker (IsectQueue &queue) : _queue (queue) {;}
+
+      virtual ~IsectWorker () {;}
+
+      virtual void run_thread_function () { _queue.run_jobs (); }
+
+   protected:
+      IsectQueue &_queue;
+};
+
+};
+
+
+/*!
+
+\class dmz::IsectBVH
+\ingroup Render
+\brief Intersection engine that does not depend on a render back end.
+\details Static triangles and dynamic object bounds are each stored in a bounding
+volume hierarchy. The hierarchies are built the first time they are needed after they
+change. Moving object bounds refits the object hierarchy instead of rebuilding it.
+\n
+All the tests in an IsectTestContainer are processed in a single pass. The tests are
+sorted so nearby tests with similar directions are traced together as a packet that
+visits each node once. Large batches are split across threads. IsectFirstPoint and
+IsectClosestPoint are applied to each test instead of to the batch as a whole.
+Results for triangles never have an object handle.
+
+*/
+
+struct dmz::IsectBVH::State {
+
+   Int32 threadCount;
+   ThreadPool pool;
+
+   TriangleStruct *triangles;
+   Int32 triangleCount;
+   Int32 triangleCapacity;
+   Boolean trianglesDirty;
+   TreeStruct triangleTree;
+
+   HashTableHandleTemplate<BoundsStruct> boundsTable;
+   BoundsStruct **boundsList;
+   Int32 boundsCapacity;
+   Boolean boundsRebuild;
+   Boolean boundsRefit;
+   Int32 refitCount;
+   TreeStruct boundsTree;
+
+   RayStruct *rays;
+   SortStruct *order;
+   SortStruct *sortTmp;
+   Int32 rayCapacity;
+   HitListStruct *lists;
+   Int32 listCount;
+
+   State () :
+         threadCount (1),
+         triangles (0),
+         triangleCount (0),
+         triangleCapacity (0),
+         trianglesDirty (False),
+         boundsList (0),
+         boundsCapacity (0),
+         boundsRebuild (False),
+         boundsRefit (False),
+         refitCount (0),
+         rays (0),
+         order (0),
+         sortTmp (0),
+         rayCapacity (0),
+         lists (0),
+         listCount (0) {;}
+
+   ~State () {
+
+      clear_triangles ();
+      clear_bounds ();
+      if (boundsList) { delete []boundsList; boundsList = 0; }
+      if (rays) { delete []rays; rays = 0; }
+      if (order) { delete []order; order = 0; }
+      if (sortTmp) { delete []sortTmp; sortTmp = 0; }
+      if (lists) { delete []lists; lists = 0; }
+   }
+
+   void clear_triangles () {
+
+      if (triangles) { delete []triangles; triangles = 0; }
+      triangleCount = triangleCapacity = 0;
+      trianglesDirty = False;
+      triangleTree.clear ();
+   }
+
+   void clear_bounds () {
+
+      boundsTable.empty ();
+      boundsTree.clear ();
+      boundsRebuild = boundsRefit = False;
+      refitCount = 0;
+   }
+
+   void update_triangle_tree ();
+   void update_bounds_tree ();
+   void reserve_rays (const Int32 Count);
+   void reserve_lists (const Int32 Count);
+};
+
+
+void
+dmz::IsectBVH::State::update_triangle_tree () {
+
+   if (trianglesDirty) {
+
+      trianglesDirty = False;
+
+      BoxStruct *boxes (new BoxStruct[triangleCount]);
+      UInt32 *masks (new UInt32[triangleCount]);
+
+      for (Int32 ix = 0; ix < triangleCount; ix++) {
+
+         const TriangleStruct &Tri (triangles[ix]);
+
+         BoxStruct &box (boxes[ix]);
+         box.reset ();
+
+         for (Int32 jy = 0; jy < 3; jy++) {
+
+            const Float64 Point1 (Tri.point[jy]);
+            const Float64 Point2 (Point1 + Tri.edge1[jy]);
+            const Float64 Point3 (Point1 + Tri.edge2[jy]);
+
+            box.min[jy] = Point1 < Point2 ? Point1 : Point2;
+            if (Point3 < box.min[jy]) { box.min[jy] = Point3; }
+            box.max[jy] = Point1 > Point2 ? Point1 : Point2;
+            if (Point3 > box.max[jy]) { box.max[jy] = Point3; }
+         }
+
+         masks[ix] = Tri.mask;
+      }
+
+      triangleTree.build (boxes, masks, triangleCount);
+
+      delete []boxes; boxes = 0;
+      delete []masks; masks = 0;
+
+      // Store the triangles in leaf order so each leaf is contiguous in memory.
+      if (triangleCount) {
+
+         TriangleStruct *sorted (new TriangleStruct[triangleCapacity]);
+
+         for (Int32 ix = 0; ix < triangleCount; ix++) {
+
+            sorted[ix] = triangles[triangleTree.order[ix]];
+         }
+
+         delete []triangles;
+         triangles = sorted;
+      }
+
+      // The triangles are now in leaf order so the order is no longer needed.
+      if (triangleTree.order) { delete []triangleTree.order; triangleTree.order = 0; }
+   }
+}
+
+
+void
+dmz::IsectBVH::State::update_bounds_tree () {
+
+   const Int32 Count (boundsTable.get_count ());
+
+   if (boundsRefit && !boundsRebuild && (refitCount >= RefitLimit)) {
+
+      boundsRebuild = True;
+   }
+
+   if (boundsRebuild || boundsRefit) {
+
+      BoxStruct *boxes (Count ? new BoxStruct[Count] : 0);
+      UInt32 *masks (Count ? new UInt32[Count] : 0);
+
+      for (Int32 ix = 0; ix < Count; ix++) {
+
+         boxes[ix] = boundsList[ix]->box;
+         masks[ix] = boundsList[ix]->mask;
+      }
+
+      if (boundsRebuild) {
+
+         boundsTree.build (boxes, masks, Count);
+         refitCount = 0;
+      }
+      else {
+
+         boundsTree.refit (boxes, masks);
+         refitCount++;
+      }
+
+      boundsRebuild = boundsRefit = False;
+
+      if (boxes) { delete []boxes; boxes = 0; }
+      if (masks) { delete []masks; masks = 0; }
+   }
+}
+
+
+void
+dmz::IsectBVH::State::reserve_rays (const Int32 Count) {
+
+   const Int32 Capacity (Count > RaysPerJob ? Count : RaysPerJob);
+
+   if (Capacity > rayCapacity) {
+
+      RayStruct *tmp (new RayStruct[Capacity]);
+      if (rays) { memcpy (tmp, rays, rayCapacity * sizeof (RayStruct)); delete []rays; }
+      rays = tmp;
+
+      if (order) { delete []order; }
+      if (sortTmp) { delete []sortTmp; }
+
+      rayCapacity = Capacity;
+      order = new SortStruct[rayCapacity];
+      sortTmp = new SortStruct[rayCapacity];
+   }
+}
+
+
+void
+dmz::IsectBVH::State::reserve_lists (const Int32 Count) {
+
+   if (Count > listCount) {
+
+      HitListStruct *tmp (new HitListStruct[Count]);
+
+      // Keep the buffers that have already grown.
+      for (Int32 ix = 0; ix < listCount; ix++) {
+
+         tmp[ix].hits = lists[ix].hits;
+         tmp[ix].capacity = lists[ix].capacity;
+         lists[ix].hits = 0;
+      }
+
+      if (lists) { delete []lists; }
+
+      lists = tmp;
+      listCount = Count;
+   }
+}
+
+
+//! Constructor.
+dmz::IsectBVH::IsectBVH () : _state (*(new State)) {;}
+
+
+//! Destructor.
+dmz::IsectBVH::~IsectBVH () { delete &_state; }
+
+
+//! Removes all triangles and object bounds.
+void
+dmz::IsectBVH::clear () {
+
+   _state.clear_triangles ();
+   _state.clear_bounds ();
+}
+
+
+/*!
+
+\brief Sets the maximum number of threads used to process a batch of tests.
+\details The calling thread is counted as one of the threads. The other threads are
+created here and are reused by every batch. A batch is only split across threads when
+it contains at least a thousand tests per thread. Defaults to one.
+\param[in] Count Maximum number of threads.
+
+*/
+void
+dmz::IsectBVH::set_thread_count (const Int32 Count) {
+
+   _state.threadCount = Count > 1 ? Count : 1;
+   _state.pool.set_thread_count (_state.threadCount - 1);
+}
+
+
+//! Returns the maximum number of threads used to process a batch of tests.
+dmz::Int32
+dmz::IsectBVH::get_thread_count () const { return _state.threadCount; }
+
+
+/*!
+
+\brief Adds a static triangle.
+\details Triangles are tested from both sides.
+\param[in] Point1 First vertex.
+\param[in] Point2 Second vertex.
+\param[in] Point3 Third vertex.
+\param[in] IsectMask Mask used to select the triangle in dmz::IsectBVH::do_isect.
+\param[in] CullMode Cull mode reported in results. The normal follows the right hand
+rule.
+\return Returns the number of triangles stored. Returns zero if the triangle has
+no area.
+
+*/
+dmz::Int32
+dmz::IsectBVH::add_triangle (
+      const Vector &Point1,
+      const Vector &Point2,
+      const Vector &Point3,
+      const UInt32 IsectMask,
+      const UInt32 CullMode) {
+
+   Int32 result (0);
+
+   const Vector Edge1 (Point2 - Point1);
+   const Vector Edge2 (Point3 - Point1);
+   const Vector Normal (Edge1.cross (Edge2));
+
+   if (Normal.magnitude () > 0.0) {
+
+      if (_state.triangleCount >= _state.triangleCapacity) {
+
+         const Int32 Capacity (
+            _state.triangleCapacity ? _state.triangleCapacity * 2 : 256);
+
+         TriangleStruct *tmp (new TriangleStruct[Capacity]);
+
+         if (_state.triangleCount) {
+
+            memcpy (
+               tmp,
+               _state.triangles,
+               _state.triangleCount * sizeof (TriangleStruct));
+         }
+
+         if (_state.triangles) { delete []_state.triangles; }
+         _state.triangles = tmp;
+         _state.triangleCapacity = Capacity;
+      }
+
+      TriangleStruct &tri (_state.triangles[_state.triangleCount]);
+      const Vector Unit (Normal.normalize ());
+
+      for (Int32 ix = 0; ix < 3; ix++) {
+
+         const VectorComponentEnum Component = VectorComponentEnum (ix);
+
+         tri.point[ix] = Point1.get (Component);
+         tri.edge1[ix] = Edge1.get (Component);
+         tri.edge2[ix] = Edge2.get (Component);
+         tri.normal[ix] = Unit.get (Component);
+      }
+
+      tri.mask = IsectMask;
+      tri.cullMode = CullMode;
+
+      _state.triangleCount++;
+      _state.trianglesDirty = True;
+      result = _state.triangleCount;
+   }
+
+   return result;
+}
+
+
+//! Returns the number of static triangles.
+dmz::Int32
+dmz::IsectBVH::get_triangle_count () const { return _state.triangleCount; }
+
+
+//! Removes all static triangles.
+void
+dmz::IsectBVH::clear_triangles () { _state.clear_triangles (); }
+
+
+/*!
+
+\brief Adds or updates the bounding box of an object.
+\details Object bounds are axis aligned boxes in world coordinates. Updating the box
+of an existing object only refits the object hierarchy.
+\param[in] ObjectHandle Handle of the object.
+\param[in] Min Minimum corner of the box.
+\param[in] Max Maximum corner of the box.
+\param[in] IsectMask Mask used to select the object in dmz::IsectBVH::do_isect.
+\return Returns dmz::True if the bounds were stored.
+
+*/
+dmz::Boolean
+dmz::IsectBVH::store_bounds (
+      const Handle ObjectHandle,
+      const Vector &Min,
+      const Vector &Max,
+      const UInt32 IsectMask) {
+
+   Boolean result (False);
+
+   BoundsStruct *bs (_state.boundsTable.lookup (ObjectHandle));
+
+   if (!bs && ObjectHandle) {
+
+      bs = new BoundsStruct (ObjectHandle);
+
+      if (_state.boundsTable.store (ObjectHandle, bs)) {
+
+         const Int32 Count (_state.boundsTable.get_count ());
+
+         if (Count > _state.boundsCapacity) {
+
+            const Int32 Capacity (Count * 2);
+            BoundsStruct **tmp (new BoundsStruct *[Capacity]);
+
+            for (Int32 ix = 0; ix < (Count - 1); ix++) {
+
+               tmp[ix] = _state.boundsList[ix];
+            }
+
+            if (_state.boundsList) { delete []_state.boundsList; }
+            _state.boundsList = tmp;
+            _state.boundsCapacity = Capacity;
+         }
+
+         bs->index = Count - 1;
+         _state.boundsList[bs->index] = bs;
+         _state.boundsRebuild = True;
+      }
+      else { delete bs; bs = 0; }
+   }
+
+   if (bs) {
+
+      for (Int32 ix = 0; ix < 3; ix++) {
+
+         const VectorComponentEnum Component = VectorComponentEnum (ix);
+         const Float64 Value1 (Min.get (Component));
+         const Float64 Value2 (Max.get (Component));
+
+         bs->box.min[ix] = Value1 < Value2 ? Value1 : Value2;
+         bs->box.max[ix] = Value1 < Value2 ? Value2 : Value1;
+      }
+
+      bs->mask = IsectMask;
+      _state.boundsRefit = True;
+      result = True;
+   }
+
+   return result;
+}
+
+
+/*!
+
+\brief Enables or disables intersection tests with an object.
+\details Disabling an object does not change the object hierarchy.
+\param[in] ObjectHandle Handle of the object.
+\param[in] Value Enables the object if dmz::True.
+\return Returns dmz::True if the object has bounds.
+
+*/
+dmz::Boolean
+dmz::IsectBVH::enable_bounds (const Handle ObjectHandle, const Boolean Value) {
+
+   BoundsStruct *bs (_state.boundsTable.lookup (ObjectHandle));
+
+   if (bs) { bs->enabled = Value; }
+
+   return bs != 0;
+}
+
+
+//! Removes the bounding box of an object.
+dmz::Boolean
+dmz::IsectBVH::remove_bounds (const Handle ObjectHandle) {
+
+   Boolean result (False);
+
+   BoundsStruct *bs (_state.boundsTable.remove (ObjectHandle));
+
+   if (bs) {
+
+      const Int32 Last (_state.boundsTable.get_count ());
+
+      if (bs->index < Last) {
+
+         _state.boundsList[bs->index] = _state.boundsList[Last];
+         _state.boundsList[bs->index]->index = bs->index;
+      }
+
+      _state.boundsList[Last] = 0;
+      _state.boundsRebuild = True;
+
+      delete bs; bs = 0;
+      result = True;
+   }
+
+   return result;
+}
+
+
+//! Returns the number of objects with bounds.
+dmz::Int32
+dmz::IsectBVH::get_bounds_count () const { return _state.boundsTable.get_count (); }
+
+
+/*!
+
+\brief Performs the intersection tests.
+\details Results are added to \a resultContainer. Triangles and object bounds are only
+tested if their mask shares a bit with \a IsectMask.
+\param[in] Parameters Intersection parameters.
+\param[in] TestValues Intersection tests to perform.
+\param[in] IsectMask Mask of the triangles and object bounds to test.
+\param[out] resultContainer Container the intersection results are added to.
+\return Returns dmz::True if \a resultContainer contains any results.
+
+*/
+dmz::Boolean
+dmz::IsectBVH::do_isect (
+      const IsectParameters &Parameters,
+      const IsectTestContainer &TestValues,
+      const UInt32 IsectMask,
+      IsectResultContainer &resultContainer) {
+
+   _state.update_triangle_tree ();
+   _state.update_bounds_tree ();
+
+   const Boolean HasTriangles (_state.triangleTree.nodeCount > 0);
+   const Boolean HasBounds (_state.boundsTree.nodeCount > 0);
+
+   UInt32 testID (0);
+   IsectTestTypeEnum testType (IsectUnknownTest);
+   Vector value1, value2;
+
+   Int32 count (0);
+
+   Boolean found (
+      (HasTriangles || HasBounds) &&
+      TestValues.get_first_test (testID, testType, value1, value2));
+
+   BoxStruct origins;
+   origins.reset ();
+
+   while (found) {
+
+      Vector dir;
+
+      if (testType == IsectRayTest) { dir = value2; }
+      else if (testType == IsectSegmentTest) { dir = value2 - value1; }
+
+      const Float64 Length (dir.magnitude ());
+
+      if (Length > 0.0) {
+
+         if (count >= _state.rayCapacity) { _state.reserve_rays (count * 2); }
+
+         RayStruct &ray (_state.rays[count]);
+
+         ray.testID = testID;
+         ray.length = Length;
+         ray.tmax = (testType == IsectRayTest) ? Huge : 1.0;
+         ray.found = False;
+
+         for (Int32 ix = 0; ix < 3; ix++) {
+
+            const VectorComponentEnum Component = VectorComponentEnum (ix);
+
+            ray.origin[ix] = value1.get (Component);
+            ray.dir[ix] = dir.get (Component);
+
+            if (ray.dir[ix] != 0.0) { ray.inv[ix] = 1.0 / ray.dir[ix]; }
+            else { ray.inv[ix] = (ray.dir[ix] < 0.0) ? -Huge : Huge; }
+         }
+
+         origins.grow (ray.origin);
+         count++;
+      }
+
+      found = TestValues.get_next_test (testID, testType, value1, value2);
+   }
+
+   if (count) {
+
+      // Sort the tests by direction octant and then along a Morton curve through
+      // their origins so each packet holds coherent rays.
+      Float64 scale[3];
+
+      for (Int32 ix = 0; ix < 3; ix++) {
+
+         const Float64 Extent (origins.max[ix] - origins.min[ix]);
+         scale[ix] = Extent > 0.0 ? 511.0 / Extent : 0.0;
+      }
+
+      for (Int32 ix = 0; ix < count; ix++) {
+
+         const RayStruct &Ray (_state.rays[ix]);
+         UInt32 key (0);
+
+         for (Int32 jy = 0; jy < 3; jy++) {
+
+            const UInt32 Cell (UInt32 ((Ray.origin[jy] - origins.min[jy]) * scale[jy]));
+            key |= local_spread_bits (Cell) << jy;
+            if (Ray.dir[jy] < 0.0) { key |= (1u << (27 + jy)); }
+         }
+
+         _state.order[ix].key = key;
+         _state.order[ix].index = ix;
+      }
+
+      if (count > PacketSize) {
+
+         local_radix_sort (_state.order, _state.sortTmp, count);
+      }
+
+      const IsectTestResultTypeEnum ResultType (Parameters.get_test_result_type ());
+
+      const HitModeEnum Mode (
+         ResultType == IsectClosestPoint ? ClosestHit :
+            (ResultType == IsectFirstPoint ? AnyHit : AllHits));
+
+      const Int32 JobCount ((count + RaysPerJob - 1) / RaysPerJob);
+      _state.reserve_lists (JobCount);
+
+      IsectQueue queue (Mode, IsectMask, _state.rays, _state.order, count, _state.lists);
+
+      if (HasTriangles) {
+
+         queue.TriangleNodes = _state.triangleTree.nodes;
+         queue.Triangles = _state.triangles;
+      }
+
+      if (HasBounds) {
+
+         queue.BoundsNodes = _state.boundsTree.nodes;
+         queue.BoundsOrder = _state.boundsTree.order;
+         queue.BoundsList = _state.boundsList;
+      }
+
+      Int32 threads (count / MinTestsPerThread);
+      if (threads > _state.threadCount) { threads = _state.threadCount; }
+      if (threads > JobCount) { threads = JobCount; }
+
+      const Int32 WorkerCount (threads - 1);
+
+      IsectWorker worker (queue);
+
+      for (Int32 ix = 0; ix < WorkerCount; ix++) { _state.pool.add_task (worker); }
+
+      queue.run_jobs ();
+
+      if (WorkerCount > 0) { _state.pool.wait (); }
+
+      const Boolean FindNormal (Parameters.get_calculate_normal ());
+      const Boolean FindHandle (Parameters.get_calculate_object_handle ());
+      const Boolean FindDistance (Parameters.get_calculate_distance ());
+      const Boolean FindCullMode (Parameters.get_calculate_cull_mode ());
+
+      for (Int32 ix = 0; ix < JobCount; ix++) {
+
+         const HitListStruct &List (_state.lists[ix]);
+
+         for (Int32 jy = 0; jy < List.count; jy++) {
+
+            const HitStruct &Hit (List.hits[jy]);
+
+            IsectResult result (Hit.testID);
+
+            result.set_point (Vector (Hit.point[0], Hit.point[1], Hit.point[2]));
+
+            if (FindNormal) {
+
+               result.set_normal (Vector (Hit.normal[0], Hit.normal[1], Hit.normal[2]));
+            }
+
+            if (FindHandle) { result.set_object_handle (Hit.objectHandle); }
+            if (FindDistance) { result.set_distance (Hit.distance); }
+            if (FindCullMode) { result.set_cull_mode (Hit.cullMode); }
+
+            resultContainer.add_result (result);
+         }
+      }
+   }
+
+   return resultContainer.get_result_count () > 0;
+}
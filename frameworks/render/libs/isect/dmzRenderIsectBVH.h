@@ -0,0 +1,61 @@
+#ifndef DMZ_RENDER_ISECT_BVH_DOT_H
+#define DMZ_RENDER_ISECT_BVH_DOT_H
+
+#include <dmzRenderIsectExport.h>
+#include <dmzTypesBase.h>
+
+namespace dmz {
+
+   class IsectParameters;
+   class IsectResultContainer;
+   class IsectTestContainer;
+   class Vector;
+
+   class DMZ_RENDER_ISECT_LINK_SYMBOL IsectBVH {
+
+      public:
+         IsectBVH ();
+         ~IsectBVH ();
+
+         void clear ();
+
+         void set_thread_count (const Int32 Count);
+         Int32 get_thread_count () const;
+
+         Int32 add_triangle (
+            const Vector &Point1,
+            const Vector &Point2,
+            const Vector &Point3,
+            const UInt32 IsectMask,
+            const UInt32 CullMode);
+
+         Int32 get_triangle_count () const;
+         void clear_triangles ();
+
+         Boolean store_bounds (
+            const Handle ObjectHandle,
+            const Vector &Min,
+            const Vector &Max,
+            const UInt32 IsectMask);
+
+         Boolean enable_bounds (const Handle ObjectHandle, const Boolean Value);
+         Boolean remove_bounds (const Handle ObjectHandle);
+         Int32 get_bounds_count () const;
+
+         Boolean do_isect (
+            const IsectParameters &Parameters,
+            const IsectTestContainer &TestValues,
+            const UInt32 IsectMask,
+            IsectResultContainer &resultContainer);
+
+      protected:
+         struct State;
+         State &_state; //!< Internal state.
+
+      private:
+         IsectBVH (const IsectBVH &);
+         IsectBVH &operator= (const IsectBVH &);
+   };
+};
+
+#endif // DMZ_RENDER_ISECT_BVH_DOT_H
@@ -0,0 +1,511 @@
+#include <dmzRenderIsectHeightField.h>
+#include <dmzSystemFile.h>
+#include <dmzTypesString.h>
+#include <dmzTypesVector.h>
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+using namespace dmz;
+
+namespace {
+
+static const Int32 TileShift = 6;
+static const Int32 TileSize = 1 << TileShift;
+static const Int32 TileMask = TileSize - 1;
+static const Int32 TileSamples = TileSize * TileSize;
+
+static Int32
+local_sample_size (const IsectHeightFormatEnum Format) {
+
+   return Format == IsectHeightUInt8 ? 1 : (Format == IsectHeightUInt16 ? 2 : 4);
+}
+
+};
+
+
+/*!
+
+\class dmz::IsectHeightField
+\ingroup Render
+\brief Regular grid of terrain heights.
+\details Columns run along the X axis and rows run along the Z axis. The height of a
+sample is added to the Y value of the origin. Heights between samples are bilinearly
+interpolated so a lookup only reads the four surrounding samples.
+\n
+Samples are stored in square tiles. When the heights come from a raw file, a tile is
+read from the file the first time it is used so only the parts of a large terrain that
+are visited are kept in memory.
+
+*/
+
+struct dmz::IsectHeightField::State {
+
+   Float64 originX;
+   Float64 originY;
+   Float64 originZ;
+   Int32 columns;
+   Int32 rows;
+   Float64 intervalX;
+   Float64 intervalZ;
+   Float64 maxX;
+   Float64 maxZ;
+
+   Int32 tileColumns;
+   Int32 tileRows;
+   Float32 **tiles;
+   Int32 loadedCount;
+
+   FILE *file;
+   IsectHeightFormatEnum format;
+   Int32 sampleSize;
+   Float64 min;
+   Float64 scale;
+   unsigned char *buffer;
+
+   State () :
+         originX (0.0),
+         originY (0.0),
+         originZ (0.0),
+         columns (0),
+         rows (0),
+         intervalX (1.0),
+         intervalZ (1.0),
+         maxX (0.0),
+         maxZ (0.0),
+         tileColumns (0),
+         tileRows (0),
+         tiles (0),
+         loadedCount (0),
+         file (0),
+         format (IsectHeightFloat32),
+         sampleSize (4),
+         min (0.0),
+         scale (1.0),
+         buffer (0) {;}
+
+   ~State () { clear (); }
+
+   void clear () {
+
+      clear_tiles ();
+      close ();
+      if (tiles) { delete []tiles; tiles = 0; }
+      columns = rows = tileColumns = tileRows = 0;
+   }
+
+   void clear_tiles () {
+
+      const Int32 Count (tileColumns * tileRows);
+
+      for (Int32 ix = 0; ix < Count; ix++) {
+
+         if (tiles[ix]) { delete []tiles[ix]; tiles[ix] = 0; }
+      }
+
+      loadedCount = 0;
+   }
+
+   void close () {
+
+      if (file) { close_file (file); file = 0; }
+      if (buffer) { delete []buffer; buffer = 0; }
+   }
+
+   Float32 *lookup_tile (const Int32 Column, const Int32 Row, const Boolean Create);
+   void load_tile (Float32 *tile, const Int32 TileColumn, const Int32 TileRow);
+
+   Float32 get_sample (const Int32 Column, const Int32 Row) {
+
+      Float32 *tile (
+         tiles[((Row >> TileShift) * tileColumns) + (Column >> TileShift)]);
+
+      if (!tile) { tile = lookup_tile (Column, Row, False); }
+
+      return tile ? tile[((Row & TileMask) << TileShift) + (Column & TileMask)] : 0.0f;
+   }
+
+   Boolean get_point (
+      const Float64 X,
+      const Float64 Z,
+      Vector &point,
+      Vector &normal);
+};
+
+
+Float32 *
+dmz::IsectHeightField::State::lookup_tile (
+      const Int32 Column,
+      const Int32 Row,
+      const Boolean Create) {
+
+   const Int32 TileColumn (Column >> TileShift);
+   const Int32 TileRow (Row >> TileShift);
+
+   Float32 *&tile (tiles[(TileRow * tileColumns) + TileColumn]);
+
+   if (!tile && (file || Create)) {
+
+      tile = new Float32[TileSamples];
+      memset (tile, 0, sizeof (Float32) * TileSamples);
+      loadedCount++;
+
+      if (file) { load_tile (tile, TileColumn, TileRow); }
+   }
+
+   return tile;
+}
+
+
+void
+dmz::IsectHeightField::State::load_tile (
+      Float32 *tile,
+      const Int32 TileColumn,
+      const Int32 TileRow) {
+
+   const Int32 StartColumn (TileColumn << TileShift);
+   const Int32 StartRow (TileRow << TileShift);
+   const Int32 ColumnCount (
+      (StartColumn + TileSize) > columns ? columns - StartColumn : TileSize);
+   const Int32 RowCount ((StartRow + TileSize) > rows ? rows - StartRow : TileSize);
+
+   for (Int32 row = 0; row < RowCount; row++) {
+
+      const long Offset = long (
+         ((Int64 (StartRow + row) * Int64 (columns)) + Int64 (StartColumn)) *
+            Int64 (sampleSize));
+
+      const Int32 Size (ColumnCount * sampleSize);
+
+      if (fseek (file, Offset, SEEK_SET) ||
+            (read_file (file, Size, (char *)buffer) != Size)) { break; }
+
+      Float32 *samples (tile + (row << TileShift));
+
+      // Raw files are little endian.
+      for (Int32 ix = 0; ix < ColumnCount; ix++) {
+
+         const unsigned char *Data (buffer + (ix * sampleSize));
+
+         if (format == IsectHeightUInt8) {
+
+            samples[ix] = Float32 (min + (Float64 (Data[0]) * scale));
+         }
+         else if (format == IsectHeightUInt16) {
+
+            const UInt32 Value (UInt32 (Data[0]) | (UInt32 (Data[1]) << 8));
+            samples[ix] = Float32 (min + (Float64 (Value) * scale));
+         }
+         else {
+
+            const UInt32 Value (
+               UInt32 (Data[0]) | (UInt32 (Data[1]) << 8) |
+               (UInt32 (Data[2]) << 16) | (UInt32 (Data[3]) << 24));
+
+            Float32 height (0.0f);
+            memcpy (&height, &Value, sizeof (Float32));
+            samples[ix] = height;
+         }
+      }
+   }
+}
+
+
+dmz::Boolean
+dmz::IsectHeightField::State::get_point (
+      const Float64 X,
+      const Float64 Z,
+      Vector &point,
+      Vector &normal) {
+
+   Boolean result (False);
+
+   const Float64 GridX ((X - originX) / intervalX);
+   const Float64 GridZ ((Z - originZ) / intervalZ);
+
+   if ((GridX >= 0.0) && (GridZ >= 0.0) && (GridX <= maxX) && (GridZ <= maxZ)) {
+
+      Int32 column = Int32 (GridX);
+      Int32 row = Int32 (GridZ);
+
+      if (column > (columns - 2)) { column = columns - 2; }
+      if (row > (rows - 2)) { row = rows - 2; }
+
+      const Float64 U (GridX - Float64 (column));
+      const Float64 V (GridZ - Float64 (row));
+
+      const Float64 H00 (get_sample (column, row));
+      const Float64 H10 (get_sample (column + 1, row));
+      const Float64 H01 (get_sample (column, row + 1));
+      const Float64 H11 (get_sample (column + 1, row + 1));
+
+      const Float64 Bottom (H00 + ((H10 - H00) * U));
+      const Float64 Top (H01 + ((H11 - H01) * U));
+
+      const Float64 SlopeX ((((H10 - H00) * (1.0 - V)) + ((H11 - H01) * V)) / intervalX);
+      const Float64 SlopeZ ((Top - Bottom) / intervalZ);
+
+      point.set_xyz (X, originY + Bottom + ((Top - Bottom) * V), Z);
+      normal.set_xyz (-SlopeX, 1.0, -SlopeZ);
+      normal.normalize_in_place ();
+
+      result = True;
+   }
+
+   return result;
+}
+
+
+//! Constructor.
+dmz::IsectHeightField::IsectHeightField () : _state (*(new State)) {;}
+
+
+//! Destructor.
+dmz::IsectHeightField::~IsectHeightField () { delete &_state; }
+
+
+//! Removes the grid and closes the raw file.
+void
+dmz::IsectHeightField::clear () { _state.clear (); }
+
+
+/*!
+
+\brief Creates an empty grid.
+\details All heights are zero until they are set or loaded.
+\param[in] Origin Position of the first sample.
+\param[in] Columns Number of samples along the X axis.
+\param[in] Rows Number of samples along the Z axis.
+\param[in] IntervalX Distance between samples along the X axis.
+\param[in] IntervalZ Distance between samples along the Z axis.
+\return Returns dmz::True if the grid has at least two samples along each axis and the
+intervals are positive.
+
+*/
+dmz::Boolean
+dmz::IsectHeightField::create (
+      const Vector &Origin,
+      const Int32 Columns,
+      const Int32 Rows,
+      const Float64 IntervalX,
+      const Float64 IntervalZ) {
+
+   Boolean result (False);
+
+   _state.clear ();
+
+   if ((Columns > 1) && (Rows > 1) && (IntervalX > 0.0) && (IntervalZ > 0.0)) {
+
+      _state.originX = Origin.get_x ();
+      _state.originY = Origin.get_y ();
+      _state.originZ = Origin.get_z ();
+      _state.columns = Columns;
+      _state.rows = Rows;
+      _state.intervalX = IntervalX;
+      _state.intervalZ = IntervalZ;
+      _state.maxX = Float64 (Columns - 1);
+      _state.maxZ = Float64 (Rows - 1);
+      _state.tileColumns = (Columns + TileMask) >> TileShift;
+      _state.tileRows = (Rows + TileMask) >> TileShift;
+
+      const Int32 Count (_state.tileColumns * _state.tileRows);
+
+      _state.tiles = new Float32 *[Count];
+      memset (_state.tiles, 0, sizeof (Float32 *) * Count);
+
+      result = True;
+   }
+
+   return result;
+}
+
+
+/*!
+
+\brief Uses a raw file for the heights of the grid.
+\details The file contains the rows of the grid one after the other with no header.
+Samples are little endian. Integer samples are scaled so zero is \a Min and the largest
+value is \a Max. Tiles are read from the file when first used and the file stays open
+until the grid is cleared. Heights that were already set are discarded.
+\param[in] FileName Name of the raw file.
+\param[in] Format Format of the samples.
+\param[in] Min Height of the smallest integer sample.
+\param[in] Max Height of the largest integer sample.
+\return Returns dmz::True if the file is large enough for the grid created
+by dmz::IsectHeightField::create.
+
+*/
+dmz::Boolean
+dmz::IsectHeightField::load_raw (
+      const String &FileName,
+      const IsectHeightFormatEnum Format,
+      const Float64 Min,
+      const Float64 Max) {
+
+   Boolean result (False);
+
+   if (_state.tiles) {
+
+      _state.clear_tiles ();
+      _state.close ();
+
+      const Int32 SampleSize (local_sample_size (Format));
+      const UInt64 Size (
+         UInt64 (_state.columns) * UInt64 (_state.rows) * UInt64 (SampleSize));
+
+      if (get_file_size (FileName) >= Size) { _state.file = open_file (FileName, "rb"); }
+
+      if (_state.file) {
+
+         _state.format = Format;
+         _state.sampleSize = SampleSize;
+         _state.min = Min;
+         _state.scale = Format == IsectHeightUInt8 ? (Max - Min) / 255.0 :
+            (Format == IsectHeightUInt16 ? (Max - Min) / 65535.0 : 1.0);
+
+         _state.buffer = new unsigned char[TileSize * SampleSize];
+
+         result = True;
+      }
+   }
+
+   return result;
+}
+
+
+//! Returns the number of samples along the X axis.
+dmz::Int32
+dmz::IsectHeightField::get_column_count () const { return _state.columns; }
+
+
+//! Returns the number of samples along the Z axis.
+dmz::Int32
+dmz::IsectHeightField::get_row_count () const { return _state.rows; }
+
+
+//! Returns the number of tiles in the grid.
+dmz::Int32
+dmz::IsectHeightField::get_tile_count () const {
+
+   return _state.tileColumns * _state.tileRows;
+}
+
+
+//! Returns the number of tiles held in memory.
+dmz::Int32
+dmz::IsectHeightField::get_loaded_tile_count () const { return _state.loadedCount; }
+
+
+/*!
+
+\brief Sets the height of a sample.
+\param[in] Column Column of the sample.
+\param[in] Row Row of the sample.
+\param[in] Value Height of the sample relative to the origin.
+\return Returns dmz::True if the sample is in the grid.
+
+*/
+dmz::Boolean
+dmz::IsectHeightField::set_height (
+      const Int32 Column,
+      const Int32 Row,
+      const Float64 Value) {
+
+   Boolean result (False);
+
+   if ((Column >= 0) && (Row >= 0) && (Column < _state.columns) && (Row < _state.rows)) {
+
+      Float32 *tile (_state.lookup_tile (Column, Row, True));
+
+      tile[((Row & TileMask) << TileShift) + (Column & TileMask)] = Float32 (Value);
+
+      result = True;
+   }
+
+   return result;
+}
+
+
+//! Returns the height of a sample relative to the origin.
+dmz::Float64
+dmz::IsectHeightField::get_height (const Int32 Column, const Int32 Row) const {
+
+   return ((Column >= 0) && (Row >= 0) &&
+         (Column < _state.columns) && (Row < _state.rows)) ?
+      Float64 (_state.get_sample (Column, Row)) : 0.0;
+}
+
+
+//! Returns dmz::True if the X and Z values of \a Value are inside the grid.
+dmz::Boolean
+dmz::IsectHeightField::contains (const Vector &Value) const {
+
+   const Float64 GridX ((Value.get_x () - _state.originX) / _state.intervalX);
+   const Float64 GridZ ((Value.get_z () - _state.originZ) / _state.intervalZ);
+
+   return (_state.tiles && (GridX >= 0.0) && (GridZ >= 0.0) &&
+      (GridX <= _state.maxX) && (GridZ <= _state.maxZ)) ? True : False;
+}
+
+
+/*!
+
+\brief Finds the terrain point below or above a position.
+\param[in] Value Position to look up. Only the X and Z values are used.
+\param[out] point Point on the terrain with the same X and Z values as \a Value.
+\param[out] normal Normal of the terrain at \a point.
+\return Returns dmz::True if \a Value is inside the grid.
+
+*/
+dmz::Boolean
+dmz::IsectHeightField::get_point (
+      const Vector &Value,
+      Vector &point,
+      Vector &normal) const {
+
+   return _state.tiles ?
+      _state.get_point (Value.get_x (), Value.get_z (), point, normal) : False;
+}
+
+
+/*!
+
+\brief Finds the terrain points for a batch of positions.
+\details Positions outside of the grid leave \a points and \a normals unchanged.
+\param[in] Count Number of positions.
+\param[in] Values Array of positions to look up.
+\param[out] points Array the terrain points are written to.
+\param[out] normals Array the terrain normals are written to.
+\param[out] found Optional array set to dmz::True for each position inside the grid.
+\return Returns the number of positions inside the grid.
+
+*/
+dmz::Int32
+dmz::IsectHeightField::get_points (
+      const Int32 Count,
+      const Vector *Values,
+      Vector *points,
+      Vector *normals,
+      Boolean *found) const {
+
+   Int32 result (0);
+
+   if (Values && points && normals) {
+
+      for (Int32 ix = 0; ix < Count; ix++) {
+
+         const Boolean Found (_state.tiles ?
+            _state.get_point (
+               Values[ix].get_x (),
+               Values[ix].get_z (),
+               points[ix],
+               normals[ix]) : False);
+
+         if (Found) { result++; }
+         if (found) { found[ix] = Found; }
+      }
+   }
+
+   return result;
+}
@@ -0,0 +1,75 @@
+#ifndef DMZ_RENDER_ISECT_HEIGHT_FIELD_DOT_H
+#define DMZ_RENDER_ISECT_HEIGHT_FIELD_DOT_H
+
+#include <dmzRenderIsectExport.h>
+#include <dmzTypesBase.h>
+
+namespace dmz {
+
+   //! \addtogroup Render
+   //! @{
+
+   //! \brief Sample format of a raw height field file.
+   enum IsectHeightFormatEnum {
+
+      IsectHeightUInt8, //!< Unsigned 8 bit samples scaled between a min and max.
+      IsectHeightUInt16, //!< Unsigned 16 bit samples scaled between a min and max.
+      IsectHeightFloat32, //!< 32 bit float samples.
+   };
+
+   //! @}
+
+   class String;
+   class Vector;
+
+   class DMZ_RENDER_ISECT_LINK_SYMBOL IsectHeightField {
+
+      public:
+         IsectHeightField ();
+         ~IsectHeightField ();
+
+         void clear ();
+
+         Boolean create (
+            const Vector &Origin,
+            const Int32 Columns,
+            const Int32 Rows,
+            const Float64 IntervalX,
+            const Float64 IntervalZ);
+
+         Boolean load_raw (
+            const String &FileName,
+            const IsectHeightFormatEnum Format,
+            const Float64 Min,
+            const Float64 Max);
+
+         Int32 get_column_count () const;
+         Int32 get_row_count () const;
+         Int32 get_tile_count () const;
+         Int32 get_loaded_tile_count () const;
+
+         Boolean set_height (const Int32 Column, const Int32 Row, const Float64 Value);
+         Float64 get_height (const Int32 Column, const Int32 Row) const;
+
+         Boolean contains (const Vector &Value) const;
+
+         Boolean get_point (const Vector &Value, Vector &point, Vector &normal) const;
+
+         Int32 get_points (
+            const Int32 Count,
+            const Vector *Values,
+            Vector *points,
+            Vector *normals,
+            Boolean *found) const;
+
+      protected:
+         struct State;
+         State &_state; //!< Internal state.
+
+      private:
+         IsectHeightField (const IsectHeightField &);
+         IsectHeightField &operator= (const IsectHeightField &);
+   };
+};
+
+#endif // DMZ_RENDER_ISECT_HEIGHT_FIELD_DOT_H
@@ -0,0 +1,726 @@
+#include <dmzRenderClusterIndex.h>
+#include <dmzTypesHandleContainer.h>
+#include <dmzTypesHashTableHandleTemplate.h>
+#include <dmzTypesHashTableUInt64Template.h>
+
+#include <math.h>
+
+namespace {
+
+static const dmz::Float64 DefaultCellSize = 1.0;
+static const dmz::Int32 DefaultMinClusterCount = 4;
+
+// Keeps cell coordinates inside the range of an Int32.
+static const dmz::Float64 MaxCell = 1073741824.0;
+
+struct CellStruct;
+struct ClusterStruct;
+
+struct ObjectStruct {
+
+   const dmz::Handle ObjectHandle;
+   dmz::Float64 x;
+   dmz::Float64 y;
+   CellStruct *cell;
+   ObjectStruct *next;
+   ObjectStruct *prev;
+   dmz::UInt32 visit;
+   ClusterStruct *cluster;
+   dmz::Boolean shown;
+   ObjectStruct *shownNext;
+   ObjectStruct *shownPrev;
+
+   ObjectStruct (const dmz::Handle TheHandle) :
+         ObjectHandle (TheHandle),
+         x (0.0),
+         y (0.0),
+         cell (0),
+         next (0),
+         prev (0),
+         visit (0),
+         cluster (0),
+         shown (dmz::False),
+         shownNext (0),
+         shownPrev (0) {;}
+};
+
+struct CellStruct {
+
+   const dmz::UInt64 Key;
+   const dmz::Int32 X;
+   const dmz::Int32 Y;
+   ObjectStruct *list;
+
+   CellStruct (const dmz::UInt64 TheKey, const dmz::Int32 TheX, const dmz::Int32 TheY) :
+         Key (TheKey),
+         X (TheX),
+         Y (TheY),
+         list (0) {;}
+};
+
+struct ClusterStruct {
+
+   const dmz::UInt64 Key;
+   dmz::UInt32 visit;
+   dmz::Int32 count;
+   dmz::Float64 sumX;
+   dmz::Float64 sumY;
+   dmz::Int32 shownCount;
+   dmz::Float64 shownX;
+   dmz::Float64 shownY;
+
+   ClusterStruct (const dmz::UInt64 TheKey) :
+         Key (TheKey),
+         visit (0),
+         count (0),
+         sumX (0.0),
+         sumY (0.0),
+         shownCount (0),
+         shownX (0.0),
+         shownY (0.0) {;}
+};
+
+template <class T> struct ArrayStruct {
+
+   T *data;
+   dmz::Int32 count;
+   dmz::Int32 capacity;
+
+   ArrayStruct () : data (0), count (0), capacity (0) {;}
+   ~ArrayStruct () { if (data) { delete []data; data = 0; } }
+
+   void add (const T &Value) {
+
+      if (count >= capacity) {
+
+         capacity = capacity ? capacity * 2 : 64;
+
+         T *list (new T[capacity]);
+
+         for (dmz::Int32 ix = 0; ix < count; ix++) { list[ix] = data[ix]; }
+
+         if (data) { delete []data; }
+         data = list;
+      }
+
+      data[count] = Value;
+      count++;
+   }
+};
+
+
+static inline dmz::Int32
+local_to_cell (const dmz::Float64 Value, const dmz::Float64 CellSize) {
+
+   dmz::Float64 result = floor (Value / CellSize);
+
+   if (result > MaxCell) { result = MaxCell; }
+   else if (result < -MaxCell) { result = -MaxCell; }
+
+   return dmz::Int32 (result);
+}
+
+
+static inline dmz::UInt64
+local_to_key (const dmz::Int32 X, const dmz::Int32 Y) {
+
+   return (dmz::UInt64 (dmz::UInt32 (X)) << 32) | dmz::UInt64 (dmz::UInt32 (Y));
+}
+
+};
+
+
+/*!
+
+\class dmz::RenderClusterIndex
+\ingroup Render
+\brief Two dimensional spatial index that culls and clusters objects to a view.
+\details Objects are stored in a uniform grid of square cells so that a view only
+visits the cells it overlaps. dmz::RenderClusterIndex::update_view finds the objects
+inside the view and, when a cluster size is given, groups them into square cluster
+cells anchored at the origin. Cluster cells holding at least the minimum cluster count
+of objects become clusters and their objects are not shown. The index remembers which
+objects were shown by the previous view and only reports the objects whose state
+changed, so a display only needs to add and remove the items that crossed the edge of
+the view or joined or left a cluster.
+
+*/
+
+struct dmz::RenderClusterIndex::State {
+
+   Float64 cellSize;
+   Int32 minCount;
+   HashTableHandleTemplate<ObjectStruct> objTable;
+   HashTableUInt64Template<CellStruct> cellTable;
+   HashTableUInt64Template<ClusterStruct> clusterTable;
+   Float64 clusterSize;
+   UInt32 visit;
+   ObjectStruct *shownList;
+   Int32 shownCount;
+   Int32 visibleCount;
+   ArrayStruct<ObjectStruct *> visible;
+   ArrayStruct<ClusterStruct *> clusters;
+   ArrayStruct<Handle> shownBuffer;
+   ArrayStruct<Handle> hiddenBuffer;
+
+   State () :
+         cellSize (DefaultCellSize),
+         minCount (DefaultMinClusterCount),
+         clusterSize (0.0),
+         visit (0),
+         shownList (0),
+         shownCount (0),
+         visibleCount (0) {;}
+
+   ~State () { clear (); }
+
+   void clear () {
+
+      visible.count = 0;
+      clusters.count = 0;
+      shownList = 0;
+      shownCount = 0;
+      visibleCount = 0;
+      objTable.empty ();
+      cellTable.empty ();
+      clusterTable.empty ();
+   }
+
+   void unlink (ObjectStruct &obj) {
+
+      CellStruct *cell (obj.cell);
+
+      if (cell) {
+
+         if (obj.prev) { obj.prev->next = obj.next; }
+         else { cell->list = obj.next; }
+
+         if (obj.next) { obj.next->prev = obj.prev; }
+
+         obj.next = obj.prev = 0;
+         obj.cell = 0;
+
+         if (!cell->list) {
+
+            if (cellTable.remove (cell->Key)) { delete cell; cell = 0; }
+         }
+      }
+   }
+
+   void link (ObjectStruct &obj) {
+
+      const Int32 X (local_to_cell (obj.x, cellSize));
+      const Int32 Y (local_to_cell (obj.y, cellSize));
+
+      if (!obj.cell || (obj.cell->X != X) || (obj.cell->Y != Y)) {
+
+         unlink (obj);
+
+         const UInt64 Key (local_to_key (X, Y));
+
+         CellStruct *cell (cellTable.lookup (Key));
+
+         if (!cell) {
+
+            cell = new CellStruct (Key, X, Y);
+
+            if (!cellTable.store (Key, cell)) { delete cell; cell = 0; }
+         }
+
+         if (cell) {
+
+            obj.next = cell->list;
+            if (cell->list) { cell->list->prev = &obj; }
+            cell->list = &obj;
+            obj.cell = cell;
+         }
+      }
+   }
+
+   void show (ObjectStruct &obj) {
+
+      if (!obj.shown) {
+
+         obj.shown = True;
+         obj.shownPrev = 0;
+         obj.shownNext = shownList;
+         if (shownList) { shownList->shownPrev = &obj; }
+         shownList = &obj;
+         shownCount++;
+      }
+   }
+
+   void hide (ObjectStruct &obj) {
+
+      if (obj.shown) {
+
+         if (obj.shownPrev) { obj.shownPrev->shownNext = obj.shownNext; }
+         else { shownList = obj.shownNext; }
+
+         if (obj.shownNext) { obj.shownNext->shownPrev = obj.shownPrev; }
+
+         obj.shownNext = obj.shownPrev = 0;
+         obj.shown = False;
+         shownCount--;
+      }
+   }
+
+   void visit_cell (
+         const CellStruct *Cell,
+         const Float64 MinX,
+         const Float64 MinY,
+         const Float64 MaxX,
+         const Float64 MaxY,
+         const Boolean Cluster) {
+
+      ObjectStruct *obj (Cell ? Cell->list : 0);
+
+      while (obj) {
+
+         if ((obj->x >= MinX) && (obj->x <= MaxX) &&
+               (obj->y >= MinY) && (obj->y <= MaxY)) {
+
+            obj->visit = visit;
+            obj->cluster = Cluster ? get_cluster (*obj) : 0;
+            visible.add (obj);
+         }
+
+         obj = obj->next;
+      }
+   }
+
+   ClusterStruct *get_cluster (const ObjectStruct &Obj) {
+
+      const UInt64 Key (local_to_key (
+         local_to_cell (Obj.x, clusterSize),
+         local_to_cell (Obj.y, clusterSize)));
+
+      ClusterStruct *cs (clusterTable.lookup (Key));
+
+      if (!cs) {
+
+         cs = new ClusterStruct (Key);
+
+         if (!clusterTable.store (Key, cs)) { delete cs; cs = 0; }
+      }
+
+      if (cs) {
+
+         if (cs->visit != visit) {
+
+            cs->visit = visit;
+            cs->count = 0;
+            cs->sumX = cs->sumY = 0.0;
+         }
+
+         cs->count++;
+         cs->sumX += Obj.x;
+         cs->sumY += Obj.y;
+      }
+
+      return cs;
+   }
+
+   Boolean use_cell_range (
+         const Int32 MinX,
+         const Int32 MinY,
+         const Int32 MaxX,
+         const Int32 MaxY) const {
+
+      // Walking the stored cells is cheaper when the view covers more cells than
+      // are in use.
+      const Float64 Width (Float64 (MaxX) - Float64 (MinX) + 1.0);
+      const Float64 Height (Float64 (MaxY) - Float64 (MinY) + 1.0);
+
+      return (Width * Height) <= Float64 (cellTable.get_count ());
+   }
+};
+
+
+//! Constructor.
+dmz::RenderClusterIndex::RenderClusterIndex () : _state (*(new State)) {;}
+
+
+//! Destructor.
+dmz::RenderClusterIndex::~RenderClusterIndex () { delete &_state; }
+
+
+/*!
+
+\brief Sets the size of the grid cells.
+\details All objects are moved into the new grid. Sizes that are not greater than
+zero are ignored. The cell size should be close to the smallest view size so that
+views at high zoom only visit a few cells.
+\param[in] Size Length of the side of a cell.
+
+*/
+void
+dmz::RenderClusterIndex::set_cell_size (const Float64 Size) {
+
+   if ((Size > 0.0) && (Size != _state.cellSize)) {
+
+      _state.cellSize = Size;
+
+      HashTableHandleIterator it;
+      ObjectStruct *obj (0);
+
+      while (_state.objTable.get_next (it, obj)) { _state.unlink (*obj); }
+
+      it.reset ();
+
+      while (_state.objTable.get_next (it, obj)) { _state.link (*obj); }
+   }
+}
+
+
+//! Returns the size of the grid cells.
+dmz::Float64
+dmz::RenderClusterIndex::get_cell_size () const { return _state.cellSize; }
+
+
+/*!
+
+\brief Sets the number of objects a cluster cell needs to become a cluster.
+\details Counts smaller than two are ignored. The new count is used by the next call
+to dmz::RenderClusterIndex::update_view.
+
+*/
+void
+dmz::RenderClusterIndex::set_min_cluster_count (const Int32 Count) {
+
+   if (Count > 1) { _state.minCount = Count; }
+}
+
+
+//! Returns the number of objects a cluster cell needs to become a cluster.
+dmz::Int32
+dmz::RenderClusterIndex::get_min_cluster_count () const { return _state.minCount; }
+
+
+//! Removes all objects and clusters.
+void
+dmz::RenderClusterIndex::clear () { _state.clear (); }
+
+
+/*!
+
+\brief Adds or moves an object.
+\details The object is shown or hidden by the next call to
+dmz::RenderClusterIndex::update_view.
+\param[in] ObjectHandle Handle of the object.
+\param[in] X Position of the object along the first axis.
+\param[in] Y Position of the object along the second axis.
+\return Returns dmz::True if the object is stored in the index.
+
+*/
+dmz::Boolean
+dmz::RenderClusterIndex::update_object (
+      const Handle ObjectHandle,
+      const Float64 X,
+      const Float64 Y) {
+
+   Boolean result (False);
+
+   if (ObjectHandle) {
+
+      ObjectStruct *obj (_state.objTable.lookup (ObjectHandle));
+
+      if (!obj) {
+
+         obj = new ObjectStruct (ObjectHandle);
+
+         if (!_state.objTable.store (ObjectHandle, obj)) { delete obj; obj = 0; }
+      }
+
+      if (obj) {
+
+         obj->x = X;
+         obj->y = Y;
+         _state.link (*obj);
+         result = True;
+      }
+   }
+
+   return result;
+}
+
+
+/*!
+
+\brief Removes an object.
+\details The object is not reported as hidden. The clusters include the object until
+the next call to dmz::RenderClusterIndex::update_view.
+\param[in] ObjectHandle Handle of the object.
+\return Returns dmz::True if the object was in the index.
+
+*/
+dmz::Boolean
+dmz::RenderClusterIndex::remove_object (const Handle ObjectHandle) {
+
+   ObjectStruct *obj (_state.objTable.remove (ObjectHandle));
+
+   if (obj) {
+
+      if (obj->visit == _state.visit) { _state.visibleCount--; }
+
+      _state.hide (*obj);
+      _state.unlink (*obj);
+      delete obj; obj = 0;
+      return True;
+   }
+
+   return False;
+}
+
+
+//! Looks up the position of an object. Returns dmz::False if it is not in the index.
+dmz::Boolean
+dmz::RenderClusterIndex::lookup_object (
+      const Handle ObjectHandle,
+      Float64 &x,
+      Float64 &y) const {
+
+   Boolean result (False);
+
+   ObjectStruct *obj (_state.objTable.lookup (ObjectHandle));
+
+   if (obj) { x = obj->x; y = obj->y; result = True; }
+
+   return result;
+}
+
+
+//! Returns the number of objects in the index.
+dmz::Int32
+dmz::RenderClusterIndex::get_object_count () const {
+
+   return _state.objTable.get_count ();
+}
+
+
+/*!
+
+\brief Culls and clusters the objects to a view.
+\details Objects inside the view that are not part of a cluster are shown. Clusters
+are only formed from objects inside the view.
+\param[in] MinX Minimum of the view along the first axis.
+\param[in] MinY Minimum of the view along the second axis.
+\param[in] MaxX Maximum of the view along the first axis.
+\param[in] MaxY Maximum of the view along the second axis.
+\param[in] ClusterSize Length of the side of a cluster cell. Clustering is disabled
+if it is not greater than zero.
+\param[out] shown HandleContainer set to the objects that are shown by this view and
+were not shown by the previous view.
+\param[out] hidden HandleContainer set to the objects that were shown by the previous
+view and are not shown by this view.
+\return Returns dmz::True if any object or cluster changed since the previous view.
+
+*/
+dmz::Boolean
+dmz::RenderClusterIndex::update_view (
+      const Float64 MinX,
+      const Float64 MinY,
+      const Float64 MaxX,
+      const Float64 MaxY,
+      const Float64 ClusterSize,
+      HandleContainer &shown,
+      HandleContainer &hidden) {
+
+   Boolean result (False);
+
+   const Boolean Cluster (ClusterSize > 0.0);
+
+   if (ClusterSize != _state.clusterSize) {
+
+      if (_state.clusters.count > 0) { result = True; }
+
+      _state.clusters.count = 0;
+      _state.clusterTable.empty ();
+      _state.clusterSize = ClusterSize;
+   }
+
+   _state.visit++;
+   _state.visible.count = 0;
+
+   if ((MinX <= MaxX) && (MinY <= MaxY)) {
+
+      const Int32 CellMinX (local_to_cell (MinX, _state.cellSize));
+      const Int32 CellMinY (local_to_cell (MinY, _state.cellSize));
+      const Int32 CellMaxX (local_to_cell (MaxX, _state.cellSize));
+      const Int32 CellMaxY (local_to_cell (MaxY, _state.cellSize));
+
+      if (_state.use_cell_range (CellMinX, CellMinY, CellMaxX, CellMaxY)) {
+
+         for (Int32 cx = CellMinX; cx <= CellMaxX; cx++) {
+
+            for (Int32 cy = CellMinY; cy <= CellMaxY; cy++) {
+
+               _state.visit_cell (
+                  _state.cellTable.lookup (local_to_key (cx, cy)),
+                  MinX, MinY, MaxX, MaxY, Cluster);
+            }
+         }
+      }
+      else {
+
+         HashTableUInt64Iterator it;
+         CellStruct *cell (_state.cellTable.get_next (it));
+
+         while (cell) {
+
+            if ((cell->X >= CellMinX) && (cell->X <= CellMaxX) &&
+                  (cell->Y >= CellMinY) && (cell->Y <= CellMaxY)) {
+
+               _state.visit_cell (cell, MinX, MinY, MaxX, MaxY, Cluster);
+            }
+
+            cell = _state.cellTable.get_next (it);
+         }
+      }
+   }
+
+   _state.clusters.count = 0;
+
+   HashTableUInt64Iterator clusterIt;
+   ClusterStruct *cs (_state.clusterTable.get_next (clusterIt));
+
+   while (cs) {
+
+      if (cs->visit != _state.visit) {
+
+         if (cs->shownCount > 0) { result = True; }
+
+         if (_state.clusterTable.remove (clusterIt.get_hash_key ())) { delete cs; }
+      }
+      else if (cs->count >= _state.minCount) {
+
+         const Float64 X (cs->sumX / Float64 (cs->count));
+         const Float64 Y (cs->sumY / Float64 (cs->count));
+
+         if ((cs->shownCount != cs->count) || (cs->shownX != X) || (cs->shownY != Y)) {
+
+            cs->shownCount = cs->count;
+            cs->shownX = X;
+            cs->shownY = Y;
+            result = True;
+         }
+
+         _state.clusters.add (cs);
+      }
+      else if (cs->shownCount > 0) {
+
+         cs->shownCount = 0;
+         result = True;
+      }
+
+      cs = _state.clusterTable.get_next (clusterIt);
+   }
+
+   _state.shownBuffer.count = 0;
+   _state.hiddenBuffer.count = 0;
+
+   for (Int32 ix = 0; ix < _state.visible.count; ix++) {
+
+      ObjectStruct *obj (_state.visible.data[ix]);
+
+      const Boolean Show (!obj->cluster || (obj->cluster->count < _state.minCount));
+
+      if (Show && !obj->shown) {
+
+         _state.show (*obj);
+         _state.shownBuffer.add (obj->ObjectHandle);
+      }
+      else if (!Show && obj->shown) {
+
+         _state.hide (*obj);
+         _state.hiddenBuffer.add (obj->ObjectHandle);
+      }
+   }
+
+   // Objects shown by the previous view that were not visited have left the view.
+   ObjectStruct *obj (_state.shownList);
+
+   while (obj) {
+
+      ObjectStruct *next (obj->shownNext);
+
+      if (obj->visit != _state.visit) {
+
+         _state.hide (*obj);
+         _state.hiddenBuffer.add (obj->ObjectHandle);
+      }
+
+      obj = next;
+   }
+
+   _state.visibleCount = _state.visible.count;
+
+   shown.clear ();
+   hidden.clear ();
+
+   shown.add (_state.shownBuffer.data, _state.shownBuffer.count);
+   hidden.add (_state.hiddenBuffer.data, _state.hiddenBuffer.count);
+
+   if (_state.shownBuffer.count || _state.hiddenBuffer.count) { result = True; }
+
+   return result;
+}
+
+
+//! Returns dmz::True if the object is shown by the current view.
+dmz::Boolean
+dmz::RenderClusterIndex::is_shown (const Handle ObjectHandle) const {
+
+   ObjectStruct *obj (_state.objTable.lookup (ObjectHandle));
+
+   return obj ? obj->shown : False;
+}
+
+
+//! Returns the number of objects shown by the current view.
+dmz::Int32
+dmz::RenderClusterIndex::get_shown_count () const { return _state.shownCount; }
+
+
+//! Returns the number of objects inside the current view including clustered objects.
+dmz::Int32
+dmz::RenderClusterIndex::get_visible_count () const { return _state.visibleCount; }
+
+
+//! Returns the number of clusters in the current view.
+dmz::Int32
+dmz::RenderClusterIndex::get_cluster_count () const { return _state.clusters.count; }
+
+
+/*!
+
+\brief Looks up a cluster in the current view.
+\param[in] Index Index of the cluster. Must be less than the value returned by
+dmz::RenderClusterIndex::get_cluster_count.
+\param[out] x Mean position of the cluster's objects along the first axis.
+\param[out] y Mean position of the cluster's objects along the second axis.
+\param[out] count Number of objects in the cluster.
+\return Returns dmz::True if \a Index is valid.
+
+*/
+dmz::Boolean
+dmz::RenderClusterIndex::get_cluster (
+      const Int32 Index,
+      Float64 &x,
+      Float64 &y,
+      Int32 &count) const {
+
+   Boolean result (False);
+
+   if ((Index >= 0) && (Index < _state.clusters.count)) {
+
+      const ClusterStruct *Cs (_state.clusters.data[Index]);
+
+      x = Cs->shownX;
+      y = Cs->shownY;
+      count = Cs->shownCount;
+      result = True;
+   }
+
+   return result;
+}
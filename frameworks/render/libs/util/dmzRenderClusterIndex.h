@@ -0,0 +1,70 @@
+#ifndef DMZ_RENDER_CLUSTER_INDEX_DOT_H
+#define DMZ_RENDER_CLUSTER_INDEX_DOT_H
+
+#include <dmzRenderUtilExport.h>
+#include <dmzTypesBase.h>
+
+namespace dmz {
+
+   class HandleContainer;
+
+   class DMZ_RENDER_UTIL_LINK_SYMBOL RenderClusterIndex {
+
+      public:
+         RenderClusterIndex ();
+         ~RenderClusterIndex ();
+
+         void set_cell_size (const Float64 Size);
+         Float64 get_cell_size () const;
+
+         void set_min_cluster_count (const Int32 Count);
+         Int32 get_min_cluster_count () const;
+
+         void clear ();
+
+         Boolean update_object (
+            const Handle ObjectHandle,
+            const Float64 X,
+            const Float64 Y);
+
+         Boolean remove_object (const Handle ObjectHandle);
+
+         Boolean lookup_object (
+            const Handle ObjectHandle,
+            Float64 &x,
+            Float64 &y) const;
+
+         Int32 get_object_count () const;
+
+         Boolean update_view (
+            const Float64 MinX,
+            const Float64 MinY,
+            const Float64 MaxX,
+            const Float64 MaxY,
+            const Float64 ClusterSize,
+            HandleContainer &shown,
+            HandleContainer &hidden);
+
+         Boolean is_shown (const Handle ObjectHandle) const;
+         Int32 get_shown_count () const;
+         Int32 get_visible_count () const;
+
+         Int32 get_cluster_count () const;
+
+         Boolean get_cluster (
+            const Int32 Index,
+            Float64 &x,
+            Float64 &y,
+            Int32 &count) const;
+
+      protected:
+         struct State;
+         State &_state; //!< Internal state.
+
+      private:
+         RenderClusterIndex (const RenderClusterIndex &);
+         RenderClusterIndex &operator= (const RenderClusterIndex &);
+   };
+};
+
+#endif // DMZ_RENDER_CLUSTER_INDEX_DOT_H
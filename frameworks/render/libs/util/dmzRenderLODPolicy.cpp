@@ -0,0 +1,236 @@
+#include <dmzRenderLODPolicy.h>
+#include <dmzTypesMath.h>
+#include <dmzTypesVector.h>
+
+#include <math.h>
+
+namespace {
+
+static const dmz::Float64 DefaultFieldOfView = 60.0;
+
+struct LevelStruct {
+
+   dmz::Float64 distance;
+   dmz::Float64 screenSize;
+   dmz::Float64 interval;
+};
+
+};
+
+
+/*!
+
+\class dmz::RenderLODPolicy
+\ingroup Render
+\brief Selects a level of detail and transform update rate for rendered objects.
+\details Level zero is the full detail level and is updated every time the object
+changes. Each level added with dmz::RenderLODPolicy::add_level is coarser than the
+previous level. An object uses the coarsest level whose distance it is beyond or whose
+screen size it is smaller than. The screen size is the fraction of the view's vertical
+extent covered by the object's bounding sphere so the policy does not depend on the
+size of the window.
+
+*/
+
+struct dmz::RenderLODPolicy::State {
+
+   LevelStruct *levels;
+   Int32 count;
+   Vector viewPos;
+   Float64 tanHalfFov;
+   UInt64 skipped;
+
+   State () : levels (0), count (0), tanHalfFov (0.0), skipped (0) {
+
+      tanHalfFov = tan (to_radians (DefaultFieldOfView) * 0.5);
+   }
+
+   ~State () { if (levels) { delete []levels; levels = 0; } }
+};
+
+
+//! Constructor.
+dmz::RenderLODPolicy::RenderLODPolicy () : _state (*(new State)) {;}
+
+
+//! Destructor.
+dmz::RenderLODPolicy::~RenderLODPolicy () { delete &_state; }
+
+
+//! Removes all levels except the full detail level.
+void
+dmz::RenderLODPolicy::clear_levels () {
+
+   if (_state.levels) { delete []_state.levels; _state.levels = 0; }
+   _state.count = 0;
+}
+
+
+/*!
+
+\brief Adds a coarser level.
+\param[in] Distance Distance from the view at which the level starts. Ignored if
+not greater than zero.
+\param[in] ScreenSize Screen size below which the level starts. Ignored if not greater
+than zero.
+\param[in] UpdateInterval Minimum time in seconds between transform updates of objects
+at the level.
+\return Returns the number of the new level. Returns zero if both \a Distance and
+\a ScreenSize are ignored.
+
+*/
+dmz::Int32
+dmz::RenderLODPolicy::add_level (
+      const Float64 Distance,
+      const Float64 ScreenSize,
+      const Float64 UpdateInterval) {
+
+   Int32 result (0);
+
+   if ((Distance > 0.0) || (ScreenSize > 0.0)) {
+
+      LevelStruct *list (new LevelStruct[_state.count + 1]);
+
+      for (Int32 ix = 0; ix < _state.count; ix++) { list[ix] = _state.levels[ix]; }
+
+      list[_state.count].distance = Distance;
+      list[_state.count].screenSize = ScreenSize;
+      list[_state.count].interval = UpdateInterval;
+
+      if (_state.levels) { delete []_state.levels; }
+      _state.levels = list;
+      _state.count++;
+
+      result = _state.count;
+   }
+
+   return result;
+}
+
+
+//! Returns the number of levels including the full detail level.
+dmz::Int32
+dmz::RenderLODPolicy::get_level_count () const { return _state.count + 1; }
+
+
+//! Returns the minimum time in seconds between transform updates at \a Level.
+dmz::Float64
+dmz::RenderLODPolicy::get_update_interval (const Int32 Level) const {
+
+   return ((Level > 0) && (Level <= _state.count)) ?
+      _state.levels[Level - 1].interval : 0.0;
+}
+
+
+/*!
+
+\brief Sets the view used to measure objects.
+\param[in] Position Position of the view.
+\param[in] FieldOfView Vertical field of view in degrees.
+
+*/
+void
+dmz::RenderLODPolicy::set_view (const Vector &Position, const Float64 FieldOfView) {
+
+   _state.viewPos = Position;
+   _state.tanHalfFov = tan (to_radians (
+      FieldOfView > 0.0 ? FieldOfView : DefaultFieldOfView) * 0.5);
+}
+
+
+/*!
+
+\brief Returns the fraction of the view's vertical extent covered by an object.
+\param[in] Position Position of the object.
+\param[in] Radius Radius of the object's bounding sphere.
+\return Returns the screen size of the object. Objects that contain the view have a
+screen size of one.
+
+*/
+dmz::Float64
+dmz::RenderLODPolicy::get_screen_size (
+      const Vector &Position,
+      const Float64 Radius) const {
+
+   Float64 result (1.0);
+
+   const Float64 Distance ((Position - _state.viewPos).magnitude ());
+
+   if ((Distance > Radius) && !is_zero64 (_state.tanHalfFov)) {
+
+      result = Radius / (Distance * _state.tanHalfFov);
+   }
+
+   return result;
+}
+
+
+/*!
+
+\brief Finds the level of an object.
+\param[in] Position Position of the object.
+\param[in] Radius Radius of the object's bounding sphere.
+\return Returns the level of the object.
+
+*/
+dmz::Int32
+dmz::RenderLODPolicy::find_level (const Vector &Position, const Float64 Radius) const {
+
+   Int32 result (0);
+
+   if (_state.count > 0) {
+
+      const Float64 Distance ((Position - _state.viewPos).magnitude ());
+      const Float64 ScreenSize (get_screen_size (Position, Radius));
+
+      for (Int32 ix = _state.count - 1; (ix >= 0) && !result; ix--) {
+
+         const LevelStruct &Level (_state.levels[ix]);
+
+         if (((Level.distance > 0.0) && (Distance >= Level.distance)) ||
+               ((Level.screenSize > 0.0) && (ScreenSize < Level.screenSize))) {
+
+            result = ix + 1;
+         }
+      }
+   }
+
+   return result;
+}
+
+
+/*!
+
+\brief Tests if an object at a level should have its transform updated.
+\details Updates that are not due are counted as skipped.
+\param[in] Level Level of the object.
+\param[in] LastUpdateTime Time of the object's last transform update.
+\param[in] CurrentTime Current time.
+\return Returns dmz::True if the update interval of \a Level has elapsed.
+
+*/
+dmz::Boolean
+dmz::RenderLODPolicy::is_update_due (
+      const Int32 Level,
+      const Float64 LastUpdateTime,
+      const Float64 CurrentTime) {
+
+   const Float64 Interval (get_update_interval (Level));
+
+   const Boolean Result (
+      (Interval <= 0.0) || ((CurrentTime - LastUpdateTime) >= Interval));
+
+   if (!Result) { _state.skipped++; }
+
+   return Result;
+}
+
+
+//! Returns the number of updates that were not due.
+dmz::UInt64
+dmz::RenderLODPolicy::get_skipped_count () const { return _state.skipped; }
+
+
+//! Resets the skipped update count.
+void
+dmz::RenderLODPolicy::reset_skipped_count () { _state.skipped = 0; }
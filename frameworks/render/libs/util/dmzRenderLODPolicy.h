@@ -0,0 +1,50 @@
+#ifndef DMZ_RENDER_LOD_POLICY_DOT_H
+#define DMZ_RENDER_LOD_POLICY_DOT_H
+
+#include <dmzRenderUtilExport.h>
+#include <dmzTypesBase.h>
+
+namespace dmz {
+
+   class Vector;
+
+   class DMZ_RENDER_UTIL_LINK_SYMBOL RenderLODPolicy {
+
+      public:
+         RenderLODPolicy ();
+         ~RenderLODPolicy ();
+
+         void clear_levels ();
+
+         Int32 add_level (
+            const Float64 Distance,
+            const Float64 ScreenSize,
+            const Float64 UpdateInterval);
+
+         Int32 get_level_count () const;
+         Float64 get_update_interval (const Int32 Level) const;
+
+         void set_view (const Vector &Position, const Float64 FieldOfView);
+
+         Float64 get_screen_size (const Vector &Position, const Float64 Radius) const;
+         Int32 find_level (const Vector &Position, const Float64 Radius) const;
+
+         Boolean is_update_due (
+            const Int32 Level,
+            const Float64 LastUpdateTime,
+            const Float64 CurrentTime);
+
+         UInt64 get_skipped_count () const;
+         void reset_skipped_count ();
+
+      protected:
+         struct State;
+         State &_state; //!< Internal state.
+
+      private:
+         RenderLODPolicy (const RenderLODPolicy &);
+         RenderLODPolicy &operator= (const RenderLODPolicy &);
+   };
+};
+
+#endif // DMZ_RENDER_LOD_POLICY_DOT_H
@@ -0,0 +1,475 @@
+#include <dmzRenderPickIndex.h>
+#include <dmzTypesHandleContainer.h>
+#include <dmzTypesHashTableHandleTemplate.h>
+#include <dmzTypesHashTableUInt64Template.h>
+
+#include <math.h>
+
+namespace {
+
+static const dmz::Float64 DefaultCellSize = 1.0;
+
+// Keeps cell coordinates inside the range of an Int32.
+static const dmz::Float64 MaxCell = 1073741824.0;
+
+struct CellStruct;
+
+struct ObjectStruct {
+
+   const dmz::Handle ObjectHandle;
+   dmz::Float64 x;
+   dmz::Float64 y;
+   CellStruct *cell;
+   ObjectStruct *next;
+   ObjectStruct *prev;
+
+   ObjectStruct (const dmz::Handle TheHandle) :
+         ObjectHandle (TheHandle),
+         x (0.0),
+         y (0.0),
+         cell (0),
+         next (0),
+         prev (0) {;}
+};
+
+struct CellStruct {
+
+   const dmz::UInt64 Key;
+   const dmz::Int32 X;
+   const dmz::Int32 Y;
+   ObjectStruct *list;
+
+   CellStruct (const dmz::UInt64 TheKey, const dmz::Int32 TheX, const dmz::Int32 TheY) :
+         Key (TheKey),
+         X (TheX),
+         Y (TheY),
+         list (0) {;}
+};
+
+
+static inline dmz::Int32
+local_to_cell (const dmz::Float64 Value, const dmz::Float64 CellSize) {
+
+   dmz::Float64 result = floor (Value / CellSize);
+
+   if (result > MaxCell) { result = MaxCell; }
+   else if (result < -MaxCell) { result = -MaxCell; }
+
+   return dmz::Int32 (result);
+}
+
+
+static inline dmz::UInt64
+local_to_key (const dmz::Int32 X, const dmz::Int32 Y) {
+
+   return (dmz::UInt64 (dmz::UInt32 (X)) << 32) | dmz::UInt64 (dmz::UInt32 (Y));
+}
+
+
+static inline dmz::Boolean
+local_is_cell_inside (
+      const CellStruct &Cell,
+      const dmz::Int32 MinX,
+      const dmz::Int32 MinY,
+      const dmz::Int32 MaxX,
+      const dmz::Int32 MaxY) {
+
+   return (Cell.X >= MinX) && (Cell.X <= MaxX) && (Cell.Y >= MinY) && (Cell.Y <= MaxY);
+}
+
+
+static void
+local_find_nearest (
+      const CellStruct *Cell,
+      const dmz::Float64 X,
+      const dmz::Float64 Y,
+      dmz::Float64 &best,
+      dmz::Handle &result) {
+
+   ObjectStruct *obj (Cell ? Cell->list : 0);
+
+   while (obj) {
+
+      const dmz::Float64 Dx (obj->x - X);
+      const dmz::Float64 Dy (obj->y - Y);
+      const dmz::Float64 Dist2 ((Dx * Dx) + (Dy * Dy));
+
+      if (Dist2 <= best) { best = Dist2; result = obj->ObjectHandle; }
+
+      obj = obj->next;
+   }
+}
+
+
+static dmz::Int32
+local_find_in_box (
+      const CellStruct *Cell,
+      const dmz::Float64 MinX,
+      const dmz::Float64 MinY,
+      const dmz::Float64 MaxX,
+      const dmz::Float64 MaxY,
+      dmz::HandleContainer &list) {
+
+   dmz::Int32 result (0);
+
+   ObjectStruct *obj (Cell ? Cell->list : 0);
+
+   while (obj) {
+
+      if ((obj->x >= MinX) && (obj->x <= MaxX) &&
+            (obj->y >= MinY) && (obj->y <= MaxY) &&
+            list.add (obj->ObjectHandle)) { result++; }
+
+      obj = obj->next;
+   }
+
+   return result;
+}
+
+};
+
+
+/*!
+
+\class dmz::RenderPickIndex
+\ingroup Render
+\brief Two dimensional spatial index of pickable objects.
+\details Objects are stored in a uniform grid of square cells so that nearest object
+and box queries only visit the cells that overlap the query. Moving an object inside
+its cell only updates its coordinates so the index may be kept current from every
+object position update. The cell size should be close to the pick tolerance in the
+units of the index.
+
+*/
+
+struct dmz::RenderPickIndex::State {
+
+   Float64 cellSize;
+   HashTableHandleTemplate<ObjectStruct> objTable;
+   HashTableUInt64Template<CellStruct> cellTable;
+
+   State () : cellSize (DefaultCellSize) {;}
+
+   ~State () { objTable.empty (); cellTable.empty (); }
+
+   void unlink (ObjectStruct &obj) {
+
+      CellStruct *cell (obj.cell);
+
+      if (cell) {
+
+         if (obj.prev) { obj.prev->next = obj.next; }
+         else { cell->list = obj.next; }
+
+         if (obj.next) { obj.next->prev = obj.prev; }
+
+         obj.next = obj.prev = 0;
+         obj.cell = 0;
+
+         if (!cell->list) {
+
+            if (cellTable.remove (cell->Key)) { delete cell; cell = 0; }
+         }
+      }
+   }
+
+   void link (ObjectStruct &obj) {
+
+      const Int32 X (local_to_cell (obj.x, cellSize));
+      const Int32 Y (local_to_cell (obj.y, cellSize));
+
+      if (!obj.cell || (obj.cell->X != X) || (obj.cell->Y != Y)) {
+
+         unlink (obj);
+
+         const UInt64 Key (local_to_key (X, Y));
+
+         CellStruct *cell (cellTable.lookup (Key));
+
+         if (!cell) {
+
+            cell = new CellStruct (Key, X, Y);
+
+            if (!cellTable.store (Key, cell)) { delete cell; cell = 0; }
+         }
+
+         if (cell) {
+
+            obj.next = cell->list;
+            if (cell->list) { cell->list->prev = &obj; }
+            cell->list = &obj;
+            obj.cell = cell;
+         }
+      }
+   }
+
+   Boolean use_cell_range (
+         const Int32 MinX,
+         const Int32 MinY,
+         const Int32 MaxX,
+         const Int32 MaxY) const {
+
+      // Walking the stored cells is cheaper when the query covers more cells than
+      // are in use.
+      const Float64 Width (Float64 (MaxX) - Float64 (MinX) + 1.0);
+      const Float64 Height (Float64 (MaxY) - Float64 (MinY) + 1.0);
+
+      return (Width * Height) <= Float64 (cellTable.get_count ());
+   }
+};
+
+
+//! Constructor.
+dmz::RenderPickIndex::RenderPickIndex () : _state (*(new State)) {;}
+
+
+//! Destructor.
+dmz::RenderPickIndex::~RenderPickIndex () { delete &_state; }
+
+
+/*!
+
+\brief Sets the size of the grid cells.
+\details All objects are moved into the new grid. Sizes that are not greater than
+zero are ignored.
+\param[in] Size Length of the side of a cell.
+
+*/
+void
+dmz::RenderPickIndex::set_cell_size (const Float64 Size) {
+
+   if ((Size > 0.0) && (Size != _state.cellSize)) {
+
+      _state.cellSize = Size;
+
+      HashTableHandleIterator it;
+      ObjectStruct *obj (0);
+
+      while (_state.objTable.get_next (it, obj)) { _state.unlink (*obj); }
+
+      it.reset ();
+
+      while (_state.objTable.get_next (it, obj)) { _state.link (*obj); }
+   }
+}
+
+
+//! Returns the size of the grid cells.
+dmz::Float64
+dmz::RenderPickIndex::get_cell_size () const { return _state.cellSize; }
+
+
+//! Removes all objects.
+void
+dmz::RenderPickIndex::clear () {
+
+   _state.objTable.empty ();
+   _state.cellTable.empty ();
+}
+
+
+/*!
+
+\brief Adds or moves an object.
+\param[in] ObjectHandle Handle of the object.
+\param[in] X Position of the object along the first axis.
+\param[in] Y Position of the object along the second axis.
+\return Returns dmz::True if the object is stored in the index.
+
+*/
+dmz::Boolean
+dmz::RenderPickIndex::update_object (
+      const Handle ObjectHandle,
+      const Float64 X,
+      const Float64 Y) {
+
+   Boolean result (False);
+
+   if (ObjectHandle) {
+
+      ObjectStruct *obj (_state.objTable.lookup (ObjectHandle));
+
+      if (!obj) {
+
+         obj = new ObjectStruct (ObjectHandle);
+
+         if (!_state.objTable.store (ObjectHandle, obj)) { delete obj; obj = 0; }
+      }
+
+      if (obj) {
+
+         obj->x = X;
+         obj->y = Y;
+         _state.link (*obj);
+         result = True;
+      }
+   }
+
+   return result;
+}
+
+
+//! Removes an object. Returns dmz::True if the object was in the index.
+dmz::Boolean
+dmz::RenderPickIndex::remove_object (const Handle ObjectHandle) {
+
+   ObjectStruct *obj (_state.objTable.remove (ObjectHandle));
+
+   if (obj) {
+
+      _state.unlink (*obj);
+      delete obj; obj = 0;
+      return True;
+   }
+
+   return False;
+}
+
+
+//! Looks up the position of an object. Returns dmz::False if it is not in the index.
+dmz::Boolean
+dmz::RenderPickIndex::lookup_object (
+      const Handle ObjectHandle,
+      Float64 &x,
+      Float64 &y) const {
+
+   Boolean result (False);
+
+   ObjectStruct *obj (_state.objTable.lookup (ObjectHandle));
+
+   if (obj) { x = obj->x; y = obj->y; result = True; }
+
+   return result;
+}
+
+
+//! Returns the number of objects in the index.
+dmz::Int32
+dmz::RenderPickIndex::get_object_count () const { return _state.objTable.get_count (); }
+
+
+//! Returns the number of grid cells that contain objects.
+dmz::Int32
+dmz::RenderPickIndex::get_cell_count () const { return _state.cellTable.get_count (); }
+
+
+/*!
+
+\brief Finds the object nearest to a point.
+\param[in] X Position of the point along the first axis.
+\param[in] Y Position of the point along the second axis.
+\param[in] MaxDistance Objects further from the point are ignored.
+\return Returns the handle of the nearest object. Returns zero if no object is
+within \a MaxDistance.
+
+*/
+dmz::Handle
+dmz::RenderPickIndex::find_nearest (
+      const Float64 X,
+      const Float64 Y,
+      const Float64 MaxDistance) const {
+
+   Handle result (0);
+
+   if (MaxDistance >= 0.0) {
+
+      const Int32 MinX (local_to_cell (X - MaxDistance, _state.cellSize));
+      const Int32 MinY (local_to_cell (Y - MaxDistance, _state.cellSize));
+      const Int32 MaxX (local_to_cell (X + MaxDistance, _state.cellSize));
+      const Int32 MaxY (local_to_cell (Y + MaxDistance, _state.cellSize));
+
+      Float64 best (MaxDistance * MaxDistance);
+
+      if (_state.use_cell_range (MinX, MinY, MaxX, MaxY)) {
+
+         for (Int32 cx = MinX; cx <= MaxX; cx++) {
+
+            for (Int32 cy = MinY; cy <= MaxY; cy++) {
+
+               local_find_nearest (
+                  _state.cellTable.lookup (local_to_key (cx, cy)), X, Y, best, result);
+            }
+         }
+      }
+      else {
+
+         HashTableUInt64Iterator it;
+         CellStruct *cell (_state.cellTable.get_next (it));
+
+         while (cell) {
+
+            if (local_is_cell_inside (*cell, MinX, MinY, MaxX, MaxY)) {
+
+               local_find_nearest (cell, X, Y, best, result);
+            }
+
+            cell = _state.cellTable.get_next (it);
+         }
+      }
+   }
+
+   return result;
+}
+
+
+/*!
+
+\brief Finds the objects inside a box.
+\param[in] MinX Minimum of the box along the first axis.
+\param[in] MinY Minimum of the box along the second axis.
+\param[in] MaxX Maximum of the box along the first axis.
+\param[in] MaxY Maximum of the box along the second axis.
+\param[out] list HandleContainer the handles of the objects inside the box are
+added to.
+\return Returns the number of objects found.
+
+*/
+dmz::Int32
+dmz::RenderPickIndex::find_in_box (
+      const Float64 MinX,
+      const Float64 MinY,
+      const Float64 MaxX,
+      const Float64 MaxY,
+      HandleContainer &list) const {
+
+   Int32 result (0);
+
+   if ((MinX <= MaxX) && (MinY <= MaxY)) {
+
+      const Int32 MinCX (local_to_cell (MinX, _state.cellSize));
+      const Int32 MinCY (local_to_cell (MinY, _state.cellSize));
+      const Int32 MaxCX (local_to_cell (MaxX, _state.cellSize));
+      const Int32 MaxCY (local_to_cell (MaxY, _state.cellSize));
+
+      if (_state.use_cell_range (MinCX, MinCY, MaxCX, MaxCY)) {
+
+         for (Int32 cx = MinCX; cx <= MaxCX; cx++) {
+
+            for (Int32 cy = MinCY; cy <= MaxCY; cy++) {
+
+               result += local_find_in_box (
+                  _state.cellTable.lookup (local_to_key (cx, cy)),
+                  MinX, MinY, MaxX, MaxY,
+                  list);
+            }
+         }
+      }
+      else {
+
+         HashTableUInt64Iterator it;
+         CellStruct *cell (_state.cellTable.get_next (it));
+
+         while (cell) {
+
+            if (local_is_cell_inside (*cell, MinCX, MinCY, MaxCX, MaxCY)) {
+
+               result += local_find_in_box (cell, MinX, MinY, MaxX, MaxY, list);
+            }
+
+            cell = _state.cellTable.get_next (it);
+         }
+      }
+   }
+
+   return result;
+}
@@ -0,0 +1,59 @@
+#ifndef DMZ_RENDER_PICK_INDEX_DOT_H
+#define DMZ_RENDER_PICK_INDEX_DOT_H
+
+#include <dmzRenderUtilExport.h>
+#include <dmzTypesBase.h>
+
+namespace dmz {
+
+   class HandleContainer;
+
+   class DMZ_RENDER_UTIL_LINK_SYMBOL RenderPickIndex {
+
+      public:
+         RenderPickIndex ();
+         ~RenderPickIndex ();
+
+         void set_cell_size (const Float64 Size);
+         Float64 get_cell_size () const;
+
+         void clear ();
+
+         Boolean update_object (
+            const Handle ObjectHandle,
+            const Float64 X,
+            const Float64 Y);
+
+         Boolean remove_object (const Handle ObjectHandle);
+
+         Boolean lookup_object (
+            const Handle ObjectHandle,
+            Float64 &x,
+            Float64 &y) const;
+
+         Int32 get_object_count () const;
+         Int32 get_cell_count () const;
+
+         Handle find_nearest (
+            const Float64 X,
+            const Float64 Y,
+            const Float64 MaxDistance) const;
+
+         Int32 find_in_box (
+            const Float64 MinX,
+            const Float64 MinY,
+            const Float64 MaxX,
+            const Float64 MaxY,
+            HandleContainer &list) const;
+
+      protected:
+         struct State;
+         State &_state; //!< Internal state.
+
+      private:
+         RenderPickIndex (const RenderPickIndex &);
+         RenderPickIndex &operator= (const RenderPickIndex &);
+   };
+};
+
+#endif // DMZ_RENDER_PICK_INDEX_DOT_H
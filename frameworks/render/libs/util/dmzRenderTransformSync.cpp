@@ -0,0 +1,351 @@
+#include <dmzRenderTransformSync.h>
+#include <dmzSystemMutex.h>
+#include <dmzSystemThread.h>
+#include <dmzSystemThreadPool.h>
+#include <dmzTypesMatrix.h>
+#include <dmzTypesVector.h>
+
+#include <string.h>
+
+#if defined (__SSE2__) || defined (_M_X64) || (defined (_M_IX86_FP) && (_M_IX86_FP >= 2))
+#   define DMZ_RENDER_TRANSFORM_SYNC_SSE2
+#   include <emmintrin.h>
+#endif
+
+using namespace dmz;
+
+namespace {
+
+// Each entry stores the three scaled rows of the render matrix, the three row scales
+// and the translation, already in render axis order.
+static const Int32 SourceSize = 15;
+static const Int32 MatrixSize = 16;
+static const Int32 EntriesPerJob = 4096;
+static const Int32 MinEntriesPerThread = 16384;
+
+static void
+local_compose (
+      const Float64 *Source,
+      const Int32 First,
+      const Int32 Last,
+      Float64 *target) {
+
+   Source += First * SourceSize;
+   target += First * MatrixSize;
+
+   for (Int32 ix = First; ix < Last; ix++) {
+
+#ifdef DMZ_RENDER_TRANSFORM_SYNC_SSE2
+      for (Int32 row = 0; row < 3; row++) {
+
+         const Float64 *Axis (Source + (row * 3));
+         const Float64 Scale (Source[9 + row]);
+         Float64 *out (target + (row * 4));
+
+         _mm_storeu_pd (out, _mm_mul_pd (_mm_loadu_pd (Axis), _mm_set1_pd (Scale)));
+         _mm_storeu_pd (out + 2, _mm_set_pd (0.0, Axis[2] * Scale));
+      }
+
+      _mm_storeu_pd (target + 12, _mm_loadu_pd (Source + 12));
+      _mm_storeu_pd (target + 14, _mm_set_pd (1.0, Source[14]));
+#else
+      for (Int32 row = 0; row < 3; row++) {
+
+         const Float64 *Axis (Source + (row * 3));
+         const Float64 Scale (Source[9 + row]);
+         Float64 *out (target + (row * 4));
+
+         out[0] = Axis[0] * Scale;
+         out[1] = Axis[1] * Scale;
+         out[2] = Axis[2] * Scale;
+         out[3] = 0.0;
+      }
+
+      target[12] = Source[12];
+      target[13] = Source[13];
+      target[14] = Source[14];
+      target[15] = 1.0;
+#endif
+
+      Source += SourceSize;
+      target += MatrixSize;
+   }
+}
+
+
+class ComposeQueue {
+
+   public:
+      const Float64 *Source;
+      Float64 *target;
+      const Int32 Count;
+      const Int32 JobCount;
+
+      ComposeQueue (const Float64 *TheSource, Float64 *theTarget, const Int32 TheCount) :
+            Source (TheSource),
+            target (theTarget),
+            Count (TheCount),
+            JobCount ((TheCount + EntriesPerJob - 1) / EntriesPerJob),
+            _next (0) {;}
+
+      void run_jobs () {
+
+         Int32 job (_get_next_job ());
+
+         while (job >= 0) {
+
+            const Int32 First (job * EntriesPerJob);
+            const Int32 Last (
+               (First + EntriesPerJob) < Count ? First + EntriesPerJob : Count);
+
+            local_compose (Source, First, Last, target);
+
+            job = _get_next_job ();
+         }
+      }
+
+   protected:
+      Int32 _get_next_job () {
+
+         Int32 result (-1);
+
+         _lock.lock ();
+            if (_next < JobCount) { result = _next; _next++; }
+         _lock.unlock ();
+
+         return result;
+      }
+
+      Mutex _lock;
+      Int32 _next;
+};
+
+
+class ComposeWorker : public ThreadFunction {
+
+   public:
+      ComposeWorker (ComposeQueue &queue) : _queue (queue) {;}
+
+      virtual ~ComposeWorker () {;}
+
+      virtual void run_thread_function () { _queue.run_jobs (); }
+
+   protected:
+      ComposeQueue &_queue;
+};
+
+};
+
+
+/*!
+
+\class dmz::RenderTransformSync
+\ingroup Render
+\brief Builds render transform matrices for a batch of objects.
+\details The orientation, position, and scale of each object are copied into a dense
+array with dmz::RenderTransformSync::add. dmz::RenderTransformSync::compose then builds
+all of the matrices in a single pass that uses SSE2 when available. Large batches are
+split across threads. The matrices use the same layout as the matrices returned by
+dmz::to_osg_matrix and may be passed directly to osg::Matrixd.
+
+*/
+
+struct dmz::RenderTransformSync::State {
+
+   Boolean zUp;
+   Int32 threadCount;
+   ThreadPool pool;
+   Int32 count;
+   Int32 capacity;
+   Int32 composed;
+   Float64 *source;
+   Float64 *matrices;
+
+   State () :
+         zUp (False),
+         threadCount (1),
+         count (0),
+         capacity (0),
+         composed (0),
+         source (0),
+         matrices (0) {;}
+
+   ~State () {
+
+      if (source) { delete []source; source = 0; }
+      if (matrices) { delete []matrices; matrices = 0; }
+   }
+
+   void grow () {
+
+      const Int32 Capacity (capacity ? capacity * 2 : 256);
+
+      Float64 *newSource (new Float64[Capacity * SourceSize]);
+      if (source) { memcpy (newSource, source, sizeof (Float64) * count * SourceSize); }
+      if (source) { delete []source; }
+      source = newSource;
+
+      if (matrices) { delete []matrices; }
+      matrices = new Float64[Capacity * MatrixSize];
+      composed = 0;
+
+      capacity = Capacity;
+   }
+};
+
+
+//! Constructor.
+dmz::RenderTransformSync::RenderTransformSync () : _state (*(new State)) {;}
+
+
+//! Destructor.
+dmz::RenderTransformSync::~RenderTransformSync () { delete &_state; }
+
+
+/*!
+
+\brief Selects the render axis convention.
+\details Should match the convention selected with dmz::set_osg_z_up or
+dmz::set_osg_y_up. Only affects objects added after the call.
+\param[in] Value Render matrices are Z up if dmz::True.
+
+*/
+void
+dmz::RenderTransformSync::set_z_up (const Boolean Value) { _state.zUp = Value; }
+
+
+//! Returns dmz::True if render matrices are Z up.
+dmz::Boolean
+dmz::RenderTransformSync::get_z_up () const { return _state.zUp; }
+
+
+/*!
+
+\brief Sets the maximum number of threads used to compose a batch.
+\details The calling thread is counted as one of the threads. The other threads are
+created here and are reused by every batch. Threads are only used when there are enough
+objects in the batch to make them worthwhile.
+\param[in] Count Maximum number of threads.
+
+*/
+void
+dmz::RenderTransformSync::set_thread_count (const Int32 Count) {
+
+   _state.threadCount = Count > 1 ? Count : 1;
+   _state.pool.set_thread_count (_state.threadCount - 1);
+}
+
+
+//! Returns the maximum number of threads used to compose a batch.
+dmz::Int32
+dmz::RenderTransformSync::get_thread_count () const { return _state.threadCount; }
+
+
+//! Removes all objects from the batch. Allocated memory is kept for the next batch.
+void
+dmz::RenderTransformSync::clear () { _state.count = _state.composed = 0; }
+
+
+/*!
+
+\brief Adds an object to the batch.
+\param[in] Ori Orientation of the object.
+\param[in] Pos Position of the object.
+\param[in] Scale Scale of the object.
+\return Returns the index of the object's matrix.
+
+*/
+dmz::Int32
+dmz::RenderTransformSync::add (
+      const Matrix &Ori,
+      const Vector &Pos,
+      const Vector &Scale) {
+
+   if (_state.count >= _state.capacity) { _state.grow (); }
+
+   Float64 data[9];
+   Ori.to_array (data);
+
+   Float64 *out (_state.source + (_state.count * SourceSize));
+
+   if (_state.zUp) {
+
+      out[0] = data[0]; out[1] = -data[6]; out[2] = data[3];
+      out[3] = -data[2]; out[4] = data[8]; out[5] = -data[5];
+      out[6] = data[1]; out[7] = -data[7]; out[8] = data[4];
+      out[9] = Scale.get_x (); out[10] = Scale.get_z (); out[11] = Scale.get_y ();
+      out[12] = Pos.get_x (); out[13] = -Pos.get_z (); out[14] = Pos.get_y ();
+   }
+   else {
+
+      out[0] = data[0]; out[1] = data[3]; out[2] = data[6];
+      out[3] = data[1]; out[4] = data[4]; out[5] = data[7];
+      out[6] = data[2]; out[7] = data[5]; out[8] = data[8];
+      out[9] = Scale.get_x (); out[10] = Scale.get_y (); out[11] = Scale.get_z ();
+      out[12] = Pos.get_x (); out[13] = Pos.get_y (); out[14] = Pos.get_z ();
+   }
+
+   const Int32 Result (_state.count);
+   _state.count++;
+
+   return Result;
+}
+
+
+//! Returns the number of objects in the batch.
+dmz::Int32
+dmz::RenderTransformSync::get_count () const { return _state.count; }
+
+
+/*!
+
+\brief Builds the matrices of all the objects in the batch.
+\return Returns the number of matrices built.
+
+*/
+dmz::Int32
+dmz::RenderTransformSync::compose () {
+
+   const Int32 Count (_state.count);
+
+   if (Count > 0) {
+
+      ComposeQueue queue (_state.source, _state.matrices, Count);
+
+      Int32 threads (Count / MinEntriesPerThread);
+      if (threads > _state.threadCount) { threads = _state.threadCount; }
+      if (threads > queue.JobCount) { threads = queue.JobCount; }
+
+      const Int32 WorkerCount (threads - 1);
+
+      ComposeWorker worker (queue);
+
+      for (Int32 ix = 0; ix < WorkerCount; ix++) { _state.pool.add_task (worker); }
+
+      queue.run_jobs ();
+
+      if (WorkerCount > 0) { _state.pool.wait (); }
+   }
+
+   _state.composed = Count;
+
+   return Count;
+}
+
+
+/*!
+
+\brief Returns the matrix of an object.
+\details The sixteen values are stored row by row with the translation in the last
+row, the layout used by osg::Matrixd.
+\param[in] Index Index returned by dmz::RenderTransformSync::add.
+\return Returns a pointer to the matrix. Returns NULL if \a Index is not valid or the
+batch has not been composed since the object was added.
+
+*/
+const dmz::Float64 *
+dmz::RenderTransformSync::get_matrix (const Int32 Index) const {
+
+   return ((Index >= 0) && (Index < _state.composed)) ?
+      _state.matrices + (Index * MatrixSize) : 0;
+}
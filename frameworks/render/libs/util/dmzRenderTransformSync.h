@@ -0,0 +1,43 @@
+#ifndef DMZ_RENDER_TRANSFORM_SYNC_DOT_H
+#define DMZ_RENDER_TRANSFORM_SYNC_DOT_H
+
+#include <dmzRenderUtilExport.h>
+#include <dmzTypesBase.h>
+
+namespace dmz {
+
+   class Matrix;
+   class Vector;
+
+   class DMZ_RENDER_UTIL_LINK_SYMBOL RenderTransformSync {
+
+      public:
+         RenderTransformSync ();
+         ~RenderTransformSync ();
+
+         void set_z_up (const Boolean Value);
+         Boolean get_z_up () const;
+
+         void set_thread_count (const Int32 Count);
+         Int32 get_thread_count () const;
+
+         void clear ();
+
+         Int32 add (const Matrix &Ori, const Vector &Pos, const Vector &Scale);
+         Int32 get_count () const;
+
+         Int32 compose ();
+
+         const Float64 *get_matrix (const Int32 Index) const;
+
+      protected:
+         struct State;
+         State &_state; //!< Internal state.
+
+      private:
+         RenderTransformSync (const RenderTransformSync &);
+         RenderTransformSync &operator= (const RenderTransformSync &);
+   };
+};
+
+#endif // DMZ_RENDER_TRANSFORM_SYNC_DOT_H
@@ -0,0 +1,409 @@
+#include <dmzObjectAttributeMasks.h>
+#include <dmzRenderConsts.h>
+#include <dmzRenderIsect.h>
+#include "dmzRenderModuleIsectBasic.h"
+#include <dmzRuntimeConfig.h>
+#include <dmzRuntimeConfigToTypesBase.h>
+#include <dmzRuntimeConfigToVector.h>
+#include <dmzRuntimeDefinitions.h>
+#include <dmzRuntimePluginFactoryLinkSymbol.h>
+#include <dmzRuntimePluginInfo.h>
+#include <dmzTypesHandleContainer.h>
+
+#include <math.h>
+
+namespace {
+
+static const dmz::UInt32 StaticMask = 0x01;
+static const dmz::UInt32 EntityMask = 0x02;
+
+static void
+local_add_box (
+      dmz::IsectBVH &bvh,
+      const dmz::Vector &Min,
+      const dmz::Vector &Max,
+      const dmz::UInt32 Mask) {
+
+   using namespace dmz;
+
+   Vector corners[8];
+
+   for (Int32 ix = 0; ix < 8; ix++) {
+
+      corners[ix].set_xyz (
+         (ix & 0x01) ? Max.get_x () : Min.get_x (),
+         (ix & 0x02) ? Max.get_y () : Min.get_y (),
+         (ix & 0x04) ? Max.get_z () : Min.get_z ());
+   }
+
+   // Two triangles per face wound so the normals point out of the box.
+   const Int32 Faces[6][4] = {
+      { 0, 4, 6, 2 }, { 1, 3, 7, 5 }, // -X, +X
+      { 0, 1, 5, 4 }, { 2, 6, 7, 3 }, // -Y, +Y
+      { 0, 2, 3, 1 }, { 4, 5, 7, 6 }, // -Z, +Z
+   };
+
+   for (Int32 ix = 0; ix < 6; ix++) {
+
+      const Int32 *Face (Faces[ix]);
+
+      bvh.add_triangle (
+         corners[Face[0]],
+         corners[Face[1]],
+         corners[Face[2]],
+         Mask,
+         IsectPolygonBackCulledMask);
+
+      bvh.add_triangle (
+         corners[Face[0]],
+         corners[Face[2]],
+         corners[Face[3]],
+         Mask,
+         IsectPolygonBackCulledMask);
+   }
+}
+
+};
+
+
+/*!
+
+\class dmz::RenderModuleIsectBasic
+\ingroup Render
+\brief Intersection module that does not require a render back end.
+\details Intersection tests are performed against static triangles defined in the
+module's config and the bounding boxes of objects whose type defines isect bounds. All
+the tests in an IsectTestContainer are processed together and large batches may be
+spread across threads. See dmz::IsectBVH.
+\code
+<dmz>
+<dmzRenderModuleIsectBasic>
+   <threads value="Maximum number of threads used for a batch of tests"/>
+   <static>
+      <triangle>
+         <vertex x="" y="" z=""/>
+         <vertex x="" y="" z=""/>
+         <vertex x="" y="" z=""/>
+      </triangle>
+      <box>
+         <min x="" y="" z=""/>
+         <max x="" y="" z=""/>
+      </box>
+   </static>
+</dmzRenderModuleIsectBasic>
+<runtime>
+   <object-type name="Type Name">
+      <render>
+         <isect>
+            <bounds>
+               <min x="" y="" z=""/>
+               <max x="" y="" z=""/>
+            </bounds>
+         </isect>
+      </render>
+   </object-type>
+</runtime>
+</dmz>
+\endcode
+The bounds of an object type are relative to the object's position and are rotated by
+the object's orientation.
+
+*/
+
+//! \cond
+dmz::RenderModuleIsectBasic::RenderModuleIsectBasic (
+      const PluginInfo &Info,
+      Config &local) :
+      Plugin (Info),
+      ObjectObserverUtil (Info, local),
+      RenderModuleIsect (Info),
+      _log (Info),
+      _defaultAttrHandle (0),
+      _staticAttrHandle (0),
+      _entityAttrHandle (0) {
+
+   _init (local);
+}
+
+
+dmz::RenderModuleIsectBasic::~RenderModuleIsectBasic () {
+
+   _objTable.empty ();
+   _defTable.empty ();
+}
+
+
+// RenderModuleIsect Interface
+dmz::Boolean
+dmz::RenderModuleIsectBasic::do_isect (
+      const IsectParameters &Parameters,
+      const IsectTestContainer &TestValues,
+      IsectResultContainer &resultContainer) {
+
+   UInt32 mask (StaticMask | EntityMask);
+
+   HandleContainer attrList;
+
+   if (Parameters.get_isect_attributes (attrList)) {
+
+      mask = 0;
+      if (attrList.contains (_staticAttrHandle)) { mask |= StaticMask; }
+      if (attrList.contains (_entityAttrHandle)) { mask |= EntityMask; }
+   }
+
+   return _bvh.do_isect (Parameters, TestValues, mask, resultContainer);
+}
+
+
+dmz::UInt32
+dmz::RenderModuleIsectBasic::enable_isect (const Handle ObjectHandle) {
+
+   UInt32 result (0);
+
+   ObjectStruct *os (_objTable.lookup (ObjectHandle));
+
+   if (os) {
+
+      if (os->disableCount > 0) { os->disableCount--; }
+      if (!os->disableCount) { _bvh.enable_bounds (ObjectHandle, True); }
+      result = UInt32 (os->disableCount);
+   }
+
+   return result;
+}
+
+
+dmz::UInt32
+dmz::RenderModuleIsectBasic::disable_isect (const Handle ObjectHandle) {
+
+   UInt32 result (0);
+
+   ObjectStruct *os (_objTable.lookup (ObjectHandle));
+
+   if (os) {
+
+      os->disableCount++;
+      if (os->disableCount == 1) { _bvh.enable_bounds (ObjectHandle, False); }
+      result = UInt32 (os->disableCount);
+   }
+
+   return result;
+}
+
+
+// Object Observer Interface
+void
+dmz::RenderModuleIsectBasic::create_object (
+      const UUID &Identity,
+      const Handle ObjectHandle,
+      const ObjectType &Type,
+      const ObjectLocalityEnum Locality) {
+
+   BoundsDefStruct *def (_lookup_bounds_def (Type));
+
+   if (def && def->Valid && !_objTable.lookup (ObjectHandle)) {
+
+      ObjectStruct *os (new ObjectStruct (*def));
+
+      if (os && _objTable.store (ObjectHandle, os)) { _store_bounds (ObjectHandle, *os); }
+      else if (os) { delete os; os = 0; }
+   }
+}
+
+
+void
+dmz::RenderModuleIsectBasic::destroy_object (
+      const UUID &Identity,
+      const Handle ObjectHandle) {
+
+   ObjectStruct *os (_objTable.remove (ObjectHandle));
+
+   if (os) {
+
+      _bvh.remove_bounds (ObjectHandle);
+      delete os; os = 0;
+   }
+}
+
+
+void
+dmz::RenderModuleIsectBasic::update_object_position (
+      const UUID &Identity,
+      const Handle ObjectHandle,
+      const Handle AttributeHandle,
+      const Vector &Value,
+      const Vector *PreviousValue) {
+
+   ObjectStruct *os (_objTable.lookup (ObjectHandle));
+
+   if (os) {
+
+      os->pos = Value;
+      _store_bounds (ObjectHandle, *os);
+   }
+}
+
+
+void
+dmz::RenderModuleIsectBasic::update_object_orientation (
+      const UUID &Identity,
+      const Handle ObjectHandle,
+      const Handle AttributeHandle,
+      const Matrix &Value,
+      const Matrix *PreviousValue) {
+
+   ObjectStruct *os (_objTable.lookup (ObjectHandle));
+
+   if (os) {
+
+      os->ori = Value;
+      _store_bounds (ObjectHandle, *os);
+   }
+}
+
+
+dmz::RenderModuleIsectBasic::BoundsDefStruct *
+dmz::RenderModuleIsectBasic::_lookup_bounds_def (const ObjectType &Type) {
+
+   BoundsDefStruct *result (_defTable.lookup (Type.get_handle ()));
+
+   if (!result && Type) {
+
+      Config bounds;
+      ObjectType current (Type);
+
+      while (current &&
+            !current.get_config ().lookup_config ("render.isect.bounds", bounds)) {
+
+         current.become_parent ();
+      }
+
+      const Vector Min (config_to_vector ("min", bounds));
+      const Vector Max (config_to_vector ("max", bounds));
+
+      // Types without bounds are stored too so the type tree is only walked once.
+      result = new BoundsDefStruct (current ? True : False, Min, Max);
+
+      if (!_defTable.store (Type.get_handle (), result)) { delete result; result = 0; }
+   }
+
+   return result;
+}
+
+
+// Stores the world space box that contains the object's rotated bounds.
+void
+dmz::RenderModuleIsectBasic::_store_bounds (
+      const Handle ObjectHandle,
+      const ObjectStruct &Obj) {
+
+   Vector center ((Obj.Def.Min + Obj.Def.Max) * 0.5);
+   const Vector HalfSize ((Obj.Def.Max - Obj.Def.Min) * 0.5);
+
+   Obj.ori.transform_vector (center);
+   center += Obj.pos;
+
+   Float64 data[9];
+   Obj.ori.to_array (data);
+
+   const Vector Extent (
+      (fabs (data[0]) * HalfSize.get_x ()) + (fabs (data[1]) * HalfSize.get_y ()) +
+         (fabs (data[2]) * HalfSize.get_z ()),
+      (fabs (data[3]) * HalfSize.get_x ()) + (fabs (data[4]) * HalfSize.get_y ()) +
+         (fabs (data[5]) * HalfSize.get_z ()),
+      (fabs (data[6]) * HalfSize.get_x ()) + (fabs (data[7]) * HalfSize.get_y ()) +
+         (fabs (data[8]) * HalfSize.get_z ()));
+
+   _bvh.store_bounds (ObjectHandle, center - Extent, center + Extent, EntityMask);
+}
+
+
+void
+dmz::RenderModuleIsectBasic::_init (Config &local) {
+
+   RuntimeContext *context (get_plugin_runtime_context ());
+
+   Definitions defs (context, &_log);
+
+   _staticAttrHandle = defs.create_named_handle (RenderIsectStaticName);
+   _entityAttrHandle = defs.create_named_handle (RenderIsectEntityName);
+
+   _bvh.set_thread_count (config_to_int32 ("threads.value", local, 1));
+
+   Config triangleList;
+
+   if (local.lookup_all_config ("static.triangle", triangleList)) {
+
+      ConfigIterator it;
+      Config triangle;
+
+      while (triangleList.get_next_config (it, triangle)) {
+
+         Config vertexList;
+         triangle.lookup_all_config ("vertex", vertexList);
+
+         ConfigIterator vertexIt;
+         Config vertex;
+         Vector points[3];
+         Int32 count (0);
+
+         while ((count < 3) && vertexList.get_next_config (vertexIt, vertex)) {
+
+            points[count] = config_to_vector (vertex);
+            count++;
+         }
+
+         if ((count < 3) ||
+               !_bvh.add_triangle (
+                  points[0],
+                  points[1],
+                  points[2],
+                  StaticMask,
+                  IsectPolygonBackCulledMask)) {
+
+            _log.warn << "Ignoring static triangle without three distinct vertices"
+               << endl;
+         }
+      }
+   }
+
+   Config boxList;
+
+   if (local.lookup_all_config ("static.box", boxList)) {
+
+      ConfigIterator it;
+      Config box;
+
+      while (boxList.get_next_config (it, box)) {
+
+         local_add_box (
+            _bvh,
+            config_to_vector ("min", box),
+            config_to_vector ("max", box),
+            StaticMask);
+      }
+   }
+
+   _log.info << "Static isect triangles: " << _bvh.get_triangle_count () << endl;
+
+   _defaultAttrHandle = activate_default_object_attribute (
+      ObjectCreateMask |
+      ObjectDestroyMask |
+      ObjectPositionMask |
+      ObjectOrientationMask);
+}
+//! \endcond
+
+
+extern "C" {
+
+DMZ_PLUGIN_FACTORY_LINK_SYMBOL dmz::Plugin *
+create_dmzRenderModuleIsectBasic (
+      const dmz::PluginInfo &Info,
+      dmz::Config &local,
+      dmz::Config &global) {
+
+   return new dmz::RenderModuleIsectBasic (Info, local);
+}
+
+};
@@ -0,0 +1,118 @@
+#ifndef DMZ_RENDER_MODULE_ISECT_BASIC_DOT_H
+#define DMZ_RENDER_MODULE_ISECT_BASIC_DOT_H
+
+#include <dmzObjectObserverUtil.h>
+#include <dmzRenderIsectBVH.h>
+#include <dmzRenderModuleIsect.h>
+#include <dmzRuntimeLog.h>
+#include <dmzRuntimeObjectType.h>
+#include <dmzRuntimePlugin.h>
+#include <dmzTypesHashTableHandleTemplate.h>
+#include <dmzTypesMatrix.h>
+#include <dmzTypesVector.h>
+
+namespace dmz {
+
+   class RenderModuleIsectBasic :
+         public Plugin,
+         public ObjectObserverUtil,
+         private RenderModuleIsect {
+
+      //! \cond
+      public:
+         RenderModuleIsectBasic (const PluginInfo &Info, Config &local);
+         ~RenderModuleIsectBasic ();
+
+         // Plugin Interface
+         virtual void update_plugin_state (
+            const PluginStateEnum State,
+            const UInt32 Level) {;}
+
+         virtual void discover_plugin (
+            const PluginDiscoverEnum Mode,
+            const Plugin *PluginPtr) {;}
+
+         // RenderModuleIsect Interface
+         virtual Boolean do_isect (
+            const IsectParameters &Parameters,
+            const IsectTestContainer &TestValues,
+            IsectResultContainer &resultContainer);
+
+         virtual UInt32 enable_isect (const Handle ObjectHandle);
+         virtual UInt32 disable_isect (const Handle ObjectHandle);
+
+         // Object Observer Interface
+         virtual void create_object (
+            const UUID &Identity,
+            const Handle ObjectHandle,
+            const ObjectType &Type,
+            const ObjectLocalityEnum Locality);
+
+         virtual void destroy_object (const UUID &Identity, const Handle ObjectHandle);
+
+         virtual void update_object_position (
+            const UUID &Identity,
+            const Handle ObjectHandle,
+            const Handle AttributeHandle,
+            const Vector &Value,
+            const Vector *PreviousValue);
+
+         virtual void update_object_orientation (
+            const UUID &Identity,
+            const Handle ObjectHandle,
+            const Handle AttributeHandle,
+            const Matrix &Value,
+            const Matrix *PreviousValue);
+
+      protected:
+         struct BoundsDefStruct {
+
+            const Boolean Valid;
+            const Vector Min;
+            const Vector Max;
+
+            BoundsDefStruct (
+                  const Boolean IsValid,
+                  const Vector &TheMin,
+                  const Vector &TheMax) :
+                  Valid (IsValid),
+                  Min (TheMin),
+                  Max (TheMax) {;}
+         };
+
+         struct ObjectStruct {
+
+            const BoundsDefStruct &Def;
+            Vector pos;
+            Matrix ori;
+            Int32 disableCount;
+
+            ObjectStruct (const BoundsDefStruct &TheDef) :
+                  Def (TheDef),
+                  disableCount (0) {;}
+         };
+
+         BoundsDefStruct *_lookup_bounds_def (const ObjectType &Type);
+         void _store_bounds (const Handle ObjectHandle, const ObjectStruct &Obj);
+         void _init (Config &local);
+
+         Log _log;
+
+         IsectBVH _bvh;
+
+         Handle _defaultAttrHandle;
+         Handle _staticAttrHandle;
+         Handle _entityAttrHandle;
+
+         HashTableHandleTemplate<BoundsDefStruct> _defTable;
+         HashTableHandleTemplate<ObjectStruct> _objTable;
+         //! \endcond
+
+      private:
+         RenderModuleIsectBasic ();
+         RenderModuleIsectBasic (const RenderModuleIsectBasic &);
+         RenderModuleIsectBasic &operator= (const RenderModuleIsectBasic &);
+   };
+};
+
+#endif // DMZ_RENDER_MODULE_ISECT_BASIC_DOT_H
@@ -41,6 +41,10 @@ namespace dmz {
          virtual osgViewer::View *lookup_view (const String &ViewName) = 0;
          virtual osgViewer::View *remove_view (const String &ViewName) = 0;
 
+         virtual Int32 get_transform_sync_count () = 0;
+         virtual Float64 get_transform_sync_time () = 0;
+         virtual UInt64 get_lod_skipped_count () = 0;
+
       protected:
          RenderModuleCoreOSG (const PluginInfo &Info);
          ~RenderModuleCoreOSG ();
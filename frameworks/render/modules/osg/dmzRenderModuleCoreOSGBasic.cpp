@@ -3,6 +3,7 @@
 #include <dmzObjectModule.h>
 #include <dmzObjectAttributeMasks.h>
 #include <dmzRenderConsts.h>
+#include <dmzRenderModulePortal.h>
 #include <dmzRenderObjectDataOSG.h>
 #include <dmzRenderUtilOSG.h>
 #include <dmzRuntimeConfig.h>
@@ -38,7 +39,15 @@ dmz::RenderModuleCoreOSGBasic::RenderModuleCoreOSGBasic (
       _isectMask (0),
       _defaultHandle (0),
       _bvrHandle (0),
-      _dirtyObjects (0) {
+      _lodHandle (0),
+      _portal (0),
+      _dirtyList (0),
+      _dirtyCount (0),
+      _dirtyCapacity (0),
+      _syncCount (0),
+      _syncTime (0.0),
+      _lodInterval (0.25),
+      _lodTime (0.0) {
 
    _log.info << "Built using Open Scene Graph v"
       << Int32 (OPENSCENEGRAPH_MAJOR_VERSION) << "."
@@ -105,6 +114,14 @@ dmz::RenderModuleCoreOSGBasic::~RenderModuleCoreOSGBasic () {
    _objectTable.empty ();
    _viewTable.empty ();
 
+   for (Int32 ix = 0; ix < _dirtyCount; ix++) {
+
+      if (_dirtyList[ix] && _dirtyList[ix]->destroyed) { delete _dirtyList[ix]; }
+      _dirtyList[ix] = 0;
+   }
+
+   if (_dirtyList) { delete []_dirtyList; _dirtyList = 0; }
+
    osg::DeleteHandler *dh (osg::Referenced::getDeleteHandler ());
 
    _scene = 0;
@@ -151,10 +168,23 @@ dmz::RenderModuleCoreOSGBasic::discover_plugin (
 
    if (Mode == PluginDiscoverAdd) {
 
+      // The LOD levels are measured from the portal named by lod.portal.name. If no
+      // name is given the master portal is used, or the first portal found if none
+      // of the portals is the master portal.
+      if (!_portal || !_portal->is_master_portal ()) {
+
+         RenderModulePortal *portal (
+            RenderModulePortal::cast (PluginPtr, _lodPortalName));
+
+         if (portal && (!_portal || portal->is_master_portal ())) { _portal = portal; }
+      }
+
       _extensions.discover_external_plugin (PluginPtr);
    }
    else if (Mode == PluginDiscoverRemove) {
 
+      if (_portal && (_portal == RenderModulePortal::cast (PluginPtr))) { _portal = 0; }
+
       _extensions.remove_external_plugin (PluginPtr);
    }
 }
@@ -164,23 +194,58 @@ dmz::RenderModuleCoreOSGBasic::discover_plugin (
 void
 dmz::RenderModuleCoreOSGBasic::update_time_slice (const Float64 DeltaTime) {
 
+   const Float64 StartTime (get_time ());
+
    ObjectModule *objMod (get_object_module ());
 
-   while (_dirtyObjects) {
+   if (_portal && (_lod.get_level_count () > 1)) {
+
+      _update_lod_levels (objMod, StartTime);
+   }
 
-      ObjectStruct *os (_dirtyObjects);
-      _dirtyObjects = os->next;
+   const Int32 Count (_dirtyCount);
+   Int32 due (0);
 
-      os->transform->setMatrix (to_osg_matrix (os->ori, os->pos, os->scale));
+   _sync.clear ();
 
-      if (objMod) {
+   // Objects with updates that are due are moved to the front of the dirty list.
+   // Destroyed objects are always swept so they are released. The due objects are no
+   // longer dirty once their matrices are composed, so an observer that moves one of
+   // them during the sweep queues it again for the next frame.
+   for (Int32 ix = 0; ix < Count; ix++) {
 
-         const osg::BoundingSphere &Bvs = os->transform->getBound ();
-         const Float64 Radius = Bvs.radius ();
-         objMod->store_scalar (os->Object, _bvrHandle, Radius);
+      ObjectStruct *os (_dirtyList[ix]);
+
+      if (os->destroyed || _lod.is_update_due (os->lodLevel, os->updateTime, StartTime)) {
+
+         _dirtyList[ix] = _dirtyList[due];
+         _dirtyList[due] = os;
+         due++;
+
+         os->dirty = False;
+         os->syncing = True;
+         _sync.add (os->ori, os->pos, os->scale);
       }
+   }
+
+   _sync.compose ();
+
+   for (Int32 ix = 0; ix < due; ix++) {
 
-      if (os->destroyed) { 
+      ObjectStruct *os (_dirtyList[ix]);
+      _dirtyList[ix] = 0;
+
+      os->syncing = False;
+      os->updateTime = StartTime;
+      os->transform->setMatrix (osg::Matrixd (_sync.get_matrix (ix)));
+
+      const osg::BoundingSphere &Bvs = os->transform->getBound ();
+      os->radius = Bvs.radius ();
+
+      if (objMod) { objMod->store_scalar (os->Object, _bvrHandle, os->radius); }
+
+      // An object that was queued again is released when the later copy is swept.
+      if (os->destroyed && !os->dirty) {
 
          if (_dynamicObjects.valid ()) {
 
@@ -189,8 +254,18 @@ dmz::RenderModuleCoreOSGBasic::update_time_slice (const Float64 DeltaTime) {
 
          delete os; os = 0;
       }
-      else { os->next = 0; os->dirty = False; }
    }
+
+   // Throttled objects and objects changed by observers while the matrices were
+   // composed or applied are synced in a later frame.
+   const Int32 Remaining (_dirtyCount - due);
+
+   for (Int32 ix = 0; ix < Remaining; ix++) { _dirtyList[ix] = _dirtyList[due + ix]; }
+   for (Int32 ix = Remaining; ix < _dirtyCount; ix++) { _dirtyList[ix] = 0; }
+
+   _dirtyCount = Remaining;
+   _syncCount = due;
+   _syncTime = get_time () - StartTime;
 }
 
 
@@ -204,7 +279,7 @@ dmz::RenderModuleCoreOSGBasic::destroy_object (
 
    if (os) {
 
-      if (os->dirty) { os->destroyed = True; }
+      if (os->dirty || os->syncing) { os->destroyed = True; }
       else {
 
          if (_dynamicObjects.valid ()) {
@@ -232,12 +307,7 @@ dmz::RenderModuleCoreOSGBasic::update_object_position (
 
       os->pos = Value;
 
-      if (!os->dirty) {
-
-         os->dirty = True;
-         os->next = _dirtyObjects;
-         _dirtyObjects = os;
-      }
+      if (!os->dirty) { _add_dirty_object (*os); }
    }
 }
 
@@ -256,12 +326,7 @@ dmz::RenderModuleCoreOSGBasic::update_object_scale (
 
       os->scale = Value;
 
-      if (!os->dirty) {
-
-         os->dirty = True;
-         os->next = _dirtyObjects;
-         _dirtyObjects = os;
-      }
+      if (!os->dirty) { _add_dirty_object (*os); }
    }
 }
 
@@ -280,12 +345,7 @@ dmz::RenderModuleCoreOSGBasic::update_object_orientation (
 
       os->ori = Value;
 
-      if (!os->dirty) {
-
-         os->dirty = True;
-         os->next = _dirtyObjects;
-         _dirtyObjects = os;
-      }
+      if (!os->dirty) { _add_dirty_object (*os); }
    }
 }
 
@@ -363,9 +423,7 @@ dmz::RenderModuleCoreOSGBasic::create_dynamic_object (const Handle ObjectHandle)
             os->transform->setMatrix (to_osg_matrix (os->ori, os->pos, os->scale));
          }
 
-         os->dirty = True;
-         os->next = _dirtyObjects;
-         _dirtyObjects = os;
+         _add_dirty_object (*os);
 
          if (_dynamicObjects.valid ()) {
 
@@ -457,12 +515,129 @@ dmz::RenderModuleCoreOSGBasic::remove_view (const String &ViewName) {
 }
 
 
+dmz::Int32
+dmz::RenderModuleCoreOSGBasic::get_transform_sync_count () { return _syncCount; }
+
+
+dmz::Float64
+dmz::RenderModuleCoreOSGBasic::get_transform_sync_time () { return _syncTime; }
+
+
+dmz::UInt64
+dmz::RenderModuleCoreOSGBasic::get_lod_skipped_count () {
+
+   return _lod.get_skipped_count ();
+}
+
+
+void
+dmz::RenderModuleCoreOSGBasic::_add_dirty_object (ObjectStruct &obj) {
+
+   if (_dirtyCount >= _dirtyCapacity) {
+
+      const Int32 Capacity (_dirtyCapacity ? _dirtyCapacity * 2 : 256);
+      ObjectStruct **list (new ObjectStruct *[Capacity]);
+
+      for (Int32 ix = 0; ix < _dirtyCount; ix++) { list[ix] = _dirtyList[ix]; }
+
+      if (_dirtyList) { delete []_dirtyList; }
+      _dirtyList = list;
+      _dirtyCapacity = Capacity;
+   }
+
+   obj.dirty = True;
+   _dirtyList[_dirtyCount] = &obj;
+   _dirtyCount++;
+}
+
+
+void
+dmz::RenderModuleCoreOSGBasic::_update_lod_levels (
+      ObjectModule *objMod,
+      const Float64 Time) {
+
+   if ((Time - _lodTime) >= _lodInterval) {
+
+      _lodTime = Time;
+
+      Vector pos;
+      Matrix ori;
+
+      _portal->get_view (pos, ori);
+      _lod.set_view (pos, _portal->get_fov ());
+
+      HashTableHandleIterator it;
+      ObjectStruct *os (0);
+
+      while (_objectTable.get_next (it, os)) {
+
+         const Int32 Level (_lod.find_level (os->pos, os->radius));
+
+         if (Level != os->lodLevel) {
+
+            os->lodLevel = Level;
+
+            if (objMod && _lodHandle) {
+
+               objMod->store_scalar (os->Object, _lodHandle, Float64 (Level));
+            }
+         }
+      }
+   }
+}
+
+
+void
+dmz::RenderModuleCoreOSGBasic::_init_lod (Config &local) {
+
+   _lodInterval = config_to_float64 ("lod.interval", local, _lodInterval);
+   _lodPortalName = config_to_string ("lod.portal.name", local);
+
+   Config levelList;
+
+   if (local.lookup_all_config ("lod.level", levelList)) {
+
+      ConfigIterator it;
+      Config level;
+
+      while (levelList.get_next_config (it, level)) {
+
+         const Int32 Result = _lod.add_level (
+            config_to_float64 ("distance", level, 0.0),
+            config_to_float64 ("screen-size", level, 0.0),
+            config_to_float64 ("update-interval", level, 0.0));
+
+         if (!Result) {
+
+            _log.error << "LOD level requires a distance or a screen size." << endl;
+         }
+      }
+   }
+
+   if (_lod.get_level_count () > 1) {
+
+      _lodHandle = config_to_named_handle (
+         "lod.attribute.name",
+         local,
+         RenderLODLevelName,
+         get_plugin_runtime_context ());
+
+      _log.info << "LOD levels: " << _lod.get_level_count () << endl;
+   }
+}
+
+
 void
 dmz::RenderModuleCoreOSGBasic::_init (Config &local, Config &global) {
 
    const String UpStr = config_to_string ("osg-up.value", local, "y").to_lower ();
    if (UpStr == "y") { set_osg_y_up (); _log.info << "OSG render Y is up." << endl; }
-   else if (UpStr == "z") { set_osg_z_up (); _log.info << "OSG render Z is up" << endl; }
+   else if (UpStr == "z") {
+
+      set_osg_z_up ();
+      _sync.set_z_up (True);
+      _log.info << "OSG render Z is up" << endl;
+   }
    else {
 
       _log.warn << "Unknown osg up type: " << UpStr << ". Defaulting to Y up." << endl;
@@ -511,11 +686,15 @@ dmz::RenderModuleCoreOSGBasic::_init (Config &local, Config &global) {
    _defaultHandle = activate_default_object_attribute (
       ObjectDestroyMask | ObjectPositionMask | ObjectScaleMask | ObjectOrientationMask);
 
+   _sync.set_thread_count (config_to_int32 ("transform-sync.threads", local, 1));
+
    _bvrHandle = config_to_named_handle (
       "bounding-volume-radius-attribute.name",
       local,
       ObjectAttributeBoundingVolumeRaidusName,
       get_plugin_runtime_context ());
+
+   _init_lod (local);
 }
 
 
@@ -2,7 +2,9 @@
 #define DMZ_RENDER_MODULE_CORE_OSG_BASIC_DOT_H
 
 #include <dmzObjectObserverUtil.h>
+#include <dmzRenderLODPolicy.h>
 #include <dmzRenderModuleCoreOSG.h>
+#include <dmzRenderTransformSync.h>
 #include <dmzRuntimeDefinitions.h>
 #include <dmzRuntimeLog.h>
 #include <dmzRuntimePlugin.h>
@@ -13,6 +15,7 @@
 #include <dmzTypesHashTableStringTemplate.h>
 #include <dmzTypesHashTableHandleTemplate.h>
 #include <dmzTypesMatrix.h>
+#include <dmzTypesString.h>
 #include <dmzTypesVector.h>
 
 #include <osg/Camera>
@@ -28,6 +31,7 @@
 namespace dmz {
 
    class ObjectModule;
+   class RenderModulePortal;
 
    class RenderModuleCoreOSGBasic :
          public Plugin,
@@ -99,6 +103,10 @@ namespace dmz {
          virtual osgViewer::View *lookup_view (const String &ViewName);
          virtual osgViewer::View *remove_view (const String &ViewName);
 
+         virtual Int32 get_transform_sync_count ();
+         virtual Float64 get_transform_sync_time ();
+         virtual UInt64 get_lod_skipped_count ();
+
       protected:
          struct ViewStruct {
 
@@ -115,19 +123,25 @@ namespace dmz {
          struct ObjectStruct {
 
             const Handle Object;
-            ObjectStruct *next;
             osg::ref_ptr<osg::MatrixTransform> transform;
             Matrix ori;
             Vector pos;
             Vector scale;
+            Float64 radius;
+            Float64 updateTime;
+            Int32 lodLevel;
             Boolean dirty;
+            Boolean syncing;
             Boolean destroyed;
 
             ObjectStruct (const Handle TheObject) :
                   Object (TheObject),
-                  next (0),
                   scale (1.0, 1.0, 1.0),
+                  radius (0.0),
+                  updateTime (0.0),
+                  lodLevel (0),
                   dirty (False),
+                  syncing (False),
                   destroyed (False) {
 
                transform =  new osg::MatrixTransform;
@@ -136,6 +150,9 @@ namespace dmz {
             ~ObjectStruct () { transform = 0; }
          };
 
+         void _add_dirty_object (ObjectStruct &obj);
+         void _update_lod_levels (ObjectModule *objMod, const Float64 Time);
+         void _init_lod (Config &local);
          void _init (Config &local, Config &global);
 
          Log _log;
@@ -145,6 +162,9 @@ namespace dmz {
          UInt32 _isectMask;
          Handle _defaultHandle;
          Handle _bvrHandle;
+         Handle _lodHandle;
+         RenderModulePortal *_portal;
+         String _lodPortalName;
          osg::ref_ptr<osg::Group> _scene;
          osg::ref_ptr<osg::Group> _overlay;
          osg::ref_ptr<osg::Group> _isect;
@@ -153,7 +173,15 @@ namespace dmz {
          HashTableStringTemplate<ViewStruct> _viewTable;
          HashTableHandleTemplate<ObjectStruct> _objectTable;
          HashTableHandleTemplate<UInt32> _isectMaskTable;
-         ObjectStruct *_dirtyObjects;
+         ObjectStruct **_dirtyList;
+         Int32 _dirtyCount;
+         Int32 _dirtyCapacity;
+         RenderTransformSync _sync;
+         Int32 _syncCount;
+         Float64 _syncTime;
+         RenderLODPolicy _lod;
+         Float64 _lodInterval;
+         Float64 _lodTime;
    };
 }
 
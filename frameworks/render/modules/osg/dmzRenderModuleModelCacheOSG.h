@@ -0,0 +1,75 @@
+#ifndef DMZ_RENDER_MODULE_MODEL_CACHE_OSG_DOT_H
+#define DMZ_RENDER_MODULE_MODEL_CACHE_OSG_DOT_H
+
+#include <dmzRuntimePlugin.h>
+#include <dmzRuntimeRTTI.h>
+#include <dmzTypesBase.h>
+
+namespace osg { class Node; }
+
+namespace dmz {
+
+   const char RenderModuleModelCacheOSGInterfaceName[] =
+      "RenderModuleModelCacheOSGInterface";
+
+   class RenderModelObserverOSG {
+
+      public:
+         virtual void update_model (const String &ResourceName, osg::Node *model) = 0;
+
+      protected:
+         RenderModelObserverOSG () {;}
+         virtual ~RenderModelObserverOSG () {;}
+   };
+
+   class RenderModuleModelCacheOSG {
+
+      public:
+         static RenderModuleModelCacheOSG *cast (const Plugin *PluginPtr);
+
+         virtual osg::Node *lookup_model (const String &ResourceName) = 0;
+         virtual osg::Node *load_model (const String &ResourceName) = 0;
+
+         virtual Boolean request_model (
+            const String &ResourceName,
+            RenderModelObserverOSG *observer) = 0;
+
+         virtual void release_model_observer (RenderModelObserverOSG &observer) = 0;
+
+         virtual osg::Node *get_placeholder_model () = 0;
+
+      protected:
+         RenderModuleModelCacheOSG (const PluginInfo &Info);
+         ~RenderModuleModelCacheOSG ();
+
+      private:
+         const PluginInfo &__Info;
+   };
+}
+
+
+inline dmz::RenderModuleModelCacheOSG *
+dmz::RenderModuleModelCacheOSG::cast (const Plugin *PluginPtr) {
+
+   return (RenderModuleModelCacheOSG *)lookup_rtti_interface (
+      RenderModuleModelCacheOSGInterfaceName,
+      "",
+      PluginPtr);
+}
+
+
+inline
+dmz::RenderModuleModelCacheOSG::RenderModuleModelCacheOSG (const PluginInfo &Info) :
+      __Info (Info) {
+
+   store_rtti_interface (RenderModuleModelCacheOSGInterfaceName, __Info, (void *)this);
+}
+
+
+inline
+dmz::RenderModuleModelCacheOSG::~RenderModuleModelCacheOSG () {
+
+   remove_rtti_interface (RenderModuleModelCacheOSGInterfaceName, __Info);
+}
+
+#endif // DMZ_RENDER_MODULE_MODEL_CACHE_OSG_DOT_H
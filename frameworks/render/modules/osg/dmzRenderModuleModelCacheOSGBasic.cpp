@@ -0,0 +1,572 @@
+#include "dmzRenderModuleModelCacheOSGBasic.h"
+#include <dmzRuntimeConfig.h>
+#include <dmzRuntimeConfigToTypesBase.h>
+#include <dmzRuntimeConfigToStringContainer.h>
+#include <dmzRuntimeIterator.h>
+#include <dmzRuntimeObjectType.h>
+#include <dmzRuntimePluginFactoryLinkSymbol.h>
+#include <dmzRuntimePluginInfo.h>
+#include <dmzSystemFile.h>
+#include <dmzSystemMutex.h>
+#include <dmzSystemThread.h>
+
+#include <osg/Geode>
+#include <osg/Shape>
+#include <osg/ShapeDrawable>
+#include <osgDB/ReadFile>
+#include <osgUtil/Optimizer>
+
+namespace {
+
+static osg::Node *
+local_read_model (const dmz::String &FileName) {
+
+   osg::Node *result (osgDB::readNodeFile (FileName.get_buffer ()));
+
+   if (result) {
+
+      osgUtil::Optimizer optimizer;
+      optimizer.optimize (result);
+   }
+
+   return result;
+}
+
+};
+
+
+//! \cond
+struct dmz::RenderModuleModelCacheOSGBasic::LoadStruct {
+
+   const String FileName;
+   osg::ref_ptr<osg::Node> model;
+   LoadStruct *next;
+
+   LoadStruct (const String &TheFileName) : FileName (TheFileName), next (0) {;}
+   ~LoadStruct () { if (next) { delete next; next = 0; } }
+};
+
+
+// The queue is shared between the main thread and the load workers. One pool task is
+// added for each job so an idle worker takes the next job when its task is run.
+struct dmz::RenderModuleModelCacheOSGBasic::LoadQueue {
+
+   Mutex lock;
+   Boolean stop;
+   LoadStruct *jobHead;
+   LoadStruct *jobTail;
+   LoadStruct *doneList;
+
+   LoadQueue () :
+         stop (False),
+         jobHead (0),
+         jobTail (0),
+         doneList (0) {;}
+
+   ~LoadQueue () {
+
+      if (jobHead) { delete jobHead; jobHead = jobTail = 0; }
+      if (doneList) { delete doneList; doneList = 0; }
+   }
+
+   void add_job (LoadStruct *job) {
+
+      lock.lock ();
+         if (jobTail) { jobTail->next = job; }
+         else { jobHead = job; }
+         jobTail = job;
+      lock.unlock ();
+   }
+
+   LoadStruct *get_next_job () {
+
+      LoadStruct *result (0);
+
+      lock.lock ();
+         if (!stop && jobHead) {
+
+            result = jobHead;
+            jobHead = result->next;
+            if (!jobHead) { jobTail = 0; }
+            result->next = 0;
+         }
+      lock.unlock ();
+
+      return result;
+   }
+
+   void add_done (LoadStruct *job) {
+
+      lock.lock ();
+         job->next = doneList;
+         doneList = job;
+      lock.unlock ();
+   }
+
+   LoadStruct *take_jobs () {
+
+      lock.lock ();
+         LoadStruct *result (jobHead);
+         jobHead = jobTail = 0;
+      lock.unlock ();
+
+      return result;
+   }
+
+   LoadStruct *take_done () {
+
+      lock.lock ();
+         LoadStruct *result (doneList);
+         doneList = 0;
+      lock.unlock ();
+
+      return result;
+   }
+};
+
+
+class dmz::RenderModuleModelCacheOSGBasic::LoadWorker : public ThreadFunction {
+
+   public:
+      LoadWorker (LoadQueue &queue) : _queue (queue) {;}
+      virtual ~LoadWorker () {;}
+
+      virtual void run_thread_function () {
+
+         LoadStruct *job (_queue.get_next_job ());
+
+         if (job) {
+
+            job->model = local_read_model (job->FileName);
+            _queue.add_done (job);
+         }
+      }
+
+   protected:
+      LoadQueue &_queue;
+};
+//! \endcond
+
+
+/*!
+
+\class dmz::RenderModuleModelCacheOSGBasic
+\ingroup Render
+\brief Loads and shares OSG models.
+\details Models are cached by the file the resource name resolves to so every plugin
+that uses the same file shares a single model. Requested models are read and optimized
+by a pool of worker threads. Observers are notified from the time slice once the model
+is loaded. Setting the thread count to zero loads requested models immediately.
+\n
+The preload list and, when the definitions attribute is true, every render model in
+the runtime object type definitions are requested when the plugin is started.
+\code
+<dmzRenderModuleModelCacheOSGBasic>
+   <threads value="2"/>
+   <placeholder resource="Optional placeholder model resource" size="1.0"/>
+   <preload definitions="Boolean, defaults to false">
+      <resource value="Model resource name"/>
+   </preload>
+</dmzRenderModuleModelCacheOSGBasic>
+\endcode
+
+*/
+
+//! \cond
+dmz::RenderModuleModelCacheOSGBasic::RenderModuleModelCacheOSGBasic (
+      const PluginInfo &Info,
+      Config &local) :
+      Plugin (Info),
+      TimeSlice (Info),
+      RenderModuleModelCacheOSG (Info),
+      _log (Info),
+      _defs (Info, &_log),
+      _rc (Info, &_log),
+      _queue (*(new LoadQueue)),
+      _worker (*(new LoadWorker (_queue))),
+      _preloadDefinitions (False) {
+
+   _init (local);
+}
+
+
+dmz::RenderModuleModelCacheOSGBasic::~RenderModuleModelCacheOSGBasic () {
+
+   _stop_workers ();
+   delete &_worker;
+   delete &_queue;
+
+   _resourceTable.clear ();
+   _fileTable.empty ();
+   _placeholder = 0;
+}
+
+
+// Plugin Interface
+void
+dmz::RenderModuleModelCacheOSGBasic::update_plugin_state (
+      const PluginStateEnum State,
+      const UInt32 Level) {
+
+   if (State == PluginStateInit) {
+
+   }
+   else if (State == PluginStateStart) {
+
+      _preload ();
+   }
+   else if (State == PluginStateStop) {
+
+   }
+   else if (State == PluginStateShutdown) {
+
+      _stop_workers ();
+   }
+}
+
+
+// Time Slice Interface
+void
+dmz::RenderModuleModelCacheOSGBasic::update_time_slice (const Float64 DeltaTime) {
+
+   _finish_jobs ();
+}
+
+
+// RenderModuleModelCacheOSG Interface
+osg::Node *
+dmz::RenderModuleModelCacheOSGBasic::lookup_model (const String &ResourceName) {
+
+   ModelStruct *ms (_lookup_model_struct (ResourceName));
+
+   return ms ? ms->model.get () : 0;
+}
+
+
+osg::Node *
+dmz::RenderModuleModelCacheOSGBasic::load_model (const String &ResourceName) {
+
+   ModelStruct *ms (_lookup_model_struct (ResourceName));
+
+   if (ms && !ms->model.valid () && !ms->failed) {
+
+      // A pending request is answered with this model when the worker finishes.
+      _load (*ms);
+      _update_observers (*ms);
+   }
+
+   return ms ? ms->model.get () : 0;
+}
+
+
+dmz::Boolean
+dmz::RenderModuleModelCacheOSGBasic::request_model (
+      const String &ResourceName,
+      RenderModelObserverOSG *observer) {
+
+   ModelStruct *ms (_lookup_model_struct (ResourceName));
+
+   if (ms && !ms->model.valid () && !ms->failed) {
+
+      if (observer) {
+
+         ObserverStruct *os (ms->obsList);
+
+         while (os &&
+               ((&(os->observer) != observer) || (os->ResourceName != ResourceName))) {
+
+            os = os->next;
+         }
+
+         if (!os) {
+
+            os = new ObserverStruct (ResourceName, *observer);
+            os->next = ms->obsList;
+            ms->obsList = os;
+         }
+      }
+
+      if (!ms->pending) {
+
+         if (_pool.get_thread_count () > 0) {
+
+            ms->pending = True;
+            _queue.add_job (new LoadStruct (ms->FileName));
+            _pool.add_task (_worker);
+         }
+         else { _load (*ms); _update_observers (*ms); }
+      }
+   }
+
+   return ms && !ms->failed;
+}
+
+
+void
+dmz::RenderModuleModelCacheOSGBasic::release_model_observer (
+      RenderModelObserverOSG &observer) {
+
+   HashTableStringIterator it;
+   ModelStruct *ms (0);
+
+   while (_fileTable.get_next (it, ms)) {
+
+      ObserverStruct *prev (0);
+      ObserverStruct *current (ms->obsList);
+
+      while (current) {
+
+         ObserverStruct *next (current->next);
+
+         if (&(current->observer) == &observer) {
+
+            if (prev) { prev->next = next; }
+            else { ms->obsList = next; }
+
+            current->next = 0;
+            delete current;
+         }
+         else { prev = current; }
+
+         current = next;
+      }
+   }
+}
+
+
+osg::Node *
+dmz::RenderModuleModelCacheOSGBasic::get_placeholder_model () {
+
+   return _placeholder.get ();
+}
+
+
+dmz::RenderModuleModelCacheOSGBasic::ModelStruct *
+dmz::RenderModuleModelCacheOSGBasic::_lookup_model_struct (const String &ResourceName) {
+
+   ModelStruct *result (_resourceTable.lookup (ResourceName));
+
+   if (!result && ResourceName) {
+
+      String fileName (_rc.find_file (ResourceName));
+
+      if (!fileName && is_valid_path (ResourceName)) { fileName = ResourceName; }
+
+      if (fileName) {
+
+         result = _fileTable.lookup (fileName);
+
+         if (!result) {
+
+            result = new ModelStruct (ResourceName, fileName);
+
+            if (!_fileTable.store (fileName, result)) { delete result; result = 0; }
+         }
+
+         if (result) { _resourceTable.store (ResourceName, result); }
+      }
+      else {
+
+         _log.error << "Unable to find model resource: " << ResourceName << endl;
+      }
+   }
+
+   return result;
+}
+
+
+void
+dmz::RenderModuleModelCacheOSGBasic::_load (ModelStruct &ms) {
+
+   _finish_model (ms, local_read_model (ms.FileName));
+}
+
+
+void
+dmz::RenderModuleModelCacheOSGBasic::_finish_model (ModelStruct &ms, osg::Node *model) {
+
+   ms.pending = False;
+   ms.model = model;
+
+   if (ms.model.valid ()) {
+
+      osg::Node::DescriptionList &list = ms.model->getDescriptions ();
+
+      String str ("<dmz><render><resource name=\"");
+      str << ms.ResourceName << "\"/></render></dmz>";
+      list.push_back (str.get_buffer ());
+
+      _log.info << "Loaded file: " << ms.FileName << " (" << ms.ResourceName << ")"
+         << endl;
+   }
+   else {
+
+      ms.failed = True;
+
+      _log.error << "Failed loading file: " << ms.FileName << " (" << ms.ResourceName
+         << ")" << endl;
+   }
+}
+
+
+void
+dmz::RenderModuleModelCacheOSGBasic::_update_observers (ModelStruct &ms) {
+
+   // Observers may request more models so the list is detached before it is walked.
+   ObserverStruct *list (ms.obsList);
+   ms.obsList = 0;
+
+   ObserverStruct *current (list);
+
+   while (current) {
+
+      current->observer.update_model (current->ResourceName, ms.model.get ());
+      current = current->next;
+   }
+
+   if (list) { delete list; list = 0; }
+}
+
+
+void
+dmz::RenderModuleModelCacheOSGBasic::_finish_jobs () {
+
+   LoadStruct *list (_queue.take_done ());
+
+   while (list) {
+
+      LoadStruct *job (list);
+      list = job->next;
+      job->next = 0;
+
+      ModelStruct *ms (_fileTable.lookup (job->FileName));
+
+      if (ms && ms->pending) {
+
+         _finish_model (*ms, job->model.get ());
+         _update_observers (*ms);
+      }
+
+      delete job; job = 0;
+   }
+}
+
+
+// Jobs that have not been started are dropped and the worker threads are joined.
+// Jobs the workers finished are handed to their observers. The models of the
+// dropped jobs are no longer pending so requesting them again loads them
+// immediately, since no workers are left.
+void
+dmz::RenderModuleModelCacheOSGBasic::_stop_workers () {
+
+   _queue.lock.lock ();
+      _queue.stop = True;
+   _queue.lock.unlock ();
+
+   _pool.set_thread_count (0);
+
+   _finish_jobs ();
+
+   LoadStruct *list (_queue.take_jobs ());
+
+   while (list) {
+
+      LoadStruct *job (list);
+      list = job->next;
+      job->next = 0;
+
+      ModelStruct *ms (_fileTable.lookup (job->FileName));
+
+      if (ms) { ms->pending = False; }
+
+      delete job; job = 0;
+   }
+}
+
+
+void
+dmz::RenderModuleModelCacheOSGBasic::_preload () {
+
+   StringContainerIterator it;
+   String name;
+
+   while (_preloadList.get_next (it, name)) { request_model (name, 0); }
+
+   if (_preloadDefinitions) {
+
+      RuntimeIterator typeIt;
+      ObjectType type;
+
+      while (_defs.get_next_object_type (typeIt, type)) {
+
+         Config modelList;
+
+         if (type.get_config ().lookup_all_config ("render.model", modelList)) {
+
+            ConfigIterator modelIt;
+            Config model;
+
+            while (modelList.get_next_config (modelIt, model)) {
+
+               const String ResourceName (config_to_string ("resource", model));
+
+               if (ResourceName) { request_model (ResourceName, 0); }
+            }
+         }
+      }
+   }
+}
+
+
+void
+dmz::RenderModuleModelCacheOSGBasic::_init (Config &local) {
+
+   _pool.set_thread_count (config_to_int32 ("threads.value", local, 2));
+
+   const String PlaceholderName (config_to_string ("placeholder.resource", local));
+
+   if (PlaceholderName) {
+
+      const String FileName (_rc.find_file (PlaceholderName));
+
+      if (FileName) { _placeholder = osgDB::readNodeFile (FileName.get_buffer ()); }
+
+      if (!_placeholder.valid ()) {
+
+         _log.error << "Failed loading placeholder model: " << PlaceholderName << endl;
+      }
+   }
+
+   if (!_placeholder.valid ()) {
+
+      const Float64 Size (config_to_float64 ("placeholder.size", local, 1.0));
+
+      osg::Geode *geode (new osg::Geode);
+      geode->addDrawable (
+         new osg::ShapeDrawable (new osg::Box (osg::Vec3 (0.0f, 0.0f, 0.0f), Size)));
+
+      _placeholder = geode;
+   }
+
+   _preloadDefinitions = config_to_boolean (
+      "preload.definitions",
+      local,
+      _preloadDefinitions);
+
+   _preloadList = config_to_string_container ("preload.resource", local);
+}
+//! \endcond
+
+
+extern "C" {
+
+DMZ_PLUGIN_FACTORY_LINK_SYMBOL dmz::Plugin *
+create_dmzRenderModuleModelCacheOSGBasic (
+      const dmz::PluginInfo &Info,
+      dmz::Config &local,
+      dmz::Config &global) {
+
+   return new dmz::RenderModuleModelCacheOSGBasic (Info, local);
+}
+
+};
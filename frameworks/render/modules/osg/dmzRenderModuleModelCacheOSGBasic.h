@@ -0,0 +1,124 @@
+#ifndef DMZ_RENDER_MODULE_MODEL_CACHE_OSG_BASIC_DOT_H
+#define DMZ_RENDER_MODULE_MODEL_CACHE_OSG_BASIC_DOT_H
+
+#include <dmzRenderModuleModelCacheOSG.h>
+#include <dmzRuntimeDefinitions.h>
+#include <dmzRuntimeLog.h>
+#include <dmzRuntimePlugin.h>
+#include <dmzRuntimeResources.h>
+#include <dmzRuntimeTimeSlice.h>
+#include <dmzSystemThreadPool.h>
+#include <dmzTypesHashTableStringTemplate.h>
+#include <dmzTypesStringContainer.h>
+
+#include <osg/Node>
+
+namespace dmz {
+
+   class RenderModuleModelCacheOSGBasic :
+         public Plugin,
+         public TimeSlice,
+         private RenderModuleModelCacheOSG {
+
+      public:
+         RenderModuleModelCacheOSGBasic (const PluginInfo &Info, Config &local);
+         ~RenderModuleModelCacheOSGBasic ();
+
+         // Plugin Interface
+         virtual void update_plugin_state (
+            const PluginStateEnum State,
+            const UInt32 Level);
+
+         virtual void discover_plugin (
+            const PluginDiscoverEnum Mode,
+            const Plugin *PluginPtr) {;}
+
+         // Time Slice Interface
+         virtual void update_time_slice (const Float64 DeltaTime);
+
+         // RenderModuleModelCacheOSG Interface
+         virtual osg::Node *lookup_model (const String &ResourceName);
+         virtual osg::Node *load_model (const String &ResourceName);
+
+         virtual Boolean request_model (
+            const String &ResourceName,
+            RenderModelObserverOSG *observer);
+
+         virtual void release_model_observer (RenderModelObserverOSG &observer);
+
+         virtual osg::Node *get_placeholder_model ();
+
+      protected:
+         struct LoadQueue;
+         struct LoadStruct;
+         class LoadWorker;
+
+         struct ObserverStruct {
+
+            const String ResourceName;
+            RenderModelObserverOSG &observer;
+            ObserverStruct *next;
+
+            ObserverStruct (
+                  const String &TheResourceName,
+                  RenderModelObserverOSG &theObserver) :
+                  ResourceName (TheResourceName),
+                  observer (theObserver),
+                  next (0) {;}
+
+            ~ObserverStruct () { if (next) { delete next; next = 0; } }
+         };
+
+         struct ModelStruct {
+
+            const String ResourceName;
+            const String FileName;
+            osg::ref_ptr<osg::Node> model;
+            Boolean pending;
+            Boolean failed;
+            ObserverStruct *obsList;
+
+            ModelStruct (const String &TheResourceName, const String &TheFileName) :
+                  ResourceName (TheResourceName),
+                  FileName (TheFileName),
+                  pending (False),
+                  failed (False),
+                  obsList (0) {;}
+
+            ~ModelStruct () { if (obsList) { delete obsList; obsList = 0; } }
+         };
+
+         ModelStruct *_lookup_model_struct (const String &ResourceName);
+         void _load (ModelStruct &ms);
+         void _finish_model (ModelStruct &ms, osg::Node *model);
+         void _update_observers (ModelStruct &ms);
+         void _finish_jobs ();
+         void _stop_workers ();
+         void _preload ();
+         void _init (Config &local);
+
+         Log _log;
+         Definitions _defs;
+         Resources _rc;
+
+         HashTableStringTemplate<ModelStruct> _fileTable;
+         HashTableStringTemplate<ModelStruct> _resourceTable;
+
+         osg::ref_ptr<osg::Node> _placeholder;
+
+         LoadQueue &_queue;
+         LoadWorker &_worker;
+         ThreadPool _pool;
+
+         Boolean _preloadDefinitions;
+         StringContainer _preloadList;
+
+      private:
+         RenderModuleModelCacheOSGBasic ();
+         RenderModuleModelCacheOSGBasic (const RenderModuleModelCacheOSGBasic &);
+         RenderModuleModelCacheOSGBasic &operator= (
+            const RenderModuleModelCacheOSGBasic &);
+   };
+};
+
+#endif // DMZ_RENDER_MODULE_MODEL_CACHE_OSG_BASIC_DOT_H
@@ -0,0 +1,369 @@
+#include <dmzRenderIsectHeightField.h>
+#include <dmzRenderModuleIsect.h>
+#include "dmzRenderModuleTerrainBasic.h"
+#include <dmzRuntimeConfig.h>
+#include <dmzRuntimeConfigToTypesBase.h>
+#include <dmzRuntimeConfigToVector.h>
+#include <dmzRuntimePluginFactoryLinkSymbol.h>
+#include <dmzRuntimePluginInfo.h>
+#include <dmzTypesMath.h>
+#include <dmzTypesVector.h>
+
+namespace {
+
+static const dmz::Vector Up (0.0, 1.0, 0.0);
+static const dmz::Vector Down (0.0, -1.0, 0.0);
+static const dmz::Vector Offset (0.0, 1.5, 0.0);
+
+// Same rules as dmz::isect_validate_point applied to the result of a single test.
+static void
+local_validate_result (
+      const dmz::Vector &Value,
+      const dmz::Vector &Dir,
+      const dmz::IsectResult &Result,
+      dmz::Boolean &found,
+      dmz::Vector &point,
+      dmz::Vector &normal) {
+
+   using namespace dmz;
+
+   Vector cpoint, cnormal;
+   Handle handle (0);
+
+   Result.get_object_handle (handle);
+
+   if (!handle && Result.get_point (cpoint) && Result.get_normal (cnormal)) {
+
+      if (!found ||
+            ((Value - point).magnitude_squared () >
+               (Value - cpoint).magnitude_squared ())) {
+
+         if (cnormal.is_zero ()) { cnormal = Up; }
+
+         Handle cullMode (0);
+
+         Result.get_cull_mode (cullMode);
+
+         if (!(cullMode & IsectPolygonBackCulledMask) &&
+               !(cullMode & IsectPolygonFrontCulledMask)) {
+
+            if (Dir.get_angle (cnormal) < HalfPi64) { cnormal = -cnormal; }
+         }
+         else if (cullMode & IsectPolygonFrontCulledMask) { cnormal = -cnormal; }
+
+         if (Dir.get_angle (cnormal) > HalfPi64) {
+
+            found = True;
+            point = cpoint;
+            normal = cnormal;
+         }
+      }
+   }
+}
+
+};
+
+
+/*!
+
+\class dmz::RenderModuleTerrainBasic
+\ingroup Render
+\brief Finds terrain points using height fields with an intersection fallback.
+\details Positions inside a height field are clamped with a bilinear lookup of the
+field. Positions outside every height field are clamped with ray intersection tests
+against the RenderModuleIsect. All the positions of a batch that need the fallback are
+tested with a single call to dmz::RenderModuleIsect::do_isect.
+\n
+Height fields are raw files with no header. See dmz::IsectHeightField for the layout.
+Columns run along the X axis and rows run along the Z axis starting at the origin given
+by the x, y, and z attributes. The min and max attributes scale integer samples.
+\code
+<dmzRenderModuleTerrainBasic>
+   <height-map
+      resource="Raw height file resource"
+      format="uint8, uint16, or float32"
+      columns="Number of samples along the X axis"
+      rows="Number of samples along the Z axis"
+      interval-x="Distance between samples along the X axis"
+      interval-z="Distance between samples along the Z axis"
+      min="Height of the smallest integer sample"
+      max="Height of the largest integer sample"
+      x="" y="" z=""
+   />
+   <fallback isect="Boolean, defaults to true"/>
+</dmzRenderModuleTerrainBasic>
+\endcode
+
+*/
+
+//! \cond
+dmz::RenderModuleTerrainBasic::RenderModuleTerrainBasic (
+      const PluginInfo &Info,
+      Config &local) :
+      Plugin (Info),
+      RenderModuleTerrain (Info),
+      _log (Info),
+      _rc (Info, &_log),
+      _isect (0),
+      _useIsect (True),
+      _fieldList (0),
+      _fieldCount (0),
+      _foundList (0),
+      _foundCount (0) {
+
+   _init (local);
+}
+
+
+dmz::RenderModuleTerrainBasic::~RenderModuleTerrainBasic () {
+
+   for (Int32 ix = 0; ix < _fieldCount; ix++) {
+
+      delete _fieldList[ix]; _fieldList[ix] = 0;
+   }
+
+   if (_fieldList) { delete []_fieldList; _fieldList = 0; }
+   if (_foundList) { delete []_foundList; _foundList = 0; }
+}
+
+
+// Plugin Interface
+void
+dmz::RenderModuleTerrainBasic::discover_plugin (
+      const PluginDiscoverEnum Mode,
+      const Plugin *PluginPtr) {
+
+   if (Mode == PluginDiscoverAdd) {
+
+      if (!_isect && _useIsect) { _isect = RenderModuleIsect::cast (PluginPtr); }
+   }
+   else if (Mode == PluginDiscoverRemove) {
+
+      if (_isect && (_isect == RenderModuleIsect::cast (PluginPtr))) { _isect = 0; }
+   }
+}
+
+
+// RenderModuleTerrain Interface
+dmz::Boolean
+dmz::RenderModuleTerrainBasic::get_terrain_point (
+      const Vector &Value,
+      Vector &point,
+      Vector &normal) {
+
+   Boolean result (False);
+
+   get_terrain_points (1, &Value, &point, &normal, &result);
+
+   return result;
+}
+
+
+dmz::Int32
+dmz::RenderModuleTerrainBasic::get_terrain_points (
+      const Int32 Count,
+      const Vector *Values,
+      Vector *points,
+      Vector *normals,
+      Boolean *found) {
+
+   Int32 result (0);
+
+   if ((Count > 0) && Values && points && normals) {
+
+      if (!found) {
+
+         if (_foundCount < Count) {
+
+            if (_foundList) { delete []_foundList; _foundList = 0; }
+            _foundList = new Boolean[Count];
+            _foundCount = Count;
+         }
+
+         found = _foundList;
+      }
+
+      for (Int32 ix = 0; ix < Count; ix++) {
+
+         found[ix] = False;
+
+         for (Int32 jy = 0; !found[ix] && (jy < _fieldCount); jy++) {
+
+            found[ix] = _fieldList[jy]->get_point (Values[ix], points[ix], normals[ix]);
+         }
+
+         if (found[ix]) { result++; }
+      }
+
+      if (_isect && (result < Count)) {
+
+         result += _isect_points (Count, Values, Down, points, normals, found);
+      }
+
+      if (_isect && (result < Count)) {
+
+         result += _isect_points (Count, Values, Up, points, normals, found);
+      }
+   }
+
+   return result;
+}
+
+
+dmz::Int32
+dmz::RenderModuleTerrainBasic::_isect_points (
+      const Int32 Count,
+      const Vector *Values,
+      const Vector &Dir,
+      Vector *points,
+      Vector *normals,
+      Boolean *found) {
+
+   Int32 result (0);
+
+   _isectTests.clear ();
+   _isectResults.clear ();
+
+   const Vector Start (Dir.get_y () < 0.0 ? Offset : -Offset);
+
+   for (Int32 ix = 0; ix < Count; ix++) {
+
+      if (!found[ix]) {
+
+         _isectTests.set_test (UInt32 (ix + 1), IsectRayTest, Values[ix] + Start, Dir);
+      }
+   }
+
+   if (_isect->do_isect (_isectParameters, _isectTests, _isectResults)) {
+
+      IsectResult value;
+
+      Boolean next (_isectResults.get_first (value));
+
+      while (next) {
+
+         const Int32 Index (Int32 (value.get_isect_test_id ()) - 1);
+
+         if ((Index >= 0) && (Index < Count)) {
+
+            // Tests were only added for positions that were not found so a
+            // point found by an earlier pass is never replaced.
+            Boolean &valid (found[Index]);
+            const Boolean WasValid (valid);
+
+            local_validate_result (
+               Values[Index],
+               Dir,
+               value,
+               valid,
+               points[Index],
+               normals[Index]);
+
+            if (valid && !WasValid) { result++; }
+         }
+
+         next = _isectResults.get_next (value);
+      }
+   }
+
+   return result;
+}
+
+
+void
+dmz::RenderModuleTerrainBasic::_init_height_map (Config &local) {
+
+   const String MapName (config_to_string ("resource", local));
+   const String MapFile (_rc.find_file (MapName));
+   const String Format (config_to_string ("format", local, "uint8"));
+
+   IsectHeightFormatEnum format (IsectHeightUInt8);
+
+   if (Format == "uint16") { format = IsectHeightUInt16; }
+   else if (Format == "float32") { format = IsectHeightFloat32; }
+   else if (Format != "uint8") {
+
+      _log.error << "Unknown height map format: " << Format << endl;
+   }
+
+   IsectHeightField *field (new IsectHeightField);
+
+   const Boolean Created (field->create (
+      config_to_vector (local),
+      config_to_int32 ("columns", local),
+      config_to_int32 ("rows", local),
+      config_to_float64 ("interval-x", local, 1.0),
+      config_to_float64 ("interval-z", local, 1.0)));
+
+   if (!Created) {
+
+      _log.error << "Invalid height map dimensions for resource: " << MapName << endl;
+   }
+   else if (!MapFile) {
+
+      _log.error << "Unable to find height map resource: " << MapName << endl;
+   }
+   else if (!field->load_raw (
+         MapFile,
+         format,
+         config_to_float64 ("min", local, 0.0),
+         config_to_float64 ("max", local, 1.0))) {
+
+      _log.error << "Height map file is smaller than the height map: " << MapFile
+         << endl;
+   }
+   else {
+
+      IsectHeightField **list (new IsectHeightField *[_fieldCount + 1]);
+
+      for (Int32 ix = 0; ix < _fieldCount; ix++) { list[ix] = _fieldList[ix]; }
+
+      list[_fieldCount] = field; field = 0;
+
+      if (_fieldList) { delete []_fieldList; }
+      _fieldList = list;
+      _fieldCount++;
+
+      _log.info << "Loaded height map: " << MapFile << endl;
+   }
+
+   if (field) { delete field; field = 0; }
+}
+
+
+void
+dmz::RenderModuleTerrainBasic::_init (Config &local) {
+
+   Config list;
+
+   if (local.lookup_all_config ("height-map", list)) {
+
+      ConfigIterator it;
+      Config map;
+
+      while (list.get_next_config (it, map)) { _init_height_map (map); }
+   }
+
+   _useIsect = config_to_boolean ("fallback.isect", local, _useIsect);
+
+   _isectParameters.set_test_result_type (IsectAllPoints);
+   _isectParameters.set_calculate_normal (True);
+   _isectParameters.set_calculate_object_handle (True);
+   _isectParameters.set_calculate_distance (False);
+   _isectParameters.set_calculate_cull_mode (True);
+}
+//! \endcond
+
+
+extern "C" {
+
+DMZ_PLUGIN_FACTORY_LINK_SYMBOL dmz::Plugin *
+create_dmzRenderModuleTerrainBasic (
+      const dmz::PluginInfo &Info,
+      dmz::Config &local,
+      dmz::Config &global) {
+
+   return new dmz::RenderModuleTerrainBasic (Info, local);
+}
+
+};
@@ -0,0 +1,82 @@
+#ifndef DMZ_RENDER_MODULE_TERRAIN_BASIC_DOT_H
+#define DMZ_RENDER_MODULE_TERRAIN_BASIC_DOT_H
+
+#include <dmzRenderIsect.h>
+#include <dmzRenderModuleTerrain.h>
+#include <dmzRuntimeLog.h>
+#include <dmzRuntimePlugin.h>
+#include <dmzRuntimeResources.h>
+
+namespace dmz {
+
+   class IsectHeightField;
+   class RenderModuleIsect;
+
+   class RenderModuleTerrainBasic :
+         public Plugin,
+         private RenderModuleTerrain {
+
+      //! \cond
+      public:
+         RenderModuleTerrainBasic (const PluginInfo &Info, Config &local);
+         ~RenderModuleTerrainBasic ();
+
+         // Plugin Interface
+         virtual void update_plugin_state (
+            const PluginStateEnum State,
+            const UInt32 Level) {;}
+
+         virtual void discover_plugin (
+            const PluginDiscoverEnum Mode,
+            const Plugin *PluginPtr);
+
+         // RenderModuleTerrain Interface
+         virtual Boolean get_terrain_point (
+            const Vector &Value,
+            Vector &point,
+            Vector &normal);
+
+         virtual Int32 get_terrain_points (
+            const Int32 Count,
+            const Vector *Values,
+            Vector *points,
+            Vector *normals,
+            Boolean *found);
+
+      protected:
+         Int32 _isect_points (
+            const Int32 Count,
+            const Vector *Values,
+            const Vector &Dir,
+            Vector *points,
+            Vector *normals,
+            Boolean *found);
+
+         void _init_height_map (Config &local);
+         void _init (Config &local);
+
+         Log _log;
+         Resources _rc;
+
+         RenderModuleIsect *_isect;
+         Boolean _useIsect;
+
+         IsectHeightField **_fieldList;
+         Int32 _fieldCount;
+
+         Boolean *_foundList;
+         Int32 _foundCount;
+
+         IsectParameters _isectParameters;
+         IsectTestContainer _isectTests;
+         IsectResultContainer _isectResults;
+         //! \endcond
+
+      private:
+         RenderModuleTerrainBasic ();
+         RenderModuleTerrainBasic (const RenderModuleTerrainBasic &);
+         RenderModuleTerrainBasic &operator= (const RenderModuleTerrainBasic &);
+   };
+};
+
+#endif // DMZ_RENDER_MODULE_TERRAIN_BASIC_DOT_H
@@ -15,6 +15,7 @@ dmz::RenderPluginObjectLoaderOSG::RenderPluginObjectLoaderOSG (const PluginInfo
       ObjectObserverUtil (Info, local),
       _log (Info),
       _core (0),
+      _cache (0),
       _modelAttrHandle (0),
       _objectTable () {
 
@@ -57,6 +58,7 @@ dmz::RenderPluginObjectLoaderOSG::discover_plugin (
    if (Mode == PluginDiscoverAdd) {
 
       if (!_core) { _core = RenderModuleCoreOSG::cast (PluginPtr); }
+      if (!_cache) { _cache = RenderModuleModelCacheOSG::cast (PluginPtr); }
    }
    else if (Mode == PluginDiscoverRemove) {
 
@@ -74,6 +76,12 @@ dmz::RenderPluginObjectLoaderOSG::discover_plugin (
          
          _core = 0;
       }
+
+      if (_cache && (_cache == RenderModuleModelCacheOSG::cast (PluginPtr))) {
+
+         _cache->release_model_observer (*this);
+         _cache = 0;
+      }
    }
 }
 
@@ -131,22 +139,17 @@ dmz::RenderPluginObjectLoaderOSG::update_object_text (
          if (!os) {
             
             os = new ObjectStruct;
-            os->model = osgDB::readNodeFile (Value.get_buffer ());
+
+            if (_cache) { _lookup_model (Value, *os); }
+            else { os->model = _load_model (Value); }
             
             if (os->model.valid ()) {
 
-               osgUtil::Optimizer optimizer;
-               optimizer.optimize (os->model.get (),
-                  osgUtil::Optimizer::DEFAULT_OPTIMIZATIONS &
-                  !osgUtil::Optimizer::OPTIMIZE_TEXTURE_SETTINGS);
-               
                osg::Group *group (_core->create_dynamic_object (ObjectHandle));
 
                if (group) { group->addChild (os->model.get ()); }
                
                _objectTable.store (ObjectHandle, os);
-
-               _log.info << "Loaded file: " << Value << endl;
             }
             else {
                
@@ -159,6 +162,75 @@ dmz::RenderPluginObjectLoaderOSG::update_object_text (
 }
 
 
+// Render Model Observer OSG Interface
+void
+dmz::RenderPluginObjectLoaderOSG::update_model (
+      const String &ResourceName,
+      osg::Node *model) {
+
+   HashTableHandleIterator it;
+   ObjectStruct *os (0);
+
+   while (_objectTable.get_next (it, os)) {
+
+      if (os->pending && (os->resource == ResourceName)) {
+
+         osg::Group *group (
+            _core ? _core->lookup_dynamic_object (it.get_hash_key ()) : 0);
+
+         if (group && os->model.valid ()) {
+
+            if (model) { group->replaceChild (os->model.get (), model); }
+            else { group->removeChild (os->model.get ()); }
+         }
+
+         os->model = model;
+         os->pending = False;
+      }
+   }
+}
+
+
+void
+dmz::RenderPluginObjectLoaderOSG::_lookup_model (
+      const String &FileName,
+      ObjectStruct &os) {
+
+   os.resource = FileName;
+   os.model = _cache->lookup_model (FileName);
+
+   if (!os.model.valid () && _cache->request_model (FileName, this)) {
+
+      os.model = _cache->lookup_model (FileName);
+
+      if (!os.model.valid ()) {
+
+         os.model = _cache->get_placeholder_model ();
+         os.pending = True;
+      }
+   }
+}
+
+
+osg::Node *
+dmz::RenderPluginObjectLoaderOSG::_load_model (const String &FileName) {
+
+   osg::Node *result (osgDB::readNodeFile (FileName.get_buffer ()));
+
+   if (result) {
+
+      osgUtil::Optimizer optimizer;
+      optimizer.optimize (result,
+         osgUtil::Optimizer::DEFAULT_OPTIMIZATIONS &
+         !osgUtil::Optimizer::OPTIMIZE_TEXTURE_SETTINGS);
+
+      _log.info << "Loaded file: " << FileName << endl;
+   }
+
+   return result;
+}
+
+
 void
 dmz::RenderPluginObjectLoaderOSG::_init (Config &local) {
 
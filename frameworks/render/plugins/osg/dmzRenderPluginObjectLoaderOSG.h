@@ -2,6 +2,7 @@
 #define DMZ_RENDER_PLUGIN_OBJECT_LOADER_OSG_DOT_H
 
 #include <dmzObjectObserverUtil.h>
+#include <dmzRenderModuleModelCacheOSG.h>
 #include <dmzRuntimeLog.h>
 #include <dmzRuntimePlugin.h>
 #include <dmzTypesHashTableHandleTemplate.h>
@@ -16,7 +17,8 @@ namespace dmz {
 
    class RenderPluginObjectLoaderOSG :
          public Plugin,
-         public ObjectObserverUtil {
+         public ObjectObserverUtil,
+         public RenderModelObserverOSG {
 
       public:
          RenderPluginObjectLoaderOSG (const PluginInfo &Info, Config &local);
@@ -197,16 +199,26 @@ namespace dmz {
             const Data &Value,
             const Data *PreviousValue) {;}
 
+         // Render Model Observer OSG Interface
+         virtual void update_model (const String &ResourceName, osg::Node *model);
+
       protected:
-         void _init (Config &local);
-         
          struct ObjectStruct {
 
+            String resource;
+            Boolean pending;
             osg::ref_ptr<osg::Node> model;
+
+            ObjectStruct () : pending (False) {;}
          };
 
+         void _lookup_model (const String &FileName, ObjectStruct &os);
+         osg::Node *_load_model (const String &FileName);
+         void _init (Config &local);
+
          Log _log;
          RenderModuleCoreOSG *_core;
+         RenderModuleModelCacheOSG *_cache;
          Handle _modelAttrHandle;
          HashTableHandleTemplate<ObjectStruct> _objectTable;
 
@@ -22,10 +22,12 @@ dmz::RenderPluginObjectOSG::RenderPluginObjectOSG (
       _defs (Info, &_log),
       _rc (Info, &_log),
       _core (0),
+      _cache (0),
       _cullMask (0),
       _masterIsectMask (0),
       _entityIsectMask (0),
-      _glyphIsectMask (0) {
+      _glyphIsectMask (0),
+      _lodHandle (0) {
 
    _noModel.model = new osg::Group;
    _init (local);
@@ -82,6 +84,8 @@ dmz::RenderPluginObjectOSG::discover_plugin (
             _add_models ();
          }
       }
+
+      if (!_cache) { _cache = RenderModuleModelCacheOSG::cast (PluginPtr); }
    }
    else if (Mode == PluginDiscoverRemove) {
 
@@ -94,6 +98,12 @@ dmz::RenderPluginObjectOSG::discover_plugin (
          _entityIsectMask = 0;
          _glyphIsectMask = 0;
       }
+
+      if (_cache && (_cache == RenderModuleModelCacheOSG::cast (PluginPtr))) {
+
+         _cache->release_model_observer (*this);
+         _cache = 0;
+      }
    }
 }
 
@@ -142,11 +152,11 @@ dmz::RenderPluginObjectOSG::create_object (
 
                if (group) {
 
-                  os->model->setNodeMask (
-                     (os->model->getNodeMask () & ~_masterIsectMask) |
+                  os->root->setNodeMask (
+                     (os->root->getNodeMask () & ~_masterIsectMask) |
                         (os->Def.Glyph ? _glyphIsectMask : _entityIsectMask));
 
-                  group->addChild (os->model.get ());
+                  group->addChild (os->root.get ());
                }
             }
          }
@@ -165,11 +175,11 @@ dmz::RenderPluginObjectOSG::destroy_object (
 
    if (os) {
 
-      if (_core && os->model.valid ()) {
+      if (_core && os->root.valid ()) {
 
          osg::Group *group (_core->lookup_dynamic_object (ObjectHandle));
 
-         if (group) { group->removeChild (os->model.get ()); }
+         if (group) { group->removeChild (os->root.get ()); }
       }
 
       delete os; os = 0;
@@ -214,14 +224,14 @@ dmz::RenderPluginObjectOSG::update_object_flag (
 
    ObjectStruct *os (_objectTable.lookup (ObjectHandle));
 
-   if (os && os->model.valid ()) {
+   if (os && os->root.valid ()) {
 
-      UInt32 mask = os->model->getNodeMask ();
+      UInt32 mask = os->root->getNodeMask ();
 
       if (Value) { mask &= (~_cullMask); }
       else { mask |= _cullMask; }
 
-      os->model->setNodeMask (mask);
+      os->root->setNodeMask (mask);
    }
 }
 
@@ -237,6 +247,76 @@ dmz::RenderPluginObjectOSG::update_object_scale (
 }
 
 
+void
+dmz::RenderPluginObjectOSG::update_object_scalar (
+      const UUID &Identity,
+      const Handle ObjectHandle,
+      const Handle AttributeHandle,
+      const Float64 Value,
+      const Float64 *PreviousValue) {
+
+   ObjectStruct *os (_objectTable.lookup (ObjectHandle));
+
+   if (os && os->lod.valid () && (AttributeHandle == _lodHandle)) {
+
+      const Int32 Level = Int32 (Value);
+      Int32 found (0);
+      unsigned int place (0);
+
+      LODStruct *ls (os->Def.lodMap);
+
+      while (ls) {
+
+         if ((ls->Level <= Level) && (ls->Level > found)) {
+
+            found = ls->Level;
+            place = ls->Place;
+         }
+
+         ls = ls->next;
+      }
+
+      os->lod->setSingleChildOn (place);
+   }
+}
+
+
+// Render Model Observer OSG Interface
+void
+dmz::RenderPluginObjectOSG::update_model (
+      const String &ResourceName,
+      osg::Node *model) {
+
+   HashTableHandleIterator it;
+   DefStruct *ds (0);
+
+   while (_defTable.get_next (it, ds)) {
+
+      PendingStruct *prev (0);
+      PendingStruct *current (ds->pendingList);
+
+      while (current) {
+
+         PendingStruct *next (current->next);
+
+         if (current->ResourceName == ResourceName) {
+
+            _update_pending (*ds, *current, model);
+
+            if (prev) { prev->next = next; }
+            else { ds->pendingList = next; }
+
+            current->next = 0;
+            delete current;
+         }
+         else { prev = current; }
+
+         current = next;
+      }
+   }
+}
+
+
 dmz::RenderPluginObjectOSG::DefStruct *
 dmz::RenderPluginObjectOSG::_lookup_def_struct (const ObjectType &Type) {
 
@@ -296,9 +376,10 @@ dmz::RenderPluginObjectOSG::_create_def_struct (const ObjectType &Type) {
 
             if (!StateNameFound || state) {
 
-               ModelStruct *ms = (NoModel ? &_noModel : _load_model (ResourceName));
+               osg::Node *node (NoModel ?
+                  _noModel.model.get () : _lookup_model (ResourceName, *result));
 
-               if (ms) {
+               if (node) {
 
                   unsigned int switchPlace (StateNameFound ? place : 0);
                   if (StateNameFound) { place++; }
@@ -306,7 +387,7 @@ dmz::RenderPluginObjectOSG::_create_def_struct (const ObjectType &Type) {
                   if (((switchPlace + 1) > result->model->getNumChildren ()) ||
                         !result->model->getChild (switchPlace)) {
 
-                     result->model->insertChild (switchPlace, ms->model.get ());
+                     result->model->insertChild (switchPlace, node);
 
                      if (switchPlace) {
 
@@ -323,6 +404,8 @@ dmz::RenderPluginObjectOSG::_create_def_struct (const ObjectType &Type) {
                }
             }
          }
+
+         _create_lod_models (Type, *result);
       }
       else { delete result; result = 0; }
    }
@@ -331,6 +414,49 @@ dmz::RenderPluginObjectOSG::_create_def_struct (const ObjectType &Type) {
 }
 
 
+void
+dmz::RenderPluginObjectOSG::_create_lod_models (const ObjectType &Type, DefStruct &def) {
+
+   Config lodList;
+
+   if (_lodHandle && Type.get_config ().lookup_all_config ("render.lod", lodList)) {
+
+      ConfigIterator it;
+      Config lod;
+
+      while (lodList.get_next_config (it, lod)) {
+
+         const Int32 Level (config_to_int32 ("level", lod, 0));
+         const String ResourceName (config_to_string ("resource", lod));
+
+         osg::Node *node (
+            (Level > 0) && ResourceName ? _lookup_model (ResourceName, def) : 0);
+
+         if (node) {
+
+            if (!def.lod.valid ()) {
+
+               def.lod = new osg::Switch;
+               def.lod->setDataVariance (osg::Object::DYNAMIC);
+               def.lod->addChild (def.model.get ());
+            }
+
+            LODStruct *ls (new LODStruct (Level, def.lod->getNumChildren ()));
+            def.lod->addChild (node);
+
+            ls->next = def.lodMap;
+            def.lodMap = ls;
+         }
+         else if (Level <= 0) {
+
+            _log.error << "Invalid level of detail: " << Level << " for type: "
+               << Type.get_name () << endl;
+         }
+      }
+   }
+}
+
+
 dmz::RenderPluginObjectOSG::ModelStruct *
 dmz::RenderPluginObjectOSG::_load_model (const String &ResourceName) {
 
@@ -374,6 +500,81 @@ dmz::RenderPluginObjectOSG::_load_model (const String &ResourceName) {
 }
 
 
+osg::Node *
+dmz::RenderPluginObjectOSG::_lookup_model (const String &ResourceName, DefStruct &def) {
+
+   osg::Node *result (0);
+
+   if (!_cache) {
+
+      ModelStruct *ms (_load_model (ResourceName));
+      if (ms) { result = ms->model.get (); }
+   }
+   else if (!(result = _cache->lookup_model (ResourceName)) &&
+         _cache->request_model (ResourceName, this)) {
+
+      result = _cache->lookup_model (ResourceName);
+
+      if (!result) {
+
+         // The placeholder is replaced by update_model when the cache has loaded
+         // the model.
+         PendingStruct *ps (new PendingStruct (ResourceName));
+         ps->slot->addChild (_cache->get_placeholder_model ());
+         ps->next = def.pendingList;
+         def.pendingList = ps;
+
+         result = ps->slot.get ();
+      }
+   }
+
+   return result;
+}
+
+
+void
+dmz::RenderPluginObjectOSG::_update_pending (
+      DefStruct &def,
+      PendingStruct &ps,
+      osg::Node *model) {
+
+   // The slot is either a state model or a simplified level of detail model.
+   unsigned int place (def.model->getChildIndex (ps.slot.get ()));
+   const Boolean IsLOD (place >= def.model->getNumChildren ());
+   osg::Switch *parent (def.model.get ());
+
+   if (IsLOD && def.lod.valid ()) {
+
+      parent = def.lod.get ();
+      place = parent->getChildIndex (ps.slot.get ());
+   }
+
+   if (place < parent->getNumChildren ()) {
+
+      osg::Node *node (model ? model : _noModel.model.get ());
+
+      parent->setChild (place, node);
+
+      // Each object holds a deep copy of the definition's models so the copies of
+      // the placeholder are replaced as well.
+      HashTableHandleIterator it;
+      ObjectStruct *os (0);
+
+      while (_objectTable.get_next (it, os)) {
+
+         osg::Switch *target (IsLOD ? os->lod.get () : os->model.get ());
+
+         if ((&(os->Def) == &def) && target && (place < target->getNumChildren ())) {
+
+            target->setChild (
+               place,
+               (osg::Node *)node->clone (osg::CopyOp::DEEP_COPY_NODES));
+         }
+      }
+   }
+}
+
+
 void
 dmz::RenderPluginObjectOSG::_add_models () {
 
@@ -386,13 +587,13 @@ dmz::RenderPluginObjectOSG::_add_models () {
 
          osg::Group *group (_core->create_dynamic_object (it.get_hash_key ()));
 
-         if (os->model.valid () && group) {
+         if (os->root.valid () && group) {
 
-            os->model->setNodeMask (
-               (os->model->getNodeMask () & ~_masterIsectMask) |
+            os->root->setNodeMask (
+               (os->root->getNodeMask () & ~_masterIsectMask) |
                   (os->Def.Glyph ? _glyphIsectMask : _entityIsectMask));
 
-            group->addChild (os->model.get ());
+            group->addChild (os->root.get ());
          }
       }
    }
@@ -411,11 +612,11 @@ dmz::RenderPluginObjectOSG::_remove_models () {
 
          osg::Group *group (_core->lookup_dynamic_object (it.get_hash_key ()));
 
-         if (os->model.valid () && group) {
+         if (os->root.valid () && group) {
 
-            os->model->setNodeMask (os->model->getNodeMask () | _masterIsectMask);
+            os->root->setNodeMask (os->root->getNodeMask () | _masterIsectMask);
 
-            group->removeChild (os->model.get ());
+            group->removeChild (os->root.get ());
          }
       }
    }
@@ -434,6 +635,10 @@ dmz::RenderPluginObjectOSG::_init (Config &local) {
       config_to_string ("hide-object-flag.name", local, ObjectAttributeHideName),
       ObjectFlagMask);
 
+   _lodHandle = activate_object_attribute (
+      config_to_string ("lod.attribute.name", local, RenderLODLevelName),
+      ObjectScalarMask);
+
    set_resources_observer_callback_mask (ResourcesDumpNone, ResourcesResourceMask);
 
    set_definitions_observer_callback_mask (
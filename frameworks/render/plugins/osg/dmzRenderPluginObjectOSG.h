@@ -2,6 +2,7 @@
 #define DMZ_RENDER_PLUGIN_OBJECT_OSG_DOT_H
 
 #include <dmzObjectObserverUtil.h>
+#include <dmzRenderModuleModelCacheOSG.h>
 #include <dmzRuntimeDefinitions.h>
 #include <dmzRuntimeDefinitionsObserver.h>
 #include <dmzRuntimeLog.h>
@@ -23,7 +24,8 @@ namespace dmz {
          public Plugin,
          public ResourcesObserver,
          public DefinitionsObserver,
-         public ObjectObserverUtil {
+         public ObjectObserverUtil,
+         public RenderModelObserverOSG {
 
       public:
          RenderPluginObjectOSG (const PluginInfo &Info, Config &local);
@@ -76,6 +78,16 @@ namespace dmz {
             const Vector &Value,
             const Vector *PreviousValue);
 
+         virtual void update_object_scalar (
+            const UUID &Identity,
+            const Handle ObjectHandle,
+            const Handle AttributeHandle,
+            const Float64 Value,
+            const Float64 *PreviousValue);
+
+         // Render Model Observer OSG Interface
+         virtual void update_model (const String &ResourceName, osg::Node *model);
+
       protected:
          struct ModelStruct {
 
@@ -97,31 +109,87 @@ namespace dmz {
             ~StateStruct () {;}
          };
 
+         struct LODStruct {
+
+            const Int32 Level;
+            const unsigned int Place;
+
+            LODStruct *next;
+
+            LODStruct (const Int32 TheLevel, const unsigned int ThePlace) :
+               Level (TheLevel),
+               Place (ThePlace),
+               next (0) {;}
+
+            ~LODStruct () {;}
+         };
+
+         // Holds the place of a model that is still being loaded by the model cache.
+         struct PendingStruct {
+
+            const String ResourceName;
+            osg::ref_ptr<osg::Group> slot;
+            PendingStruct *next;
+
+            PendingStruct (const String &TheResourceName) :
+                  ResourceName (TheResourceName),
+                  next (0) {
+
+               slot = new osg::Group;
+            }
+
+            ~PendingStruct () {;}
+         };
+
          struct DefStruct {
 
             const Boolean Glyph;
             osg::ref_ptr<osg::Switch> model;
+            osg::ref_ptr<osg::Switch> lod;
             StateStruct *stateMap;
+            LODStruct *lodMap;
+            PendingStruct *pendingList;
 
-            DefStruct (const Boolean IsGlyph) : Glyph (IsGlyph), stateMap (0) {
+            DefStruct (const Boolean IsGlyph) :
+                  Glyph (IsGlyph),
+                  stateMap (0),
+                  lodMap (0),
+                  pendingList (0) {
 
                model = new osg::Switch;
                model->setDataVariance (osg::Object::DYNAMIC);
             }
 
-            ~DefStruct () { delete_list (stateMap); }
+            ~DefStruct () {
+
+               delete_list (stateMap);
+               delete_list (lodMap);
+               delete_list (pendingList);
+            }
          };
  
+         // The root is the level of detail switch when the definition has simplified
+         // models. Otherwise the root is the state switch.
          struct ObjectStruct {
 
             const DefStruct &Def;
             osg::ref_ptr<osg::Switch> model;
+            osg::ref_ptr<osg::Switch> lod;
+            osg::ref_ptr<osg::Switch> root;
 
             ObjectStruct (DefStruct &TheDef) : Def (TheDef) {
 
-               if (Def.model.valid ()) {
+               if (Def.lod.valid ()) {
+
+                  lod = (osg::Switch *)Def.lod->clone (osg::CopyOp::DEEP_COPY_NODES);
+                  model = (osg::Switch *)lod->getChild (0);
+                  lod->setSingleChildOn (0);
+                  root = lod;
+               }
+               else if (Def.model.valid ()) {
 
                   model = (osg::Switch *)Def.model->clone (osg::CopyOp::DEEP_COPY_NODES);
+                  root = model;
                }
             }
          };
@@ -129,6 +197,9 @@ namespace dmz {
          DefStruct *_lookup_def_struct (const ObjectType &Type);
          DefStruct *_create_def_struct (const ObjectType &Type);
          ModelStruct *_load_model (const String &FileName);
+         osg::Node *_lookup_model (const String &ResourceName, DefStruct &def);
+         void _update_pending (DefStruct &def, PendingStruct &ps, osg::Node *model);
+         void _create_lod_models (const ObjectType &Type, DefStruct &def);
          void _add_models ();
          void _remove_models ();
          void _init (Config &local);
@@ -138,6 +209,7 @@ namespace dmz {
          Resources _rc;
 
          RenderModuleCoreOSG *_core;
+         RenderModuleModelCacheOSG *_cache;
 
          HashTableStringTemplate<ModelStruct> _modelTable;
          HashTableHandleTemplate<DefStruct> _defTable;
@@ -150,6 +222,7 @@ namespace dmz {
          UInt32 _masterIsectMask;
          UInt32 _entityIsectMask;
          UInt32 _glyphIsectMask;
+         Handle _lodHandle;
 
       private:
          RenderPluginObjectOSG ();
@@ -16,6 +16,7 @@ dmz::RenderPluginStaticTerrainOSG::RenderPluginStaticTerrainOSG (
       _log (Info),
       _rc (Info, &_log),
       _core (0),
+      _cache (0),
       _modelList (0) {
 
    _init (local);
@@ -36,6 +37,7 @@ dmz::RenderPluginStaticTerrainOSG::update_plugin_state (
 
    if (State == PluginStateInit) {
 
+      _load_models ();
    }
    else if (State == PluginStateStart) {
 
@@ -72,23 +74,22 @@ dmz::RenderPluginStaticTerrainOSG::discover_plugin (
 
                while (current) {
 
-                  if (current->model.valid ()) {
-
-                     if (!current->Isect) {
-
-                        UInt32 mask = current->model->getNodeMask ();
-                        mask &= (~IsectMask);
-                        current->model->setNodeMask (mask);
-                     }
+                  if (!current->Isect) {
 
-                     root->addChild (current->model.get ());
+                     UInt32 mask = current->root->getNodeMask ();
+                     mask &= (~IsectMask);
+                     current->root->setNodeMask (mask);
                   }
 
+                  root->addChild (current->root.get ());
+
                   current = current->next;
                }
             }
          }
       }
+
+      if (!_cache) { _cache = RenderModuleModelCacheOSG::cast (PluginPtr); }
    }
    else if (Mode == PluginDiscoverRemove) {
 
@@ -104,16 +105,13 @@ dmz::RenderPluginStaticTerrainOSG::discover_plugin (
 
             while (current) {
 
-               if (current->model.valid ()) {
+               root->removeChild (current->root.get ());
 
-                  root->removeChild (current->model.get ());
+               if (!current->Isect) {
 
-                  if (!current->Isect) {
-
-                     UInt32 mask = current->model->getNodeMask ();
-                     mask |= IsectMask;
-                     current->model->setNodeMask (mask);
-                  }
+                  UInt32 mask = current->root->getNodeMask ();
+                  mask |= IsectMask;
+                  current->root->setNodeMask (mask);
                }
 
                current = current->next;
@@ -122,60 +120,129 @@ dmz::RenderPluginStaticTerrainOSG::discover_plugin (
 
          _core = 0;
       }
+
+      if (_cache && (_cache == RenderModuleModelCacheOSG::cast (PluginPtr))) {
+
+         _cache->release_model_observer (*this);
+         _cache = 0;
+      }
    }
 }
 
 
+// Render Model Observer OSG Interface
 void
-dmz::RenderPluginStaticTerrainOSG::_init (Config &local) {
+dmz::RenderPluginStaticTerrainOSG::update_model (
+      const String &ResourceName,
+      osg::Node *model) {
 
-   Config list;
+   ModelStruct *current (_modelList);
 
-   if (local.lookup_all_config ("model", list)) {
+   while (current) {
 
-      ConfigIterator it;
-      Config model;
+      if (!current->model.valid () && (current->ResourceName == ResourceName)) {
 
-      while (list.get_next_config (it, model)) {
+         _add_model (*current, model);
+      }
 
-         const String ResourceName = config_to_string ("resource", model);
+      current = current->next;
+   }
+}
 
-         if (ResourceName) {
 
-            const String FileName = _rc.find_file (ResourceName);
-            const Boolean Isect = config_to_boolean ("isect", model, True);
+void
+dmz::RenderPluginStaticTerrainOSG::_load_models () {
 
-            if (FileName) {
+   ModelStruct *current (_modelList);
 
-               ModelStruct *ms = new ModelStruct (Isect);
+   while (current) {
 
-               if (ms) {
+      if (!current->model.valid ()) {
 
-                  ms->model = osgDB::readNodeFile (FileName.get_buffer ());
+         const String ResourceName (current->ResourceName);
 
-                  if (ms->model.valid ()) { 
+         if (_cache) {
 
-                  osg::BoundingSphere bound = ms->model->computeBound ();
-                  _log.info << FileName << " center: ["
-                     << bound.center ().x () << ", "
-                     << bound.center ().y () << ", "
-                     << bound.center ().z () << "]" << endl;
+            osg::Node *model (_cache->lookup_model (ResourceName));
 
-                     ms->next = _modelList;
-                     _modelList = ms;
+            if (!model && _cache->request_model (ResourceName, this)) {
 
-                     _log.info << "Loaded model: " << FileName
-                       << " (" << ResourceName << ")" << endl;
-                  }
-                  else {
+               model = _cache->lookup_model (ResourceName);
+            }
 
-                     delete ms; ms = 0;
-                     _log.error << "Failed loading model: " << FileName
-                        << " (" << ResourceName << ")" << endl;
-                  }
+            // Models that are still loading are added by update_model.
+            if (model) { _add_model (*current, model); }
+         }
+         else {
+
+            const String FileName = _rc.find_file (ResourceName);
+
+            if (FileName) {
+
+               osg::ref_ptr<osg::Node> model (
+                  osgDB::readNodeFile (FileName.get_buffer ()));
+
+               if (model.valid ()) {
+
+                  _add_model (*current, model.get ());
+
+                  _log.info << "Loaded model: " << FileName
+                    << " (" << ResourceName << ")" << endl;
+               }
+               else {
+
+                  _log.error << "Failed loading model: " << FileName
+                     << " (" << ResourceName << ")" << endl;
                }
             }
          }
+      }
+
+      current = current->next;
+   }
+}
+
+
+void
+dmz::RenderPluginStaticTerrainOSG::_add_model (ModelStruct &ms, osg::Node *model) {
+
+   if (model) {
+
+      ms.model = model;
+      ms.root->addChild (model);
+
+      osg::BoundingSphere bound = model->computeBound ();
+      _log.info << ms.ResourceName << " center: ["
+         << bound.center ().x () << ", "
+         << bound.center ().y () << ", "
+         << bound.center ().z () << "]" << endl;
+   }
+}
+
+
+void
+dmz::RenderPluginStaticTerrainOSG::_init (Config &local) {
+
+   Config list;
+
+   if (local.lookup_all_config ("model", list)) {
+
+      ConfigIterator it;
+      Config model;
+
+      while (list.get_next_config (it, model)) {
+
+         const String ResourceName = config_to_string ("resource", model);
+
+         if (ResourceName) {
+
+            ModelStruct *ms = new ModelStruct (
+               ResourceName,
+               config_to_boolean ("isect", model, True));
+
+            ms->next = _modelList;
+            _modelList = ms;
+         }
          else {
 
             _log.error << "No resource name specified for static terrain." << endl;
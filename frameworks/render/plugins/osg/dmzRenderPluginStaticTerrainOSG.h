@@ -1,18 +1,20 @@
 #ifndef DMZ_RENDER_PLUGIN_STATIC_TERRAIN_OSG_DOT_H
 #define DMZ_RENDER_PLUGIN_STATIC_TERRAIN_OSG_DOT_H
 
+#include <dmzRenderModuleModelCacheOSG.h>
 #include <dmzRuntimeLog.h>
 #include <dmzRuntimePlugin.h>
 #include <dmzRuntimeResources.h>
 
-#include <osg/Node>
+#include <osg/Group>
 
 namespace dmz {
 
    class RenderModuleCoreOSG;
 
    class RenderPluginStaticTerrainOSG :
-         public Plugin {
+         public Plugin,
+         public RenderModelObserverOSG {
 
       public:
          RenderPluginStaticTerrainOSG (const PluginInfo &Info, Config &local);
@@ -27,23 +29,35 @@ namespace dmz {
             const PluginDiscoverEnum Mode,
             const Plugin *PluginPtr);
 
+         // Render Model Observer OSG Interface
+         virtual void update_model (const String &ResourceName, osg::Node *model);
+
       protected:
          struct ModelStruct {
 
+            const String ResourceName;
             const Boolean Isect;
             ModelStruct *next;
+            osg::ref_ptr<osg::Group> root;
             osg::ref_ptr<osg::Node> model;
 
-            ModelStruct (const Boolean IsIsect) : Isect (IsIsect), next (0) {;}
+            ModelStruct (const String &TheResourceName, const Boolean IsIsect) :
+                  ResourceName (TheResourceName),
+                  Isect (IsIsect),
+                  next (0) { root = new osg::Group; }
+
             ~ModelStruct () { if (next) { delete next; next = 0; } }
          };
 
+         void _load_models ();
+         void _add_model (ModelStruct &ms, osg::Node *model);
          void _init (Config &local);
 
          Log _log;
          Resources _rc;
 
          RenderModuleCoreOSG *_core;
+         RenderModuleModelCacheOSG *_cache;
 
          ModelStruct *_modelList;
 
@@ -2,6 +2,7 @@
 #include <dmzEventModuleCommon.h>
 #include <dmzObjectAttributeMasks.h>
 #include <dmzObjectModule.h>
+#include <dmzObjectModuleGrid.h>
 #include <dmzRenderIsect.h>
 #include <dmzRenderModuleIsect.h>
 #include <dmzRuntimeConfigToNamedHandle.h>
@@ -10,7 +11,9 @@
 #include <dmzRuntimePluginInfo.h>
 #include <dmzTypesHandleContainer.h>
 #include <dmzTypesMath.h>
+#include <dmzTypesMathBatch.h>
 #include <dmzTypesMatrix.h>
+#include <dmzTypesSphere.h>
 #include <dmzTypesVector.h>
 #include <dmzWeaponConsts.h>
 #include "dmzWeaponPluginTrackingMissile.h"
@@ -29,6 +32,7 @@ dmz::WeaponPluginTrackingMissile::WeaponPluginTrackingMissile (
       _sourceHandle (0),
       _targetLockHandle (0),
       _isect (0),
+      _grid (0),
       _common (0) {
 
    _init (local);
@@ -72,11 +76,13 @@ dmz::WeaponPluginTrackingMissile::discover_plugin (
    if (Mode == PluginDiscoverAdd) {
 
       if (!_isect) { _isect = RenderModuleIsect::cast (PluginPtr); }
+      if (!_grid) { _grid = ObjectModuleGrid::cast (PluginPtr); }
       if (!_common) { _common = EventModuleCommon::cast (PluginPtr); }
    }
    else if (Mode == PluginDiscoverRemove) {
 
       if (_isect && (_isect == RenderModuleIsect::cast (PluginPtr))) { _isect = 0; }
+      if (_grid && (_grid == ObjectModuleGrid::cast (PluginPtr))) { _grid = 0; }
       if (_common && (_common == EventModuleCommon::cast (PluginPtr))) { _common = 0; }
    }
 }
@@ -90,146 +96,417 @@ dmz::WeaponPluginTrackingMissile::update_time_slice (const Float64 TimeDelta) {
 
    if (module && _isect) {
 
-      IsectParameters params;
-      params.set_test_result_type (IsectClosestPoint);
+      _gather_missiles (*module);
 
-      HashTableHandleIterator it;
-      ObjectStruct *obj (0);
+      if (_frame.count > 0) {
 
-      while (_objectTable.get_next (it, obj)) {
+         _acquire_targets (*module);
+         _guide_missiles (*module, TimeDelta);
+         _move_missiles (*module, TimeDelta);
+      }
+
+      // Missiles are destroyed after the frame since destroying an object removes
+      // its ObjectStruct from the object table.
+      Handle object (_destroyList.get_first ());
 
-         _isect->disable_isect (obj->Object);
-         Vector pos, vel, dir (0, 0, -1);
-         Matrix ori;
-         module->lookup_position (obj->Object, _defaultHandle, pos);
-         module->lookup_orientation (obj->Object, _defaultHandle, ori);
-         module->lookup_velocity (obj->Object, _defaultHandle, vel);
-         ori.transform_vector (dir);
+      while (object) {
 
-         if (!obj->target) {
+         module->destroy_object (object);
+         object = _destroyList.get_next ();
+      }
 
-            IsectTestContainer test;
-            IsectResultContainer isectResults;
-            test.set_test (1, IsectSegmentTest, pos, pos + (dir * 100.0));
+      _destroyList.clear ();
+      _frame.count = 0;
+   }
+}
 
-            if (_isect->do_isect (params, test, isectResults)) {
 
-               IsectResult value;
-               isectResults.get_first (value);
-               value.get_object_handle (obj->target);
-            }
+// Object Observer Interface
+void
+dmz::WeaponPluginTrackingMissile::create_object (
+      const UUID &Identity,
+      const Handle ObjectHandle,
+      const ObjectType &Type,
+      const ObjectLocalityEnum Locality) {
+
+   if ((Locality == ObjectLocal) && !_ignoreSet.contains_exact_type (Type) &&
+         _typeSet.contains_type (Type)) {
+
+      _register (ObjectHandle, Type);
+      if (_common) { _common->create_launch_event (ObjectHandle, 0); }
+   }
+}
+
+
+void
+dmz::WeaponPluginTrackingMissile::destroy_object (
+      const UUID &Identity,
+      const Handle ObjectHandle) {
+
+   ObjectStruct *os = _objectTable.remove (ObjectHandle);
+
+   if (os) {
+
+      if ((os->index >= 0) && (os->index < _frame.count) &&
+            (_frame.obj[os->index] == os)) {
+
+         _frame.obj[os->index] = 0;
+      }
+
+      delete os; os = 0;
+   }
+}
+
+
+void
+dmz::WeaponPluginTrackingMissile::update_object_position (
+      const UUID &Identity,
+      const Handle ObjectHandle,
+      const Handle AttributeHandle,
+      const Vector &Value,
+      const Vector *PreviousValue) {
+
+   ObjectStruct *os (_objectTable.lookup (ObjectHandle));
+
+   if (os && os->synced) { os->pos = Value; }
+}
+
+
+void
+dmz::WeaponPluginTrackingMissile::update_object_orientation (
+      const UUID &Identity,
+      const Handle ObjectHandle,
+      const Handle AttributeHandle,
+      const Matrix &Value,
+      const Matrix *PreviousValue) {
+
+   ObjectStruct *os (_objectTable.lookup (ObjectHandle));
+
+   if (os && os->synced) { os->ori = Value; }
+}
+
+
+void
+dmz::WeaponPluginTrackingMissile::update_object_velocity (
+      const UUID &Identity,
+      const Handle ObjectHandle,
+      const Handle AttributeHandle,
+      const Vector &Value,
+      const Vector *PreviousValue) {
+
+   ObjectStruct *os (_objectTable.lookup (ObjectHandle));
+
+   if (os && os->synced) { os->vel = Value; }
+}
+
+
+void
+dmz::WeaponPluginTrackingMissile::_gather_missiles (ObjectModule &module) {
+
+   _frame.count = 0;
+   _frame.reserve (_objectTable.get_count ());
+
+   HashTableHandleIterator it;
+   ObjectStruct *obj (0);
+
+   while (_objectTable.get_next (it, obj)) {
+
+      // The missile state is looked up once and then cached. The cache is kept
+      // current by the position, velocity and orientation callbacks so a missile
+      // moved by another plugin flies from where it was moved to.
+      if (!obj->synced) {
+
+         module.lookup_position (obj->Object, _defaultHandle, obj->pos);
+         module.lookup_velocity (obj->Object, _defaultHandle, obj->vel);
+         module.lookup_orientation (obj->Object, _defaultHandle, obj->ori);
+         obj->synced = True;
+      }
+
+      const Int32 Index (_frame.count);
+
+      obj->index = Index;
+      _frame.obj[Index] = obj;
+      _frame.pos[Index] = obj->pos;
+      _frame.vel[Index] = obj->vel;
+      _frame.dir[Index].set_xyz (0.0, 0.0, -1.0);
+      obj->ori.transform_vector (_frame.dir[Index]);
+      _frame.count++;
+   }
+}
+
+
+void
+dmz::WeaponPluginTrackingMissile::_acquire_targets (ObjectModule &module) {
+
+   if (_grid) {
+
+      for (Int32 ix = 0; ix < _frame.count; ix++) {
+
+         ObjectStruct *obj (_frame.obj[ix]);
+
+         if (obj && !obj->target) { obj->target = _find_target (module, ix); }
+      }
+   }
+   else {
+
+      IsectTestContainer tests;
+      Int32 testCount (0);
+
+      for (Int32 ix = 0; ix < _frame.count; ix++) {
+
+         ObjectStruct *obj (_frame.obj[ix]);
+
+         if (obj && !obj->target) {
+
+            tests.set_test (
+               UInt32 (ix + 1),
+               IsectSegmentTest,
+               _frame.pos[ix],
+               _frame.pos[ix] + (_frame.dir[ix] * obj->Info.AcquireRange));
+
+            testCount++;
          }
+      }
 
-         if (obj->target) {
+      if (testCount > 0) {
+
+         _isect_batch (tests);
+
+         for (Int32 ix = 0; ix < _frame.count; ix++) {
+
+            ObjectStruct *obj (_frame.obj[ix]);
 
-            Vector targetPos;
+            if (obj && !obj->target) { obj->target = _frame.hitObject[ix]; }
+         }
+      }
+   }
+}
 
-            if (module->lookup_position (obj->target, _defaultHandle, targetPos)) {
 
-               if ((pos - targetPos).magnitude () < 2.0) {
+dmz::Handle
+dmz::WeaponPluginTrackingMissile::_find_target (
+      ObjectModule &module,
+      const Int32 Index) {
 
-                  if (_common) {
+   Handle result (0);
 
-                     _common->create_detonation_event (obj->Object, obj->target);
-                  }
+   const ObjectStruct &Obj (*(_frame.obj[Index]));
+   const Vector &Pos (_frame.pos[Index]);
+   const Vector &Dir (_frame.dir[Index]);
 
-                  module->destroy_object (obj->Object);
-                  obj = 0;
-               }
-               else {
+   HandleContainer list;
 
-                  const Vector TargetDir = (targetPos - pos).normalize ();
+   _grid->find_objects (
+      Sphere (Pos, Obj.Info.AcquireRange),
+      list,
+      _targetSet.get_count () > 0 ? &_targetSet : 0,
+      &_typeSet);
 
-                  const Float64 Rot = dir.get_angle (TargetDir);
+   Float64 bestAngle (0.0);
+   Float64 bestDistance (0.0);
 
-                  if (Rot > HalfPi64) { obj->target = 0; }
-                  else {
+   Handle current (list.get_first ());
 
-                     const Float64 MaxTurn = obj->Info.MaxTurn * TimeDelta;
+   while (current) {
 
-                     if (fabs (Rot) > MaxTurn) {
+      Vector targetPos;
 
-                        const Vector Axis = dir.cross (TargetDir);
+      if ((current != Obj.Object) && (current != Obj.Source) &&
+            module.lookup_position (current, _defaultHandle, targetPos)) {
 
-                        ori = Matrix (Axis, Rot > 0.0 ? MaxTurn : -MaxTurn) * ori;
-                     }
-                  }
-               }
-            }
+         const Vector Offset (targetPos - Pos);
+         const Float64 Distance (Offset.magnitude ());
+         const Float64 Angle (Dir.get_angle (Offset));
+
+         if ((Distance <= Obj.Info.AcquireRange) && (Angle <= Obj.Info.AcquireAngle) &&
+               (!result || (Angle < bestAngle) ||
+                  ((Angle == bestAngle) && (Distance < bestDistance)))) {
+
+            result = current;
+            bestAngle = Angle;
+            bestDistance = Distance;
          }
+      }
 
-         if (obj) {
+      current = list.get_next ();
+   }
 
-            Float64 speed = vel.magnitude ();
+   return result;
+}
 
-            if (speed < obj->Info.MaxSpeed) {
 
-               speed += obj->Info.Acceleration * TimeDelta;
+void
+dmz::WeaponPluginTrackingMissile::_guide_missiles (
+      ObjectModule &module,
+      const Float64 TimeDelta) {
 
-               if (speed > obj->Info.MaxSpeed) { speed = obj->Info.MaxSpeed; }
-            }
+   for (Int32 ix = 0; ix < _frame.count; ix++) {
 
-            Vector vel (0.0, 0.0, -speed);
-            ori.transform_vector (vel);
-            const Vector NewPos (pos + (vel * TimeDelta));
+      ObjectStruct *obj (_frame.obj[ix]);
 
-            IsectTestContainer test;
-            IsectResultContainer isectResults;
-            test.set_test (1, IsectSegmentTest, pos, NewPos);
+      _frame.targetDir[ix].set_xyz (0.0, 0.0, 0.0);
 
-            if (_isect->do_isect (params, test, isectResults)) {
+      if (obj && obj->target) {
 
-               if (_common) {
+         Vector targetPos;
 
-                  IsectResult value;
-                  isectResults.get_first (value);
-                  Handle target (0);
-                  value.get_object_handle (target);
-                  _common->create_detonation_event (obj->Object, target);
-               }
+         if (module.lookup_position (obj->target, _defaultHandle, targetPos)) {
 
-               module->destroy_object (obj->Object);
-            }
+            _frame.targetDir[ix] = targetPos - _frame.pos[ix];
+
+            if (_frame.targetDir[ix].magnitude () < 2.0) { _detonate (ix, obj->target); }
+         }
+         else { obj->target = 0; }
+      }
+   }
+
+   normalize_vectors (_frame.targetDir, _frame.count);
+
+   for (Int32 ix = 0; ix < _frame.count; ix++) {
+
+      ObjectStruct *obj (_frame.obj[ix]);
+
+      if (obj) {
+
+         if (obj->target) {
+
+            const Vector &Dir (_frame.dir[ix]);
+            const Vector &TargetDir (_frame.targetDir[ix]);
+            const Float64 Rot = Dir.get_angle (TargetDir);
+
+            if (Rot > HalfPi64) { obj->target = 0; }
             else {
 
-               module->store_position (obj->Object, _defaultHandle, NewPos);
-               module->store_velocity (obj->Object, _defaultHandle, vel);
-               module->store_orientation (obj->Object, _defaultHandle, ori);
+               const Float64 MaxTurn = obj->Info.MaxTurn * TimeDelta;
+
+               if (fabs (Rot) > MaxTurn) {
+
+                  const Vector Axis = Dir.cross (TargetDir);
 
-               // only re-enable isect if object is not destroyed.
-               _isect->enable_isect (obj->Object);
+                  obj->ori = Matrix (Axis, Rot > 0.0 ? MaxTurn : -MaxTurn) * obj->ori;
+               }
             }
          }
+
+         Float64 speed = _frame.vel[ix].magnitude ();
+
+         if (speed < obj->Info.MaxSpeed) {
+
+            speed += obj->Info.Acceleration * TimeDelta;
+
+            if (speed > obj->Info.MaxSpeed) { speed = obj->Info.MaxSpeed; }
+         }
+
+         _frame.vel[ix].set_xyz (0.0, 0.0, -speed);
+         obj->ori.transform_vector (_frame.vel[ix]);
       }
    }
 }
 
 
-// Object Observer Interface
 void
-dmz::WeaponPluginTrackingMissile::create_object (
-      const UUID &Identity,
-      const Handle ObjectHandle,
-      const ObjectType &Type,
-      const ObjectLocalityEnum Locality) {
+dmz::WeaponPluginTrackingMissile::_move_missiles (
+      ObjectModule &module,
+      const Float64 TimeDelta) {
 
-   if ((Locality == ObjectLocal) && !_ignoreSet.contains_exact_type (Type) &&
-         _typeSet.contains_type (Type)) {
+   extrapolate_vectors (_frame.pos, _frame.vel, TimeDelta, _frame.count, _frame.next);
 
-      _register (ObjectHandle, Type);
-      if (_common) { _common->create_launch_event (ObjectHandle, 0); }
+   IsectTestContainer tests;
+
+   for (Int32 ix = 0; ix < _frame.count; ix++) {
+
+      if (_frame.obj[ix]) {
+
+         tests.set_test (
+            UInt32 (ix + 1),
+            IsectSegmentTest,
+            _frame.pos[ix],
+            _frame.next[ix]);
+      }
+   }
+
+   _isect_batch (tests);
+
+   for (Int32 ix = 0; ix < _frame.count; ix++) {
+
+      ObjectStruct *obj (_frame.obj[ix]);
+
+      if (obj) {
+
+         if (_frame.hitDistance[ix] >= 0.0) { _detonate (ix, _frame.hitObject[ix]); }
+         else {
+
+            obj->pos = _frame.next[ix];
+            obj->vel = _frame.vel[ix];
+
+            module.store_position (obj->Object, _defaultHandle, obj->pos);
+            module.store_velocity (obj->Object, _defaultHandle, obj->vel);
+            module.store_orientation (obj->Object, _defaultHandle, obj->ori);
+         }
+      }
    }
 }
 
 
 void
-dmz::WeaponPluginTrackingMissile::destroy_object (
-      const UUID &Identity,
-      const Handle ObjectHandle) {
+dmz::WeaponPluginTrackingMissile::_isect_batch (IsectTestContainer &tests) {
 
-   ObjectStruct *os = _objectTable.remove (ObjectHandle);
+   for (Int32 ix = 0; ix < _frame.count; ix++) {
+
+      _frame.hitObject[ix] = 0;
+      _frame.hitDistance[ix] = -1.0;
+   }
+
+   // Closest point results are reduced per batch by some isect modules so all
+   // points are requested and the closest hit of each test is found here. Hits on
+   // the missile itself are skipped instead of disabling its isect.
+   IsectParameters params;
+   params.set_test_result_type (IsectAllPoints);
+   params.set_calculate_object_handle (True);
+   params.set_calculate_distance (True);
+
+   IsectResultContainer results;
+
+   if (_isect->do_isect (params, tests, results)) {
+
+      IsectResult value;
+      Boolean found (results.get_first (value));
+
+      while (found) {
 
-   if (os) { delete os; os = 0; }
+         const Int32 Index (Int32 (value.get_isect_test_id ()) - 1);
+         Handle hit (0);
+         Float64 distance (0.0);
+         value.get_object_handle (hit);
+         value.get_distance (distance);
+
+         if ((Index >= 0) && (Index < _frame.count) && _frame.obj[Index] &&
+               (hit != _frame.obj[Index]->Object) &&
+               ((_frame.hitDistance[Index] < 0.0) ||
+                  (distance < _frame.hitDistance[Index]))) {
+
+            _frame.hitObject[Index] = hit;
+            _frame.hitDistance[Index] = distance;
+         }
+
+         found = results.get_next (value);
+      }
+   }
+}
+
+
+void
+dmz::WeaponPluginTrackingMissile::_detonate (const Int32 Index, const Handle Target) {
+
+   ObjectStruct *obj (_frame.obj[Index]);
+
+   if (obj) {
+
+      if (_common) { _common->create_detonation_event (obj->Object, Target); }
+
+      _destroyList.add (obj->Object);
+      _frame.obj[Index] = 0;
+   }
 }
 
 
@@ -299,13 +576,20 @@ dmz::WeaponPluginTrackingMissile::_get_type_info (const ObjectType &Type) {
 
             Config info;
 
-            if (current.get_config ().lookup_all_config ("weapon", info)) {
+            if (current.get_config ().lookup_all_config_merged ("weapon", info)) {
 
                const Float64 MaxTurn = config_to_float64 ("turn-rate", info, Pi64 * 0.5);
                const Float64 MaxSpeed = config_to_float64 ("speed", info, 350.0);
                const Float64 Accel = config_to_float64 ("acceleration", info, 600.0);
 
-               result = new TypeStruct (MaxTurn, MaxSpeed, Accel);
+               const Float64 Range = config_to_float64 ("acquire-range", info, 100.0);
+
+               const Float64 Angle = config_to_float64 (
+                  "acquire-angle",
+                  info,
+                  Pi64 / 18.0);
+
+               result = new TypeStruct (MaxTurn, MaxSpeed, Accel, Range, Angle);
 
                if (result) {
 
@@ -333,7 +617,8 @@ dmz::WeaponPluginTrackingMissile::_init (Config &local) {
    RuntimeContext *context (get_plugin_runtime_context ());
 
    _defaultHandle = activate_default_object_attribute (
-      ObjectCreateMask | ObjectDestroyMask);
+      ObjectCreateMask | ObjectDestroyMask | ObjectPositionMask | ObjectVelocityMask |
+      ObjectOrientationMask);
 
    _targetLockHandle = config_to_named_handle (
       "target-lock.name",
@@ -348,6 +633,7 @@ dmz::WeaponPluginTrackingMissile::_init (Config &local) {
       context);
 
    _typeSet = config_to_object_type_set ("munitions", local, context);
+   _targetSet = config_to_object_type_set ("targets", local, context);
 }
 //! \endcond
 
@@ -8,11 +8,16 @@
 #include <dmzRuntimeTimeSlice.h>
 #include <dmzTypesHandleContainer.h>
 #include <dmzTypesHashTableHandleTemplate.h>
+#include <dmzTypesMatrix.h>
+#include <dmzTypesVector.h>
 
 namespace dmz {
  
-   class RenderModuleIsect;
    class EventModuleCommon;
+   class IsectTestContainer;
+   class ObjectModule;
+   class ObjectModuleGrid;
+   class RenderModuleIsect;
 
 // MOVE once plugin is finished.
 //! \cond
@@ -46,20 +51,47 @@ namespace dmz {
 
          virtual void destroy_object (const UUID &Identity, const Handle ObjectHandle);
 
+         virtual void update_object_position (
+            const UUID &Identity,
+            const Handle ObjectHandle,
+            const Handle AttributeHandle,
+            const Vector &Value,
+            const Vector *PreviousValue);
+
+         virtual void update_object_orientation (
+            const UUID &Identity,
+            const Handle ObjectHandle,
+            const Handle AttributeHandle,
+            const Matrix &Value,
+            const Matrix *PreviousValue);
+
+         virtual void update_object_velocity (
+            const UUID &Identity,
+            const Handle ObjectHandle,
+            const Handle AttributeHandle,
+            const Vector &Value,
+            const Vector *PreviousValue);
+
       protected:
          struct TypeStruct {
 
             const Float64 MaxTurn;
             const Float64 MaxSpeed;
             const Float64 Acceleration;
+            const Float64 AcquireRange;
+            const Float64 AcquireAngle;
 
             TypeStruct (
                   const Float64 TheMaxTurn,
                   const Float64 TheMaxSpeed,
-                  const Float64 TheAcceleration) :
+                  const Float64 TheAcceleration,
+                  const Float64 TheAcquireRange,
+                  const Float64 TheAcquireAngle) :
                   MaxTurn (TheMaxTurn),
                   MaxSpeed (TheMaxSpeed),
-                  Acceleration (TheAcceleration) {;}
+                  Acceleration (TheAcceleration),
+                  AcquireRange (TheAcquireRange),
+                  AcquireAngle (TheAcquireAngle) {;}
          };
 
          struct ObjectStruct {
@@ -68,6 +100,11 @@ namespace dmz {
             const Handle Object;
             const Handle Source;
             Handle target;
+            Int32 index;
+            Boolean synced;
+            Vector pos;
+            Vector vel;
+            Matrix ori;
 
             ObjectStruct (
                   const TypeStruct &TheInfo,
@@ -77,9 +114,77 @@ namespace dmz {
                   Info (TheInfo),
                   Object (TheObject),
                   Source (TheSource),
-                  target (TheTarget) {;}
+                  target (TheTarget),
+                  index (-1),
+                  synced (False) {;}
+         };
+
+         // Per frame missile state kept in contiguous arrays indexed by missile.
+         struct FrameStruct {
+
+            Int32 count;
+            Int32 size;
+            ObjectStruct **obj;
+            Vector *pos;
+            Vector *vel;
+            Vector *dir;
+            Vector *next;
+            Vector *targetDir;
+            Handle *hitObject;
+            Float64 *hitDistance;
+
+            FrameStruct () :
+                  count (0),
+                  size (0),
+                  obj (0),
+                  pos (0),
+                  vel (0),
+                  dir (0),
+                  next (0),
+                  targetDir (0),
+                  hitObject (0),
+                  hitDistance (0) {;}
+
+            ~FrameStruct () { _free (); }
+
+            void reserve (const Int32 Size) {
+
+               if (Size > size) {
+
+                  _free ();
+                  size = Size;
+                  obj = new ObjectStruct *[size];
+                  pos = new Vector[size];
+                  vel = new Vector[size];
+                  dir = new Vector[size];
+                  next = new Vector[size];
+                  targetDir = new Vector[size];
+                  hitObject = new Handle[size];
+                  hitDistance = new Float64[size];
+               }
+            }
+
+            void _free () {
+
+               if (obj) { delete []obj; obj = 0; }
+               if (pos) { delete []pos; pos = 0; }
+               if (vel) { delete []vel; vel = 0; }
+               if (dir) { delete []dir; dir = 0; }
+               if (next) { delete []next; next = 0; }
+               if (targetDir) { delete []targetDir; targetDir = 0; }
+               if (hitObject) { delete []hitObject; hitObject = 0; }
+               if (hitDistance) { delete []hitDistance; hitDistance = 0; }
+               size = count = 0;
+            }
          };
 
+         void _gather_missiles (ObjectModule &module);
+         void _acquire_targets (ObjectModule &module);
+         Handle _find_target (ObjectModule &module, const Int32 Index);
+         void _guide_missiles (ObjectModule &module, const Float64 TimeDelta);
+         void _move_missiles (ObjectModule &module, const Float64 TimeDelta);
+         void _isect_batch (IsectTestContainer &tests);
+         void _detonate (const Int32 Index, const Handle Target);
          void _register (const Handle ObjectHandle, const ObjectType &Type);
          TypeStruct *_get_type_info (const ObjectType &Type);
          void _init (Config &local);
@@ -90,8 +195,12 @@ namespace dmz {
          Handle _sourceHandle;
          ObjectTypeSet _ignoreSet;
          ObjectTypeSet _typeSet;
+         ObjectTypeSet _targetSet;
          RenderModuleIsect *_isect;
+         ObjectModuleGrid *_grid;
          EventModuleCommon *_common;
+         FrameStruct _frame;
+         HandleContainer _destroyList;
          HashTableHandleTemplate<TypeStruct> _typeMap;
          HashTableHandleTemplate<TypeStruct> _typeTable;
          HashTableHandleTemplate<ObjectStruct> _objectTable;
@@ -1,6 +1,7 @@
 #include <dmzRuntimeConfig.h>
 #include "dmzRuntimeConfigContext.h"
 #include <dmzSystemStream.h>
+#include <dmzTypesHashTableStringTemplate.h>
 #include <dmzTypesStringTokenizer.h>
 
 #include <stdio.h>
@@ -14,6 +15,190 @@
 
 static const char LocalScopeChar ('.');
 
+namespace {
+
+// Config names are interned in a single process wide table so config contexts key their
+// attribute and child tables by the name's handle. Interned names are never removed.
+// The set of names used in config files is small and they are shared by every tree.
+// The table is never deleted so config contexts released during shutdown may still
+// use it.
+struct ConfigNameTable {
+
+   dmz::SpinLock lock;
+   dmz::UInt32 nextHandle;
+   dmz::HashTableStringTemplate<dmz::ConfigNameStruct> nameTable;
+
+   ConfigNameTable () : nextHandle (dmz::ConfigValueNameHandle + 1) {
+
+      nameTable.store (
+         "",
+         new dmz::ConfigNameStruct ("", dmz::ConfigValueNameHandle));
+   }
+};
+
+static ConfigNameTable &localNameTable (*(new ConfigNameTable));
+
+};
+
+
+dmz::ConfigNameStruct &
+dmz::config_intern_name (const String &Name) {
+
+   localNameTable.lock.lock ();
+
+   ConfigNameStruct *result (localNameTable.nameTable.lookup (Name));
+
+   if (!result) {
+
+      result = new ConfigNameStruct (Name, localNameTable.nextHandle);
+      localNameTable.nameTable.store (Name, result);
+      localNameTable.nextHandle++;
+   }
+
+   localNameTable.lock.unlock ();
+
+   return *result;
+}
+
+
+dmz::ConfigNameStruct *
+dmz::config_lookup_name (const String &Name) {
+
+   localNameTable.lock.lock ();
+      ConfigNameStruct *result (localNameTable.nameTable.lookup (Name));
+   localNameTable.lock.unlock ();
+
+   return result;
+}
+
+
+
+
+dmz::ConfigContext *
+dmz::ConfigContext::find_last (const UInt32 *Handles, const Int32 Count) {
+
+   ConfigContext *result (0);
+
+   DataList *dl ((Count > 0) ? configTable.lookup (Handles[0]) : 0);
+
+   if (dl) {
+
+      dl->lock.lock ();
+         DataStruct *ds (dl->head);
+      dl->lock.unlock ();
+
+      while (ds) {
+
+         if (ds->handle) {
+
+            if (Count == 1) { result = ds->context; }
+            else {
+
+               ConfigContext *found (ds->context->find_last (Handles + 1, Count - 1));
+               if (found) { result = found; }
+            }
+         }
+
+         dl->lock.lock ();
+            ds = ds->next;
+         dl->lock.unlock ();
+      }
+   }
+
+   return result;
+}
+
+
+void
+dmz::ConfigContext::find_all (
+      const UInt32 *Handles,
+      const Int32 Count,
+      ConfigContext &list) {
+
+   DataList *dl ((Count > 0) ? configTable.lookup (Handles[0]) : 0);
+
+   if (dl) {
+
+      dl->lock.lock ();
+         DataStruct *ds (dl->head);
+      dl->lock.unlock ();
+
+      while (ds) {
+
+         if (ds->handle) {
+
+            if (Count == 1) { list.add_config (ds->context); }
+            else { ds->context->find_all (Handles + 1, Count - 1, list); }
+         }
+
+         dl->lock.lock ();
+            ds = ds->next;
+         dl->lock.unlock ();
+      }
+   }
+}
+
+
+dmz::ConfigNamePath::ConfigNamePath () : handles (_local), count (0) {;}
+
+
+dmz::ConfigNamePath::~ConfigNamePath () {
+
+   if (handles != _local) { delete []handles; handles = 0; }
+}
+
+
+/*!
+
+\brief Converts a scoped config name into a list of name handles.
+\details If \a Intern is dmz::False, names that have never been interned cause the
+function to fail since no config context can have that name.
+\param[in] Path String containing the scoped config name.
+\param[in] Intern Boolean indicating if unknown names should be interned.
+\return Returns dmz::True if every element of the path has a handle.
+
+*/
+dmz::Boolean
+dmz::ConfigNamePath::compile (const String &Path, const Boolean Intern) {
+
+   Boolean result (True);
+
+   Int32 size (1);
+
+   for (Int32 ix = 0; ix < Path.get_length (); ix++) {
+
+      if (Path.get_char (ix) == LocalScopeChar) { size++; }
+   }
+
+   if (handles != _local) { delete []handles; handles = _local; }
+
+   if (size > LocalSize) { handles = new UInt32[size]; }
+
+   count = 0;
+
+   StringTokenizer it (Path, LocalScopeChar);
+   String sub = it.get_next ();
+
+   while (sub && result && (count < size)) {
+
+      if (Intern) { handles[count] = config_intern_name (sub).Handle; count++; }
+      else {
+
+         ConfigNameStruct *ns (config_lookup_name (sub));
+
+         if (ns) { handles[count] = ns->Handle; count++; }
+         else { result = False; }
+      }
+
+      sub = it.get_next ();
+   }
+
+   if (!result) { count = 0; }
+
+   return result;
+}
+
+
 static dmz::ConfigContext *
 local_get_config_from_scope (
       const dmz::String &Scope,
@@ -31,7 +216,10 @@ local_get_config_from_scope (
 
       while (!done) {
 
-         dmz::ConfigContext::DataList *next = result->configTable.lookup (sub);
+         dmz::ConfigNameStruct *ns (dmz::config_lookup_name (sub));
+
+         dmz::ConfigContext::DataList *next =
+            ns ? result->configTable.lookup (ns->Handle) : 0;
 
          if (next && next->tail) {
 
@@ -117,7 +305,7 @@ dmz::Config::get_last_config
 
 struct dmz::ConfigIterator::State {
 
-   HashTableStringIterator it;
+   HashTableUInt32Iterator it;
 };
 
 
@@ -462,7 +650,7 @@ dmz::Config::get_first_attribute (
             value = ac->value;
          ac->lock.unlock ();
 
-         name = it.state.it.get_hash_key ();
+         name = ac->Name;
 
          if ((name == "") || (!value.get_buffer ())) {
 
@@ -504,7 +692,7 @@ dmz::Config::get_next_attribute (
             value = ac->value;
          ac->lock.unlock ();
 
-         name = it.state.it.get_hash_key ();
+         name = ac->Name;
 
          if ((name == "") || (!value.get_buffer ())) {
 
@@ -574,25 +762,7 @@ dmz::Config::store_attribute (const String &Name, const String &Value) {
       }
       else { context = _state.context; }
 
-      if (context) {
-
-         ConfigAttributeContext *ac (context->attrTable.lookup (attrName));
-
-         if (!ac) {
-
-            ac = new ConfigAttributeContext (Value);
-            if (ac && context->attrTable.store (attrName, ac)) { result = True; }
-            else if (ac) { delete ac; ac = 0; }
-         }
-         else {
-
-            result = True;
-
-            ac->lock.lock ();
-               ac->value = Value;
-            ac->lock.unlock ();
-         }
-      }
+      if (context && context->store_attribute (attrName, Value)) { result = True; }
    }
 
    return result;
@@ -667,14 +837,19 @@ dmz::Config::lookup_attribute (const String &Name, String &value) const {
 
       if (!pop_last_config_scope_element (Name, dataName, attrName)) { attrName = Name; }
 
-      Config cd;
+      ConfigContext *context (_state.context);
 
-      if (dataName) { lookup_config (dataName, cd); }
-      else { cd = *this; }
+      if (dataName) {
 
-      if (cd) {
+         ConfigNamePath path;
 
-         ConfigAttributeContext *ac = cd._state.context->attrTable.lookup (attrName);
+         context = path.compile (dataName, False) ?
+            context->find_last (path.handles, path.count) : 0;
+      }
+
+      if (context) {
+
+         ConfigAttributeContext *ac = context->lookup_attribute (attrName);
 
          if (ac) {
 
@@ -724,14 +899,19 @@ dmz::Config::remove_attribute (const String &Name, String &value) {
 
       if (!pop_last_config_scope_element (Name, dataName, attrName)) { attrName = Name; }
 
-      Config cd;
+      ConfigContext *context (_state.context);
+
+      if (dataName) {
 
-      if (dataName) { lookup_config (dataName, cd); }
-      else { cd = *this; }
+         ConfigNamePath path;
 
-      if (cd) {
+         context = path.compile (dataName, False) ?
+            context->find_last (path.handles, path.count) : 0;
+      }
+
+      if (context) {
 
-         ConfigAttributeContext *ac = cd._state.context->attrTable.lookup (attrName);
+         ConfigAttributeContext *ac = context->lookup_attribute (attrName);
 
          if (ac) {
 
@@ -765,22 +945,7 @@ dmz::Config::set_value (const String &Value) {
 
    if (_state.context && !_state.context->Name) {
 
-      ConfigAttributeContext *ac (_state.context->attrTable.lookup (""));
-
-      if (!ac) {
-
-         ac = new ConfigAttributeContext (Value);
-         if (ac && _state.context->attrTable.store ("", ac)) { result = True; }
-         else if (ac) { delete ac; ac = 0; }
-      }
-      else {
-
-         result = True;
-
-         ac->lock.lock ();
-            ac->value = Value;
-         ac->lock.unlock ();
-      }
+      if (_state.context->store_attribute ("", Value)) { result = True; }
    }
 
    return result;
@@ -807,13 +972,12 @@ dmz::Config::append_value (const String &Value, const Boolean IsFormatted) {
 
          if (IsFormatted) { _state.context->flags |= ConfigFormattedFlag; }
 
-         ConfigAttributeContext *ac (_state.context->attrTable.lookup (""));
+         ConfigAttributeContext *ac (
+            _state.context->attrTable.lookup (ConfigValueNameHandle));
 
          if (!ac) {
 
-            ac = new ConfigAttributeContext (Value);
-            if (ac && _state.context->attrTable.store ("", ac)) { result = True; }
-            else if (ac) { delete ac; ac = 0; }
+            if (_state.context->store_attribute ("", Value)) { result = True; }
          }
          else {
 
@@ -831,8 +995,7 @@ dmz::Config::append_value (const String &Value, const Boolean IsFormatted) {
          if (cd) {
 
             cd->flags |= IsFormatted ? ConfigFormattedFlag : 0;
-            ConfigAttributeContext *ptr = new ConfigAttributeContext (Value);
-            if (ptr && !cd->attrTable.store ("", ptr)) { delete ptr; ptr = 0; }
+            cd->store_attribute ("", Value);
             _state.context->add_config (cd);
             result = True;
             cd->unref (); cd = 0;
@@ -860,7 +1023,8 @@ dmz::Config::get_value (String &value) const {
 
       if (!_state.context->Name) {
 
-         ConfigAttributeContext *at (_state.context->attrTable.lookup (""));
+         ConfigAttributeContext *at (
+            _state.context->attrTable.lookup (ConfigValueNameHandle));
 
          if (at) {
 
@@ -873,7 +1037,8 @@ dmz::Config::get_value (String &value) const {
       }
       else {
 
-         ConfigContext::DataList *dl (_state.context->configTable.lookup (""));
+         ConfigContext::DataList *dl (
+            _state.context->configTable.lookup (ConfigValueNameHandle));
 
          if (dl) {
 
@@ -886,7 +1051,8 @@ dmz::Config::get_value (String &value) const {
 
                   if (ds->handle && ds->context) {
 
-                     ConfigAttributeContext *at (ds->context->attrTable.lookup (""));
+                     ConfigAttributeContext *at (
+                        ds->context->attrTable.lookup (ConfigValueNameHandle));
 
                      if (at) {
 
@@ -1129,14 +1295,14 @@ dmz::Boolean
 dmz::Config::lookup_config (const String &Name, Config &data) const {
 
    Boolean result (False);
-   Config tmp;
 
-   if (lookup_all_config (Name, tmp)) {
+   ConfigNamePath path;
 
-      result = True;
+   if (_state.context && path.compile (Name, False)) {
 
-      ConfigIterator it;
-      tmp.get_last_config (it, data);
+      ConfigContext *context (_state.context->find_last (path.handles, path.count));
+
+      if (context) { data.set_config_context (context); result = True; }
    }
 
    return result;
@@ -1156,57 +1322,23 @@ dmz::Boolean
 dmz::Config::lookup_all_config (const String &Name, Config &data) const {
 
    Boolean result (False);
-   StringTokenizer it (Name, LocalScopeChar);
-   String sub = it.get_next ();
-   Boolean done (!sub ? True : False);
-
-   Config prev ("prev");
-   prev.add_config (*this);
-   Config current (sub);
-
-   while (!done) {
 
-      ConfigIterator tableIt;
-      Config next;
+   ConfigNamePath path;
 
-      ConfigContext *curContext = current.get_config_context ();
+   if (_state.context && path.compile (Name, False) && path.count) {
 
-      while (prev.get_next_config (tableIt, next)) {
+      String name, remainder;
 
-         ConfigContext *nextContext = next.get_config_context ();
+      if (!pop_last_config_scope_element (Name, remainder, name)) { name = Name; }
 
-         if (nextContext && curContext) {
+      Config current (name);
 
-            ConfigContext::DataList *dl (nextContext->configTable.lookup (sub));
-
-            if (dl) {
-
-               dl->lock.lock ();
-                  ConfigContext::DataStruct *ds = dl->head;
-                  while (ds) {
-
-                     if (ds->handle) {
-
-                        curContext->add_config (ds->context);
-                     }
+      _state.context->find_all (path.handles, path.count, *(current._state.context));
 
-                     ds = ds->next;
-                  }
-               dl->lock.unlock ();
-            }
-         }
-      }
-
-      if (current.is_empty ()) { done = True; }
-      else {
-
-         sub = it.get_next ();
-         if (!sub) { data = current; done = True; result = True; }
-         else { prev = current; Config next (sub); current = next; }
-      }
+      if (current.get_config_count ()) { data = current; result = True; }
    }
 
-   if (data.is_empty ()) { data.set_config_context (0); result = False; }
+   if (!result && data.is_empty ()) { data.set_config_context (0); }
 
    return result;
 }
@@ -5,13 +5,30 @@
 #include <dmzSystemSpinLock.h>
 #include <dmzTypesBase.h>
 #include <dmzTypesHashTableLock.h>
-#include <dmzTypesHashTableStringTemplate.h>
+#include <dmzTypesHashTableUInt32Template.h>
+#include <dmzTypesString.h>
 
 namespace dmz {
 
    const UInt8 ConfigFormattedFlag = 0x01;
    const UInt8 ConfigInArrayFlag     = 0x02;
 
+   struct ConfigNameStruct {
+
+      const String Name;
+      const UInt32 Handle;
+
+      ConfigNameStruct (const String &TheName, const UInt32 TheHandle) :
+            Name (TheName),
+            Handle (TheHandle) {;}
+   };
+
+   //! Handle of the empty name used to store the value of a config context.
+   const UInt32 ConfigValueNameHandle = 1;
+
+   ConfigNameStruct &config_intern_name (const String &Name);
+   ConfigNameStruct *config_lookup_name (const String &Name);
+
    class ConfigContextLock : public HashTableLock {
 
       protected:
@@ -43,10 +60,13 @@ namespace dmz {
    class ConfigAttributeContext {
 
       public:
+         const String &Name;
          SpinLock lock;
          String value;
 
-         explicit ConfigAttributeContext (const String &Value) : value (Value) {;}
+         ConfigAttributeContext (const ConfigNameStruct &TheName, const String &Value) :
+               Name (TheName.Name),
+               value (Value) {;}
          ~ConfigAttributeContext () {;}
 
       private:
@@ -91,19 +111,28 @@ namespace dmz {
          Boolean add_config (ConfigContext *context);
          Boolean remove_config (const String &Name);
 
+         ConfigAttributeContext *lookup_attribute (const String &Name) const;
+         ConfigAttributeContext *store_attribute (
+            const String &Name,
+            const String &Value);
+
+         ConfigContext *find_last (const UInt32 *Handles, const Int32 Count);
+         void find_all (const UInt32 *Handles, const Int32 Count, ConfigContext &list);
+
          const String Name;
+         const UInt32 NameHandle;
          UInt8 flags;
 
          ConfigContextLock attrLock;
-         HashTableStringTemplate<ConfigAttributeContext> attrTable;
+         HashTableUInt32Template<ConfigAttributeContext> attrTable;
 
          ConfigContextCounter orderCount;
 
          ConfigContextLock dataLock;
-         HashTableStringTemplate<DataList> configTable;
+         HashTableUInt32Template<DataList> configTable;
 
          ConfigContextLock dataOrderLock;
-         HashTableStringTemplate<DataStruct> configOrderTable;
+         HashTableUInt32Template<DataStruct> configOrderTable;
 
       protected:
          virtual ~ConfigContext ();
@@ -113,12 +142,33 @@ namespace dmz {
          ConfigContext (const ConfigContext &Context);
          ConfigContext &operator= (const ConfigContext &Context);
    };
+
+   class ConfigNamePath {
+
+      public:
+         ConfigNamePath ();
+         ~ConfigNamePath ();
+
+         Boolean compile (const String &Path, const Boolean Intern);
+
+         UInt32 *handles;
+         Int32 count;
+
+      protected:
+         enum { LocalSize = 8 };
+         UInt32 _local[LocalSize];
+
+      private:
+         ConfigNamePath (const ConfigNamePath &);
+         ConfigNamePath &operator= (const ConfigNamePath &);
+   };
 };
 
 
 inline
 dmz::ConfigContext::ConfigContext (const String &TheName) :
       Name (TheName),
+      NameHandle (config_intern_name (TheName).Handle),
       flags (0),
       attrTable (&attrLock),
       configTable (&dataLock),
@@ -141,15 +191,15 @@ dmz::ConfigContext::add_config (ConfigContext *context) {
 
    if (context) {
 
-      DataList *dl = configTable.lookup (context->Name);
+      DataList *dl = configTable.lookup (context->NameHandle);
 
       if (!dl) {
 
          dl = new DataList;
-         if (!configTable.store (context->Name, dl)) {
+         if (!configTable.store (context->NameHandle, dl)) {
 
             delete dl; dl = 0;
-            dl = configTable.lookup (context->Name);
+            dl = configTable.lookup (context->NameHandle);
          }
       }
 
@@ -157,10 +207,7 @@ dmz::ConfigContext::add_config (ConfigContext *context) {
 
       if (dl && ds) {
 
-         String handleName;
-         handleName << ds->handle;
-
-         if (configOrderTable.store (handleName, ds)) {
+         if (configOrderTable.store (ds->handle, ds)) {
 
             dl->lock.lock ();
                if (dl->tail) { dl->tail->next = ds; dl->tail = ds; }
@@ -183,7 +230,9 @@ dmz::ConfigContext::remove_config (const String &Name) {
 
    Boolean result (False);
 
-   DataList *dl = configTable.lookup (Name);
+   ConfigNameStruct *ns (config_lookup_name (Name));
+
+   DataList *dl = ns ? configTable.lookup (ns->Handle) : 0;
 
    if (dl) {
 
@@ -204,5 +253,49 @@ dmz::ConfigContext::remove_config (const String &Name) {
    return result;
 }
 
+
+inline dmz::ConfigAttributeContext *
+dmz::ConfigContext::lookup_attribute (const String &Name) const {
+
+   ConfigNameStruct *ns (config_lookup_name (Name));
+
+   return ns ? attrTable.lookup (ns->Handle) : 0;
+}
+
+
+inline dmz::ConfigAttributeContext *
+dmz::ConfigContext::store_attribute (const String &Name, const String &Value) {
+
+   const ConfigNameStruct &Ns (config_intern_name (Name));
+
+   ConfigAttributeContext *result (attrTable.lookup (Ns.Handle));
+
+   if (!result) {
+
+      result = new ConfigAttributeContext (Ns, Value);
+
+      if (result && !attrTable.store (Ns.Handle, result)) {
+
+         delete result; result = 0;
+         result = attrTable.lookup (Ns.Handle);
+
+         if (result) {
+
+            result->lock.lock ();
+               result->value = Value;
+            result->lock.unlock ();
+         }
+      }
+   }
+   else {
+
+      result->lock.lock ();
+         result->value = Value;
+      result->lock.unlock ();
+   }
+
+   return result;
+}
+
 #endif // DMZ_RUNTIME_CONFIG_CONTEXT_DOT_H
 
@@ -0,0 +1,209 @@
+#include <dmzRuntimeConfig.h>
+#include "dmzRuntimeConfigContext.h"
+#include <dmzRuntimeConfigPath.h>
+
+/*!
+
+\class dmz::ConfigPath
+\ingroup Runtime
+\brief Compiled scoped Config name.
+\details A ConfigPath splits a scoped name such as "dmz.types.foo" once and stores the
+interned handle of each element. Lookups with a ConfigPath do not need to split or hash
+the name and walk the tree by handle. Results are not cached so every lookup sees the
+current state of the Config tree. A ConfigPath should be used when the same scoped name
+is looked up repeatedly.
+\code
+const dmz::ConfigPath RulePath ("net.rule");
+
+dmz::Config list;
+
+if (RulePath.lookup_all_config (type.get_config (), list)) {
+
+   // Do something with list.
+}
+\endcode
+\note A ConfigPath is not modified by lookups and may be shared between threads.
+\sa dmz::Config::lookup_config \n dmz::Config::lookup_all_config \n
+dmz::Config::lookup_attribute
+
+*/
+
+//! \cond
+struct dmz::ConfigPath::State {
+
+   String path;
+   String lastName;
+   ConfigNamePath namePath;
+
+   void set_path (const String &Path) {
+
+      path = Path;
+      namePath.compile (path, True);
+
+      String remainder;
+
+      if (!pop_last_config_scope_element (path, remainder, lastName)) {
+
+         lastName = path;
+      }
+   }
+};
+//! \endcond
+
+
+//! Constructor.
+dmz::ConfigPath::ConfigPath () : _state (*(new State)) {;}
+
+
+/*!
+
+\brief Path constructor.
+\param[in] Path String containing the scoped config name.
+
+*/
+dmz::ConfigPath::ConfigPath (const String &Path) : _state (*(new State)) {
+
+   _state.set_path (Path);
+}
+
+
+//! Copy constructor.
+dmz::ConfigPath::ConfigPath (const ConfigPath &Path) : _state (*(new State)) {
+
+   _state.set_path (Path._state.path);
+}
+
+
+//! Destructor.
+dmz::ConfigPath::~ConfigPath () { delete &_state; }
+
+
+//! Assignment operator.
+dmz::ConfigPath &
+dmz::ConfigPath::operator= (const ConfigPath &Path) {
+
+   if (this != &Path) { _state.set_path (Path._state.path); }
+
+   return *this;
+}
+
+
+/*!
+
+\brief Sets the scoped config name.
+\param[in] Path String containing the scoped config name.
+
+*/
+void
+dmz::ConfigPath::set_path (const String &Path) { _state.set_path (Path); }
+
+
+//! Returns the scoped config name.
+dmz::String
+dmz::ConfigPath::get_path () const { return _state.path; }
+
+
+/*!
+
+\brief Looks up a config context.
+\details Equivalent to calling dmz::Config::lookup_config on \a Source with the path.
+\param[in] Source Config to search.
+\param[out] data Config to store the found config context.
+\return Returns dmz::True if the config context was found.
+
+*/
+dmz::Boolean
+dmz::ConfigPath::lookup_config (const Config &Source, Config &data) const {
+
+   Boolean result (False);
+
+   ConfigContext *context (Source.get_config_context ());
+
+   if (context && _state.namePath.count) {
+
+      context = context->find_last (_state.namePath.handles, _state.namePath.count);
+   }
+   else { context = 0; }
+
+   if (context) { data.set_config_context (context); result = True; }
+
+   return result;
+}
+
+
+/*!
+
+\brief Looks up all config contexts.
+\details Equivalent to calling dmz::Config::lookup_all_config on \a Source with the path.
+\param[in] Source Config to search.
+\param[out] data Config to store the found config contexts.
+\return Returns dmz::True if any config contexts were found.
+
+*/
+dmz::Boolean
+dmz::ConfigPath::lookup_all_config (const Config &Source, Config &data) const {
+
+   Boolean result (False);
+
+   ConfigContext *context (Source.get_config_context ());
+
+   if (context && _state.namePath.count) {
+
+      Config current (_state.lastName);
+
+      context->find_all (
+         _state.namePath.handles,
+         _state.namePath.count,
+         *(current.get_config_context ()));
+
+      if (current.get_config_count ()) { data = current; result = True; }
+   }
+
+   if (!result && data.is_empty ()) { data.set_config_context (0); }
+
+   return result;
+}
+
+
+/*!
+
+\brief Looks up an attribute.
+\details Equivalent to calling dmz::Config::lookup_attribute on \a Source with the path.
+The last element of the path is the name of the attribute.
+\param[in] Source Config to search.
+\param[out] value String used to store the value of the attribute.
+\return Returns dmz::True if the attribute was found.
+
+*/
+dmz::Boolean
+dmz::ConfigPath::lookup_attribute (const Config &Source, String &value) const {
+
+   Boolean result (False);
+
+   const Int32 Count (_state.namePath.count);
+
+   ConfigContext *context (Source.get_config_context ());
+
+   if (context && (Count > 1)) {
+
+      context = context->find_last (_state.namePath.handles, Count - 1);
+   }
+   else if (Count < 1) { context = 0; }
+
+   if (context) {
+
+      ConfigAttributeContext *ac (
+         context->attrTable.lookup (_state.namePath.handles[Count - 1]));
+
+      if (ac) {
+
+         ac->lock.lock ();
+            value = ac->value;
+         ac->lock.unlock ();
+
+         if (value.get_buffer ()) { result = True; }
+      }
+   }
+
+   return result;
+}
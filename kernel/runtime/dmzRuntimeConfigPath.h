@@ -0,0 +1,35 @@
+#ifndef DMZ_RUNTIME_CONFIG_PATH_DOT_H
+#define DMZ_RUNTIME_CONFIG_PATH_DOT_H
+
+#include <dmzKernelExport.h>
+#include <dmzTypesBase.h>
+#include <dmzTypesString.h>
+
+namespace dmz {
+
+   class Config;
+
+   class DMZ_KERNEL_LINK_SYMBOL ConfigPath {
+
+      public:
+         ConfigPath ();
+         explicit ConfigPath (const String &Path);
+         ConfigPath (const ConfigPath &Path);
+         ~ConfigPath ();
+
+         ConfigPath &operator= (const ConfigPath &Path);
+
+         void set_path (const String &Path);
+         String get_path () const;
+
+         Boolean lookup_config (const Config &Source, Config &data) const;
+         Boolean lookup_all_config (const Config &Source, Config &data) const;
+         Boolean lookup_attribute (const Config &Source, String &value) const;
+
+      protected:
+         struct State;
+         State &_state; //!< Internal state.
+   };
+};
+
+#endif // DMZ_RUNTIME_CONFIG_PATH_DOT_H
@@ -0,0 +1,399 @@
+#include "dmzRuntimeContext.h"
+#include "dmzRuntimeContextUndo.h"
+#include <dmzRuntimeIterator.h>
+
+#include <string.h> // for memcpy
+
+/*!
+
+\brief Creates an undo stack and adds it to the memory usage.
+\param[in] Name String containing the name of the undo stack.
+\param[in] AutoCreated Indicates if the stack was created by dmz::Undo::do_next.
+\return Returns a pointer to the new stack.
+
+*/
+dmz::UndoStackStruct *
+dmz::RuntimeContextUndo::create_stack (const String &Name, const Boolean AutoCreated) {
+
+   UndoStackStruct *result (new UndoStackStruct (Name, &context, AutoCreated));
+
+   if (result) { memoryUsage += result->memoryUsage; }
+
+   return result;
+}
+
+
+/*!
+
+\brief Stores an action in an undo stack.
+\details The action Data is stored in a compact binary form. String elements are
+interned so that repeated strings such as attribute and type names are only stored once.
+If \a CoalesceKey is non-zero and matches the most recent action in the stack with the
+same message and observer, the action is discarded. The earlier action restores the
+final value when the stack is played back so the newer one is redundant.
+\param[in] stack UndoStackStruct to store the action in.
+\param[in] Type Message to send when the action is played back.
+\param[in] ObserverHandle Handle of the observer to send the message to.
+\param[in] CoalesceKey Key used to coalesce consecutive actions. Zero disables coalescing.
+\param[in] Value Pointer to the Data sent with the message. May be NULL.
+\return Returns dmz::True if the action was stored or coalesced.
+
+*/
+dmz::Boolean
+dmz::RuntimeContextUndo::store_action (
+      UndoStackStruct &stack,
+      const Message &Type,
+      const Handle ObserverHandle,
+      const UInt64 CoalesceKey,
+      const Data *Value) {
+
+   Boolean result (False);
+
+   if (CoalesceKey && stack.head &&
+         (stack.head->CoalesceKey == CoalesceKey) &&
+         (stack.head->ObserverHandle == ObserverHandle) &&
+         (stack.head->Type == Type)) {
+
+      result = True;
+   }
+   else {
+
+      UndoActionStruct *action (new UndoActionStruct (Type, ObserverHandle, CoalesceKey));
+
+      if (action && Value) {
+
+         encoder.reset ();
+         encoder.set_next_int32 (Value->get_attribute_count ());
+
+         RuntimeIterator it;
+         Handle attr (Value->get_first_attribute (it));
+
+         while (attr) {
+
+            const BaseTypeEnum AttrType (Value->lookup_attribute_base_type_enum (attr));
+            const Int32 Count (Value->lookup_attribute_element_count (attr));
+
+            encoder.set_next_uint32 (attr);
+            encoder.set_next_uint8 (UInt8 (AttrType));
+            encoder.set_next_int32 (Count);
+
+            for (Int32 ix = 0; ix < Count; ix++) {
+
+               if (AttrType == BaseTypeBoolean) {
+
+                  Boolean element (False);
+                  Value->lookup_boolean (attr, ix, element);
+                  encoder.set_next_uint8 (element ? 1 : 0);
+               }
+               else if (AttrType == BaseTypeInt32) {
+
+                  Int32 element (0);
+                  Value->lookup_int32 (attr, ix, element);
+                  encoder.set_next_int32 (element);
+               }
+               else if (AttrType == BaseTypeUInt32) {
+
+                  UInt32 element (0);
+                  Value->lookup_uint32 (attr, ix, element);
+                  encoder.set_next_uint32 (element);
+               }
+               else if (AttrType == BaseTypeInt64) {
+
+                  Int64 element (0);
+                  Value->lookup_int64 (attr, ix, element);
+                  encoder.set_next_int64 (element);
+               }
+               else if (AttrType == BaseTypeUInt64) {
+
+                  UInt64 element (0);
+                  Value->lookup_uint64 (attr, ix, element);
+                  encoder.set_next_uint64 (element);
+               }
+               else if (AttrType == BaseTypeFloat32) {
+
+                  Float32 element (0.0f);
+                  Value->lookup_float32 (attr, ix, element);
+                  encoder.set_next_float32 (element);
+               }
+               else if (AttrType == BaseTypeFloat64) {
+
+                  Float64 element (0.0);
+                  Value->lookup_float64 (attr, ix, element);
+                  encoder.set_next_float64 (element);
+               }
+               else if (AttrType == BaseTypeString) {
+
+                  String element;
+                  Value->lookup_string (attr, ix, element);
+                  encoder.set_next_uint32 (_intern_string (element));
+               }
+            }
+
+            attr = Value->get_next_attribute (it);
+         }
+
+         Int32 length (0);
+         char *buffer (encoder.get_buffer (length));
+
+         if (length > 0) {
+
+            action->buffer = new char[length];
+
+            if (action->buffer) {
+
+               memcpy (action->buffer, buffer, length);
+               action->size = length;
+            }
+         }
+      }
+
+      if (action) {
+
+         const UInt64 ActionSize (sizeof (UndoActionStruct) + action->size);
+
+         action->next = stack.head;
+         stack.head = action;
+         stack.memoryUsage += ActionSize;
+         memoryUsage += ActionSize;
+         result = True;
+      }
+   }
+
+   return result;
+}
+
+
+/*!
+
+\brief Decodes the Data of an undo action.
+\param[in] Action UndoActionStruct to decode.
+\param[out] value Data object to store the decoded action Data in.
+\return Returns dmz::True if the action has Data. Returns dmz::False if the action
+was stored with a NULL Data pointer.
+
+*/
+dmz::Boolean
+dmz::RuntimeContextUndo::decode_action (const UndoActionStruct &Action, Data &value) {
+
+   Boolean result (False);
+
+   value.clear ();
+
+   if (Action.buffer) {
+
+      result = True;
+
+      decoder.set_buffer (Action.size, Action.buffer);
+
+      const Int32 AttrCount (decoder.get_next_int32 ());
+
+      for (Int32 count = 0; count < AttrCount; count++) {
+
+         const Handle Attr (decoder.get_next_uint32 ());
+         const BaseTypeEnum AttrType (BaseTypeEnum (decoder.get_next_uint8 ()));
+         const Int32 Count (decoder.get_next_int32 ());
+
+         for (Int32 ix = 0; ix < Count; ix++) {
+
+            if (AttrType == BaseTypeBoolean) {
+
+               value.store_boolean (Attr, ix, decoder.get_next_uint8 () != 0);
+            }
+            else if (AttrType == BaseTypeInt32) {
+
+               value.store_int32 (Attr, ix, decoder.get_next_int32 ());
+            }
+            else if (AttrType == BaseTypeUInt32) {
+
+               value.store_uint32 (Attr, ix, decoder.get_next_uint32 ());
+            }
+            else if (AttrType == BaseTypeInt64) {
+
+               value.store_int64 (Attr, ix, decoder.get_next_int64 ());
+            }
+            else if (AttrType == BaseTypeUInt64) {
+
+               value.store_uint64 (Attr, ix, decoder.get_next_uint64 ());
+            }
+            else if (AttrType == BaseTypeFloat32) {
+
+               value.store_float32 (Attr, ix, decoder.get_next_float32 ());
+            }
+            else if (AttrType == BaseTypeFloat64) {
+
+               value.store_float64 (Attr, ix, decoder.get_next_float64 ());
+            }
+            else if (AttrType == BaseTypeString) {
+
+               UndoStringStruct *str (stringHandleTable.lookup (decoder.get_next_uint32 ()));
+               value.store_string (Attr, ix, str ? str->Value : String ());
+            }
+         }
+      }
+
+      decoder.clear ();
+   }
+
+   return result;
+}
+
+
+/*!
+
+\brief Deletes a list of undo stacks.
+\param[in] head Pointer to the first UndoStackStruct in the list.
+
+*/
+void
+dmz::RuntimeContextUndo::delete_stack_list (UndoStackStruct *head) {
+
+   while (head) {
+
+      UndoStackStruct *stack (head);
+      head = head->next;
+      _delete_stack (stack);
+   }
+}
+
+
+/*!
+
+\brief Evicts the oldest undo and redo stacks until the memory budget is met.
+\details The oldest undo stacks are evicted first followed by the oldest redo stacks.
+The next undo and redo stacks are never evicted. No stacks are evicted while an
+action is being recorded.
+
+*/
+void
+dmz::RuntimeContextUndo::enforce_memory_budget () {
+
+   Boolean done (!memoryBudget || currentStack);
+
+   while (!done && (memoryUsage > memoryBudget)) {
+
+      UndoStackStruct *list (0);
+
+      if (undoHead && undoHead->next) { list = undoHead; }
+      else if (redoHead && redoHead->next) { list = redoHead; }
+
+      if (list) {
+
+         while (list->next->next) { list = list->next; }
+
+         UndoStackStruct *oldest (list->next);
+         list->next = 0;
+         _delete_stack (oldest);
+      }
+      else { done = True; }
+   }
+}
+
+
+dmz::UInt32
+dmz::RuntimeContextUndo::_intern_string (const String &Value) {
+
+   UndoStringStruct *str (stringTable.lookup (Value));
+
+   if (!str) {
+
+      nextStringHandle++;
+
+      while (!nextStringHandle || stringHandleTable.lookup (nextStringHandle)) {
+
+         nextStringHandle++;
+      }
+
+      str = new UndoStringStruct (Value, nextStringHandle);
+
+      if (str && stringTable.store (Value, str)) {
+
+         stringHandleTable.store (str->StringHandle, str);
+         memoryUsage += sizeof (UndoStringStruct) + Value.get_length ();
+      }
+      else if (str) { delete str; str = 0; }
+   }
+
+   if (str) { str->count++; }
+
+   return str ? str->StringHandle : 0;
+}
+
+
+void
+dmz::RuntimeContextUndo::_release_string (const UInt32 StringHandle) {
+
+   UndoStringStruct *str (stringHandleTable.lookup (StringHandle));
+
+   if (str) {
+
+      str->count--;
+
+      if (str->count <= 0) {
+
+         stringHandleTable.remove (StringHandle);
+         stringTable.remove (str->Value);
+         memoryUsage -= sizeof (UndoStringStruct) + str->Value.get_length ();
+         delete str; str = 0;
+      }
+   }
+}
+
+
+void
+dmz::RuntimeContextUndo::_release_action_strings (const UndoActionStruct &Action) {
+
+   if (Action.buffer) {
+
+      decoder.set_buffer (Action.size, Action.buffer);
+
+      const Int32 AttrCount (decoder.get_next_int32 ());
+
+      for (Int32 count = 0; count < AttrCount; count++) {
+
+         decoder.get_next_uint32 ();
+         const BaseTypeEnum AttrType (BaseTypeEnum (decoder.get_next_uint8 ()));
+         const Int32 Count (decoder.get_next_int32 ());
+
+         Int32 elementSize (0);
+
+         if (AttrType == BaseTypeBoolean) { elementSize = sizeof (UInt8); }
+         else if (AttrType == BaseTypeInt32) { elementSize = sizeof (Int32); }
+         else if (AttrType == BaseTypeUInt32) { elementSize = sizeof (UInt32); }
+         else if (AttrType == BaseTypeInt64) { elementSize = sizeof (Int64); }
+         else if (AttrType == BaseTypeUInt64) { elementSize = sizeof (UInt64); }
+         else if (AttrType == BaseTypeFloat32) { elementSize = sizeof (Float32); }
+         else if (AttrType == BaseTypeFloat64) { elementSize = sizeof (Float64); }
+
+         if (AttrType == BaseTypeString) {
+
+            for (Int32 ix = 0; ix < Count; ix++) {
+
+               _release_string (decoder.get_next_uint32 ());
+            }
+         }
+         else { decoder.set_place (decoder.get_place () + (elementSize * Count)); }
+      }
+
+      decoder.clear ();
+   }
+}
+
+
+void
+dmz::RuntimeContextUndo::_delete_stack (UndoStackStruct *stack) {
+
+   if (stack) {
+
+      memoryUsage -= stack->memoryUsage;
+
+      while (stack->head) {
+
+         UndoActionStruct *action (stack->head);
+         stack->head = action->next;
+         _release_action_strings (*action);
+         delete action; action = 0;
+      }
+
+      delete stack; stack = 0;
+   }
+}
@@ -5,8 +5,13 @@
 #include <dmzRuntimeHandle.h>
 #include <dmzRuntimeMessaging.h>
 #include <dmzRuntimeUndo.h>
+#include <dmzSystem.h>
+#include <dmzSystemMarshal.h>
 #include <dmzSystemRefCount.h>
+#include <dmzSystemUnmarshal.h>
 #include <dmzTypesHashTableHandleTemplate.h>
+#include <dmzTypesHashTableStringTemplate.h>
+#include <dmzTypesHashTableUInt32Template.h>
 
 namespace dmz {
 
@@ -14,24 +19,24 @@ namespace dmz {
 
       const Message Type;
       const Handle ObserverHandle;
-      Data *data;
+      const UInt64 CoalesceKey;
+      char *buffer; // Compact encoding of the action Data, NULL if no Data was given.
+      Int32 size;
 
       UndoActionStruct *next;
 
       UndoActionStruct (
             const Message &TheType,
             const Handle TheHandle,
-            const Data *TheData) :
+            const UInt64 TheKey) :
             Type (TheType),
             ObserverHandle (TheHandle),
-            data (TheData ? new Data (*TheData) : 0),
+            CoalesceKey (TheKey),
+            buffer (0),
+            size (0),
             next (0) {;}
 
-      ~UndoActionStruct () {
-
-         if (data) { delete data; data = 0; }
-         if (next) { delete next; next = 0; }
-      }
+      ~UndoActionStruct () { if (buffer) { delete []buffer; buffer = 0; } }
    };
 
    struct UndoStackStruct {
@@ -39,6 +44,7 @@ namespace dmz {
       const String Name;
       const RuntimeHandle UndoHandle;
       const Boolean AutoCreated;
+      UInt64 memoryUsage;
       UndoActionStruct *head;
       UndoStackStruct *next;
 
@@ -49,14 +55,21 @@ namespace dmz {
             Name (TheName),
             UndoHandle (TheName + ".UndoHandle", context),
             AutoCreated (IsAutoCreated),
+            memoryUsage (sizeof (UndoStackStruct) + TheName.get_length ()),
             head (0),
             next (0) {;}
+   };
 
-      ~UndoStackStruct () {
+   struct UndoStringStruct {
 
-         if (head) { delete head; head = 0; }
-         if (next) { delete next; next = 0; }
-      }
+      const String Value;
+      const UInt32 StringHandle;
+      Int32 count;
+
+      UndoStringStruct (const String &TheValue, const UInt32 TheHandle) :
+            Value (TheValue),
+            StringHandle (TheHandle),
+            count (0) {;}
    };
 
 /*!
@@ -80,6 +93,20 @@ the kernel.
 
          void update_action_names ();
 
+         UndoStackStruct *create_stack (const String &Name, const Boolean AutoCreated);
+
+         Boolean store_action (
+            UndoStackStruct &stack,
+            const Message &Type,
+            const Handle ObserverHandle,
+            const UInt64 CoalesceKey,
+            const Data *Value);
+
+         Boolean decode_action (const UndoActionStruct &Action, Data &value);
+
+         void delete_stack_list (UndoStackStruct *head);
+         void enforce_memory_budget ();
+
          const RuntimeHandle NestedHandle;
 
          RuntimeContext &context; //!< Runtime context reference.
@@ -91,9 +118,22 @@ the kernel.
          UndoStackStruct *undoHead; //!< Undo list head.
          UndoStackStruct *redoHead; //!< Redo list head.
 
+         UInt64 memoryBudget; //!< Memory budget in bytes. Zero if unbounded.
+         UInt64 memoryUsage; //!< Memory used by the undo and redo lists in bytes.
+
+         Marshal encoder; //!< Reused when encoding action Data.
+         Unmarshal decoder; //!< Reused when decoding action Data.
+         UInt32 nextStringHandle; //!< Next interned string handle.
+         HashTableStringTemplate<UndoStringStruct> stringTable; //!< Interned strings.
+         HashTableUInt32Template<UndoStringStruct> stringHandleTable; //!< Handle table.
 
       private:
          virtual ~RuntimeContextUndo ();
+
+         UInt32 _intern_string (const String &Value);
+         void _release_string (const UInt32 StringHandle);
+         void _release_action_strings (const UndoActionStruct &Action);
+         void _delete_stack (UndoStackStruct *stack);
    };
 };
 
@@ -107,7 +147,12 @@ dmz::RuntimeContextUndo::RuntimeContextUndo (
       inUndo (False),
       currentStack (0),
       undoHead (0),
-      redoHead (0) {;}
+      redoHead (0),
+      memoryBudget (0),
+      memoryUsage (0),
+      encoder (get_byte_order ()),
+      decoder (get_byte_order ()),
+      nextStringHandle (0) {;}
 
 
 //! Destructor.
@@ -116,8 +161,10 @@ dmz::RuntimeContextUndo::~RuntimeContextUndo () {
 
    obsTable.clear ();
    currentStack = 0;
-   if (undoHead) { delete undoHead; undoHead = 0; }
-   if (redoHead) { delete redoHead; redoHead = 0; }
+   delete_stack_list (undoHead); undoHead = 0;
+   delete_stack_list (redoHead); redoHead = 0;
+   stringHandleTable.clear ();
+   stringTable.empty ();
 }
 
 
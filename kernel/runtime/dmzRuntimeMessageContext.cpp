@@ -10,16 +10,25 @@ dmz::MessageContext::MessageContext (
       monostate (0),
       inSend (False),
       parent (theParent),
-      dispatch (msgContext) {
+      dispatch (msgContext),
+      Depth (theParent ? theParent->Depth + 1 : 0),
+      ancestors (0) {
 
    if (dispatch) { dispatch->ref (); }
    if (parent) { parent->ref (); }
+
+   // Each message type holds a reference to its parent so the ancestors are fixed for
+   // the life of the message type.
+   ancestors = new MessageContext *[Depth + 1];
+   ancestors[Depth] = this;
+   for (Int32 ix = 0; ix < Depth; ix++) { ancestors[ix] = parent->ancestors[ix]; }
 }
 
 
 dmz::MessageContext::~MessageContext () {
 
    obsTable.clear ();
+   delete []ancestors; ancestors = 0;
    if (parent) { parent->unref (); parent = 0; }
    if (monostate) { delete monostate; monostate = 0; }
    if (dispatch) { dispatch->unref (); dispatch = 0; }
@@ -35,6 +35,9 @@ namespace dmz {
          MessageContext *parent;
          RuntimeContextMessaging *dispatch;
 
+         const Int32 Depth; //!< Number of ancestors.
+         MessageContext **ancestors; //!< Ancestors indexed by depth. Includes self.
+
          HashTableHandleTemplate<MessageObserver> obsTable;
    };
 };
@@ -158,20 +158,10 @@ dmz::Message::set_type (const Handle TypeHandle, RuntimeContext *context) {
 dmz::Boolean
 dmz::Message::is_of_type (const Message &Type) const {
 
-   Boolean result (False);
-
-   if (Type) {
-
-      Message current (_context);
-
-      while (current && !result) {
+   const Int32 TypeDepth (Type._context ? Type._context->Depth : -1);
 
-         if (Type == current) { result = True; }
-         else { current.become_parent (); }
-      }
-   }
-
-   return result;
+   return _context && (TypeDepth >= 0) && (TypeDepth <= _context->Depth) &&
+      (_context->ancestors[TypeDepth] == Type._context);
 }
 
 
@@ -148,20 +148,7 @@ dmz::ObjectType::set_type (const Handle TypeHandle, RuntimeContext *context) {
 dmz::Boolean
 dmz::ObjectType::is_of_type (const ObjectType &Type) const {
 
-   Boolean result (False);
-
-   ObjectType current (_context);
-
-   if (Type) {
-
-      while (current && !result) {
-
-         if (Type == current) { result = True; }
-         else { current.become_parent (); }
-      }
-   }
-
-   return result;
+   return _context && _context->is_of_type (Type._context);
 }
 
 
@@ -616,14 +603,39 @@ dmz::ObjectTypeSet::contains_type (const ObjectType &Type) const {
 
    Boolean result (False);
 
-   ObjectType current (Type);
+   TypeContext *context (Type.get_type_context ());
+
+   const Int32 Count (_state.table.get_count ());
 
-   Boolean done (current ? False : True);
+   if (context && Count) {
 
-   while (!done) {
+      // Holding the lock keeps the attached ancestors from being destroyed.
+      context->lock.lock ();
+
+      const Int32 First (context->attachedDepth);
+
+      if (Count <= (context->Depth - First)) {
+
+         HashTableHandleIterator it;
+         ObjectType *ptr (0);
+
+         while (!result && _state.table.get_next (it, ptr)) {
+
+            result = context->is_of_type (ptr->get_type_context (), First);
+         }
+      }
+      else {
+
+         for (Int32 ix = context->Depth; !result && (ix >= First); ix--) {
+
+            const Handle TypeHandle (
+               context->ancestors[ix]->Handle.get_runtime_handle ());
+
+            if (_state.table.lookup (TypeHandle)) { result = True; }
+         }
+      }
 
-      if (_state.table.lookup (current.get_handle ())) { result = done = True; }
-      else { current.become_parent (); if (!current) { done = True; } }
+      context->lock.unlock ();
    }
 
    return result;
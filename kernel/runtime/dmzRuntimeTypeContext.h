@@ -23,12 +23,20 @@ namespace dmz {
          const String Name;
          const RuntimeHandle Handle;
 
-         SpinLock lock;
+         mutable SpinLock lock;
 
          TypeContext *parent;
          ConfigContext *config;
          HashTableHandleTemplate<TypeContext> table;
 
+         const Int32 Depth; //!< Number of ancestors when the type was created.
+         Int32 attachedDepth; //!< Depth of the oldest ancestor still attached.
+         TypeContext **ancestors; //!< Ancestors indexed by depth. Includes self.
+
+         Boolean is_of_type (const TypeContext *Type) const;
+         Boolean is_of_type (const TypeContext *Type, const Int32 First) const;
+         void detach_ancestors (const Int32 TheDepth);
+
       protected:
          ~TypeContext ();
 
@@ -48,12 +56,22 @@ dmz::TypeContext::TypeContext (
       Name (TheName),
       Handle (TheName + ".Type", context),
       parent (theParent),
-      config (theConfig) {
+      config (theConfig),
+      Depth (theParent ? theParent->Depth + 1 : 0),
+      attachedDepth (0),
+      ancestors (0) {
+
+   // The ancestors never change once a type is created so ancestry tests index the
+   // array instead of walking the parent chain.
+   ancestors = new TypeContext *[Depth + 1];
+   ancestors[Depth] = this;
 
    if (config) { config->ref (); }
    if (theParent) {
 
       theParent->lock.lock ();
+      for (Int32 ix = 0; ix < Depth; ix++) { ancestors[ix] = theParent->ancestors[ix]; }
+      attachedDepth = theParent->attachedDepth;
       if (theParent->table.store (Handle.get_runtime_handle (), this)) { this->ref (); }
       theParent->lock.unlock ();
    }
@@ -76,6 +94,7 @@ dmz::TypeContext::~TypeContext () {
          current->lock.lock ();
          current->parent = 0;
          current->lock.unlock ();
+         current->detach_ancestors (current->Depth);
          current->unref ();
          current = table.get_next (it);
       }
@@ -86,6 +105,52 @@ dmz::TypeContext::~TypeContext () {
 
    lock.unlock ();
 
+   delete []ancestors; ancestors = 0;
+}
+
+
+//! Returns dmz::True if \a Type is the type or one of its attached ancestors.
+inline dmz::Boolean
+dmz::TypeContext::is_of_type (const TypeContext *Type) const {
+
+   // attachedDepth is changed by detach_ancestors () so it is read under the lock.
+   lock.lock ();
+   const Int32 First (attachedDepth);
+   lock.unlock ();
+
+   return is_of_type (Type, First);
+}
+
+
+//! Same as is_of_type () but uses \a First, read by a caller holding the lock.
+inline dmz::Boolean
+dmz::TypeContext::is_of_type (const TypeContext *Type, const Int32 First) const {
+
+   const Int32 TypeDepth (Type ? Type->Depth : -1);
+
+   return (TypeDepth >= First) && (TypeDepth <= Depth) && (ancestors[TypeDepth] == Type);
+}
+
+
+//! Detaches the type and its descendants from the ancestors above \a TheDepth.
+inline void
+dmz::TypeContext::detach_ancestors (const Int32 TheDepth) {
+
+   HashTableHandleIterator it;
+
+   lock.lock ();
+
+      if (TheDepth > attachedDepth) { attachedDepth = TheDepth; }
+
+      TypeContext *current = table.get_first (it);
+
+      while (current) {
+
+         current->detach_ancestors (TheDepth);
+         current = table.get_next (it);
+      }
+
+   lock.unlock ();
 }
 
 #endif // DMZ_RUNTIME_TYPE_CONTEXT_DOT_H
@@ -63,7 +63,9 @@ const Data *Value)
 \brief Interface for undo and redo.
 \details The Undo class provides an interface for recording and triggering undo and redo
 messages. Undo and redo actions may be nested. When an action is invoked all
-nested actions are invoked as well.
+nested actions are invoked as well. The memory used by the recorded actions may be
+bounded with dmz::Undo::set_memory_budget. When the budget is exceeded, the oldest
+actions are discarded.
 
 */
 
@@ -105,13 +107,43 @@ dmz::Undo::reset () {
 
    if (_context && !_context->currentStack) {
 
-      if (_context->undoHead) { delete _context->undoHead; _context->undoHead = 0; }
-      if (_context->redoHead) { delete _context->redoHead; _context->redoHead = 0; }
+      _context->delete_stack_list (_context->undoHead); _context->undoHead = 0;
+      _context->delete_stack_list (_context->redoHead); _context->redoHead = 0;
       _context->update_action_names ();
    }
 }
 
 
+/*!
+
+\brief Sets the memory budget for recorded undo and redo actions.
+\details When the memory used by the recorded actions exceeds the budget, the oldest
+undo actions are discarded followed by the oldest redo actions. The next undo and redo
+actions are always kept. The default budget of zero does not bound memory use.
+\param[in] Bytes Memory budget in bytes.
+
+*/
+void
+dmz::Undo::set_memory_budget (const UInt64 Bytes) {
+
+   if (_context) {
+
+      _context->memoryBudget = Bytes;
+      _context->enforce_memory_budget ();
+   }
+}
+
+
+//! Returns the memory budget in bytes. Zero if memory use is not bounded.
+dmz::UInt64
+dmz::Undo::get_memory_budget () const { return _context ? _context->memoryBudget : 0; }
+
+
+//! Returns the memory used by the recorded undo and redo actions in bytes.
+dmz::UInt64
+dmz::Undo::get_memory_usage () const { return _context ? _context->memoryUsage : 0; }
+
+
 /*!
 
 \brief Tests if handle is from a nested undo dmz::Undo::start_record().
@@ -214,12 +246,16 @@ dmz::Undo::dump (const UndoTypeEnum Type, UndoDump &out) {
          if (count) {
 
             HashTableUInt32Iterator it;
+            Data data (&(_context->context));
 
             uas = table.get_last (it);
 
             while (uas) {
 
-               out.store_action (uas->Type, uas->ObserverHandle, uas->data);
+               out.store_action (
+                  uas->Type,
+                  uas->ObserverHandle,
+                  _context->decode_action (*uas, data) ? &data : 0);
 
                uas = table.get_prev (it);
             }
@@ -262,8 +298,7 @@ out << "@@@@@@@@@@ Start Do Next Undo @@@@@@@@@@" << endl;
 
             _context->undoHead = current->next;
 
-            _context->currentStack =
-               new UndoStackStruct (current->Name, &(_context->context));
+            _context->currentStack = _context->create_stack (current->Name, True);
 
             if (_context->currentStack) {
 
@@ -284,8 +319,7 @@ out << "@@@@@@@@@@ Start Do Next Redo @@@@@@@@@@" << endl;
 
             _context->redoHead = current->next;
 
-            _context->currentStack =
-               new UndoStackStruct (current->Name, &(_context->context));
+            _context->currentStack = _context->create_stack (current->Name, True);
 
             if (_context->currentStack) {
 
@@ -308,19 +342,20 @@ out << "@@@@@@@@@@ Start Do Next Redo @@@@@@@@@@" << endl;
             RecordType);
 
          UndoActionStruct *action (current->head);
+         Data data (&(_context->context));
 
          while (action) {
 
 #ifdef DMZ_RUNTIME_UNDO_DEBUG
 out << "------- Start Do Action -------" << endl;
 out << action->Type.get_name () << endl;
-if (action->data) { out << *(action->data) << endl; }
+if (action->buffer) { out << action->size << " bytes" << endl; }
 out << "-------------------------------" << endl;
 #endif
 
             action->Type.send (
                action->ObserverHandle,
-               action->data,
+               _context->decode_action (*action, data) ? &data : 0,
                0);
 
             action = action->next;
@@ -328,8 +363,9 @@ out << "-------------------------------" << endl;
 
          _context->currentStack = 0;
 
-         delete current; current = 0;
+         _context->delete_stack_list (current); current = 0;
 
+         _context->enforce_memory_budget ();
          _context->update_action_names ();
 
          _context->update_record_state (
@@ -366,7 +402,7 @@ dmz::Undo::start_record (const String &Name) {
 
       if (!_context->currentStack) {
 
-         _context->currentStack = new UndoStackStruct (Name, &(_context->context), False);
+         _context->currentStack = _context->create_stack (Name, False);
 
          if (_context->currentStack) {
 
@@ -409,12 +445,40 @@ dmz::Undo::store_action (
       const Handle ObserverHandle,
       const Data *UndoData) {
 
+   return store_coalesced_action (Type, ObserverHandle, 0, UndoData);
+}
+
+
+/*!
+
+\brief Stores an action that may be coalesced with the previous action.
+\details Consecutive actions in the same record with the same message, observer, and
+non-zero \a CoalesceKey are coalesced. Only the first of these actions is stored since
+it restores the value that was current before the actions were recorded. This allows
+repeated updates to the same value (e.g. dragging an object) to be recorded as a single
+action.
+\param[in] Type Message that will be sent when the action is played back.
+\param[in] ObserverHandle Handle to the observer the action message should be set to.
+If set to zero, it is sent to all subscribers of the specified message type.
+\param[in] CoalesceKey Key identifying the value the action restores. If set to zero,
+the action is never coalesced.
+\param[in] UndoData Pointer to Data object to be sent with the action message. Pointer
+may be NULL if no data needs to be sent with the message.
+\return Returns dmz::True if the action was stored or coalesced successfully. Will
+return dmz::False if actions are not currently being recorded.
+
+*/
+dmz::Boolean
+dmz::Undo::store_coalesced_action (
+      const Message &Type,
+      const Handle ObserverHandle,
+      const UInt64 CoalesceKey,
+      const Data *UndoData) {
+
    Boolean result (False);
 
    if (_context && _context->currentStack) {
 
-      UndoActionStruct *uas (new UndoActionStruct (Type, ObserverHandle, UndoData));
-
 #ifdef DMZ_RUNTIME_UNDO_DEBUG
 out << "###### Start Store Action ######" << endl;
 out << Type.get_name () << endl;
@@ -422,12 +486,12 @@ if (UndoData) { out << *UndoData << endl; }
 out << "################################" << endl;
 #endif
 
-      if (uas) {
-
-         result = True;
-         uas->next = _context->currentStack->head;
-         _context->currentStack->head = uas;
-      }
+      result = _context->store_action (
+         *(_context->currentStack),
+         Type,
+         ObserverHandle,
+         CoalesceKey,
+         UndoData);
    }
 
    return result;
@@ -478,10 +542,11 @@ out << "+++ Stop Record: " << _context->currentStack->Name << endl;
                _context->currentStack &&
                !_context->currentStack->AutoCreated) {
 
-            delete _context->redoHead; _context->redoHead = 0;
+            _context->delete_stack_list (_context->redoHead); _context->redoHead = 0;
          }
 
          _context->currentStack = 0;
+         _context->enforce_memory_budget ();
          _context->update_action_names ();
          _context->update_record_state (
             UndoRecordingStateStop,
@@ -529,7 +594,7 @@ dmz::Undo::abort_record (const Handle RecordHandle) {
          UndoRecordingTypeExplicit,
          UndoTypeUndo);
 
-      delete stack; stack = 0;
+      _context->delete_stack_list (stack); stack = 0;
 
       result = True;
    }
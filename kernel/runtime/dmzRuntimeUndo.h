@@ -56,6 +56,10 @@ namespace dmz {
 
          void reset ();
 
+         void set_memory_budget (const UInt64 Bytes);
+         UInt64 get_memory_budget () const;
+         UInt64 get_memory_usage () const;
+
          Boolean is_nested_handle (const Handle UndoHandle) const;
          Boolean is_in_undo () const;
          Boolean is_recording () const;
@@ -77,6 +81,12 @@ namespace dmz {
             return store_action (Type, 0, UndoData);
          }
 
+         Boolean store_coalesced_action (
+            const Message &Type,
+            const Handle ObserverHandle,
+            const UInt64 CoalesceKey,
+            const Data *UndoData);
+
          Boolean stop_record (const Handle Handle);
          Boolean abort_record (const Handle Handle);
 
@@ -0,0 +1,34 @@
+#ifndef DMZ_SYSTEM_THREAD_POOL_DOT_H
+#define DMZ_SYSTEM_THREAD_POOL_DOT_H
+
+#include <dmzKernelExport.h>
+#include <dmzTypesBase.h>
+
+namespace dmz {
+
+   class ThreadFunction;
+
+   class DMZ_KERNEL_LINK_SYMBOL ThreadPool {
+
+      public:
+         ThreadPool ();
+         ~ThreadPool ();
+
+         void set_thread_count (const Int32 Count);
+         Int32 get_thread_count () const;
+
+         void add_task (ThreadFunction &task);
+         Boolean is_done ();
+         void wait ();
+
+      protected:
+         struct State;
+         State &_state; //!< Internal state.
+
+      private:
+         ThreadPool (const ThreadPool &);
+         ThreadPool &operator= (const ThreadPool &);
+   };
+};
+
+#endif // DMZ_SYSTEM_THREAD_POOL_DOT_H
@@ -0,0 +1,241 @@
+#include <dmzSystemThread.h>
+#include <dmzSystemThreadPool.h>
+
+#include <pthread.h>
+
+/*!
+
+\class dmz::ThreadPool
+\ingroup System
+\brief Runs tasks on a set of persistent worker threads.
+\details The worker threads are created by dmz::ThreadPool::set_thread_count and are
+reused for every task added to the pool. Idle workers block until a task is added. The
+workers are joined when the thread count is changed and when the pool is destroyed.
+A pool without worker threads runs each task on the calling thread.
+\code
+dmz::ThreadPool pool;
+pool.set_thread_count (3);
+
+for (dmz::Int32 ix = 0; ix < 3; ix++) { pool.add_task (worker); }
+
+worker.run_thread_function ();
+pool.wait ();
+\endcode
+
+*/
+
+namespace {
+
+struct TaskStruct {
+
+   dmz::ThreadFunction &task;
+   TaskStruct *next;
+
+   TaskStruct (dmz::ThreadFunction &theTask) : task (theTask), next (0) {;}
+};
+
+};
+
+
+struct dmz::ThreadPool::State {
+
+   pthread_mutex_t lock;
+   pthread_cond_t wake;
+   pthread_cond_t done;
+   pthread_t *threads;
+   Int32 threadCount;
+   Int32 pending;
+   Boolean stop;
+   TaskStruct *head;
+   TaskStruct *tail;
+
+   static void *run_thread (void *data);
+   void run_tasks ();
+   void stop_threads ();
+
+   State () :
+         threads (0),
+         threadCount (0),
+         pending (0),
+         stop (False),
+         head (0),
+         tail (0) {
+
+      pthread_mutex_init (&lock, 0);
+      pthread_cond_init (&wake, 0);
+      pthread_cond_init (&done, 0);
+   }
+
+   ~State () {
+
+      stop_threads ();
+      pthread_cond_destroy (&done);
+      pthread_cond_destroy (&wake);
+      pthread_mutex_destroy (&lock);
+   }
+};
+
+
+void *
+dmz::ThreadPool::State::run_thread (void *data) {
+
+   State *state ((State *)data);
+
+   if (state) { state->run_tasks (); }
+
+   cleanup_thread ();
+
+   return data;
+}
+
+
+void
+dmz::ThreadPool::State::run_tasks () {
+
+   Boolean running (True);
+
+   pthread_mutex_lock (&lock);
+
+   while (running) {
+
+      while (!head && !stop) { pthread_cond_wait (&wake, &lock); }
+
+      TaskStruct *ts (head);
+
+      if (ts) {
+
+         head = ts->next;
+         if (!head) { tail = 0; }
+
+         pthread_mutex_unlock (&lock);
+
+         ts->task.run_thread_function ();
+         delete ts; ts = 0;
+
+         pthread_mutex_lock (&lock);
+
+         pending--;
+         if (!pending) { pthread_cond_broadcast (&done); }
+      }
+      else { running = False; }
+   }
+
+   pthread_mutex_unlock (&lock);
+}
+
+
+// Queued tasks are finished before the workers exit.
+void
+dmz::ThreadPool::State::stop_threads () {
+
+   if (threads) {
+
+      pthread_mutex_lock (&lock);
+         stop = True;
+         pthread_cond_broadcast (&wake);
+      pthread_mutex_unlock (&lock);
+
+      for (Int32 ix = 0; ix < threadCount; ix++) { pthread_join (threads[ix], 0); }
+
+      delete []threads; threads = 0;
+      threadCount = 0;
+      stop = False;
+   }
+}
+
+
+//! Constructor. The pool is created without worker threads.
+dmz::ThreadPool::ThreadPool () : _state (*(new State)) {;}
+
+
+//! Destructor. Finishes the queued tasks and joins the worker threads.
+dmz::ThreadPool::~ThreadPool () { delete &_state; }
+
+
+/*!
+
+\brief Sets the number of worker threads.
+\details Finishes the queued tasks and joins the current worker threads before the
+new worker threads are created.
+\param[in] Count Number of worker threads. Zero runs tasks on the calling thread.
+
+*/
+void
+dmz::ThreadPool::set_thread_count (const Int32 Count) {
+
+   _state.stop_threads ();
+
+   if (Count > 0) {
+
+      _state.threads = new pthread_t[Count];
+
+      for (Int32 ix = 0; ix < Count; ix++) {
+
+         if (pthread_create (
+               &(_state.threads[_state.threadCount]),
+               0,
+               State::run_thread,
+               (void *)&_state) == 0) {
+
+            _state.threadCount++;
+         }
+      }
+
+      if (!_state.threadCount) { delete []_state.threads; _state.threads = 0; }
+   }
+}
+
+
+//! Returns the number of worker threads.
+dmz::Int32
+dmz::ThreadPool::get_thread_count () const { return _state.threadCount; }
+
+
+/*!
+
+\brief Adds a task to the pool.
+\details The task's dmz::ThreadFunction::run_thread_function is invoked once by the
+next idle worker thread. If the pool has no worker threads, the task is run before this
+function returns. The same task may be added more than once.
+\param[in] task ThreadFunction to run. It must not be deleted until the task is done.
+
+*/
+void
+dmz::ThreadPool::add_task (ThreadFunction &task) {
+
+   if (_state.threadCount > 0) {
+
+      TaskStruct *ts (new TaskStruct (task));
+
+      pthread_mutex_lock (&(_state.lock));
+         if (_state.tail) { _state.tail->next = ts; }
+         else { _state.head = ts; }
+         _state.tail = ts;
+         _state.pending++;
+         pthread_cond_signal (&(_state.wake));
+      pthread_mutex_unlock (&(_state.lock));
+   }
+   else { task.run_thread_function (); }
+}
+
+
+//! Returns dmz::True if every task added to the pool is done.
+dmz::Boolean
+dmz::ThreadPool::is_done () {
+
+   pthread_mutex_lock (&(_state.lock));
+      const Boolean Result (_state.pending == 0);
+   pthread_mutex_unlock (&(_state.lock));
+
+   return Result;
+}
+
+
+//! Blocks until every task added to the pool is done.
+void
+dmz::ThreadPool::wait () {
+
+   pthread_mutex_lock (&(_state.lock));
+      while (_state.pending > 0) { pthread_cond_wait (&(_state.done), &(_state.lock)); }
+   pthread_mutex_unlock (&(_state.lock));
+}
@@ -0,0 +1,208 @@
+#include <dmzSystemThread.h>
+#include <dmzSystemThreadPool.h>
+
+#ifndef _WIN32_WINNT
+#define _WIN32_WINNT 0x0400
+#endif
+#include <windows.h>
+#include <process.h>
+
+namespace {
+
+struct TaskStruct {
+
+   dmz::ThreadFunction &task;
+   TaskStruct *next;
+
+   TaskStruct (dmz::ThreadFunction &theTask) : task (theTask), next (0) {;}
+};
+
+static const LONG MaxSignals = 0x7FFFFFFF;
+
+};
+
+
+// The wake semaphore is released once per task and once per worker when the workers
+// are stopped. A worker that wakes to an empty queue exits.
+struct dmz::ThreadPool::State {
+
+   CRITICAL_SECTION lock;
+   HANDLE wake;
+   HANDLE done;
+   HANDLE *threads;
+   Int32 threadCount;
+   Int32 pending;
+   TaskStruct *head;
+   TaskStruct *tail;
+
+   static unsigned int WINAPI run_thread (LPVOID data);
+   void run_tasks ();
+   void stop_threads ();
+
+   State () :
+         wake (0),
+         done (0),
+         threads (0),
+         threadCount (0),
+         pending (0),
+         head (0),
+         tail (0) {
+
+      InitializeCriticalSection (&lock);
+      wake = CreateSemaphore (0, 0, MaxSignals, 0);
+      done = CreateEvent (0, TRUE, TRUE, 0);
+   }
+
+   ~State () {
+
+      stop_threads ();
+      if (done) { CloseHandle (done); done = 0; }
+      if (wake) { CloseHandle (wake); wake = 0; }
+      DeleteCriticalSection (&lock);
+   }
+};
+
+
+unsigned int WINAPI
+dmz::ThreadPool::State::run_thread (LPVOID data) {
+
+   State *state ((State *)data);
+
+   if (state) { state->run_tasks (); }
+
+   cleanup_thread ();
+
+   return 1;
+}
+
+
+void
+dmz::ThreadPool::State::run_tasks () {
+
+   Boolean running (True);
+
+   while (running) {
+
+      WaitForSingleObject (wake, INFINITE);
+
+      EnterCriticalSection (&lock);
+         TaskStruct *ts (head);
+
+         if (ts) {
+
+            head = ts->next;
+            if (!head) { tail = 0; }
+         }
+      LeaveCriticalSection (&lock);
+
+      if (ts) {
+
+         ts->task.run_thread_function ();
+         delete ts; ts = 0;
+
+         EnterCriticalSection (&lock);
+            pending--;
+            if (!pending) { SetEvent (done); }
+         LeaveCriticalSection (&lock);
+      }
+      else { running = False; }
+   }
+}
+
+
+void
+dmz::ThreadPool::State::stop_threads () {
+
+   if (threads) {
+
+      ReleaseSemaphore (wake, threadCount, 0);
+
+      for (Int32 ix = 0; ix < threadCount; ix++) {
+
+         WaitForSingleObject (threads[ix], INFINITE);
+         CloseHandle (threads[ix]);
+      }
+
+      delete []threads; threads = 0;
+      threadCount = 0;
+   }
+}
+
+
+dmz::ThreadPool::ThreadPool () : _state (*(new State)) {;}
+
+
+dmz::ThreadPool::~ThreadPool () { delete &_state; }
+
+
+void
+dmz::ThreadPool::set_thread_count (const Int32 Count) {
+
+   _state.stop_threads ();
+
+   if (Count > 0) {
+
+      _state.threads = new HANDLE[Count];
+
+      for (Int32 ix = 0; ix < Count; ix++) {
+
+         unsigned int id (0);
+
+         const uintptr_t Thread (_beginthreadex (
+            0,
+            0,
+            State::run_thread,
+            LPVOID (&_state),
+            0,
+            &id));
+
+         if (Thread) {
+
+            _state.threads[_state.threadCount] = HANDLE (Thread);
+            _state.threadCount++;
+         }
+      }
+
+      if (!_state.threadCount) { delete []_state.threads; _state.threads = 0; }
+   }
+}
+
+
+dmz::Int32
+dmz::ThreadPool::get_thread_count () const { return _state.threadCount; }
+
+
+void
+dmz::ThreadPool::add_task (ThreadFunction &task) {
+
+   if (_state.threadCount > 0) {
+
+      TaskStruct *ts (new TaskStruct (task));
+
+      EnterCriticalSection (&(_state.lock));
+         if (_state.tail) { _state.tail->next = ts; }
+         else { _state.head = ts; }
+         _state.tail = ts;
+         _state.pending++;
+         ResetEvent (_state.done);
+      LeaveCriticalSection (&(_state.lock));
+
+      ReleaseSemaphore (_state.wake, 1, 0);
+   }
+   else { task.run_thread_function (); }
+}
+
+
+dmz::Boolean
+dmz::ThreadPool::is_done () {
+
+   EnterCriticalSection (&(_state.lock));
+      const Boolean Result (_state.pending == 0);
+   LeaveCriticalSection (&(_state.lock));
+
+   return Result;
+}
+
+
+void
+dmz::ThreadPool::wait () { WaitForSingleObject (_state.done, INFINITE); }
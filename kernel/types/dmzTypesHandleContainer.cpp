@@ -1,79 +1,166 @@
 #include <dmzTypesHandleContainer.h>
-#include <dmzTypesHashTableHandleTemplate.h>
+
+#include <stdlib.h> // qsort
+#include <string.h> // memcpy memmove
 
 /*!
 
 \class dmz::HandleContainerIterator
 \ingroup Types
 \brief Iterator used to traverse a HandleContainer.
+\details The iterator remembers the insertion order of the last Handle it returned.
+Handles may be added to or removed from the container while it is being iterated.
 
 */
 
-//! \cond
-struct dmz::HandleContainerIterator::State {
-
-   HashTableHandleIterator it;
-};
-//! \endcond
-
-
 //! Constructor.
-dmz::HandleContainerIterator::HandleContainerIterator () : state (*(new State)) {;}
+dmz::HandleContainerIterator::HandleContainerIterator () : index (-1), order (0) {;}
 
 
 //! Destructor.
-dmz::HandleContainerIterator::~HandleContainerIterator () { delete &state; }
+dmz::HandleContainerIterator::~HandleContainerIterator () {;}
 
 
 //! Resets iterator.
 void
-dmz::HandleContainerIterator::reset () { state.it.reset (); }
+dmz::HandleContainerIterator::reset () { index = -1; order = 0; }
 
 /*!
 
 \class dmz::HandleContainer
 \ingroup Types
 \brief Container class for storing Handles.
+\details The Handles are iterated in the order they were added. A second array keeps
+the same Handles sorted by value so lookups use a binary search.
+Small containers store their Handles inside the HandleContainer and do not allocate.
 
 */
 
-//! \cond
-struct dmz::HandleContainer::State {
+namespace {
+
+typedef dmz::HandleContainer::Entry local_entry;
+
+// Sorts by Handle and then by insertion order.
+static int
+local_compare_value (const void *Value1, const void *Value2) {
+
+   const local_entry *First ((const local_entry *)Value1);
+   const local_entry *Second ((const local_entry *)Value2);
+
+   return (First->value < Second->value) ? -1 : ((First->value > Second->value) ? 1 :
+      ((First->order < Second->order) ? -1 : ((First->order > Second->order) ? 1 : 0)));
+}
+
+
+static int
+local_compare_order (const void *Value1, const void *Value2) {
+
+   const local_entry *First ((const local_entry *)Value1);
+   const local_entry *Second ((const local_entry *)Value2);
+
+   return (First->order < Second->order) ? -1 : ((First->order > Second->order) ? 1 : 0);
+}
+
+
+// Moves the iterator to the next or previous index. Returns False if there are no
+// more Handles in that direction. If the container was changed since the iterator
+// was last used, the iterator's position is found from the insertion order of the
+// last Handle it returned.
+static dmz::Boolean
+local_step (
+      const local_entry *Data,
+      const dmz::Int32 Count,
+      const dmz::Int32 Found,
+      dmz::HandleContainerIterator &it,
+      const dmz::Boolean Prev) {
+
+   dmz::Int32 index (-1);
+
+   if (it.index < 0) { index = Prev ? Count - 1 : 0; }
+   else if ((it.index < Count) && (Data[it.index].order == it.order)) {
+
+      index = Prev ? it.index - 1 : it.index + 1;
+   }
+   else if (Prev) { index = Found - 1; }
+   else {
+
+      index = ((Found < Count) && (Data[Found].order == it.order)) ? Found + 1 : Found;
+   }
+
+   const dmz::Boolean Result ((index >= 0) && (index < Count));
+
+   if (Result) { it.index = index; it.order = Data[index].order; }
+
+   return Result;
+}
+
+
+// Keeps the Handles in data for which Container.contains () equals Wanted. The
+// order of the kept Handles does not change. Returns the number of Handles kept.
+static dmz::Int32
+local_filter (
+      local_entry *data,
+      const dmz::Int32 Count,
+      const dmz::HandleContainer &Container,
+      const dmz::Boolean Wanted) {
+
+   dmz::Int32 place (0);
+
+   for (dmz::Int32 ix = 0; ix < Count; ix++) {
+
+      if (Container.contains (data[ix].value) == Wanted) {
+
+         data[place] = data[ix];
+         place++;
+      }
+   }
+
+   return place;
+}
 
-   HashTableHandleIterator it;
-   HashTableHandle table;
-   ~State () { table.clear (); }
 };
-//! \endcond
 
 
 //! Constructor.
-dmz::HandleContainer::HandleContainer () : _state (*(new State)) {;}
+dmz::HandleContainer::HandleContainer () :
+      _data (_local),
+      _sorted (_local + LocalSize),
+      _count (0),
+      _capacity (LocalSize),
+      _nextOrder (1) {;}
 
 
 //! Copy Constructor.
-dmz::HandleContainer::HandleContainer (
-      const HandleContainer &Container) : _state (*(new State)) { *this = Container; }
+dmz::HandleContainer::HandleContainer (const HandleContainer &Container) :
+      _data (_local),
+      _sorted (_local + LocalSize),
+      _count (0),
+      _capacity (LocalSize),
+      _nextOrder (1) {
+
+   *this = Container;
+}
 
 
 //! Destructor.
-dmz::HandleContainer::~HandleContainer () { delete &_state; }
+dmz::HandleContainer::~HandleContainer () {
+
+   if (_data != _local) { delete []_data; _data = 0; _sorted = 0; }
+}
 
 
 //! Assignment operator.
 dmz::HandleContainer &
 dmz::HandleContainer::operator= (const HandleContainer &Container) {
 
-   _state.table.clear ();
-
-   HashTableHandleIterator it;
-
-   void *ptr = Container._state.table.get_next (it);
+   if (&Container != this) {
 
-   while (ptr) {
-
-      _state.table.store (it.get_hash_key (), (void *)this);
-      ptr = Container._state.table.get_next (it);
+      _count = 0;
+      _reserve (Container._count);
+      memcpy (_data, Container._data, Container._count * sizeof (Entry));
+      memcpy (_sorted, Container._sorted, Container._count * sizeof (Entry));
+      _count = Container._count;
+      _nextOrder = Container._nextOrder;
    }
 
    return *this;
@@ -93,19 +180,11 @@ in the same order.
 dmz::Boolean
 dmz::HandleContainer::operator== (const HandleContainer &Container) const {
 
-   Boolean result (False);
+   Boolean result (_count == Container._count);
 
-   if (get_count () == Container.get_count ()) {
+   for (Int32 ix = 0; result && (ix < _count); ix++) {
 
-      result = True;
-
-      HandleContainerIterator it1, it2;
-      Handle v1, v2;
-
-      while (result && get_next (it1, v1) && Container.get_next (it2, v2)) {
-
-         if (v1 != v2) { result = False; }
-      }
+      if (_data[ix].value != Container._data[ix].value) { result = False; }
    }
 
    return result;
@@ -115,6 +194,7 @@ dmz::HandleContainer::operator== (const HandleContainer &Container) const {
 /*!
 
 \brief Tests if two HandleContainer object have the same content.
+\details The order in which the Handles were added does not matter.
 \param[in] Container HandleContainer to test against.
 \return Returns dmz::True if the two HandleContainer objects have the same content.
 
@@ -122,33 +202,87 @@ dmz::HandleContainer::operator== (const HandleContainer &Container) const {
 dmz::Boolean
 dmz::HandleContainer::has_same_content (const HandleContainer &Container) const {
 
-   Boolean result (False);
+   Boolean result (_count == Container._count);
 
-   if (get_count () == Container.get_count ()) {
+   for (Int32 ix = 0; result && (ix < _count); ix++) {
 
-      result = True;
+      if (_sorted[ix].value != Container._sorted[ix].value) { result = False; }
+   }
+
+   return result;
+}
+
+
+/*!
+
+\brief Assignment by sum operator.
+\details Adds all the Handles in \a Container that are not already stored. This is a
+set union. The new Handles are added in the order they are stored in \a Container.
+\param[in] Container HandleContainer to add.
+\return Returns a reference to self.
 
-      HandleContainerIterator it;
-      Handle value;
+*/
+dmz::HandleContainer &
+dmz::HandleContainer::operator+= (const HandleContainer &Container) {
+
+   if ((&Container != this) && (Container._count > 0)) {
 
-      while (result && get_next (it, value)) {
+      Entry *added (new Entry[Container._count]);
 
-         if (!Container.contains (value)) { result = False; }
+      for (Int32 ix = 0; ix < Container._count; ix++) {
+
+         added[ix].value = Container._data[ix].value;
+         added[ix].order = _nextOrder + UInt64 (ix);
       }
+
+      _append (added, Container._count);
+
+      delete []added; added = 0;
    }
 
-   return result;
+   return *this;
 }
 
 
-//! Assignment by sum operator.
+/*!
+
+\brief Assignment by difference operator.
+\details Removes all the Handles in \a Container. The remaining Handles keep their order.
+\param[in] Container HandleContainer of Handles to remove.
+\return Returns a reference to self.
+
+*/
 dmz::HandleContainer &
-dmz::HandleContainer::operator+= (const HandleContainer &Container) {
+dmz::HandleContainer::operator-= (const HandleContainer &Container) {
+
+   if (&Container == this) { clear (); }
+   else if (Container._count > 0) {
 
-   Handle item;
-   HandleContainerIterator it;
+      local_filter (_sorted, _count, Container, False);
+      _count = local_filter (_data, _count, Container, False);
+   }
+
+   return *this;
+}
 
-   while (Container.get_next (it, item)) { add (item); }
+
+/*!
+
+\brief Assignment by intersection operator.
+\details Removes all the Handles that are not in \a Container. The remaining Handles
+keep their order.
+\param[in] Container HandleContainer to intersect with.
+\return Returns a reference to self.
+
+*/
+dmz::HandleContainer &
+dmz::HandleContainer::operator&= (const HandleContainer &Container) {
+
+   if (&Container != this) {
+
+      local_filter (_sorted, _count, Container, True);
+      _count = local_filter (_data, _count, Container, True);
+   }
 
    return *this;
 }
@@ -156,12 +290,12 @@ dmz::HandleContainer::operator+= (const HandleContainer &Container) {
 
 //! Clears container.
 void
-dmz::HandleContainer::clear () { _state.table.clear (); }
+dmz::HandleContainer::clear () { _count = 0; }
 
 
 //! Returns number of unique Handles stored in container.
 dmz::Int32
-dmz::HandleContainer::get_count () const { return _state.table.get_count (); }
+dmz::HandleContainer::get_count () const { return _count; }
 
 
 /*!
@@ -174,7 +308,9 @@ dmz::HandleContainer::get_count () const { return _state.table.get_count (); }
 dmz::Boolean
 dmz::HandleContainer::contains (const Handle Value) const {
 
-   return _state.table.lookup (Value) != 0;
+   const Int32 Place (_find (Value));
+
+   return (Place < _count) && (_sorted[Place].value == Value);
 }
 
 
@@ -189,11 +325,60 @@ dmz::HandleContainer::contains (const Handle Value) const {
 dmz::Boolean
 dmz::HandleContainer::add (const Handle Value) {
 
-   Boolean result (False);
+   const Int32 Place (_find (Value));
 
-   result = _state.table.store (Value, (void *)this);
+   if ((Place >= _count) || (_sorted[Place].value != Value)) {
 
-   if (!result) { result = contains (Value); }
+      _reserve (_count + 1);
+
+      if (Place < _count) {
+
+         memmove (
+            _sorted + Place + 1,
+            _sorted + Place,
+            (_count - Place) * sizeof (Entry));
+      }
+
+      _sorted[Place].value = Value;
+      _sorted[Place].order = _nextOrder;
+      _data[_count] = _sorted[Place];
+      _nextOrder++;
+      _count++;
+   }
+
+   return True;
+}
+
+
+/*!
+
+\brief Adds an array of Handles to container.
+\details The array may contain duplicates. New Handles are added in the order they
+appear in \a Values.
+\param[in] Values Array of Handles to be added.
+\param[in] Count Number of Handles in \a Values.
+\return Returns the number of Handles that were not already in the container.
+
+*/
+dmz::Int32
+dmz::HandleContainer::add (const Handle *Values, const Int32 Count) {
+
+   Int32 result (0);
+
+   if (Values && (Count > 0)) {
+
+      Entry *added (new Entry[Count]);
+
+      for (Int32 ix = 0; ix < Count; ix++) {
+
+         added[ix].value = Values[ix];
+         added[ix].order = _nextOrder + UInt64 (ix);
+      }
+
+      result = _append (added, Count);
+
+      delete []added; added = 0;
+   }
 
    return result;
 }
@@ -209,7 +394,33 @@ dmz::HandleContainer::add (const Handle Value) {
 dmz::Boolean
 dmz::HandleContainer::remove (const Handle Value) {
 
-   return (_state.table.remove (Value) != 0);
+   Boolean result (False);
+
+   const Int32 Place (_find (Value));
+
+   if ((Place < _count) && (_sorted[Place].value == Value)) {
+
+      const Int32 Index (_find_order (_sorted[Place].order));
+
+      _count--;
+
+      if (Place < _count) {
+
+         memmove (
+            _sorted + Place,
+            _sorted + Place + 1,
+            (_count - Place) * sizeof (Entry));
+      }
+
+      if (Index < _count) {
+
+         memmove (_data + Index, _data + Index + 1, (_count - Index) * sizeof (Entry));
+      }
+
+      result = True;
+   }
+
+   return result;
 }
 
 
@@ -221,16 +432,7 @@ empty.
 
 */
 dmz::Handle
-dmz::HandleContainer::get_first () const {
-
-   Handle result (0);
-
-   _state.it.reset ();
-
-   if (_state.table.get_next (_state.it) != 0) { result = _state.it.get_hash_key (); }
-
-   return result;
-}
+dmz::HandleContainer::get_first () const { return get_first (_it); }
 
 
 /*!
@@ -241,14 +443,7 @@ have been returned.
 
 */
 dmz::Handle
-dmz::HandleContainer::get_next () const {
-
-   Handle result (0);
-
-   if (_state.table.get_next (_state.it) != 0) { result = _state.it.get_hash_key (); }
-
-   return result;
-}
+dmz::HandleContainer::get_next () const { return get_next (_it); }
 
 
 /*!
@@ -259,17 +454,7 @@ beginning of the table.
 
 */
 dmz::Handle
-dmz::HandleContainer::get_prev () const {
-
-   Handle result (0);
-
-   if (_state.table.get_next (_state.it, True) != 0) {
-
-      result = _state.it.get_hash_key ();
-   }
-
-   return result;
-}
+dmz::HandleContainer::get_prev () const { return get_prev (_it); }
 
 
 /*!
@@ -280,19 +465,7 @@ empty.
 
 */
 dmz::Handle
-dmz::HandleContainer::get_last () const {
-
-   Handle result (0);
-
-   _state.it.reset ();
-
-   if (_state.table.get_next (_state.it, True) != 0) {
-
-      result = _state.it.get_hash_key ();
-   }
-
-   return result;
-}
+dmz::HandleContainer::get_last () const { return get_last (_it); }
 
 
 /*!
@@ -306,13 +479,9 @@ empty.
 dmz::Handle
 dmz::HandleContainer::get_first (HandleContainerIterator &it) const {
 
-   Handle result (0);
-
-   it.state.it.reset ();
+   it.reset ();
 
-   if (_state.table.get_next (it.state.it) != 0) { result = it.state.it.get_hash_key (); }
-
-   return result;
+   return get_next (it);
 }
 
 
@@ -329,7 +498,7 @@ dmz::HandleContainer::get_next (HandleContainerIterator &it) const {
 
    Handle result (0);
 
-   if (_state.table.get_next (it.state.it) != 0) { result = it.state.it.get_hash_key (); }
+   get_next (it, result);
 
    return result;
 }
@@ -347,9 +516,11 @@ are no more Handles to return.
 dmz::Boolean
 dmz::HandleContainer::get_next (HandleContainerIterator &it, Handle &value) const {
 
-   value = 0;
+   const Int32 Found (
+      ((it.index >= 0) && ((it.index >= _count) || (_data[it.index].order != it.order))) ?
+         _find_order (it.order) : 0);
 
-   if (_state.table.get_next (it.state.it) != 0) { value = it.state.it.get_hash_key (); }
+   value = local_step (_data, _count, Found, it, False) ? _data[it.index].value : 0;
 
    return value != 0;
 }
@@ -368,10 +539,7 @@ dmz::HandleContainer::get_prev (HandleContainerIterator &it) const {
 
    Handle result (0);
 
-   if (_state.table.get_next (it.state.it, True) != 0) {
-
-      result = it.state.it.get_hash_key ();
-   }
+   get_prev (it, result);
 
    return result;
 }
@@ -389,12 +557,11 @@ are no more Handles to return.
 dmz::Boolean
 dmz::HandleContainer::get_prev (HandleContainerIterator &it, Handle &value) const {
 
-   value = 0;
-
-   if (_state.table.get_next (it.state.it, True) != 0) {
+   const Int32 Found (
+      ((it.index >= 0) && ((it.index >= _count) || (_data[it.index].order != it.order))) ?
+         _find_order (it.order) : 0);
 
-      value = it.state.it.get_hash_key ();
-   }
+   value = local_step (_data, _count, Found, it, True) ? _data[it.index].value : 0;
 
    return value != 0;
 }
@@ -411,15 +578,153 @@ empty.
 dmz::Handle
 dmz::HandleContainer::get_last (HandleContainerIterator &it) const {
 
-   Handle result (0);
+   it.reset ();
+
+   return get_prev (it);
+}
+
+
+/*!
+
+\brief Grows the storage so it can hold \a Size Handles.
+\details Storage grows geometrically once the inline storage is used up. The stored
+Handles are kept.
+\param[in] Size Number of Handles the container needs to hold.
+
+*/
+void
+dmz::HandleContainer::_reserve (const Int32 Size) {
+
+   if (Size > _capacity) {
 
-   it.state.it.reset ();
+      const Int32 Capacity ((Size > (_capacity * 2)) ? Size : (_capacity * 2));
+      Entry *data (new Entry[Capacity * 2]);
 
-   if (_state.table.get_next (it.state.it, True) != 0) {
+      if (_count > 0) {
 
-      result = it.state.it.get_hash_key ();
+         memcpy (data, _data, _count * sizeof (Entry));
+         memcpy (data + Capacity, _sorted, _count * sizeof (Entry));
+      }
+
+      if (_data != _local) { delete []_data; }
+
+      _data = data;
+      _sorted = data + Capacity;
+      _capacity = Capacity;
+   }
+}
+
+
+/*!
+
+\brief Adds an array of new entries to the container.
+\details The entries in \a added must have ascending insertion orders starting at
+_nextOrder. Entries that are already stored or that repeat an earlier entry are
+dropped. The rest are appended in insertion order and merged into the sorted array.
+\param[in] added Array of entries to add. The array is sorted in place.
+\param[in] Count Number of entries in \a added.
+\return Returns the number of Handles that were added.
+
+*/
+dmz::Int32
+dmz::HandleContainer::_append (Entry *added, const Int32 Count) {
+
+   qsort (added, Count, sizeof (Entry), local_compare_value);
+
+   Int32 result (0);
+
+   for (Int32 ix = 0; ix < Count; ix++) {
+
+      const Handle Value (added[ix].value);
+
+      if (((result == 0) || (added[result - 1].value != Value)) && !contains (Value)) {
+
+         added[result] = added[ix];
+         result++;
+      }
+   }
+
+   if (result > 0) {
+
+      _reserve (_count + result);
+
+      // Merge from the back so the sorted array can be built in place.
+      Int32 place (_count + result);
+      Int32 ix (_count - 1);
+      Int32 jy (result - 1);
+
+      while (jy >= 0) {
+
+         place--;
+
+         if ((ix >= 0) && (_sorted[ix].value > added[jy].value)) {
+
+            _sorted[place] = _sorted[ix];
+            ix--;
+         }
+         else { _sorted[place] = added[jy]; jy--; }
+      }
+
+      memcpy (_data + _count, added, result * sizeof (Entry));
+      qsort (_data + _count, result, sizeof (Entry), local_compare_order);
+
+      _count += result;
    }
 
+   _nextOrder += UInt64 (Count);
+
    return result;
 }
 
+
+/*!
+
+\brief Finds where a Handle is or would be stored in the sorted array.
+\param[in] Value Handle to find.
+\return Returns the index of the first sorted Handle that is not less than \a Value.
+
+*/
+dmz::Int32
+dmz::HandleContainer::_find (const Handle Value) const {
+
+   Int32 low (0);
+   Int32 high (_count);
+
+   // Handles are usually added in ascending order so check the end first.
+   if ((_count > 0) && (_sorted[_count - 1].value < Value)) { low = _count; }
+
+   while (low < high) {
+
+      const Int32 Middle ((low + high) >> 1);
+
+      if (_sorted[Middle].value < Value) { low = Middle + 1; }
+      else { high = Middle; }
+   }
+
+   return low;
+}
+
+
+/*!
+
+\brief Finds where an insertion order is or would be stored in the insertion array.
+\param[in] Order Insertion order to find.
+\return Returns the index of the first Handle that was not added before \a Order.
+
+*/
+dmz::Int32
+dmz::HandleContainer::_find_order (const UInt64 Order) const {
+
+   Int32 low (0);
+   Int32 high (_count);
+
+   while (low < high) {
+
+      const Int32 Middle ((low + high) >> 1);
+
+      if (_data[Middle].order < Order) { low = Middle + 1; }
+      else { high = Middle; }
+   }
+
+   return low;
+}
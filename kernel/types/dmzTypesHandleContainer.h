@@ -15,8 +15,8 @@ namespace dmz {
          void reset ();
 
          //! \cond
-         struct State;
-         State &state;
+         Int32 index;
+         UInt64 order;
          //! \endcond
 
       private:
@@ -36,6 +36,8 @@ namespace dmz {
          Boolean has_same_content (const HandleContainer &Container) const;
 
          HandleContainer &operator+= (const HandleContainer &Container);
+         HandleContainer &operator-= (const HandleContainer &Container);
+         HandleContainer &operator&= (const HandleContainer &Container);
 
          void clear ();
 
@@ -44,6 +46,7 @@ namespace dmz {
          Boolean contains (const Handle Value) const;
 
          Boolean add (const Handle Value);
+         Int32 add (const Handle *Values, const Int32 Count);
          Boolean remove (const Handle Value);
 
          Handle get_first () const;
@@ -58,11 +61,25 @@ namespace dmz {
          Boolean get_prev (HandleContainerIterator &it, Handle &value) const;
          Handle get_last (HandleContainerIterator &it) const;
 
-      protected:
          //! \cond
-         struct State;
-         State &_state;
+         struct Entry { Handle value; UInt64 order; };
          //! \endcond
+
+      protected:
+         //! Number of Handles stored inside the container.
+         enum { LocalSize = 4 };
+         void _reserve (const Int32 Size);
+         Int32 _append (Entry *added, const Int32 Count);
+         Int32 _find (const Handle Value) const;
+         Int32 _find_order (const UInt64 Order) const;
+
+         Entry *_data; //!< Handles in insertion order. Points to _local or the heap.
+         Entry *_sorted; //!< The same Handles sorted by value. Follows _data.
+         Int32 _count; //!< Number of Handles stored.
+         Int32 _capacity; //!< Number of Handles that fit in _data and in _sorted.
+         UInt64 _nextOrder; //!< Insertion order given to the next Handle added.
+         mutable HandleContainerIterator _it; //!< Iterator used by get_next ().
+         Entry _local[LocalSize * 2]; //!< Inline storage used for small containers.
    };
 };
 
@@ -2,65 +2,101 @@
 #include <dmzTypesHashTable$(type).h>
 #include <$(typeInclude)>
 
-static inline dmz::Int32
-local_hash (const dmz::UInt32 Value) {
+#include <string.h> // memcpy
+
+// The hash functions mix 64 bit words by multiplying them into a 128 bit product and
+// folding the two halves together in the style of wyhash. Every input bit affects the
+// result so keys with long common prefixes and sequential UUIDs are spread across
+// the table.
+
+static const dmz::UInt64 localSeed0 = (dmz::UInt64 (0xa0761d64) << 32) | 0x78bd642f;
+static const dmz::UInt64 localSeed1 = (dmz::UInt64 (0xe7037ed1) << 32) | 0xa0b428db;
+static const dmz::UInt64 localSeed2 = (dmz::UInt64 (0x8ebc6af0) << 32) | 0x9c88c6e3;
+
+static inline dmz::UInt64
+local_mix (const dmz::UInt64 Value1, const dmz::UInt64 Value2) {
+
+   const dmz::UInt64 A (Value1 ^ localSeed0);
+   const dmz::UInt64 B (Value2 ^ localSeed1);
+
+#if defined (__SIZEOF_INT128__)
+   const unsigned __int128 Product ((unsigned __int128)A * B);
+   return dmz::UInt64 (Product) ^ dmz::UInt64 (Product >> 64);
+#else
+   const dmz::UInt64 ALow (A & 0xffffffff), AHigh (A >> 32);
+   const dmz::UInt64 BLow (B & 0xffffffff), BHigh (B >> 32);
+   const dmz::UInt64 LowLow (ALow * BLow), LowHigh (ALow * BHigh);
+   const dmz::UInt64 HighLow (AHigh * BLow), HighHigh (AHigh * BHigh);
+   const dmz::UInt64 Middle ((LowLow >> 32) + (LowHigh & 0xffffffff) + HighLow);
+   const dmz::UInt64 Low ((Middle << 32) | (LowLow & 0xffffffff));
+   const dmz::UInt64 High (HighHigh + (LowHigh >> 32) + (Middle >> 32));
+   return Low ^ High;
+#endif
+}
 
-   dmz::Int32 result (Value);
-   if (result < 0) { result = -result; }
-   return result;
+
+static inline dmz::UInt32
+local_finalize (const dmz::UInt64 Value, const dmz::Int32 Length) {
+
+   return dmz::UInt32 (local_mix (Value ^ dmz::UInt64 (Length), localSeed2));
 }
 
 
-static inline dmz::Int32
-local_hash (const dmz::UInt64 Value) {
+static inline dmz::UInt32
+local_hash (const dmz::UInt32 Value) {
 
-   dmz::UInt32 *ptr = (dmz::UInt32 *)&Value;
-   dmz::Int32 result = (dmz::Int32)ptr[0] ^ ptr[1];
-   if (result < 0) { result = -result; }
-   return result;
+   // Handles are allocated sequentially so the value is already evenly distributed
+   // across the table.
+   return Value;
 }
 
 
+static inline dmz::UInt32
+local_hash (const dmz::UInt64 Value) { return local_finalize (Value, 8); }
+
+
 #ifdef DMZ_TYPES_STRING_DOT_H
-static inline dmz::Int32
+static inline dmz::UInt32
 local_hash (const dmz::String &Value) {
 
-   dmz::Int32 result (0);
    dmz::Int32 len (0);
    const char *buf = Value.get_buffer (len);
 
-   result = (5 * len);
+   dmz::UInt64 result (localSeed2);
+   dmz::Int32 place (0);
 
-   for (dmz::Int32 ix = 0; ix < len; ix++) {
+   while ((len - place) >= 16) {
 
-      result = ((result << 1) + dmz::Int32 (buf[ix]));
+      dmz::UInt64 word[2];
+      memcpy (word, &(buf[place]), 16);
+      result = local_mix (word[0] ^ result, word[1]);
+      place += 16;
    }
 
-   if (result < 0) { result = -result; }
+   if (place < len) {
 
-   return result;
+      dmz::UInt64 word[2] = { 0, 0 };
+      memcpy (word, &(buf[place]), len - place);
+      result = local_mix (word[0] ^ result, word[1]);
+   }
+
+   return local_finalize (result, len);
 }
 #endif
 
 
 #ifdef DMZ_TYPES_UUID_DOT_H
-static inline dmz::Int32
+static inline dmz::UInt32
 local_hash (const dmz::UUID &Value) {
 
-   dmz::Int32 result (0);
-
    dmz::UInt8 array[16];
 
    Value.to_array (array);
 
-   for (dmz::Int32 ix = 0; ix < 16; ix++) {
-
-      result = ((result << 2) + dmz::Int32 (array[ix]));
-   }
-
-   if (result < 0) { result = -result; }
+   dmz::UInt64 word[2];
+   memcpy (word, array, 16);
 
-   return result;
+   return local_finalize (local_mix (word[0], word[1]), 16);
 }
 #endif
 
@@ -160,6 +196,7 @@ struct dmz::HashTable$(type)::State {
    UInt32 growCount;
    Int32 size;
    Int32 count;
+   Int32 removed;
    Boolean autoGrow;
    DataStruct *table;
    DataStruct *head;
@@ -169,6 +206,7 @@ struct dmz::HashTable$(type)::State {
       growCount (0),
       size (0),
       count (0),
+      removed (0),
       autoGrow (True),
       table (0),
       head (0),
@@ -211,10 +249,54 @@ struct dmz::HashTable$(type)::State {
       }
 
       count = 0;
+      removed = 0;
 
       head = tail = 0;
    }
 
+   // Stores the elements in a new table of the same size. This drops the marks left
+   // behind by removed elements that would otherwise lengthen every probe. Iterators
+   // resolve their key again after the grow count changes.
+   void rehash () {
+
+      DataStruct *oldTable (table);
+      DataStruct *cur (head);
+
+      growCount++;
+      table = new DataStruct[size];
+      head = tail = 0;
+      removed = 0;
+
+      while (cur) {
+
+         Int32 index = local_hash (cur->key) % size;
+
+         while (table[index].dirty) { index++; if (index >= size) { index = 0; } }
+
+         DataStruct &el = table[index];
+         el.key = cur->key;
+         el.data = cur->data;
+         el.dirty = True;
+         el.prev = tail;
+
+         if (tail) { tail->next = &el; }
+         else { head = &el; }
+
+         tail = &el;
+         cur = cur->next;
+      }
+
+      delete []oldTable; oldTable = 0;
+   }
+
+   // Removed marks are only cleared when they end a probe run. A run of marks in front
+   // of live keys makes every store into it scan the whole run, so the table is rehashed
+   // once an eighth of the slots hold marks instead of waiting for the table to fill.
+   Boolean should_rehash () const {
+
+      return ((count + removed + 1) > size) || (removed > (size >> 3));
+   }
+
    Int32 find_ptr_index (DataStruct *data) const {
 
       return Int32 (data - table);
@@ -267,6 +349,21 @@ dmz::Int32
 dmz::HashTable$(type)::get_count () const { return _state.count; }
 
 
+//! Gets the hash value used to place \a Key in the table.
+dmz::UInt32
+dmz::HashTable$(type)::hash (const $(type) &Key) { return local_hash (Key); }
+
+
+//! Gets the number of slots that still hold the mark of a removed element.
+dmz::Int32
+dmz::HashTable$(type)::get_removed_count () const { return _state.removed; }
+
+
+//! Gets the number of times the elements have been moved to a new table.
+dmz::UInt32
+dmz::HashTable$(type)::get_grow_count () const { return _state.growCount; }
+
+
 //! Moves an element in the list.
 dmz::Boolean
 dmz::HashTable$(type)::move (
@@ -412,6 +509,7 @@ dmz::HashTable$(type)::store (const $(type) &Key, void *data) {
    if (data) {
 
       if ((_state.count + 1) > _state.size) { grow (); }
+      else if (_state.should_rehash ()) { _state.rehash (); }
 
       if (_state.size >= (_state.count + 1)) {
 
@@ -447,6 +545,8 @@ dmz::HashTable$(type)::store (const $(type) &Key, void *data) {
             result = True;
             _state.count++;
 
+            if (_state.table[foundIndex].dirty) { _state.removed--; }
+
             _state.table[foundIndex].prev = 0;
             _state.table[foundIndex].next = 0;
             _state.table[foundIndex].key = Key;
@@ -490,6 +590,20 @@ dmz::HashTable$(type)::remove (const $(type) &Key) {
       else { _state.tail = el.prev; }
 
       _state.count--;
+      _state.removed++;
+
+      // The mark is only needed while a later element in the same probe run follows it.
+      Int32 current (index);
+      const Int32 Next ((index + 1) < _state.size ? index + 1 : 0);
+
+      while (!_state.table[Next].dirty && _state.table[current].dirty &&
+            !_state.table[current].data) {
+
+         _state.table[current].dirty = False;
+         _state.removed--;
+         current--;
+         if (current < 0) { current = _state.size - 1; }
+      }
    }
 
    return data;
@@ -529,10 +643,12 @@ dmz::HashTable$(type)::grow (const Int32 Size) {
 
       const Int32 OldSize (_state.size);
       const Int32 OldCount (_state.count);
+      const Int32 OldRemoved (_state.removed);
       DataStruct *table (_state.table);
 
       _state.size = 0;
       _state.count = 0;
+      _state.removed = 0;
       _state.table = new DataStruct[newSize];
 
       if (table && _state.table) {
@@ -556,6 +672,7 @@ dmz::HashTable$(type)::grow (const Int32 Size) {
          _state.table = table;
          _state.size = OldSize;
          _state.count = OldCount;
+         _state.removed = OldRemoved;
       }
    }
 }
@@ -568,6 +685,7 @@ dmz::HashTable$(type)::set_table_size (const Int32 Size) {
    if (_state.table) { delete []_state.table; _state.table = 0; }
    _state.size = 0;
    _state.count = 0;
+   _state.removed = 0;
    _state.head = _state.tail = 0;
 
    if (Size) {
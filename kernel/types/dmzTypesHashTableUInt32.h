@@ -46,6 +46,9 @@ namespace dmz {
          void * remove (const UInt32 &Key);
 
          // For internal use
+         static UInt32 hash (const UInt32 &Key);
+         Int32 get_removed_count () const;
+         UInt32 get_grow_count () const;
          void grow (const Int32 Size = 0);
          void set_table_size (const Int32 Size);
          void set_attributes (const UInt32 Attributes);
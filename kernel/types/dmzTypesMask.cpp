@@ -2,6 +2,11 @@
 #include <stdlib.h>
 #include <string.h>
 
+#if defined (_MSC_VER)
+#   include <intrin.h>
+#   pragma intrinsic (_BitScanForward)
+#endif
+
 /*!
 
 \class dmz::Mask
@@ -11,52 +16,54 @@
 or 64 bit flags as with typical bit masks that use unsigned integers, a dmz::Mask
 is able to accommodate as may bit flags as memory will allow. The dmz::Mask supports
 most typical bitwise operations.
+
+The first 128 bits are stored inside the dmz::Mask so masks of that size do not
+allocate. Larger masks are stored in a heap buffer.
 \htmlonly Lua bindings are <a href="dmzlua.html#dmz.mask">available</a>.
 \endhtmlonly
 */
 
-struct dmz::Mask::State {
-
-   Int32 size;
-   UInt32 *mask;
-   State () : size (0), mask (0) {;}
-   ~State () { empty (); }
-   void empty () { if (mask) { delete []mask; mask = 0; size = 0; } }
-   void clear () { if (mask) { memset (mask, '\0', size * sizeof (UInt32)); } }
+namespace {
 
-   void grow_buffer (const Int32 Size) {
+static inline dmz::Int32
+local_bit_count (const dmz::UInt32 Value) {
 
-      if ((Size >= 0) && (Size > size)) {
-
-         empty ();
-         mask = new UInt32[Size];
-         if (mask) { size = Size; clear (); }
-      }
-      else { clear (); }
-   }
+#if defined (__GNUC__)
+   return dmz::Int32 (__builtin_popcount (Value));
+#else
+   dmz::UInt32 value (Value - ((Value >> 1) & 0x55555555));
+   value = (value & 0x33333333) + ((value >> 2) & 0x33333333);
+   return dmz::Int32 ((((value + (value >> 4)) & 0x0F0F0F0F) * 0x01010101) >> 24);
+#endif
+}
 
-   void resize (const Int32 Size) {
 
-      if (!mask) { grow_buffer (Size); }
-      else if (Size > size) {
+//! Value must not be zero.
+static inline dmz::Int32
+local_first_bit (const dmz::UInt32 Value) {
 
-         const Int32 OldSize (size);
-         UInt32 *oldMask (mask);
+#if defined (__GNUC__)
+   return dmz::Int32 (__builtin_ctz (Value));
+#elif defined (_MSC_VER)
+   unsigned long result (0);
+   _BitScanForward (&result, Value);
+   return dmz::Int32 (result);
+#else
+   dmz::Int32 result (0);
+   while (!(Value & (dmz::UInt32 (0x01) << result))) { result++; }
+   return result;
+#endif
+}
 
-         mask = new UInt32[Size];
 
-         if (mask) {
+static inline dmz::Int32
+local_last_block (const dmz::UInt32 *Mask, const dmz::Int32 Size) {
 
-            size = Size;
-            clear ();
+   dmz::Int32 result (Size - 1);
+   while ((result >= 0) && !Mask[result]) { result--; }
+   return result;
+}
 
-            memcpy (mask, oldMask, OldSize * sizeof (UInt32));
-            delete []oldMask; oldMask = 0;
-         }
-         else { mask = oldMask; }
-      }
-      else {;} // do nothing
-   }
 };
 
 
@@ -66,11 +73,17 @@ struct dmz::Mask::State {
 \details No initial storage is allocated.
 
 */
-dmz::Mask::Mask () : _state (*(new State)) {;}
+dmz::Mask::Mask () : _mask (_local), _size (0), _capacity (LocalSize) {;}
 
 
 //! Copy constructor.
-dmz::Mask::Mask (const Mask &Value) : _state (*(new State)) { *this = Value; }
+dmz::Mask::Mask (const Mask &Value) :
+      _mask (_local),
+      _size (0),
+      _capacity (LocalSize) {
+
+   *this = Value;
+}
 
 
 /*!
@@ -81,7 +94,7 @@ number of bits specified by \a Shift.
 \param[in] Shift Number of bits to shift single bit in mask.
 
 */
-dmz::Mask::Mask (const Int32 Shift) : _state (*(new State)) {
+dmz::Mask::Mask (const Int32 Shift) : _mask (_local), _size (0), _capacity (LocalSize) {
 
    if (Shift >= 0) { set_sub_mask (0, 0x01); *this << Shift; }
 }
@@ -96,14 +109,17 @@ the number of bits specified by \a Shift.
 \param[in] Value 32 bit mask to be shifted.
 
 */
-dmz::Mask::Mask (const Int32 Shift, const UInt32 Value) : _state (*(new State)) {
+dmz::Mask::Mask (const Int32 Shift, const UInt32 Value) :
+      _mask (_local),
+      _size (0),
+      _capacity (LocalSize) {
 
    if (Shift >= 0) { set_sub_mask (0, Value); *this << Shift; }
 }
 
 
 //! Destructor. Deletes all allocated storage.
-dmz::Mask::~Mask () { delete &_state; }
+dmz::Mask::~Mask () { _release (); }
 
 
 /*!
@@ -119,22 +135,18 @@ considered equal.
 dmz::Boolean
 dmz::Mask::operator== (const Mask &Value) const {
 
-   const Int32 MaxSize =
-      (_state.size > Value._state.size) ? _state.size : Value._state.size;
+   const Int32 MinSize ((_size < Value._size) ? _size : Value._size);
 
-   Boolean done (False);
-   Boolean result (True);
-   Int32 count (0);
+   Boolean result (memcmp (_mask, Value._mask, MinSize * sizeof (UInt32)) == 0);
 
-   while (!done) {
+   for (Int32 ix = MinSize; result && (ix < _size); ix++) {
 
-      if (((count < _state.size) ? _state.mask[count] : 0) !=
-            ((count < Value._state.size) ? Value._state.mask[count] : 0)) {
+      if (_mask[ix]) { result = False; }
+   }
 
-         done = True;
-         result = False;
-      }
-      else { count++; if (count >= MaxSize) { done = True; } }
+   for (Int32 ix = MinSize; result && (ix < Value._size); ix++) {
+
+      if (Value._mask[ix]) { result = False; }
    }
 
    return result;
@@ -150,28 +162,7 @@ not the other.
 
 */
 dmz::Boolean
-dmz::Mask::operator!= (const Mask &Value) const {
-
-   const Int32 MaxSize =
-      (_state.size > Value._state.size) ? _state.size : Value._state.size;
-
-   Boolean done (False);
-   Boolean result (False);
-   Int32 count (0);
-
-   while (!done) {
-
-      if (((count < _state.size) ? _state.mask[count] : 0) !=
-            ((count < Value._state.size) ? Value._state.mask[count] : 0)) {
-
-         done = True;
-         result = True;
-      }
-      else { count++; if (count >= MaxSize) { done = True; } }
-   }
-
-   return result;
-}
+dmz::Mask::operator!= (const Mask &Value) const { return !(*this == Value); }
 
 
 /*!
@@ -185,14 +176,10 @@ dmz::Mask::operator!= (const Mask &Value) const {
 dmz::Mask &
 dmz::Mask::operator= (const Mask &Value) {
 
-   _state.grow_buffer (Value._state.size);
-
-   if (_state.mask && Value._state.mask) {
+   if (&Value != this) {
 
-      const Int32 MinSize (
-         (_state.size > Value._state.size) ? Value._state.size : _state.size);
-
-      memcpy (_state.mask, Value._state.mask, MinSize * sizeof (UInt32));
+      _reserve (Value._size, False);
+      memcpy (_mask, Value._mask, Value._size * sizeof (UInt32));
    }
 
    return *this;
@@ -207,20 +194,7 @@ storage has a bit set.
 
 */
 dmz::Boolean
-dmz::Mask::operator! () const {
-
-   Boolean result (True);
-   Int32 count (0);
-   Boolean done ((_state.size > 0) ? False : True);
-
-   while (!done) {
-
-      if (_state.mask[count]) { done = True; result = False; }
-      else { count++; if(count >= _state.size) { done = True; } }
-   }
-
-   return result;
-}
+dmz::Mask::operator! () const { return !is_set (); }
 
 
 /*!
@@ -234,13 +208,8 @@ dmz::Mask
 dmz::Mask::operator~ () const {
 
    Mask result (*this);
-   UInt32 *mask = result._state.mask;
 
-   if (mask) {
-
-      const Int32 Size = result._state.size;
-      for (Int32 ix = 0; ix < Size; ix++) { mask[ix] = ~mask[ix]; }
-   }
+   for (Int32 ix = 0; ix < result._size; ix++) { result._mask[ix] = ~result._mask[ix]; }
 
    return result;
 }
@@ -256,32 +225,12 @@ dmz::Mask::operator~ () const {
 dmz::Mask &
 dmz::Mask::operator^= (const Mask &Value) {
 
-   if (Value._state.mask) {
-
-      const Int32 ValueSize (Value._state.size);
-      const UInt32 *ValueMask (Value._state.mask);
-      UInt32 *oldMask (_state.mask);
-      const Int32 OldSize (_state.size);
-      const Int32 Size = (ValueSize > OldSize) ? ValueSize : OldSize;
-
-      if (ValueSize > OldSize) {
-
-         _state.mask = 0;
-         _state.size = 0;
-         _state.grow_buffer (ValueSize);
-      }
-
-      if (_state.mask) {
+   if (Value._size > 0) {
 
-         for (Int32 ix = 0; ix < Size; ix++) {
+      _reserve (Value._size, True);
 
-            _state.mask[ix] =
-               ((OldSize > ix) ? oldMask[ix] : 0) ^
-                  ((ValueSize > ix) ? ValueMask[ix] : 0);
-         }
-      }
-
-      if (_state.mask != oldMask) { delete []oldMask; }
+      const UInt32 *ValueMask (Value._mask);
+      for (Int32 ix = 0; ix < Value._size; ix++) { _mask[ix] ^= ValueMask[ix]; }
    }
 
    return *this;
@@ -314,13 +263,12 @@ dmz::Mask::operator^ (const Mask &Value) const {
 dmz::Mask &
 dmz::Mask::operator&= (const Mask &Value) {
 
-   const Int32 Size (_state.size);
-   const Int32 ValueSize (Value._state.size);
-   const UInt32 *ValueMask = Value._state.mask;
+   const Int32 ValueSize (Value._size);
+   const UInt32 *ValueMask (Value._mask);
 
-   for (Int32 ix = 0; ix < Size; ix++) {
+   for (Int32 ix = 0; ix < _size; ix++) {
 
-      _state.mask[ix] &= (ValueSize > ix) ? ValueMask[ix] : 0;
+      _mask[ix] &= (ValueSize > ix) ? ValueMask[ix] : 0;
    }
 
    return *this;
@@ -353,32 +301,12 @@ dmz::Mask::operator& (const Mask &Value) const {
 dmz::Mask &
 dmz::Mask::operator|= (const Mask &Value) {
 
-   if (Value._state.mask) {
+   if (Value._size > 0) {
 
-      const Int32 ValueSize (Value._state.size);
-      const UInt32 *ValueMask (Value._state.mask);
-      UInt32 *oldMask (_state.mask);
-      const Int32 OldSize (_state.size);
-      const Int32 Size = (ValueSize > OldSize) ? ValueSize : OldSize;
+      _reserve (Value._size, True);
 
-      if (ValueSize > OldSize) {
-
-         _state.mask = 0;
-         _state.size = 0;
-         _state.grow_buffer (ValueSize);
-      }
-
-      if (_state.mask) {
-
-         for (Int32 ix = 0; ix < Size; ix++) {
-
-            _state.mask[ix] =
-               ((OldSize > ix) ? oldMask[ix] : 0) |
-                  ((ValueSize > ix) ? ValueMask[ix] : 0);
-         }
-      }
-
-      if (_state.mask != oldMask) { delete []oldMask; }
+      const UInt32 *ValueMask (Value._mask);
+      for (Int32 ix = 0; ix < Value._size; ix++) { _mask[ix] |= ValueMask[ix]; }
    }
 
    return *this;
@@ -404,6 +332,7 @@ dmz::Mask::operator| (const Mask &Value) const {
 /*!
 
 \brief Bitwise left shift operator.
+\details The storage is resized to hold the highest set bit after the shift.
 \param[in] Shift Number of bits the mask is shifted to the left.
 \return Returns a reference to self.
 
@@ -411,48 +340,39 @@ dmz::Mask::operator| (const Mask &Value) const {
 dmz::Mask &
 dmz::Mask::operator<< (const Int32 Shift) {
 
-   if ((Shift > 0) && (_state.size >= 1)) {
-
-      Boolean done (False);
-      Int32 place (_state.size - 1);
-      Int32 found (-1);
-
-      while (!done) {
-
-         if (_state.mask[place]) { found = place; done = True; }
-         else { place--; if (place < 0) { done = True; } }
-      }
+   const Int32 Found ((Shift > 0) ? local_last_block (_mask, _size) : -1);
 
-      if (found >= 0) {
+   if (Found >= 0) {
 
-         const Int32 Offset (Shift / 32);
-         const Int32 ElementShift (Shift % 32);
-         const Int32 OverflowShift (32 - ElementShift);
-         const UInt32 OverflowMask (0xffffffff << (OverflowShift));
-         const UInt32 OverflowSize (_state.mask[found] & OverflowMask ? 1 : 0);
-         const Int32 NewSize (OverflowSize + found + Offset + 1);
-         UInt32 *newMask (new UInt32[NewSize]);
+      const Int32 Offset (Shift / 32);
+      const Int32 ElementShift (Shift % 32);
+      const Int32 OverflowShift (32 - ElementShift);
+      const Int32 OverflowSize (
+         (ElementShift && (_mask[Found] >> OverflowShift)) ? 1 : 0);
+      const Int32 NewSize (OverflowSize + Found + Offset + 1);
 
-         if (newMask) {
+      _reserve (NewSize, True);
 
-            memset (newMask, '\0', NewSize * sizeof (UInt32));
+      // Blocks are moved from the top down so the shift can be done in place.
+      for (Int32 ix = NewSize - 1; ix >= 0; ix--) {
 
-            UInt32 prevOverflow (0);
+         const Int32 Source (ix - Offset);
+         UInt32 value (0);
 
-            for (Int32 ix = 0; ix <= found; ix++) {
+         if ((Source >= 0) && (Source <= Found)) {
 
-               const UInt32 Value (_state.mask[ix] << ElementShift);
-               newMask[ix + Offset] = Value | prevOverflow;
-               prevOverflow = (_state.mask[ix] & OverflowMask) >> OverflowShift;
-            }
+            value = _mask[Source] << ElementShift;
+         }
 
-            if (prevOverflow) { newMask[found + Offset + 1] = prevOverflow; }
+         if (ElementShift && (Source > 0) && (Source <= (Found + 1))) {
 
-            _state.size = NewSize;
-            delete []_state.mask; _state.mask = 0;
-            _state.mask = newMask;
+            value |= _mask[Source - 1] >> OverflowShift;
          }
+
+         _mask[ix] = value;
       }
+
+      _size = NewSize;
    }
 
    return *this;
@@ -470,54 +390,36 @@ dmz::Mask::operator<< (const Int32 Shift) {
 dmz::Mask &
 dmz::Mask::operator>> (const Int32 Shift) {
 
-   if ((Shift > 0) && (_state.size >= 1)) {
-
-      Boolean done (False);
-      Int32 place (_state.size - 1);
-      Int32 found (-1);
-
-      while (!done) {
-
-         if (_state.mask[place]) { found = place; done = True; }
-         else { place--; if (place < 0) { done = True; } }
-      }
-
-      if (found >= 0) {
-
-         const Int32 Offset (Shift / 32);
-         const Int32 ElementShift (Shift % 32);
-         const Int32 OverflowShift (32 - ElementShift);
-         const UInt32 OverflowMask (0xffffffff >> (OverflowShift));
-         const Int32 NewSize (found + 1 + (-Offset));
-
-         if (NewSize > 0) {
+   const Int32 Found ((Shift > 0) ? local_last_block (_mask, _size) : -1);
 
-            UInt32 *newMask (new UInt32[NewSize]);
+   if (Found >= 0) {
 
-            if (newMask) {
+      const Int32 Offset (Shift / 32);
+      const Int32 ElementShift (Shift % 32);
+      const Int32 OverflowShift (32 - ElementShift);
+      const Int32 NewSize (Found + 1 - Offset);
 
-               memset (newMask, '\0', NewSize * sizeof (UInt32));
+      if (NewSize > 0) {
 
-               UInt32 prevOverflow (0);
+         // Blocks are moved from the bottom up so the shift can be done in place.
+         for (Int32 ix = 0; ix < NewSize; ix++) {
 
-               for (Int32 ix = (NewSize - 1); ix >= 0; ix--) {
+            const Int32 Source (ix + Offset);
+            UInt32 value (_mask[Source] >> ElementShift);
 
-                  const UInt32 Value (_state.mask[ix + Offset] >> ElementShift);
-                  newMask[ix] = Value | prevOverflow;
-                  prevOverflow =
-                     (_state.mask[ix + Offset] & OverflowMask) << OverflowShift;
-               }
+            if (ElementShift && (Source < Found)) {
 
-               _state.size = NewSize;
-               delete []_state.mask; _state.mask = 0;
-               _state.mask = newMask;
+               value |= _mask[Source + 1] << OverflowShift;
             }
+
+            _mask[ix] = value;
          }
-         else { memset (_state.mask, '\0', _state.size * sizeof (UInt32)); }
+
+         _size = NewSize;
       }
+      else { clear (); }
    }
 
-
    return *this;
 }
 
@@ -536,12 +438,9 @@ size of the dmz::Mask, the call is ignored. The internal storage is allocated in
 dmz::Boolean
 dmz::Mask::grow (const Int32 Size) {
 
-   Boolean result (False);
-
-   if (Size > _state.size) { _state.resize (Size); result = (Size <= _state.size); }
-   else { result = True; }
+   _reserve (Size, True);
 
-   return result;
+   return Size <= _size;
 }
 
 
@@ -552,7 +451,7 @@ dmz::Mask::grow (const Int32 Size) {
 
 */
 dmz::Int32
-dmz::Mask::get_size () const { return _state.size; }
+dmz::Mask::get_size () const { return _size; }
 
 
 /*!
@@ -571,11 +470,10 @@ dmz::Mask::set_sub_mask (const Int32 Offset, const UInt32 Value) {
 
    Boolean result (False);
 
-   _state.resize (Offset + 1);
-
-   if (_state.mask && (Offset < _state.size)) {
+   if (Offset >= 0) {
 
-      _state.mask[Offset] = Value;
+      _reserve (Offset + 1, True);
+      _mask[Offset] = Value;
       result = True;
    }
 
@@ -594,7 +492,7 @@ dmz::Mask::set_sub_mask (const Int32 Offset, const UInt32 Value) {
 dmz::UInt32
 dmz::Mask::get_sub_mask (const Int32 Offset) const {
 
-   return (_state.mask && (Offset < _state.size)) ? _state.mask[Offset] : 0;
+   return ((Offset >= 0) && (Offset < _size)) ? _mask[Offset] : 0;
 }
 
 
@@ -605,7 +503,7 @@ dmz::Mask::get_sub_mask (const Int32 Offset) const {
 
 */
 dmz::Mask &
-dmz::Mask::empty () { _state.empty (); return *this; }
+dmz::Mask::empty () { _release (); _size = 0; return *this; }
 
 
 /*!
@@ -617,7 +515,7 @@ storage.
 
 */
 dmz::Mask &
-dmz::Mask::clear () { _state.clear (); return *this; }
+dmz::Mask::clear () { memset (_mask, '\0', _size * sizeof (UInt32)); return *this; }
 
 
 /*!
@@ -627,24 +525,7 @@ dmz::Mask::clear () { _state.clear (); return *this; }
 
 */
 dmz::Boolean
-dmz::Mask::is_set () const {
-
-   Boolean result (False);
-
-   if (_state.mask) {
-
-      Boolean done (False);
-      Int32 count (0);
-
-      while (!done) {
-
-         if (_state.mask[count]) { result = True; done = True; }
-         else { count++; if (count >= _state.size) { done = True; } }
-      }
-   }
-
-   return result;
-}
+dmz::Mask::is_set () const { return local_last_block (_mask, _size) >= 0; }
 
 
 /*!
@@ -659,12 +540,13 @@ to accommodate the new bit.
 dmz::Mask &
 dmz::Mask::set_bit (const Int32 Bit) {
 
-   const div_t Result = div (int (Bit), 32);
-   Int32 Place (Result.quot);
-   Int32 Shift (Result.rem);
+   if (Bit >= 0) {
 
-   _state.resize (Place + 1);
-   if (_state.mask && (Place < _state.size)) { _state.mask[Place] |= 0x1 << Shift; }
+      const Int32 Place (Bit >> 5);
+
+      _reserve (Place + 1, True);
+      _mask[Place] |= UInt32 (0x01) << (Bit & 0x1F);
+   }
 
    return *this;
 }
@@ -680,11 +562,12 @@ dmz::Mask::set_bit (const Int32 Bit) {
 dmz::Mask &
 dmz::Mask::unset_bit (const Int32 Bit) {
 
-   const div_t Result = div (int (Bit), 32);
-   Int32 Place (Result.quot);
-   Int32 Shift (Result.rem);
+   const Int32 Place (Bit >> 5);
 
-   if (_state.mask && (Place < _state.size)) { _state.mask[Place] &= ~(0x1 << Shift); }
+   if ((Bit >= 0) && (Place < _size)) {
+
+      _mask[Place] &= ~(UInt32 (0x01) << (Bit & 0x1F));
+   }
 
    return *this;
 }
@@ -699,22 +582,15 @@ dmz::Mask::unset_bit (const Int32 Bit) {
 dmz::Boolean
 dmz::Mask::get_bit (const Int32 Bit) const {
 
-   Boolean result (False);
-   const div_t Result = div (int (Bit), 32);
-   Int32 Place (Result.quot);
-   Int32 Shift (Result.rem);
-
-   if (_state.mask && (Place < _state.size)) {
-
-      if (_state.mask[Place] & (0x01 << Shift)) { result = True; }
-   }
+   const Int32 Place (Bit >> 5);
 
-   return result;
+   return (Bit >= 0) && (Place < _size) &&
+      (_mask[Place] & (UInt32 (0x01) << (Bit & 0x1F)));
 }
 
+
 /*!
 
-\fn dmz::Mask::contains (const Mask &Value) const
 \brief Determines if the passed in mask is contained with in the mask.
 \details This function test if the passed in mask \a Value is contained with in the mask
 storage.
@@ -722,6 +598,21 @@ storage.
 \return Returns dmz::True if the passed in mask is contained in the mask storage.
 
 */
+dmz::Boolean
+dmz::Mask::contains (const Mask &Value) const {
+
+   Boolean result (True);
+
+   for (Int32 ix = 0; result && (ix < Value._size); ix++) {
+
+      const UInt32 Bits (Value._mask[ix]);
+
+      if (Bits && ((ix >= _size) || ((_mask[ix] & Bits) != Bits))) { result = False; }
+   }
+
+   return result;
+}
+
 
 /*!
 
@@ -733,15 +624,119 @@ storage.
 dmz::Mask &
 dmz::Mask::unset (const Mask &Value) {
 
-   const Int32 Size (_state.size);
-   const Int32 ValueSize (Value._state.size);
-   const UInt32 *Mask = Value._state.mask;
+   const Int32 Size ((_size < Value._size) ? _size : Value._size);
+   const UInt32 *ValueMask (Value._mask);
+
+   for (Int32 ix = 0; ix < Size; ix++) { _mask[ix] &= ~(ValueMask[ix]); }
 
-   for (Int32 ix = 0; ix < Size; ix++) {
+   return *this;
+}
 
-      _state.mask[ix] &= (ValueSize > ix) ? ~(Mask[ix]) : 0xFFFFFFFF;
+
+/*!
+
+\brief Counts the bits that are set in the mask.
+\return Returns the number of bits set in the mask.
+
+*/
+dmz::Int32
+dmz::Mask::get_bit_count () const {
+
+   Int32 result (0);
+
+   for (Int32 ix = 0; ix < _size; ix++) { result += local_bit_count (_mask[ix]); }
+
+   return result;
+}
+
+
+/*!
+
+\brief Finds the next bit that is set in the mask.
+\details The bits set in a mask may be iterated with:
+\code
+dmz::Int32 bit (mask.get_next_bit (0));
+
+while (bit >= 0) {
+
+   // Use bit.
+   bit = mask.get_next_bit (bit + 1);
+}
+\endcode
+\param[in] Bit First bit to test.
+\return Returns the first bit that is set starting at \a Bit. Returns -1 if no bits are
+set at or after \a Bit.
+
+*/
+dmz::Int32
+dmz::Mask::get_next_bit (const Int32 Bit) const {
+
+   Int32 result (-1);
+
+   Int32 place ((Bit > 0) ? (Bit >> 5) : 0);
+   UInt32 value (0);
+
+   if (place < _size) {
+
+      value = _mask[place];
+      if (Bit > 0) { value &= 0xFFFFFFFF << (Bit & 0x1F); }
    }
 
-   return *this;
+   while (!value && (place < _size)) {
+
+      place++;
+      if (place < _size) { value = _mask[place]; }
+   }
+
+   if (value) { result = (place << 5) + local_first_bit (value); }
+
+   return result;
 }
 
+
+/*!
+
+\brief Resizes the mask storage.
+\details The storage is grown geometrically once the inline storage is used up. Blocks
+that are added to the mask are set to zero.
+\param[in] Size Number of 32 bit blocks required.
+\param[in] Keep If dmz::True the current value of the mask is kept. Otherwise all
+blocks in the mask are cleared.
+
+*/
+void
+dmz::Mask::_reserve (const Int32 Size, const Boolean Keep) {
+
+   const Int32 Start (Keep ? _size : 0);
+   const Int32 NewSize ((Size > _size) ? Size : _size);
+
+   if (NewSize > _capacity) {
+
+      const Int32 Capacity ((NewSize > (_capacity * 2)) ? NewSize : (_capacity * 2));
+      UInt32 *mask (new UInt32[Capacity]);
+
+      if (Keep && (_size > 0)) { memcpy (mask, _mask, _size * sizeof (UInt32)); }
+
+      _release ();
+      _mask = mask;
+      _capacity = Capacity;
+   }
+
+   if (NewSize > Start) {
+
+      memset (_mask + Start, '\0', (NewSize - Start) * sizeof (UInt32));
+   }
+
+   _size = NewSize;
+}
+
+
+//! Releases heap storage and returns to the inline storage.
+void
+dmz::Mask::_release () {
+
+   if (_mask != _local) { delete []_mask; }
+
+   _mask = _local;
+   _capacity = LocalSize;
+}
@@ -43,12 +43,21 @@ namespace dmz {
          Mask &set_bit (const Int32 Bit);
          Mask &unset_bit (const Int32 Bit);
          Boolean get_bit (const Int32 Bit) const;
-         Boolean contains (const Mask &Value) const { return (*this & Value) == Value; }
+         Boolean contains (const Mask &Value) const;
          Mask &unset (const Mask &Value);
+         Int32 get_bit_count () const;
+         Int32 get_next_bit (const Int32 Bit) const;
 
       protected:
-         struct State;
-         State &_state; //!< Internal state.
+         //! Number of 32 bit blocks stored inside the Mask.
+         enum { LocalSize = 4 };
+         void _reserve (const Int32 Size, const Boolean Keep);
+         void _release ();
+
+         UInt32 *_mask; //!< Mask storage. Points to either _local or a heap buffer.
+         Int32 _size; //!< Number of 32 bit blocks in use.
+         Int32 _capacity; //!< Number of 32 bit blocks in _mask.
+         UInt32 _local[LocalSize]; //!< Inline storage used for small masks.
    };
 };
 
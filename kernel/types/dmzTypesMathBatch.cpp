@@ -0,0 +1,459 @@
+#include <dmzTypesMathBatch.h>
+#include <dmzTypesMatrix.h>
+#include <dmzTypesVector.h>
+
+#include <math.h>
+
+#if defined (__SSE2__) || defined (_M_X64) || (defined (_M_IX86_FP) && (_M_IX86_FP >= 2))
+#   define DMZ_MATH_BATCH_SSE2
+#   include <emmintrin.h>
+#endif
+
+#if defined (DMZ_MATH_BATCH_SSE2) && \
+   (defined (__x86_64__) || defined (__i386__)) && \
+   (defined (__clang__) || \
+      (defined (__GNUC__) && ((__GNUC__ > 4) || ((__GNUC__ == 4) && (__GNUC_MINOR__ >= 9)))))
+#   define DMZ_MATH_BATCH_AVX2
+#   define DMZ_MATH_BATCH_AVX2_TARGET __attribute__ ((target ("avx2")))
+#   include <immintrin.h>
+#endif
+
+/*!
+
+\file dmzTypesMathBatch.h
+\ingroup Types
+\brief Functions that apply Vector and Matrix operations to arrays.
+\details The functions produce the same results as calling the equivalent Vector and
+Matrix member functions on each element. The instruction set is selected when the
+kernel is loaded. SSE2 is used when the kernel is built for a processor that supports
+it. AVX2 is used when the kernel is built with GCC or Clang for x86 and the processor
+supports it. Otherwise the scalar member functions are used.
+
+*/
+
+namespace {
+
+static dmz::MathBatchModeEnum
+local_get_supported_mode () {
+
+   dmz::MathBatchModeEnum result (dmz::MathBatchScalar);
+
+   // The batch functions treat arrays of Vectors and Matrices as arrays of Float64.
+   if ((sizeof (dmz::Vector) == (sizeof (dmz::Float64) * 3)) &&
+         (sizeof (dmz::Matrix) == (sizeof (dmz::Float64) * 9))) {
+
+#ifdef DMZ_MATH_BATCH_SSE2
+      result = dmz::MathBatchSSE2;
+#endif
+
+#ifdef DMZ_MATH_BATCH_AVX2
+      __builtin_cpu_init ();
+      if (__builtin_cpu_supports ("avx2")) { result = dmz::MathBatchAVX2; }
+#endif
+   }
+
+   return result;
+}
+
+static const dmz::MathBatchModeEnum localSupportedMode (local_get_supported_mode ());
+static dmz::MathBatchModeEnum localMode (localSupportedMode);
+
+
+static inline const dmz::Float64 *
+local_array (const dmz::Vector *Value) { return (const dmz::Float64 *)Value; }
+
+
+static inline dmz::Float64 *
+local_array (dmz::Vector *value) { return (dmz::Float64 *)value; }
+
+
+static inline const dmz::Float64 *
+local_array (const dmz::Matrix *Value) { return (const dmz::Float64 *)Value; }
+
+
+static inline dmz::Float64 *
+local_array (dmz::Matrix *value) { return (dmz::Float64 *)value; }
+
+#ifdef DMZ_MATH_BATCH_SSE2
+
+static void
+local_transform_sse2 (
+      const dmz::Float64 *M,
+      const dmz::Float64 *Source,
+      const dmz::Int32 Count,
+      dmz::Float64 *target) {
+
+   const __m128d Col0 (_mm_set_pd (M[3], M[0]));
+   const __m128d Col1 (_mm_set_pd (M[4], M[1]));
+   const __m128d Col2 (_mm_set_pd (M[5], M[2]));
+
+   for (dmz::Int32 ix = 0; ix < Count; ix++) {
+
+      const dmz::Float64 X (Source[0]), Y (Source[1]), Z (Source[2]);
+
+      const __m128d XY (_mm_add_pd (
+         _mm_add_pd (
+            _mm_mul_pd (Col0, _mm_set1_pd (X)),
+            _mm_mul_pd (Col1, _mm_set1_pd (Y))),
+         _mm_mul_pd (Col2, _mm_set1_pd (Z))));
+
+      _mm_storeu_pd (target, XY);
+      target[2] = (M[6] * X) + (M[7] * Y) + (M[8] * Z);
+
+      Source += 3;
+      target += 3;
+   }
+}
+
+
+static void
+local_extrapolate_sse2 (
+      const dmz::Float64 *Position,
+      const dmz::Float64 *Velocity,
+      const dmz::Float64 Time,
+      const dmz::Int32 Count,
+      dmz::Float64 *target) {
+
+   const dmz::Int32 Size (Count * 3);
+   const __m128d TimeValue (_mm_set1_pd (Time));
+
+   dmz::Int32 place (0);
+
+   for (; (place + 2) <= Size; place += 2) {
+
+      _mm_storeu_pd (&(target[place]), _mm_add_pd (
+         _mm_loadu_pd (&(Position[place])),
+         _mm_mul_pd (_mm_loadu_pd (&(Velocity[place])), TimeValue)));
+   }
+
+   for (; place < Size; place++) {
+
+      target[place] = Position[place] + (Velocity[place] * Time);
+   }
+}
+
+
+static void
+local_normalize_sse2 (dmz::Float64 *vec, const dmz::Int32 Count) {
+
+   for (dmz::Int32 ix = 0; ix < Count; ix++) {
+
+      const __m128d XY (_mm_loadu_pd (vec));
+      const dmz::Float64 Z (vec[2]);
+
+      const dmz::Float64 Result (
+         sqrt ((vec[0] * vec[0]) + (vec[1] * vec[1]) + (Z * Z)));
+
+      const dmz::Float64 Magnitude ((Result > dmz::Epsilon64) ? Result : 0.0);
+
+      if (Magnitude > 0.0) {
+
+         const dmz::Float64 Scale (1.0 / Magnitude);
+         _mm_storeu_pd (vec, _mm_mul_pd (XY, _mm_set1_pd (Scale)));
+         vec[2] = Z * Scale;
+      }
+      else { vec[0] = vec[1] = vec[2] = 0.0; }
+
+      vec += 3;
+   }
+}
+
+
+static void
+local_multiply_sse2 (
+      const dmz::Float64 *Left,
+      const dmz::Float64 *Right,
+      const dmz::Int32 Count,
+      dmz::Float64 *target) {
+
+   for (dmz::Int32 ix = 0; ix < Count; ix++) {
+
+      const __m128d B0 (_mm_loadu_pd (&(Right[0])));
+      const __m128d B1 (_mm_loadu_pd (&(Right[3])));
+      const __m128d B2 (_mm_loadu_pd (&(Right[6])));
+      const dmz::Float64 B02 (Right[2]), B12 (Right[5]), B22 (Right[8]);
+
+      dmz::Float64 result[9];
+
+      for (dmz::Int32 row = 0; row < 9; row += 3) {
+
+         const dmz::Float64 A0 (Left[row]), A1 (Left[row + 1]), A2 (Left[row + 2]);
+
+         _mm_storeu_pd (&(result[row]), _mm_add_pd (
+            _mm_add_pd (
+               _mm_mul_pd (_mm_set1_pd (A0), B0),
+               _mm_mul_pd (_mm_set1_pd (A1), B1)),
+            _mm_mul_pd (_mm_set1_pd (A2), B2)));
+
+         result[row + 2] = (A0 * B02) + (A1 * B12) + (A2 * B22);
+      }
+
+      for (dmz::Int32 count = 0; count < 9; count++) { target[count] = result[count]; }
+
+      Left += 9;
+      Right += 9;
+      target += 9;
+   }
+}
+
+#endif // DMZ_MATH_BATCH_SSE2
+
+#ifdef DMZ_MATH_BATCH_AVX2
+
+DMZ_MATH_BATCH_AVX2_TARGET static void
+local_transform_avx2 (
+      const dmz::Float64 *M,
+      const dmz::Float64 *Source,
+      const dmz::Int32 Count,
+      dmz::Float64 *target) {
+
+   const __m256d Col0 (_mm256_set_pd (0.0, M[6], M[3], M[0]));
+   const __m256d Col1 (_mm256_set_pd (0.0, M[7], M[4], M[1]));
+   const __m256d Col2 (_mm256_set_pd (0.0, M[8], M[5], M[2]));
+   const __m256i Mask (_mm256_set_epi64x (0, -1, -1, -1));
+
+   for (dmz::Int32 ix = 0; ix < Count; ix++) {
+
+      const __m256d Result (_mm256_add_pd (
+         _mm256_add_pd (
+            _mm256_mul_pd (Col0, _mm256_broadcast_sd (&(Source[0]))),
+            _mm256_mul_pd (Col1, _mm256_broadcast_sd (&(Source[1])))),
+         _mm256_mul_pd (Col2, _mm256_broadcast_sd (&(Source[2])))));
+
+      _mm256_maskstore_pd (target, Mask, Result);
+
+      Source += 3;
+      target += 3;
+   }
+}
+
+
+DMZ_MATH_BATCH_AVX2_TARGET static void
+local_extrapolate_avx2 (
+      const dmz::Float64 *Position,
+      const dmz::Float64 *Velocity,
+      const dmz::Float64 Time,
+      const dmz::Int32 Count,
+      dmz::Float64 *target) {
+
+   const dmz::Int32 Size (Count * 3);
+   const __m256d TimeValue (_mm256_set1_pd (Time));
+
+   dmz::Int32 place (0);
+
+   for (; (place + 4) <= Size; place += 4) {
+
+      _mm256_storeu_pd (&(target[place]), _mm256_add_pd (
+         _mm256_loadu_pd (&(Position[place])),
+         _mm256_mul_pd (_mm256_loadu_pd (&(Velocity[place])), TimeValue)));
+   }
+
+   for (; place < Size; place++) {
+
+      target[place] = Position[place] + (Velocity[place] * Time);
+   }
+}
+
+#endif // DMZ_MATH_BATCH_AVX2
+
+};
+
+
+/*!
+
+\brief Gets the instruction set used by the batch math functions.
+\return Returns the instruction set in use.
+
+*/
+dmz::MathBatchModeEnum
+dmz::get_math_batch_mode () { return localMode; }
+
+
+/*!
+
+\brief Sets the instruction set used by the batch math functions.
+\details The mode is limited to the instruction sets supported by the build and the
+processor. This function is intended for testing and benchmarking and should not be
+called while batch functions are in use by other threads.
+\param[in] Mode Requested instruction set.
+\return Returns the instruction set that will be used.
+
+*/
+dmz::MathBatchModeEnum
+dmz::set_math_batch_mode (const MathBatchModeEnum Mode) {
+
+   localMode = (Mode < localSupportedMode) ? Mode : localSupportedMode;
+
+   return localMode;
+}
+
+
+/*!
+
+\brief Transforms an array of Vectors by a Matrix.
+\details Equivalent to calling dmz::Matrix::transform_vector on each element.
+\a Source and \a target may be the same array.
+\param[in] Mat Matrix used to transform the Vectors.
+\param[in] Source Array of Vectors to transform.
+\param[in] Count Number of Vectors in \a Source.
+\param[out] target Array of at least \a Count Vectors that stores the result.
+
+*/
+void
+dmz::transform_vectors (
+      const Matrix &Mat,
+      const Vector *Source,
+      const Int32 Count,
+      Vector *target) {
+
+   if (Source && target && (Count > 0)) {
+
+#ifdef DMZ_MATH_BATCH_AVX2
+      if (localMode == MathBatchAVX2) {
+
+         local_transform_avx2 (
+            local_array (&Mat),
+            local_array (Source),
+            Count,
+            local_array (target));
+      }
+      else
+#endif
+#ifdef DMZ_MATH_BATCH_SSE2
+      if (localMode >= MathBatchSSE2) {
+
+         local_transform_sse2 (
+            local_array (&Mat),
+            local_array (Source),
+            Count,
+            local_array (target));
+      }
+      else
+#endif
+      {
+         for (Int32 ix = 0; ix < Count; ix++) {
+
+            target[ix] = Source[ix];
+            Mat.transform_vector (target[ix]);
+         }
+      }
+   }
+}
+
+
+/*!
+
+\brief Extrapolates an array of positions.
+\details Sets each element of \a target to Position + (Velocity * Time).
+\a Position or \a Velocity may be the same array as \a target.
+\param[in] Position Array of positions.
+\param[in] Velocity Array of velocities.
+\param[in] Time Time to extrapolate.
+\param[in] Count Number of elements in \a Position and \a Velocity.
+\param[out] target Array of at least \a Count Vectors that stores the result.
+
+*/
+void
+dmz::extrapolate_vectors (
+      const Vector *Position,
+      const Vector *Velocity,
+      const Float64 Time,
+      const Int32 Count,
+      Vector *target) {
+
+   if (Position && Velocity && target && (Count > 0)) {
+
+#ifdef DMZ_MATH_BATCH_AVX2
+      if (localMode == MathBatchAVX2) {
+
+         local_extrapolate_avx2 (
+            local_array (Position),
+            local_array (Velocity),
+            Time,
+            Count,
+            local_array (target));
+      }
+      else
+#endif
+#ifdef DMZ_MATH_BATCH_SSE2
+      if (localMode >= MathBatchSSE2) {
+
+         local_extrapolate_sse2 (
+            local_array (Position),
+            local_array (Velocity),
+            Time,
+            Count,
+            local_array (target));
+      }
+      else
+#endif
+      {
+         for (Int32 ix = 0; ix < Count; ix++) {
+
+            target[ix] = Position[ix] + (Velocity[ix] * Time);
+         }
+      }
+   }
+}
+
+
+/*!
+
+\brief Normalizes an array of Vectors in place.
+\details Equivalent to calling dmz::Vector::normalize_in_place on each element.
+\param[in,out] vec Array of Vectors to normalize.
+\param[in] Count Number of Vectors in \a vec.
+
+*/
+void
+dmz::normalize_vectors (Vector *vec, const Int32 Count) {
+
+   if (vec && (Count > 0)) {
+
+#ifdef DMZ_MATH_BATCH_SSE2
+      if (localMode >= MathBatchSSE2) { local_normalize_sse2 (local_array (vec), Count); }
+      else
+#endif
+      {
+         for (Int32 ix = 0; ix < Count; ix++) { vec[ix].normalize_in_place (); }
+      }
+   }
+}
+
+
+/*!
+
+\brief Multiplies two arrays of Matrices.
+\details Sets each element of \a target to Left * Right. \a Left or \a Right may be the
+same array as \a target.
+\param[in] Left Array of left hand Matrices.
+\param[in] Right Array of right hand Matrices.
+\param[in] Count Number of elements in \a Left and \a Right.
+\param[out] target Array of at least \a Count Matrices that stores the result.
+
+*/
+void
+dmz::multiply_matrices (
+      const Matrix *Left,
+      const Matrix *Right,
+      const Int32 Count,
+      Matrix *target) {
+
+   if (Left && Right && target && (Count > 0)) {
+
+#ifdef DMZ_MATH_BATCH_SSE2
+      if (localMode >= MathBatchSSE2) {
+
+         local_multiply_sse2 (
+            local_array (Left),
+            local_array (Right),
+            Count,
+            local_array (target));
+      }
+      else
+#endif
+      {
+         for (Int32 ix = 0; ix < Count; ix++) { target[ix] = Left[ix] * Right[ix]; }
+      }
+   }
+}
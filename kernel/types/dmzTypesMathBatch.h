@@ -0,0 +1,50 @@
+#ifndef DMZ_TYPES_MATH_BATCH_DOT_H
+#define DMZ_TYPES_MATH_BATCH_DOT_H
+
+#include <dmzKernelExport.h>
+#include <dmzTypesBase.h>
+
+namespace dmz {
+
+class Vector;
+class Matrix;
+
+//! \addtogroup Types
+//! @{
+
+//! Instruction sets used by the batch math functions.
+enum MathBatchModeEnum {
+   MathBatchScalar, //!< Scalar code.
+   MathBatchSSE2, //!< SSE2 instructions.
+   MathBatchAVX2, //!< AVX2 instructions.
+};
+
+DMZ_KERNEL_LINK_SYMBOL MathBatchModeEnum get_math_batch_mode ();
+DMZ_KERNEL_LINK_SYMBOL MathBatchModeEnum set_math_batch_mode (
+   const MathBatchModeEnum Mode);
+
+DMZ_KERNEL_LINK_SYMBOL void transform_vectors (
+   const Matrix &Mat,
+   const Vector *Source,
+   const Int32 Count,
+   Vector *target);
+
+DMZ_KERNEL_LINK_SYMBOL void extrapolate_vectors (
+   const Vector *Position,
+   const Vector *Velocity,
+   const Float64 Time,
+   const Int32 Count,
+   Vector *target);
+
+DMZ_KERNEL_LINK_SYMBOL void normalize_vectors (Vector *vec, const Int32 Count);
+
+DMZ_KERNEL_LINK_SYMBOL void multiply_matrices (
+   const Matrix *Left,
+   const Matrix *Right,
+   const Int32 Count,
+   Matrix *target);
+
+//! @}
+};
+
+#endif // DMZ_TYPES_MATH_BATCH_DOT_H
@@ -299,31 +299,20 @@ dmz::Matrix::operator- (const Matrix &Mat) const {
 inline dmz::Matrix &
 dmz::Matrix::operator*= (const Matrix &Mat) {
 
-   Float64 sum (0.0);
-   Int32 offset0 (0), offset1 (0), offset2 (0);
+   Float64 copy[9];
+   const Float64 *B (Mat._data);
 
-   Float64 resultMatrix[9];
+   if (&Mat == this) { to_array (copy); B = copy; }
 
-   for (Int32 row = 0; row < 3; row++) {
+   for (Int32 row = 0; row < 9; row += 3) {
 
-      for (Int32 col = 0; col < 3; col++) {
+      const Float64 A0 (_data[row]), A1 (_data[row + 1]), A2 (_data[row + 2]);
 
-         offset0 = (row * 3) + col;
-         sum = 0.0;
-
-         for (Int32 count = 0; count < 3; count++) {
-
-            offset1 = (row * 3) + count;
-            offset2 = (count * 3) + col;
-            sum += _data[offset1] * Mat._data[offset2];
-         }
-
-         resultMatrix[offset0] = sum;
-      }
+      _data[row] = (A0 * B[0]) + (A1 * B[3]) + (A2 * B[6]);
+      _data[row + 1] = (A0 * B[1]) + (A1 * B[4]) + (A2 * B[7]);
+      _data[row + 2] = (A0 * B[2]) + (A1 * B[5]) + (A2 * B[8]);
    }
 
-   from_array (resultMatrix);
-
    return *this;
 }
 
@@ -9,7 +9,7 @@
 
 #include <ctype.h> // toupper tolower
 #include <stdio.h> // snprintf
-#include <string.h> // memcpy strncmp
+#include <string.h> // memcpy memcmp memchr
 
 /*!
 
@@ -38,6 +38,12 @@ binary data is stored with one of the member functions that does not take a
 length or size parameter the class will look for the first NULL character
 in the buffer to determine size and length.
 
+Short strings are stored in a buffer inside the dmz::String and do not allocate.
+Longer strings are stored in a reference counted heap buffer that is shared when the
+String is copied or assigned. The shared buffer is copied the first time one of the
+Strings sharing it is modified. The reference count is updated atomically so Strings
+that share a buffer may be used by different threads.
+
 */
 
 /*!
@@ -60,6 +66,67 @@ static const char rawInt64Format[] = "%I64";
 static const char rawInt64Format[] = "%ll";
 #endif
 
+#if defined (_WIN32)
+#   include <intrin.h>
+typedef long localRefCountType;
+#   define local_atomic_inc(value) _InterlockedIncrement (value)
+#   define local_atomic_dec(value) _InterlockedDecrement (value)
+#elif defined (__APPLE__) || defined (MACOSX)
+#   include <libkern/OSAtomic.h>
+typedef int32_t localRefCountType;
+#   define local_atomic_inc(value) OSAtomicIncrement32Barrier (value)
+#   define local_atomic_dec(value) OSAtomicDecrement32Barrier (value)
+#else
+typedef dmz::Int32 localRefCountType;
+#   define local_atomic_inc(value) __sync_add_and_fetch (value, 1)
+#   define local_atomic_dec(value) __sync_sub_and_fetch (value, 1)
+#endif
+
+namespace {
+
+// Header of a heap allocated String buffer. The character data follows the header.
+// Heap buffers are shared between copies of a String and are copied when written.
+struct StringBlockStruct {
+
+   volatile localRefCountType count;
+   dmz::Int32 pad;
+};
+
+static inline StringBlockStruct *
+local_block (char *buffer) { return ((StringBlockStruct *)buffer) - 1; }
+
+
+static char *
+local_create_block (const dmz::Int32 Size) {
+
+   StringBlockStruct *block = (StringBlockStruct *)
+      new char[sizeof (StringBlockStruct) + Size];
+
+   block->count = 1;
+
+   return (char *)(block + 1);
+}
+
+
+static inline void
+local_ref_block (char *buffer) { local_atomic_inc (&(local_block (buffer)->count)); }
+
+
+static void
+local_unref_block (char *buffer) {
+
+   StringBlockStruct *block = local_block (buffer);
+
+   // A count of one can not be raised by another thread since this String holds the
+   // only reference, so the atomic decrement is only needed for shared buffers.
+   if ((block->count == 1) || (local_atomic_dec (&(block->count)) == 0)) {
+
+      delete []((char *)block);
+   }
+}
+
+};
+
 //! Converts Int8 to String.
 dmz::String
 dmz::String::number (const char Value) {
@@ -330,7 +397,13 @@ dmz::String::number (const Float64 Value, const Int32 Precision, const char Mode
 dmz::String::String () : _buffer (NULL), _length (0), _size (0) {;}
 
 
-//! Copy constructor.
+/*!
+
+\brief Copy constructor.
+\details Short strings are copied into the inline buffer. Long strings share the
+buffer of \a Str until either String is modified.
+
+*/
 dmz::String::String (const String &Str) : _buffer (NULL), _length (0), _size (0) {
 
    *this = Str;
@@ -393,10 +466,10 @@ dmz::String::String (const char *Buffer) :
 /*!
 
 \brief Destructor
-\details Deletes allocated char buffer if it exists.
+\details Releases the buffer if it exists.
 
 */
-dmz::String::~String () { empty (); }
+dmz::String::~String () { _release (); }
 
 
 /*!
@@ -413,8 +486,9 @@ dmz::String::operator== (const String &Buffer) const {
 
    if (_length == Buffer._length) {
 
-      if (!_buffer && !Buffer._buffer) { result = True; }
-      else if (!strncmp (_buffer, Buffer._buffer, _length)) { result = True; }
+      if (_buffer == Buffer._buffer) { result = True; }
+      else if (!_buffer || !Buffer._buffer) { result = (_length == 0); }
+      else if (!memcmp (_buffer, Buffer._buffer, _length)) { result = True; }
    }
 
    return result;
@@ -438,7 +512,8 @@ dmz::String::operator!= (const String &Buffer) const {
 /*!
 
 \brief Assignment operator.
-\details Copies the contents of \a Buffer.
+\details Short strings are copied into the inline buffer. Long strings share the
+buffer of \a Buffer until either String is modified.
 \param[in] Buffer Right hand value.
 \return Returns reference to self.
 
@@ -446,26 +521,27 @@ dmz::String::operator!= (const String &Buffer) const {
 dmz::String &
 dmz::String::operator= (const String &Buffer) {
 
-   if (_buffer && !Buffer._buffer) { empty (); }
-   else if (Buffer._buffer) {
+   if (this == &Buffer) {;} // do nothing
+   else if (!Buffer._buffer) { empty (); }
+   else if (Buffer._buffer == Buffer._local) {
 
-      if ((!_buffer) || (_size <= Buffer._length)) {
+      if (_buffer != _local) {
 
-         empty ();
-
-         const Int32 NewSize (
-            Buffer._size >= Buffer._length + 1 ? Buffer._size : Buffer._length + 1);
-
-         _buffer = new char[NewSize];
-         if (_buffer) { _size = NewSize; }
+         _release ();
+         _buffer = _local;
+         _size = LocalSize;
       }
 
-      if (_buffer) {
+      _length = Buffer._length;
+      memcpy (_buffer, Buffer._buffer, _length + 1);
+   }
+   else if (_buffer != Buffer._buffer) {
 
-         _length = Buffer._length;
-         memcpy (_buffer, Buffer._buffer, _length);
-         _buffer[_length] = '\0';
-      }
+      local_ref_block (Buffer._buffer);
+      _release ();
+      _buffer = Buffer._buffer;
+      _length = Buffer._length;
+      _size = Buffer._size;
    }
 
    return *this;
@@ -483,7 +559,9 @@ together.
 dmz::String
 dmz::String::operator+ (const String &Buffer) const {
 
-   String result (*this);
+   String result;
+   result._reserve (_length + Buffer._length + 1, 0);
+   result.append (*this);
    result.append (Buffer);
    return result;
 }
@@ -516,7 +594,6 @@ dmz::String &
 dmz::String::operator+= (const char Value) {
 
    const char Buffer[] = { Value, '\0' };
-
    return append (Buffer);
 }
 
@@ -532,7 +609,9 @@ dmz::Boolean
 dmz::String::operator! () const {
 
    Boolean result (False);
+
    if (!_buffer || _buffer[0] == '\0') { result = True; }
+
    return result;
 }
 
@@ -552,7 +631,7 @@ is ignored.  @see dmz::String::resize
 void
 dmz::String::set_length (const Int32 Length, String *remainder) {
 
-   if (Length < _size) {
+   if ((Length >= 0) && (Length < _size)) {
 
       if (_buffer) {
 
@@ -565,8 +644,15 @@ dmz::String::set_length (const Int32 Length, String *remainder) {
             else { remainder->flush (); }
          }
 
-         _buffer[Length] = '\0';
-         _length = Length;
+         const Int32 OldLength (_length);
+
+         _reserve (_size, Length);
+
+         if (Length > OldLength) {
+
+            memset (&(_buffer[OldLength]), '\0', Length - OldLength);
+            _length = Length;
+         }
       }
    }
 }
@@ -605,9 +691,10 @@ dmz::String::get_size () const { return _size; }
 then the internal size of the buffer will be Size + 1 so that a NULL byte may be set
 at the end. A NULL character is appended to the end of the buffer to facilitate
 the use of the buffer in Standard C string functions and to prevent buffer
-overruns. If the string already has a buffer allocated it will either delete
-the existing buffer and allocate a new one if the existing one is too small or
-use the existing buffer if it is the same size or larger than the buffer being copied.
+overruns. If the string already has a buffer allocated it will either release
+the existing buffer and allocate a new one if the existing one is too small or shared
+with another String, or use the existing buffer if it is the same size or larger than
+the buffer being copied. Strings that fit in the inline buffer do not allocate.
 If the preexisting buffer contains data, it will be overwritten with the data
 contained in \a Buffer.
 \param[in] Buffer character buffer to copy.
@@ -620,18 +707,18 @@ dmz::String::set_buffer (const char *Buffer, const Int32 Length, const Int32 Siz
 
    if ((Length >= 0) && (Length <= Size) && Buffer) {
 
-      const Int32 RealSize ((Length == Size) ? Size + 1 :  Size);
-
-      if (!_buffer || (RealSize > _size)) {
+      if (_buffer && (Buffer >= _buffer) && (Buffer < (_buffer + _size))) {
 
-         empty ();
-         _buffer = new char[RealSize];
-         _size = RealSize;
+         // Buffer points into this String so copy it before the buffer is reused.
+         const String Copy (Buffer, Length, Size);
+         *this = Copy;
       }
+      else {
 
-      if (_buffer) {
+         const Int32 RealSize ((Length == Size) ? Size + 1 :  Size);
+
+         _reserve (RealSize, 0);
 
-         flush ();
          _length = Length;
          memcpy (_buffer, Buffer, _length);
          _buffer[_length] = '\0';
@@ -639,14 +726,9 @@ dmz::String::set_buffer (const char *Buffer, const Int32 Length, const Int32 Siz
    }
    else if (!Buffer && (Size > 0)) {
 
-      if (Size != _size) {
+      if ((_buffer != _local) && (Size != _size)) { _release (); }
 
-         empty ();
-         _buffer = new char[Size];
-         _size = Size;
-      }
-
-      flush ();
+      _reserve (Size, 0);
    }
    else if (!Size && !Length && !Buffer) { empty (); }
 }
@@ -660,6 +742,7 @@ dmz::String::set_buffer (const char *Buffer, const Int32 Length, const Int32 Siz
 
 */
 
+
 /*!
 
 \brief Returns pointer to internal buffer and stores the buffer's Length in \a length.
@@ -696,10 +779,12 @@ dmz::Boolean
 dmz::String::set_char (const Int32 Index, const char Value) {
 
    Boolean result (False);
+
    const Int32 RealIndex ((Index >= 0) ? Index : _length + Index);
 
    if ((RealIndex >= 0) && (RealIndex < _length)) {
 
+      _reserve (_size, _length);
       _buffer[RealIndex] = Value;
       result = True;
    }
@@ -724,6 +809,7 @@ char
 dmz::String::get_char (const Int32 Index) const {
 
    char result (0);
+
    const Int32 RealIndex ((Index >= 0) ? Index : _length + Index);
 
    if ((RealIndex >= 0) && (RealIndex < _length)) {
@@ -735,11 +821,11 @@ dmz::String::get_char (const Int32 Index) const {
 }
 
 
-//! \brief Deletes internal buffer.
+//! \brief Releases internal buffer.
 dmz::String &
 dmz::String::empty () {
 
-   if (_buffer) { delete []_buffer; _buffer = NULL; _size = _length = 0; }
+   _release ();
    return *this;
 }
 
@@ -747,16 +833,15 @@ dmz::String::empty () {
 /*!
 
 \brief Sets length to zero and clears the buffer.
-\details Set all values in the buffer array to NULL. The function does \b not delete
-the buffer.
+\details The function does \b not delete the buffer unless it is shared with another
+String. A shared buffer is replaced with the inline buffer.
 
 */
 dmz::String &
 dmz::String::flush () {
 
-   _length = 0;
-
-   if (_buffer) { memset (_buffer, '\0', _size); }
+   if (_buffer) { _reserve (_size, 0); }
+   else { _length = 0; }
 
    return *this;
 }
@@ -776,29 +861,8 @@ size then data that does not fit in the new buffer will be lost.
 dmz::String &
 dmz::String::resize (const Int32 Size) {
 
-   if (Size == _size) {;} // do nothing
-   else {
-
-      char *buf (new char[Size + 1]);
-
-      if (buf && _buffer) {
-
-         _size = Size + 1;
-         _length  = (Size > _length) ? _length : Size;
-         memcpy (buf, _buffer, _length);
-         buf[_length] = '\0';
-         char *oldBuf (_buffer);
-         _buffer = buf;
-         delete []oldBuf;
-      }
-      else if (buf) { // must be !_buffer
-
-         _buffer = buf;
-         _size = Size + 1;
-         _length = 0;
-         flush ();
-      }
-   }
+   if ((Size == _size) || (Size < 0)) {;} // do nothing
+   else { _reserve (Size + 1, (Size > _length) ? _length : Size); }
 
    return *this;
 }
@@ -808,7 +872,7 @@ dmz::String::resize (const Int32 Size) {
 
 \brief Appends \a Value to end of current character buffer.
 \details If current buffer is not large enough to append \a Value to the end, it will be
-resized.
+grown geometrically so that repeated appends do not reallocate each time.
 \param[in] Value buffer to append to end of current buffer.
 \return Returns reference to self.
 
@@ -818,17 +882,20 @@ dmz::String::append (const String &Value) {
 
    if (Value._buffer) {
 
-      if ((_length + Value._length) >= _size) {
+      const Int32 ValueLength (Value._length);
+      const Int32 NewLength (_length + ValueLength);
 
-         resize (_length + Value._length + 1);
-      }
-
-      if ((_length + Value._length) < _size) {
+      if (NewLength >= _size) {
 
-         memcpy (&(_buffer[_length]), Value._buffer, Value._length);
-         _length = _length + Value._length;
-         _buffer[_length] = '\0';
+         const Int32 Grow (_size + (_size >> 1));
+         _reserve (Grow > NewLength ? Grow + 1 : NewLength + 1, _length);
       }
+      else { _reserve (_size, _length); }
+
+      // Value may be this String so its buffer is read after the reserve.
+      memcpy (&(_buffer[_length]), Value._buffer, ValueLength);
+      _length = NewLength;
+      _buffer[_length] = '\0';
    }
 
    return *this;
@@ -851,20 +918,18 @@ dmz::String::repeat (const String &Buffer, const Int32 Count) {
 
    if (Buffer._length && Buffer._buffer && (Count >= 0)) {
 
-      const Int32 NewSize = Count * Buffer._length + 1;
+      const String Source (Buffer);
+      const Int32 NewSize = Count * Source._length + 1;
 
-      if (NewSize > _size) { empty (); resize (NewSize); }
+      _reserve (NewSize, 0);
 
-      if (_buffer) {
-
-         for (Int32 ix = 0; ix < Count; ix++) {
-
-            memcpy (&(_buffer[ix * Buffer._length]), Buffer._buffer, Buffer._length);
-         }
+      for (Int32 ix = 0; ix < Count; ix++) {
 
-         _length = NewSize - 1;
-         _buffer[NewSize - 1] = '\0';
+         memcpy (&(_buffer[ix * Source._length]), Source._buffer, Source._length);
       }
+
+      _length = NewSize - 1;
+      _buffer[NewSize - 1] = '\0';
    }
 
    return *this;
@@ -893,26 +958,26 @@ dmz::String::shift (const Int32 ShiftValue, const char FillChar) {
 
       if (RealShiftValue < _length) {
 
-         for (Int32 ix = RealShiftValue; ix <= _length; ix++) {
+         _reserve (_size, _length);
 
-            { _buffer[ix - RealShiftValue] = _buffer[ix]; }
-         }
+         memmove (_buffer, &(_buffer[RealShiftValue]), _length - RealShiftValue);
 
          _length = _length + ShiftValue;
+         _buffer[_length] = '\0';
       }
       else { flush (); }
    }
    else {
 
-      if ((_length + ShiftValue) >= _size) { resize (_length + ShiftValue + 1); }
+      const Int32 NewLength (_length + ShiftValue);
 
-      for (Int32 ix = _length + ShiftValue + 1; ix >= 0; ix--) {
+      _reserve ((NewLength < _size) ? _size : NewLength + 1, _length);
 
-         if (0 <= (ix - ShiftValue)) { _buffer[ix] = _buffer[ix - ShiftValue]; }
-         else { _buffer[ix] = FillChar; }
-      }
+      memmove (&(_buffer[ShiftValue]), _buffer, _length);
+      memset (_buffer, FillChar, ShiftValue);
 
-      _length = _length + ShiftValue;
+      _length = NewLength;
+      _buffer[_length] = '\0';
    }
 
    return *this;
@@ -929,7 +994,9 @@ dmz::Boolean
 dmz::String::is_null () const {
 
    Boolean result (False);
+
    if (!_buffer) { result = True; }
+
    return result;
 }
 
@@ -945,6 +1012,8 @@ dmz::String::to_upper () {
 
    if (_buffer && _length) {
 
+      _reserve (_size, _length);
+
       for (Int32 ix = 0; ix < _length; ix++) { _buffer[ix] = toupper (_buffer[ix]); }
    }
 
@@ -963,6 +1032,8 @@ dmz::String::to_lower () {
 
    if (_buffer && _length) {
 
+      _reserve (_size, _length);
+
       for (Int32 ix = 0; ix < _length; ix++) { _buffer[ix] = tolower (_buffer[ix]); }
    }
 
@@ -1014,7 +1085,6 @@ dmz::String::find_sub (
       const Int32 Start) const {
 
    Boolean result (False);
-
    index = -1;
 
    const Int32 RealStart ((Start >= 0) ? Start : _length + Start);
@@ -1023,22 +1093,31 @@ dmz::String::find_sub (
 
       if (_buffer && Sub._buffer) {
 
+         const Int32 Last (_length - Sub._length);
+
+         if (!Sub._length) { index = RealStart; result = True; }
+
          Int32 place = RealStart;
-         Boolean done = False;
 
-         while (!done) {
+         while (!result && (place <= Last)) {
+
+            const char *Found = (const char *)memchr (
+               &(_buffer[place]),
+               Sub._buffer[0],
+               Last - place + 1);
 
-            if ((_length - place) >= Sub._length) {
+            if (!Found) { place = Last + 1; }
+            else {
 
-               if (!strncmp (&(_buffer[place]), Sub._buffer, Sub._length)) {
+               place = Int32 (Found - _buffer);
+
+               if (!memcmp (Found, Sub._buffer, Sub._length)) {
 
                   index = place;
-                  done = True;
                   result = True;
                }
                else { place++; }
             }
-            else { done = True; }
          }
       }
    }
@@ -1105,15 +1184,18 @@ dmz::String::replace_sub (
 
       listStruct *next;
       Int32 start, end;
+
       listStruct (const Int32 Start, const Int32 End) :
             next (0),
             start (Start),
             end (End) {;}
+
       ~listStruct () { if (next) { delete next; next = 0; } }
    };
 
    listStruct *list (0);
    listStruct *cur (0);
+
    Int32 count (0);
    Int32 place (Start < 0 ? _length + Start : Start);
    Boolean done (False);
@@ -1123,6 +1205,7 @@ dmz::String::replace_sub (
    while (!done) {
 
       Int32 index (-1);
+
       if (find_sub (Sub, index, place)) {
 
           count++;
@@ -1137,46 +1220,44 @@ dmz::String::replace_sub (
    if (list) {
 
       const Int32 NewLen (_length + (count * (TargetLen - SubLen)));
-      char *buf (new char[NewLen + 1]);
-
-      if (buf) {
 
-         Int32 newPlace (0);
-         Int32 oldPlace (0);
-         cur = list;
+      String result;
+      result._reserve (NewLen + 1, 0);
 
-         while (cur) {
+      char *buf (result._buffer);
 
-            const Int32 Diff (cur->start - oldPlace);
+      Int32 newPlace (0);
+      Int32 oldPlace (0);
+      cur = list;
 
-            if (Diff > 0)  {
-
-               memcpy (&(buf[newPlace]), &(_buffer[oldPlace]), Diff);
-               newPlace += Diff;
-               oldPlace += Diff;
-            }
+      while (cur) {
 
-            Int32 len (-1);
+         const Int32 Diff (cur->start - oldPlace);
 
-            memcpy (&(buf[newPlace]), Target.get_buffer (len), TargetLen);
-            newPlace += TargetLen;
-            oldPlace += SubLen;
+         if (Diff > 0)  {
 
-            cur = cur->next;
+            memcpy (&(buf[newPlace]), &(_buffer[oldPlace]), Diff);
+            newPlace += Diff;
+            oldPlace += Diff;
          }
 
-         if (oldPlace < _length) {
+         Int32 len (-1);
+         memcpy (&(buf[newPlace]), Target.get_buffer (len), TargetLen);
+         newPlace += TargetLen;
+         oldPlace += SubLen;
+         cur = cur->next;
+      }
 
-            memcpy (&(buf[newPlace]), &(_buffer[oldPlace]), _length - oldPlace);
-         }
+      if (oldPlace < _length) {
 
-         empty ();
-         _buffer = buf;
-         _length = NewLen;
-         _size = NewLen + 1;
-         _buffer[_length] = '\0';
+         memcpy (&(buf[newPlace]), &(_buffer[oldPlace]), _length - oldPlace);
       }
 
+      result._length = NewLen;
+      buf[NewLen] = '\0';
+
+      *this = result;
+
       delete list; list = 0;
    }
 
@@ -1184,7 +1265,6 @@ dmz::String::replace_sub (
 }
 
 
-
 /*!
 
 \brief Tests if String contains substring at the specified string position.
@@ -1198,15 +1278,70 @@ dmz::String::contains_sub (const String &Sub, const Int32 Start) const {
 
    Boolean result (False);
 
-   if (_buffer && Sub._buffer && ((Sub._length + Start) <= _length)) {
+   if (_buffer && Sub._buffer && (Start >= 0) && ((Sub._length + Start) <= _length)) {
 
-      result = (strncmp (&(_buffer[Start]), Sub._buffer, Sub._length) == 0);
+      result = (memcmp (&(_buffer[Start]), Sub._buffer, Sub._length) == 0);
    }
 
    return result;
 }
 
 
+/*!
+
+\brief Makes the buffer writable and at least \a Size bytes.
+\details If the buffer is NULL, shared with another String, or smaller than \a Size, a
+new buffer is created. The inline buffer is used when \a Size fits in it. At most
+\a Keep bytes of the current data are preserved and the length is truncated to
+\a Keep. The buffer is always NULL terminated after the call.
+\param[in] Size Minimum size of the buffer in bytes.
+\param[in] Keep Number of bytes of the current data to preserve.
+
+*/
+void
+dmz::String::_reserve (const Int32 Size, const Int32 Keep) {
+
+   const Int32 KeepLength ((Keep < _length) ? (Keep > 0 ? Keep : 0) : _length);
+
+   const Boolean Unique (
+      _buffer && ((_buffer == _local) || (local_block (_buffer)->count == 1)));
+
+   if (!Unique || (Size > _size)) {
+
+      char *oldBuffer (_buffer);
+
+      if (Size <= LocalSize) {
+
+         _buffer = _local;
+         _size = LocalSize;
+      }
+      else {
+
+         _buffer = local_create_block (Size);
+         _size = Size;
+      }
+
+      if (oldBuffer && KeepLength) { memcpy (_buffer, oldBuffer, KeepLength); }
+
+      if (oldBuffer && (oldBuffer != _local)) { local_unref_block (oldBuffer); }
+   }
+
+   _length = KeepLength;
+   _buffer[_length] = '\0';
+}
+
+
+//! Releases the buffer and sets the String to NULL.
+void
+dmz::String::_release () {
+
+   if (_buffer && (_buffer != _local)) { local_unref_block (_buffer); }
+
+   _buffer = NULL;
+   _length = _size = 0;
+}
+
+
 dmz::String &
 operator<< (dmz::String &str, const dmz::String &Value) {
 
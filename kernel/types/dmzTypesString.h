@@ -116,9 +116,15 @@ namespace dmz {
          Boolean contains_sub (const String &Sub, const Int32 Start = 0) const;
 
       protected:
+         //! Size of the inline buffer used to store short strings.
+         enum { LocalSize = 24 };
+         void _reserve (const Int32 Size, const Int32 Keep);
+         void _release ();
+
          char * _buffer; //!< Character buffer.
          Int32 _length; //!< Number of bytes used in buffer.
          Int32 _size; //!< Buffer size in bytes.
+         char _local[LocalSize]; //!< Inline buffer used for short strings.
    };
 };
 
@@ -0,0 +1,51 @@
+#include <dmzApplication.h>
+#include <dmzFoundationXMLUtil.h>
+#include <dmzRuntimeConfig.h>
+#include <dmzRuntimeDefinitions.h>
+#include <dmzRuntimeObjectType.h>
+#include <dmzTest.h>
+
+using namespace dmz;
+
+namespace {
+
+static const char RuntimeXML[] =
+   "<dmz><runtime><object-type name=\"quietType\"/></runtime></dmz>";
+
+static Boolean
+local_init_runtime (const Boolean Quiet, Test &test) {
+
+   Application app ("dmzApplicationTest", "dmz");
+   app.set_quiet (Quiet);
+
+   Config global ("global");
+   Boolean result (xml_string_to_config (RuntimeXML, global, &(test.log)));
+
+   if (result) {
+
+      app.add_global_config (global);
+      result = app.init_runtime ();
+   }
+
+   ObjectType type;
+
+   return result &&
+      Definitions (app.get_context ()).lookup_object_type ("quietType", type);
+}
+
+};
+
+
+int
+main (int argc, char *argv[]) {
+
+   Test test ("dmzApplicationTest", argc, argv);
+
+   test.validate ("Runtime types are defined", local_init_runtime (False, test));
+
+   test.validate (
+      "Runtime types are defined in quiet mode",
+      local_init_runtime (True, test));
+
+   return test.result ();
+}
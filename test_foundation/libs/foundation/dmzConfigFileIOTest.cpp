@@ -0,0 +1,223 @@
+#include <dmzFoundationConfigFileIO.h>
+#include <dmzFoundationConsts.h>
+#include <dmzFoundationXMLUtil.h>
+#include <dmzRuntimeConfig.h>
+#include <dmzSystemFile.h>
+#include <dmzSystemStreamString.h>
+#include <dmzTest.h>
+#include <dmzTypesStringContainer.h>
+
+#include <stdio.h>
+
+using namespace dmz;
+
+namespace {
+
+static const char CacheDir[] = ".";
+static const char CacheExtension[] = ".dmzcache";
+
+static Boolean
+is_cache_file (const String &FileName) {
+
+   const String Ext (CacheExtension);
+
+   return FileName.contains_sub (Ext, FileName.get_length () - Ext.get_length ());
+}
+
+
+static Boolean
+write_file (const String &FileName, const String &Value) {
+
+   Boolean result (False);
+
+   FILE *file (open_file (FileName, "wb"));
+
+   if (file) {
+
+      result = fwrite (Value.get_buffer (), 1, Value.get_length (), file) ==
+         size_t (Value.get_length ());
+
+      close_file (file);
+   }
+
+   return result;
+}
+
+
+static String
+to_xml (const Config &Data) {
+
+   String result;
+   StreamString stream (result);
+   format_config_to_xml (Data, stream, ConfigPrettyPrint);
+
+   return result;
+}
+
+
+static Int32
+count_cache_files () {
+
+   Int32 result (0);
+
+   StringContainer list;
+
+   if (get_file_list (CacheDir, list)) {
+
+      StringContainerIterator it;
+      String file;
+
+      while (list.get_next (it, file)) { if (is_cache_file (file)) { result++; } }
+   }
+
+   return result;
+}
+
+
+static void
+remove_files (const StringContainer &Files) {
+
+   StringContainerIterator it;
+   String file;
+
+   while (Files.get_next (it, file)) { remove_file (file); }
+
+   StringContainer list;
+
+   if (get_file_list (CacheDir, list)) {
+
+      it.reset ();
+
+      while (list.get_next (it, file)) {
+
+         if (is_cache_file (file)) { remove_file (String (CacheDir) + "/" + file); }
+      }
+   }
+}
+
+};
+
+
+int
+main (int argc, char *argv[]) {
+
+   Test test ("dmzConfigFileIOTest", argc, argv);
+
+   StringContainer files;
+
+   for (Int32 ix = 0; ix < 8; ix++) {
+
+      String name, value;
+      name << "dmzConfigFileIOTest" << ix << ".xml";
+
+      value << "<dmz><item" << ix << " index=\"" << ix << "\" name=\"item\">"
+         << "<list value=\"a\"/><other/><list value=\"b\"/>"
+         << "<text><![CDATA[  line one\n  line two]]></text>"
+         << "</item" << ix << "></dmz>";
+
+      if (write_file (name, value)) { files.add (name); }
+   }
+
+   const String JSONFile ("dmzConfigFileIOTest.json");
+
+   if (write_file (
+         JSONFile,
+         "{\"dmz\":{\"array\":[{\"value\":\"1\"},{\"value\":\"2\"}],\"flag\":true}}")) {
+
+      files.add (JSONFile);
+   }
+
+   test.validate ("Test config files written", files.get_count () == 9);
+
+   Config serial ("global");
+   test.validate (
+      "Config files read serially",
+      read_config_files ("", files, serial));
+
+   const String Expected (to_xml (serial));
+
+   Config parallel ("global");
+   test.validate (
+      "Config files read in parallel",
+      read_config_files_parallel (files, parallel, "", 4));
+
+   test.validate (
+      "Config files read in parallel match files read serially",
+      to_xml (parallel) == Expected);
+
+   Config cacheMiss ("global");
+   test.validate (
+      "Config files read with an empty cache",
+      read_config_files_parallel (files, cacheMiss, CacheDir, 4));
+
+   test.validate (
+      "Cache file stored for each config file",
+      count_cache_files () == files.get_count ());
+
+   test.validate (
+      "Config files read with an empty cache match files read serially",
+      to_xml (cacheMiss) == Expected);
+
+   Config cacheHit ("global");
+   test.validate (
+      "Config files read from the cache",
+      read_config_files_parallel (files, cacheHit, CacheDir, 1));
+
+   test.validate (
+      "Config files read from the cache match files read serially",
+      to_xml (cacheHit) == Expected);
+
+   Config array;
+   test.validate (
+      "JSON array read from the cache",
+      cacheHit.lookup_all_config ("dmz.array", array) &&
+         array.get_config_count () == 2);
+
+   ConfigIterator it;
+   Config element;
+
+   test.validate (
+      "JSON array element in array flag read from the cache",
+      array.get_first_config (it, element) && element.is_in_array ());
+
+   Config text;
+   Config value;
+   test.validate (
+      "Formatted value read from the cache",
+      cacheHit.lookup_config ("dmz.item0.text", text) &&
+         text.get_first_config (it, value) && value.is_formatted ());
+
+   write_file ("dmzConfigFileIOTest0.xml", "<dmz><changed/></dmz>");
+
+   Config changed ("global");
+   test.validate (
+      "Changed config file read with the cache",
+      read_config_files_parallel (files, changed, CacheDir, 4));
+
+   Config tmp;
+   test.validate (
+      "Changed config file is parsed instead of read from the cache",
+      changed.lookup_config ("dmz.changed", tmp) &&
+         !changed.lookup_config ("dmz.item0", tmp));
+
+   write_file ("dmzConfigFileIOTest3.xml", "<dmz><broken></dmz>");
+   write_file ("dmzConfigFileIOTest5.xml", "<dmz><broken></dmz>");
+
+   Config broken ("global");
+   test.validate (
+      "Config files that fail to parse are reported",
+      !read_config_files_parallel (files, broken, CacheDir, 4));
+
+   test.validate (
+      "Config files after one that fails to parse are still read",
+      broken.lookup_config ("dmz.item2", tmp) &&
+         !broken.lookup_config ("dmz.item3", tmp) &&
+         broken.lookup_config ("dmz.item4", tmp) &&
+         !broken.lookup_config ("dmz.item5", tmp) &&
+         broken.lookup_config ("dmz.item7", tmp) &&
+         broken.lookup_config ("dmz.array", tmp));
+
+   remove_files (files);
+
+   return test.result ();
+}
@@ -0,0 +1,237 @@
+#include <dmzAudioSoundAttributes.h>
+#include <dmzAudioSoundInit.h>
+#include <dmzAudioVoiceManager.h>
+#include <dmzSystem.h>
+#include <dmzTypesHandleContainer.h>
+#include <dmzTypesVector.h>
+#include <dmzTest.h>
+
+using namespace dmz;
+
+namespace {
+
+// A large battle: far more sound instances than a back end has voices.
+static const Int32 BattleCount = 4000;
+static const Int32 BattleVoices = 32;
+static const Int32 FrameCount = 100;
+static const Float64 FrameTime = 1.0 / 60.0;
+
+
+static Boolean
+local_add (
+      VoiceManager &voices,
+      const Handle VoiceHandle,
+      const Vector &Pos,
+      const Float64 Priority = 1.0,
+      const Boolean Looped = True,
+      const Float64 Length = 10.0) {
+
+   SoundInit init;
+   init.set (SoundLooped, Looped);
+   init.set_priority (Priority);
+
+   SoundAttributes attr;
+   attr.set_position (Pos);
+
+   return voices.add_voice (VoiceHandle, init, attr, Length);
+}
+
+
+static Boolean
+local_move (VoiceManager &voices, const Handle VoiceHandle, const Vector &Pos) {
+
+   SoundAttributes attr;
+   attr.set_position (Pos);
+
+   return voices.update_voice (VoiceHandle, attr);
+}
+
+
+static Boolean
+local_near (const Float64 Value1, const Float64 Value2) {
+
+   const Float64 Diff (Value1 - Value2);
+   return (Diff < 1.0e-9) && (Diff > -1.0e-9);
+}
+
+};
+
+
+int
+main (int argc, char *argv[]) {
+
+   Test test ("dmzAudioVoiceManagerTest", argc, argv);
+
+   VoiceManager voices;
+   voices.set_max_voices (2);
+
+   HandleContainer promoted, demoted, expired;
+
+   test.validate (
+      "Voices are real while there are free voices",
+      local_add (voices, 1, Vector (0.0, 0.0, 10.0)) &&
+      local_add (voices, 2, Vector (0.0, 0.0, 20.0)) &&
+      local_add (voices, 3, Vector (0.0, 0.0, 2.0)) &&
+      !local_add (voices, 3, Vector (0.0, 0.0, 2.0)) &&
+      voices.is_real_voice (1) && voices.is_real_voice (2) &&
+      !voices.is_real_voice (3) &&
+      (voices.get_voice_count () == 3) && (voices.get_real_voice_count () == 2));
+
+   voices.update (0.5, promoted, demoted, expired);
+
+   test.validate (
+      "Closest voices are real",
+      voices.is_real_voice (1) && voices.is_real_voice (3) &&
+      !voices.is_real_voice (2) &&
+      promoted.contains (3) && (promoted.get_count () == 1) &&
+      demoted.contains (2) && (demoted.get_count () == 1) &&
+      !expired.get_count ());
+
+   test.validate (
+      "Virtual voices keep their offset",
+      local_near (voices.get_offset (2), 0.5) && local_near (voices.get_offset (3), 0.5));
+
+   test.validate (
+      "Audibility follows the inverse distance model",
+      local_near (voices.get_audibility (1), 0.1) &&
+      local_near (voices.get_audibility (2), 0.05));
+
+   local_move (voices, 2, Vector (0.0, 0.0, 9.0));
+   voices.update (0.1, promoted, demoted, expired);
+
+   test.validate (
+      "Real voices are not swapped for slightly louder voices",
+      voices.is_real_voice (1) && !voices.is_real_voice (2) &&
+      !promoted.get_count () && !demoted.get_count ());
+
+   local_move (voices, 2, Vector (0.0, 0.0, 1.0));
+   voices.update (0.1, promoted, demoted, expired);
+
+   test.validate (
+      "Approaching voice becomes real",
+      voices.is_real_voice (2) && !voices.is_real_voice (1) &&
+      promoted.contains (2) && demoted.contains (1));
+
+   test.validate (
+      "Priority outranks distance",
+      local_add (voices, 4, Vector (0.0, 0.0, 100.0), 1000.0) &&
+      !voices.is_real_voice (4));
+
+   voices.update (0.1, promoted, demoted, expired);
+
+   test.validate (
+      "High priority voice becomes real",
+      voices.is_real_voice (4) && (voices.get_real_voice_count () == 2));
+
+   voices.set_listener_position (Vector (0.0, 0.0, 10.0));
+   voices.update (0.1, promoted, demoted, expired);
+
+   test.validate (
+      "Ranking follows the listener",
+      voices.is_real_voice (4) && voices.is_real_voice (1) &&
+      !voices.is_real_voice (2) && !voices.is_real_voice (3));
+
+   voices.remove_voice (4);
+   voices.update (0.1, promoted, demoted, expired);
+
+   test.validate (
+      "Removed voice frees a real voice",
+      (voices.get_voice_count () == 3) && (voices.get_real_voice_count () == 2) &&
+      voices.is_real_voice (1) && (promoted.get_count () == 1));
+
+   voices.clear ();
+   voices.set_listener_position (Vector ());
+
+   local_add (voices, 10, Vector (0.0, 0.0, 1.0), 1.0, False, 1.0);
+   local_add (voices, 11, Vector (0.0, 0.0, 1.0), 1.0, True, 1.0);
+   local_add (voices, 12, Vector (0.0, 0.0, 50.0), 1.0, False, 1.0);
+   local_add (voices, 13, Vector (0.0, 0.0, 50.0), 1.0, True, 1.0);
+
+   voices.update (0.75, promoted, demoted, expired);
+   voices.update (0.5, promoted, demoted, expired);
+
+   test.validate (
+      "Finished virtual voices expire",
+      expired.contains (12) && (expired.get_count () == 1) &&
+      (voices.get_voice_count () == 3) && !voices.get_offset (12));
+
+   test.validate (
+      "Finished real voices are left to the back end",
+      voices.is_real_voice (10) && local_near (voices.get_offset (10), 1.25));
+
+   test.validate (
+      "Looped voices wrap",
+      local_near (voices.get_offset (11), 0.25) &&
+      local_near (voices.get_offset (13), 0.25));
+
+   SoundInit relativeInit;
+   relativeInit.set (SoundRelative, True);
+   relativeInit.set (SoundLooped, True);
+   SoundAttributes relativeAttr;
+   relativeAttr.set_position (Vector (0.0, 0.0, 0.5));
+   voices.set_listener_position (Vector (0.0, 0.0, 1000.0));
+
+   test.validate (
+      "Relative voices ignore the listener",
+      voices.add_voice (14, relativeInit, relativeAttr, 1.0) &&
+      local_near (voices.get_audibility (14), 1.0));
+
+   voices.set_max_voices (0);
+   voices.update (0.0, promoted, demoted, expired);
+
+   test.validate (
+      "Zero max voices makes every voice real",
+      (voices.get_real_voice_count () == voices.get_voice_count ()) &&
+      !demoted.get_count ());
+
+   VoiceManager battle;
+   battle.set_max_voices (BattleVoices);
+   battle.set_rolloff_factor (0.1);
+
+   for (Int32 ix = 0; ix < BattleCount; ix++) {
+
+      local_add (
+         battle,
+         Handle (ix + 1),
+         Vector (Float64 (ix % 100) * 10.0, 0.0, Float64 (ix / 100) * 10.0),
+         (ix % 10) ? 1.0 : 4.0);
+   }
+
+   const Float64 Start (get_time ());
+
+   Int32 changes (0);
+
+   for (Int32 frame = 0; frame < FrameCount; frame++) {
+
+      battle.set_listener_position (Vector (Float64 (frame) * 5.0, 0.0, 200.0));
+      battle.update (FrameTime, promoted, demoted, expired);
+      changes += promoted.get_count ();
+   }
+
+   const Float64 Time (get_time () - Start);
+
+   Boolean ranked (battle.get_real_voice_count () == BattleVoices);
+   Float64 minReal (-1.0);
+   Float64 maxVirtual (0.0);
+
+   for (Int32 ix = 1; ix <= BattleCount; ix++) {
+
+      const Float64 Audibility (battle.get_audibility (ix));
+
+      if (battle.is_real_voice (ix)) {
+
+         if ((minReal < 0.0) || (Audibility < minReal)) { minReal = Audibility; }
+      }
+      else if (Audibility > maxVirtual) { maxVirtual = Audibility; }
+   }
+
+   test.log.out << "Ranked " << BattleCount << " voices for " << BattleVoices
+      << " real voices over " << FrameCount << " frames in " << Time * 1.0e3
+      << " ms with " << changes << " promotions" << endl;
+
+   test.validate (
+      "Battle keeps the most audible voices real",
+      ranked && (minReal > 0.0) && ((minReal * 1.2) >= maxVirtual));
+
+   return test.result ();
+}
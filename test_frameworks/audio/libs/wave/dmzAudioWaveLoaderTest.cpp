@@ -0,0 +1,320 @@
+#include <dmzAudioWaveFile.h>
+#include <dmzAudioWaveLoader.h>
+#include <dmzSystem.h>
+#include <dmzSystemFile.h>
+#include <dmzSystemMarshal.h>
+#include <dmzTypesString.h>
+#include <dmzTest.h>
+
+#include <stdio.h>
+#include <string.h>
+
+using namespace dmz;
+
+namespace {
+
+// Matches the ambient tracks loaded when a large scenario starts.
+static const Int32 FileCount = 16;
+static const Int32 FileBytes = 1024 * 1024;
+static const Int32 StreamChunk = 4096;
+static const Int32 ThreadCount = 2;
+
+static String
+local_temp_dir () {
+
+   String result (get_env ("TMPDIR"));
+   if (!result) { result = get_env ("TEMP"); }
+   if (!result) { result = get_env ("TMP"); }
+   if (!result) { result = "/tmp"; }
+
+   return result;
+}
+
+
+// The files are written to the temp directory so the test does not depend on the
+// current directory being writable.
+static const String TestPrefix (local_temp_dir () + "/dmzAudioWaveLoaderTest-");
+
+
+static char
+local_sample (const Int32 File, const Int32 Offset) {
+
+   return char (((Offset * 13) + (File * 7)) & 0xFF);
+}
+
+
+static String
+local_file_name (const Int32 File) {
+
+   String result (TestPrefix);
+   result << "track" << File << ".wav";
+   return result;
+}
+
+
+static void
+local_tag (const char *Tag, Marshal &out) {
+
+   for (Int32 ix = 0; ix < 4; ix++) { out.set_next_uint8 (UInt8 (Tag[ix])); }
+}
+
+
+// Writes a 16 bit stereo file with an extended fmt chunk and an odd sized chunk
+// before the audio data.
+static Boolean
+local_write_wave (const String &FileName, const Int32 File, const Int32 Size) {
+
+   Boolean result (False);
+
+   char *data (new char[Size]);
+
+   for (Int32 ix = 0; ix < Size; ix++) { data[ix] = local_sample (File, ix); }
+
+   Marshal out (ByteOrderLittleEndian);
+   local_tag ("RIFF", out);
+   out.set_next_uint32 (UInt32 (4 + 26 + 12 + 8 + Size));
+   local_tag ("WAVE", out);
+   local_tag ("fmt ", out);
+   out.set_next_uint32 (18);
+   out.set_next_uint16 (WaveFormatPCM);
+   out.set_next_uint16 (2);
+   out.set_next_uint32 (22050);
+   out.set_next_uint32 (22050 * 4);
+   out.set_next_uint16 (4);
+   out.set_next_uint16 (16);
+   out.set_next_uint16 (0);
+   local_tag ("LIST", out);
+   out.set_next_uint32 (3);
+   local_tag ("abcd", out);
+   local_tag ("data", out);
+   out.set_next_uint32 (UInt32 (Size));
+
+   FILE *file (open_file (FileName, "wb"));
+
+   if (file) {
+
+      Int32 headerSize (0);
+      const char *Header (out.get_buffer (headerSize));
+
+      result =
+         (fwrite (Header, 1, headerSize, file) == size_t (headerSize)) &&
+         (fwrite (data, 1, Size, file) == size_t (Size));
+
+      close_file (file);
+   }
+
+   delete []data; data = 0;
+
+   return result;
+}
+
+
+static Boolean
+local_check_data (
+      const char *Data,
+      const Int32 File,
+      const Int32 Offset,
+      const Int32 Size) {
+
+   Boolean result (Data != 0);
+
+   for (Int32 ix = 0; result && (ix < Size); ix++) {
+
+      if (Data[ix] != local_sample (File, Offset + ix)) { result = False; }
+   }
+
+   return result;
+}
+
+
+static Boolean
+local_check_file (WaveFile &file, const Int32 File) {
+
+   UInt32 size (0);
+   const char *Data (file.get_audio_buffer (size));
+
+   return file.is_valid () && (size == UInt32 (FileBytes)) &&
+      local_check_data (Data, File, 0, FileBytes);
+}
+
+};
+
+
+int
+main (int argc, char *argv[]) {
+
+   Test test ("dmzAudioWaveLoaderTest", argc, argv);
+
+   Boolean written (True);
+
+   for (Int32 ix = 0; ix < FileCount; ix++) {
+
+      if (!local_write_wave (local_file_name (ix), ix, FileBytes)) { written = False; }
+   }
+
+   test.validate ("Write wave files", written);
+
+   WaveFile wave (local_file_name (0));
+
+   test.validate (
+      "Load wave file with extra chunks",
+      (wave.get_audio_format () == WaveFormatPCM) &&
+      (wave.get_channel_count () == 2) &&
+      (wave.get_frequency () == 22050) &&
+      (wave.get_bits_per_sample () == 16) &&
+      (wave.get_data_size () == UInt32 (FileBytes)) &&
+      local_check_file (wave, 0));
+
+   WaveFile stream;
+
+   Boolean match (stream.open_stream (local_file_name (1)));
+   char buffer[StreamChunk];
+   Int32 offset (0);
+   UInt32 read (0);
+
+   while (match && ((read = stream.read_stream (StreamChunk, buffer)) > 0)) {
+
+      if (!local_check_data (buffer, 1, offset, Int32 (read))) { match = False; }
+      offset += Int32 (read);
+   }
+
+   UInt32 size (0);
+
+   test.validate (
+      "Stream wave file in pieces",
+      match && (offset == FileBytes) && stream.is_valid () &&
+      (stream.get_data_size () == UInt32 (FileBytes)) &&
+      !stream.get_audio_buffer (size) && (size == 0));
+
+   test.validate (
+      "Rewind stream",
+      stream.rewind_stream () &&
+      (stream.read_stream (StreamChunk, buffer) == UInt32 (StreamChunk)) &&
+      local_check_data (buffer, 1, 0, StreamChunk));
+
+   test.validate (
+      "Seek stream",
+      stream.seek_stream (UInt32 (FileBytes / 2)) &&
+      (stream.read_stream (StreamChunk, buffer) == UInt32 (StreamChunk)) &&
+      local_check_data (buffer, 1, FileBytes / 2, StreamChunk) &&
+      stream.seek_stream (UInt32 (FileBytes * 2)) &&
+      (stream.read_stream (StreamChunk, buffer) == 0));
+
+   stream.clear ();
+
+   test.validate (
+      "Closed stream reads nothing",
+      !stream.is_valid () && (stream.read_stream (StreamChunk, buffer) == 0));
+
+   WaveFile missing;
+
+   test.validate (
+      "Missing file fails to load",
+      !missing.load_file (TestPrefix + "missing.wav") && !missing.is_valid () &&
+      missing.get_error ());
+
+   Float64 start (get_time ());
+
+   Boolean loaded (True);
+
+   for (Int32 ix = 0; ix < FileCount; ix++) {
+
+      WaveFile file (local_file_name (ix));
+      if (!local_check_file (file, ix)) { loaded = False; }
+   }
+
+   const Float64 SyncTime (get_time () - start);
+
+   test.validate ("Load files on the calling thread", loaded);
+
+   WaveLoader loader;
+   loader.set_thread_count (ThreadCount);
+
+   start = get_time ();
+
+   Boolean requested (True);
+
+   for (Int32 ix = 0; ix < FileCount; ix++) {
+
+      if (!loader.request_file (local_file_name (ix))) { requested = False; }
+   }
+
+   const Float64 RequestTime (get_time () - start);
+
+   test.validate (
+      "Requests for files that are already pending are ignored",
+      requested && !loader.request_file (local_file_name (0)) &&
+      loader.is_pending (local_file_name (0)) &&
+      loader.request_file (TestPrefix + "missing.wav"));
+
+   Int32 count (0);
+   Int32 failed (0);
+   loaded = True;
+
+   while (loader.get_pending_count () > 0) {
+
+      WaveFile *file (loader.take_loaded_file ());
+
+      if (file) {
+
+         if (!file->is_valid ()) { failed++; }
+         else {
+
+            Int32 index (-1);
+
+            for (Int32 ix = 0; ix < FileCount; ix++) {
+
+               if (file->get_file_name () == local_file_name (ix)) { index = ix; }
+            }
+
+            if ((index < 0) || !local_check_file (*file, index)) { loaded = False; }
+
+            count++;
+         }
+
+         delete file; file = 0;
+      }
+      else { sleep (0.001); }
+   }
+
+   const Float64 AsyncTime (get_time () - start);
+
+   test.log.out << "Load " << FileCount << " files: " << SyncTime * 1.0e3
+      << " ms blocking, " << RequestTime * 1.0e3 << " ms blocking and "
+      << AsyncTime * 1.0e3 << " ms total with " << ThreadCount << " workers" << endl;
+
+   test.validate (
+      "Workers load every requested file",
+      loaded && (count == FileCount) && (failed == 1) &&
+      !loader.is_pending (local_file_name (0)) && !loader.take_loaded_file ());
+
+   loader.set_thread_count (0);
+
+   WaveFile *file (0);
+
+   test.validate (
+      "Zero threads loads on the calling thread",
+      loader.request_file (local_file_name (2)) &&
+      (file = loader.take_loaded_file ()) && local_check_file (*file, 2) &&
+      (loader.get_pending_count () == 0));
+
+   if (file) { delete file; file = 0; }
+
+   loader.set_thread_count (ThreadCount);
+
+   for (Int32 ix = 0; ix < FileCount; ix++) {
+
+      loader.request_file (local_file_name (ix));
+   }
+
+   loader.stop ();
+
+   test.validate (
+      "Stop discards pending files",
+      (loader.get_pending_count () == 0) && !loader.take_loaded_file () &&
+      loader.request_file (local_file_name (3)));
+
+   for (Int32 ix = 0; ix < FileCount; ix++) { remove_file (local_file_name (ix)); }
+
+   return test.result ();
+}
@@ -0,0 +1,681 @@
+#include <dmzEventModule.h>
+#include "dmzEventModuleBasicTest.h"
+#include <dmzEventConsts.h>
+#include <dmzRuntimeConfig.h>
+#include <dmzRuntimeData.h>
+#include <dmzRuntimeDefinitions.h>
+#include <dmzRuntimePluginFactoryLinkSymbol.h>
+#include <dmzSystem.h>
+#include <dmzTypesMask.h>
+#include <dmzTypesMatrix.h>
+#include <dmzTypesVector.h>
+
+namespace {
+
+// Matches the event load of a heavy weapon fire exercise.
+static const dmz::Int32 BurstCount = 20000;
+static const dmz::Int32 OpenCount = 100;
+static const dmz::Int32 GrowCount = 20;
+static const dmz::Int32 BatchCount = 5000;
+static const dmz::Float64 ExpireMargin = 0.3;
+
+};
+
+
+dmz::EventModuleBasicTest::EventModuleBasicTest (
+      const PluginInfo &Info,
+      Config &local,
+      Config &global) :
+      Plugin (Info),
+      TimeSlice (Info),
+      EventObserver (Info),
+      test (Info.get_name (), Info.get_context ()),
+      _log (Info),
+      _time (Info.get_context ()),
+      _eventMod (0),
+      _attrHandle (0),
+      _sourceHandle (0),
+      _targetHandle (0),
+      _started (False),
+      _expireTime (0.0),
+      _dumpCount (0),
+      _dumpBadCount (0),
+      _createCount (0),
+      _closeCount (0),
+      _closeBatchCount (0),
+      _closeBatchEventCount (0),
+      _delayedHandle (0) {
+
+   Definitions defs (Info.get_context ());
+
+   _attrHandle = defs.create_named_handle ("Test_Attribute");
+   _sourceHandle = defs.create_named_handle ("Test_Source");
+   _targetHandle = defs.create_named_handle ("Test_Target");
+}
+
+
+dmz::EventModuleBasicTest::~EventModuleBasicTest () {;}
+
+
+// Plugin Interface
+void
+dmz::EventModuleBasicTest::discover_plugin (
+      const PluginDiscoverEnum Mode,
+      const Plugin *PluginPtr) {
+
+   if (Mode == PluginDiscoverAdd) {
+
+      if (!_eventMod) { _eventMod = EventModule::cast (PluginPtr); }
+   }
+   else if (Mode == PluginDiscoverRemove) {
+
+      if (_eventMod && (_eventMod == EventModule::cast (PluginPtr))) { _eventMod = 0; }
+   }
+}
+
+
+// TimeSlice Interface
+void
+dmz::EventModuleBasicTest::update_time_slice (const Float64 TimeDelta) {
+
+   if (!_eventMod) {
+
+      test.validate (False, "Discovered event module");
+      test.exit ("Test completed");
+   }
+   else if (!_started) {
+
+      _started = True;
+
+      Definitions defs (get_plugin_runtime_context ());
+
+      _type = defs.get_root_event_type ();
+      _objectType = defs.get_root_object_type ();
+
+      test.validate (_type && _objectType, "Found event and object types");
+
+      _test_attributes ();
+      _test_batch ();
+
+      _create_events (OpenCount, _openList);
+
+      const Float64 Time (_create_events (BurstCount, _closedList));
+
+      _log.out << "Create, fill, and close " << BurstCount << " events: "
+         << Time * 1.0e3 << " ms" << endl;
+
+      test.validate (
+         _events_exist (_closedList, True) && _events_exist (_openList, True),
+         "Closed events are kept until they expire");
+
+      _expireTime = _time.get_frame_time () + ExpireMargin;
+   }
+   else if (_time.get_frame_time () > _expireTime) {
+
+      test.validate (
+         _events_exist (_closedList, False),
+         "Closed events expire after the time to live");
+
+      test.validate (_events_exist (_openList, True), "Open events do not expire");
+
+      HandleContainer list;
+
+      const Float64 Time (_create_events (BurstCount, list));
+
+      _log.out << "Create, fill, and close " << BurstCount << " recycled events: "
+         << Time * 1.0e3 << " ms" << endl;
+
+      test.validate (
+         (list.get_count () == BurstCount) && _events_exist (list, True),
+         "Expired event records are reused");
+
+      test.exit ("Test completed");
+   }
+}
+
+
+// EventObserver Interface
+void
+dmz::EventModuleBasicTest::create_event (
+      const Handle EventHandle,
+      const EventType &Type,
+      const EventLocalityEnum Locality) {
+
+   _createCount++;
+}
+
+
+void
+dmz::EventModuleBasicTest::close_event (
+      const Handle EventHandle,
+      const EventType &Type,
+      const EventLocalityEnum Locality) {
+
+   _closeCount++;
+}
+
+
+void
+dmz::EventModuleBasicTest::close_events (
+      const EventRecordStruct *List,
+      const Int32 Count) {
+
+   _closeBatchCount++;
+   _closeBatchEventCount += Count;
+
+   // Closing an event from inside the callback is delayed until the batch is done.
+   if (_delayedHandle) {
+
+      const Handle Delayed (_delayedHandle);
+      _delayedHandle = 0;
+      _eventMod->close_event (Delayed);
+   }
+}
+
+
+// EventDump Interface
+void
+dmz::EventModuleBasicTest::start_dump_event (
+      const Handle EventHandle,
+      const EventType &Type,
+      const EventLocalityEnum Locality) {
+
+   _dumpCount = 0;
+   _dumpBadCount = 0;
+
+   if ((Type != _type) || (Locality != EventLocal)) { _dumpBadCount++; }
+}
+
+
+void
+dmz::EventModuleBasicTest::end_dump_event (const Handle EventHandle) {;}
+
+
+void
+dmz::EventModuleBasicTest::store_event_handle (
+      const Handle EventHandle,
+      const Handle AttributeHandle,
+      const Handle Value) {
+
+   _dumpCount++;
+   if (Value != 7) { _dumpBadCount++; }
+}
+
+
+void
+dmz::EventModuleBasicTest::store_event_object_handle (
+      const Handle EventHandle,
+      const Handle AttributeHandle,
+      const Handle Value) {
+
+   _dumpCount++;
+   if ((AttributeHandle == _sourceHandle) && (Value != 11)) { _dumpBadCount++; }
+   else if ((AttributeHandle == _targetHandle) && (Value != 12)) { _dumpBadCount++; }
+}
+
+
+void
+dmz::EventModuleBasicTest::store_event_object_type (
+      const Handle EventHandle,
+      const Handle AttributeHandle,
+      const ObjectType &Value) {
+
+   _dumpCount++;
+   if (Value != _objectType) { _dumpBadCount++; }
+}
+
+
+void
+dmz::EventModuleBasicTest::store_event_state (
+      const Handle EventHandle,
+      const Handle AttributeHandle,
+      const Mask &Value) {
+
+   _dumpCount++;
+   if (Value != Mask (3)) { _dumpBadCount++; }
+}
+
+
+void
+dmz::EventModuleBasicTest::store_event_time_stamp (
+      const Handle EventHandle,
+      const Handle AttributeHandle,
+      const Float64 &Value) {
+
+   _dumpCount++;
+   if (Value != 100.0) { _dumpBadCount++; }
+}
+
+
+void
+dmz::EventModuleBasicTest::store_event_position (
+      const Handle EventHandle,
+      const Handle AttributeHandle,
+      const Vector &Value) {
+
+   _dumpCount++;
+   if (Value != Vector (1.0, 2.0, 3.0)) { _dumpBadCount++; }
+}
+
+
+void
+dmz::EventModuleBasicTest::store_event_orientation (
+      const Handle EventHandle,
+      const Handle AttributeHandle,
+      const Matrix &Value) {
+
+   _dumpCount++;
+   if (Value != Matrix (Vector (0.0, 1.0, 0.0), 0.5)) { _dumpBadCount++; }
+}
+
+
+void
+dmz::EventModuleBasicTest::store_event_velocity (
+      const Handle EventHandle,
+      const Handle AttributeHandle,
+      const Vector &Value) {
+
+   _dumpCount++;
+   if (Value != Vector (4.0, 5.0, 6.0)) { _dumpBadCount++; }
+}
+
+
+void
+dmz::EventModuleBasicTest::store_event_acceleration (
+      const Handle EventHandle,
+      const Handle AttributeHandle,
+      const Vector &Value) {
+
+   _dumpCount++;
+   if (Value != Vector (7.0, 8.0, 9.0)) { _dumpBadCount++; }
+}
+
+
+void
+dmz::EventModuleBasicTest::store_event_scale (
+      const Handle EventHandle,
+      const Handle AttributeHandle,
+      const Vector &Value) {
+
+   _dumpCount++;
+   if (Value != Vector (1.0, 1.0, 1.0)) { _dumpBadCount++; }
+}
+
+
+void
+dmz::EventModuleBasicTest::store_event_vector (
+      const Handle EventHandle,
+      const Handle AttributeHandle,
+      const Vector &Value) {
+
+   _dumpCount++;
+   if (Value != Vector (-1.0, -2.0, -3.0)) { _dumpBadCount++; }
+}
+
+
+void
+dmz::EventModuleBasicTest::store_event_scalar (
+      const Handle EventHandle,
+      const Handle AttributeHandle,
+      const Float64 Value) {
+
+   _dumpCount++;
+   if (Value != 0.25) { _dumpBadCount++; }
+}
+
+
+void
+dmz::EventModuleBasicTest::store_event_counter (
+      const Handle EventHandle,
+      const Handle AttributeHandle,
+      const Int64 Value) {
+
+   _dumpCount++;
+   if (Value != -9000000000ll) { _dumpBadCount++; }
+}
+
+
+void
+dmz::EventModuleBasicTest::store_event_text (
+      const Handle EventHandle,
+      const Handle AttributeHandle,
+      const String &Value) {
+
+   _dumpCount++;
+   if (Value != "Splash") { _dumpBadCount++; }
+}
+
+
+void
+dmz::EventModuleBasicTest::store_event_data (
+      const Handle EventHandle,
+      const Handle AttributeHandle,
+      const Data &Value) {
+
+   Float64 value (0.0);
+
+   _dumpCount++;
+   if (!Value.lookup_float64 (_attrHandle, 0, value) || (value != 42.0)) {
+
+      _dumpBadCount++;
+   }
+}
+
+
+void
+dmz::EventModuleBasicTest::_test_attributes () {
+
+   const Handle Event (_eventMod->create_event (_type, EventLocal));
+
+   test.validate (Event != 0, "Create event");
+
+   const Vector Position (1.0, 2.0, 3.0);
+   const Matrix Orientation (Vector (0.0, 1.0, 0.0), 0.5);
+   const Vector Velocity (4.0, 5.0, 6.0);
+   const Vector Acceleration (7.0, 8.0, 9.0);
+   const Vector Scale (1.0, 1.0, 1.0);
+   const Vector Offset (-1.0, -2.0, -3.0);
+   const Int64 Counter (-9000000000ll);
+   Data data (get_plugin_runtime_context ());
+   data.store_float64 (_attrHandle, 0, 42.0);
+
+   test.validate (
+      _eventMod->store_handle (Event, _attrHandle, 6) &&
+      _eventMod->store_handle (Event, _attrHandle, 7) &&
+      _eventMod->store_object_handle (Event, _sourceHandle, 10) &&
+      _eventMod->store_object_handle (Event, _targetHandle, 12) &&
+      _eventMod->store_object_handle (Event, _sourceHandle, 11) &&
+      _eventMod->store_object_type (Event, _attrHandle, _objectType) &&
+      _eventMod->store_state (Event, _attrHandle, Mask (3)) &&
+      _eventMod->store_time_stamp (Event, _attrHandle, 100.0) &&
+      _eventMod->store_position (Event, _attrHandle, Position) &&
+      _eventMod->store_orientation (Event, _attrHandle, Orientation) &&
+      _eventMod->store_velocity (Event, _attrHandle, Velocity) &&
+      _eventMod->store_acceleration (Event, _attrHandle, Acceleration) &&
+      _eventMod->store_scale (Event, _attrHandle, Scale) &&
+      _eventMod->store_vector (Event, _attrHandle, Offset) &&
+      _eventMod->store_scalar (Event, _attrHandle, 0.25) &&
+      _eventMod->store_counter (Event, _attrHandle, Counter) &&
+      _eventMod->store_text (Event, _attrHandle, "Splash") &&
+      _eventMod->store_data (Event, _attrHandle, data),
+      "Store every attribute type");
+
+   Handle handle (0), source (0), target (0);
+   ObjectType objectType;
+   Mask state;
+   Float64 timeStamp (0.0), scalar (0.0);
+   Vector position, velocity, acceleration, scale, offset;
+   Matrix orientation;
+   Int64 counter (0);
+   String text;
+   Data dataValue;
+
+   test.validate (
+      _eventMod->lookup_handle (Event, _attrHandle, handle) && (handle == 7) &&
+      _eventMod->lookup_object_handle (Event, _sourceHandle, source) &&
+      (source == 11) &&
+      _eventMod->lookup_object_handle (Event, _targetHandle, target) &&
+      (target == 12) &&
+      _eventMod->lookup_object_type (Event, _attrHandle, objectType) &&
+      (objectType == _objectType) &&
+      _eventMod->lookup_state (Event, _attrHandle, state) && (state == Mask (3)) &&
+      _eventMod->lookup_time_stamp (Event, _attrHandle, timeStamp) &&
+      (timeStamp == 100.0) &&
+      _eventMod->lookup_position (Event, _attrHandle, position) &&
+      (position == Position) &&
+      _eventMod->lookup_orientation (Event, _attrHandle, orientation) &&
+      (orientation == Orientation) &&
+      _eventMod->lookup_velocity (Event, _attrHandle, velocity) &&
+      (velocity == Velocity) &&
+      _eventMod->lookup_acceleration (Event, _attrHandle, acceleration) &&
+      (acceleration == Acceleration) &&
+      _eventMod->lookup_scale (Event, _attrHandle, scale) && (scale == Scale) &&
+      _eventMod->lookup_vector (Event, _attrHandle, offset) && (offset == Offset) &&
+      _eventMod->lookup_scalar (Event, _attrHandle, scalar) && (scalar == 0.25) &&
+      _eventMod->lookup_counter (Event, _attrHandle, counter) &&
+      (counter == Counter) &&
+      _eventMod->lookup_text (Event, _attrHandle, text) && (text == "Splash") &&
+      _eventMod->lookup_data (Event, _attrHandle, dataValue) && (dataValue == data),
+      "Lookup every attribute type");
+
+   test.validate (
+      !_eventMod->lookup_handle (Event, _sourceHandle, handle) &&
+      !_eventMod->lookup_position (Event, _sourceHandle, position) &&
+      !_eventMod->lookup_text (Event, _targetHandle, text),
+      "Missing attributes are not found");
+
+   _eventMod->dump_event (Event, *this);
+
+   test.validate ((_dumpCount == 16) && (_dumpBadCount == 0), "Dump every attribute");
+
+   test.validate (
+      _eventMod->close_event (Event) && !_eventMod->close_event (Event) &&
+      !_eventMod->store_handle (Event, _attrHandle, 8) &&
+      _eventMod->lookup_handle (Event, _attrHandle, handle) && (handle == 7),
+      "Closed event keeps attributes and rejects changes");
+
+   // Store more attributes than fit in the inline block of an event.
+   const Handle Grow (_eventMod->create_event (_type, EventLocal));
+
+   Definitions defs (get_plugin_runtime_context ());
+   Boolean stored (True), found (True);
+
+   for (Int32 ix = 0; ix < GrowCount; ix++) {
+
+      String name ("Test_Grow_");
+      name << ix;
+      const Handle Attr (defs.create_named_handle (name));
+
+      if (!_eventMod->store_vector (Grow, Attr, Vector (ix, ix, ix)) ||
+            !_eventMod->store_text (Grow, Attr, name)) { stored = False; }
+   }
+
+   for (Int32 ix = 0; ix < GrowCount; ix++) {
+
+      String name ("Test_Grow_");
+      name << ix;
+      const Handle Attr (defs.create_named_handle (name));
+
+      Vector value;
+      String text;
+
+      if (!_eventMod->lookup_vector (Grow, Attr, value) ||
+            (value != Vector (ix, ix, ix)) ||
+            !_eventMod->lookup_text (Grow, Attr, text) || (text != name)) {
+
+         found = False;
+      }
+   }
+
+   test.validate (
+      stored && found && _eventMod->close_event (Grow),
+      "Attributes grow past the inline block");
+}
+
+
+void
+dmz::EventModuleBasicTest::_test_batch () {
+
+   Definitions defs (get_plugin_runtime_context ());
+
+   const Handle DefaultHandle (defs.create_named_handle (EventAttributeDefaultName));
+   const Handle SourceHandle (defs.create_named_handle (EventAttributeSourceName));
+   const Handle TargetHandle (defs.create_named_handle (EventAttributeTargetName));
+   const Handle MunitionsHandle (defs.create_named_handle (EventAttributeMunitionsName));
+
+   _eventMod->register_event_observer (_type, Mask (0, EventCallbackAll), *this);
+
+   // Per event path with an observer for comparison.
+   Float64 start (get_time ());
+
+   for (Int32 ix = 0; ix < BatchCount; ix++) {
+
+      const Handle Event (_eventMod->create_event (_type, EventLocal));
+
+      _eventMod->store_object_handle (Event, SourceHandle, Handle (ix + 1));
+      _eventMod->store_object_handle (Event, TargetHandle, Handle (ix + 2));
+      _eventMod->store_object_handle (Event, MunitionsHandle, Handle (ix + 3));
+      _eventMod->store_position (Event, DefaultHandle, Vector (ix, 0.0, ix));
+      _eventMod->store_velocity (Event, DefaultHandle, Vector (0.0, 0.0, -300.0));
+      _eventMod->close_event (Event);
+   }
+
+   const Float64 SingleTime (get_time () - start);
+
+   test.validate (
+      (_createCount == BatchCount) && (_closeCount == BatchCount) &&
+      (_closeBatchCount == 0),
+      "Closing single events calls the per event callbacks");
+
+   _createCount = _closeCount = 0;
+
+   EventDescriptorStruct *list (new EventDescriptorStruct[BatchCount + 1]);
+   Handle *handles (new Handle[BatchCount + 2]);
+
+   start = get_time ();
+
+   for (Int32 ix = 0; ix < BatchCount; ix++) {
+
+      EventDescriptorStruct &desc (list[ix]);
+      desc.type = _type;
+      desc.source = Handle (ix + 1);
+      desc.target = Handle (ix + 2);
+      desc.munitions = Handle (ix + 3);
+      desc.hasPosition = True;
+      desc.position.set_xyz (ix, 0.0, ix);
+      desc.hasVelocity = (ix % 2) == 0;
+      desc.velocity.set_xyz (0.0, 0.0, -300.0);
+   }
+
+   // An event without a type is not created.
+   list[BatchCount].type = EventType ();
+
+   const Int32 Created (_eventMod->create_events (list, BatchCount + 1));
+
+   for (Int32 ix = 0; ix < BatchCount; ix++) { handles[ix] = list[ix].handle; }
+
+   // Repeated and unknown handles are skipped.
+   handles[BatchCount] = handles[0];
+   handles[BatchCount + 1] = 0;
+
+   _delayedHandle = _eventMod->create_event (_type, EventLocal);
+   const Handle Delayed (_delayedHandle);
+
+   const Int32 Closed (_eventMod->close_events (handles, BatchCount + 2));
+
+   const Float64 BatchTime (get_time () - start);
+
+   _log.out << "Create, fill, and close " << BatchCount << " observed events: "
+      << SingleTime * 1.0e3 << " ms one at a time, " << BatchTime * 1.0e3
+      << " ms as a batch" << endl;
+
+   test.validate (
+      (Created == BatchCount) && (list[BatchCount].handle == 0) &&
+      (Closed == BatchCount),
+      "Create and close a batch of events");
+
+   Boolean found (True);
+
+   for (Int32 ix = 0; found && (ix < BatchCount); ix++) {
+
+      const Handle Event (list[ix].handle);
+      Handle source (0), target (0), munitions (0);
+      Vector position, velocity;
+
+      found =
+         _eventMod->lookup_object_handle (Event, SourceHandle, source) &&
+         (source == Handle (ix + 1)) &&
+         _eventMod->lookup_object_handle (Event, TargetHandle, target) &&
+         (target == Handle (ix + 2)) &&
+         _eventMod->lookup_object_handle (Event, MunitionsHandle, munitions) &&
+         (munitions == Handle (ix + 3)) &&
+         _eventMod->lookup_position (Event, DefaultHandle, position) &&
+         (position == Vector (ix, 0.0, ix)) &&
+         (_eventMod->lookup_velocity (Event, DefaultHandle, velocity) ==
+            ((ix % 2) == 0)) &&
+         !_eventMod->store_handle (Event, _attrHandle, 1);
+   }
+
+   test.validate (found, "Batch events store descriptor attributes and are closed");
+
+   test.validate (
+      (_createCount == (BatchCount + 1)) && (_closeBatchCount == 1) &&
+      (_closeBatchEventCount == BatchCount),
+      "Observer receives one batch callback");
+
+   test.validate (
+      (_closeCount == 1) && !_eventMod->store_handle (Delayed, _attrHandle, 1),
+      "Event closed in a batch callback is closed after the batch");
+
+   test.validate (
+      (_eventMod->close_events (handles, BatchCount) == 0) &&
+      (_eventMod->create_events (0, 1) == 0),
+      "Closed events are not closed again");
+
+   _eventMod->release_event_observer_all (*this);
+
+   delete []list; list = 0;
+   delete []handles; handles = 0;
+}
+
+
+dmz::Float64
+dmz::EventModuleBasicTest::_create_events (const Int32 Count, HandleContainer &list) {
+
+   const Float64 Start (get_time ());
+   const Boolean Close (&list != &_openList);
+
+   for (Int32 ix = 0; ix < Count; ix++) {
+
+      const Handle Event (_eventMod->create_event (_type, EventLocal));
+
+      if (Event) {
+
+         _eventMod->store_object_handle (Event, _sourceHandle, Handle (ix + 1));
+         _eventMod->store_object_handle (Event, _targetHandle, Handle (ix + 2));
+         _eventMod->store_object_type (Event, _attrHandle, _objectType);
+         _eventMod->store_position (Event, _attrHandle, Vector (ix, 0.0, ix));
+         _eventMod->store_velocity (Event, _attrHandle, Vector (0.0, 0.0, -300.0));
+
+         if (Close) { _eventMod->close_event (Event); }
+
+         list.add (Event);
+      }
+   }
+
+   return get_time () - Start;
+}
+
+
+dmz::Boolean
+dmz::EventModuleBasicTest::_events_exist (
+      const HandleContainer &List,
+      const Boolean Exist) {
+
+   Boolean result (List.get_count () > 0);
+
+   HandleContainerIterator it;
+   Handle event (0);
+   EventType type;
+
+   while (result && List.get_next (it, event)) {
+
+      if (_eventMod->lookup_event_type (event, type) != Exist) { result = False; }
+   }
+
+   return result;
+}
+
+
+extern "C" {
+
+DMZ_PLUGIN_FACTORY_LINK_SYMBOL dmz::Plugin *
+create_dmzEventModuleBasicTest (
+      const dmz::PluginInfo &Info,
+      dmz::Config &local,
+      dmz::Config &global) {
+
+   return new dmz::EventModuleBasicTest (Info, local, global);
+}
+
+};
@@ -0,0 +1,173 @@
+#ifndef DMZ_EVENT_MODULE_BASIC_TEST_DOT_H
+#define DMZ_EVENT_MODULE_BASIC_TEST_DOT_H
+
+#include <dmzEventDump.h>
+#include <dmzEventObserver.h>
+#include <dmzRuntimeEventType.h>
+#include <dmzRuntimeLog.h>
+#include <dmzRuntimeObjectType.h>
+#include <dmzRuntimePlugin.h>
+#include <dmzRuntimeTime.h>
+#include <dmzRuntimeTimeSlice.h>
+#include <dmzTestPluginUtil.h>
+#include <dmzTypesHandleContainer.h>
+
+namespace dmz {
+
+   class Config;
+   class EventModule;
+
+   class EventModuleBasicTest :
+      public Plugin,
+      public TimeSlice,
+      public EventObserver,
+      public EventDump {
+
+      public:
+         EventModuleBasicTest (
+            const PluginInfo &Info,
+            Config &local,
+            Config &global);
+         ~EventModuleBasicTest ();
+
+         // Plugin Interface
+         virtual void update_plugin_state (
+            const PluginStateEnum State,
+            const UInt32 Level) {;}
+
+         virtual void discover_plugin (
+            const PluginDiscoverEnum Mode,
+            const Plugin *PluginPtr);
+
+         // TimeSlice Interface
+         virtual void update_time_slice (const Float64 TimeDelta);
+
+         // EventObserver Interface
+         virtual void store_event_module (const String &Name, EventModule &module) {;}
+         virtual void remove_event_module (const String &Name, EventModule &module) {;}
+
+         virtual void create_event (
+            const Handle EventHandle,
+            const EventType &Type,
+            const EventLocalityEnum Locality);
+
+         virtual void close_event (
+            const Handle EventHandle,
+            const EventType &Type,
+            const EventLocalityEnum Locality);
+
+         virtual void close_events (const EventRecordStruct *List, const Int32 Count);
+
+         // EventDump Interface
+         virtual void start_dump_event (
+            const Handle EventHandle,
+            const EventType &Type,
+            const EventLocalityEnum Locality);
+
+         virtual void end_dump_event (const Handle EventHandle);
+
+         virtual void store_event_handle (
+            const Handle EventHandle,
+            const Handle AttributeHandle,
+            const Handle Value);
+
+         virtual void store_event_object_handle (
+            const Handle EventHandle,
+            const Handle AttributeHandle,
+            const Handle Value);
+
+         virtual void store_event_object_type (
+            const Handle EventHandle,
+            const Handle AttributeHandle,
+            const ObjectType &Value);
+
+         virtual void store_event_state (
+            const Handle EventHandle,
+            const Handle AttributeHandle,
+            const Mask &Value);
+
+         virtual void store_event_time_stamp (
+            const Handle EventHandle,
+            const Handle AttributeHandle,
+            const Float64 &Value);
+
+         virtual void store_event_position (
+            const Handle EventHandle,
+            const Handle AttributeHandle,
+            const Vector &Value);
+
+         virtual void store_event_orientation (
+            const Handle EventHandle,
+            const Handle AttributeHandle,
+            const Matrix &Value);
+
+         virtual void store_event_velocity (
+            const Handle EventHandle,
+            const Handle AttributeHandle,
+            const Vector &Value);
+
+         virtual void store_event_acceleration (
+            const Handle EventHandle,
+            const Handle AttributeHandle,
+            const Vector &Value);
+
+         virtual void store_event_scale (
+            const Handle EventHandle,
+            const Handle AttributeHandle,
+            const Vector &Value);
+
+         virtual void store_event_vector (
+            const Handle EventHandle,
+            const Handle AttributeHandle,
+            const Vector &Value);
+
+         virtual void store_event_scalar (
+            const Handle EventHandle,
+            const Handle AttributeHandle,
+            const Float64 Value);
+
+         virtual void store_event_counter (
+            const Handle EventHandle,
+            const Handle AttributeHandle,
+            const Int64 Value);
+
+         virtual void store_event_text (
+            const Handle EventHandle,
+            const Handle AttributeHandle,
+            const String &Value);
+
+         virtual void store_event_data (
+            const Handle EventHandle,
+            const Handle AttributeHandle,
+            const Data &Value);
+
+      protected:
+         void _test_attributes ();
+         void _test_batch ();
+         Float64 _create_events (const Int32 Count, HandleContainer &list);
+         Boolean _events_exist (const HandleContainer &List, const Boolean Exist);
+
+         TestPluginUtil test;
+         Log _log;
+         Time _time;
+         EventType _type;
+         ObjectType _objectType;
+         EventModule *_eventMod;
+         Handle _attrHandle;
+         Handle _sourceHandle;
+         Handle _targetHandle;
+         Boolean _started;
+         Float64 _expireTime;
+         Int32 _dumpCount;
+         Int32 _dumpBadCount;
+         Int32 _createCount;
+         Int32 _closeCount;
+         Int32 _closeBatchCount;
+         Int32 _closeBatchEventCount;
+         Handle _delayedHandle;
+         HandleContainer _openList;
+         HandleContainer _closedList;
+   };
+};
+
+#endif // DMZ_EVENT_MODULE_BASIC_TEST_DOT_H
@@ -0,0 +1,336 @@
+#include <dmzInputMaskConsts.h>
+#include <dmzInputEventController.h>
+#include <dmzInputModule.h>
+#include "dmzInputModuleBasicTest.h"
+#include <dmzRuntimeConfig.h>
+#include <dmzRuntimeData.h>
+#include <dmzRuntimeDefinitions.h>
+#include <dmzRuntimePluginFactoryLinkSymbol.h>
+#include <dmzSystem.h>
+#include <dmzTypesMask.h>
+
+namespace {
+
+// Matches a station with several tools listening to a joystick and a mouse.
+static const dmz::Int32 ChannelCount = 32;
+static const dmz::Int32 EventCount = 100000;
+static const dmz::Int32 MoveCount = 50;
+static const dmz::Handle Source = 1;
+
+static const dmz::Mask LocalEventMask (
+   dmz::Mask (0, dmz::InputEventAxisConst) |
+   dmz::Mask (0, dmz::InputEventButtonConst) |
+   dmz::Mask (0, dmz::InputEventMouseConst) |
+   dmz::Mask (0, dmz::InputEventDataConst));
+
+static dmz::InputEventMouse
+local_mouse (const dmz::Int32 X, const dmz::Int32 PreviousX, const dmz::UInt32 Mask) {
+
+   dmz::InputEventMouse result;
+   result.set_source_handle (Source);
+   result.set_mouse_position (X, 0);
+   result.set_previous_mouse_position (PreviousX, 0);
+   result.set_mouse_screen_position (X, 0);
+   result.set_previous_mouse_screen_position (PreviousX, 0);
+   result.set_button_mask (Mask);
+   result.set_previous_button_mask (Mask);
+   return result;
+}
+
+};
+
+
+dmz::InputModuleBasicTest::InputModuleBasicTest (
+      const PluginInfo &Info,
+      Config &local,
+      Config &global) :
+      Plugin (Info),
+      TimeSlice (Info),
+      InputObserver (Info),
+      test (Info.get_name (), Info.get_context ()),
+      _log (Info),
+      _inputMod (0),
+      _coalesceMod (0),
+      _frame (0),
+      _channelA (0),
+      _channelB (0),
+      _lastChannel (0),
+      _axisCount (0),
+      _buttonCount (0),
+      _mouseCount (0),
+      _dataCount (0),
+      _axisValue (0.0f) {
+
+   Definitions defs (Info.get_context ());
+
+   _channelA = defs.create_named_handle ("Test_Channel_A");
+   _channelB = defs.create_named_handle ("Test_Channel_B");
+}
+
+
+dmz::InputModuleBasicTest::~InputModuleBasicTest () {;}
+
+
+// TimeSlice Interface
+void
+dmz::InputModuleBasicTest::update_time_slice (const Float64 TimeDelta) {
+
+   _frame++;
+
+   if (!_inputMod || !_coalesceMod) {
+
+      test.validate (False, "Discovered input modules");
+      test.exit ("Test completed");
+   }
+   else if (_frame == 1) {
+
+      _test_dispatch ();
+      _start_coalesce ();
+   }
+   else if (_frame == 3) {
+
+      _test_coalesce ();
+      test.exit ("Test completed");
+   }
+}
+
+
+// InputObserver Interface
+void
+dmz::InputModuleBasicTest::store_input_module (
+      const String &Name,
+      InputModule &module) {
+
+   if (Name == "dmzInputModuleBasic") { _inputMod = &module; }
+   else if (Name == "dmzInputModuleBasicCoalesce") { _coalesceMod = &module; }
+}
+
+
+void
+dmz::InputModuleBasicTest::remove_input_module (
+      const String &Name,
+      InputModule &module) {
+
+   if (_inputMod == &module) { _inputMod = 0; }
+   if (_coalesceMod == &module) { _coalesceMod = 0; }
+}
+
+
+void
+dmz::InputModuleBasicTest::receive_axis_event (
+      const Handle Channel,
+      const InputEventAxis &Value) {
+
+   _axisCount++;
+   _axisValue = Value.get_axis_value ();
+   _lastChannel = Channel;
+}
+
+
+void
+dmz::InputModuleBasicTest::receive_button_event (
+      const Handle Channel,
+      const InputEventButton &Value) {
+
+   _buttonCount++;
+   _lastChannel = Channel;
+}
+
+
+void
+dmz::InputModuleBasicTest::receive_mouse_event (
+      const Handle Channel,
+      const InputEventMouse &Value) {
+
+   if (!_mouseCount) { _firstMouse = Value; }
+   _mouseCount++;
+   _lastMouse = Value;
+   _lastChannel = Channel;
+}
+
+
+void
+dmz::InputModuleBasicTest::receive_data_event (
+      const Handle Channel,
+      const Handle Source,
+      const Data &Value) {
+
+   _dataCount++;
+   _lastChannel = Channel;
+}
+
+
+void
+dmz::InputModuleBasicTest::_reset () {
+
+   _lastChannel = 0;
+   _axisCount = 0;
+   _buttonCount = 0;
+   _mouseCount = 0;
+   _dataCount = 0;
+}
+
+
+void
+dmz::InputModuleBasicTest::_test_dispatch () {
+
+   _inputMod->register_input_observer (_channelA, LocalEventMask, *this);
+   _inputMod->register_input_observer (_channelB, LocalEventMask, *this);
+
+   _reset ();
+
+   InputEventAxis axis (Source, 1);
+   axis.update_axis_value (0.5f);
+   _inputMod->send_axis_event (axis);
+
+   InputEventButton button (Source, 1);
+   button.update_button_value (True);
+   _inputMod->send_button_event (button);
+
+   _inputMod->send_data_event (Source, Data ());
+
+   test.validate (
+      (_axisCount == 1) && (_buttonCount == 1) && (_dataCount == 1),
+      "Observer on two channels receives each event once");
+
+   const Handle FirstChannel (_lastChannel);
+   const Handle SecondChannel (FirstChannel == _channelA ? _channelB : _channelA);
+
+   _reset ();
+   _inputMod->send_axis_event (axis);
+
+   test.validate (_axisCount == 0, "Duplicate axis event is not sent");
+
+   _inputMod->set_channel_state (FirstChannel, False);
+
+   _reset ();
+   axis.update_axis_value (0.25f);
+   _inputMod->send_axis_event (axis);
+
+   test.validate (
+      (_axisCount == 1) && (_lastChannel == SecondChannel) && (_axisValue == 0.25f),
+      "Event is sent through the remaining active channel");
+
+   _inputMod->set_channel_state (SecondChannel, False);
+
+   _reset ();
+   axis.update_axis_value (0.75f);
+   _inputMod->send_axis_event (axis);
+   _inputMod->send_data_event (Source, Data ());
+
+   test.validate (
+      (_axisCount == 0) && (_dataCount == 0),
+      "Events are not sent to inactive channels");
+
+   _inputMod->set_channel_state (FirstChannel, True);
+   _inputMod->release_input_observer (FirstChannel, LocalEventMask, *this);
+
+   _reset ();
+   axis.update_axis_value (0.5f);
+   _inputMod->send_axis_event (axis);
+
+   test.validate (_axisCount == 0, "Events are not sent after the observer is released");
+
+   _inputMod->release_input_observer (SecondChannel, LocalEventMask, *this);
+
+   Definitions defs (get_plugin_runtime_context ());
+
+   for (Int32 ix = 0; ix < ChannelCount; ix++) {
+
+      String name ("Test_Channel_");
+      name << ix;
+
+      const Handle Channel (defs.create_named_handle (name));
+
+      _inputMod->register_input_observer (Channel, LocalEventMask, *this);
+
+      // Only every other channel is active like tools that are not selected.
+      if (ix % 2) { _inputMod->set_channel_state (Channel, False); }
+   }
+
+   _reset ();
+
+   const Float64 Start (get_time ());
+
+   for (Int32 ix = 0; ix < EventCount; ix++) {
+
+      axis.update_axis_value (Float32 (ix % 100) * 0.01f);
+      _inputMod->send_axis_event (axis);
+   }
+
+   _log.out << "Send " << EventCount << " axis events on " << ChannelCount
+      << " channels: " << (get_time () - Start) * 1.0e3 << " ms" << endl;
+
+   test.validate (_axisCount == EventCount, "Every changed axis value is sent once");
+}
+
+
+void
+dmz::InputModuleBasicTest::_start_coalesce () {
+
+   _coalesceMod->register_input_observer (_channelA, LocalEventMask, *this);
+
+   _reset ();
+
+   InputEventAxis axis (Source, 2);
+
+   for (Int32 ix = 1; ix <= MoveCount; ix++) {
+
+      axis.update_axis_value (Float32 (ix) * 0.01f);
+      _coalesceMod->send_axis_event (axis);
+   }
+
+   for (Int32 ix = 1; ix <= MoveCount; ix++) {
+
+      _coalesceMod->send_mouse_event (local_mouse (ix, ix - 1, 0));
+   }
+
+   test.validate (
+      (_axisCount == 0) && (_mouseCount == 0),
+      "Axis and mouse move events are held until the end of the frame");
+
+   InputEventMouse press (local_mouse (MoveCount, MoveCount, 1));
+   press.set_previous_button_mask (0);
+   _coalesceMod->send_mouse_event (press);
+
+   test.validate (
+      (_mouseCount == 2) &&
+      (_firstMouse.get_mouse_x () == MoveCount) &&
+      (_firstMouse.get_previous_mouse_x () == 0) &&
+      (_lastMouse.get_button_mask () == 1),
+      "Button press is sent after one move spanning the held moves");
+
+   for (Int32 ix = 1; ix <= MoveCount; ix++) {
+
+      _coalesceMod->send_mouse_event (
+         local_mouse (MoveCount + ix, MoveCount + ix - 1, 1));
+   }
+}
+
+
+void
+dmz::InputModuleBasicTest::_test_coalesce () {
+
+   test.validate (
+      (_axisCount == 1) && (_axisValue == Float32 (MoveCount) * 0.01f) &&
+      (_mouseCount == 3) &&
+      (_lastMouse.get_mouse_x () == (MoveCount * 2)) &&
+      (_lastMouse.get_previous_mouse_x () == MoveCount),
+      "One axis and one mouse move event are sent per frame");
+
+   _coalesceMod->release_input_observer (_channelA, LocalEventMask, *this);
+}
+
+
+extern "C" {
+
+DMZ_PLUGIN_FACTORY_LINK_SYMBOL dmz::Plugin *
+create_dmzInputModuleBasicTest (
+      const dmz::PluginInfo &Info,
+      dmz::Config &local,
+      dmz::Config &global) {
+
+   return new dmz::InputModuleBasicTest (Info, local, global);
+}
+
+};
@@ -0,0 +1,95 @@
+#ifndef DMZ_INPUT_MODULE_BASIC_TEST_DOT_H
+#define DMZ_INPUT_MODULE_BASIC_TEST_DOT_H
+
+#include <dmzInputEventMouse.h>
+#include <dmzInputObserver.h>
+#include <dmzRuntimeLog.h>
+#include <dmzRuntimePlugin.h>
+#include <dmzRuntimeTimeSlice.h>
+#include <dmzTestPluginUtil.h>
+
+namespace dmz {
+
+   class Config;
+   class InputModule;
+
+   class InputModuleBasicTest :
+      public Plugin,
+      public TimeSlice,
+      public InputObserver {
+
+      public:
+         InputModuleBasicTest (
+            const PluginInfo &Info,
+            Config &local,
+            Config &global);
+         ~InputModuleBasicTest ();
+
+         // Plugin Interface
+         virtual void update_plugin_state (
+            const PluginStateEnum State,
+            const UInt32 Level) {;}
+
+         virtual void discover_plugin (
+            const PluginDiscoverEnum Mode,
+            const Plugin *PluginPtr) {;}
+
+         // TimeSlice Interface
+         virtual void update_time_slice (const Float64 TimeDelta);
+
+         // InputObserver Interface
+         virtual void store_input_module (const String &Name, InputModule &module);
+         virtual void remove_input_module (const String &Name, InputModule &module);
+
+         virtual void update_channel_state (const Handle Channel, const Boolean State) {;}
+
+         virtual void receive_axis_event (
+            const Handle Channel,
+            const InputEventAxis &Value);
+
+         virtual void receive_button_event (
+            const Handle Channel,
+            const InputEventButton &Value);
+
+         virtual void receive_switch_event (
+            const Handle Channel,
+            const InputEventSwitch &Value) {;}
+
+         virtual void receive_key_event (
+            const Handle Channel,
+            const InputEventKey &Value) {;}
+
+         virtual void receive_mouse_event (
+            const Handle Channel,
+            const InputEventMouse &Value);
+
+         virtual void receive_data_event (
+            const Handle Channel,
+            const Handle Source,
+            const Data &Value);
+
+      protected:
+         void _reset ();
+         void _test_dispatch ();
+         void _start_coalesce ();
+         void _test_coalesce ();
+
+         TestPluginUtil test;
+         Log _log;
+         InputModule *_inputMod;
+         InputModule *_coalesceMod;
+         Int32 _frame;
+         Handle _channelA;
+         Handle _channelB;
+         Handle _lastChannel;
+         Int32 _axisCount;
+         Int32 _buttonCount;
+         Int32 _mouseCount;
+         Int32 _dataCount;
+         Float32 _axisValue;
+         InputEventMouse _firstMouse;
+         InputEventMouse _lastMouse;
+   };
+};
+
+#endif // DMZ_INPUT_MODULE_BASIC_TEST_DOT_H
@@ -0,0 +1,135 @@
+#include <dmzObjectUpdateQueue.h>
+#include <dmzSystem.h>
+#include <dmzTest.h>
+#include <dmzTypesHandleContainer.h>
+
+using namespace dmz;
+
+namespace {
+
+static const Int32 ObjectCount = 300;
+
+// Every tenth object is visible. Applying an update takes about 0.2 ms so a frame
+// budget is used up after a few hundred updates at most.
+class TestUpdater : public ObjectUpdateQueue::Updater {
+
+   public:
+      TestUpdater () : count (0), visibleFirst (True), _visibleDone (False) {;}
+
+      virtual Boolean is_update_visible (const Handle ObjectHandle) {
+
+         return (ObjectHandle % 10) == 0;
+      }
+
+      virtual void apply_update (const Handle ObjectHandle) {
+
+         if (is_update_visible (ObjectHandle)) {
+
+            if (_visibleDone) { visibleFirst = False; }
+         }
+         else { _visibleDone = True; }
+
+         const Float64 Start (get_time ());
+         while ((get_time () - Start) < 0.0002) {;}
+
+         updated.add (ObjectHandle);
+         count++;
+      }
+
+      void reset () { count = 0; _visibleDone = False; }
+
+      HandleContainer updated;
+      Int32 count;
+      Boolean visibleFirst;
+
+   protected:
+      Boolean _visibleDone;
+};
+
+};
+
+
+int
+main (int argc, char *argv[]) {
+
+   Test test ("dmzObjectUpdateQueueTest", argc, argv);
+
+   ObjectUpdateQueue queue;
+
+   test.validate (
+      "Queue an object",
+      queue.queue_object (1, 1.0) && queue.is_queued (1) && (queue.get_count () == 1));
+
+   test.validate (
+      "Queueing an object again is coalesced",
+      !queue.queue_object (1, 1.5) && (queue.get_count () == 1) &&
+      (queue.get_coalesced_count () == 1));
+
+   test.validate (
+      "Remove a queued object",
+      queue.remove_object (1) && !queue.is_queued (1) && !queue.remove_object (1) &&
+      (queue.get_count () == 0));
+
+   TestUpdater updater;
+
+   for (Handle handle = 1; handle <= ObjectCount; handle++) {
+
+      queue.queue_object (handle, 1.0);
+   }
+
+   queue.set_budget (0.005);
+
+   const Int32 FirstCount (queue.update (2.0, updater));
+
+   test.validate (
+      "Visible objects are updated before the budget is used up",
+      updater.visibleFirst && (FirstCount == updater.count) &&
+      (FirstCount >= ((ObjectCount / 10) + 64)) && (FirstCount < ObjectCount) &&
+      !queue.is_queued (ObjectCount) &&
+      (queue.get_count () == (ObjectCount - FirstCount)) &&
+      (queue.get_deferred_count () == UInt64 (ObjectCount - FirstCount)));
+
+   test.validate (
+      "Lag is measured from the time an object was queued",
+      (queue.get_update_count () == UInt64 (FirstCount)) &&
+      (queue.get_max_lag () == 1.0) && (queue.get_average_lag () == 1.0));
+
+   Int32 frames (1);
+
+   while (queue.get_count () && (frames < ObjectCount)) {
+
+      queue.update (Float64 (frames + 2), updater);
+      frames++;
+   }
+
+   test.validate (
+      "Deferred objects are updated in the following frames",
+      (frames > 1) && (updater.count == ObjectCount) &&
+      (updater.updated.get_count () == ObjectCount) &&
+      (queue.get_update_count () == UInt64 (ObjectCount)) &&
+      (queue.get_max_lag () >= 2.0) && (queue.get_average_lag () > 1.0));
+
+   queue.reset_counters ();
+   queue.set_budget (0.0);
+   updater.reset ();
+
+   for (Handle handle = 1; handle <= ObjectCount; handle++) {
+
+      queue.queue_object (handle, 10.0);
+   }
+
+   test.validate (
+      "A budget of zero updates every queued object",
+      (queue.update (10.5, updater) == ObjectCount) && (queue.get_count () == 0) &&
+      (queue.get_deferred_count () == 0) && (queue.get_coalesced_count () == 0) &&
+      (queue.get_max_lag () == 0.5));
+
+   queue.queue_object (1, 11.0);
+   queue.clear ();
+
+   test.validate (
+      "Clear empties the queue without updating",
+      (queue.get_count () == 0) && (queue.update (12.0, updater) == 0));
+
+   return test.result ();
+}
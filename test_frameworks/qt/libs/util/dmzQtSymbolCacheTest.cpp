@@ -0,0 +1,156 @@
+#include <dmzQtSymbolCache.h>
+#include <dmzSystem.h>
+#include <dmzTypesString.h>
+#include <dmzTest.h>
+#include <QtGui/QApplication>
+#include <QtGui/QPainter>
+#include <QtCore/QFile>
+#include <QtSvg/QSvgRenderer>
+
+using namespace dmz;
+
+namespace {
+
+// Matches the dense displays the cache is meant for.
+static const Int32 SymbolCount = 20000;
+static const int CanvasSize = 1024;
+
+static const char SymbolData[] =
+   "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"32\" height=\"24\">"
+   "<rect x=\"1\" y=\"1\" width=\"30\" height=\"22\" fill=\"#80e0ff\" stroke=\"black\"/>"
+   "<path d=\"M 4 20 L 16 4 L 28 20 Z\" fill=\"none\" stroke=\"black\"/>"
+   "</svg>";
+
+static Boolean
+local_write (const String &FileName, const char *Data) {
+
+   QFile file (FileName.get_buffer ());
+
+   Boolean result (file.open (QIODevice::WriteOnly | QIODevice::Truncate));
+
+   if (result) { result = file.write (Data) > 0; file.close (); }
+
+   return result;
+}
+
+
+static QPointF
+local_position (const Int32 Index) {
+
+   return QPointF ((Index * 37) % (CanvasSize - 32), (Index * 101) % (CanvasSize - 24));
+}
+
+};
+
+
+int
+main (int argc, char *argv[]) {
+
+   Test test ("dmzQtSymbolCacheTest", argc, argv);
+
+   // The GUI is disabled so the test runs without a display.
+   QApplication app (argc, argv, false);
+
+   const String FileName ("dmzQtSymbolCacheTest.svg");
+
+   test.validate ("Write symbol file", local_write (FileName, SymbolData));
+
+   QtSymbolCache cache;
+
+   test.validate (
+      "Scale buckets",
+      (QtSymbolCache::get_scale_bucket (1.0) == 0) &&
+      (QtSymbolCache::get_scale_bucket (1.2) == 1) &&
+      (QtSymbolCache::get_scale_bucket (2.0) == 2) &&
+      (QtSymbolCache::get_scale_bucket (0.5) == -2) &&
+      (QtSymbolCache::get_bucket_scale (QtSymbolCache::get_scale_bucket (1.2)) >= 1.2));
+
+   QSvgRenderer *renderer (cache.lookup_renderer (FileName));
+
+   test.validate (
+      "Shared renderer",
+      renderer && (cache.lookup_renderer (FileName) == renderer) &&
+      (cache.get_miss_count () == 1) && (cache.get_hit_count () == 1));
+
+   test.validate (
+      "Missing file",
+      !cache.lookup_renderer ("dmzQtSymbolCacheTestMissing.svg") &&
+      cache.lookup_symbol ("dmzQtSymbolCacheTestMissing.svg", 1.0).isNull ());
+
+   cache.reset_counts ();
+
+   const QImage Image (cache.lookup_symbol (FileName, 1.0));
+   const QImage Large (cache.lookup_symbol (FileName, 2.0));
+
+   test.validate (
+      "Rasterize symbol",
+      (Image.width () == 32) && (Image.height () == 24) &&
+      (Large.width () == 64) && (Large.height () == 24 * 2) &&
+      (cache.get_image_count () == 2) &&
+      (cache.get_miss_count () == 2) &&
+      (cache.get_byte_count () == (32 * 24 * 4) + (64 * 48 * 4)));
+
+   test.validate (
+      "Symbols in the same bucket share an image",
+      (cache.lookup_symbol (FileName, 0.9).cacheKey () == Image.cacheKey ()) &&
+      (cache.get_hit_count () == 1) && (cache.get_image_count () == 2));
+
+   cache.set_max_image_bytes (64 * 48 * 4);
+
+   test.validate (
+      "Image byte limit",
+      (cache.get_image_count () == 0) &&
+      !cache.lookup_symbol (FileName, 2.0).isNull () &&
+      (cache.get_image_count () == 1) &&
+      !cache.lookup_symbol (FileName, 1.0).isNull () &&
+      (cache.get_image_count () == 1));
+
+   cache.set_max_image_bytes (64 * 1024 * 1024);
+
+   QImage canvas (CanvasSize, CanvasSize, QImage::Format_ARGB32_Premultiplied);
+   const QSizeF Size (cache.get_symbol_size (FileName));
+
+   canvas.fill (0);
+   QPainter painter (&canvas);
+
+   Float64 start (get_time ());
+
+   for (Int32 ix = 0; ix < SymbolCount; ix++) {
+
+      renderer->render (&painter, QRectF (local_position (ix), Size));
+   }
+
+   const Float64 RenderTime (get_time () - start);
+
+   cache.reset_counts ();
+   start = get_time ();
+
+   for (Int32 ix = 0; ix < SymbolCount; ix++) {
+
+      painter.drawImage (
+         QRectF (local_position (ix), Size),
+         cache.lookup_symbol (FileName, 1.0));
+   }
+
+   const Float64 CacheTime (get_time () - start);
+
+   painter.end ();
+
+   test.log.out << "Draw " << SymbolCount << " symbols: renderer "
+      << RenderTime * 1.0e3 << " ms, cache " << CacheTime * 1.0e3 << " ms" << endl;
+
+   test.validate (
+      "Cached symbols are rasterized once",
+      (cache.get_miss_count () <= 1) &&
+      (cache.get_hit_count () >= UInt64 (SymbolCount - 1)));
+
+   cache.clear ();
+
+   test.validate (
+      "Clear cache",
+      (cache.get_image_count () == 0) && (cache.get_byte_count () == 0));
+
+   QFile::remove (FileName.get_buffer ());
+
+   return test.result ();
+}
@@ -0,0 +1,312 @@
+#include <dmzQtTileCache.h>
+#include <dmzSystem.h>
+#include <dmzTypesString.h>
+#include <dmzTest.h>
+#include <QtCore/QByteArray>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+
+using namespace dmz;
+
+namespace {
+
+// A local file tile source stands in for a slow tile server.
+static const Int32 SourceZoom = 5;
+static const Int32 SourceSize = 1 << SourceZoom;
+static const Int32 TileBytes = 1024;
+static const Int32 ViewWidth = 4;
+static const Int32 ViewHeight = 3;
+static const Int32 FrameCount = 400;
+static const Float64 FrameTime = 0.1;
+static const Float64 PanSpeed = 2.0;
+static const Int32 PrefetchPerFrame = 4;
+
+static const String SourceDir ("dmzQtTileCacheTest/source");
+static const String CacheDir ("dmzQtTileCacheTest/cache");
+
+
+static String
+local_tile_name (const Int32 Zoom, const Int32 X, const Int32 Y) {
+
+   String result;
+   result << Zoom << "-" << X << "-" << Y << ".png";
+   return result;
+}
+
+
+static String
+local_source_path (const Int32 Zoom, const Int32 X, const Int32 Y) {
+
+   String result (SourceDir);
+   result << "/" << Zoom << "/" << X << "/" << Y << ".png";
+   return result;
+}
+
+
+static Boolean
+local_write (const String &Path, const QByteArray &Data) {
+
+   QFile file (Path.get_buffer ());
+
+   Boolean result (file.open (QIODevice::WriteOnly | QIODevice::Truncate));
+
+   if (result) { result = file.write (Data) == Data.size (); file.close (); }
+
+   return result;
+}
+
+
+static Boolean
+local_create_source () {
+
+   Boolean result (True);
+
+   QDir dir;
+
+   for (Int32 zoom = SourceZoom - 1; zoom <= SourceZoom + 1; zoom++) {
+
+      const Int32 Size (1 << zoom);
+
+      for (Int32 ix = 0; result && (ix < Size); ix++) {
+
+         String path (SourceDir);
+         path << "/" << zoom << "/" << ix;
+
+         result = dir.mkpath (path.get_buffer ());
+
+         for (Int32 jy = 0; result && (jy < Size); jy++) {
+
+            QByteArray data (TileBytes, char ((ix * 31 + jy * 7 + zoom) & 0xFF));
+            result = local_write (local_source_path (zoom, ix, jy), data);
+         }
+      }
+   }
+
+   return result;
+}
+
+
+static Boolean
+local_fetch (QtTileCache &cache, const Int32 Zoom, const Int32 X, const Int32 Y) {
+
+   Boolean result (False);
+
+   QFile file (local_source_path (Zoom, X, Y).get_buffer ());
+
+   if (file.open (QIODevice::ReadOnly)) {
+
+      result = cache.store_tile (local_tile_name (Zoom, X, Y), file.readAll ());
+      file.close ();
+   }
+
+   return result;
+}
+
+
+// Pans a view across the source and returns the number of tiles the view had to wait
+// for because they were not in the cache.
+static Int32
+local_pan (QtTileCache &cache, const Boolean Prefetch, Int32 &prefetched) {
+
+   Int32 result (0);
+   prefetched = 0;
+
+   cache.clear ();
+   cache.clear_prefetch ();
+
+   Float64 posX (0.0);
+   Float64 velocityX (PanSpeed);
+   const Int32 MinY (SourceSize / 2);
+
+   for (Int32 frame = 0; frame < FrameCount; frame++) {
+
+      const Int32 MinX ((Int32)posX);
+
+      for (Int32 ix = MinX; ix < MinX + ViewWidth; ix++) {
+
+         for (Int32 jy = MinY; jy < MinY + ViewHeight; jy++) {
+
+            QByteArray data;
+
+            if (!cache.load_tile (local_tile_name (SourceZoom, ix, jy), data)) {
+
+               local_fetch (cache, SourceZoom, ix, jy);
+               result++;
+            }
+         }
+      }
+
+      if (Prefetch) {
+
+         cache.plan_prefetch (
+            SourceZoom,
+            MinX,
+            MinY,
+            MinX + ViewWidth - 1,
+            MinY + ViewHeight - 1,
+            velocityX,
+            0.0,
+            SourceZoom - 1,
+            SourceZoom + 1);
+
+         Int32 zoom (0), x (0), y (0);
+
+         for (Int32 count = 0;
+               (count < PrefetchPerFrame) && cache.get_next_prefetch (zoom, x, y);
+               count++) {
+
+            if (!cache.contains_tile (local_tile_name (zoom, x, y))) {
+
+               local_fetch (cache, zoom, x, y);
+               prefetched++;
+            }
+         }
+      }
+
+      posX += velocityX * FrameTime;
+
+      // Bounce off the edges of the source.
+      if ((posX + ViewWidth) > SourceSize) {
+
+         posX = Float64 (SourceSize - ViewWidth);
+         velocityX = -PanSpeed;
+      }
+      else if (posX < 0.0) { posX = 0.0; velocityX = PanSpeed; }
+   }
+
+   return result;
+}
+
+};
+
+
+int
+main (int argc, char *argv[]) {
+
+   Test test ("dmzQtTileCacheTest", argc, argv);
+
+   test.validate ("Create local tile source", local_create_source ());
+
+   QtTileCache cache;
+
+   test.validate (
+      "Open cache directory",
+      cache.set_directory (CacheDir) && (cache.get_directory () == CacheDir));
+
+   cache.clear ();
+   cache.set_max_disk_bytes (TileBytes * 10);
+
+   for (Int32 ix = 0; ix < 10; ix++) { local_fetch (cache, SourceZoom, ix, 0); }
+
+   QByteArray data;
+
+   test.validate (
+      "Store and load tiles",
+      (cache.get_tile_count () == 10) &&
+      (cache.get_disk_bytes () == (TileBytes * 10)) &&
+      cache.load_tile (local_tile_name (SourceZoom, 0, 0), data) &&
+      (data.size () == TileBytes) &&
+      !cache.load_tile (local_tile_name (SourceZoom, 0, 1), data) &&
+      (cache.get_hit_count () == 1) && (cache.get_miss_count () == 1));
+
+   local_fetch (cache, SourceZoom, 10, 0);
+
+   test.validate (
+      "Least recently used tile is evicted",
+      (cache.get_tile_count () == 10) &&
+      (cache.get_evict_count () == 1) &&
+      cache.contains_tile (local_tile_name (SourceZoom, 0, 0)) &&
+      !cache.contains_tile (local_tile_name (SourceZoom, 1, 0)) &&
+      !QFile::exists (
+         (CacheDir + "/" + local_tile_name (SourceZoom, 1, 0)).get_buffer ()));
+
+   local_write (CacheDir + "/external.png", QByteArray (TileBytes, 'x'));
+   QFile::remove ((CacheDir + "/" + local_tile_name (SourceZoom, 2, 0)).get_buffer ());
+
+   test.validate (
+      "Rescan finds external changes",
+      cache.rescan () &&
+      cache.contains_tile ("external.png") &&
+      !cache.contains_tile (local_tile_name (SourceZoom, 2, 0)) &&
+      (cache.get_tile_count () == 10) &&
+      (cache.get_disk_bytes () == (TileBytes * 10)));
+
+   QtTileCache reopened;
+   reopened.set_max_disk_bytes (0);
+
+   test.validate (
+      "Reopen cache directory",
+      reopened.set_directory (CacheDir) && (reopened.get_tile_count () == 10));
+
+   cache.set_max_disk_bytes (TileBytes * 4);
+
+   test.validate (
+      "Lower byte limit trims the store",
+      (cache.get_tile_count () == 4) && (cache.get_disk_bytes () == (TileBytes * 4)));
+
+   cache.set_prefetch_time (1.0);
+   cache.set_prefetch_margin (1);
+
+   const Int32 Planned (
+      cache.plan_prefetch (SourceZoom, 10, 10, 12, 12, 4.0, 0.0, 0, SourceZoom + 1));
+
+   Int32 zoom (0), x (0), y (0);
+
+   const Boolean First (cache.get_next_prefetch (zoom, x, y));
+
+   Boolean inView (False);
+   Int32 lower (0), higher (0), returned (First ? 1 : 0);
+
+   while (cache.get_next_prefetch (zoom, x, y)) {
+
+      returned++;
+
+      if ((zoom == SourceZoom) && (x >= 10) && (x <= 12) && (y >= 10) && (y <= 12)) {
+
+         inView = True;
+      }
+      else if (zoom == (SourceZoom - 1)) { lower++; }
+      else if (zoom == (SourceZoom + 1)) { higher++; }
+   }
+
+   test.validate (
+      "Prefetch plan leads the view",
+      (Planned > 0) && (returned == Planned) && First && !inView &&
+      (lower == 4) && (higher > 0));
+
+   test.validate (
+      "Prefetched tiles are only returned once",
+      (cache.plan_prefetch (
+         SourceZoom, 10, 10, 12, 12, 4.0, 0.0, 0, SourceZoom + 1) == 0) &&
+      !cache.get_next_prefetch (zoom, x, y));
+
+   cache.set_max_disk_bytes (TileBytes * 256);
+   cache.set_prefetch_time (2.0);
+
+   Int32 prefetched (0);
+
+   Float64 start (get_time ());
+   const Int32 Stalls (local_pan (cache, False, prefetched));
+   const Float64 Time (get_time () - start);
+
+   start = get_time ();
+   const Int32 PrefetchStalls (local_pan (cache, True, prefetched));
+   const Float64 PrefetchTime (get_time () - start);
+
+   test.log.out << "Pan " << FrameCount << " frames: " << Stalls << " stalled tiles in "
+      << Time * 1.0e3 << " ms without prefetch, " << PrefetchStalls
+      << " stalled tiles and " << prefetched << " prefetched tiles in "
+      << PrefetchTime * 1.0e3 << " ms with prefetch" << endl;
+
+   test.validate (
+      "Prefetch reduces stalled tiles",
+      (PrefetchStalls < Stalls) && (cache.get_disk_bytes () <= (TileBytes * 256)));
+
+   cache.clear ();
+
+   test.validate (
+      "Clear cache",
+      (cache.get_tile_count () == 0) && (cache.get_disk_bytes () == 0));
+
+   return test.result ();
+}
@@ -0,0 +1,336 @@
+#include <dmzRenderIsect.h>
+#include <dmzRenderIsectBVH.h>
+#include <dmzSystem.h>
+#include <dmzTypesBase.h>
+#include <dmzTypesString.h>
+#include <dmzTypesVector.h>
+#include <dmzTest.h>
+
+#include <math.h>
+
+using namespace dmz;
+
+namespace {
+
+static const UInt32 StaticMask = 0x01;
+static const UInt32 EntityMask = 0x02;
+static const Int32 GridSize = 256;
+static const Float64 CellSize = 4.0;
+static const Int32 RayCount = 10000;
+static const Int32 Frames = 20;
+static const Vector Down (0.0, -1.0, 0.0);
+
+
+static Float64
+local_height (const Int32 X, const Int32 Z) {
+
+   return (sin (Float64 (X) * 0.11) * 12.0) + (cos (Float64 (Z) * 0.07) * 9.0) +
+      Float64 ((X * 7 + Z * 13) % 5) * 0.25;
+}
+
+
+static Vector
+local_vertex (const Int32 X, const Int32 Z) {
+
+   return Vector (Float64 (X) * CellSize, local_height (X, Z), Float64 (Z) * CellSize);
+}
+
+
+static void
+local_build_terrain (IsectBVH &bvh) {
+
+   for (Int32 x = 0; x < GridSize; x++) {
+
+      for (Int32 z = 0; z < GridSize; z++) {
+
+         const Vector P00 (local_vertex (x, z));
+         const Vector P10 (local_vertex (x + 1, z));
+         const Vector P01 (local_vertex (x, z + 1));
+         const Vector P11 (local_vertex (x + 1, z + 1));
+
+         bvh.add_triangle (P00, P01, P10, StaticMask, IsectPolygonBackCulledMask);
+         bvh.add_triangle (P11, P10, P01, StaticMask, IsectPolygonBackCulledMask);
+      }
+   }
+}
+
+
+// Height of the terrain triangles at a point computed directly from the grid.
+static Float64
+local_terrain_height (const Float64 X, const Float64 Z) {
+
+   const Int32 CellX (Int32 (X / CellSize));
+   const Int32 CellZ (Int32 (Z / CellSize));
+   const Float64 U ((X / CellSize) - Float64 (CellX));
+   const Float64 V ((Z / CellSize) - Float64 (CellZ));
+
+   const Float64 H00 (local_height (CellX, CellZ));
+   const Float64 H10 (local_height (CellX + 1, CellZ));
+   const Float64 H01 (local_height (CellX, CellZ + 1));
+   const Float64 H11 (local_height (CellX + 1, CellZ + 1));
+
+   return (U + V) <= 1.0 ?
+      H00 + ((H10 - H00) * U) + ((H01 - H00) * V) :
+      H11 + ((H01 - H11) * (1.0 - U)) + ((H10 - H11) * (1.0 - V));
+}
+
+
+// Simple linear congruential generator so every run uses the same positions.
+static Float64
+local_random (UInt32 &seed) {
+
+   seed = (seed * 1664525u) + 1013904223u;
+   return Float64 (seed >> 8) / Float64 (1u << 24);
+}
+
+
+static void
+local_place_entities (Vector *positions, const Int32 Count, const Int32 Frame) {
+
+   UInt32 seed (12345u + UInt32 (Frame));
+   const Float64 Size (Float64 (GridSize) * CellSize);
+
+   for (Int32 ix = 0; ix < Count; ix++) {
+
+      const Float64 X (local_random (seed) * Size);
+      const Float64 Z (local_random (seed) * Size);
+      positions[ix].set_xyz (X, local_terrain_height (X, Z), Z);
+   }
+}
+
+
+static void
+local_set_tests (
+      const Vector *Positions,
+      const Int32 Count,
+      IsectTestContainer &tests) {
+
+   const Vector Offset (0.0, 1.5, 0.0);
+
+   for (Int32 ix = 0; ix < Count; ix++) {
+
+      tests.set_test (UInt32 (ix + 1), IsectRayTest, Positions[ix] + Offset, Down);
+   }
+}
+
+
+static Boolean
+local_validate_ground (
+      const Vector *Positions,
+      const Int32 Count,
+      const IsectResultContainer &Results,
+      const Boolean OnePerTest) {
+
+   Boolean result (OnePerTest ? Results.get_result_count () == Count : True);
+
+   IsectResult value;
+   Boolean found (Results.get_first (value));
+
+   while (found && result) {
+
+      Vector point, normal;
+      Float64 distance (0.0);
+      Handle object (0);
+      const UInt32 TestID (value.get_isect_test_id ());
+
+      result = (TestID > 0) && (TestID <= UInt32 (Count)) &&
+         value.get_point (point) && value.get_normal (normal) &&
+         value.get_distance (distance) && value.get_object_handle (object) && !object;
+
+      if (result) {
+
+         const Vector &Pos (Positions[TestID - 1]);
+
+         result = (fabs (point.get_y () - Pos.get_y ()) < 1.0e-6) &&
+            (fabs (point.get_x () - Pos.get_x ()) < 1.0e-9) &&
+            (fabs (point.get_z () - Pos.get_z ()) < 1.0e-9) &&
+            (fabs (distance - 1.5) < 1.0e-6) &&
+            (fabs (normal.magnitude () - 1.0) < 1.0e-9);
+      }
+
+      found = Results.get_next (value);
+   }
+
+   return result;
+}
+
+};
+
+
+int
+main (int argc, char *argv[]) {
+
+   Test test ("dmzRenderIsectBVHBenchmark", argc, argv);
+
+   IsectBVH bvh;
+
+   Float64 start (get_time ());
+   local_build_terrain (bvh);
+
+   IsectParameters closest;
+   closest.set_test_result_type (IsectClosestPoint);
+
+   IsectParameters all;
+
+   IsectTestContainer tests;
+   IsectResultContainer results;
+
+   // The first isect builds the hierarchy.
+   tests.set_test (1, IsectRayTest, Vector (10.0, 100.0, 10.0), Down);
+   bvh.do_isect (closest, tests, StaticMask, results);
+   test.report_time ("Build terrain hierarchy", start, bvh.get_triangle_count (), "test");
+
+   test.validate (
+      "Terrain triangles stored",
+      bvh.get_triangle_count () == (GridSize * GridSize * 2));
+
+   // ============================================================================ //
+   // <object bounds>
+
+   const Vector BoxMin (100.0, 40.0, 100.0);
+   const Vector BoxMax (104.0, 44.0, 108.0);
+   const Vector Offset (20.0, 0.0, 0.0);
+
+   test.validate (
+      "Store object bounds",
+      bvh.store_bounds (7, BoxMin, BoxMax, EntityMask) &&
+      bvh.store_bounds (8, BoxMin + Offset, BoxMax + Offset, EntityMask) &&
+      !bvh.store_bounds (0, BoxMin, BoxMax, EntityMask) &&
+      (bvh.get_bounds_count () == 2));
+
+   tests.clear ();
+   tests.set_segment_test (
+      1,
+      Vector (102.0, 100.0, 104.0),
+      Vector (102.0, -100.0, 104.0));
+   results.clear ();
+
+   Vector point, normal;
+   Handle object (0);
+   IsectResult value;
+
+   test.validate (
+      "Segment hits top of object bounds first",
+      bvh.do_isect (closest, tests, StaticMask | EntityMask, results) &&
+      results.get_first (value) && value.get_point (point) &&
+      value.get_normal (normal) && value.get_object_handle (object) &&
+      (object == 7) && (point - Vector (102.0, 44.0, 104.0)).is_zero () &&
+      (normal - Vector (0.0, 1.0, 0.0)).is_zero ());
+
+   results.clear ();
+
+   test.validate (
+      "All points returns the terrain and the object bounds",
+      bvh.do_isect (all, tests, StaticMask | EntityMask, results) &&
+      (results.get_result_count () == 2));
+
+   results.clear ();
+   bvh.enable_bounds (7, False);
+
+   test.validate (
+      "Disabled object bounds are ignored",
+      bvh.do_isect (all, tests, StaticMask | EntityMask, results) &&
+      (results.get_result_count () == 1));
+
+   results.clear ();
+   bvh.enable_bounds (7, True);
+   const Vector Move (0.0, 2.0, 0.0);
+   bvh.store_bounds (7, BoxMin + Move, BoxMax + Move, EntityMask);
+
+   test.validate (
+      "Moved object bounds are refit",
+      bvh.do_isect (closest, tests, EntityMask, results) &&
+      results.get_first (value) && value.get_point (point) &&
+      (point - Vector (102.0, 46.0, 104.0)).is_zero ());
+
+   results.clear ();
+   const Vector Away (0.0, 300.0, 0.0);
+   bvh.store_bounds (7, BoxMin + Away, BoxMax + Away, EntityMask);
+
+   test.validate (
+      "Object bounds outside the segment are missed",
+      !bvh.do_isect (all, tests, EntityMask, results));
+
+   test.validate (
+      "Remove object bounds",
+      bvh.remove_bounds (7) && !bvh.remove_bounds (7) && (bvh.get_bounds_count () == 1));
+
+   bvh.remove_bounds (8);
+
+   // </object bounds>
+   // ============================================================================ //
+   // <ground clamp>
+
+   Vector *positions (new Vector[RayCount]);
+
+   local_place_entities (positions, RayCount, 0);
+   tests.clear ();
+   local_set_tests (positions, RayCount, tests);
+   results.clear ();
+
+   bvh.do_isect (closest, tests, StaticMask, results);
+   test.validate (
+      "Closest point ground clamp",
+      local_validate_ground (positions, RayCount, results, True));
+
+   results.clear ();
+   bvh.do_isect (all, tests, StaticMask, results);
+   test.validate (
+      "All points ground clamp",
+      (results.get_result_count () >= RayCount) &&
+      local_validate_ground (positions, RayCount, results, False));
+
+   const Int32 ThreadCounts[] = { 1, 4 };
+
+   for (Int32 ix = 0; ix < 2; ix++) {
+
+      bvh.set_thread_count (ThreadCounts[ix]);
+
+      Boolean valid (True);
+      Float64 elapsed (0.0);
+
+      for (Int32 frame = 0; frame < Frames; frame++) {
+
+         local_place_entities (positions, RayCount, frame);
+         local_set_tests (positions, RayCount, tests);
+         results.clear ();
+
+         const Float64 FrameStart (get_time ());
+         bvh.do_isect (closest, tests, StaticMask, results);
+         elapsed += get_time () - FrameStart;
+
+         valid = valid && local_validate_ground (positions, RayCount, results, True);
+      }
+
+      String name ("Batched ground clamp, threads ");
+      name << ThreadCounts[ix];
+      test.report_time (name, get_time () - elapsed, RayCount * Frames, "test");
+      test.validate (name, valid);
+   }
+
+   // One test per call is how ground clamping was done before batching.
+   bvh.set_thread_count (1);
+   local_place_entities (positions, RayCount, 0);
+   IsectTestContainer single;
+   IsectResultContainer singleResults;
+   Boolean valid (True);
+
+   start = get_time ();
+
+   for (Int32 ix = 0; ix < RayCount; ix++) {
+
+      single.set_test (1, IsectRayTest, positions[ix] + Vector (0.0, 1.5, 0.0), Down);
+      singleResults.clear ();
+      valid = bvh.do_isect (closest, single, StaticMask, singleResults) && valid;
+   }
+
+   test.report_time ("One ground clamp test per call", start, RayCount, "test");
+   test.validate ("One ground clamp test per call", valid);
+
+   delete []positions; positions = 0;
+
+   // </ground clamp>
+   // ============================================================================ //
+
+   return test.result ();
+}
@@ -0,0 +1,216 @@
+#include <dmzRenderIsectHeightField.h>
+#include <dmzSystemFile.h>
+#include <dmzTypesMath.h>
+#include <dmzTypesString.h>
+#include <dmzTypesVector.h>
+#include <dmzTest.h>
+
+#include <math.h>
+#include <stdio.h>
+
+using namespace dmz;
+
+namespace {
+
+static const Int32 Columns = 130;
+static const Int32 Rows = 100;
+static const Float64 IntervalX = 2.0;
+static const Float64 IntervalZ = 4.0;
+static const Vector Origin (-10.0, 5.0, 20.0);
+static const char FileName[] = "dmzRenderIsectHeightFieldTest.raw";
+
+// The samples of a plane are reproduced exactly by bilinear interpolation.
+static Float64
+local_plane (const Float64 X, const Float64 Z) { return (0.5 * X) - (0.25 * Z) + 3.0; }
+
+
+static Boolean
+local_validate_plane (const IsectHeightField &Field, const Vector &Value) {
+
+   Vector point, normal;
+
+   const Vector Normal (Vector (-0.5, 1.0, 0.25).normalize ());
+   const Float64 Height (local_plane (Value.get_x (), Value.get_z ()) + Origin.get_y ());
+
+   return Field.get_point (Value, point, normal) &&
+      (fabs (point.get_y () - Height) < 1.0e-4) &&
+      is_zero64 (point.get_x () - Value.get_x ()) &&
+      is_zero64 (point.get_z () - Value.get_z ()) &&
+      (normal - Normal).is_zero (1.0e-5);
+}
+
+
+static Vector
+local_grid_point (const Float64 Column, const Float64 Row) {
+
+   return Vector (
+      Origin.get_x () + (Column * IntervalX),
+      0.0,
+      Origin.get_z () + (Row * IntervalZ));
+}
+
+
+static Boolean
+local_write_raw () {
+
+   Boolean result (False);
+
+   FILE *file (open_file (FileName, "wb"));
+
+   if (file) {
+
+      result = True;
+
+      for (Int32 row = 0; row < Rows; row++) {
+
+         for (Int32 column = 0; column < Columns; column++) {
+
+            const UInt16 Value (UInt16 ((row * Columns) + column));
+            const unsigned char Data[2] = {
+               (unsigned char)(Value & 0xFF),
+               (unsigned char)(Value >> 8),
+            };
+
+            if (fwrite (Data, 1, 2, file) != 2) { result = False; }
+         }
+      }
+
+      close_file (file);
+   }
+
+   return result;
+}
+
+};
+
+
+int
+main (int argc, char *argv[]) {
+
+   Test test ("dmzRenderIsectHeightFieldTest", argc, argv);
+
+   IsectHeightField field;
+
+   test.validate (
+      "Height field requires two samples per axis",
+      !field.create (Origin, 1, Rows, IntervalX, IntervalZ) &&
+      !field.create (Origin, Columns, Rows, 0.0, IntervalZ) &&
+      field.create (Origin, Columns, Rows, IntervalX, IntervalZ) &&
+      (field.get_column_count () == Columns) && (field.get_row_count () == Rows) &&
+      (field.get_tile_count () == 6) && (field.get_loaded_tile_count () == 0));
+
+   Vector point, normal;
+
+   test.validate (
+      "Empty height field is flat",
+      field.get_point (local_grid_point (3.5, 7.25), point, normal) &&
+      is_zero64 (point.get_y () - Origin.get_y ()) &&
+      (normal - Vector (0.0, 1.0, 0.0)).is_zero () &&
+      (field.get_loaded_tile_count () == 0));
+
+   for (Int32 row = 0; row < Rows; row++) {
+
+      for (Int32 column = 0; column < Columns; column++) {
+
+         const Vector Pos (local_grid_point (column, row));
+         field.set_height (column, row, local_plane (Pos.get_x (), Pos.get_z ()));
+      }
+   }
+
+   test.validate (
+      "Set heights outside of the grid",
+      !field.set_height (-1, 0, 1.0) && !field.set_height (0, Rows, 1.0) &&
+      (field.get_loaded_tile_count () == 6));
+
+   test.validate (
+      "Plane inside a tile",
+      local_validate_plane (field, local_grid_point (10.3, 20.6)));
+
+   test.validate (
+      "Plane across tile edges",
+      local_validate_plane (field, local_grid_point (63.5, 63.75)) &&
+      local_validate_plane (field, local_grid_point (128.0, 64.0)));
+
+   test.validate (
+      "Plane at the far corner of the grid",
+      local_validate_plane (field, local_grid_point (Columns - 1, Rows - 1)));
+
+   test.validate (
+      "Positions outside of the grid",
+      !field.contains (local_grid_point (-0.01, 5.0)) &&
+      !field.contains (local_grid_point (5.0, Rows - 0.99)) &&
+      field.contains (local_grid_point (0.0, 0.0)) &&
+      !field.get_point (local_grid_point (Columns, 5.0), point, normal));
+
+   // Bilinear interpolation of a single raised sample.
+   field.create (Origin, Columns, Rows, IntervalX, IntervalZ);
+   field.set_height (11, 21, 8.0);
+
+   test.validate (
+      "Bilinear interpolation",
+      field.get_point (local_grid_point (10.5, 20.25), point, normal) &&
+      is_zero64 (point.get_y () - (Origin.get_y () + (8.0 * 0.5 * 0.25))) &&
+      (normal.get_x () < 0.0) && (normal.get_z () < 0.0));
+
+   const Int32 Count (4);
+   const Vector Values[Count] = {
+      local_grid_point (11.0, 21.0),
+      local_grid_point (-5.0, 21.0),
+      local_grid_point (0.0, 0.0),
+      local_grid_point (11.0, Rows + 5.0),
+   };
+
+   Vector points[Count], normals[Count];
+   Boolean found[Count];
+
+   test.validate (
+      "Batch lookup",
+      (field.get_points (Count, Values, points, normals, found) == 2) &&
+      found[0] && !found[1] && found[2] && !found[3] &&
+      is_zero64 (points[0].get_y () - (Origin.get_y () + 8.0)) &&
+      is_zero64 (points[2].get_y () - Origin.get_y ()));
+
+   // Raw files are read one tile at a time.
+   test.validate ("Write raw height file", local_write_raw ());
+
+   const Float64 Scale (1.0 / 65535.0);
+
+   test.validate (
+      "Raw file smaller than the grid",
+      field.create (Origin, Columns, Rows + 1, IntervalX, IntervalZ) &&
+      !field.load_raw (FileName, IsectHeightUInt16, 0.0, 65535.0) &&
+      !field.load_raw (FileName, IsectHeightFloat32, 0.0, 1.0));
+
+   test.validate (
+      "Load raw height file",
+      field.create (Origin, Columns, Rows, IntervalX, IntervalZ) &&
+      field.load_raw (FileName, IsectHeightUInt16, 0.0, 65535.0) &&
+      (field.get_loaded_tile_count () == 0));
+
+   test.validate (
+      "Raw samples are read on first use",
+      is_zero64 (field.get_height (5, 3) - Float64 ((3 * Columns) + 5)) &&
+      (field.get_loaded_tile_count () == 1) &&
+      is_zero64 (field.get_height (129, 99) - Float64 ((99 * Columns) + 129)) &&
+      (field.get_loaded_tile_count () == 2) &&
+      field.get_point (local_grid_point (64.5, 70.5), point, normal) &&
+      is_zero64 (point.get_y () - (Origin.get_y () + (70.5 * Columns) + 64.5), 1.0e-3) &&
+      (field.get_loaded_tile_count () == 3));
+
+   field.load_raw (FileName, IsectHeightUInt16, -1.0, 1.0);
+
+   test.validate (
+      "Raw samples are scaled",
+      is_zero64 (field.get_height (0, 0) + 1.0) &&
+      is_zero64 (field.get_height (1, 0) - (-1.0 + (2.0 * Scale)), 1.0e-6));
+
+   field.clear ();
+   remove_file (FileName);
+
+   test.validate (
+      "Cleared height field",
+      (field.get_column_count () == 0) && (field.get_loaded_tile_count () == 0) &&
+      !field.get_point (local_grid_point (1.0, 1.0), point, normal));
+
+   return test.result ();
+}
@@ -0,0 +1,310 @@
+#include <dmzRenderClusterIndex.h>
+#include <dmzSystem.h>
+#include <dmzTypesHandleContainer.h>
+#include <dmzTypesString.h>
+#include <dmzTest.h>
+
+using namespace dmz;
+
+namespace {
+
+// Matches a continental map view of a large exercise.
+static const Int32 ObjectCount = 50000;
+static const Int32 GroupCount = 40;
+static const Int32 PanCount = 200;
+static const Float64 ClusterSize = 2.0;
+
+struct PointStruct { Float64 x; Float64 y; };
+
+static UInt32 local_seed = 12345;
+
+static Float64
+local_random () {
+
+   local_seed = (local_seed * 1103515245u) + 12345u;
+   return Float64 ((local_seed >> 8) & 0xFFFF) / 65535.0;
+}
+
+
+static void
+local_apply (
+      const HandleContainer &Shown,
+      const HandleContainer &Hidden,
+      HandleContainer &display) {
+
+   display -= Hidden;
+   display += Shown;
+}
+
+
+static Boolean
+local_matches (
+      const RenderClusterIndex &Index,
+      const PointStruct *List,
+      const Int32 Count,
+      const Float64 MinX,
+      const Float64 MinY,
+      const Float64 MaxX,
+      const Float64 MaxY,
+      const HandleContainer &Display) {
+
+   Boolean result (Display.get_count () == Index.get_shown_count ());
+
+   Int32 inside (0);
+
+   for (Int32 ix = 0; result && (ix < Count); ix++) {
+
+      const Boolean Inside (
+         (List[ix].x >= MinX) && (List[ix].x <= MaxX) &&
+         (List[ix].y >= MinY) && (List[ix].y <= MaxY));
+
+      const Handle Object (Handle (ix + 1));
+
+      if (Inside) { inside++; }
+
+      if (Display.contains (Object) != Index.is_shown (Object)) { result = False; }
+      else if (!Inside && Display.contains (Object)) { result = False; }
+   }
+
+   Int32 clustered (0);
+
+   for (Int32 ix = 0; ix < Index.get_cluster_count (); ix++) {
+
+      Float64 x (0.0), y (0.0);
+      Int32 count (0);
+
+      if (Index.get_cluster (ix, x, y, count)) { clustered += count; }
+   }
+
+   return result && (inside == Index.get_visible_count ()) &&
+      (inside == (clustered + Index.get_shown_count ()));
+}
+
+};
+
+
+int
+main (int argc, char *argv[]) {
+
+   Test test ("dmzRenderClusterIndexTest", argc, argv);
+
+   RenderClusterIndex index;
+   HandleContainer shown, hidden;
+
+   test.validate (
+      "Empty index",
+      (index.get_object_count () == 0) &&
+      !index.update_view (-10.0, -10.0, 10.0, 10.0, 0.0, shown, hidden) &&
+      (shown.get_count () == 0) && (hidden.get_count () == 0) &&
+      !index.update_object (0, 1.0, 1.0));
+
+   index.set_cell_size (10.0);
+   index.set_min_cluster_count (3);
+
+   index.update_object (1, 1.0, 1.0);
+   index.update_object (2, 2.0, 2.0);
+   index.update_object (3, 3.0, 3.0);
+   index.update_object (4, 25.0, 5.0);
+
+   test.validate (
+      "Cull to view",
+      index.update_view (0.0, 0.0, 10.0, 10.0, 0.0, shown, hidden) &&
+      (shown.get_count () == 3) && !shown.contains (4) && (hidden.get_count () == 0) &&
+      (index.get_visible_count () == 3) && (index.get_cluster_count () == 0));
+
+   test.validate (
+      "Unchanged view reports no changes",
+      !index.update_view (0.0, 0.0, 10.0, 10.0, 0.0, shown, hidden) &&
+      (shown.get_count () == 0) && (hidden.get_count () == 0));
+
+   test.validate (
+      "Pan view",
+      index.update_view (20.0, 0.0, 30.0, 10.0, 0.0, shown, hidden) &&
+      (shown.get_count () == 1) && shown.contains (4) &&
+      (hidden.get_count () == 3) && !index.is_shown (1) && index.is_shown (4));
+
+   Float64 x (0.0), y (0.0);
+   Int32 count (0);
+
+   test.validate (
+      "Cluster dense cell",
+      index.update_view (0.0, 0.0, 30.0, 10.0, 20.0, shown, hidden) &&
+      (shown.get_count () == 0) && (hidden.get_count () == 0) &&
+      (index.get_shown_count () == 1) && (index.get_cluster_count () == 1) &&
+      index.get_cluster (0, x, y, count) &&
+      (count == 3) && (x == 2.0) && (y == 2.0) &&
+      !index.get_cluster (1, x, y, count));
+
+   index.update_object (5, 4.0, 5.0);
+
+   test.validate (
+      "Object joins cluster",
+      index.update_view (0.0, 0.0, 30.0, 10.0, 20.0, shown, hidden) &&
+      (shown.get_count () == 0) && (hidden.get_count () == 0) &&
+      index.get_cluster (0, x, y, count) && (count == 4) && !index.is_shown (5));
+
+   test.validate (
+      "Zoom in breaks cluster",
+      index.update_view (0.0, 0.0, 10.0, 10.0, 2.0, shown, hidden) &&
+      (shown.get_count () == 4) && (hidden.get_count () == 1) && hidden.contains (4) &&
+      (index.get_cluster_count () == 0));
+
+   test.validate (
+      "Remove object",
+      index.remove_object (5) && !index.remove_object (5) &&
+      (index.get_shown_count () == 3) && (index.get_object_count () == 4) &&
+      !index.update_view (0.0, 0.0, 10.0, 10.0, 2.0, shown, hidden));
+
+   index.clear ();
+
+   test.validate (
+      "Clear index",
+      (index.get_object_count () == 0) && (index.get_shown_count () == 0) &&
+      !index.update_view (0.0, 0.0, 10.0, 10.0, 2.0, shown, hidden));
+
+   // Objects are grouped around a few centers the way forces gather in an exercise.
+   PointStruct *list (new PointStruct[ObjectCount]);
+   PointStruct groups[GroupCount];
+
+   for (Int32 ix = 0; ix < GroupCount; ix++) {
+
+      groups[ix].x = (local_random () * 300.0) - 150.0;
+      groups[ix].y = (local_random () * 140.0) - 70.0;
+   }
+
+   index.set_cell_size (1.0);
+   index.set_min_cluster_count (4);
+
+   Float64 start (get_time ());
+
+   for (Int32 ix = 0; ix < ObjectCount; ix++) {
+
+      const PointStruct &Group (groups[ix % GroupCount]);
+
+      list[ix].x = Group.x + ((local_random () - 0.5) * 20.0);
+      list[ix].y = Group.y + ((local_random () - 0.5) * 10.0);
+      index.update_object (Handle (ix + 1), list[ix].x, list[ix].y);
+   }
+
+   test.log.out << "Index " << ObjectCount << " objects: "
+      << (get_time () - start) * 1.0e3 << " ms" << endl;
+
+   HandleContainer display;
+
+   start = get_time ();
+
+   index.update_view (-180.0, -85.0, 180.0, 85.0, ClusterSize, shown, hidden);
+
+   test.log.out << "Continental view: " << index.get_shown_count () << " shown and "
+      << index.get_cluster_count () << " clusters of " << index.get_visible_count ()
+      << " visible objects in " << (get_time () - start) * 1.0e3 << " ms" << endl;
+
+   local_apply (shown, hidden, display);
+
+   test.validate (
+      "Continental view clusters objects",
+      (index.get_shown_count () < (ObjectCount / 10)) &&
+      local_matches (index, list, ObjectCount, -180.0, -85.0, 180.0, 85.0, display));
+
+   // Pan a regional view across the map at a zoom with smaller clusters.
+   Boolean match (True);
+   Int32 changes (0);
+   Float64 minX (groups[0].x - 10.0);
+   const Float64 MinY (groups[0].y - 6.0);
+   const Float64 Width (20.0);
+   const Float64 Height (12.0);
+   const Float64 Step (0.05);
+
+   start = get_time ();
+
+   for (Int32 ix = 0; ix < PanCount; ix++) {
+
+      index.update_view (
+         minX, MinY, minX + Width, MinY + Height, ClusterSize * 0.125, shown, hidden);
+
+      changes += shown.get_count () + hidden.get_count ();
+      local_apply (shown, hidden, display);
+      minX += Step;
+   }
+
+   const Float64 PanTime (get_time () - start);
+
+   test.log.out << "Pan regional view " << PanCount << " times: "
+      << (PanTime * 1.0e3) / Float64 (PanCount) << " ms/view, "
+      << Float64 (changes) / Float64 (PanCount) << " items changed/view, "
+      << index.get_shown_count () << " shown" << endl;
+
+   minX -= Step;
+
+   test.validate (
+      "Regional view after panning",
+      local_matches (
+         index, list, ObjectCount, minX, MinY, minX + Width, MinY + Height, display));
+
+   // A view without culling or clustering would touch every object.
+   start = get_time ();
+
+   for (Int32 ix = 0; ix < PanCount; ix++) {
+
+      Int32 inside (0);
+
+      for (Int32 jx = 0; jx < ObjectCount; jx++) {
+
+         if ((list[jx].x >= minX) && (list[jx].x <= (minX + Width)) &&
+               (list[jx].y >= MinY) && (list[jx].y <= (MinY + Height))) { inside++; }
+      }
+
+      if (inside != index.get_visible_count ()) { match = False; }
+   }
+
+   test.log.out << "Linear view test: "
+      << ((get_time () - start) * 1.0e3) / Float64 (PanCount) << " ms/view" << endl;
+
+   test.validate ("Visible count matches a linear search", match);
+
+   start = get_time ();
+
+   for (Int32 ix = 0; ix < ObjectCount; ix++) {
+
+      list[ix].x += (local_random () - 0.5) * 0.1;
+      list[ix].y += (local_random () - 0.5) * 0.1;
+      index.update_object (Handle (ix + 1), list[ix].x, list[ix].y);
+   }
+
+   index.update_view (
+      minX, MinY, minX + Width, MinY + Height, ClusterSize * 0.125, shown, hidden);
+
+   local_apply (shown, hidden, display);
+
+   test.log.out << "Move " << ObjectCount << " objects and update view: "
+      << (get_time () - start) * 1.0e3 << " ms" << endl;
+
+   test.validate (
+      "Regional view after moving objects",
+      local_matches (
+         index, list, ObjectCount, minX, MinY, minX + Width, MinY + Height, display));
+
+   index.update_view (
+      groups[1].x - 0.5, groups[1].y - 0.5, groups[1].x + 0.5, groups[1].y + 0.5, 0.0,
+      shown, hidden);
+
+   local_apply (shown, hidden, display);
+
+   test.validate (
+      "Street view shows every object without clusters",
+      (index.get_cluster_count () == 0) &&
+      (index.get_shown_count () == index.get_visible_count ()) &&
+      local_matches (
+         index,
+         list,
+         ObjectCount,
+         groups[1].x - 0.5,
+         groups[1].y - 0.5,
+         groups[1].x + 0.5,
+         groups[1].y + 0.5,
+         display));
+
+   delete []list; list = 0;
+
+   return test.result ();
+}
@@ -0,0 +1,84 @@
+#include <dmzRenderLODPolicy.h>
+#include <dmzTypesMath.h>
+#include <dmzTypesVector.h>
+#include <dmzTest.h>
+
+using namespace dmz;
+
+int
+main (int argc, char *argv[]) {
+
+   Test test ("dmzRenderLODPolicyTest", argc, argv);
+
+   RenderLODPolicy lod;
+
+   const Vector Near (0.0, 0.0, -10.0);
+   const Vector Middle (0.0, 0.0, -150.0);
+   const Vector Far (0.0, 0.0, -600.0);
+
+   test.validate (
+      "Policy without levels uses full detail",
+      (lod.get_level_count () == 1) &&
+      (lod.find_level (Far, 1.0) == 0) &&
+      is_zero64 (lod.get_update_interval (0)) &&
+      lod.is_update_due (0, 1.0, 1.0) &&
+      (lod.get_skipped_count () == 0));
+
+   test.validate (
+      "Add levels",
+      (lod.add_level (0.0, 0.0, 1.0) == 0) &&
+      (lod.add_level (100.0, 0.0, 0.1) == 1) &&
+      (lod.add_level (500.0, 0.001, 0.5) == 2) &&
+      (lod.get_level_count () == 3) &&
+      is_zero64 (lod.get_update_interval (1) - 0.1) &&
+      is_zero64 (lod.get_update_interval (2) - 0.5) &&
+      is_zero64 (lod.get_update_interval (3)));
+
+   test.validate (
+      "Levels by distance",
+      (lod.find_level (Near, 1.0) == 0) &&
+      (lod.find_level (Middle, 1.0) == 1) &&
+      (lod.find_level (Far, 1.0) == 2));
+
+   // With a 90 degree field of view the view's vertical half extent equals the
+   // distance so the screen size is the ratio of the radius and the distance.
+   lod.set_view (Vector (0.0, 0.0, 0.0), 90.0);
+
+   test.validate (
+      "Screen size",
+      is_zero64 (lod.get_screen_size (Middle, 15.0) - 0.1) &&
+      is_zero64 (lod.get_screen_size (Near, 20.0) - 1.0));
+
+   test.validate (
+      "Small objects use a coarser level",
+      (lod.find_level (Near, 0.005) == 2) &&
+      (lod.find_level (Near, 0.5) == 0) &&
+      (lod.find_level (Middle, 1000.0) == 1));
+
+   lod.set_view (Vector (0.0, 0.0, -600.0), 90.0);
+
+   test.validate (
+      "Levels follow the view",
+      (lod.find_level (Far, 1.0) == 0) &&
+      (lod.find_level (Near, 1.0) == 2));
+
+   test.validate (
+      "Update throttling",
+      lod.is_update_due (0, 10.0, 10.0) &&
+      !lod.is_update_due (1, 10.0, 10.05) &&
+      lod.is_update_due (1, 10.0, 10.15) &&
+      !lod.is_update_due (2, 10.0, 10.4) &&
+      lod.is_update_due (2, 10.0, 11.0) &&
+      (lod.get_skipped_count () == 2));
+
+   lod.reset_skipped_count ();
+   lod.clear_levels ();
+
+   test.validate (
+      "Clear levels",
+      (lod.get_skipped_count () == 0) &&
+      (lod.get_level_count () == 1) &&
+      (lod.find_level (Near, 0.005) == 0));
+
+   return test.result ();
+}
@@ -0,0 +1,245 @@
+#include <dmzRenderPickIndex.h>
+#include <dmzSystem.h>
+#include <dmzTypesHandleContainer.h>
+#include <dmzTypesString.h>
+#include <dmzTest.h>
+
+using namespace dmz;
+
+namespace {
+
+// Matches the dense displays the index is meant for.
+static const Int32 ObjectCount = 20000;
+static const Int32 QueryCount = 20000;
+static const Float64 Extent = 1000.0;
+static const Float64 PickRadius = 4.0;
+
+struct PointStruct { Float64 x; Float64 y; };
+
+static UInt32 local_seed = 12345;
+
+static Float64
+local_random () {
+
+   local_seed = (local_seed * 1103515245u) + 12345u;
+   return Float64 ((local_seed >> 8) & 0xFFFF) / 65535.0;
+}
+
+
+static Handle
+local_brute_nearest (
+      const PointStruct *List,
+      const Int32 Count,
+      const Float64 X,
+      const Float64 Y,
+      const Float64 MaxDistance,
+      Float64 &dist2) {
+
+   Handle result (0);
+   dist2 = MaxDistance * MaxDistance;
+
+   for (Int32 ix = 0; ix < Count; ix++) {
+
+      const Float64 Dx (List[ix].x - X);
+      const Float64 Dy (List[ix].y - Y);
+      const Float64 Value ((Dx * Dx) + (Dy * Dy));
+
+      if (Value <= dist2) { dist2 = Value; result = Handle (ix + 1); }
+   }
+
+   return result;
+}
+
+};
+
+
+int
+main (int argc, char *argv[]) {
+
+   Test test ("dmzRenderPickIndexTest", argc, argv);
+
+   RenderPickIndex index;
+   HandleContainer found;
+
+   test.validate (
+      "Empty index",
+      (index.get_object_count () == 0) &&
+      (index.find_nearest (0.0, 0.0, 100.0) == 0) &&
+      (index.find_in_box (-10.0, -10.0, 10.0, 10.0, found) == 0) &&
+      !index.update_object (0, 1.0, 1.0));
+
+   index.set_cell_size (10.0);
+
+   test.validate (
+      "Add objects",
+      index.update_object (1, 1.0, 1.0) &&
+      index.update_object (2, 5.0, 5.0) &&
+      index.update_object (3, -15.0, 2.0) &&
+      (index.get_object_count () == 3) &&
+      (index.get_cell_count () == 2));
+
+   test.validate (
+      "Nearest object",
+      (index.find_nearest (0.0, 0.0, 10.0) == 1) &&
+      (index.find_nearest (6.0, 6.0, 10.0) == 2) &&
+      (index.find_nearest (-9.0, 2.0, 10.0) == 3) &&
+      (index.find_nearest (-9.0, 2.0, 5.0) == 0));
+
+   found.clear ();
+
+   test.validate (
+      "Box select",
+      (index.find_in_box (-20.0, 0.0, 2.0, 3.0, found) == 2) &&
+      found.contains (1) && found.contains (3) && !found.contains (2));
+
+   Float64 x (0.0), y (0.0);
+
+   test.validate (
+      "Move object to a new cell",
+      index.update_object (1, 25.0, 25.0) &&
+      index.lookup_object (1, x, y) && (x == 25.0) && (y == 25.0) &&
+      (index.find_nearest (24.0, 24.0, 2.0) == 1) &&
+      (index.find_nearest (0.0, 0.0, 2.0) == 0) &&
+      (index.get_cell_count () == 3));
+
+   test.validate (
+      "Remove object",
+      index.remove_object (3) && !index.remove_object (3) &&
+      (index.find_nearest (-15.0, 2.0, 1.0) == 0) &&
+      (index.get_object_count () == 2) &&
+      (index.get_cell_count () == 2));
+
+   index.set_cell_size (100.0);
+
+   test.validate (
+      "Change cell size",
+      (index.get_cell_count () == 1) &&
+      (index.find_nearest (24.0, 24.0, 2.0) == 1) &&
+      (index.find_nearest (5.0, 5.0, 1.0) == 2));
+
+   index.clear ();
+
+   test.validate (
+      "Clear index",
+      (index.get_object_count () == 0) && (index.get_cell_count () == 0));
+
+   PointStruct *list (new PointStruct[ObjectCount]);
+
+   index.set_cell_size (PickRadius * 2.0);
+
+   for (Int32 ix = 0; ix < ObjectCount; ix++) {
+
+      list[ix].x = local_random () * Extent;
+      list[ix].y = local_random () * Extent;
+      index.update_object (Handle (ix + 1), list[ix].x, list[ix].y);
+   }
+
+   PointStruct *queries (new PointStruct[QueryCount]);
+
+   for (Int32 ix = 0; ix < QueryCount; ix++) {
+
+      queries[ix].x = local_random () * Extent;
+      queries[ix].y = local_random () * Extent;
+   }
+
+   Boolean match (True);
+
+   for (Int32 ix = 0; ix < QueryCount; ix++) {
+
+      const Handle Result (
+         index.find_nearest (queries[ix].x, queries[ix].y, PickRadius));
+
+      if (Result) {
+
+         Float64 dist2 (0.0);
+
+         local_brute_nearest (
+            list, ObjectCount, queries[ix].x, queries[ix].y, PickRadius, dist2);
+
+         const Float64 Dx (list[Result - 1].x - queries[ix].x);
+         const Float64 Dy (list[Result - 1].y - queries[ix].y);
+
+         if (((Dx * Dx) + (Dy * Dy)) > dist2) { match = False; }
+      }
+   }
+
+   test.validate ("Nearest object matches a linear search", match);
+
+   Int32 hits (0);
+   Float64 start (get_time ());
+
+   for (Int32 ix = 0; ix < QueryCount; ix++) {
+
+      if (index.find_nearest (queries[ix].x, queries[ix].y, PickRadius)) { hits++; }
+   }
+
+   const Float64 IndexTime (get_time () - start);
+
+   Int32 bruteHits (0);
+   start = get_time ();
+
+   for (Int32 ix = 0; ix < QueryCount; ix++) {
+
+      Float64 dist2 (0.0);
+
+      if (local_brute_nearest (
+            list, ObjectCount, queries[ix].x, queries[ix].y, PickRadius, dist2)) {
+
+         bruteHits++;
+      }
+   }
+
+   const Float64 BruteTime (get_time () - start);
+
+   test.log.out << "Nearest object among " << ObjectCount << " objects: index "
+      << (IndexTime * 1.0e6) / Float64 (QueryCount) << " us/query, linear "
+      << (BruteTime * 1.0e6) / Float64 (QueryCount) << " us/query" << endl;
+
+   test.validate ("Nearest object hit count", hits == bruteHits);
+
+   found.clear ();
+
+   const Int32 BoxCount (index.find_in_box (100.0, 200.0, 300.0, 250.0, found));
+
+   Int32 bruteBox (0);
+
+   for (Int32 ix = 0; ix < ObjectCount; ix++) {
+
+      if ((list[ix].x >= 100.0) && (list[ix].x <= 300.0) &&
+            (list[ix].y >= 200.0) && (list[ix].y <= 250.0)) {
+
+         if (found.contains (Handle (ix + 1))) { bruteBox++; }
+         else { bruteBox = -ObjectCount; }
+      }
+   }
+
+   test.validate (
+      "Box select matches a linear search",
+      (BoxCount > 0) && (BoxCount == bruteBox) && (found.get_count () == BoxCount));
+
+   start = get_time ();
+
+   for (Int32 ix = 0; ix < ObjectCount; ix++) {
+
+      list[ix].x += (local_random () - 0.5) * PickRadius;
+      list[ix].y += (local_random () - 0.5) * PickRadius;
+      index.update_object (Handle (ix + 1), list[ix].x, list[ix].y);
+   }
+
+   test.log.out << "Update " << ObjectCount << " object positions: "
+      << (get_time () - start) * 1.0e3 << " ms" << endl;
+
+   Float64 dist2 (0.0);
+
+   const Handle Expected (local_brute_nearest (
+      list, ObjectCount, queries[0].x, queries[0].y, Extent, dist2));
+
+   test.validate (
+      "Nearest object after moving objects",
+      index.find_nearest (queries[0].x, queries[0].y, Extent) == Expected);
+
+   delete []queries; queries = 0;
+   delete []list; list = 0;
+
+   return test.result ();
+}
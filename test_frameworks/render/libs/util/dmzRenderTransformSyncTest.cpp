@@ -0,0 +1,179 @@
+#include <dmzRenderTransformSync.h>
+#include <dmzSystem.h>
+#include <dmzTypesMatrix.h>
+#include <dmzTypesString.h>
+#include <dmzTypesVector.h>
+#include <dmzTest.h>
+
+#include <math.h>
+
+using namespace dmz;
+
+namespace {
+
+static const Int32 ObjectCount = 50000;
+static const Int32 Frames = 20;
+
+// Reference layouts copied from to_osg_matrix_y_up and to_osg_matrix_z_up in
+// dmzRenderUtilOSG.cpp.
+static void
+local_reference (
+      const Boolean ZUp,
+      const Matrix &Ori,
+      const Vector &Pos,
+      const Vector &Scale,
+      Float64 result[16]) {
+
+   const Float64 X (Scale.get_x ()), Y (Scale.get_y ()), Z (Scale.get_z ());
+
+   Float64 d[9];
+   Ori.to_array (d);
+
+   const Float64 YUpValues[16] = {
+      d[0] * X, d[3] * X, d[6] * X, 0.0,
+      d[1] * Y, d[4] * Y, d[7] * Y, 0.0,
+      d[2] * Z, d[5] * Z, d[8] * Z, 0.0,
+      Pos.get_x (), Pos.get_y (), Pos.get_z (), 1.0,
+   };
+
+   const Float64 ZUpValues[16] = {
+      d[0] * X, -d[6] * X, d[3] * X, 0.0,
+      -d[2] * Z, d[8] * Z, -d[5] * Z, 0.0,
+      d[1] * Y, -d[7] * Y, d[4] * Y, 0.0,
+      Pos.get_x (), -Pos.get_z (), Pos.get_y (), 1.0,
+   };
+
+   const Float64 *Values (ZUp ? ZUpValues : YUpValues);
+
+   for (Int32 ix = 0; ix < 16; ix++) { result[ix] = Values[ix]; }
+}
+
+
+static void
+local_object (
+      const Int32 Index,
+      const Int32 Frame,
+      Matrix &ori,
+      Vector &pos,
+      Vector &scale) {
+
+   const Float64 Value (Float64 (Index) + (Float64 (Frame) * 0.1));
+
+   ori = Matrix (Vector (0.0, 1.0, 0.0), Value * 0.01) *
+      Matrix (Vector (1.0, 0.0, 0.0), Value * 0.003);
+
+   pos.set_xyz (Value, -Value * 0.5, Value * 2.0);
+   scale.set_xyz (1.0 + (Index % 3), 1.0, 0.5 + (Index % 2));
+}
+
+
+static Boolean
+local_validate (const RenderTransformSync &Sync, const Int32 Count, const Int32 Frame) {
+
+   Boolean result (True);
+
+   for (Int32 ix = 0; (ix < Count) && result; ix++) {
+
+      Matrix ori;
+      Vector pos, scale;
+      Float64 expected[16];
+
+      local_object (ix, Frame, ori, pos, scale);
+      local_reference (Sync.get_z_up (), ori, pos, scale, expected);
+
+      const Float64 *Value (Sync.get_matrix (ix));
+
+      for (Int32 jy = 0; (jy < 16) && result; jy++) {
+
+         result = Value && (Value[jy] == expected[jy]);
+      }
+   }
+
+   return result;
+}
+
+
+static void
+local_fill (RenderTransformSync &sync, const Int32 Count, const Int32 Frame) {
+
+   sync.clear ();
+
+   for (Int32 ix = 0; ix < Count; ix++) {
+
+      Matrix ori;
+      Vector pos, scale;
+
+      local_object (ix, Frame, ori, pos, scale);
+      sync.add (ori, pos, scale);
+   }
+}
+
+};
+
+
+int
+main (int argc, char *argv[]) {
+
+   Test test ("dmzRenderTransformSyncTest", argc, argv);
+
+   RenderTransformSync sync;
+
+   test.validate (
+      "Empty batch",
+      (sync.compose () == 0) && !sync.get_matrix (0) && (sync.get_count () == 0));
+
+   local_fill (sync, 10, 0);
+
+   test.validate (
+      "Matrices are not available before compose",
+      (sync.get_count () == 10) && !sync.get_matrix (0));
+
+   test.validate (
+      "Y up matrices",
+      (sync.compose () == 10) && local_validate (sync, 10, 0) &&
+      !sync.get_matrix (10));
+
+   sync.set_z_up (True);
+   local_fill (sync, 10, 0);
+
+   test.validate (
+      "Z up matrices",
+      (sync.compose () == 10) && local_validate (sync, 10, 0));
+
+   sync.set_z_up (False);
+
+   const Int32 ThreadCounts[] = { 1, 4 };
+
+   for (Int32 ix = 0; ix < 2; ix++) {
+
+      sync.set_thread_count (ThreadCounts[ix]);
+
+      Boolean valid (True);
+      Float64 fillTime (0.0);
+      Float64 composeTime (0.0);
+
+      for (Int32 frame = 0; frame < Frames; frame++) {
+
+         Float64 start (get_time ());
+         local_fill (sync, ObjectCount, frame);
+         fillTime += get_time () - start;
+
+         start = get_time ();
+         sync.compose ();
+         composeTime += get_time () - start;
+
+         valid = valid && local_validate (sync, ObjectCount, frame);
+      }
+
+      String name ("Compose ");
+      name << ObjectCount << " matrices, threads " << ThreadCounts[ix];
+
+      test.log.out << name << ": fill " << (fillTime * 1.0e3) / Float64 (Frames)
+         << " ms/frame, compose " << (composeTime * 1.0e3) / Float64 (Frames)
+         << " ms/frame" << endl;
+
+      test.validate (name, valid);
+   }
+
+   return test.result ();
+}
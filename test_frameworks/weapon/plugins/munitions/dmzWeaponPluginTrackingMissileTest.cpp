@@ -0,0 +1,198 @@
+#include <dmzObjectAttributeMasks.h>
+#include <dmzObjectModule.h>
+#include <dmzRuntimeConfig.h>
+#include <dmzRuntimeDefinitions.h>
+#include <dmzRuntimePluginFactoryLinkSymbol.h>
+#include <dmzRuntimePluginInfo.h>
+#include <dmzTypesVector.h>
+#include "dmzWeaponPluginTrackingMissileTest.h"
+
+namespace {
+
+// Two waves of missiles, one lane per target. Each target is offset from its lane so a
+// missile that is not guided flies past it.
+static const dmz::Int32 LaneCount = 200;
+static const dmz::Float64 LaneWidth = 100.0;
+static const dmz::Float64 TargetOffset = 40.0;
+static const dmz::Float64 TargetZ = 2500.0;
+static const dmz::Float64 FirstWaveZ = 3000.0;
+static const dmz::Float64 SecondWaveZ = 3100.0;
+static const dmz::Float64 Timeout = 10.0;
+
+// A missile is launched away from every target and is then moved in front of the
+// relocation target once the tracking missile plugin has started flying it.
+static const dmz::Float64 RelocateX = 30000.0;
+static const dmz::Float64 LaunchX = 60000.0;
+static const dmz::Int32 RelocateFrame = 2;
+
+};
+
+
+dmz::WeaponPluginTrackingMissileTest::WeaponPluginTrackingMissileTest (
+      const PluginInfo &Info,
+      Config &local,
+      Config &global) :
+      Plugin (Info),
+      TimeSlice (Info),
+      ObjectObserverUtil (Info, local),
+      test (Info.get_name (), Info.get_context ()),
+      _log (Info),
+      _time (Info.get_context ()),
+      _defaultHandle (0),
+      _started (False),
+      _timeout (0.0),
+      _sliceTime (0.0),
+      _sliceCount (0),
+      _decoy (0),
+      _relocated (0) {
+
+   Definitions defs (Info.get_context ());
+
+   defs.lookup_object_type ("Test_Missile", _missileType);
+   defs.lookup_object_type ("Test_Target", _targetType);
+
+   _defaultHandle = activate_default_object_attribute (ObjectDestroyMask);
+}
+
+
+dmz::WeaponPluginTrackingMissileTest::~WeaponPluginTrackingMissileTest () {;}
+
+
+// TimeSlice Interface
+void
+dmz::WeaponPluginTrackingMissileTest::update_time_slice (const Float64 TimeDelta) {
+
+   ObjectModule *module (get_object_module ());
+
+   if (!module) {
+
+      test.validate (False, "Discovered object module");
+      test.exit ("Test completed");
+   }
+   else if (!_started) {
+
+      _started = True;
+
+      test.validate (_missileType && _targetType, "Found missile and target types");
+
+      _launch_salvo ();
+      _timeout = _time.get_frame_time () + Timeout;
+   }
+   else if (!_missileList.get_count () || (_time.get_frame_time () > _timeout)) {
+
+      test.validate (!_missileList.get_count (), "Every missile in the salvo hit");
+
+      Handle target (_targetList.get_first ());
+      Boolean targetsExist (True);
+
+      while (target) {
+
+         if (!module->is_object (target)) { targetsExist = False; }
+         target = _targetList.get_next ();
+      }
+
+      test.validate (
+         targetsExist && module->is_object (_decoy),
+         "Missiles only destroy themselves");
+
+      _log.out << "Salvo of " << (LaneCount * 2) + 1 << " missiles hit in " << _sliceCount
+         << " frames averaging " << (_sliceTime / Float64 (_sliceCount)) * 1.0e3
+         << " ms per frame" << endl;
+
+      test.exit ("Test completed");
+   }
+   else {
+
+      _sliceTime += TimeDelta;
+      _sliceCount++;
+
+      if ((_sliceCount == RelocateFrame) && module->is_object (_relocated)) {
+
+         module->store_position (
+            _relocated,
+            _defaultHandle,
+            Vector (RelocateX, 0.0, FirstWaveZ));
+      }
+   }
+}
+
+
+// Object Observer Interface
+void
+dmz::WeaponPluginTrackingMissileTest::destroy_object (
+      const UUID &Identity,
+      const Handle ObjectHandle) {
+
+   _missileList.remove (ObjectHandle);
+}
+
+
+void
+dmz::WeaponPluginTrackingMissileTest::_launch_salvo () {
+
+   for (Int32 ix = 0; ix < LaneCount; ix++) {
+
+      const Float64 X (1000.0 + (Float64 (ix) * LaneWidth));
+
+      const Vector TargetPos (X + TargetOffset, 0.0, TargetZ);
+
+      _targetList.add (_create_object (_targetType, TargetPos));
+
+      // The second wave flies behind the first so the first wave is inside its
+      // acquisition cone. Munitions are never acquired as targets.
+      _missileList.add (_create_object (_missileType, Vector (X, 0.0, FirstWaveZ)));
+      _missileList.add (_create_object (_missileType, Vector (X, 0.0, SecondWaveZ)));
+   }
+
+   // The decoy is in range of the first lane but outside of the acquisition cone.
+   _decoy = _create_object (_targetType, Vector (500.0, 0.0, TargetZ));
+
+   _targetList.add (
+      _create_object (_targetType, Vector (RelocateX + TargetOffset, 0.0, TargetZ)));
+
+   _relocated = _create_object (_missileType, Vector (LaunchX, 0.0, FirstWaveZ));
+   _missileList.add (_relocated);
+
+   test.validate (
+      (_targetList.get_count () == (LaneCount + 1)) &&
+      (_missileList.get_count () == ((LaneCount * 2) + 1)) && _decoy && _relocated,
+      "Created salvo");
+}
+
+
+dmz::Handle
+dmz::WeaponPluginTrackingMissileTest::_create_object (
+      const ObjectType &Type,
+      const Vector &Pos) {
+
+   Handle result (0);
+
+   ObjectModule *module (get_object_module ());
+
+   if (module) {
+
+      result = module->create_object (Type, ObjectLocal);
+
+      if (result) {
+
+         module->store_position (result, _defaultHandle, Pos);
+         module->activate_object (result);
+      }
+   }
+
+   return result;
+}
+
+
+extern "C" {
+
+DMZ_PLUGIN_FACTORY_LINK_SYMBOL dmz::Plugin *
+create_dmzWeaponPluginTrackingMissileTest (
+      const dmz::PluginInfo &Info,
+      dmz::Config &local,
+      dmz::Config &global) {
+
+   return new dmz::WeaponPluginTrackingMissileTest (Info, local, global);
+}
+
+};
@@ -0,0 +1,66 @@
+#ifndef DMZ_WEAPON_PLUGIN_TRACKING_MISSILE_TEST_DOT_H
+#define DMZ_WEAPON_PLUGIN_TRACKING_MISSILE_TEST_DOT_H
+
+#include <dmzObjectObserverUtil.h>
+#include <dmzRuntimeLog.h>
+#include <dmzRuntimeObjectType.h>
+#include <dmzRuntimePlugin.h>
+#include <dmzRuntimeTime.h>
+#include <dmzRuntimeTimeSlice.h>
+#include <dmzTestPluginUtil.h>
+#include <dmzTypesHandleContainer.h>
+
+namespace dmz {
+
+   class Config;
+   class Vector;
+
+   class WeaponPluginTrackingMissileTest :
+      public Plugin,
+      public TimeSlice,
+      public ObjectObserverUtil {
+
+      public:
+         WeaponPluginTrackingMissileTest (
+            const PluginInfo &Info,
+            Config &local,
+            Config &global);
+         ~WeaponPluginTrackingMissileTest ();
+
+         // Plugin Interface
+         virtual void update_plugin_state (
+            const PluginStateEnum State,
+            const UInt32 Level) {;}
+
+         virtual void discover_plugin (
+            const PluginDiscoverEnum Mode,
+            const Plugin *PluginPtr) {;}
+
+         // TimeSlice Interface
+         virtual void update_time_slice (const Float64 TimeDelta);
+
+         // Object Observer Interface
+         virtual void destroy_object (const UUID &Identity, const Handle ObjectHandle);
+
+      protected:
+         void _launch_salvo ();
+         Handle _create_object (const ObjectType &Type, const Vector &Pos);
+
+         TestPluginUtil test;
+         Log _log;
+         Time _time;
+         Handle _defaultHandle;
+         ObjectType _missileType;
+         ObjectType _targetType;
+         Boolean _started;
+         Float64 _timeout;
+         Float64 _sliceTime;
+         Int32 _sliceCount;
+         Handle _decoy;
+         Handle _relocated;
+         HandleContainer _missileList;
+         HandleContainer _targetList;
+   };
+};
+
+#endif // DMZ_WEAPON_PLUGIN_TRACKING_MISSILE_TEST_DOT_H
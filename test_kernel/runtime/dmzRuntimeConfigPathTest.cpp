@@ -0,0 +1,195 @@
+#include <dmzRuntimeConfig.h>
+#include <dmzRuntimeConfigPath.h>
+#include <dmzRuntimeConfigToTypesBase.h>
+#include <dmzTest.h>
+
+using namespace dmz;
+
+namespace {
+
+static Config
+create_item (const String &Name, const Int32 Id) {
+
+   Config result (Name);
+   String value;
+   value << Id;
+   result.store_attribute ("id", value);
+
+   return result;
+}
+
+
+static String
+get_ids (const Config &List) {
+
+   String result;
+
+   ConfigIterator it;
+   Config cd;
+
+   while (List.get_next_config (it, cd)) {
+
+      result << config_to_string ("id", cd) << " ";
+   }
+
+   return result;
+}
+
+};
+
+
+int
+main (int argc, char *argv[]) {
+
+   Test test ("dmzRuntimeConfigPathTest", argc, argv);
+
+   Config global ("global");
+
+   // Two "dmz" roots each with two "list" children holding items so the results of
+   // lookups depend on the order across multiple parents.
+   Int32 id (0);
+
+   for (Int32 ix = 0; ix < 2; ix++) {
+
+      Config dmz ("dmz");
+
+      for (Int32 jy = 0; jy < 2; jy++) {
+
+         Config list ("list");
+
+         for (Int32 kz = 0; kz < 2; kz++) { list.add_config (create_item ("item", id++)); }
+
+         dmz.add_config (list);
+      }
+
+      global.add_config (dmz);
+   }
+
+   Config empty ("dmz");
+   empty.add_config (Config ("other"));
+   global.add_config (empty);
+
+   Config all;
+
+   test.validate (
+      "Lookup all config returns every match in order",
+      global.lookup_all_config ("dmz.list.item", all) &&
+         (get_ids (all) == "0 1 2 3 4 5 6 7 "));
+
+   test.validate (
+      "Lookup all config list is named after the last path element",
+      all.get_name () == "item");
+
+   Config last;
+
+   test.validate (
+      "Lookup config returns the last match",
+      global.lookup_config ("dmz.list.item", last) &&
+         (config_to_string ("id", last) == "7"));
+
+   test.validate (
+      "Scoped attribute lookup uses the last match",
+      config_to_string ("dmz.list.item.id", global) == "7");
+
+   Config missing;
+
+   test.validate (
+      "Lookup of a name never used in a config fails",
+      !global.lookup_config ("dmz.list.never-used-name", missing) && !missing);
+
+   test.validate (
+      "Lookup all config of a name never used in a config fails",
+      !global.lookup_all_config ("never-used-name", missing) && !missing);
+
+   const ConfigPath ItemPath ("dmz.list.item");
+   const ConfigPath IdPath ("dmz.list.item.id");
+   const ConfigPath UnknownPath ("dmz.unknown");
+
+   test.validate ("Path is stored", ItemPath.get_path () == "dmz.list.item");
+
+   Config pathAll;
+
+   test.validate (
+      "Compiled path lookup all config matches Config lookup",
+      ItemPath.lookup_all_config (global, pathAll) &&
+         (get_ids (pathAll) == get_ids (all)) &&
+         (pathAll.get_name () == "item"));
+
+   Config pathLast;
+
+   test.validate (
+      "Compiled path lookup config matches Config lookup",
+      ItemPath.lookup_config (global, pathLast) && (pathLast == last));
+
+   String value;
+
+   test.validate (
+      "Compiled path attribute lookup",
+      IdPath.lookup_attribute (global, value) && (value == "7"));
+
+   test.validate (
+      "Repeated compiled path attribute lookup",
+      IdPath.lookup_attribute (global, value) && (value == "7"));
+
+   test.validate (
+      "Compiled path with unknown name fails",
+      !UnknownPath.lookup_config (global, missing) && !missing);
+
+   Config dmz ("dmz");
+   Config list ("list");
+   list.add_config (create_item ("item", 8));
+   dmz.add_config (list);
+   global.add_config (dmz);
+
+   test.validate (
+      "Compiled path lookup sees added config",
+      ItemPath.lookup_config (global, pathLast) &&
+         (config_to_string ("id", pathLast) == "8"));
+
+   test.validate (
+      "Compiled path attribute lookup sees added config",
+      IdPath.lookup_attribute (global, value) && (value == "8"));
+
+   last.store_attribute ("id", "changed");
+
+   Config firstDMZ;
+   ConfigIterator it;
+   global.get_first_config (it, firstDMZ);
+
+   test.validate (
+      "Compiled path lookup from a different source",
+      IdPath.lookup_attribute (firstDMZ, value) == False);
+
+   const ConfigPath ListItemPath ("list.item.id");
+
+   test.validate (
+      "Compiled path attribute lookup from a child",
+      ListItemPath.lookup_attribute (firstDMZ, value) && (value == "3"));
+
+   dmz.remove_config ("list");
+
+   test.validate (
+      "Compiled path lookup sees removed config",
+      IdPath.lookup_attribute (global, value) && (value == "changed"));
+
+   ConfigPath copy (ItemPath);
+
+   test.validate (
+      "Copied path lookup",
+      copy.lookup_config (global, pathLast) && (pathLast == last));
+
+   Config valueConfig ("value");
+   valueConfig.append_value ("text", False);
+
+   String text;
+
+   test.validate (
+      "Config value stored and retrieved",
+      valueConfig.get_value (text) && (text == "text"));
+
+   test.validate (
+      "Config value not returned as an attribute",
+      !valueConfig.get_first_attribute (it, text, value));
+
+   return test.result ();
+}
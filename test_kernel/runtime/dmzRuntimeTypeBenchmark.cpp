@@ -0,0 +1,196 @@
+#include <dmzRuntimeConfig.h>
+#include <dmzRuntimeDefinitions.h>
+#include <dmzRuntimeEventType.h>
+#include <dmzRuntimeInit.h>
+#include <dmzRuntimeMessaging.h>
+#include <dmzRuntimeObjectType.h>
+#include <dmzSystem.h>
+#include <dmzTest.h>
+
+using namespace dmz;
+
+namespace {
+
+static const Int32 Depth = 32;
+static const Int32 Iterations = 100000;
+
+
+static String
+local_name (const String &Prefix, const Int32 Level) {
+
+   String result (Prefix);
+   result << Level;
+   return result;
+}
+
+
+static void
+local_add_chain (Config &runtime, const String &Tag, const String &Prefix) {
+
+   for (Int32 level = 0; level < Depth; level++) {
+
+      Config type (Tag);
+      type.store_attribute ("name", local_name (Prefix, level));
+
+      if (level > 0) {
+
+         type.store_attribute ("parent", local_name (Prefix, level - 1));
+      }
+
+      runtime.add_config (type);
+   }
+
+   // A sibling of the deepest type that is not an ancestor of it.
+   Config sibling (Tag);
+   sibling.store_attribute ("name", Prefix + "Sibling");
+   sibling.store_attribute ("parent", local_name (Prefix, Depth - 2));
+   runtime.add_config (sibling);
+}
+
+
+// Ancestry test done by walking the parent chain. Used as the reference.
+static Boolean
+local_walk_is_of_type (const ObjectType &Value, const ObjectType &Type) {
+
+   Boolean result (False);
+   ObjectType current (Value);
+
+   while (current && !result) {
+
+      if (current == Type) { result = True; }
+      else { current.become_parent (); }
+   }
+
+   return result;
+}
+
+};
+
+
+int
+main (int argc, char *argv[]) {
+
+   Test test ("dmzRuntimeTypeBenchmark", argc, argv);
+
+   RuntimeContext *context (test.rt.get_context ());
+
+   Config runtime ("runtime");
+   local_add_chain (runtime, "object-type", "object");
+   local_add_chain (runtime, "event-type", "event");
+   local_add_chain (runtime, "message", "message");
+
+   runtime_init (runtime, context, &(test.log));
+
+   Definitions defs (context, &(test.log));
+
+   ObjectType objectTop, objectLeaf, objectSibling;
+   EventType eventTop, eventLeaf, eventSibling;
+   Message messageTop, messageLeaf, messageSibling;
+
+   test.validate (
+      "Looking up object types",
+      defs.lookup_object_type (local_name ("object", 0), objectTop) &&
+      defs.lookup_object_type (local_name ("object", Depth - 1), objectLeaf) &&
+      defs.lookup_object_type ("objectSibling", objectSibling));
+
+   test.validate (
+      "Looking up event types",
+      defs.lookup_event_type (local_name ("event", 0), eventTop) &&
+      defs.lookup_event_type (local_name ("event", Depth - 1), eventLeaf) &&
+      defs.lookup_event_type ("eventSibling", eventSibling));
+
+   test.validate (
+      "Looking up message types",
+      defs.lookup_message (local_name ("message", 0), messageTop) &&
+      defs.lookup_message (local_name ("message", Depth - 1), messageLeaf) &&
+      defs.lookup_message ("messageSibling", messageSibling));
+
+   // Every ancestor of the deepest type is found and the sibling is not.
+   Boolean ancestry (True);
+   ObjectType current (objectLeaf);
+
+   while (current) {
+
+      ancestry = ancestry && objectLeaf.is_of_type (current) &&
+         (current == objectLeaf || !current.is_of_type (objectLeaf)) &&
+         (objectSibling.is_of_type (current) == (current != objectLeaf));
+
+      current.become_parent ();
+   }
+
+   test.validate ("Object type ancestry matches parent chain", ancestry);
+
+   test.validate (
+      "Event and message type ancestry",
+      eventLeaf.is_of_type (eventTop) && !eventTop.is_of_type (eventLeaf) &&
+      !eventLeaf.is_of_type (eventSibling) &&
+      messageLeaf.is_of_type (messageTop) && !messageTop.is_of_type (messageLeaf) &&
+      !messageLeaf.is_of_type (messageSibling) && !messageLeaf.is_of_type (Message ()));
+
+   ObjectTypeSet topSet;
+   topSet.add_object_type (objectTop);
+
+   ObjectTypeSet siblingSet;
+   siblingSet.add_object_type (objectSibling);
+
+   EventTypeSet eventSet;
+   eventSet.add_event_type (eventTop);
+
+   test.validate (
+      "Type sets contain descendants",
+      topSet.contains_type (objectLeaf) && !siblingSet.contains_type (objectLeaf) &&
+      siblingSet.contains_type (objectSibling) && eventSet.contains_type (eventLeaf) &&
+      !topSet.contains_type (ObjectType ()));
+
+   // Walking the parent chain is the cost of an ancestry test before the ancestors
+   // were indexed.
+   Float64 start (get_time ());
+   Int32 found (0);
+
+   for (Int32 ix = 0; ix < Iterations; ix++) {
+
+      if (local_walk_is_of_type (objectLeaf, objectTop)) { found++; }
+      if (local_walk_is_of_type (objectLeaf, objectSibling)) { found++; }
+   }
+
+   test.report_time ("Parent chain walk", start, Iterations * 2, "test");
+   test.validate ("Parent chain walk", found == Iterations);
+
+   start = get_time ();
+   found = 0;
+
+   for (Int32 ix = 0; ix < Iterations; ix++) {
+
+      if (objectLeaf.is_of_type (objectTop)) { found++; }
+      if (objectLeaf.is_of_type (objectSibling)) { found++; }
+   }
+
+   test.report_time ("ObjectType::is_of_type", start, Iterations * 2, "test");
+   test.validate ("ObjectType::is_of_type", found == Iterations);
+
+   start = get_time ();
+   found = 0;
+
+   for (Int32 ix = 0; ix < Iterations; ix++) {
+
+      if (eventLeaf.is_of_type (eventTop)) { found++; }
+      if (messageLeaf.is_of_type (messageTop)) { found++; }
+   }
+
+   test.report_time ("EventType and Message is_of_type", start, Iterations * 2, "test");
+   test.validate ("EventType and Message is_of_type", found == (Iterations * 2));
+
+   start = get_time ();
+   found = 0;
+
+   for (Int32 ix = 0; ix < Iterations; ix++) {
+
+      if (topSet.contains_type (objectLeaf)) { found++; }
+      if (siblingSet.contains_type (objectLeaf)) { found++; }
+   }
+
+   test.report_time ("ObjectTypeSet::contains_type", start, Iterations * 2, "test");
+   test.validate ("ObjectTypeSet::contains_type", found == Iterations);
+
+   return test.result ();
+}
@@ -35,8 +35,10 @@ class UndoTest : public MessageObserver {
       Boolean valid ();
       void reset ();
       void set_undo ();
+      void set_coalesced_undo (const UInt64 Key);
 
       const String Name;
+      Int32 undoCount;
       Boolean gotUndo;
       Boolean gotRedo;
       DataConverterString dcs;
@@ -52,6 +54,7 @@ UndoTest::UndoTest (
       RuntimeContext *context) :
       MessageObserver (0, ReceiverName, context),
       Name (ReceiverName),
+      undoCount (0),
       gotUndo (False),
       gotRedo (False),
       dcs (context),
@@ -76,6 +79,7 @@ UndoTest::receive_message (
    if ((Type == undoType) && (Name == dcs.to_string (InData))) {
 
       gotUndo = True;
+      undoCount++;
       Data data (dcs.to_data (Name));
       undo.store_action (redoType, get_message_observer_handle (), &data);
    }
@@ -98,7 +102,7 @@ UndoTest::valid () {
 
 
 void
-UndoTest::reset () { gotUndo = gotRedo = False; }
+UndoTest::reset () { gotUndo = gotRedo = False; undoCount = 0; }
 
 
 void
@@ -110,6 +114,15 @@ UndoTest::set_undo () {
 }
 
 
+void
+UndoTest::set_coalesced_undo (const UInt64 Key) {
+
+   Data data (dcs.to_data (Name));
+
+   undo.store_coalesced_action (undoType, get_message_observer_handle (), Key, &data);
+}
+
+
 class TestObserver : public UndoObserver {
 
    public:
@@ -324,5 +337,67 @@ main (int argc, char *argv[]) {
    undo2.reset ();
    undo3.reset ();
 
+   undo.reset ();
+
+   test.validate (
+      "Memory usage is zero after reset",
+      !undo.get_memory_usage () && !obs.undoName && !obs.redoName);
+
+   record1 = undo.start_record (Level1);
+   undo1.set_coalesced_undo (1);
+   undo1.set_coalesced_undo (1);
+   undo1.set_coalesced_undo (1);
+   undo1.set_coalesced_undo (2);
+   undo2.set_coalesced_undo (2);
+   undo.stop_record (record1);
+
+   undo.do_next (UndoTypeUndo);
+
+   test.validate (
+      "Consecutive actions with the same coalesce key are played back once",
+      (undo1.undoCount == 2) && (undo2.undoCount == 1));
+
+   undo1.reset ();
+   undo2.reset ();
+   undo.reset ();
+
+   record1 = undo.start_record (Level1);
+   undo1.set_undo ();
+   undo.stop_record (record1);
+
+   const UInt64 FirstUsage (undo.get_memory_usage ());
+
+   record2 = undo.start_record (Level2);
+   undo2.set_undo ();
+   undo.stop_record (record2);
+
+   const UInt64 SecondUsage (undo.get_memory_usage ());
+
+   test.validate (
+      "Memory usage grows as actions are recorded",
+      FirstUsage && (SecondUsage > FirstUsage));
+
+   undo.set_memory_budget (SecondUsage);
+
+   test.validate ("Memory budget is set", undo.get_memory_budget () == SecondUsage);
+
+   record3 = undo.start_record (Level3);
+   undo3.set_undo ();
+   undo.stop_record (record3);
+
+   test.validate (
+      "Memory usage is within budget after the oldest record is evicted",
+      undo.get_memory_usage () <= SecondUsage);
+
+   undo.do_next (UndoTypeUndo);
+   undo.do_next (UndoTypeUndo);
+
+   test.validate (
+      "Newest records are kept when the memory budget is exceeded",
+      undo3.gotUndo && undo2.gotUndo && !undo1.gotUndo &&
+      !undo.do_next (UndoTypeUndo));
+
+   undo.set_memory_budget (0);
+
    return test.result ();
 }
@@ -0,0 +1,121 @@
+#include <dmzSystem.h>
+#include <dmzSystemMutex.h>
+#include <dmzSystemThread.h>
+#include <dmzSystemThreadPool.h>
+#include <dmzTest.h>
+
+using namespace dmz;
+
+namespace {
+
+static const Int32 TaskCount = 1000;
+static const Int32 BatchCount = 500;
+
+class CountTask : public ThreadFunction {
+
+   public:
+      CountTask (const Float64 Delay = 0.0) : _Delay (Delay), _count (0) {;}
+      virtual ~CountTask () {;}
+
+      virtual void run_thread_function () {
+
+         if (_Delay > 0.0) { sleep (_Delay); }
+
+         _lock.lock ();
+            _count++;
+         _lock.unlock ();
+      }
+
+      Int32 get_count () {
+
+         _lock.lock ();
+            const Int32 Result (_count);
+         _lock.unlock ();
+
+         return Result;
+      }
+
+   protected:
+      const Float64 _Delay;
+      Mutex _lock;
+      Int32 _count;
+};
+
+};
+
+
+int
+main (int argc, char *argv[]) {
+
+   Test test ("dmzSystemThreadPoolTest", argc, argv);
+
+   CountTask inlineTask;
+   ThreadPool inlinePool;
+   inlinePool.add_task (inlineTask);
+
+   test.validate (
+      "Pool without threads runs tasks on the calling thread",
+      !inlinePool.get_thread_count () && (inlineTask.get_count () == 1) &&
+      inlinePool.is_done ());
+
+   ThreadPool pool;
+   pool.set_thread_count (4);
+
+   CountTask task;
+
+   for (Int32 ix = 0; ix < TaskCount; ix++) { pool.add_task (task); }
+
+   pool.wait ();
+
+   test.validate (
+      "Every task is run once",
+      (pool.get_thread_count () == 4) && (task.get_count () == TaskCount) &&
+      pool.is_done ());
+
+   // Matches a per frame batch: the same workers are woken for every batch.
+   CountTask batchTask;
+   const Float64 Start (get_time ());
+
+   for (Int32 ix = 0; ix < BatchCount; ix++) {
+
+      for (Int32 jy = 0; jy < 4; jy++) { pool.add_task (batchTask); }
+
+      pool.wait ();
+   }
+
+   test.log.out << "Ran " << BatchCount << " batches in "
+      << (get_time () - Start) * 1.0e3 << " ms" << endl;
+
+   test.validate ("Batches reuse the workers", batchTask.get_count () == BatchCount * 4);
+
+   CountTask resizeTask;
+
+   for (Int32 ix = 0; ix < 50; ix++) {
+
+      pool.set_thread_count ((ix % 3) + 1);
+      pool.add_task (resizeTask);
+   }
+
+   pool.wait ();
+
+   test.validate (
+      "Changing the thread count joins the workers and keeps queued tasks",
+      (pool.get_thread_count () == 2) && (resizeTask.get_count () == 50));
+
+   CountTask slowTask (0.01);
+
+   {
+      ThreadPool scoped;
+      scoped.set_thread_count (2);
+
+      for (Int32 ix = 0; ix < 10; ix++) { scoped.add_task (slowTask); }
+
+      test.validate ("Slow tasks are not done at once", !scoped.is_done ());
+   }
+
+   test.validate (
+      "Destroying the pool finishes the queued tasks",
+      slowTask.get_count () == 10);
+
+   return test.result ();
+}
@@ -0,0 +1,224 @@
+#include <dmzTypesBase.h>
+#include <dmzTypesHandleContainer.h>
+#include <dmzTest.h>
+
+using namespace dmz;
+
+namespace {
+
+static HandleContainer
+local_create (const Handle *Values, const Int32 Count) {
+
+   HandleContainer result;
+   for (Int32 ix = 0; ix < Count; ix++) { result.add (Values[ix]); }
+   return result;
+}
+
+
+static Boolean
+local_equals (const HandleContainer &Container, const Handle *Values, const Int32 Count) {
+
+   Boolean result (Container.get_count () == Count);
+
+   HandleContainerIterator it;
+   Handle value (0);
+   Int32 place (0);
+
+   while (result && Container.get_next (it, value)) {
+
+      result = (place < Count) && (Values[place] == value);
+      place++;
+   }
+
+   return result && (place == Count);
+}
+
+};
+
+
+int
+main (int argc, char *argv[]) {
+
+   Test test ("dmzTypesHandleContainerTest", argc, argv);
+
+   // ============================================================================ //
+   // <add remove contains>
+
+   HandleContainer empty;
+   test.validate (
+      "Default constructor creates an empty container.",
+      !empty.get_count () && !empty.get_first () && !empty.get_last () &&
+      !empty.contains (1));
+
+   const Handle Unsorted[] = { 30, 10, 20, 10, 50, 40 };
+   const Handle Inserted[] = { 30, 10, 20, 50, 40 };
+
+   HandleContainer container (local_create (Unsorted, 6));
+
+   test.validate (
+      "Added handles are unique and iterated in insertion order.",
+      local_equals (container, Inserted, 5));
+
+   test.validate (
+      "Adding an existing handle succeeds without duplicating it.",
+      container.add (20) && (container.get_count () == 5));
+
+   test.validate (
+      "contains () finds stored handles only.",
+      container.contains (10) && container.contains (50) &&
+      !container.contains (15) && !container.contains (60));
+
+   test.validate (
+      "remove () only removes stored handles.",
+      container.remove (30) && !container.remove (30) && !container.contains (30) &&
+      (container.get_count () == 4));
+
+   container.add (30);
+
+   const Handle Readded[] = { 10, 20, 50, 40, 30 };
+
+   test.validate (
+      "A removed handle that is added again moves to the end.",
+      local_equals (container, Readded, 5));
+
+   // </add remove contains>
+   // ============================================================================ //
+   // <iteration>
+
+   test.validate (
+      "Internal iterator.",
+      (container.get_first () == 10) && (container.get_next () == 20) &&
+      (container.get_prev () == 10) && (container.get_last () == 30) &&
+      (container.get_prev () == 40) && (container.get_next () == 30) &&
+      !container.get_next ());
+
+   HandleContainerIterator it;
+   Handle value (0);
+   Int32 count (0);
+
+   while (container.get_prev (it, value)) { count++; }
+
+   test.validate ("Reverse iteration.", (count == 5) && !value);
+
+   // Remove the current handle while iterating.
+   HandleContainer removeAll (container);
+   it.reset ();
+   count = 0;
+
+   while (removeAll.get_next (it, value)) { removeAll.remove (value); count++; }
+
+   test.validate (
+      "Removing the current handle while iterating visits every handle.",
+      (count == 5) && !removeAll.get_count ());
+
+   HandleContainer removeAhead (container);
+   it.reset ();
+   count = 0;
+
+   while (removeAhead.get_next (it, value)) {
+
+      if (value == 20) { removeAhead.remove (10); removeAhead.remove (40); }
+      count++;
+   }
+
+   test.validate (
+      "Removing other handles while iterating skips only the removed handles.",
+      (count == 4) && (removeAhead.get_count () == 3));
+
+   HandleContainer growing (container);
+   it.reset ();
+   count = 0;
+
+   while (growing.get_next (it, value)) {
+
+      if (value == 20) { growing.add (25); growing.add (5); }
+      count++;
+   }
+
+   test.validate (
+      "Handles added while iterating are visited after the existing handles.",
+      (count == 7) && (growing.get_count () == 7) && (value == 0) &&
+      (growing.get_last () == 5));
+
+   // </iteration>
+   // ============================================================================ //
+   // <set operations>
+
+   const Handle OtherValues[] = { 5, 20, 40, 60 };
+   const HandleContainer Other (local_create (OtherValues, 4));
+
+   HandleContainer unionSet (container);
+   unionSet += Other;
+   const Handle Union[] = { 10, 20, 50, 40, 30, 5, 60 };
+   test.validate ("Union.", local_equals (unionSet, Union, 7));
+
+   HandleContainer intersection (container);
+   intersection &= Other;
+   const Handle Intersection[] = { 20, 40 };
+   test.validate ("Intersection.", local_equals (intersection, Intersection, 2));
+
+   HandleContainer difference (container);
+   difference -= Other;
+   const Handle Difference[] = { 10, 50, 30 };
+   test.validate ("Difference.", local_equals (difference, Difference, 3));
+
+   HandleContainer self (container);
+   self += self;
+   self &= self;
+   test.validate ("Union and intersection with self.", self == container);
+   self -= self;
+   test.validate ("Difference with self.", !self.get_count ());
+
+   // </set operations>
+   // ============================================================================ //
+   // <bulk and large>
+
+   const Int32 LargeCount (1000);
+   Handle *values (new Handle[LargeCount * 2]);
+
+   for (Int32 ix = 0; ix < LargeCount; ix++) {
+
+      values[ix] = Handle (LargeCount - ix);
+      values[ix + LargeCount] = Handle (ix + 1);
+   }
+
+   HandleContainer large;
+   test.validate (
+      "Bulk add ignores duplicates.",
+      (large.add (values, LargeCount * 2) == LargeCount) &&
+      (large.get_count () == LargeCount) &&
+      (large.get_first () == Handle (LargeCount)) && (large.get_last () == 1) &&
+      (large.add (values, LargeCount) == 0));
+
+   delete []values; values = 0;
+
+   HandleContainer largeCopy (large);
+   largeCopy.remove (500);
+
+   test.validate (
+      "Copy of a large container is independent.",
+      large.contains (500) && !largeCopy.contains (500) &&
+      !(large == largeCopy) && !large.has_same_content (largeCopy));
+
+   largeCopy.add (500);
+
+   test.validate (
+      "Containers with the same handles in a different order have the same content "
+      "but are not equal.",
+      !(large == largeCopy) && large.has_same_content (largeCopy));
+
+   largeCopy = large;
+
+   test.validate (
+      "Containers with the same handles in the same order are equal.",
+      (large == largeCopy) && large.has_same_content (largeCopy) &&
+      (largeCopy.get_last () == 1));
+
+   largeCopy = container;
+   test.validate ("Assign small container to large.", largeCopy == container);
+
+   // </bulk and large>
+   // ============================================================================ //
+
+   return test.result ();
+}
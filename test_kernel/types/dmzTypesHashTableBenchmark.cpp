@@ -0,0 +1,296 @@
+#include <dmzSystem.h>
+#include <dmzTypesBase.h>
+#include <dmzTypesHashTableString.h>
+#include <dmzTypesHashTableStringTemplate.h>
+#include <dmzTypesHashTableUUID.h>
+#include <dmzTypesHashTableUUIDTemplate.h>
+#include <dmzTypesString.h>
+#include <dmzTypesUUID.h>
+#include <dmzTest.h>
+
+#include <math.h>
+
+using namespace dmz;
+
+namespace {
+
+static const Int32 Iterations = 20;
+
+// Attribute, event and message names used by the frameworks. The corpus is built by
+// scoping and numbering them the way plugin configurations do.
+static const char *Names[] = {
+   "Object_Bounding_Volume_Radius_Attribute",
+   "Object_Create_Message",
+   "Object_Default_Attribute",
+   "Object_Destroy_Message",
+   "Object_Hide_Attribute",
+   "Object_Highlight_Attribute",
+   "Object_Human_In_The_Loop",
+   "Object_Last_Network_Value",
+   "Object_Select_Attribute",
+   "Event_Collision",
+   "Event_Default_Attribute",
+   "Event_Detonation",
+   "Event_Launch",
+   "Event_Munitions_Attribute",
+   "Event_Source_Attribute",
+   "Event_Target_Attribute",
+   "DMZ_Render_Isect_Entity",
+   "DMZ_Render_Isect_Glyph",
+   "DMZ_Render_Main_Portal",
+   "Weapon_Target_Lock",
+   0
+};
+
+static const char *Scopes[] = {
+   "",
+   "dmz.object.attribute.",
+   "dmz.net.rule.attribute.",
+   "dmzObjectPluginRemote.attribute.",
+   0
+};
+
+static const char BaseUUID[] = "6ba7b810-9dad-11d1-80b4-00c04fd430c8";
+
+static Int32
+local_table_size (const Int32 Count) {
+
+   Int32 result (1);
+   while ((result * 3) < (Count * 4)) { result = result << 1; }
+   return result;
+}
+
+
+static Float64
+local_expected_collisions (const Int32 Count, const Int32 Size) {
+
+   const Float64 N (Count);
+   const Float64 M (Size);
+   return N - (M * (1.0 - pow (1.0 - (1.0 / M), N)));
+}
+
+
+static Int32
+local_collisions (const UInt32 *Hashes, const Int32 Count, const Int32 Size) {
+
+   Int32 result (0);
+   Boolean *used (new Boolean[Size]);
+
+   for (Int32 ix = 0; ix < Size; ix++) { used[ix] = False; }
+
+   for (Int32 ix = 0; ix < Count; ix++) {
+
+      const UInt32 Index (Hashes[ix] % UInt32 (Size));
+
+      if (used[Index]) { result++; }
+      else { used[Index] = True; }
+   }
+
+   delete []used; used = 0;
+
+   return result;
+}
+
+
+static void
+local_report_collisions (
+      Test &test,
+      const String &Name,
+      const Int32 Collisions,
+      const Int32 Count,
+      const Int32 Size) {
+
+   const Float64 Expected (local_expected_collisions (Count, Size));
+
+   test.log.out << Name << ": " << Collisions << " bucket collisions for " << Count
+      << " keys in " << Size << " buckets (" << Expected << " expected from a random hash)"
+      << endl;
+
+   test.validate (
+      Name + " collisions are close to a random hash",
+      Float64 (Collisions) < (Expected * 1.25));
+}
+
+};
+
+
+int
+main (int argc, char *argv[]) {
+
+   Test test ("dmzTypesHashTableBenchmark", argc, argv);
+
+   // Attribute name corpus
+   Int32 nameCount (0);
+   while (Names[nameCount]) { nameCount++; }
+
+   Int32 scopeCount (0);
+   while (Scopes[scopeCount]) { scopeCount++; }
+
+   const Int32 Variants (100);
+   const Int32 StringCount (nameCount * scopeCount * Variants);
+   String *strings (new String[StringCount]);
+
+   Int32 place (0);
+
+   for (Int32 scope = 0; scope < scopeCount; scope++) {
+
+      for (Int32 name = 0; name < nameCount; name++) {
+
+         for (Int32 variant = 0; variant < Variants; variant++) {
+
+            strings[place] << Scopes[scope] << Names[name];
+            if (variant) { strings[place] << "_" << variant; }
+            place++;
+         }
+      }
+   }
+
+   UInt32 *hashes (new UInt32[StringCount]);
+
+   Float64 start (get_time ());
+
+   for (Int32 count = 0; count < Iterations; count++) {
+
+      for (Int32 ix = 0; ix < StringCount; ix++) {
+
+         hashes[ix] = HashTableString::hash (strings[ix]);
+      }
+   }
+
+   test.report_time (
+      "Hash attribute names",
+      start,
+      StringCount * Iterations,
+      "operation");
+
+   const Int32 StringTableSize (local_table_size (StringCount));
+
+   local_report_collisions (
+      test,
+      "Attribute names",
+      local_collisions (hashes, StringCount, StringTableSize),
+      StringCount,
+      StringTableSize);
+
+   delete []hashes; hashes = 0;
+
+   HashTableStringTemplate<String> stringTable;
+
+   start = get_time ();
+
+   for (Int32 ix = 0; ix < StringCount; ix++) {
+
+      stringTable.store (strings[ix], &(strings[ix]));
+   }
+
+   test.report_time ("Store attribute names", start, StringCount, "operation");
+   test.validate ("Store attribute names", stringTable.get_count () == StringCount);
+
+   start = get_time ();
+   Int32 found (0);
+
+   for (Int32 count = 0; count < Iterations; count++) {
+
+      for (Int32 ix = 0; ix < StringCount; ix++) {
+
+         if (stringTable.lookup (strings[ix]) == &(strings[ix])) { found++; }
+      }
+   }
+
+   test.report_time (
+      "Lookup attribute names",
+      start,
+      StringCount * Iterations,
+      "operation");
+   test.validate ("Lookup attribute names", found == (StringCount * Iterations));
+
+   stringTable.clear ();
+   delete []strings; strings = 0;
+
+   // Sequential UUID corpus. Time based UUIDs created in sequence differ in the
+   // time_low field and UUIDs assigned by a tool often differ in the node field.
+   const Int32 HalfCount (StringCount / 2);
+   const Int32 UUIDCount (HalfCount * 2);
+   UUID *uuids (new UUID[UUIDCount]);
+
+   UInt8 base[16];
+   UUID (String (BaseUUID)).to_array (base);
+
+   for (Int32 ix = 0; ix < HalfCount; ix++) {
+
+      UInt8 timeLow[16];
+      UInt8 node[16];
+
+      for (Int32 byte = 0; byte < 16; byte++) { timeLow[byte] = node[byte] = base[byte]; }
+
+      const UInt32 Value (UInt32 (ix) * 16);
+      timeLow[0] = UInt8 (Value >> 24);
+      timeLow[1] = UInt8 (Value >> 16);
+      timeLow[2] = UInt8 (Value >> 8);
+      timeLow[3] = UInt8 (Value);
+
+      node[13] = UInt8 (ix >> 16);
+      node[14] = UInt8 (ix >> 8);
+      node[15] = UInt8 (ix);
+
+      uuids[ix].from_array (timeLow);
+      uuids[HalfCount + ix].from_array (node);
+   }
+
+   hashes = new UInt32[UUIDCount];
+
+   start = get_time ();
+
+   for (Int32 count = 0; count < Iterations; count++) {
+
+      for (Int32 ix = 0; ix < UUIDCount; ix++) {
+
+         hashes[ix] = HashTableUUID::hash (uuids[ix]);
+      }
+   }
+
+   test.report_time ("Hash sequential UUIDs", start, UUIDCount * Iterations, "operation");
+
+   const Int32 UUIDTableSize (local_table_size (UUIDCount));
+
+   local_report_collisions (
+      test,
+      "Sequential UUIDs",
+      local_collisions (hashes, UUIDCount, UUIDTableSize),
+      UUIDCount,
+      UUIDTableSize);
+
+   delete []hashes; hashes = 0;
+
+   HashTableUUIDTemplate<UUID> uuidTable;
+
+   start = get_time ();
+
+   for (Int32 ix = 0; ix < UUIDCount; ix++) { uuidTable.store (uuids[ix], &(uuids[ix])); }
+
+   test.report_time ("Store sequential UUIDs", start, UUIDCount, "operation");
+   test.validate ("Store sequential UUIDs", uuidTable.get_count () == UUIDCount);
+
+   start = get_time ();
+   found = 0;
+
+   for (Int32 count = 0; count < Iterations; count++) {
+
+      for (Int32 ix = 0; ix < UUIDCount; ix++) {
+
+         if (uuidTable.lookup (uuids[ix]) == &(uuids[ix])) { found++; }
+      }
+   }
+
+   test.report_time (
+      "Lookup sequential UUIDs",
+      start,
+      UUIDCount * Iterations,
+      "operation");
+   test.validate ("Lookup sequential UUIDs", found == (UUIDCount * Iterations));
+
+   uuidTable.clear ();
+   delete []uuids; uuids = 0;
+
+   return test.result ();
+}
@@ -702,5 +702,44 @@ test.log.error
 << endl;
 #endif
 
+   // Removing every third key leaves enough removed slots that the store in the middle
+   // of the loop rehashes the table in place.
+   HashTableStringTemplate<Int32> rehashTable;
+   const Int32 RehashCount (48);
+
+   for (Int32 ix = 0; ix < RehashCount; ix++) {
+
+      String key ("rehash");
+      key << ix;
+      rehashTable.store (key, new Int32 (ix));
+   }
+
+   for (Int32 ix = 0; ix < RehashCount; ix += 3) {
+
+      String key ("rehash");
+      key << ix;
+      delete rehashTable.remove (key);
+   }
+
+   const Int32 RehashSize (rehashTable.get_size ());
+   const Int32 Remaining (rehashTable.get_count ());
+   const Int32 Half (Remaining / 2);
+   Int32 visited (0);
+   Int32 *rehashValue (rehashTable.get_first (it));
+
+   while (rehashValue) {
+
+      visited++;
+      if (visited == Half) { rehashTable.store ("rehashStored", new Int32 (-1)); }
+      rehashValue = rehashTable.get_next (it);
+   }
+
+   test.validate (
+      "Storing while iterating visits every element",
+      (visited == (Remaining + 1)) && (rehashTable.get_count () == (Remaining + 1)) &&
+      (rehashTable.get_size () == RehashSize));
+
+   rehashTable.empty ();
+
    return test.result ();
 }
@@ -413,6 +413,77 @@ main (int argc, char *argv[]) {
 
    // </validate HashTableLock>
    // ============================================================================ //
+   // <validate removed marks>
+
+   // UInt32 keys hash to themselves, so keys stored in order fill consecutive slots.
+   Int32 markValue (1);
+   HashTableUInt32 trailTable (64, 0);
+
+   for (UInt32 ix = 1; ix <= 3; ix++) { trailTable.store (ix, &markValue); }
+
+   trailTable.remove (3);
+   const Int32 TrailRemoved3 (trailTable.get_removed_count ());
+   trailTable.remove (1);
+   const Int32 TrailRemoved1 (trailTable.get_removed_count ());
+   trailTable.remove (2);
+   const Int32 TrailRemoved2 (trailTable.get_removed_count ());
+
+   test.validate (
+      "Removed marks are kept only while a live key follows them",
+      (TrailRemoved3 == 0) && (TrailRemoved1 == 1) && (TrailRemoved2 == 0) &&
+      (trailTable.get_count () == 0));
+
+   // Removing the first half of a block of keys leaves a run of removed marks in front
+   // of the live keys that removal can not clear.
+   const Int32 MarkTableSize (1 << 15);
+   const UInt32 MarkLiveCount (20000);
+   const UInt32 MarkRemovedCount (10000);
+   const Int32 MarkPasses (5);
+
+   HashTableUInt32 markTable (MarkTableSize, 0);
+
+   for (UInt32 ix = 0; ix < MarkLiveCount; ix++) { markTable.store (ix, &markValue); }
+   for (UInt32 ix = 0; ix < MarkRemovedCount; ix++) { markTable.remove (ix); }
+
+   const Int32 MarksLeft (markTable.get_removed_count ());
+   const UInt32 StartGrowCount (markTable.get_grow_count ());
+
+   // The first store rehashes the table in place to drop the marks.
+   markTable.store (MarkLiveCount, &markValue);
+   markTable.remove (MarkLiveCount);
+
+   const Int32 RehashRemoved (markTable.get_removed_count ());
+   const UInt32 RehashGrowCount (markTable.get_grow_count ());
+
+   Boolean markStored (True);
+   Int32 maxRemoved (0);
+
+   for (Int32 pass = 0; pass < MarkPasses; pass++) {
+
+      for (UInt32 ix = 0; ix < MarkRemovedCount; ix++) {
+
+         if (!markTable.store (ix, &markValue)) { markStored = False; }
+         markTable.remove (ix);
+
+         const Int32 Removed (markTable.get_removed_count ());
+         if (Removed > maxRemoved) { maxRemoved = Removed; }
+      }
+   }
+
+   test.validate (
+      "Removed marks that fill an eighth of the table are dropped by one rehash",
+      (MarksLeft == Int32 (MarkRemovedCount)) &&
+      (RehashGrowCount == (StartGrowCount + 1)) && (RehashRemoved == 0));
+
+   test.validate (
+      "Store and remove churn keeps the removed marks bounded without growing",
+      markStored && (maxRemoved <= (MarkTableSize >> 3)) &&
+      (markTable.get_count () == Int32 (MarkLiveCount - MarkRemovedCount)) &&
+      (markTable.get_size () == MarkTableSize) &&
+      (markTable.get_grow_count () == RehashGrowCount));
+
+   // </validate removed marks>
+   // ============================================================================ //
 
    return test.result ();
 
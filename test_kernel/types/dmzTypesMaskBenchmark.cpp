@@ -0,0 +1,153 @@
+#include <dmzSystem.h>
+#include <dmzTypesBase.h>
+#include <dmzTypesMask.h>
+#include <dmzTypesString.h>
+#include <dmzTest.h>
+
+#include <new>
+#include <stdlib.h>
+
+using namespace dmz;
+
+namespace {
+
+static const Int32 Iterations = 200000;
+static const Int32 StateCount = 96;
+
+static Int32 localAllocationCount = 0;
+
+
+static void
+local_report_allocations (
+      Test &test,
+      const String &Name,
+      const Int32 Start,
+      const Int32 Count,
+      const Int32 Expected) {
+
+   const Int32 Allocations (localAllocationCount - Start);
+
+   test.log.out << Name << ": " << Allocations << " allocations in " << Count
+      << " iterations" << endl;
+
+   test.validate (Name + " allocations", Allocations <= Expected);
+}
+
+
+static void *
+local_allocate (size_t size) {
+
+   localAllocationCount++;
+
+   void *result (malloc (size ? size : 1));
+   if (!result) { throw std::bad_alloc (); }
+   return result;
+}
+
+};
+
+// Count every heap allocation made by the process, including those made by the kernel.
+void *operator new (size_t size) throw (std::bad_alloc) { return local_allocate (size); }
+void *operator new[] (size_t size) throw (std::bad_alloc) { return local_allocate (size); }
+void operator delete (void *ptr) throw () { free (ptr); }
+void operator delete[] (void *ptr) throw () { free (ptr); }
+
+
+int
+main (int argc, char *argv[]) {
+
+   Test test ("dmzTypesMaskBenchmark", argc, argv);
+
+   // Object states as they are defined by the runtime. Each state is a single bit.
+   Mask *states (new Mask[StateCount]);
+   for (Int32 ix = 0; ix < StateCount; ix++) { states[ix] = Mask (ix); }
+
+   const Mask Dead (states[3]);
+   const Mask Smoking (states[7]);
+   const Mask Damage (states[3] | states[5] | states[7]);
+
+   // Construct and combine
+   Int32 allocationStart (localAllocationCount);
+   Float64 start (get_time ());
+   Int32 setCount (0);
+
+   for (Int32 ix = 0; ix < Iterations; ix++) {
+
+      Mask state (states[ix % StateCount]);
+      state |= states[(ix + 1) % StateCount];
+      state.unset (Smoking);
+      if (state.is_set ()) { setCount++; }
+   }
+
+   local_report_allocations (test, "Combine states", allocationStart, Iterations, 0);
+   test.report_time ("Combine states", start, Iterations);
+   test.validate ("Combine states", setCount == Iterations);
+
+   // Compare states the way network state rules do.
+   Mask previous (Dead | states[20]);
+   Mask current (Dead | states[21]);
+
+   allocationStart = localAllocationCount;
+   start = get_time ();
+   Int32 changeCount (0);
+
+   for (Int32 ix = 0; ix < Iterations; ix++) {
+
+      if ((previous & Damage) != (current & Damage)) { changeCount++; }
+      if (current.contains (Dead) && !(current & Smoking)) { changeCount++; }
+      if (previous != current) { changeCount++; }
+   }
+
+   local_report_allocations (test, "Compare states", allocationStart, Iterations, 0);
+   test.report_time ("Compare states", start, Iterations * 3);
+   test.validate ("Compare states", changeCount == (Iterations * 2));
+
+   // Query bits
+   Mask all;
+   for (Int32 ix = 0; ix < StateCount; ix += 3) { all |= states[ix]; }
+
+   allocationStart = localAllocationCount;
+   start = get_time ();
+   Int32 bitCount (0);
+
+   for (Int32 ix = 0; ix < Iterations; ix++) {
+
+      Int32 bit (all.get_next_bit (0));
+
+      while (bit >= 0) { bitCount++; bit = all.get_next_bit (bit + 1); }
+   }
+
+   local_report_allocations (test, "Iterate set bits", allocationStart, Iterations, 0);
+   test.report_time ("Iterate set bits", start, Iterations);
+   test.validate (
+      "Iterate set bits",
+      (bitCount == (Iterations * all.get_bit_count ())) &&
+      (all.get_bit_count () == (StateCount / 3)));
+
+   // Masks larger than the inline storage allocate once when copied.
+   const Mask Large (300);
+
+   allocationStart = localAllocationCount;
+   start = get_time ();
+   Int32 largeCount (0);
+
+   for (Int32 ix = 0; ix < Iterations; ix++) {
+
+      Mask large (Large);
+      large |= states[ix % StateCount];
+      if (large.get_bit (300)) { largeCount++; }
+   }
+
+   local_report_allocations (
+      test,
+      "Combine large masks",
+      allocationStart,
+      Iterations,
+      Iterations);
+   test.report_time ("Combine large masks", start, Iterations);
+   test.validate ("Combine large masks", largeCount == Iterations);
+
+   delete []states; states = 0;
+
+   return test.result ();
+}
@@ -217,6 +217,75 @@ main (int argc, char *argv[]) {
       "Identical masks contain each other.",
       testMask6.contains (testMask7));
 
+   // ============================================================================ //
+   // <large masks>
+
+   Mask largeMask (300);
+   largeMask.set_bit (5);
+   largeMask.set_bit (127);
+   largeMask.set_bit (128);
+
+   test.validate (
+      "Mask grows past inline storage.",
+      (largeMask.get_size () == 10) &&
+      largeMask.get_bit (5) && largeMask.get_bit (127) &&
+      largeMask.get_bit (128) && largeMask.get_bit (300) &&
+      !largeMask.get_bit (301) && !largeMask.get_bit (-1));
+
+   Mask largeCopy (largeMask);
+   largeCopy.unset_bit (300);
+   test.validate (
+      "Mask copy of large mask is independent.",
+      largeMask.get_bit (300) && !largeCopy.get_bit (300) &&
+      largeMask.contains (largeCopy) && !largeCopy.contains (largeMask));
+
+   test.validate (
+      "Mask get_bit_count () function.",
+      (largeMask.get_bit_count () == 4) &&
+      (largeCopy.get_bit_count () == 3) &&
+      (nullMask.get_bit_count () == 0));
+
+   test.validate (
+      "Mask get_next_bit () function.",
+      (largeMask.get_next_bit (0) == 5) &&
+      (largeMask.get_next_bit (6) == 127) &&
+      (largeMask.get_next_bit (128) == 128) &&
+      (largeMask.get_next_bit (129) == 300) &&
+      (largeMask.get_next_bit (301) == -1) &&
+      (nullMask.get_next_bit (0) == -1));
+
+   Mask shiftMask (0, 0x80000001);
+   shiftMask << 32;
+   test.validate (
+      "Mask << operator by whole block.",
+      (shiftMask.get_size () == 2) &&
+      (shiftMask.get_sub_mask (0) == 0) &&
+      (shiftMask.get_sub_mask (1) == 0x80000001));
+
+   shiftMask << 97;
+   test.validate (
+      "Mask << operator past inline storage.",
+      (shiftMask.get_size () == 6) &&
+      (shiftMask.get_bit_count () == 2) &&
+      shiftMask.get_bit (129) && shiftMask.get_bit (160));
+
+   shiftMask >> 129;
+   test.validate (
+      "Mask >> operator from heap storage.",
+      (shiftMask == Mask (0, 0x80000001)) &&
+      (shiftMask.get_size () == 2) && !shiftMask.get_sub_mask (1));
+
+   shiftMask >> 64;
+   test.validate ("Mask >> operator past zero bit.", !shiftMask);
+
+   Mask selfMask (40);
+   selfMask = selfMask;
+   selfMask |= selfMask;
+   test.validate ("Mask assigned to itself.", selfMask == Mask (40));
+
+   // </large masks>
+   // ============================================================================ //
+
    return test.result ();
 }
 
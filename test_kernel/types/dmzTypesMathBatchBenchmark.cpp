@@ -0,0 +1,217 @@
+#include <dmzSystem.h>
+#include <dmzTypesBase.h>
+#include <dmzTypesConsts.h>
+#include <dmzTypesMathBatch.h>
+#include <dmzTypesMatrix.h>
+#include <dmzTypesString.h>
+#include <dmzTypesVector.h>
+#include <dmzTest.h>
+
+#include <string.h>
+
+using namespace dmz;
+
+namespace {
+
+static const Int32 Iterations = 200;
+static const Int32 Count = 10001;
+
+static const char *ModeNames[] = { "Scalar", "SSE2", "AVX2" };
+
+
+static Boolean
+local_same (const Vector *Value1, const Vector *Value2, const Int32 Size) {
+
+   Boolean result (True);
+
+   for (Int32 ix = 0; (ix < Size) && result; ix++) {
+
+      Float64 data1[3], data2[3];
+      Value1[ix].get_xyz (data1[0], data1[1], data1[2]);
+      Value2[ix].get_xyz (data2[0], data2[1], data2[2]);
+      result = (memcmp (data1, data2, sizeof (data1)) == 0);
+   }
+
+   return result;
+}
+
+
+static Boolean
+local_same (const Matrix *Value1, const Matrix *Value2, const Int32 Size) {
+
+   Boolean result (True);
+
+   for (Int32 ix = 0; (ix < Size) && result; ix++) {
+
+      Float64 data1[9], data2[9];
+      Value1[ix].to_array (data1);
+      Value2[ix].to_array (data2);
+      result = (memcmp (data1, data2, sizeof (data1)) == 0);
+   }
+
+   return result;
+}
+
+};
+
+
+int
+main (int argc, char *argv[]) {
+
+   Test test ("dmzTypesMathBatchBenchmark", argc, argv);
+
+   const MathBatchModeEnum SupportedMode (get_math_batch_mode ());
+
+   test.log.out << "Supported batch math mode: " << ModeNames[SupportedMode] << endl;
+
+   Vector *position (new Vector[Count]);
+   Vector *velocity (new Vector[Count]);
+   Matrix *left (new Matrix[Count]);
+   Matrix *right (new Matrix[Count]);
+
+   for (Int32 ix = 0; ix < Count; ix++) {
+
+      const Float64 Value = ix;
+
+      position[ix].set_xyz (Value * 0.5, -Value * 1.25, Value * 0.001 + 3.0);
+      velocity[ix].set_xyz (Value * 0.01 - 5.0, 7.5, -Value * 0.003);
+      left[ix] = Matrix (HalfPi64 * 0.001 * Value, Pi64 / 3.0, 0.25);
+      right[ix] = Matrix (Vector (1.0, Value, -2.0), Value * 0.0001);
+   }
+
+   // Keep a zero length vector to check the normalize zero case.
+   velocity[0].set_xyz (0.0, 0.0, 0.0);
+
+   const Matrix Transform (Pi64 / 5.0, -Pi64 / 7.0, HalfPi64 / 3.0);
+   const Float64 Time (0.016);
+
+   Vector *expectedTransform (new Vector[Count]);
+   Vector *expectedExtrapolate (new Vector[Count]);
+   Vector *expectedNormalize (new Vector[Count]);
+   Matrix *expectedMultiply (new Matrix[Count]);
+
+   set_math_batch_mode (MathBatchScalar);
+
+   transform_vectors (Transform, position, Count, expectedTransform);
+   extrapolate_vectors (position, velocity, Time, Count, expectedExtrapolate);
+   for (Int32 ix = 0; ix < Count; ix++) { expectedNormalize[ix] = velocity[ix]; }
+   normalize_vectors (expectedNormalize, Count);
+   multiply_matrices (left, right, Count, expectedMultiply);
+
+   Boolean scalarMatch (True);
+
+   for (Int32 ix = 0; (ix < Count) && scalarMatch; ix++) {
+
+      Vector value (position[ix]);
+      Transform.transform_vector (value);
+      scalarMatch = local_same (&value, &(expectedTransform[ix]), 1);
+
+      value = position[ix] + (velocity[ix] * Time);
+      scalarMatch = scalarMatch && local_same (&value, &(expectedExtrapolate[ix]), 1);
+
+      value = velocity[ix].normalize ();
+      scalarMatch = scalarMatch && local_same (&value, &(expectedNormalize[ix]), 1);
+
+      const Matrix Product (left[ix] * right[ix]);
+      scalarMatch = scalarMatch && local_same (&Product, &(expectedMultiply[ix]), 1);
+   }
+
+   test.validate ("Scalar batch matches Vector and Matrix operations", scalarMatch);
+
+   Vector *vecResult (new Vector[Count]);
+   Matrix *matResult (new Matrix[Count]);
+
+   for (Int32 mode = MathBatchScalar; mode <= SupportedMode; mode++) {
+
+      const MathBatchModeEnum Mode (set_math_batch_mode (MathBatchModeEnum (mode)));
+      const String Name (ModeNames[Mode]);
+
+      test.validate (Name + " mode selected", Mode == MathBatchModeEnum (mode));
+
+      // Results
+      transform_vectors (Transform, position, Count, vecResult);
+      test.validate (
+         Name + " transform matches scalar",
+         local_same (vecResult, expectedTransform, Count));
+
+      for (Int32 ix = 0; ix < Count; ix++) { vecResult[ix] = position[ix]; }
+      transform_vectors (Transform, vecResult, Count, vecResult);
+      test.validate (
+         Name + " transform in place matches scalar",
+         local_same (vecResult, expectedTransform, Count));
+
+      extrapolate_vectors (position, velocity, Time, Count, vecResult);
+      test.validate (
+         Name + " extrapolate matches scalar",
+         local_same (vecResult, expectedExtrapolate, Count));
+
+      for (Int32 ix = 0; ix < Count; ix++) { vecResult[ix] = velocity[ix]; }
+      normalize_vectors (vecResult, Count);
+      test.validate (
+         Name + " normalize matches scalar",
+         local_same (vecResult, expectedNormalize, Count));
+
+      multiply_matrices (left, right, Count, matResult);
+      test.validate (
+         Name + " multiply matches scalar",
+         local_same (matResult, expectedMultiply, Count));
+
+      for (Int32 ix = 0; ix < Count; ix++) { matResult[ix] = left[ix]; }
+      multiply_matrices (matResult, right, Count, matResult);
+      test.validate (
+         Name + " multiply in place matches scalar",
+         local_same (matResult, expectedMultiply, Count));
+
+      // Throughput
+      Float64 start (get_time ());
+
+      for (Int32 count = 0; count < Iterations; count++) {
+
+         transform_vectors (Transform, position, Count, vecResult);
+      }
+
+      test.report_time (Name + " transform", start, Count * Iterations, "operation");
+
+      start = get_time ();
+
+      for (Int32 count = 0; count < Iterations; count++) {
+
+         extrapolate_vectors (position, velocity, Time, Count, vecResult);
+      }
+
+      test.report_time (Name + " extrapolate", start, Count * Iterations, "operation");
+
+      start = get_time ();
+
+      for (Int32 count = 0; count < Iterations; count++) {
+
+         normalize_vectors (vecResult, Count);
+      }
+
+      test.report_time (Name + " normalize", start, Count * Iterations, "operation");
+
+      start = get_time ();
+
+      for (Int32 count = 0; count < Iterations; count++) {
+
+         multiply_matrices (left, right, Count, matResult);
+      }
+
+      test.report_time (Name + " multiply", start, Count * Iterations, "operation");
+   }
+
+   set_math_batch_mode (SupportedMode);
+
+   delete []matResult; matResult = 0;
+   delete []vecResult; vecResult = 0;
+   delete []expectedMultiply; expectedMultiply = 0;
+   delete []expectedNormalize; expectedNormalize = 0;
+   delete []expectedExtrapolate; expectedExtrapolate = 0;
+   delete []expectedTransform; expectedTransform = 0;
+   delete []right; right = 0;
+   delete []left; left = 0;
+   delete []velocity; velocity = 0;
+   delete []position; position = 0;
+
+   return test.result ();
+}
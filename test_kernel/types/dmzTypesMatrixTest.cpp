@@ -120,6 +120,14 @@ main (int argc, char *argv[]) {
       "Matrix times its inverse is the identity matrix.",
       (ToInvert * theInvert).is_identity ());
 
+   Matrix squared (ForwardToUp);
+   squared *= squared;
+   v = Forward;
+   squared.transform_vector (v);
+   test.validate (
+      "Matrix multiplied by itself in place",
+      (squared == (ForwardToUp * ForwardToUp)) && (Backward - v).is_zero ());
+
    const Matrix FromTwoVec (Forward, Up);
    v = Down;
    FromTwoVec.transform_vector (v);
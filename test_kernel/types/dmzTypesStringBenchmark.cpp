@@ -0,0 +1,147 @@
+#include <dmzSystem.h>
+#include <dmzTypesBase.h>
+#include <dmzTypesHashTableStringTemplate.h>
+#include <dmzTypesString.h>
+#include <dmzTest.h>
+
+using namespace dmz;
+
+namespace {
+
+static const Int32 Iterations = 200000;
+static const Int32 KeyCount = 10000;
+
+static const char ShortValue[] = "dmzObjectType";
+static const char LongValue[] =
+   "dmzRenderPluginObjectOSG.model.resource.highResolutionTexturedModel";
+
+};
+
+int
+main (int argc, char *argv[]) {
+
+   Test test ("dmzTypesStringBenchmark", argc, argv);
+
+   const String Short (ShortValue);
+   const String Long (LongValue);
+
+   // Concatenation
+   Float64 start (get_time ());
+   Int32 totalLength (0);
+
+   for (Int32 ix = 0; ix < Iterations; ix++) {
+
+      String value;
+      value << Short << "." << ix << "." << Short;
+      totalLength += value.get_length ();
+   }
+
+   test.report_time ("Concatenate short strings", start, Iterations);
+   test.validate ("Concatenate short strings", totalLength > 0);
+
+   start = get_time ();
+   String built;
+
+   for (Int32 ix = 0; ix < Iterations; ix++) { built += 'x'; }
+
+   test.report_time ("Append single characters", start, Iterations);
+   test.validate (
+      "Append single characters",
+      (built.get_length () == Iterations) && (built.get_char (-1) == 'x'));
+
+   start = get_time ();
+   totalLength = 0;
+
+   for (Int32 ix = 0; ix < Iterations; ix++) {
+
+      const String Value (Long + Short);
+      totalLength += Value.get_length ();
+   }
+
+   test.report_time ("Concatenate long strings", start, Iterations);
+   test.validate (
+      "Concatenate long strings",
+      totalLength == (Iterations * (Long.get_length () + Short.get_length ())));
+
+   // Copy
+   start = get_time ();
+   Int32 shortMatch (0);
+
+   for (Int32 ix = 0; ix < Iterations; ix++) {
+
+      const String Copy (Short);
+      if (Copy.get_length () == Short.get_length ()) { shortMatch++; }
+   }
+
+   test.report_time ("Copy short string", start, Iterations);
+   test.validate ("Copy short string", shortMatch == Iterations);
+
+   start = get_time ();
+   Int32 longMatch (0);
+
+   for (Int32 ix = 0; ix < Iterations; ix++) {
+
+      String copy;
+      copy = Long;
+      if (copy.get_buffer () == Long.get_buffer ()) { longMatch++; }
+   }
+
+   test.report_time ("Copy long string", start, Iterations);
+   test.validate ("Copy long string shares buffer", longMatch == Iterations);
+
+   // Compare
+   const String ShortOther (ShortValue);
+   const String LongCopy (Long);
+   String longOther (Long);
+   longOther.set_char (-1, 'X');
+
+   start = get_time ();
+   Int32 equalCount (0);
+
+   for (Int32 ix = 0; ix < Iterations; ix++) {
+
+      if (Short == ShortOther) { equalCount++; }
+      if (Long == LongCopy) { equalCount++; }
+      if (Long == longOther) { equalCount++; }
+   }
+
+   test.report_time ("Compare strings", start, Iterations * 3);
+   test.validate ("Compare strings", equalCount == (Iterations * 2));
+
+   // Hashing
+   String *keys (new String[KeyCount]);
+
+   for (Int32 ix = 0; ix < KeyCount; ix++) {
+
+      keys[ix] << (ix & 0x01 ? Long : Short) << "." << ix;
+   }
+
+   HashTableStringTemplate<String> table;
+
+   start = get_time ();
+
+   for (Int32 ix = 0; ix < KeyCount; ix++) {
+
+      table.store (keys[ix], new String (keys[ix]));
+   }
+
+   test.report_time ("Hash table store", start, KeyCount);
+   test.validate ("Hash table store", table.get_count () == KeyCount);
+
+   start = get_time ();
+   Int32 found (0);
+
+   for (Int32 ix = 0; ix < Iterations; ix++) {
+
+      const String *Value (table.lookup (keys[ix % KeyCount]));
+      if (Value && (*Value == keys[ix % KeyCount])) { found++; }
+   }
+
+   test.report_time ("Hash table lookup", start, Iterations);
+   test.validate ("Hash table lookup", found == Iterations);
+
+   table.empty ();
+   delete []keys; keys = 0;
+
+   return test.result ();
+}
@@ -308,5 +308,52 @@ main (int argc, char *argv[]) {
       "find_sub returns True when sub string is the same",
       strFindSub3.find_sub (strFindSub4, index));
 
+   String strShort ("short");
+   test.validate (
+      "Short string is stored without allocating a shared buffer",
+      (strShort.get_size () > strShort.get_length ()) &&
+         (String (strShort).get_buffer () != strShort.get_buffer ()));
+
+   String strLong ("This string is long enough to be stored in a shared buffer.");
+   String strLongCopy (strLong);
+   test.validate (
+      "Copy of long string shares buffer",
+      (strLongCopy.get_buffer () == strLong.get_buffer ()) && (strLongCopy == strLong));
+
+   strLongCopy.set_char (0, 't');
+   test.validate (
+      "Writing to shared string copies the buffer",
+      (strLongCopy.get_buffer () != strLong.get_buffer ()) &&
+         (strLong.get_char (0) == 'T') && (strLongCopy.get_char (0) == 't'));
+
+   String strLongAssign;
+   strLongAssign = strLong;
+   strLongAssign << " More.";
+   test.validate (
+      "Appending to assigned string does not modify source",
+      !strcmp (
+         "This string is long enough to be stored in a shared buffer.",
+         strLong.get_buffer ()) &&
+      !strcmp (
+         "This string is long enough to be stored in a shared buffer. More.",
+         strLongAssign.get_buffer ()));
+
+   String strSelf ("self");
+   strSelf << strSelf << strSelf << strSelf << strSelf;
+   test.validate (
+      "Append string to itself",
+      strSelf == "selfselfselfselfselfselfselfselfselfselfselfselfselfselfselfself" &&
+         (strSelf.get_length () == 64));
+
+   const char Binary[] = { 'a', '\0', 'b' };
+   const char BinaryOther[] = { 'a', '\0', 'c' };
+   test.validate (
+      "Binary strings with embedded NULL compare all bytes",
+      (String (Binary, 3) != String (BinaryOther, 3)) &&
+         (String (Binary, 3) == String (Binary, 3)));
+
+   String strNull;
+   test.validate ("NULL string equals empty string", strNull == String (""));
+
    return test.result ();
 }